@@ -0,0 +1,193 @@
+/**
+ * @file DatabaseBenchmarks.cpp
+ *
+ * This module contains end-to-end benchmarks of the
+ * DatabaseAbstractions::Database interface, using the
+ * DatabaseAbstractions::InMemoryDatabase class as the backend.
+ */
+
+#include <benchmark/benchmark.h>
+#include <DatabaseAbstractions/InMemoryDatabase.hpp>
+#include <DatabaseAbstractions/RowBatch.hpp>
+#include <stddef.h>
+#include <string>
+
+using namespace DatabaseAbstractions;
+
+namespace {
+
+    /**
+     * This makes a database with a table holding the given number
+     * of rows, keyed by integers counting up from 1.
+     *
+     * @param[out] database
+     *     This is the database to fill.
+     *
+     * @param[in] rows
+     *     This is the number of rows to add.
+     */
+    void FillDatabase(
+        InMemoryDatabase& database,
+        size_t rows
+    ) {
+        (void)database.ExecuteStatement(
+            "CREATE TABLE kv ("
+            "  id INTEGER PRIMARY KEY,"
+            "  name TEXT,"
+            "  score INTEGER,"
+            "  data BLOB"
+            ");"
+            "CREATE INDEX kv_score ON kv (score)"
+        );
+        const auto insert = database.BuildStatement(
+            "INSERT INTO kv VALUES (?, ?, ?, ?)"
+        ).statement;
+        const Blob data(32, 0x5A);
+        for (size_t i = 1; i <= rows; ++i) {
+            insert->Reset();
+            insert->BindParameters({i, "name" + std::to_string(i), i % 1000, data});
+            (void)insert->Step();
+        }
+    }
+
+    /**
+     * This applies the table sizes used by the benchmarks
+     * to the given benchmark.
+     *
+     * @param[in,out] benchmark
+     *     This is the benchmark to configure.
+     */
+    void TableSizes(benchmark::internal::Benchmark* benchmark) {
+        benchmark->ArgName("rows")->Arg(1000)->Arg(100000);
+    }
+
+}
+
+static void Database_Insert_Bind_Step(benchmark::State& state) {
+    InMemoryDatabase database;
+    FillDatabase(database, 0);
+    const auto insert = database.BuildStatement(
+        "INSERT OR REPLACE INTO kv VALUES (?, ?, ?, ?)"
+    ).statement;
+    const std::string name("name");
+    const Blob data(32, 0x5A);
+    size_t key = 0;
+    for (auto _: state) {
+        insert->Reset();
+        insert->BindParameters({(key++ % 1000) + 1, name, key, data});
+        benchmark::DoNotOptimize(insert->Step());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(Database_Insert_Bind_Step);
+
+static void Database_Point_Select_Bind_Step_Fetch(benchmark::State& state) {
+    InMemoryDatabase database;
+    const auto rows = (size_t)state.range(0);
+    FillDatabase(database, rows);
+    const auto select = database.BuildStatement(
+        "SELECT name, score FROM kv WHERE id = ?"
+    ).statement;
+    size_t key = 0;
+    for (auto _: state) {
+        select->Reset();
+        select->BindParameter(1, (key++ % rows) + 1);
+        benchmark::DoNotOptimize(select->Step());
+        benchmark::DoNotOptimize(select->FetchColumn(0, Value::Type::Text));
+        benchmark::DoNotOptimize(select->FetchColumn(1, Value::Type::Integer));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(Database_Point_Select_Bind_Step_Fetch)->Apply(TableSizes);
+
+static void Database_Range_Select_Step_Fetch(benchmark::State& state) {
+    InMemoryDatabase database;
+    FillDatabase(database, (size_t)state.range(0));
+    const auto select = database.BuildStatement(
+        "SELECT id, data FROM kv WHERE score >= ? AND score < ?"
+    ).statement;
+    size_t rowsFetched = 0;
+    for (auto _: state) {
+        select->Reset();
+        select->BindParameters({100, 110});
+        while (!select->Step().done) {
+            benchmark::DoNotOptimize(select->FetchColumn(0, Value::Type::Integer));
+            benchmark::DoNotOptimize(select->FetchColumn(1, Value::Type::Blob));
+            ++rowsFetched;
+        }
+    }
+    state.SetItemsProcessed((int64_t)rowsFetched);
+}
+BENCHMARK(Database_Range_Select_Step_Fetch)->Apply(TableSizes);
+
+static void Database_Scan_Step_Batch(benchmark::State& state) {
+    InMemoryDatabase database;
+    FillDatabase(database, (size_t)state.range(0));
+    const auto select = database.BuildStatement(
+        "SELECT id, name FROM kv"
+    ).statement;
+    RowBatch batch({Value::Type::Integer, Value::Type::Text}, 256);
+    size_t rowsFetched = 0;
+    for (auto _: state) {
+        select->Reset();
+        for (;;) {
+            const auto results = select->StepBatch(256, batch);
+            rowsFetched += batch.GetRowCount();
+            if (results.done) {
+                break;
+            }
+        }
+    }
+    state.SetItemsProcessed((int64_t)rowsFetched);
+}
+BENCHMARK(Database_Scan_Step_Batch)->Apply(TableSizes);
+
+static void Database_Create_Snapshot(benchmark::State& state) {
+    InMemoryDatabase database;
+    FillDatabase(database, (size_t)state.range(0));
+    size_t bytes = 0;
+    for (auto _: state) {
+        const auto snapshot = database.CreateSnapshot();
+        bytes += snapshot.size();
+        benchmark::DoNotOptimize(snapshot.data());
+    }
+    state.SetBytesProcessed((int64_t)bytes);
+}
+BENCHMARK(Database_Create_Snapshot)->Apply(TableSizes);
+
+static void Database_Install_Snapshot(benchmark::State& state) {
+    InMemoryDatabase source;
+    FillDatabase(source, (size_t)state.range(0));
+    const auto snapshot = source.CreateSnapshot();
+    InMemoryDatabase database;
+    for (auto _: state) {
+        benchmark::DoNotOptimize(database.InstallSnapshot(snapshot));
+    }
+    state.SetBytesProcessed((int64_t)(snapshot.size() * state.iterations()));
+}
+BENCHMARK(Database_Install_Snapshot)->Apply(TableSizes);
+
+static void Database_Delta_Snapshot_Round_Trip(benchmark::State& state) {
+    InMemoryDatabase leader;
+    FillDatabase(leader, (size_t)state.range(0));
+    InMemoryDatabase follower;
+    (void)follower.InstallSnapshot(leader.CreateSnapshot());
+    const auto update = leader.BuildStatement(
+        "UPDATE kv SET score = ? WHERE id = ?"
+    ).statement;
+    size_t key = 0;
+    for (auto _: state) {
+        const auto baseId = leader.GetSnapshotId();
+        for (size_t i = 0; i < 10; ++i) {
+            update->Reset();
+            update->BindParameters({key, (key % (size_t)state.range(0)) + 1});
+            ++key;
+            (void)update->Step();
+        }
+        benchmark::DoNotOptimize(
+            follower.InstallDeltaSnapshot(leader.CreateDeltaSnapshot(baseId))
+        );
+    }
+    state.SetItemsProcessed(state.iterations() * 10);
+}
+BENCHMARK(Database_Delta_Snapshot_Round_Trip)->Apply(TableSizes);
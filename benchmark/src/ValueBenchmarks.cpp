@@ -0,0 +1,414 @@
+/**
+ * @file ValueBenchmarks.cpp
+ *
+ * This module contains benchmarks of the
+ * DatabaseAbstractions::Value class.
+ */
+
+#include <benchmark/benchmark.h>
+#include <DatabaseAbstractions/Value.hpp>
+#include <stddef.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace DatabaseAbstractions;
+
+namespace {
+
+    /**
+     * This is the number of values constructed by moving from sources
+     * which are prepared, with timing paused, all at once.
+     */
+    constexpr size_t MOVE_BATCH_SIZE = 1000;
+
+    /**
+     * This makes a string of the length given by the benchmark's
+     * first argument.
+     *
+     * @param[in] state
+     *     This is the state of the benchmark.
+     *
+     * @return
+     *     The string is returned.
+     */
+    std::string MakeText(const benchmark::State& state) {
+        return std::string((size_t)state.range(0), 'x');
+    }
+
+    /**
+     * This makes a blob of the size given by the benchmark's
+     * first argument.
+     *
+     * @param[in] state
+     *     This is the state of the benchmark.
+     *
+     * @return
+     *     The blob is returned.
+     */
+    Blob MakeBlob(const benchmark::State& state) {
+        return Blob((size_t)state.range(0), 0x5A);
+    }
+
+    /**
+     * This makes a value of the kind selected by the benchmark's
+     * first argument: 0 for integer, 1 for real, 2 for short text,
+     * 3 for long text, and 4 for blob.
+     *
+     * @param[in] state
+     *     This is the state of the benchmark.
+     *
+     * @return
+     *     The value is returned.
+     */
+    Value MakeValue(const benchmark::State& state) {
+        switch (state.range(0)) {
+            case 0: return Value(42);
+            case 1: return Value(4.2);
+            case 2: return Value("short");
+            case 3: return Value(std::string(256, 'x'));
+            default: return Value(Blob(256, 0x5A));
+        }
+    }
+
+    /**
+     * This applies the argument names and values used with MakeValue
+     * to the given benchmark.
+     *
+     * @param[in,out] benchmark
+     *     This is the benchmark to configure.
+     */
+    void ValueKinds(benchmark::internal::Benchmark* benchmark) {
+        benchmark->ArgName("kind");
+        for (int kind = 0; kind < 5; ++kind) {
+            benchmark->Arg(kind);
+        }
+    }
+
+}
+
+static void Value_Construct_Default(benchmark::State& state) {
+    for (auto _: state) {
+        Value value;
+        benchmark::DoNotOptimize(value);
+    }
+}
+BENCHMARK(Value_Construct_Default);
+
+static void Value_Construct_Null(benchmark::State& state) {
+    for (auto _: state) {
+        Value value(nullptr);
+        benchmark::DoNotOptimize(value);
+    }
+}
+BENCHMARK(Value_Construct_Null);
+
+static void Value_Construct_Boolean(benchmark::State& state) {
+    auto boolean = true;
+    benchmark::DoNotOptimize(boolean);
+    for (auto _: state) {
+        Value value(boolean);
+        benchmark::DoNotOptimize(value);
+    }
+}
+BENCHMARK(Value_Construct_Boolean);
+
+static void Value_Construct_Int(benchmark::State& state) {
+    auto integer = 42;
+    benchmark::DoNotOptimize(integer);
+    for (auto _: state) {
+        Value value(integer);
+        benchmark::DoNotOptimize(value);
+    }
+}
+BENCHMARK(Value_Construct_Int);
+
+static void Value_Construct_Intmax(benchmark::State& state) {
+    intmax_t integer = 42;
+    benchmark::DoNotOptimize(integer);
+    for (auto _: state) {
+        Value value(integer);
+        benchmark::DoNotOptimize(value);
+    }
+}
+BENCHMARK(Value_Construct_Intmax);
+
+static void Value_Construct_Size(benchmark::State& state) {
+    size_t integer = 42;
+    benchmark::DoNotOptimize(integer);
+    for (auto _: state) {
+        Value value(integer);
+        benchmark::DoNotOptimize(value);
+    }
+}
+BENCHMARK(Value_Construct_Size);
+
+static void Value_Construct_Real(benchmark::State& state) {
+    auto real = 4.2;
+    benchmark::DoNotOptimize(real);
+    for (auto _: state) {
+        Value value(real);
+        benchmark::DoNotOptimize(value);
+    }
+}
+BENCHMARK(Value_Construct_Real);
+
+static void Value_Construct_CString(benchmark::State& state) {
+    const auto text = MakeText(state);
+    const auto cString = text.c_str();
+    for (auto _: state) {
+        Value value(cString);
+        benchmark::DoNotOptimize(value);
+    }
+}
+BENCHMARK(Value_Construct_CString)->ArgName("length")->Arg(8)->Arg(64)->Arg(1024);
+
+static void Value_Construct_String_Copy(benchmark::State& state) {
+    const auto text = MakeText(state);
+    for (auto _: state) {
+        Value value(text);
+        benchmark::DoNotOptimize(value);
+    }
+}
+BENCHMARK(Value_Construct_String_Copy)->ArgName("length")->Arg(8)->Arg(64)->Arg(1024);
+
+static void Value_Construct_String_Move(benchmark::State& state) {
+    const auto text = MakeText(state);
+    std::vector< std::string > sources;
+    while (state.KeepRunningBatch(MOVE_BATCH_SIZE)) {
+        state.PauseTiming();
+        sources.assign(MOVE_BATCH_SIZE, text);
+        state.ResumeTiming();
+        for (auto& source: sources) {
+            Value value(std::move(source));
+            benchmark::DoNotOptimize(value);
+        }
+    }
+}
+BENCHMARK(Value_Construct_String_Move)->ArgName("length")->Arg(8)->Arg(64)->Arg(1024);
+
+static void Value_Construct_Blob_Copy(benchmark::State& state) {
+    const auto blob = MakeBlob(state);
+    for (auto _: state) {
+        Value value(blob);
+        benchmark::DoNotOptimize(value);
+    }
+}
+BENCHMARK(Value_Construct_Blob_Copy)->ArgName("size")->Arg(8)->Arg(64)->Arg(1024);
+
+static void Value_Construct_Blob_Move(benchmark::State& state) {
+    const auto blob = MakeBlob(state);
+    std::vector< Blob > sources;
+    while (state.KeepRunningBatch(MOVE_BATCH_SIZE)) {
+        state.PauseTiming();
+        sources.assign(MOVE_BATCH_SIZE, blob);
+        state.ResumeTiming();
+        for (auto& source: sources) {
+            Value value(std::move(source));
+            benchmark::DoNotOptimize(value);
+        }
+    }
+}
+BENCHMARK(Value_Construct_Blob_Move)->ArgName("size")->Arg(8)->Arg(64)->Arg(1024);
+
+static void Value_Construct_Blob_Borrowed(benchmark::State& state) {
+    const auto blob = MakeBlob(state);
+    for (auto _: state) {
+        Value value(BlobView(blob.data(), blob.size()));
+        benchmark::DoNotOptimize(value);
+    }
+}
+BENCHMARK(Value_Construct_Blob_Borrowed)->ArgName("size")->Arg(8)->Arg(64)->Arg(1024);
+
+static void Value_Construct_Error(benchmark::State& state) {
+    const std::string error("something went wrong");
+    for (auto _: state) {
+        auto value = Value::Error(error);
+        benchmark::DoNotOptimize(value);
+    }
+}
+BENCHMARK(Value_Construct_Error);
+
+static void Value_Copy_Construct(benchmark::State& state) {
+    const auto original = MakeValue(state);
+    for (auto _: state) {
+        Value copy(original);
+        benchmark::DoNotOptimize(copy);
+    }
+}
+BENCHMARK(Value_Copy_Construct)->Apply(ValueKinds);
+
+static void Value_Copy_Assign(benchmark::State& state) {
+    const auto original = MakeValue(state);
+    Value copy;
+    for (auto _: state) {
+        copy = original;
+        benchmark::DoNotOptimize(copy);
+    }
+}
+BENCHMARK(Value_Copy_Assign)->Apply(ValueKinds);
+
+static void Value_Move_Construct(benchmark::State& state) {
+    auto value = MakeValue(state);
+    for (auto _: state) {
+        Value moved(std::move(value));
+        benchmark::DoNotOptimize(moved);
+        value = std::move(moved);
+    }
+}
+BENCHMARK(Value_Move_Construct)->Apply(ValueKinds);
+
+static void Value_Move_Assign(benchmark::State& state) {
+    auto first = MakeValue(state);
+    Value second;
+    for (auto _: state) {
+        second = std::move(first);
+        first = std::move(second);
+        benchmark::DoNotOptimize(first);
+    }
+}
+BENCHMARK(Value_Move_Assign)->Apply(ValueKinds);
+
+static void Value_Assign_String_Reusing_Capacity(benchmark::State& state) {
+    const auto text = MakeText(state);
+    Value value(text);
+    for (auto _: state) {
+        value = text;
+        benchmark::DoNotOptimize(value);
+    }
+}
+BENCHMARK(Value_Assign_String_Reusing_Capacity)->ArgName("length")->Arg(8)->Arg(64)->Arg(1024);
+
+static void Value_Equal(benchmark::State& state) {
+    const auto lhs = MakeValue(state);
+    const auto rhs = MakeValue(state);
+    for (auto _: state) {
+        benchmark::DoNotOptimize(lhs == rhs);
+    }
+}
+BENCHMARK(Value_Equal)->Apply(ValueKinds);
+
+static void Value_Equal_Boolean(benchmark::State& state) {
+    const Value lhs(true);
+    const Value rhs(true);
+    for (auto _: state) {
+        benchmark::DoNotOptimize(lhs == rhs);
+    }
+}
+BENCHMARK(Value_Equal_Boolean);
+
+static void Value_Equal_Null(benchmark::State& state) {
+    const Value lhs(nullptr);
+    const Value rhs(nullptr);
+    for (auto _: state) {
+        benchmark::DoNotOptimize(lhs == rhs);
+    }
+}
+BENCHMARK(Value_Equal_Null);
+
+static void Value_Equal_Invalid(benchmark::State& state) {
+    const Value lhs;
+    const Value rhs;
+    for (auto _: state) {
+        benchmark::DoNotOptimize(lhs == rhs);
+    }
+}
+BENCHMARK(Value_Equal_Invalid);
+
+static void Value_Equal_Error(benchmark::State& state) {
+    const auto lhs = Value::Error("something went wrong");
+    const auto rhs = Value::Error("something went wrong");
+    for (auto _: state) {
+        benchmark::DoNotOptimize(lhs == rhs);
+    }
+}
+BENCHMARK(Value_Equal_Error);
+
+static void Value_Equal_Integer_Real(benchmark::State& state) {
+    const Value lhs(42);
+    const Value rhs(42.0);
+    for (auto _: state) {
+        benchmark::DoNotOptimize(lhs == rhs);
+    }
+}
+BENCHMARK(Value_Equal_Integer_Real);
+
+static void Value_Equal_Blob_Borrowed_Owned(benchmark::State& state) {
+    const auto blob = MakeBlob(state);
+    const Value lhs(BlobView(blob.data(), blob.size()));
+    const Value rhs(blob);
+    for (auto _: state) {
+        benchmark::DoNotOptimize(lhs == rhs);
+    }
+}
+BENCHMARK(Value_Equal_Blob_Borrowed_Owned)->ArgName("size")->Arg(8)->Arg(64)->Arg(1024);
+
+static void Value_Not_Equal_Mismatched_Types(benchmark::State& state) {
+    const Value lhs("42");
+    const Value rhs(42);
+    for (auto _: state) {
+        benchmark::DoNotOptimize(lhs != rhs);
+    }
+}
+BENCHMARK(Value_Not_Equal_Mismatched_Types);
+
+static void Value_Convert_To_String(benchmark::State& state) {
+    const Value value("some text");
+    for (auto _: state) {
+        benchmark::DoNotOptimize(&(const std::string&)value);
+    }
+}
+BENCHMARK(Value_Convert_To_String);
+
+static void Value_Convert_To_CString(benchmark::State& state) {
+    const Value value("some text");
+    for (auto _: state) {
+        benchmark::DoNotOptimize((const char*)value);
+    }
+}
+BENCHMARK(Value_Convert_To_CString);
+
+static void Value_Convert_To_Integer(benchmark::State& state) {
+    const Value value(42);
+    for (auto _: state) {
+        benchmark::DoNotOptimize((intmax_t)value);
+        benchmark::DoNotOptimize((int)value);
+        benchmark::DoNotOptimize((size_t)value);
+    }
+}
+BENCHMARK(Value_Convert_To_Integer);
+
+static void Value_Convert_To_Real(benchmark::State& state) {
+    const Value value(4.2);
+    for (auto _: state) {
+        benchmark::DoNotOptimize((double)value);
+    }
+}
+BENCHMARK(Value_Convert_To_Real);
+
+static void Value_Convert_To_Boolean(benchmark::State& state) {
+    const Value value(true);
+    for (auto _: state) {
+        benchmark::DoNotOptimize((bool)value);
+    }
+}
+BENCHMARK(Value_Convert_To_Boolean);
+
+static void Value_Convert_To_BlobView(benchmark::State& state) {
+    const Value value(Blob(64, 0x5A));
+    for (auto _: state) {
+        const BlobView view(value);
+        benchmark::DoNotOptimize(view.data);
+    }
+}
+BENCHMARK(Value_Convert_To_BlobView);
+
+static void Value_Own_Borrowed_Blob(benchmark::State& state) {
+    const auto blob = MakeBlob(state);
+    for (auto _: state) {
+        Value value(BlobView(blob.data(), blob.size()));
+        value.Own();
+        benchmark::DoNotOptimize(value);
+    }
+}
+BENCHMARK(Value_Own_Borrowed_Blob)->ArgName("size")->Arg(8)->Arg(64)->Arg(1024);
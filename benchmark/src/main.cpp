@@ -0,0 +1,82 @@
+/**
+ * @file main.cpp
+ *
+ * This module holds the entry point of the DatabaseAbstractions
+ * benchmarks.  Unless told otherwise on the command line, results are
+ * also written in JSON format to a file, so that they can be tracked
+ * over time.
+ */
+
+#include <benchmark/benchmark.h>
+#include <string.h>
+#include <vector>
+
+namespace {
+
+    /**
+     * This is the option used to write results to a file by default.
+     */
+    char DEFAULT_OUTPUT_FILE[] = "--benchmark_out=DatabaseAbstractionsBenchmarks.json";
+
+    /**
+     * This is the option used to select the format of the file
+     * to which results are written by default.
+     */
+    char DEFAULT_OUTPUT_FORMAT[] = "--benchmark_out_format=json";
+
+    /**
+     * This determines whether any of the given command-line arguments
+     * begins with the given prefix.
+     *
+     * @param[in] arguments
+     *     These are the command-line arguments to check.
+     *
+     * @param[in] prefix
+     *     This is the prefix to look for.
+     *
+     * @return
+     *     An indication of whether any argument begins with the prefix
+     *     is returned.
+     */
+    bool HasArgument(
+        const std::vector< char* >& arguments,
+        const char* prefix
+    ) {
+        const auto prefixLength = strlen(prefix);
+        for (const auto argument: arguments) {
+            if (strncmp(argument, prefix, prefixLength) == 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+}
+
+/**
+ * This function is the entry point of the program.
+ *
+ * @param[in] argc
+ *     This is the number of command-line arguments given to the program.
+ *
+ * @param[in] argv
+ *     This is the array of command-line arguments given to the program.
+ */
+int main(int argc, char* argv[]) {
+    std::vector< char* > arguments(argv, argv + argc);
+    if (!HasArgument(arguments, "--benchmark_out=")) {
+        arguments.push_back(DEFAULT_OUTPUT_FILE);
+        if (!HasArgument(arguments, "--benchmark_out_format=")) {
+            arguments.push_back(DEFAULT_OUTPUT_FORMAT);
+        }
+    }
+    auto argumentCount = (int)arguments.size();
+    arguments.push_back(nullptr);
+    benchmark::Initialize(&argumentCount, arguments.data());
+    if (benchmark::ReportUnrecognizedArguments(argumentCount, arguments.data())) {
+        return 1;
+    }
+    (void)benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
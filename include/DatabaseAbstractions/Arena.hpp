@@ -0,0 +1,106 @@
+#pragma once
+
+/**
+ * @file Arena.hpp
+ *
+ * This file defines the DatabaseAbstractions::Arena class, which hands out
+ * memory which is all released at once.
+ */
+
+#include <memory>
+#include <stddef.h>
+
+namespace DatabaseAbstractions {
+
+    /**
+     * This is a monotonic allocator.  It hands out memory carved from
+     * large blocks, and never releases any of it individually.  Instead,
+     * all the memory handed out is released at once when the arena is
+     * reset or destroyed.  The blocks are kept when the arena is reset,
+     * so that using it again doesn't need to allocate more memory.
+     *
+     * This is useful for data which all shares the same lifetime, such
+     * as the text and blobs of the values in a batch of rows fetched from
+     * a database (see Value::Assign and RowBatch::GetArena).
+     */
+    class Arena {
+        // Lifecycle
+    public:
+        ~Arena() noexcept;
+        Arena(const Arena&) = delete;
+        Arena(Arena&&) noexcept;
+        Arena& operator=(const Arena&) = delete;
+        Arena& operator=(Arena&&) noexcept;
+
+        // Construction
+    public:
+        /**
+         * This constructs an arena which has no memory yet.
+         *
+         * @param[in] blockSize
+         *     This is the number of bytes to allocate at a time.  Larger
+         *     requests are given blocks of their own.
+         */
+        explicit Arena(size_t blockSize = 4096);
+
+        // Methods
+    public:
+        /**
+         * This hands out memory from the arena, which stays valid until
+         * the arena is reset or destroyed.
+         *
+         * @param[in] size
+         *     This is the number of bytes to hand out.
+         *
+         * @param[in] alignment
+         *     This is the alignment, which must be a power of two,
+         *     required for the memory.
+         *
+         * @return
+         *     A pointer to the memory handed out is returned.
+         */
+        void* Allocate(
+            size_t size,
+            size_t alignment = alignof(max_align_t)
+        );
+
+        /**
+         * This releases all the memory handed out by the arena at once,
+         * keeping its blocks to hand out again.
+         */
+        void Reset();
+
+        /**
+         * This returns the number of bytes handed out since the arena
+         * was constructed or last reset, not counting padding needed
+         * for alignment.
+         *
+         * @return
+         *     The number of bytes handed out is returned.
+         */
+        size_t GetBytesUsed() const;
+
+        /**
+         * This returns the total size of the blocks held by the arena.
+         *
+         * @return
+         *     The total size of the blocks held by the arena is returned.
+         */
+        size_t GetBytesReserved() const;
+
+        // Private Properties
+    private:
+        /**
+         * This is the type of structure that contains the private
+         * properties of the instance.  It is defined in the implementation
+         * and declared here to ensure that it is scoped inside the class.
+         */
+        struct Impl;
+
+        /**
+         * This contains the private properties of the instance.
+         */
+        std::unique_ptr< Impl > impl_;
+    };
+
+}
@@ -0,0 +1,118 @@
+#pragma once
+
+/**
+ * @file AsyncDatabase.hpp
+ *
+ * This file defines the DatabaseAbstractions::AsyncDatabase class, which
+ * moves the work of another database onto a pool of worker threads.
+ */
+
+#include "Database.hpp"
+#include "WorkerPool.hpp"
+
+#include <memory>
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+
+namespace DatabaseAbstractions {
+
+    /**
+     * This is an adapter which wraps any Database implementation so that
+     * its asynchronous methods (BuildStatementAsync, ExecuteAsync,
+     * ApplyWriteBatchAsync, and StepAsync on the statements it prepares)
+     * do their work on a worker pool instead of the calling thread.  This
+     * lets a thread which must stay responsive, such as one running a
+     * consensus protocol, hand storage work off and carry on.
+     *
+     * All work for the wrapped database, asynchronous or not, is done
+     * one operation at a time in the order it's requested, so the wrapped
+     * database need not be thread-safe, and many AsyncDatabase instances
+     * may share one pool.  The synchronous methods wait for any earlier
+     * asynchronous work to finish before doing their own.
+     *
+     * Completion functions are called on a worker thread, and may use the
+     * database and its statements synchronously; such calls are done
+     * immediately rather than waiting in line behind the function itself.
+     * The synchronous methods must not otherwise be called from the
+     * pool's worker threads, since they could wait forever for a thread
+     * to become available.
+     *
+     * Snapshot readers and writers made by this database are wrapped
+     * the same way, so they may be used alongside asynchronous work.
+     */
+    class AsyncDatabase
+        : public Database
+    {
+        // Lifecycle
+    public:
+        ~AsyncDatabase() noexcept;
+        AsyncDatabase(const AsyncDatabase&) = delete;
+        AsyncDatabase(AsyncDatabase&&) noexcept;
+        AsyncDatabase& operator=(const AsyncDatabase&) = delete;
+        AsyncDatabase& operator=(AsyncDatabase&&) noexcept;
+
+        // Construction
+    public:
+        /**
+         * This constructs the adapter.
+         *
+         * @param[in] database
+         *     This is the database to wrap.
+         *
+         * @param[in] pool
+         *     This is the worker pool on which to do the work of the
+         *     wrapped database.
+         */
+        AsyncDatabase(
+            std::shared_ptr< Database > database,
+            std::shared_ptr< WorkerPool > pool
+        );
+
+        // Database
+    public:
+        virtual BuildStatementResults BuildStatement(
+            const std::string& statement
+        ) override;
+        virtual std::string ExecuteStatement(const std::string& statement) override;
+        virtual std::string BeginTransaction() override;
+        virtual std::string CommitTransaction() override;
+        virtual std::string RollbackTransaction() override;
+        virtual std::string ApplyWriteBatch(const WriteBatch& batch) override;
+        virtual void BuildStatementAsync(
+            const std::string& statement,
+            BuildStatementCallback callback
+        ) override;
+        virtual void ExecuteAsync(
+            const std::string& statement,
+            CompletionCallback callback
+        ) override;
+        virtual void ApplyWriteBatchAsync(
+            WriteBatch&& batch,
+            CompletionCallback callback
+        ) override;
+        virtual Blob CreateSnapshot() override;
+        virtual std::string InstallSnapshot(const Blob& blob) override;
+        virtual std::shared_ptr< SnapshotReader > CreateSnapshotReader(size_t chunkSize) override;
+        virtual std::shared_ptr< SnapshotReader > CaptureSnapshot(size_t chunkSize) override;
+        virtual std::shared_ptr< SnapshotWriter > CreateSnapshotWriter() override;
+        virtual uint64_t GetSnapshotId() override;
+        virtual DeltaSnapshot CreateDeltaSnapshot(uint64_t baseId) override;
+        virtual std::string InstallDeltaSnapshot(const DeltaSnapshot& snapshot) override;
+
+        // Private Properties
+    private:
+        /**
+         * This is the type of structure that contains the private
+         * properties of the instance.  It is defined in the implementation
+         * and declared here to ensure that it is scoped inside the class.
+         */
+        struct Impl;
+
+        /**
+         * This contains the private properties of the instance.
+         */
+        std::unique_ptr< Impl > impl_;
+    };
+
+}
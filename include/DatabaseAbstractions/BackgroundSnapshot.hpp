@@ -0,0 +1,198 @@
+#pragma once
+
+/**
+ * @file BackgroundSnapshot.hpp
+ *
+ * This file defines the DatabaseAbstractions::BackgroundSnapshot class,
+ * which writes out a snapshot captured from a database on a thread of
+ * its own, while the database goes on being used.
+ */
+
+#include "Database.hpp"
+#include "Snapshot.hpp"
+
+#include <functional>
+#include <memory>
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+
+namespace DatabaseAbstractions {
+
+    /**
+     * This is the maximum number of bytes in each chunk of a snapshot
+     * written in the background unless another size is given.
+     */
+    constexpr size_t DEFAULT_BACKGROUND_SNAPSHOT_CHUNK_SIZE = 65536;
+
+    /**
+     * This describes how far along a snapshot being written in the
+     * background is.
+     */
+    struct BackgroundSnapshotProgress {
+        /**
+         * This is the number of bytes of the snapshot written so far.
+         */
+        uint64_t bytes = 0;
+
+        /**
+         * This is the number of chunks of the snapshot written so far.
+         */
+        uint64_t chunks = 0;
+
+        /**
+         * This flag is set once the snapshot is no longer being written,
+         * whether because it's complete, it failed, or it was cancelled.
+         */
+        bool done = false;
+    };
+
+    /**
+     * This is the type of function called on the background thread
+     * each time another chunk of the snapshot has been written.
+     */
+    using BackgroundSnapshotProgressCallback = std::function<
+        void(const BackgroundSnapshotProgress& progress)
+    >;
+
+    /**
+     * This reads a snapshot captured from a database and writes it to a
+     * snapshot writer, one chunk at a time, on a thread of its own.
+     *
+     * The snapshot is captured using Database::CaptureSnapshot when it's
+     * started, so it holds the state of the database at that moment, and
+     * the database may go on being used, and changed, while the snapshot
+     * is written.  How long the capture itself takes, and so how long the
+     * database is held up, depends on the database; an InMemoryDatabase,
+     * for example, only copies the schema and the list of pages of each
+     * table, and afterwards copies a page only before changing it.
+     *
+     * The writer is given the chunks on the background thread, and is
+     * finished there once the last chunk is written, but only if the
+     * snapshot is complete.  Progress may be checked at any time, from
+     * any thread, or reported after each chunk by a callback.  The
+     * snapshot may be cancelled, in which case it stops before the
+     * next chunk.
+     */
+    class BackgroundSnapshot {
+        // Lifecycle
+    public:
+        /**
+         * This cancels the snapshot being written, if any, and waits
+         * for the background thread to stop.
+         */
+        ~BackgroundSnapshot() noexcept;
+        BackgroundSnapshot(const BackgroundSnapshot&) = delete;
+        BackgroundSnapshot(BackgroundSnapshot&&) noexcept;
+        BackgroundSnapshot& operator=(const BackgroundSnapshot&) = delete;
+        BackgroundSnapshot& operator=(BackgroundSnapshot&&) noexcept;
+
+        // Construction
+    public:
+        /**
+         * This constructs an object which isn't yet writing a snapshot.
+         */
+        BackgroundSnapshot();
+
+        // Methods
+    public:
+        /**
+         * This captures the current state of the given database and
+         * starts writing a snapshot of it in the background.
+         *
+         * @param[in] database
+         *     This is the database to snapshot.  It's only used during
+         *     the call, to capture its state.
+         *
+         * @param[in] writer
+         *     This is where to write the snapshot.
+         *
+         * @param[in] progressCallback
+         *     If not null, this is called on the background thread
+         *     each time another chunk has been written.
+         *
+         * @param[in] chunkSize
+         *     This is the maximum number of bytes in each chunk.
+         *
+         * @return
+         *     If a snapshot is already being written, a description of
+         *     the problem is returned.  Otherwise, an empty string
+         *     is returned.
+         */
+        std::string Start(
+            Database& database,
+            std::shared_ptr< SnapshotWriter > writer,
+            BackgroundSnapshotProgressCallback progressCallback = nullptr,
+            size_t chunkSize = DEFAULT_BACKGROUND_SNAPSHOT_CHUNK_SIZE
+        );
+
+        /**
+         * This starts writing the snapshot produced by the given reader
+         * in the background.  The reader must be safe to read on
+         * another thread, as those returned by Database::CaptureSnapshot
+         * are.
+         *
+         * @param[in] reader
+         *     This is the source of the snapshot.
+         *
+         * @param[in] writer
+         *     This is where to write the snapshot.
+         *
+         * @param[in] progressCallback
+         *     If not null, this is called on the background thread
+         *     each time another chunk has been written.
+         *
+         * @return
+         *     If a snapshot is already being written, a description of
+         *     the problem is returned.  Otherwise, an empty string
+         *     is returned.
+         */
+        std::string Start(
+            std::shared_ptr< SnapshotReader > reader,
+            std::shared_ptr< SnapshotWriter > writer,
+            BackgroundSnapshotProgressCallback progressCallback = nullptr
+        );
+
+        /**
+         * This returns how far along the snapshot is.
+         *
+         * @return
+         *     How far along the snapshot is, is returned.
+         */
+        BackgroundSnapshotProgress GetProgress() const;
+
+        /**
+         * This asks for the snapshot to stop before its next chunk.
+         * The writer isn't finished.  Call Wait to know when the
+         * background thread has stopped.
+         */
+        void Cancel();
+
+        /**
+         * This waits for the snapshot to be complete, to fail, or to
+         * stop after being cancelled, and then allows another snapshot
+         * to be started.
+         *
+         * @return
+         *     If the snapshot failed or was cancelled, a description of
+         *     the problem is returned.  Otherwise, an empty string
+         *     is returned.
+         */
+        std::string Wait();
+
+        // Private Properties
+    private:
+        /**
+         * This is the type of structure that contains the private
+         * properties of the instance.  It is defined in the implementation
+         * and declared here to ensure that it is scoped inside the class.
+         */
+        struct Impl;
+
+        /**
+         * This contains the private properties of the instance.
+         */
+        std::unique_ptr< Impl > impl_;
+    };
+
+}
@@ -0,0 +1,208 @@
+#pragma once
+
+/**
+ * @file CachingDatabase.hpp
+ *
+ * This file defines the DatabaseAbstractions::CachingDatabase class,
+ * which wraps a database in order to cache the results of queries.
+ */
+
+#include "Database.hpp"
+
+#include <memory>
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+
+namespace DatabaseAbstractions {
+
+    /**
+     * This is the memory budget of a result cache unless another is given.
+     */
+    constexpr size_t DEFAULT_RESULT_CACHE_BUDGET = 16 * 1024 * 1024;
+
+    /**
+     * This describes how well a result cache is doing.
+     */
+    struct ResultCacheStatistics {
+        // Properties
+
+        /**
+         * This is the number of times a query was answered from the cache.
+         */
+        uint64_t hits = 0;
+
+        /**
+         * This is the number of times a query had to be run because its
+         * results weren't in the cache.
+         */
+        uint64_t misses = 0;
+
+        /**
+         * This is the number of times the results of a query were
+         * added to the cache.
+         */
+        uint64_t stores = 0;
+
+        /**
+         * This is the number of cached results discarded to stay
+         * within the memory budget.
+         */
+        uint64_t evictions = 0;
+
+        /**
+         * This is the number of cached results discarded because
+         * the tables they were read from were changed.
+         */
+        uint64_t invalidations = 0;
+
+        /**
+         * This is the number of results currently in the cache.
+         */
+        size_t entries = 0;
+
+        /**
+         * This is the approximate number of bytes of memory used by
+         * the results currently in the cache.
+         */
+        size_t bytes = 0;
+
+        // Methods
+
+        /**
+         * This returns the fraction of queries answered from the cache.
+         *
+         * @return
+         *     The fraction of queries answered from the cache is
+         *     returned, or zero if there haven't been any queries.
+         */
+        double GetHitRatio() const;
+    };
+
+    /**
+     * This is a database which passes everything through to another
+     * database, except that it remembers the rows fetched by queries
+     * (statements starting with SELECT), and when a statement with the
+     * same SQL text and the same parameter values is stepped again, it
+     * hands out the remembered rows rather than running the query.
+     *
+     * Rows are remembered in the compact form produced by EncodeValue,
+     * only for the columns and types actually fetched, and as far as the
+     * statement was stepped.  If a later query fetches a column which
+     * wasn't remembered, or steps past the remembered rows, the query is
+     * run after all.  The least recently used results are discarded to
+     * keep the memory they use within a budget.
+     *
+     * Results are discarded by table whenever a statement which changes
+     * that table is executed, stepped, or applied in a write batch.
+     * Tables are found by scanning the SQL text, which covers INSERT,
+     * REPLACE, UPDATE, DELETE, CREATE TABLE, DROP TABLE and ALTER TABLE.
+     * Any other statement (other than BEGIN, COMMIT, and their kin),
+     * rolling back a transaction, or installing a snapshot discards all
+     * results.  Changes made indirectly, such as by triggers or foreign
+     * key actions, or to the tables behind a view, aren't seen, so
+     * queries of tables changed that way shouldn't go through the cache.
+     *
+     * The database and its statements may be used by several threads
+     * at once, as long as the wrapped database allows it.
+     */
+    class CachingDatabase
+        : public Database
+    {
+        // Lifecycle
+    public:
+        ~CachingDatabase() noexcept;
+        CachingDatabase(const CachingDatabase&) = delete;
+        CachingDatabase(CachingDatabase&&) noexcept;
+        CachingDatabase& operator=(const CachingDatabase&) = delete;
+        CachingDatabase& operator=(CachingDatabase&&) noexcept;
+
+        // Construction
+    public:
+        /**
+         * This constructs the wrapper.
+         *
+         * @param[in] database
+         *     This is the database to wrap.
+         *
+         * @param[in] memoryBudget
+         *     This is the approximate number of bytes of memory which
+         *     the cached results may use.
+         */
+        explicit CachingDatabase(
+            std::shared_ptr< Database > database,
+            size_t memoryBudget = DEFAULT_RESULT_CACHE_BUDGET
+        );
+
+        // Methods
+    public:
+        /**
+         * This changes the approximate number of bytes of memory which
+         * the cached results may use, discarding results as needed.
+         *
+         * @param[in] memoryBudget
+         *     This is the approximate number of bytes of memory which
+         *     the cached results may use.
+         */
+        void SetMemoryBudget(size_t memoryBudget);
+
+        /**
+         * This discards all cached results.
+         */
+        void Clear();
+
+        /**
+         * This returns a copy of the statistics kept by the cache.
+         *
+         * @return
+         *     A copy of the statistics kept by the cache is returned.
+         */
+        ResultCacheStatistics GetStatistics() const;
+
+        // Database
+    public:
+        virtual BuildStatementResults BuildStatement(
+            const std::string& statement
+        ) override;
+        virtual std::string ExecuteStatement(const std::string& statement) override;
+        virtual std::string BeginTransaction() override;
+        virtual std::string CommitTransaction() override;
+        virtual std::string RollbackTransaction() override;
+        virtual std::string ApplyWriteBatch(const WriteBatch& batch) override;
+        virtual void BuildStatementAsync(
+            const std::string& statement,
+            BuildStatementCallback callback
+        ) override;
+        virtual void ExecuteAsync(
+            const std::string& statement,
+            CompletionCallback callback
+        ) override;
+        virtual void ApplyWriteBatchAsync(
+            WriteBatch&& batch,
+            CompletionCallback callback
+        ) override;
+        virtual Blob CreateSnapshot() override;
+        virtual std::string InstallSnapshot(const Blob& blob) override;
+        virtual std::shared_ptr< SnapshotReader > CreateSnapshotReader(size_t chunkSize) override;
+        virtual std::shared_ptr< SnapshotReader > CaptureSnapshot(size_t chunkSize) override;
+        virtual std::shared_ptr< SnapshotWriter > CreateSnapshotWriter() override;
+        virtual uint64_t GetSnapshotId() override;
+        virtual DeltaSnapshot CreateDeltaSnapshot(uint64_t baseId) override;
+        virtual std::string InstallDeltaSnapshot(const DeltaSnapshot& snapshot) override;
+
+        // Private Properties
+    private:
+        /**
+         * This is the type of structure that contains the private
+         * properties of the instance.  It is defined in the implementation
+         * and declared here to ensure that it is scoped inside the class.
+         */
+        struct Impl;
+
+        /**
+         * This contains the private properties of the instance.
+         */
+        std::unique_ptr< Impl > impl_;
+    };
+
+}
@@ -0,0 +1,150 @@
+#pragma once
+
+/**
+ * @file CompositeKey.hpp
+ *
+ * This file defines the DatabaseAbstractions::CompositeKey class, which
+ * combines several database values into one key for caches and indexes.
+ */
+
+#include "Value.hpp"
+
+#include <functional>
+#include <initializer_list>
+#include <stddef.h>
+#include <vector>
+
+namespace DatabaseAbstractions {
+
+    /**
+     * This is a key made up of several values, such as the values of
+     * several columns of a row.  Keys are compared value by value, in
+     * order, using Value::Compare.  The hash of the key is computed once,
+     * when the key is made, so looking keys up in hash tables doesn't
+     * have to hash the values again, and keys whose hashes differ are
+     * known to be different without comparing their values.
+     *
+     * The key keeps its own copies of the data of its values, so it
+     * doesn't depend on borrowed blobs or arenas the values came from.
+     */
+    class CompositeKey {
+        // Construction
+    public:
+        CompositeKey();
+
+        /**
+         * This makes a key from the given values.
+         *
+         * @param[in] values
+         *     These are the values which make up the key, in order.
+         */
+        CompositeKey(std::initializer_list< Value > values);
+
+        /**
+         * This makes a key from the given values.
+         *
+         * @param[in] values
+         *     These are the values which make up the key, in order.
+         */
+        explicit CompositeKey(std::vector< Value > values);
+
+        // Methods
+    public:
+        /**
+         * This returns the number of values in the key.
+         *
+         * @return
+         *     The number of values in the key is returned.
+         */
+        size_t GetSize() const;
+
+        /**
+         * This returns the values which make up the key.
+         *
+         * @return
+         *     The values which make up the key are returned.
+         */
+        const std::vector< Value >& GetValues() const;
+
+        /**
+         * This returns the hash of the key, computed when the key
+         * was made.  Like Value::Hash, all of its bits are well mixed.
+         *
+         * @return
+         *     The hash of the key is returned.
+         */
+        size_t Hash() const;
+
+        /**
+         * This compares the key with another key, value by value, with
+         * a key which runs out of values first coming first.
+         *
+         * @param[in] other
+         *     This is the key with which to compare.
+         *
+         * @return
+         *     -1, 0, or 1 is returned, according to whether the key
+         *     comes before, is equivalent to, or comes after the
+         *     other key.
+         */
+        int Compare(const CompositeKey& other) const;
+
+        const Value& operator[](size_t index) const;
+        bool operator==(const CompositeKey& other) const;
+        bool operator!=(const CompositeKey& other) const;
+        bool operator<(const CompositeKey& other) const;
+        bool operator<=(const CompositeKey& other) const;
+        bool operator>(const CompositeKey& other) const;
+        bool operator>=(const CompositeKey& other) const;
+
+        // Private Methods
+    private:
+        /**
+         * This makes sure the key owns the data of its values,
+         * and computes its hash.
+         */
+        void Prepare();
+
+        // Private Properties
+    private:
+        /**
+         * These are the values which make up the key, in order.
+         */
+        std::vector< Value > values_;
+
+        /**
+         * This is the hash of the key.
+         */
+        size_t hash_ = 0;
+    };
+
+    /**
+     * This is a support function for Google Test to print out
+     * composite keys.
+     *
+     * @param[in] key
+     *     This is the key to print.
+     *
+     * @param[in] os
+     *     This points to the stream to which to print the key.
+     */
+    void PrintTo(
+        const CompositeKey& key,
+        std::ostream* os
+    );
+
+}
+
+namespace std {
+
+    /**
+     * This lets composite keys be used as keys in standard
+     * unordered containers.
+     */
+    template<> struct hash< DatabaseAbstractions::CompositeKey > {
+        size_t operator()(const DatabaseAbstractions::CompositeKey& key) const {
+            return key.Hash();
+        }
+    };
+
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+/**
+ * @file CompressedSnapshotDatabase.hpp
+ *
+ * This file defines the DatabaseAbstractions::CompressedSnapshotDatabase
+ * class, which wraps a database in order to compress its snapshots.
+ */
+
+#include "Database.hpp"
+#include "SnapshotCodec.hpp"
+#include "WorkerPool.hpp"
+
+#include <memory>
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+
+namespace DatabaseAbstractions {
+
+    /**
+     * This is a database which passes everything through to another
+     * database, except that the snapshots it makes, whether complete,
+     * in chunks, or deltas, are compressed into frames (see
+     * SnapshotCodec.hpp).  When installing a snapshot, it detects
+     * whether or not the snapshot is a frame, and if so, decompresses it
+     * using whichever codec made it, so snapshots made by databases which
+     * don't compress them, or which use other codecs, may be installed too.
+     */
+    class CompressedSnapshotDatabase
+        : public Database
+    {
+        // Lifecycle
+    public:
+        ~CompressedSnapshotDatabase() noexcept;
+        CompressedSnapshotDatabase(const CompressedSnapshotDatabase&) = delete;
+        CompressedSnapshotDatabase(CompressedSnapshotDatabase&&) noexcept;
+        CompressedSnapshotDatabase& operator=(const CompressedSnapshotDatabase&) = delete;
+        CompressedSnapshotDatabase& operator=(CompressedSnapshotDatabase&&) noexcept;
+
+        // Construction
+    public:
+        /**
+         * This constructs the wrapper.
+         *
+         * @param[in] database
+         *     This is the database to wrap.
+         *
+         * @param[in] codec
+         *     This is the codec to use to compress snapshots.  If null,
+         *     the built-in LZ codec is used.
+         *
+         * @param[in] pool
+         *     If not null, this is used to compress and decompress
+         *     blocks of snapshots in parallel.
+         *
+         * @param[in] blockSize
+         *     This is the number of bytes of each snapshot to compress
+         *     in each block.
+         */
+        explicit CompressedSnapshotDatabase(
+            std::shared_ptr< Database > database,
+            std::shared_ptr< const SnapshotCodec > codec = nullptr,
+            std::shared_ptr< WorkerPool > pool = nullptr,
+            size_t blockSize = DEFAULT_SNAPSHOT_BLOCK_SIZE
+        );
+
+        // Database
+    public:
+        virtual BuildStatementResults BuildStatement(
+            const std::string& statement
+        ) override;
+        virtual std::string ExecuteStatement(const std::string& statement) override;
+        virtual std::string BeginTransaction() override;
+        virtual std::string CommitTransaction() override;
+        virtual std::string RollbackTransaction() override;
+        virtual std::string ApplyWriteBatch(const WriteBatch& batch) override;
+        virtual void BuildStatementAsync(
+            const std::string& statement,
+            BuildStatementCallback callback
+        ) override;
+        virtual void ExecuteAsync(
+            const std::string& statement,
+            CompletionCallback callback
+        ) override;
+        virtual void ApplyWriteBatchAsync(
+            WriteBatch&& batch,
+            CompletionCallback callback
+        ) override;
+        virtual Blob CreateSnapshot() override;
+        virtual std::string InstallSnapshot(const Blob& blob) override;
+        virtual std::shared_ptr< SnapshotReader > CreateSnapshotReader(size_t chunkSize) override;
+        virtual std::shared_ptr< SnapshotReader > CaptureSnapshot(size_t chunkSize) override;
+        virtual std::shared_ptr< SnapshotWriter > CreateSnapshotWriter() override;
+        virtual uint64_t GetSnapshotId() override;
+        virtual DeltaSnapshot CreateDeltaSnapshot(uint64_t baseId) override;
+        virtual std::string InstallDeltaSnapshot(const DeltaSnapshot& snapshot) override;
+
+        // Private Properties
+    private:
+        /**
+         * This is the type of structure that contains the private
+         * properties of the instance.  It is defined in the implementation
+         * and declared here to ensure that it is scoped inside the class.
+         */
+        struct Impl;
+
+        /**
+         * This contains the private properties of the instance.
+         */
+        std::unique_ptr< Impl > impl_;
+    };
+
+}
@@ -0,0 +1,165 @@
+#pragma once
+
+/**
+ * @file ConnectionPool.hpp
+ *
+ * This file defines the DatabaseAbstractions::ConnectionPool class, which
+ * spreads read-only queries across several connections to a database.
+ */
+
+#include "Database.hpp"
+
+#include <functional>
+#include <memory>
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+
+namespace DatabaseAbstractions {
+
+    /**
+     * This holds counters describing how busy a connection pool is.
+     */
+    struct ConnectionPoolStatistics {
+        /**
+         * This is the number of connections in the pool used only for
+         * read-only queries.
+         */
+        size_t readers = 0;
+
+        /**
+         * This is the number of reader connections currently held
+         * by statements.
+         */
+        size_t readersInUse = 0;
+
+        /**
+         * This is the largest number of reader connections which have
+         * been held by statements at once.
+         */
+        size_t peakReadersInUse = 0;
+
+        /**
+         * This is the number of read-only statements built on
+         * reader connections.
+         */
+        size_t reads = 0;
+
+        /**
+         * This is the number of statements built or executed on the
+         * writer connection.
+         */
+        size_t writes = 0;
+
+        /**
+         * This is the number of times a read-only statement had to wait
+         * for a reader connection because all of them were in use.
+         */
+        size_t readerWaits = 0;
+    };
+
+    /**
+     * This is a database which owns several connections to another
+     * database, so that it may be used by many threads at once.
+     *
+     * One connection, the writer, is used for everything other than
+     * read-only queries (statements starting with SELECT), and is used by
+     * one thread at a time.  Each read-only query is given a connection
+     * of its own, a reader, for as long as its statement is held, so that
+     * readers on different threads don't wait for each other or for the
+     * writer.  If every reader is in use, the query waits for one to be
+     * released, so statements for read-only queries should be released
+     * promptly.  While a transaction is open, read-only queries use the
+     * writer instead, so that they see the changes made in the transaction.
+     * Transactions are tracked whether they're begun and ended with the
+     * transaction methods or with BEGIN, COMMIT, END, and ROLLBACK
+     * statements.
+     *
+     * The connections must all refer to the same stored data, so that
+     * readers see the changes made through the writer.  Statements
+     * handed out by the pool may each be used by one thread at a time.
+     * The writer is shared, so changes made by several threads at once
+     * (especially within transactions) must be coordinated by the caller.
+     */
+    class ConnectionPool
+        : public Database
+    {
+        // Types
+    public:
+        /**
+         * This is the type of function used to make connections
+         * for the pool.
+         */
+        using ConnectionFactory = std::function< std::shared_ptr< Database >() >;
+
+        // Lifecycle
+    public:
+        ~ConnectionPool() noexcept;
+        ConnectionPool(const ConnectionPool&) = delete;
+        ConnectionPool(ConnectionPool&&) noexcept;
+        ConnectionPool& operator=(const ConnectionPool&) = delete;
+        ConnectionPool& operator=(ConnectionPool&&) noexcept;
+
+        // Construction
+    public:
+        /**
+         * This constructs the pool, making its connections.
+         *
+         * @param[in] connect
+         *     This is the function to call to make each connection.
+         *
+         * @param[in] readerCount
+         *     This is the number of reader connections to make, in
+         *     addition to the writer connection.  If zero, read-only
+         *     queries use the writer.
+         */
+        ConnectionPool(
+            ConnectionFactory connect,
+            size_t readerCount
+        );
+
+        // Methods
+    public:
+        /**
+         * This returns counters describing how busy the pool is.
+         *
+         * @return
+         *     Counters describing how busy the pool is are returned.
+         */
+        ConnectionPoolStatistics GetStatistics() const;
+
+        // Database
+    public:
+        virtual BuildStatementResults BuildStatement(
+            const std::string& statement
+        ) override;
+        virtual std::string ExecuteStatement(const std::string& statement) override;
+        virtual std::string BeginTransaction() override;
+        virtual std::string CommitTransaction() override;
+        virtual std::string RollbackTransaction() override;
+        virtual std::string ApplyWriteBatch(const WriteBatch& batch) override;
+        virtual Blob CreateSnapshot() override;
+        virtual std::string InstallSnapshot(const Blob& blob) override;
+        virtual std::shared_ptr< SnapshotReader > CreateSnapshotReader(size_t chunkSize) override;
+        virtual std::shared_ptr< SnapshotReader > CaptureSnapshot(size_t chunkSize) override;
+        virtual std::shared_ptr< SnapshotWriter > CreateSnapshotWriter() override;
+        virtual uint64_t GetSnapshotId() override;
+        virtual DeltaSnapshot CreateDeltaSnapshot(uint64_t baseId) override;
+        virtual std::string InstallDeltaSnapshot(const DeltaSnapshot& snapshot) override;
+
+        // Private Properties
+    private:
+        /**
+         * This is the type of structure that contains the private
+         * properties of the instance.  It is defined in the implementation
+         * and declared here to ensure that it is scoped inside the class.
+         */
+        struct Impl;
+
+        /**
+         * This contains the private properties of the instance.
+         */
+        std::unique_ptr< Impl > impl_;
+    };
+
+}
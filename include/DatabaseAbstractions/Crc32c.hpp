@@ -0,0 +1,51 @@
+#pragma once
+
+/**
+ * @file Crc32c.hpp
+ *
+ * This file declares the DatabaseAbstractions::Crc32c function, which
+ * computes the CRC-32C (Castagnoli) checksum used to verify the integrity
+ * of snapshots.  Where the processor has instructions for computing it
+ * (SSE 4.2 on x86, or the CRC extension on ARMv8), they're used;
+ * otherwise, a portable table-driven method is used.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace DatabaseAbstractions {
+
+    /**
+     * This computes the CRC-32C (Castagnoli) checksum of the given data.
+     *
+     * @param[in] data
+     *     This points to the data to checksum.
+     *
+     * @param[in] size
+     *     This is the number of bytes of data to checksum.
+     *
+     * @param[in] crc
+     *     This is the checksum of any data preceding the given data,
+     *     so that the checksum of a large buffer can be computed
+     *     piece by piece.  It's zero for the first piece.
+     *
+     * @return
+     *     The checksum of all the data so far is returned.
+     */
+    uint32_t Crc32c(
+        const void* data,
+        size_t size,
+        uint32_t crc = 0
+    );
+
+    /**
+     * This determines whether or not Crc32c uses processor instructions
+     * made for computing the checksum, rather than the portable method.
+     *
+     * @return
+     *     An indication of whether or not Crc32c uses processor
+     *     instructions made for computing the checksum is returned.
+     */
+    bool IsCrc32cAccelerated();
+
+}
@@ -11,8 +11,12 @@
  * of concrete database implementation details into the business layer.
  */
 
+#include "RowBatch.hpp"
+#include "Snapshot.hpp"
 #include "Value.hpp"
+#include "WriteBatch.hpp"
 
+#include <functional>
 #include <initializer_list>
 #include <memory>
 #include <stddef.h>
@@ -22,8 +26,6 @@
 
 namespace DatabaseAbstractions {
 
-    using Blob = std::vector< uint8_t >;
-
     struct StepStatementResults {
         /**
          * This flag is set if there are no more rows to fetch with the
@@ -37,6 +39,23 @@ namespace DatabaseAbstractions {
         std::string error;
     };
 
+    /**
+     * This is the type of function called with the results of stepping
+     * a statement asynchronously.
+     */
+    using StepStatementCallback = std::function<
+        void(const StepStatementResults& results)
+    >;
+
+    /**
+     * This is the type of function called when an asynchronous operation
+     * which produces no results other than an error completes.  The error
+     * is empty if the operation succeeded.
+     */
+    using CompletionCallback = std::function<
+        void(const std::string& error)
+    >;
+
     /**
      * This is an abstract interface to an object which represents an
      * SQL statement prepared for use with a database.  It can be used to:
@@ -46,14 +65,145 @@ namespace DatabaseAbstractions {
      */
     class PreparedStatement {
     public:
+        /**
+         * This binds a value to one of the parameters of the statement.
+         *
+         * If the value is a borrowed blob (see Value::IsBorrowed), the
+         * implementation may use the referenced data directly rather
+         * than copying it, so the caller must keep the data valid and
+         * unchanged until the statement is next reset or destroyed.
+         *
+         * @param[in] index
+         *     This is the index of the parameter to bind.
+         *
+         * @param[in] value
+         *     This is the value to bind to the parameter.
+         */
         virtual void BindParameter(
             int index,
             const Value& value
         ) = 0;
         virtual void BindParameters(std::initializer_list< const Value > values) = 0;
+
+        /**
+         * These bind values to parameters of the statement, handing the
+         * values over to the statement, so that their text or binary data
+         * can be kept by the statement without being copied.
+         *
+         * The base implementations pass the values to the versions of
+         * BindParameter which take them by reference.  Implementations
+         * may override these to take the values instead.
+         *
+         * @param[in] index
+         *     This is the index of the parameter to bind.
+         *
+         * @param[in] value
+         *     This is the value to bind to the parameter.
+         *
+         * @param[in] values
+         *     These are the values to bind to the parameters of the
+         *     statement, starting with the first one.
+         */
+        virtual void BindParameter(
+            int index,
+            Value&& value
+        );
+        virtual void BindParameters(std::vector< Value >&& values);
+
+        /**
+         * This fetches the value of one of the columns of the current row.
+         *
+         * When fetching a blob, the implementation may return a borrowed
+         * blob (see Value::IsBorrowed) which refers directly to its row
+         * buffer.  Such a value is only valid until the statement is next
+         * stepped or reset, so call Value::Own on it to keep it longer.
+         *
+         * @param[in] index
+         *     This is the index of the column to fetch.
+         *
+         * @param[in] type
+         *     This is the type of value expected in the column.
+         *
+         * @return
+         *     The value of the column is returned.
+         */
         virtual Value FetchColumn(int index, Value::Type type) = 0;
+
+        /**
+         * This fetches the value of one of the columns of the current row
+         * into the given value, so that the memory already held by the
+         * value for text or binary data can be reused rather than
+         * allocating more.  Borrowed blobs may be fetched, as for the
+         * other version of FetchColumn.
+         *
+         * The base implementation assigns the value returned by the
+         * other version of FetchColumn.  Implementations may override
+         * this to copy the column directly into the given value.
+         *
+         * @param[in] index
+         *     This is the index of the column to fetch.
+         *
+         * @param[in] type
+         *     This is the type of value expected in the column.
+         *
+         * @param[out] value
+         *     This is where to store the value of the column.
+         */
+        virtual void FetchColumn(
+            int index,
+            Value::Type type,
+            Value& value
+        );
+
         virtual void Reset() = 0;
         virtual StepStatementResults Step() = 0;
+
+        /**
+         * This steps the statement repeatedly, fetching the columns of
+         * each row into the given batch, until the given number of rows
+         * have been fetched, there are no more rows, or an error occurs.
+         *
+         * The batch is cleared first, and the number and types of the
+         * columns fetched are taken from the batch.  Text and blobs are
+         * copied into the arena of the batch, so that they remain valid
+         * after the next step.  The base implementation uses Step and
+         * FetchColumn.  Implementations may override this to fetch rows
+         * more efficiently.
+         *
+         * @param[in] maxRows
+         *     This is the maximum number of rows to fetch.
+         *
+         * @param[in,out] batch
+         *     This is the batch into which to fetch the rows.
+         *
+         * @return
+         *     The results of stepping the statement are returned.
+         *     The done flag is set if the statement ran out of rows
+         *     while filling the batch.
+         */
+        virtual StepStatementResults StepBatch(
+            size_t maxRows,
+            RowBatch& batch
+        );
+
+        /**
+         * This steps the statement without waiting for it to finish,
+         * calling the given function with the results once it does.
+         * The function may be called on another thread, before or after
+         * this method returns, so it must not assume either.  Nothing else
+         * may be done with the statement until the function is called,
+         * except from within the function itself.
+         *
+         * The base implementation calls Step and then the function,
+         * before returning.  Implementations which can do the work in the
+         * background (such as statements prepared by AsyncDatabase)
+         * override this.
+         *
+         * @param[in] callback
+         *     This is the function to call with the results of stepping
+         *     the statement.
+         */
+        virtual void StepAsync(StepStatementCallback callback);
     };
 
     struct BuildStatementResults {
@@ -61,6 +211,14 @@ namespace DatabaseAbstractions {
         std::string error;
     };
 
+    /**
+     * This is the type of function called with the results of
+     * preparing a statement asynchronously.
+     */
+    using BuildStatementCallback = std::function<
+        void(const BuildStatementResults& results)
+    >;
+
     /**
      * This is an abstract interface for general-purpose access to some
      * kind of relational database which understands SQL statements.
@@ -75,11 +233,224 @@ namespace DatabaseAbstractions {
         ) = 0;
         virtual std::string ExecuteStatement(const std::string& statement) = 0;
 
+        /**
+         * This opens a transaction, so that the changes made by the
+         * statements which follow are made permanent together, when the
+         * transaction is committed, or not at all, if it's rolled back.
+         * Transactions do not nest.
+         *
+         * The base implementation executes a "BEGIN" statement.
+         *
+         * @return
+         *     If an error occurs, a description of the error is returned.
+         *     Otherwise, an empty string is returned.
+         */
+        virtual std::string BeginTransaction();
+
+        /**
+         * This makes the changes made during the open transaction
+         * permanent, and closes the transaction.
+         *
+         * The base implementation executes a "COMMIT" statement.
+         *
+         * @return
+         *     If an error occurs, a description of the error is returned.
+         *     Otherwise, an empty string is returned.
+         */
+        virtual std::string CommitTransaction();
+
+        /**
+         * This undoes the changes made during the open transaction,
+         * and closes the transaction.
+         *
+         * The base implementation executes a "ROLLBACK" statement.
+         *
+         * @return
+         *     If an error occurs, a description of the error is returned.
+         *     Otherwise, an empty string is returned.
+         */
+        virtual std::string RollbackTransaction();
+
+        /**
+         * This applies all the statements in the given batch, in order,
+         * as one transaction.  If any statement fails, none of the changes
+         * made by the batch are kept.  No transaction may be open when
+         * this is called.
+         *
+         * The base implementation opens a transaction, prepares each
+         * statement (reusing the previous one when consecutive statements
+         * have the same text), binds its parameters, steps it until it's
+         * done, and then commits the transaction.  Implementations may
+         * override this to group the work further, for example to flush
+         * their storage once per batch rather than once per statement.
+         *
+         * @param[in] batch
+         *     This is the batch of statements to apply.
+         *
+         * @return
+         *     If an error occurs, a description of the error is returned.
+         *     Otherwise, an empty string is returned.
+         */
+        virtual std::string ApplyWriteBatch(const WriteBatch& batch);
+
+        /**
+         * These are asynchronous versions of BuildStatement,
+         * ExecuteStatement and ApplyWriteBatch.  Each starts the operation
+         * without waiting for it to finish, and calls the given function
+         * with the results once it does.  The function may be called on
+         * another thread, before or after the method returns, so it must
+         * not assume either.
+         *
+         * The base implementations carry out the operation synchronously
+         * and then call the function, before returning.  To move the work
+         * off of the calling thread for any implementation, wrap the
+         * database in an AsyncDatabase.
+         *
+         * @param[in] statement
+         *     This is the SQL text of the statement to build or execute.
+         *
+         * @param[in] batch
+         *     This is the batch of statements to apply.  It's given up
+         *     by the caller, so that it can be kept until it's applied.
+         *
+         * @param[in] callback
+         *     This is the function to call with the results of the
+         *     operation.
+         */
+        virtual void BuildStatementAsync(
+            const std::string& statement,
+            BuildStatementCallback callback
+        );
+        virtual void ExecuteAsync(
+            const std::string& statement,
+            CompletionCallback callback
+        );
+        virtual void ApplyWriteBatchAsync(
+            WriteBatch&& batch,
+            CompletionCallback callback
+        );
+
         // These are designed for use in obtaining blobs holding the complete
         // state of the database (schema and data) and using them to replace
         // the database using those blobs.
         virtual Blob CreateSnapshot() = 0;
         virtual std::string InstallSnapshot(const Blob& blob) = 0;
+
+        /**
+         * This returns an object which produces a snapshot of the
+         * database one chunk at a time.  The chunks, concatenated in
+         * order, form the same kind of blob returned by CreateSnapshot.
+         *
+         * The base implementation creates the complete snapshot using
+         * CreateSnapshot and then hands it out in chunks.  Implementations
+         * may override this to produce chunks as they go, so that the
+         * complete snapshot never needs to be held in memory and the
+         * first chunks are available before the rest are produced.
+         *
+         * @param[in] chunkSize
+         *     This is the maximum number of bytes in each chunk.
+         *
+         * @return
+         *     The snapshot reader is returned.
+         */
+        virtual std::shared_ptr< SnapshotReader > CreateSnapshotReader(size_t chunkSize);
+
+        /**
+         * This captures the current state of the database, and returns
+         * an object which produces a snapshot of that state one chunk at
+         * a time, like the one returned by CreateSnapshotReader.  Unlike
+         * that one, this reader keeps producing the captured state even
+         * as the database goes on changing, and it may be read on any
+         * thread, independently of the database, so that a snapshot can
+         * be written out in the background without holding up the
+         * statements executed meanwhile.  The database may be destroyed
+         * before the reader.
+         *
+         * The base implementation creates the complete snapshot using
+         * CreateSnapshot and then hands it out in chunks, so the capture
+         * takes as long as creating the snapshot.  Implementations may
+         * override this to capture the state far more cheaply, such as
+         * by sharing their storage with the reader and copying any part
+         * of it before changing it.
+         *
+         * @param[in] chunkSize
+         *     This is the maximum number of bytes in each chunk.
+         *
+         * @return
+         *     The snapshot reader is returned.
+         */
+        virtual std::shared_ptr< SnapshotReader > CaptureSnapshot(size_t chunkSize);
+
+        /**
+         * This returns an object which accepts a snapshot one chunk at a
+         * time, and installs it in the database once it's finished.
+         * The database must outlive the writer.
+         *
+         * The base implementation collects the chunks and installs the
+         * complete snapshot using InstallSnapshot, so the whole snapshot
+         * is held in memory, in addition to the state decoded from it,
+         * until the install is finished.  Implementations may override
+         * this to consume the chunks as they arrive.
+         *
+         * @return
+         *     The snapshot writer is returned.
+         */
+        virtual std::shared_ptr< SnapshotWriter > CreateSnapshotWriter();
+
+        /**
+         * This returns an identifier of the current state of the database,
+         * which can be given to CreateDeltaSnapshot on another database to
+         * get the changes needed to bring this one up to date.
+         *
+         * Implementations which support delta snapshots must assign
+         * identifiers deterministically, so that members of the cluster
+         * which have applied the same changes agree on them.  The base
+         * implementation returns zero, meaning the state is unknown.
+         *
+         * @return
+         *     The identifier of the current state of the database
+         *     is returned, or zero if it isn't known.
+         */
+        virtual uint64_t GetSnapshotId();
+
+        /**
+         * This produces the changes made to the database since the state
+         * with the given identifier.  If the database can't produce those
+         * changes (for example, if it no longer tracks changes that far
+         * back, or the identifier is zero or unknown), it produces a full
+         * snapshot instead.
+         *
+         * The base implementation always produces a full snapshot using
+         * CreateSnapshot.
+         *
+         * @param[in] baseId
+         *     This identifies the state of the database from which
+         *     to produce the changes.
+         *
+         * @return
+         *     The delta or full snapshot is returned.
+         */
+        virtual DeltaSnapshot CreateDeltaSnapshot(uint64_t baseId);
+
+        /**
+         * This installs a snapshot produced by CreateDeltaSnapshot.
+         * A full snapshot replaces the database.  A delta is applied on
+         * top of the current state, which must be the state identified
+         * by the delta's base identifier; otherwise, an error is returned
+         * and the database is left unchanged, so that the caller can fall
+         * back to requesting a full snapshot.
+         *
+         * The base implementation installs full snapshots using
+         * InstallSnapshot, and rejects deltas.
+         *
+         * @param[in] snapshot
+         *     This is the delta or full snapshot to install.
+         *
+         * @return
+         *     If an error occurs, a description of the error is returned.
+         *     Otherwise, an empty string is returned.
+         */
+        virtual std::string InstallDeltaSnapshot(const DeltaSnapshot& snapshot);
     };
 
 }
@@ -0,0 +1,125 @@
+#pragma once
+
+/**
+ * @file InMemoryDatabase.hpp
+ *
+ * This file defines the DatabaseAbstractions::InMemoryDatabase class,
+ * a self-contained implementation of the Database interface which keeps
+ * all of its data in memory.
+ */
+
+#include "Database.hpp"
+
+#include <memory>
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+
+namespace DatabaseAbstractions {
+
+    /**
+     * This is an implementation of the Database interface which keeps
+     * all of its data in memory and depends on nothing outside of this
+     * library.  It's meant to be used as a fast test double and as a
+     * baseline for measuring the performance of other implementations.
+     *
+     * It understands the following subset of SQL:
+     * - CREATE TABLE [IF NOT EXISTS] with column types, PRIMARY KEY,
+     *   UNIQUE, NOT NULL and DEFAULT constraints
+     * - CREATE [UNIQUE] INDEX [IF NOT EXISTS] on a single column
+     * - DROP TABLE [IF EXISTS] and DROP INDEX [IF EXISTS]
+     * - INSERT [OR REPLACE] INTO and REPLACE INTO, with one or more
+     *   rows of values
+     * - SELECT (columns, "*", or "COUNT(*)") with WHERE, ORDER BY
+     *   and LIMIT clauses
+     * - UPDATE ... SET with a WHERE clause
+     * - DELETE FROM with a WHERE clause
+     * - BEGIN [TRANSACTION], COMMIT [TRANSACTION] (or END) and
+     *   ROLLBACK [TRANSACTION]
+     *
+     * WHERE clauses consist of comparisons (=, <>, <, <=, >, >=) between
+     * a column and a value, joined by AND.  Values may be literals or
+     * parameters ("?" or "?NNN").  Parameters are numbered from 1 and
+     * columns are numbered from 0, as in SQLite.  An INTEGER PRIMARY KEY
+     * column is given the next available key when a null is inserted
+     * into it.
+     *
+     * Rows are stored contiguously in fixed-size pages.  Primary keys
+     * and unique columns are indexed with hash tables, and all indexed
+     * columns are also kept in ordered indexes, which are used for
+     * comparisons and ordering.  Each statement is atomic: if it fails,
+     * any changes it made are undone.  Transactions are kept atomic the
+     * same way, by undoing their changes, including changes to the schema,
+     * when they're rolled back.
+     *
+     * Each statement which changes the database outside of a transaction,
+     * and each transaction which changes it, advances its snapshot
+     * identifier, and the changes are kept in a bounded log, so that
+     * delta snapshots can be produced for databases which have fallen
+     * only a little behind.  Snapshots taken while a transaction is
+     * open leave out the changes it has made so far, so that they
+     * always match their snapshot identifier.  Snapshots written to the
+     * database in chunks are decoded as the chunks arrive, so only the
+     * tables being built, and not the encoded snapshot, are held in
+     * memory while it's being installed.
+     *
+     * Prepared statements keep the database's data alive, so they may
+     * outlive the database object itself.  Like other implementations,
+     * the database is not safe to use from multiple threads at once.
+     */
+    class InMemoryDatabase
+        : public Database
+    {
+        // Lifecycle
+    public:
+        ~InMemoryDatabase() noexcept;
+        InMemoryDatabase(const InMemoryDatabase&) = delete;
+        InMemoryDatabase(InMemoryDatabase&&) noexcept;
+        InMemoryDatabase& operator=(const InMemoryDatabase&) = delete;
+        InMemoryDatabase& operator=(InMemoryDatabase&&) noexcept;
+
+        // Construction
+    public:
+        /**
+         * This constructs an empty database.
+         *
+         * @param[in] maxChangeLogSize
+         *     This is the maximum number of row and schema changes to
+         *     keep in the log used to produce delta snapshots.
+         */
+        explicit InMemoryDatabase(size_t maxChangeLogSize = 65536);
+
+        // Database
+    public:
+        virtual BuildStatementResults BuildStatement(
+            const std::string& statement
+        ) override;
+        virtual std::string ExecuteStatement(const std::string& statement) override;
+        virtual std::string BeginTransaction() override;
+        virtual std::string CommitTransaction() override;
+        virtual std::string RollbackTransaction() override;
+        virtual Blob CreateSnapshot() override;
+        virtual std::string InstallSnapshot(const Blob& blob) override;
+        virtual std::shared_ptr< SnapshotReader > CreateSnapshotReader(size_t chunkSize) override;
+        virtual std::shared_ptr< SnapshotReader > CaptureSnapshot(size_t chunkSize) override;
+        virtual std::shared_ptr< SnapshotWriter > CreateSnapshotWriter() override;
+        virtual uint64_t GetSnapshotId() override;
+        virtual DeltaSnapshot CreateDeltaSnapshot(uint64_t baseId) override;
+        virtual std::string InstallDeltaSnapshot(const DeltaSnapshot& snapshot) override;
+
+        // Private Properties
+    private:
+        /**
+         * This is the type of structure that contains the private
+         * properties of the instance.  It is defined in the implementation
+         * and declared here to ensure that it is scoped inside the class.
+         */
+        struct Impl;
+
+        /**
+         * This contains the private properties of the instance.
+         */
+        std::unique_ptr< Impl > impl_;
+    };
+
+}
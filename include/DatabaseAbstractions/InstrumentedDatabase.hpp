@@ -0,0 +1,302 @@
+#pragma once
+
+/**
+ * @file InstrumentedDatabase.hpp
+ *
+ * This file defines the DatabaseAbstractions::InstrumentedDatabase class,
+ * which wraps a database in order to measure how it's used.
+ */
+
+#include "Database.hpp"
+
+#include <memory>
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace DatabaseAbstractions {
+
+    /**
+     * This is the number of different SQL texts which an instrumented
+     * database measures separately unless another number is given.
+     */
+    constexpr size_t DEFAULT_MAX_MEASURED_STATEMENTS = 1000;
+
+    /**
+     * This summarizes how long a kind of operation has taken.  Durations
+     * are kept in a histogram whose buckets grow in size along with the
+     * durations they hold, so that percentiles are accurate to within
+     * about 12% no matter how long the operations take.
+     */
+    struct LatencyStatistics {
+        // Properties
+
+        /**
+         * This is the number of operations measured.
+         */
+        uint64_t count = 0;
+
+        /**
+         * This is the total duration of the operations, in nanoseconds.
+         */
+        uint64_t totalNanoseconds = 0;
+
+        /**
+         * This is the longest duration of any operation, in nanoseconds.
+         */
+        uint64_t maxNanoseconds = 0;
+
+        /**
+         * These are the numbers of operations whose durations fell into
+         * each bucket of the histogram.  Use GetBucketLowerBound to find
+         * the shortest duration which falls into each bucket.
+         */
+        std::vector< uint64_t > buckets;
+
+        // Methods
+
+        /**
+         * This returns the shortest duration, in nanoseconds, which
+         * falls into the given bucket of the histogram.
+         *
+         * @param[in] bucket
+         *     This is the index of the bucket.
+         *
+         * @return
+         *     The shortest duration which falls into the bucket
+         *     is returned.
+         */
+        static uint64_t GetBucketLowerBound(size_t bucket);
+
+        /**
+         * This estimates the duration, in nanoseconds, within which the
+         * given fraction of the operations finished.
+         *
+         * @param[in] fraction
+         *     This is the fraction of operations (for example, 0.99 for
+         *     the 99th percentile).
+         *
+         * @return
+         *     The estimated duration is returned, or zero if no
+         *     operations have been measured.
+         */
+        uint64_t GetPercentile(double fraction) const;
+    };
+
+    /**
+     * This describes how statements built from one SQL text have been used.
+     */
+    struct StatementMetrics {
+        /**
+         * This is the SQL text of the statements.  It's empty for the
+         * entry measuring statements whose SQL texts were left without
+         * entries of their own.
+         */
+        std::string text;
+
+        /**
+         * This flag is set for the entry measuring all statements whose
+         * SQL texts were first used after the limit on the number of
+         * SQL texts measured separately was reached.
+         */
+        bool other = false;
+
+        /**
+         * This measures the time spent preparing the statements.
+         */
+        LatencyStatistics build;
+
+        /**
+         * This measures the time spent executing the SQL text
+         * directly, without preparing a statement.
+         */
+        LatencyStatistics execute;
+
+        /**
+         * This measures the time spent stepping the statements.
+         * Each call to StepBatch counts as one step.
+         */
+        LatencyStatistics step;
+
+        /**
+         * This measures the time spent fetching columns.
+         */
+        LatencyStatistics fetch;
+
+        /**
+         * This is the number of times preparing, executing, or stepping
+         * a statement failed.
+         */
+        uint64_t errors = 0;
+
+        /**
+         * This is the number of rows produced by stepping the statements.
+         */
+        uint64_t rows = 0;
+
+        /**
+         * This is the number of bytes of text and blobs fetched
+         * from the rows.
+         */
+        uint64_t bytesFetched = 0;
+    };
+
+    /**
+     * This describes the snapshots made or installed by a database.
+     */
+    struct SnapshotMetrics {
+        /**
+         * This measures the time spent making or installing snapshots.
+         * Snapshots made or installed in chunks are measured one chunk
+         * at a time.
+         */
+        LatencyStatistics duration;
+
+        /**
+         * This is the number of snapshots made or installed, including
+         * delta snapshots.
+         */
+        uint64_t snapshots = 0;
+
+        /**
+         * This is the total size, in bytes, of the snapshots.
+         */
+        uint64_t bytes = 0;
+    };
+
+    /**
+     * This is a copy of all the measurements made by an instrumented
+     * database at one point in time.
+     */
+    struct DatabaseMetrics {
+        /**
+         * These describe how statements have been used, one entry per
+         * SQL text, in no particular order, followed by one entry for
+         * all other SQL texts if the limit on the number of SQL texts
+         * measured separately was reached.
+         */
+        std::vector< StatementMetrics > statements;
+
+        /**
+         * This measures the time spent applying write batches.
+         */
+        LatencyStatistics writeBatches;
+
+        /**
+         * This describes the snapshots made by the database.
+         */
+        SnapshotMetrics snapshotsCreated;
+
+        /**
+         * This describes the snapshots installed in the database.
+         */
+        SnapshotMetrics snapshotsInstalled;
+    };
+
+    /**
+     * This is a database which passes everything through to another
+     * database, measuring how long each operation takes and how much
+     * data it handles.  Statements, snapshot readers, and snapshot
+     * writers it hands out are measured as well.
+     *
+     * The measurements are kept in counters which are updated without
+     * locks, so the database and its statements may be used by several
+     * threads at once, as long as the wrapped database allows it.
+     * Finding the counters for a SQL text takes a short lock, once each
+     * time a statement is built or executed directly.  Statements keep
+     * their counters, so stepping them and fetching columns never lock.
+     * GetMetrics copies the counters as they are at the time, so it's
+     * cheap enough to call periodically for monitoring.
+     *
+     * Each SQL text measured separately has several histograms of its
+     * own, so only a limited number of SQL texts are measured that way.
+     * Statements using any other SQL text are measured together in one
+     * more entry, so that memory use doesn't grow with the number of
+     * different SQL texts used.
+     */
+    class InstrumentedDatabase
+        : public Database
+    {
+        // Lifecycle
+    public:
+        ~InstrumentedDatabase() noexcept;
+        InstrumentedDatabase(const InstrumentedDatabase&) = delete;
+        InstrumentedDatabase(InstrumentedDatabase&&) noexcept;
+        InstrumentedDatabase& operator=(const InstrumentedDatabase&) = delete;
+        InstrumentedDatabase& operator=(InstrumentedDatabase&&) noexcept;
+
+        // Construction
+    public:
+        /**
+         * This constructs the wrapper.
+         *
+         * @param[in] database
+         *     This is the database to wrap.
+         *
+         * @param[in] maxStatements
+         *     This is the number of different SQL texts to measure
+         *     separately.
+         */
+        explicit InstrumentedDatabase(
+            std::shared_ptr< Database > database,
+            size_t maxStatements = DEFAULT_MAX_MEASURED_STATEMENTS
+        );
+
+        // Methods
+    public:
+        /**
+         * This returns a copy of the measurements made so far.
+         *
+         * @return
+         *     A copy of the measurements made so far is returned.
+         */
+        DatabaseMetrics GetMetrics() const;
+
+        // Database
+    public:
+        virtual BuildStatementResults BuildStatement(
+            const std::string& statement
+        ) override;
+        virtual std::string ExecuteStatement(const std::string& statement) override;
+        virtual std::string BeginTransaction() override;
+        virtual std::string CommitTransaction() override;
+        virtual std::string RollbackTransaction() override;
+        virtual std::string ApplyWriteBatch(const WriteBatch& batch) override;
+        virtual void BuildStatementAsync(
+            const std::string& statement,
+            BuildStatementCallback callback
+        ) override;
+        virtual void ExecuteAsync(
+            const std::string& statement,
+            CompletionCallback callback
+        ) override;
+        virtual void ApplyWriteBatchAsync(
+            WriteBatch&& batch,
+            CompletionCallback callback
+        ) override;
+        virtual Blob CreateSnapshot() override;
+        virtual std::string InstallSnapshot(const Blob& blob) override;
+        virtual std::shared_ptr< SnapshotReader > CreateSnapshotReader(size_t chunkSize) override;
+        virtual std::shared_ptr< SnapshotReader > CaptureSnapshot(size_t chunkSize) override;
+        virtual std::shared_ptr< SnapshotWriter > CreateSnapshotWriter() override;
+        virtual uint64_t GetSnapshotId() override;
+        virtual DeltaSnapshot CreateDeltaSnapshot(uint64_t baseId) override;
+        virtual std::string InstallDeltaSnapshot(const DeltaSnapshot& snapshot) override;
+
+        // Private Properties
+    private:
+        /**
+         * This is the type of structure that contains the private
+         * properties of the instance.  It is defined in the implementation
+         * and declared here to ensure that it is scoped inside the class.
+         */
+        struct Impl;
+
+        /**
+         * This contains the private properties of the instance.
+         */
+        std::unique_ptr< Impl > impl_;
+    };
+
+}
@@ -0,0 +1,177 @@
+#pragma once
+
+/**
+ * @file LogStore.hpp
+ *
+ * This file defines the DatabaseAbstractions::LogStore class, an
+ * abstract interface to storage for a replicated log, such as the log
+ * of entries kept by each member of a Raft cluster.
+ */
+
+#include "Value.hpp"
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace DatabaseAbstractions {
+
+    /**
+     * This refers to one entry of a log, whose data is owned by the
+     * log store.
+     */
+    struct LogEntryView {
+        /**
+         * This is the position of the entry in the log.  The first
+         * entry ever appended to a log has index 1.
+         */
+        uint64_t index = 0;
+
+        /**
+         * This is the term of leadership in which the entry was made.
+         */
+        uint64_t term = 0;
+
+        /**
+         * This refers to the data of the entry, owned by the log store.
+         */
+        BlobView data;
+    };
+
+    /**
+     * This is an abstract interface to storage for a log of entries,
+     * which can only be added to at the end, and removed from at
+     * either end.  Each entry has an index, one more than that of the
+     * entry before it, a term, and some data of its own.
+     *
+     * Unlike the state machine kept in a Database, the log doesn't need
+     * SQL, so it can be stored far more cheaply, and the two can be
+     * tuned independently.
+     */
+    class LogStore {
+    public:
+        virtual ~LogStore() = default;
+
+        /**
+         * This returns the index of the first entry in the log.
+         *
+         * @return
+         *     The index of the first entry in the log is returned.
+         *     If the log is empty, this is one more than the index
+         *     returned by GetLastIndex.
+         */
+        virtual uint64_t GetFirstIndex() = 0;
+
+        /**
+         * This returns the index of the last entry in the log.
+         *
+         * @return
+         *     The index of the last entry in the log is returned.
+         *     If the log is empty, this is one less than the index
+         *     returned by GetFirstIndex.
+         */
+        virtual uint64_t GetLastIndex() = 0;
+
+        /**
+         * This returns the term of the given entry of the log.
+         *
+         * @param[in] index
+         *     This is the index of the entry whose term to return.
+         *
+         * @return
+         *     The term of the entry is returned, or zero if the log
+         *     doesn't have the entry.
+         */
+        virtual uint64_t GetTerm(uint64_t index) = 0;
+
+        /**
+         * This adds an entry to the end of the log, with an index one
+         * more than the last index of the log.  The entry isn't
+         * guaranteed to survive a crash until Sync is called, so that
+         * several entries can be appended and then made durable
+         * together.
+         *
+         * @param[in] term
+         *     This is the term of the entry.
+         *
+         * @param[in] data
+         *     This is the data of the entry, which is copied.
+         *
+         * @return
+         *     If an error occurs, a description of the error is returned.
+         *     Otherwise, an empty string is returned.
+         */
+        virtual std::string Append(
+            uint64_t term,
+            BlobView data
+        ) = 0;
+
+        /**
+         * This makes sure that every change made to the log so far
+         * will survive a crash.
+         *
+         * @return
+         *     If an error occurs, a description of the error is returned.
+         *     Otherwise, an empty string is returned.
+         */
+        virtual std::string Sync() = 0;
+
+        /**
+         * This looks up a range of entries of the log.  The data of
+         * the entries is owned by the log store, and remains valid
+         * only until the log is next changed.
+         *
+         * @param[in] first
+         *     This is the index of the first entry to look up.
+         *
+         * @param[in] last
+         *     This is the index of the last entry to look up.
+         *
+         * @param[out] entries
+         *     This is where to store the entries.  Its existing contents
+         *     are replaced.
+         *
+         * @return
+         *     If an error occurs, such as the log not having all the
+         *     entries asked for, a description of the error is returned.
+         *     Otherwise, an empty string is returned.
+         */
+        virtual std::string Read(
+            uint64_t first,
+            uint64_t last,
+            std::vector< LogEntryView >& entries
+        ) = 0;
+
+        /**
+         * This removes every entry after the given one from the end of
+         * the log, as when a Raft follower's log conflicts with that of
+         * its leader.  The removal is made durable by the next call
+         * to Sync.
+         *
+         * @param[in] last
+         *     This is the index of the last entry to keep.
+         *
+         * @return
+         *     If an error occurs, a description of the error is returned.
+         *     Otherwise, an empty string is returned.
+         */
+        virtual std::string TruncateSuffix(uint64_t last) = 0;
+
+        /**
+         * This removes every entry up to and including the given one
+         * from the start of the log, as when the entries have been
+         * captured in a snapshot.  If the index is past the end of
+         * the log, the log is emptied, and the next entry appended
+         * will have the index following the given one.
+         *
+         * @param[in] last
+         *     This is the index of the last entry to remove.
+         *
+         * @return
+         *     If an error occurs, a description of the error is returned.
+         *     Otherwise, an empty string is returned.
+         */
+        virtual std::string CompactPrefix(uint64_t last) = 0;
+    };
+
+}
@@ -0,0 +1,180 @@
+#pragma once
+
+/**
+ * @file RowBatch.hpp
+ *
+ * This file defines the DatabaseAbstractions::RowBatch class, which holds
+ * a number of rows fetched from a database at once, arranged by column.
+ */
+
+#include "Arena.hpp"
+#include "Value.hpp"
+
+#include <memory>
+#include <stddef.h>
+#include <vector>
+
+namespace DatabaseAbstractions {
+
+    /**
+     * This is a reusable buffer of rows fetched from a database, stored
+     * column by column.  The values in the buffer are kept when the batch
+     * is cleared, so that filling it again can reuse their storage
+     * rather than allocating new memory.
+     *
+     * The batch also owns an arena, into which the text and blobs of its
+     * values are normally copied (see Value::Assign), so that they don't
+     * each need memory of their own, and are all released at once when
+     * the batch is cleared.  Copy any values which need to be kept longer
+     * than that.
+     */
+    class RowBatch {
+        // Lifecycle
+    public:
+        ~RowBatch() noexcept;
+        RowBatch(const RowBatch&) = delete;
+        RowBatch(RowBatch&&) noexcept;
+        RowBatch& operator=(const RowBatch&) = delete;
+        RowBatch& operator=(RowBatch&&) noexcept;
+
+        // Construction
+    public:
+        /**
+         * This constructs a batch for rows having the given columns.
+         *
+         * @param[in] columnTypes
+         *     These are the types of values to fetch for the columns
+         *     of each row.
+         *
+         * @param[in] capacity
+         *     This is the number of rows for which to preallocate values.
+         */
+        RowBatch(
+            const std::vector< Value::Type >& columnTypes,
+            size_t capacity = 0
+        );
+
+        // Methods
+    public:
+        /**
+         * This returns the number of columns in each row of the batch.
+         *
+         * @return
+         *     The number of columns in each row of the batch is returned.
+         */
+        size_t GetColumnCount() const;
+
+        /**
+         * This returns the type of value to fetch for the given column.
+         *
+         * @param[in] column
+         *     This is the index of the column whose type to return.
+         *
+         * @return
+         *     The type of value to fetch for the column is returned.
+         */
+        Value::Type GetColumnType(size_t column) const;
+
+        /**
+         * This returns the number of rows currently in the batch.
+         *
+         * @return
+         *     The number of rows currently in the batch is returned.
+         */
+        size_t GetRowCount() const;
+
+        /**
+         * This returns the number of rows the batch can hold without
+         * allocating more values.
+         *
+         * @return
+         *     The number of rows for which values are allocated
+         *     is returned.
+         */
+        size_t GetCapacity() const;
+
+        /**
+         * This returns the values of the given column, one per row,
+         * in row order.
+         *
+         * @param[in] column
+         *     This is the index of the column whose values to return.
+         *
+         * @return
+         *     A pointer to the value of the column in the first row
+         *     is returned.  The values for the other rows follow it.
+         */
+        const Value* GetColumn(size_t column) const;
+
+        /**
+         * This returns the value of one column in one row of the batch.
+         *
+         * @param[in] row
+         *     This is the index of the row holding the value.
+         *
+         * @param[in] column
+         *     This is the index of the column holding the value.
+         *
+         * @return
+         *     The value at the given row and column is returned.
+         */
+        const Value& GetValue(size_t row, size_t column) const;
+
+        /**
+         * This returns the value of one column in one row of the batch,
+         * so that it can be filled in.
+         *
+         * @param[in] row
+         *     This is the index of the row holding the value.
+         *
+         * @param[in] column
+         *     This is the index of the column holding the value.
+         *
+         * @return
+         *     The value at the given row and column is returned.
+         */
+        Value& GetValue(size_t row, size_t column);
+
+        /**
+         * This adds a row to the end of the batch, allocating values
+         * for it only if the batch is already at capacity.  The values
+         * of the new row are whatever was left there by a previous use
+         * of the batch, and are expected to be overwritten.
+         *
+         * @return
+         *     The index of the new row is returned.
+         */
+        size_t AddRow();
+
+        /**
+         * This returns the arena into which the text and blobs of the
+         * values of the batch should be copied.
+         *
+         * @return
+         *     The arena of the batch is returned.
+         */
+        Arena& GetArena();
+
+        /**
+         * This removes all rows from the batch, keeping the values
+         * allocated for them so they can be reused, and releases all
+         * the memory handed out by the arena of the batch.
+         */
+        void Clear();
+
+        // Private Properties
+    private:
+        /**
+         * This is the type of structure that contains the private
+         * properties of the instance.  It is defined in the implementation
+         * and declared here to ensure that it is scoped inside the class.
+         */
+        struct Impl;
+
+        /**
+         * This contains the private properties of the instance.
+         */
+        std::unique_ptr< Impl > impl_;
+    };
+
+}
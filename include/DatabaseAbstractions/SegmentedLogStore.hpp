@@ -0,0 +1,150 @@
+#pragma once
+
+/**
+ * @file SegmentedLogStore.hpp
+ *
+ * This file defines the DatabaseAbstractions::SegmentedLogStore class,
+ * an implementation of the LogStore interface which keeps the log in
+ * a series of append-only files.
+ */
+
+#include "LogStore.hpp"
+
+#include <memory>
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace DatabaseAbstractions {
+
+    /**
+     * This is the approximate number of bytes of entries kept in each
+     * segment of a segmented log store unless another size is given.
+     */
+    constexpr size_t DEFAULT_LOG_SEGMENT_SIZE = 16 * 1024 * 1024;
+
+    /**
+     * This is an implementation of the LogStore interface which keeps
+     * the log in a series of files called segments.  Entries are only
+     * ever appended to the last segment, and once it grows past the
+     * segment size, a new segment is started.  Each entry is stored with
+     * its term, its length, and a checksum, so that an entry torn by a
+     * crash is found and discarded when the log is opened again.  Only
+     * the last segment can be torn by a crash, so damage found in any
+     * other segment is reported as an error rather than discarded.
+     *
+     * The index and term of every entry is kept in memory, so looking
+     * up entries and terms never reads the files.  Entries in earlier
+     * segments are read straight from the files mapped into memory, and
+     * entries in the last segment from a copy of it kept in memory.
+     *
+     * Appending doesn't flush anything to disk; Sync does that for all
+     * the entries appended since it was last called.  Removing entries
+     * from the end of the log only shortens the segment they're in and
+     * deletes any segments after it, and removing entries from the
+     * start of the log only deletes segments holding nothing but removed
+     * entries, so no entries are ever rewritten.  The index of the
+     * first entry is kept in a small file of its own, along with the
+     * sequence numbers of the first and last segments.  That file is
+     * rewritten before each new segment is started and after segments
+     * are removed from the end, so that segment files left behind by
+     * removing entries are never taken to be part of the log.
+     *
+     * The files are named by adding extensions to a base path given
+     * when the log is opened: ".meta" for the file holding the index of
+     * the first entry and the range of segments, and a sequence number
+     * followed by ".log" for each segment.  Like other implementations, the log store is not safe
+     * to use from multiple threads at once.
+     */
+    class SegmentedLogStore
+        : public LogStore
+    {
+        // Lifecycle
+    public:
+        ~SegmentedLogStore() noexcept;
+        SegmentedLogStore(const SegmentedLogStore&) = delete;
+        SegmentedLogStore(SegmentedLogStore&&) noexcept;
+        SegmentedLogStore& operator=(const SegmentedLogStore&) = delete;
+        SegmentedLogStore& operator=(SegmentedLogStore&&) noexcept;
+
+        // Construction
+    public:
+        /**
+         * This constructs a log store which isn't yet open.
+         */
+        SegmentedLogStore();
+
+        // Methods
+    public:
+        /**
+         * This opens the log kept in the files with the given base path,
+         * creating it if it doesn't exist yet, and replacing any log
+         * previously opened by the object.
+         *
+         * @param[in] basePath
+         *     This is the path, without extension, of the files in which
+         *     the log is kept.  The directory must already exist.
+         *
+         * @param[in] segmentSize
+         *     This is the approximate number of bytes of entries to keep
+         *     in each segment.
+         *
+         * @return
+         *     If an error occurs, a description of the error is returned.
+         *     Otherwise, an empty string is returned.
+         */
+        std::string Open(
+            const std::string& basePath,
+            size_t segmentSize = DEFAULT_LOG_SEGMENT_SIZE
+        );
+
+        /**
+         * This closes the log, if it's open.  Entries appended since
+         * Sync was last called are written to the files, but not
+         * necessarily flushed to disk.
+         */
+        void Close();
+
+        /**
+         * This returns the number of segments in which the log is kept.
+         *
+         * @return
+         *     The number of segments in which the log is kept is returned.
+         */
+        size_t GetSegmentCount() const;
+
+        // LogStore
+    public:
+        virtual uint64_t GetFirstIndex() override;
+        virtual uint64_t GetLastIndex() override;
+        virtual uint64_t GetTerm(uint64_t index) override;
+        virtual std::string Append(
+            uint64_t term,
+            BlobView data
+        ) override;
+        virtual std::string Sync() override;
+        virtual std::string Read(
+            uint64_t first,
+            uint64_t last,
+            std::vector< LogEntryView >& entries
+        ) override;
+        virtual std::string TruncateSuffix(uint64_t last) override;
+        virtual std::string CompactPrefix(uint64_t last) override;
+
+        // Private Properties
+    private:
+        /**
+         * This is the type of structure that contains the private
+         * properties of the instance.  It is defined in the implementation
+         * and declared here to ensure that it is scoped inside the class.
+         */
+        struct Impl;
+
+        /**
+         * This contains the private properties of the instance.
+         */
+        std::unique_ptr< Impl > impl_;
+    };
+
+}
@@ -0,0 +1,176 @@
+#pragma once
+
+/**
+ * @file Snapshot.hpp
+ *
+ * This file specifies abstract interfaces for streaming database
+ * snapshots in chunks, so that neither the creation nor the installation
+ * of a snapshot requires the complete snapshot to be held in memory
+ * at once.
+ */
+
+#include "Value.hpp"
+
+#include <memory>
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+
+namespace DatabaseAbstractions {
+
+    /**
+     * This holds either the changes made to a database since some
+     * earlier state (a delta), or the complete state of the database
+     * (a full snapshot), along with identifiers of the states involved.
+     */
+    struct DeltaSnapshot {
+        /**
+         * This flag is set if the blob holds a complete snapshot,
+         * rather than the changes made since the base state.
+         */
+        bool full = true;
+
+        /**
+         * This identifies the state of the database on top of which
+         * the delta must be installed.  It isn't used for full snapshots.
+         */
+        uint64_t baseId = 0;
+
+        /**
+         * This identifies the state of the database captured by the
+         * snapshot, which is the state a database is left in after
+         * installing it.
+         */
+        uint64_t id = 0;
+
+        /**
+         * This holds the changes, or the complete snapshot, in a form
+         * only meaningful to the database implementation.
+         */
+        Blob blob;
+
+        /**
+         * This gets a value if creating the snapshot results in an error.
+         */
+        std::string error;
+    };
+
+    struct ReadSnapshotChunkResults {
+        /**
+         * This flag is set if there are no more chunks to read
+         * from the snapshot.
+         */
+        bool done = false;
+
+        /**
+         * This gets a value if reading the snapshot results in an error.
+         */
+        std::string error;
+    };
+
+    /**
+     * This is an abstract interface to an object which produces the
+     * snapshot of a database one chunk at a time.
+     */
+    class SnapshotReader {
+    public:
+        virtual ~SnapshotReader() = default;
+
+        /**
+         * This reads the next chunk of the snapshot.
+         *
+         * @param[out] chunk
+         *     This is where to store the next chunk of the snapshot.
+         *     It's left empty once there are no more chunks to read.
+         *     Its existing capacity is reused where possible.
+         *
+         * @return
+         *     The results of reading the chunk are returned.
+         */
+        virtual ReadSnapshotChunkResults ReadChunk(Blob& chunk) = 0;
+    };
+
+    /**
+     * This is an abstract interface to an object which accepts the
+     * snapshot of a database one chunk at a time and installs it
+     * once the last chunk has been written.
+     */
+    class SnapshotWriter {
+    public:
+        virtual ~SnapshotWriter() = default;
+
+        /**
+         * This adds the next chunk of the snapshot.
+         *
+         * @param[in] chunk
+         *     This is the next chunk of the snapshot.  It's only used
+         *     during the call, and may be discarded afterwards.
+         *
+         * @return
+         *     If an error occurs, a description of the error is returned.
+         *     Otherwise, an empty string is returned.
+         */
+        virtual std::string WriteChunk(BlobView chunk) = 0;
+
+        /**
+         * This installs the snapshot formed by the chunks written so far,
+         * replacing the database.
+         *
+         * @return
+         *     If an error occurs, a description of the error is returned.
+         *     Otherwise, an empty string is returned.
+         */
+        virtual std::string Finish() = 0;
+    };
+
+    /**
+     * This is a snapshot reader which produces chunks from a snapshot
+     * that is already complete and held in memory.
+     */
+    class BlobSnapshotReader
+        : public SnapshotReader
+    {
+        // Lifecycle
+    public:
+        ~BlobSnapshotReader() noexcept;
+        BlobSnapshotReader(const BlobSnapshotReader&) = delete;
+        BlobSnapshotReader(BlobSnapshotReader&&) noexcept;
+        BlobSnapshotReader& operator=(const BlobSnapshotReader&) = delete;
+        BlobSnapshotReader& operator=(BlobSnapshotReader&&) noexcept;
+
+        // Construction
+    public:
+        /**
+         * This constructs a reader for the given snapshot.
+         *
+         * @param[in] snapshot
+         *     This is the complete snapshot to read.
+         *
+         * @param[in] chunkSize
+         *     This is the maximum number of bytes in each chunk.
+         */
+        BlobSnapshotReader(
+            Blob&& snapshot,
+            size_t chunkSize
+        );
+
+        // SnapshotReader
+    public:
+        virtual ReadSnapshotChunkResults ReadChunk(Blob& chunk) override;
+
+        // Private Properties
+    private:
+        /**
+         * This is the type of structure that contains the private
+         * properties of the instance.  It is defined in the implementation
+         * and declared here to ensure that it is scoped inside the class.
+         */
+        struct Impl;
+
+        /**
+         * This contains the private properties of the instance.
+         */
+        std::unique_ptr< Impl > impl_;
+    };
+
+}
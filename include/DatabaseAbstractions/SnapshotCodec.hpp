@@ -0,0 +1,403 @@
+#pragma once
+
+/**
+ * @file SnapshotCodec.hpp
+ *
+ * This file declares the DatabaseAbstractions::SnapshotCodec interface,
+ * along with the functions and classes which use codecs to compress
+ * database snapshots into self-describing frames and decompress them
+ * again.
+ *
+ * A frame starts with a header identifying it as a frame, the codec used,
+ * and the block size.  The snapshot is split into blocks of that size,
+ * each compressed separately, so that blocks can be compressed and
+ * decompressed in parallel, and a frame can be produced and consumed
+ * one chunk at a time.  Each block is preceded by its sizes and a
+ * CRC-32C checksum of its sizes and data, and the last block is followed
+ * by a block with no data.  A block which the codec can't make smaller is
+ * stored as is.
+ *
+ * The checksums let a frame be verified, in parallel, before any of it
+ * is decompressed or installed, and identify the first corrupt block,
+ * so that a transfer can be resumed from there rather than started over.
+ */
+
+#include "Snapshot.hpp"
+#include "Value.hpp"
+#include "WorkerPool.hpp"
+
+#include <memory>
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+
+namespace DatabaseAbstractions {
+
+    /**
+     * This is the codec identifier for blocks which are stored as is.
+     */
+    constexpr uint8_t SNAPSHOT_CODEC_NONE = 0;
+
+    /**
+     * This is the codec identifier for the built-in LZ codec, which
+     * trades some compression ratio for speed.
+     */
+    constexpr uint8_t SNAPSHOT_CODEC_LZ = 1;
+
+    /**
+     * This is the version of the frame format written by this module.
+     */
+    constexpr uint8_t SNAPSHOT_FRAME_VERSION = 1;
+
+    /**
+     * This is the number of bytes in the header of a frame.
+     */
+    constexpr size_t SNAPSHOT_FRAME_HEADER_SIZE = 12;
+
+    /**
+     * This is the number of bytes in the header of each block in a frame,
+     * including its checksum.
+     */
+    constexpr size_t SNAPSHOT_FRAME_BLOCK_HEADER_SIZE = 12;
+
+    /**
+     * This is the block size used unless another is given.
+     */
+    constexpr size_t DEFAULT_SNAPSHOT_BLOCK_SIZE = 256 * 1024;
+
+    /**
+     * This holds the results of verifying a frame.
+     */
+    struct SnapshotFrameVerification {
+        /**
+         * This gets a value if the frame isn't complete and intact.
+         */
+        std::string error;
+
+        /**
+         * This is the number of blocks, starting from the first, which
+         * are complete and intact.
+         */
+        size_t intactBlocks = 0;
+
+        /**
+         * This is the number of bytes, starting from the beginning of
+         * the frame, which are complete and intact.  A transfer of the
+         * frame which was cut short or corrupted may be resumed from here.
+         */
+        size_t intactBytes = 0;
+    };
+
+    /**
+     * This is an abstract interface to an algorithm which compresses
+     * and decompresses blocks of snapshot data.  Codecs must be safe
+     * to use from several threads at once.
+     */
+    class SnapshotCodec {
+    public:
+        virtual ~SnapshotCodec() = default;
+
+        /**
+         * This returns the identifier stored in frames compressed by
+         * the codec, which is used to find the codec again when the
+         * frames are decompressed.
+         *
+         * @return
+         *     The identifier of the codec is returned.
+         */
+        virtual uint8_t GetId() const = 0;
+
+        /**
+         * This returns the most bytes that one byte of data compressed
+         * by the codec may decompress to.  Blocks claiming to decompress
+         * to more than this allows are rejected as corrupt, before any
+         * room is made for them.
+         *
+         * @return
+         *     The largest ratio of decompressed size to compressed size
+         *     is returned.
+         */
+        virtual size_t GetMaxExpansion() const = 0;
+
+        /**
+         * This compresses a block of data.
+         *
+         * @param[in] input
+         *     This is the data to compress.
+         *
+         * @param[out] output
+         *     This is where to store the compressed data.  Its existing
+         *     contents are replaced.
+         */
+        virtual void Compress(
+            BlobView input,
+            Blob& output
+        ) const = 0;
+
+        /**
+         * This decompresses a block of data.
+         *
+         * @param[in] input
+         *     This is the compressed data.
+         *
+         * @param[out] output
+         *     This is where to store the decompressed data.
+         *
+         * @param[in] size
+         *     This is the exact number of bytes the data decompresses to.
+         *
+         * @return
+         *     An indication of whether or not the data was decompressed
+         *     successfully is returned.  This is false if the compressed
+         *     data is corrupt.
+         */
+        virtual bool Decompress(
+            BlobView input,
+            uint8_t* output,
+            size_t size
+        ) const = 0;
+    };
+
+    /**
+     * This makes a codec available to decompress frames which name it,
+     * replacing any codec previously registered with the same identifier.
+     * The built-in codecs are always registered.
+     *
+     * @param[in] codec
+     *     This is the codec to register.
+     */
+    void RegisterSnapshotCodec(std::shared_ptr< const SnapshotCodec > codec);
+
+    /**
+     * This finds the codec registered with the given identifier.
+     *
+     * @param[in] id
+     *     This is the identifier of the codec to find.
+     *
+     * @return
+     *     The codec is returned, or null if no codec is registered
+     *     with the given identifier.
+     */
+    std::shared_ptr< const SnapshotCodec > GetSnapshotCodec(uint8_t id);
+
+    /**
+     * This determines whether or not the given data starts with
+     * the header of a frame.  Snapshots made by the databases in
+     * this library never do.
+     *
+     * @param[in] data
+     *     This is the data to check.
+     *
+     * @return
+     *     An indication of whether or not the data starts with
+     *     the header of a frame is returned.
+     */
+    bool IsSnapshotFrame(BlobView data);
+
+    /**
+     * This compresses a complete snapshot into a frame.
+     *
+     * @param[in] snapshot
+     *     This is the snapshot to compress.
+     *
+     * @param[in] codec
+     *     This is the codec to use.
+     *
+     * @param[in] blockSize
+     *     This is the number of bytes of the snapshot to compress
+     *     in each block.
+     *
+     * @param[in] pool
+     *     If not null, this is used to compress blocks in parallel.
+     *
+     * @return
+     *     The frame is returned.
+     */
+    Blob CompressSnapshot(
+        BlobView snapshot,
+        const SnapshotCodec& codec,
+        size_t blockSize = DEFAULT_SNAPSHOT_BLOCK_SIZE,
+        WorkerPool* pool = nullptr
+    );
+
+    /**
+     * This checks the layout of a frame and the checksums of all its
+     * blocks, without decompressing them.
+     *
+     * @param[in] frame
+     *     This is the frame to verify.
+     *
+     * @param[in] pool
+     *     If not null, this is used to check blocks in parallel.
+     *
+     * @return
+     *     The results of verifying the frame are returned.
+     */
+    SnapshotFrameVerification VerifySnapshotFrame(
+        BlobView frame,
+        WorkerPool* pool = nullptr
+    );
+
+    /**
+     * This decompresses a complete frame back into a snapshot, using
+     * whichever registered codec the frame names.  Each block's
+     * checksum is verified before the block is decompressed.
+     *
+     * @param[in] frame
+     *     This is the frame to decompress.
+     *
+     * @param[out] snapshot
+     *     This is where to store the snapshot.
+     *
+     * @param[in] pool
+     *     If not null, this is used to decompress blocks in parallel.
+     *
+     * @return
+     *     If an error occurs, a description of the error is returned.
+     *     Otherwise, an empty string is returned.
+     */
+    std::string DecompressSnapshot(
+        BlobView frame,
+        Blob& snapshot,
+        WorkerPool* pool = nullptr
+    );
+
+    /**
+     * This is a snapshot reader which compresses the chunks produced by
+     * another snapshot reader into a frame, and produces the frame in
+     * chunks.  When given a worker pool, it compresses as many blocks
+     * at a time as the pool has threads.
+     */
+    class CompressingSnapshotReader
+        : public SnapshotReader
+    {
+        // Lifecycle
+    public:
+        ~CompressingSnapshotReader() noexcept;
+        CompressingSnapshotReader(const CompressingSnapshotReader&) = delete;
+        CompressingSnapshotReader(CompressingSnapshotReader&&) noexcept;
+        CompressingSnapshotReader& operator=(const CompressingSnapshotReader&) = delete;
+        CompressingSnapshotReader& operator=(CompressingSnapshotReader&&) noexcept;
+
+        // Construction
+    public:
+        /**
+         * This constructs the reader.
+         *
+         * @param[in] reader
+         *     This is the reader of the snapshot to compress.
+         *
+         * @param[in] chunkSize
+         *     This is the maximum number of bytes in each chunk.
+         *
+         * @param[in] codec
+         *     This is the codec to use.
+         *
+         * @param[in] blockSize
+         *     This is the number of bytes of the snapshot to compress
+         *     in each block.
+         *
+         * @param[in] pool
+         *     If not null, this is used to compress blocks in parallel.
+         */
+        CompressingSnapshotReader(
+            std::shared_ptr< SnapshotReader > reader,
+            size_t chunkSize,
+            std::shared_ptr< const SnapshotCodec > codec,
+            size_t blockSize = DEFAULT_SNAPSHOT_BLOCK_SIZE,
+            std::shared_ptr< WorkerPool > pool = nullptr
+        );
+
+        // SnapshotReader
+    public:
+        virtual ReadSnapshotChunkResults ReadChunk(Blob& chunk) override;
+
+        // Private Properties
+    private:
+        /**
+         * This is the type of structure that contains the private
+         * properties of the instance.  It is defined in the implementation
+         * and declared here to ensure that it is scoped inside the class.
+         */
+        struct Impl;
+
+        /**
+         * This contains the private properties of the instance.
+         */
+        std::unique_ptr< Impl > impl_;
+    };
+
+    /**
+     * This is a snapshot writer which decompresses a frame written to it
+     * in chunks, and passes the decompressed snapshot on to another
+     * snapshot writer, one block at a time.  If what's written isn't
+     * a frame, it's passed on as is.  When given a worker pool, it
+     * decompresses as many blocks at a time as the pool has threads.
+     *
+     * Each block's checksum is verified before the block is passed on.
+     * If a block is corrupt, WriteChunk returns an error, and discards
+     * that block along with anything written after it.  Writing may then
+     * carry on with the frame from the offset returned by GetResumeOffset.
+     */
+    class DecompressingSnapshotWriter
+        : public SnapshotWriter
+    {
+        // Lifecycle
+    public:
+        ~DecompressingSnapshotWriter() noexcept;
+        DecompressingSnapshotWriter(const DecompressingSnapshotWriter&) = delete;
+        DecompressingSnapshotWriter(DecompressingSnapshotWriter&&) noexcept;
+        DecompressingSnapshotWriter& operator=(const DecompressingSnapshotWriter&) = delete;
+        DecompressingSnapshotWriter& operator=(DecompressingSnapshotWriter&&) noexcept;
+
+        // Construction
+    public:
+        /**
+         * This constructs the writer.
+         *
+         * @param[in] writer
+         *     This is the writer to which to pass the decompressed
+         *     snapshot.
+         *
+         * @param[in] pool
+         *     If not null, this is used to decompress blocks in parallel.
+         */
+        explicit DecompressingSnapshotWriter(
+            std::shared_ptr< SnapshotWriter > writer,
+            std::shared_ptr< WorkerPool > pool = nullptr
+        );
+
+        // Methods
+    public:
+        /**
+         * This returns the number of bytes of the frame accepted so far,
+         * which is where writing should resume after WriteChunk reports
+         * a corrupt block.
+         *
+         * @return
+         *     The number of bytes of the frame accepted so far
+         *     is returned.
+         */
+        uint64_t GetResumeOffset() const;
+
+        // SnapshotWriter
+    public:
+        virtual std::string WriteChunk(BlobView chunk) override;
+        virtual std::string Finish() override;
+
+        // Private Properties
+    private:
+        /**
+         * This is the type of structure that contains the private
+         * properties of the instance.  It is defined in the implementation
+         * and declared here to ensure that it is scoped inside the class.
+         */
+        struct Impl;
+
+        /**
+         * This contains the private properties of the instance.
+         */
+        std::unique_ptr< Impl > impl_;
+    };
+
+}
@@ -0,0 +1,139 @@
+#pragma once
+
+/**
+ * @file SnapshotFile.hpp
+ *
+ * This file declares functions which store database snapshots in files
+ * and install them from files mapped into memory, so that neither
+ * operation requires the complete snapshot to be held in a buffer.
+ *
+ * A snapshot file begins with a small header identifying the format,
+ * the schema of the database, and the length and checksum of the
+ * snapshot which follows it.
+ */
+
+#include "Database.hpp"
+
+#include <stdint.h>
+#include <string>
+
+namespace DatabaseAbstractions {
+
+    /**
+     * This is the version of the snapshot file format written by
+     * CreateSnapshotFile.
+     */
+    constexpr uint32_t SNAPSHOT_FILE_VERSION = 1;
+
+    /**
+     * This is the number of bytes in the header of a snapshot file.
+     */
+    constexpr size_t SNAPSHOT_FILE_HEADER_SIZE = 40;
+
+    /**
+     * This holds the information stored in the header of
+     * a snapshot file.
+     */
+    struct SnapshotFileHeader {
+        /**
+         * This is the version of the snapshot file format.
+         */
+        uint32_t version = 0;
+
+        /**
+         * This is a value chosen by the application to identify the
+         * schema of the database, so that a snapshot isn't installed
+         * into a database expecting a different schema.
+         */
+        uint64_t schemaHash = 0;
+
+        /**
+         * This is the number of bytes in the snapshot.
+         */
+        uint64_t length = 0;
+
+        /**
+         * This is the CRC-32C checksum of the snapshot.
+         */
+        uint32_t checksum = 0;
+    };
+
+    /**
+     * This streams a snapshot of the given database into a file.
+     * The file is written under a unique temporary name in the same
+     * directory and renamed into place once it's complete and flushed
+     * to disk, so the file at the given path is never left incomplete,
+     * even if more than one snapshot of it is being written at once.
+     * The directory is flushed after the rename, so the new file is in
+     * place before success is reported.
+     *
+     * @param[in] database
+     *     This is the database to snapshot.
+     *
+     * @param[in] path
+     *     This is the path of the file to create.
+     *
+     * @param[in] schemaHash
+     *     This is a value chosen by the application to identify
+     *     the schema of the database.
+     *
+     * @return
+     *     If an error occurs, a description of the error is returned.
+     *     Otherwise, an empty string is returned.
+     */
+    std::string CreateSnapshotFile(
+        Database& database,
+        const std::string& path,
+        uint64_t schemaHash
+    );
+
+    /**
+     * This reads the header of the given snapshot file and checks that
+     * it's valid, without reading the snapshot itself.
+     *
+     * @param[in] path
+     *     This is the path of the snapshot file.
+     *
+     * @param[out] header
+     *     This is where to store the information from the header.
+     *
+     * @return
+     *     If an error occurs, a description of the error is returned.
+     *     Otherwise, an empty string is returned.
+     */
+    std::string ReadSnapshotFileHeader(
+        const std::string& path,
+        SnapshotFileHeader& header
+    );
+
+    /**
+     * This maps the given snapshot file into memory, verifies it, and
+     * installs the snapshot into the given database by passing it to the
+     * database's snapshot writer in chunks taken directly from the
+     * mapping.  Databases whose writers decode chunks as they arrive,
+     * such as InMemoryDatabase, never hold a copy of the whole encoded
+     * snapshot.  The database is left untouched if the file is invalid,
+     * was made for a different schema, or fails its checksum.
+     *
+     * @param[in] database
+     *     This is the database in which to install the snapshot.
+     *
+     * @param[in] path
+     *     This is the path of the snapshot file.
+     *
+     * @param[in] schemaHash
+     *     This is a value chosen by the application to identify the
+     *     schema of the database.  It must match the value given when
+     *     the snapshot file was created.
+     *
+     * @return
+     *     If an error occurs, a description of the error is returned.
+     *     Otherwise, an empty string is returned.
+     */
+    std::string InstallSnapshotFile(
+        Database& database,
+        const std::string& path,
+        uint64_t schemaHash
+    );
+
+}
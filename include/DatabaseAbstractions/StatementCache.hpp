@@ -0,0 +1,150 @@
+#pragma once
+
+/**
+ * @file StatementCache.hpp
+ *
+ * This file defines the DatabaseAbstractions::StatementCache class, which
+ * wraps a database in order to reuse prepared statements built for the
+ * same SQL text.
+ */
+
+#include "Database.hpp"
+
+#include <memory>
+#include <stddef.h>
+#include <string>
+
+namespace DatabaseAbstractions {
+
+    /**
+     * This holds counters describing how well a statement cache
+     * is working.
+     */
+    struct StatementCacheStatistics {
+        /**
+         * This is the number of statements handed out from the cache.
+         */
+        size_t hits = 0;
+
+        /**
+         * This is the number of statements which had to be built
+         * because none were available in the cache.
+         */
+        size_t misses = 0;
+
+        /**
+         * This is the number of statements dropped from the cache
+         * to make room for others.
+         */
+        size_t evictions = 0;
+
+        /**
+         * This is the number of statements currently in the cache.
+         */
+        size_t size = 0;
+    };
+
+    /**
+     * This is a database which passes everything through to another
+     * database, except that it keeps the statements it builds, and
+     * hands them out again (after resetting them) when asked to build
+     * a statement from the same SQL text.  The least recently used
+     * statements are dropped when the cache is full.
+     *
+     * A cached statement is only handed out when nothing else holds it,
+     * so a statement is never shared by two users at once.  Resetting a
+     * statement doesn't necessarily clear its parameter bindings, so
+     * users should bind every parameter each time they use one.
+     *
+     * The cache is emptied whenever a snapshot is installed, since the
+     * cached statements may no longer match the schema of the database.
+     */
+    class StatementCache
+        : public Database
+    {
+        // Lifecycle
+    public:
+        ~StatementCache() noexcept;
+        StatementCache(const StatementCache&) = delete;
+        StatementCache(StatementCache&&) noexcept;
+        StatementCache& operator=(const StatementCache&) = delete;
+        StatementCache& operator=(StatementCache&&) noexcept;
+
+        // Construction
+    public:
+        /**
+         * This constructs a cache for statements built by the given
+         * database.
+         *
+         * @param[in] database
+         *     This is the database to wrap.
+         *
+         * @param[in] capacity
+         *     This is the maximum number of statements to keep.
+         */
+        StatementCache(
+            std::shared_ptr< Database > database,
+            size_t capacity
+        );
+
+        // Methods
+    public:
+        /**
+         * This returns counters describing how well the cache is working.
+         *
+         * @return
+         *     Counters describing how well the cache is working
+         *     are returned.
+         */
+        StatementCacheStatistics GetStatistics() const;
+
+        /**
+         * This drops all statements from the cache.  It should be called
+         * after changing the schema of the database, if the database
+         * doesn't automatically update statements prepared beforehand.
+         */
+        void Clear();
+
+        // Database
+    public:
+        virtual BuildStatementResults BuildStatement(
+            const std::string& statement
+        ) override;
+        virtual std::string ExecuteStatement(const std::string& statement) override;
+        virtual std::string BeginTransaction() override;
+        virtual std::string CommitTransaction() override;
+        virtual std::string RollbackTransaction() override;
+        virtual std::string ApplyWriteBatch(const WriteBatch& batch) override;
+        virtual void ExecuteAsync(
+            const std::string& statement,
+            CompletionCallback callback
+        ) override;
+        virtual void ApplyWriteBatchAsync(
+            WriteBatch&& batch,
+            CompletionCallback callback
+        ) override;
+        virtual Blob CreateSnapshot() override;
+        virtual std::string InstallSnapshot(const Blob& blob) override;
+        virtual std::shared_ptr< SnapshotReader > CreateSnapshotReader(size_t chunkSize) override;
+        virtual std::shared_ptr< SnapshotReader > CaptureSnapshot(size_t chunkSize) override;
+        virtual std::shared_ptr< SnapshotWriter > CreateSnapshotWriter() override;
+        virtual uint64_t GetSnapshotId() override;
+        virtual DeltaSnapshot CreateDeltaSnapshot(uint64_t baseId) override;
+        virtual std::string InstallDeltaSnapshot(const DeltaSnapshot& snapshot) override;
+
+        // Private Properties
+    private:
+        /**
+         * This is the type of structure that contains the private
+         * properties of the instance.  It is defined in the implementation
+         * and declared here to ensure that it is scoped inside the class.
+         */
+        struct Impl;
+
+        /**
+         * This contains the private properties of the instance.
+         */
+        std::unique_ptr< Impl > impl_;
+    };
+
+}
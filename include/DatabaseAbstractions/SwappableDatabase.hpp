@@ -0,0 +1,172 @@
+#pragma once
+
+/**
+ * @file SwappableDatabase.hpp
+ *
+ * This file defines the DatabaseAbstractions::SwappableDatabase class,
+ * which installs snapshots into a separate database and then swaps it in,
+ * so that reads aren't held up while a snapshot is installed.
+ */
+
+#include "Database.hpp"
+
+#include <functional>
+#include <memory>
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+
+namespace DatabaseAbstractions {
+
+    /**
+     * This is a database which passes everything through to another
+     * database, the current one, except for installing full snapshots.
+     * A full snapshot is installed into a new database, the shadow, made
+     * by a factory function, and once it's installed, the shadow replaces
+     * the current database in one step.  Until then, statements keep
+     * being built on the current database, so reads go on at full speed
+     * while a follower catches up.
+     *
+     * Statements hold on to the database on which they were built, so
+     * statements built before a swap finish against the old state, and
+     * only statements built afterwards see the new state.  The old
+     * database is released once nothing holds it any more.
+     *
+     * Snapshots may also be installed on a background thread of the
+     * swappable database's own, using InstallSnapshotAsync, so that even
+     * the caller isn't held up.  Changes made to the current database
+     * while a snapshot is being installed are lost when the shadow is
+     * swapped in, just as if they'd been made before the install.  The
+     * shadow isn't swapped in while a transaction is open on the current
+     * database, whether it was begun with BeginTransaction or by a BEGIN
+     * statement; the install fails instead.  Delta snapshots are
+     * installed directly into the current database, since they only
+     * make a few changes.
+     *
+     * The current database is used exactly as it would be without the
+     * swappable database, so it needs to be safe to use from several
+     * threads only if the swappable database is.
+     */
+    class SwappableDatabase
+        : public Database
+    {
+        // Types
+    public:
+        /**
+         * This is the type of function used to make the databases
+         * into which snapshots are installed.
+         */
+        using DatabaseFactory = std::function< std::shared_ptr< Database >() >;
+
+        // Lifecycle
+    public:
+        /**
+         * This waits for any snapshots being installed in the background
+         * to be installed.
+         */
+        ~SwappableDatabase() noexcept;
+        SwappableDatabase(const SwappableDatabase&) = delete;
+        SwappableDatabase(SwappableDatabase&&) noexcept;
+        SwappableDatabase& operator=(const SwappableDatabase&) = delete;
+        SwappableDatabase& operator=(SwappableDatabase&&) noexcept;
+
+        // Construction
+    public:
+        /**
+         * This constructs the database, making the first current
+         * database using the given function.
+         *
+         * @param[in] makeDatabase
+         *     This is the function to call to make the first current
+         *     database, and each shadow into which a snapshot
+         *     is installed.
+         */
+        explicit SwappableDatabase(DatabaseFactory makeDatabase);
+
+        // Methods
+    public:
+        /**
+         * This returns the current database, on which statements
+         * are built.
+         *
+         * @return
+         *     The current database is returned.
+         */
+        std::shared_ptr< Database > GetCurrent() const;
+
+        /**
+         * This returns the number of times a shadow has been swapped in
+         * to replace the current database.
+         *
+         * @return
+         *     The number of times a shadow has been swapped in
+         *     is returned.
+         */
+        size_t GetSwapCount() const;
+
+        /**
+         * This installs the given full snapshot into a shadow on a
+         * background thread, and swaps the shadow in once it's installed.
+         * Snapshots given to this method are installed one at a time,
+         * in the order given.
+         *
+         * @param[in] blob
+         *     This is the snapshot to install.  It's given up by the
+         *     caller, so that it can be kept until it's installed.
+         *
+         * @param[in] callback
+         *     This is the function to call, on the background thread,
+         *     with the results of installing the snapshot.
+         */
+        void InstallSnapshotAsync(
+            Blob&& blob,
+            CompletionCallback callback
+        );
+
+        // Database
+    public:
+        virtual BuildStatementResults BuildStatement(
+            const std::string& statement
+        ) override;
+        virtual std::string ExecuteStatement(const std::string& statement) override;
+        virtual std::string BeginTransaction() override;
+        virtual std::string CommitTransaction() override;
+        virtual std::string RollbackTransaction() override;
+        virtual std::string ApplyWriteBatch(const WriteBatch& batch) override;
+        virtual void BuildStatementAsync(
+            const std::string& statement,
+            BuildStatementCallback callback
+        ) override;
+        virtual void ExecuteAsync(
+            const std::string& statement,
+            CompletionCallback callback
+        ) override;
+        virtual void ApplyWriteBatchAsync(
+            WriteBatch&& batch,
+            CompletionCallback callback
+        ) override;
+        virtual Blob CreateSnapshot() override;
+        virtual std::string InstallSnapshot(const Blob& blob) override;
+        virtual std::shared_ptr< SnapshotReader > CreateSnapshotReader(size_t chunkSize) override;
+        virtual std::shared_ptr< SnapshotReader > CaptureSnapshot(size_t chunkSize) override;
+        virtual std::shared_ptr< SnapshotWriter > CreateSnapshotWriter() override;
+        virtual uint64_t GetSnapshotId() override;
+        virtual DeltaSnapshot CreateDeltaSnapshot(uint64_t baseId) override;
+        virtual std::string InstallDeltaSnapshot(const DeltaSnapshot& snapshot) override;
+
+        // Private Properties
+    private:
+        /**
+         * This is the type of structure that contains the private
+         * properties of the instance.  It is defined in the implementation
+         * and declared here to ensure that it is scoped inside the class.
+         */
+        struct Impl;
+
+        /**
+         * This contains the private properties of the instance.
+         */
+        std::unique_ptr< Impl > impl_;
+    };
+
+}
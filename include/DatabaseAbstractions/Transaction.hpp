@@ -0,0 +1,106 @@
+#pragma once
+
+/**
+ * @file Transaction.hpp
+ *
+ * This file defines the DatabaseAbstractions::Transaction class, which
+ * keeps a database transaction open for as long as it exists.
+ */
+
+#include "Database.hpp"
+
+#include <memory>
+#include <string>
+
+namespace DatabaseAbstractions {
+
+    /**
+     * This opens a transaction on a database when constructed, and rolls
+     * it back when destroyed unless it was committed first.  This ensures
+     * a transaction is never left open when the code using it returns
+     * early or throws.
+     *
+     * The database must outlive the transaction.
+     */
+    class Transaction {
+        // Lifecycle
+    public:
+        /**
+         * This rolls back the transaction if it's still open.
+         */
+        ~Transaction() noexcept;
+        Transaction(const Transaction&) = delete;
+        Transaction(Transaction&&) noexcept;
+        Transaction& operator=(const Transaction&) = delete;
+        Transaction& operator=(Transaction&&) noexcept;
+
+        // Construction
+    public:
+        /**
+         * This opens a transaction on the given database.
+         *
+         * @param[in] database
+         *     This is the database on which to open the transaction.
+         */
+        explicit Transaction(Database& database);
+
+        // Methods
+    public:
+        /**
+         * This returns the error reported when the transaction
+         * was opened, if any.
+         *
+         * @return
+         *     If the transaction couldn't be opened, a description of
+         *     the problem is returned.  Otherwise, an empty string
+         *     is returned.
+         */
+        const std::string& GetError() const;
+
+        /**
+         * This determines whether or not the transaction is open,
+         * meaning it was opened successfully and hasn't yet been
+         * committed or rolled back.
+         *
+         * @return
+         *     An indication of whether or not the transaction is open
+         *     is returned.
+         */
+        bool IsOpen() const;
+
+        /**
+         * This makes the changes made during the transaction permanent.
+         * If this fails, the transaction is left open, and is rolled back
+         * when the guard is destroyed.
+         *
+         * @return
+         *     If an error occurs, a description of the error is returned.
+         *     Otherwise, an empty string is returned.
+         */
+        std::string Commit();
+
+        /**
+         * This undoes the changes made during the transaction.
+         *
+         * @return
+         *     If an error occurs, a description of the error is returned.
+         *     Otherwise, an empty string is returned.
+         */
+        std::string Rollback();
+
+        // Private Properties
+    private:
+        /**
+         * This is the type of structure that contains the private
+         * properties of the instance.  It is defined in the implementation
+         * and declared here to ensure that it is scoped inside the class.
+         */
+        struct Impl;
+
+        /**
+         * This contains the private properties of the instance.
+         */
+        std::unique_ptr< Impl > impl_;
+    };
+
+}
@@ -0,0 +1,324 @@
+#pragma once
+
+/**
+ * @file TypedStatement.hpp
+ *
+ * This file defines the DatabaseAbstractions::TypedStatement class
+ * template, which wraps a prepared statement whose parameter and column
+ * types are known at compile time.
+ */
+
+#include "Database.hpp"
+
+#include <initializer_list>
+#include <memory>
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <tuple>
+#include <utility>
+
+namespace DatabaseAbstractions {
+
+    /**
+     * This is used to list the types of the parameters of a
+     * TypedStatement, in order.
+     */
+    template< typename... T > struct Params {};
+
+    /**
+     * This is used to list the types of the columns of a
+     * TypedStatement, in order.
+     */
+    template< typename... T > struct Columns {};
+
+    /**
+     * This is specialized for each C++ type which may be used as the type
+     * of a parameter or column of a TypedStatement.  Each specialization
+     * provides the type of value the database should produce for it, as
+     * well as functions to bind a parameter and fetch a column of that
+     * type.
+     */
+    template< typename T > struct ColumnTraits;
+
+    template<> struct ColumnTraits< int > {
+        static constexpr Value::Type type = Value::Type::Integer;
+
+        static void Bind(PreparedStatement& statement, int index, int value) {
+            statement.BindParameter(index, Value(value));
+        }
+
+        static int Fetch(PreparedStatement& statement, int index) {
+            return statement.FetchColumn(index, type);
+        }
+    };
+
+    template<> struct ColumnTraits< intmax_t > {
+        static constexpr Value::Type type = Value::Type::Integer;
+
+        static void Bind(PreparedStatement& statement, int index, intmax_t value) {
+            statement.BindParameter(index, Value(value));
+        }
+
+        static intmax_t Fetch(PreparedStatement& statement, int index) {
+            return statement.FetchColumn(index, type);
+        }
+    };
+
+    template<> struct ColumnTraits< size_t > {
+        static constexpr Value::Type type = Value::Type::Integer;
+
+        static void Bind(PreparedStatement& statement, int index, size_t value) {
+            statement.BindParameter(index, Value(value));
+        }
+
+        static size_t Fetch(PreparedStatement& statement, int index) {
+            return statement.FetchColumn(index, type);
+        }
+    };
+
+    template<> struct ColumnTraits< double > {
+        static constexpr Value::Type type = Value::Type::Real;
+
+        static void Bind(PreparedStatement& statement, int index, double value) {
+            statement.BindParameter(index, Value(value));
+        }
+
+        static double Fetch(PreparedStatement& statement, int index) {
+            return statement.FetchColumn(index, type);
+        }
+    };
+
+    template<> struct ColumnTraits< bool > {
+        static constexpr Value::Type type = Value::Type::Boolean;
+
+        static void Bind(PreparedStatement& statement, int index, bool value) {
+            statement.BindParameter(index, Value(value));
+        }
+
+        static bool Fetch(PreparedStatement& statement, int index) {
+            return statement.FetchColumn(index, type);
+        }
+    };
+
+    template<> struct ColumnTraits< std::string > {
+        static constexpr Value::Type type = Value::Type::Text;
+
+        static void Bind(PreparedStatement& statement, int index, const std::string& value) {
+            statement.BindParameter(index, Value(value));
+        }
+
+        static std::string Fetch(PreparedStatement& statement, int index) {
+            return (const std::string&)statement.FetchColumn(index, type);
+        }
+    };
+
+    /**
+     * Blob parameters are bound as borrowed blobs, so the data isn't
+     * copied, but must be kept valid and unchanged until the statement
+     * is next reset or destroyed (see PreparedStatement::BindParameter).
+     */
+    template<> struct ColumnTraits< Blob > {
+        static constexpr Value::Type type = Value::Type::Blob;
+
+        static void Bind(PreparedStatement& statement, int index, const Blob& value) {
+            statement.BindParameter(index, Value(BlobView(value)));
+        }
+
+        static Blob Fetch(PreparedStatement& statement, int index) {
+            const auto value = statement.FetchColumn(index, type);
+            const BlobView view(value);
+            return Blob(view.data, view.data + view.size);
+        }
+    };
+
+    /**
+     * These are used by TypedStatement to expand lists of parameters
+     * and columns into the indexes at which they're bound or fetched.
+     */
+    namespace TypedStatementInternal {
+
+        template< size_t... I > struct Indices {};
+
+        template< size_t N, size_t... I > struct MakeIndices
+            : MakeIndices< N - 1, N - 1, I... >
+        {
+        };
+
+        template< size_t... I > struct MakeIndices< 0, I... > {
+            using Type = Indices< I... >;
+        };
+
+        /**
+         * This is used to call a function once for each element of a
+         * parameter pack, in order, since C++11 has no fold expressions.
+         */
+        inline void Expand(std::initializer_list< int >) {}
+
+    }
+
+    template< typename P, typename C > class TypedStatement;
+
+    /**
+     * This wraps a prepared statement whose parameter and column types
+     * are given as template arguments, so that parameters are bound and
+     * columns fetched directly as C++ values, with the number and types
+     * checked at compile time.  For example:
+     *
+     * @code
+     * TypedStatement<
+     *     Params< intmax_t >,
+     *     Columns< std::string, Blob >
+     * > query(database.BuildStatement("SELECT name, photo FROM people WHERE id = ?").statement);
+     * query.Bind(42);
+     * while (query.Step().done == false) {
+     *     std::string name;
+     *     Blob photo;
+     *     query.Fetch(name, photo);
+     * }
+     * @endcode
+     *
+     * Each parameter and column type must have a ColumnTraits
+     * specialization.
+     */
+    template< typename... P, typename... C > class TypedStatement<
+        Params< P... >,
+        Columns< C... >
+    > {
+        // Types
+    public:
+        /**
+         * This is the type of tuple holding one row of results.
+         */
+        using Row = std::tuple< C... >;
+
+        // Construction
+    public:
+        /**
+         * This constructs the wrapper.
+         *
+         * @param[in] statement
+         *     This is the statement to wrap.
+         */
+        explicit TypedStatement(std::shared_ptr< PreparedStatement > statement)
+            : statement_(statement)
+        {
+        }
+
+        // Methods
+    public:
+        /**
+         * This returns the statement being wrapped.
+         *
+         * @return
+         *     The statement being wrapped is returned.
+         */
+        const std::shared_ptr< PreparedStatement >& GetStatement() const {
+            return statement_;
+        }
+
+        /**
+         * This binds values to all the parameters of the statement,
+         * in order.
+         *
+         * @param[in] params
+         *     These are the values to bind to the parameters.
+         */
+        void Bind(const P&... params) {
+            BindAt(
+                typename TypedStatementInternal::MakeIndices< sizeof...(P) >::Type(),
+                params...
+            );
+        }
+
+        /**
+         * This resets the statement so that it can be run again.
+         */
+        void Reset() {
+            statement_->Reset();
+        }
+
+        /**
+         * This steps the statement.
+         *
+         * @return
+         *     The results of stepping the statement are returned.
+         */
+        StepStatementResults Step() {
+            return statement_->Step();
+        }
+
+        /**
+         * This fetches all the columns of the current row into the
+         * given variables, in order.
+         *
+         * @param[out] columns
+         *     These are the variables into which to fetch the columns.
+         */
+        void Fetch(C&... columns) {
+            FetchAt(
+                typename TypedStatementInternal::MakeIndices< sizeof...(C) >::Type(),
+                columns...
+            );
+        }
+
+        /**
+         * This fetches all the columns of the current row as a tuple.
+         *
+         * @return
+         *     The columns of the current row are returned.
+         */
+        Row FetchRow() {
+            return FetchAs< Row >();
+        }
+
+        /**
+         * This fetches all the columns of the current row, and uses them,
+         * in order, to construct an object of the given type (which is
+         * typically a plain structure with one member per column).
+         *
+         * @return
+         *     The object constructed from the columns of the current row
+         *     is returned.
+         */
+        template< typename S > S FetchAs() {
+            return FetchAsAt< S >(
+                typename TypedStatementInternal::MakeIndices< sizeof...(C) >::Type()
+            );
+        }
+
+        // Private Methods
+    private:
+        template< size_t... I > void BindAt(
+            TypedStatementInternal::Indices< I... >,
+            const P&... params
+        ) {
+            TypedStatementInternal::Expand({
+                (ColumnTraits< P >::Bind(*statement_, (int)I + 1, params), 0)...
+            });
+        }
+
+        template< size_t... I > void FetchAt(
+            TypedStatementInternal::Indices< I... >,
+            C&... columns
+        ) {
+            TypedStatementInternal::Expand({
+                (columns = ColumnTraits< C >::Fetch(*statement_, (int)I), 0)...
+            });
+        }
+
+        template< typename S, size_t... I > S FetchAsAt(
+            TypedStatementInternal::Indices< I... >
+        ) {
+            return S{ColumnTraits< C >::Fetch(*statement_, (int)I)...};
+        }
+
+        // Private Properties
+    private:
+        /**
+         * This is the statement being wrapped.
+         */
+        std::shared_ptr< PreparedStatement > statement_;
+    };
+
+}
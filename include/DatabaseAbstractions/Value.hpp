@@ -7,18 +7,59 @@
  * an element of data either sent to or retrieved from a database.
  */
 
+#include <functional>
 #include <memory>
 #include <ostream>
 #include <stddef.h>
 #include <stdint.h>
 #include <string>
+#include <vector>
 
 namespace DatabaseAbstractions {
 
+    class Arena;
+
+    /**
+     * This is the type used to hold binary data.
+     */
+    using Blob = std::vector< uint8_t >;
+
+    /**
+     * This refers to binary data which is owned by something else, such
+     * as a caller's buffer or a database row buffer.  It's only valid
+     * for as long as the owner keeps the data alive and unchanged.
+     */
+    struct BlobView {
+        /**
+         * This points to the first byte of the data.
+         */
+        const uint8_t* data = nullptr;
+
+        /**
+         * This is the number of bytes of data.
+         */
+        size_t size = 0;
+
+        BlobView() = default;
+
+        BlobView(const uint8_t* data, size_t size)
+            : data(data)
+            , size(size)
+        {
+        }
+
+        BlobView(const Blob& blob)
+            : data(blob.data())
+            , size(blob.size())
+        {
+        }
+    };
+
     class Value {
         // Types
     public:
         enum class Type {
+            Blob,
             Boolean,
             Error,
             Integer,
@@ -42,12 +83,61 @@ namespace DatabaseAbstractions {
         Value(const char* text);
         Value(const std::string& text);
         Value(std::string&& text);
+
+        /**
+         * This constructs a text value from the given characters,
+         * which need not be followed by a null terminator, copying
+         * them straight into the value.
+         *
+         * @param[in] text
+         *     This points to the characters of the text.
+         *
+         * @param[in] size
+         *     This is the number of characters in the text.
+         */
+        Value(const char* text, size_t size);
+
         Value(double real);
         Value(int integer);
         Value(intmax_t integer);
         Value(size_t integer);
         Value(bool boolean);
         Value(nullptr_t null);
+        Value(const Blob& blob);
+        Value(Blob&& blob);
+
+        /**
+         * This constructs a blob value which refers to binary data
+         * owned by something else, rather than copying it.  The data
+         * must remain valid and unchanged for as long as the value
+         * (or any copy of it) is used, or until Own is called.
+         *
+         * @param[in] blob
+         *     This refers to the data the value should reference.
+         */
+        Value(BlobView blob);
+
+        /**
+         * These construct a text or blob value whose data is copied
+         * into the given arena rather than into memory of its own.
+         * See Assign for how such values behave.
+         *
+         * @param[in] text
+         *     This is the text to copy into the arena.
+         *
+         * @param[in] size
+         *     This is the number of bytes of text to copy, which
+         *     need not be followed by a null terminator.
+         *
+         * @param[in] blob
+         *     This is the binary data to copy into the arena.
+         *
+         * @param[in,out] arena
+         *     This is the arena into which to copy the data.
+         */
+        Value(const std::string& text, Arena& arena);
+        Value(const char* text, size_t size, Arena& arena);
+        Value(BlobView blob, Arena& arena);
 
         // Methods
     public:
@@ -58,9 +148,147 @@ namespace DatabaseAbstractions {
         operator intmax_t() const;
         operator size_t() const;
         operator bool() const;
+        operator BlobView() const;
         Type GetType() const;
+
+        /**
+         * This is used to determine whether or not the value is a blob
+         * which refers to data owned by something else.
+         *
+         * @return
+         *     An indication of whether or not the value is a borrowed
+         *     blob is returned.
+         */
+        bool IsBorrowed() const;
+
+        /**
+         * This is used to determine whether or not the value keeps its
+         * text or binary data in an arena (see Assign).
+         *
+         * @return
+         *     An indication of whether or not the value keeps its data
+         *     in an arena is returned.
+         */
+        bool IsInArena() const;
+
+        /**
+         * This is used to determine whether or not the value keeps its
+         * text or binary data in a shared buffer (see Share).
+         *
+         * @return
+         *     An indication of whether or not the value keeps its data
+         *     in a shared buffer is returned.
+         */
+        bool IsShared() const;
+
+        /**
+         * If the value is a blob referring to data owned by something
+         * else, or keeps its data in an arena, this copies the data into
+         * the value, so that it no longer depends on the original owner.
+         * Otherwise, this does nothing.
+         */
+        void Own();
+
+        /**
+         * If the value is text, an error, or a blob, this moves its data
+         * into a reference-counted buffer which can't be changed, so that
+         * copies of the value (and copies of those) share the buffer
+         * rather than copying the data.  Copying such a value only
+         * updates a reference count, which is safe to do from several
+         * threads at once.  The buffer is freed when the last value
+         * sharing it is destroyed or given something else to hold.
+         *
+         * Borrowed data, and data kept in an arena, is copied into the
+         * buffer, so the value no longer depends on its original owner.
+         * Changing the value never changes the buffer, so values sharing
+         * it aren't affected.  Values which aren't text, errors, or blobs,
+         * or which already share their data, are left as they are.
+         */
+        void Share();
+
+        /**
+         * These replace the value with a copy of the given text or binary
+         * data, reusing the memory already held by the value for text or
+         * binary data, if any, so that a value used over and over again
+         * only allocates memory when it needs more than it already has.
+         *
+         * @param[in] text
+         *     This points to the characters of the text, which need not
+         *     be followed by a null terminator.
+         *
+         * @param[in] data
+         *     This points to the binary data.
+         *
+         * @param[in] size
+         *     This is the number of characters or bytes to copy.
+         */
+        void SetText(const char* text, size_t size);
+        void SetBlob(const uint8_t* data, size_t size);
+
+        /**
+         * This makes the value a copy of the given value, except that
+         * any text or binary data is copied into the given arena, rather
+         * than into memory of the value's own.  The data remains valid
+         * until the arena is reset or destroyed, so the value must not be
+         * used after that, other than to be assigned or destroyed.
+         *
+         * Copies of the value own their data, so they don't depend on
+         * the arena, but moving the value leaves the new value using
+         * the arena.  Converting a text value kept in an arena to a
+         * std::string reference copies the text into the value, so
+         * use the const char* conversion instead to avoid the copy.
+         *
+         * @param[in] other
+         *     This is the value to copy.
+         *
+         * @param[in,out] arena
+         *     This is the arena into which to copy the data.
+         */
+        void Assign(const Value& other, Arena& arena);
+
+        /**
+         * This compares the value with another value, in the order used
+         * by SQL for sorting and comparing values.  Nulls come first,
+         * then numbers, then text, then blobs, and finally errors.
+         * Numbers are compared by numeric value, whether they're
+         * integers or reals (booleans count as 0 or 1), and NaN comes
+         * before all other numbers.  Text and blobs are compared byte
+         * by byte, and errors are compared by their text.
+         *
+         * The comparison is a total order, which the equality and
+         * relational operators also follow, so values may be used
+         * as keys in ordered containers.
+         *
+         * @param[in] other
+         *     This is the value with which to compare.
+         *
+         * @return
+         *     -1, 0, or 1 is returned, according to whether the value
+         *     comes before, is equivalent to, or comes after the
+         *     other value.
+         */
+        int Compare(const Value& other) const;
+
+        /**
+         * This computes a hash of the value, which is the same for
+         * all values that are equivalent according to Compare (so, for
+         * example, an integer and a real number with the same numeric
+         * value hash the same).  All bits of the hash are well mixed,
+         * so it's suitable for hash tables which use its low bits
+         * directly, such as open-addressing tables.  The hash may
+         * differ between platforms, so it mustn't be stored.
+         *
+         * @return
+         *     The hash of the value is returned.
+         */
+        size_t Hash() const;
+
         bool operator==(const Value& other) const;
         bool operator!=(const Value& other) const;
+        bool operator<(const Value& other) const;
+        bool operator<=(const Value& other) const;
+        bool operator>(const Value& other) const;
+        bool operator>=(const Value& other) const;
         Value& operator=(const char* text);
         Value& operator=(const std::string& text);
         Value& operator=(std::string&& text);
@@ -70,21 +298,165 @@ namespace DatabaseAbstractions {
         Value& operator=(size_t integer);
         Value& operator=(bool boolean);
         Value& operator=(nullptr_t null);
+        Value& operator=(const Blob& blob);
+        Value& operator=(Blob&& blob);
+        Value& operator=(BlobView blob);
         static Value Error(const std::string& error);
 
+        // Friends
+    private:
+        /**
+         * This is allowed to read the text of values kept in an arena
+         * without copying it into the value first.
+         */
+        friend void EncodeValue(const Value& value, Blob& buffer);
+
         // Private Properties
     private:
         /**
-         * This is the type of structure that contains the private
-         * properties of the instance.  It is defined in the implementation
-         * and declared here to ensure that it is scoped inside the class.
+         * This is the storage for the data held by the value.  It's kept
+         * inline in the value itself, so that values never need to
+         * allocate memory for scalar data.  Text and errors are held in
+         * a std::string, whose small-string optimization keeps short
+         * strings inline as well.  Blobs are either held in an owned
+         * vector or referenced through a view of someone else's data.
+         * Text and blobs kept in an arena are referenced through views.
+         * Shared text, errors, and blobs are held through reference-counted
+         * pointers to buffers which never change.
+         */
+        union Data {
+            bool boolean;
+            intmax_t integer;
+            double real;
+            std::string text;
+            Blob blob;
+            BlobView blobView;
+            struct {
+                const char* data;
+                size_t size;
+            } textView;
+            std::shared_ptr< const std::string > sharedText;
+            std::shared_ptr< const Blob > sharedBlob;
+
+            Data() noexcept {}
+            ~Data() noexcept {}
+        };
+
+        /**
+         * This indicates which member of the data union is active,
+         * as well as what kind of value this is.
          */
-        struct Impl;
+        Type type_ = Type::Invalid;
 
         /**
-         * This contains the private properties of the instance.
+         * This indicates whether a blob value holds a view of data
+         * owned by something else, rather than its own vector.
          */
-        std::unique_ptr< Impl > impl_;
+        bool borrowed_ = false;
+
+        /**
+         * This indicates whether a text, error, or blob value keeps its
+         * data in an arena, referenced through a view.  It's mutable
+         * because converting such a text value to a std::string reference
+         * has to copy the text into the value.
+         */
+        mutable bool inArena_ = false;
+
+        /**
+         * This indicates whether a text, error, or blob value holds
+         * a pointer to a shared buffer holding its data (see Share).
+         */
+        bool shared_ = false;
+
+        /**
+         * This holds the data of the value.
+         */
+        mutable Data data_;
+
+        // Private Methods
+    private:
+        /**
+         * This is used to determine whether or not the text member
+         * of the data union is active.
+         *
+         * @return
+         *     An indication of whether or not the value holds a string
+         *     is returned.
+         */
+        bool HoldsString() const noexcept;
+
+        /**
+         * This is used to determine whether or not the blob member
+         * of the data union is active.
+         *
+         * @return
+         *     An indication of whether or not the value holds an owned
+         *     blob is returned.
+         */
+        bool HoldsBlob() const noexcept;
+
+        /**
+         * This returns the text of a text or error value, wherever
+         * it's kept.
+         *
+         * @param[out] size
+         *     This is where to store the number of bytes of text.
+         *
+         * @return
+         *     A pointer to the text, which is followed by a null
+         *     terminator, is returned.
+         */
+        const char* GetText(size_t& size) const noexcept;
+
+        /**
+         * If the value is text kept in an arena, this copies the text
+         * into the value.
+         */
+        void OwnText() const;
+
+        /**
+         * This destroys any data held by the value, leaving it invalid.
+         */
+        void Clear() noexcept;
+
+        /**
+         * This copies the data of the given value into this value,
+         * which must be invalid.
+         *
+         * @param[in] other
+         *     This is the value to copy.
+         */
+        void CopyFrom(const Value& other);
+
+        /**
+         * This moves the data of the given value into this value,
+         * which must be invalid.  The other value is left invalid.
+         *
+         * @param[in,out] other
+         *     This is the value to move.
+         */
+        void MoveFrom(Value& other) noexcept;
+
+        /**
+         * This replaces the data of the value with the given text,
+         * reusing the existing string storage if any.
+         *
+         * @param[in] text
+         *     This is the text to store.
+         *
+         * @param[in] type
+         *     This is the type of value to make (text or error).
+         */
+        template< typename T > void AssignString(T&& text, Type type);
+
+        /**
+         * This replaces the data of the value with the given owned blob,
+         * reusing the existing blob storage if any.
+         *
+         * @param[in] blob
+         *     This is the blob to store.
+         */
+        template< typename T > void AssignBlob(T&& blob);
     };
 
     /**
@@ -103,3 +475,17 @@ namespace DatabaseAbstractions {
     );
 
 }
+
+namespace std {
+
+    /**
+     * This lets database values be used as keys in standard
+     * unordered containers.
+     */
+    template<> struct hash< DatabaseAbstractions::Value > {
+        size_t operator()(const DatabaseAbstractions::Value& value) const {
+            return value.Hash();
+        }
+    };
+
+}
@@ -0,0 +1,259 @@
+#pragma once
+
+/**
+ * @file ValueEncoding.hpp
+ *
+ * This file declares the functions which encode database values and batches
+ * of rows into a compact binary form, suitable for sending to other members
+ * of a cluster, along with the DatabaseAbstractions::ValueDecoder class,
+ * which decodes them again.
+ *
+ * Each value is encoded as a one-byte tag giving its type, followed by its
+ * data, if any:
+ * - Booleans are one byte, 0 or 1.
+ * - Integers are zigzag-encoded into 7-bit groups, least significant first,
+ *   so that small positive and negative numbers take few bytes.
+ * - Reals are the 8 bytes of their IEEE 754 representation, least
+ *   significant first.
+ * - Text, errors, and blobs are the number of bytes, encoded like an
+ *   unsigned integer, followed by the bytes.
+ *
+ * A batch of rows is encoded as the number of columns, the tag of each
+ * column's type, and the number of rows, followed by the values of each
+ * row in turn.
+ */
+
+#include "Arena.hpp"
+#include "RowBatch.hpp"
+#include "Value.hpp"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+
+namespace DatabaseAbstractions {
+
+    /**
+     * These are the tags which identify the type of each encoded value.
+     */
+    enum class ValueTag : uint8_t {
+        Invalid = 0,
+        Null = 1,
+        Boolean = 2,
+        Integer = 3,
+        Real = 4,
+        Text = 5,
+        Blob = 6,
+        Error = 7,
+    };
+
+    /**
+     * This appends the encoding of a value to the given buffer.
+     *
+     * @param[in] value
+     *     This is the value to encode.
+     *
+     * @param[in,out] buffer
+     *     This is the buffer to which to append the encoding.
+     */
+    void EncodeValue(
+        const Value& value,
+        Blob& buffer
+    );
+
+    /**
+     * This appends the encoding of the given row values to the given
+     * buffer.  The number of values isn't encoded.
+     *
+     * @param[in] values
+     *     This points to the first value to encode.
+     *
+     * @param[in] count
+     *     This is the number of values to encode.
+     *
+     * @param[in,out] buffer
+     *     This is the buffer to which to append the encoding.
+     */
+    void EncodeValues(
+        const Value* values,
+        size_t count,
+        Blob& buffer
+    );
+
+    /**
+     * This appends the encoding of a batch of rows to the given buffer.
+     *
+     * @param[in] batch
+     *     This is the batch of rows to encode.
+     *
+     * @param[in,out] buffer
+     *     This is the buffer to which to append the encoding.
+     */
+    void EncodeRowBatch(
+        const RowBatch& batch,
+        Blob& buffer
+    );
+
+    /**
+     * This reads encoded values and batches of rows from a buffer,
+     * checking that they don't run past its end.
+     *
+     * Decoding doesn't copy anything it doesn't have to.  Blobs are
+     * decoded as borrowed values (see Value::IsBorrowed) referring
+     * directly to the buffer, so the buffer must outlive them, or
+     * Value::Own must be called on them.  Text is copied, either into
+     * the value itself or into an arena, because text values keep
+     * a null terminator after their text.
+     */
+    class ValueDecoder {
+        // Construction
+    public:
+        /**
+         * This constructs a decoder which reads from the given buffer.
+         *
+         * @param[in] buffer
+         *     This is the buffer from which to read.  It must outlive
+         *     the decoder and any blobs decoded from it.
+         */
+        explicit ValueDecoder(BlobView buffer);
+
+        // Methods
+    public:
+        /**
+         * This determines whether or not the whole buffer has been read.
+         *
+         * @return
+         *     An indication of whether or not the whole buffer
+         *     has been read is returned.
+         */
+        bool AtEnd() const;
+
+        /**
+         * This returns the number of bytes read from the buffer so far.
+         *
+         * @return
+         *     The number of bytes read from the buffer so far
+         *     is returned.
+         */
+        size_t GetOffset() const;
+
+        /**
+         * This reads the next value from the buffer.  Any text
+         * is copied into the value.
+         *
+         * @param[out] value
+         *     This is where to store the value.
+         *
+         * @return
+         *     If an error occurs, a description of the error is returned,
+         *     and the position of the decoder is unspecified.
+         *     Otherwise, an empty string is returned.
+         */
+        std::string Decode(Value& value);
+
+        /**
+         * This reads the next value from the buffer.  Any text is copied
+         * into the given arena, so the value mustn't be used after the
+         * arena is reset or destroyed (see Value::Assign).
+         *
+         * @param[out] value
+         *     This is where to store the value.
+         *
+         * @param[in,out] arena
+         *     This is the arena into which to copy any text.
+         *
+         * @return
+         *     If an error occurs, a description of the error is returned,
+         *     and the position of the decoder is unspecified.
+         *     Otherwise, an empty string is returned.
+         */
+        std::string Decode(
+            Value& value,
+            Arena& arena
+        );
+
+        /**
+         * This reads the next batch of rows from the buffer, replacing
+         * the contents of the given batch.  If the batch already has
+         * the same columns, its values and arena are reused.  Any text
+         * is copied into the arena of the batch.
+         *
+         * @param[in,out] batch
+         *     This is where to store the rows.
+         *
+         * @return
+         *     If an error occurs, a description of the error is returned,
+         *     and the contents of the batch are unspecified.
+         *     Otherwise, an empty string is returned.
+         */
+        std::string Decode(RowBatch& batch);
+
+        // Private Methods
+    private:
+        /**
+         * This reads the next value from the buffer.
+         *
+         * @param[out] value
+         *     This is where to store the value.
+         *
+         * @param[in,out] arena
+         *     If not null, this is the arena into which to copy any text.
+         *
+         * @return
+         *     If an error occurs, a description of the error is returned.
+         *     Otherwise, an empty string is returned.
+         */
+        std::string DecodeValue(
+            Value& value,
+            Arena* arena
+        );
+
+        /**
+         * This reads an unsigned integer encoded in 7-bit groups.
+         *
+         * @param[out] value
+         *     This is where to store the integer.
+         *
+         * @return
+         *     An indication of whether or not the integer
+         *     was read is returned.
+         */
+        bool ReadVarint(uint64_t& value);
+
+        /**
+         * This reads a length-prefixed sequence of bytes.
+         *
+         * @param[out] data
+         *     This is where to store a pointer to the bytes.
+         *
+         * @param[out] size
+         *     This is where to store the number of bytes.
+         *
+         * @return
+         *     An indication of whether or not the bytes
+         *     were read is returned.
+         */
+        bool ReadBytes(
+            const uint8_t*& data,
+            size_t& size
+        );
+
+        // Private Properties
+    private:
+        /**
+         * This points to the start of the buffer.
+         */
+        const uint8_t* begin_;
+
+        /**
+         * This points to the next byte to read.
+         */
+        const uint8_t* next_;
+
+        /**
+         * This points just past the end of the buffer.
+         */
+        const uint8_t* end_;
+    };
+
+}
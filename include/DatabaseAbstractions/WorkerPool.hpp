@@ -0,0 +1,81 @@
+#pragma once
+
+/**
+ * @file WorkerPool.hpp
+ *
+ * This file defines the DatabaseAbstractions::WorkerPool class, which
+ * runs work on a fixed set of background threads.
+ */
+
+#include <functional>
+#include <memory>
+#include <stddef.h>
+
+namespace DatabaseAbstractions {
+
+    /**
+     * This runs functions given to it on a fixed number of worker
+     * threads, in the order they're given, as threads become available.
+     */
+    class WorkerPool {
+        // Lifecycle
+    public:
+        /**
+         * This waits for all work already given to the pool to be
+         * finished, and then stops the worker threads.  If the pool is
+         * destroyed by one of its own worker threads (for example, when
+         * the last reference to it is released by work it's doing),
+         * that thread finishes the remaining work after the pool is gone.
+         */
+        ~WorkerPool() noexcept;
+        WorkerPool(const WorkerPool&) = delete;
+        WorkerPool(WorkerPool&&) noexcept;
+        WorkerPool& operator=(const WorkerPool&) = delete;
+        WorkerPool& operator=(WorkerPool&&) noexcept;
+
+        // Construction
+    public:
+        /**
+         * This constructs the pool and starts its worker threads.
+         *
+         * @param[in] threadCount
+         *     This is the number of worker threads to start.  If zero,
+         *     one thread is started for each processor core.
+         */
+        explicit WorkerPool(size_t threadCount = 0);
+
+        // Methods
+    public:
+        /**
+         * This returns the number of worker threads in the pool.
+         *
+         * @return
+         *     The number of worker threads in the pool is returned.
+         */
+        size_t GetThreadCount() const;
+
+        /**
+         * This queues the given function to be called on one of
+         * the worker threads.
+         *
+         * @param[in] work
+         *     This is the function to call.
+         */
+        void Post(std::function< void() > work);
+
+        // Private Properties
+    private:
+        /**
+         * This is the type of structure that contains the private
+         * properties of the instance.  It is defined in the implementation
+         * and declared here to ensure that it is scoped inside the class.
+         */
+        struct Impl;
+
+        /**
+         * This contains the private properties of the instance.
+         */
+        std::unique_ptr< Impl > impl_;
+    };
+
+}
@@ -0,0 +1,133 @@
+#pragma once
+
+/**
+ * @file WriteBatch.hpp
+ *
+ * This file defines the DatabaseAbstractions::WriteBatch class, which
+ * collects statements and their parameters so that they can be applied
+ * to a database together.
+ */
+
+#include "Value.hpp"
+
+#include <initializer_list>
+#include <memory>
+#include <stddef.h>
+#include <string>
+#include <vector>
+
+namespace DatabaseAbstractions {
+
+    /**
+     * This is a list of SQL statements, each with the values to bind to
+     * its parameters, which are meant to be applied to a database
+     * together, as one atomic change.  For example, a batch might hold
+     * the changes made by a number of committed entries of a cluster's
+     * log.
+     *
+     * The batch keeps its own copies of all values, including blobs which
+     * were borrowed when they were added, so nothing the values refer to
+     * needs to outlive the call which adds them.
+     */
+    class WriteBatch {
+        // Lifecycle
+    public:
+        ~WriteBatch() noexcept;
+        WriteBatch(const WriteBatch&) = delete;
+        WriteBatch(WriteBatch&&) noexcept;
+        WriteBatch& operator=(const WriteBatch&) = delete;
+        WriteBatch& operator=(WriteBatch&&) noexcept;
+
+        // Construction
+    public:
+        /**
+         * This constructs an empty batch.
+         */
+        WriteBatch();
+
+        // Methods
+    public:
+        /**
+         * This adds a statement to the end of the batch.
+         *
+         * @param[in] statement
+         *     This is the SQL text of the statement.
+         *
+         * @param[in] parameters
+         *     These are the values to bind to the statement's parameters,
+         *     starting with the first one.
+         */
+        void Add(
+            const std::string& statement,
+            std::initializer_list< const Value > parameters = {}
+        );
+
+        /**
+         * This adds a statement to the end of the batch, taking the
+         * values to bind to its parameters.
+         *
+         * @param[in] statement
+         *     This is the SQL text of the statement.
+         *
+         * @param[in] parameters
+         *     These are the values to bind to the statement's parameters,
+         *     starting with the first one.
+         */
+        void Add(
+            const std::string& statement,
+            std::vector< Value >&& parameters
+        );
+
+        /**
+         * This returns the number of statements in the batch.
+         *
+         * @return
+         *     The number of statements in the batch is returned.
+         */
+        size_t GetSize() const;
+
+        /**
+         * This returns the SQL text of the given statement in the batch.
+         *
+         * @param[in] index
+         *     This is the position of the statement in the batch.
+         *
+         * @return
+         *     The SQL text of the statement is returned.
+         */
+        const std::string& GetStatement(size_t index) const;
+
+        /**
+         * This returns the values to bind to the parameters of the given
+         * statement in the batch.
+         *
+         * @param[in] index
+         *     This is the position of the statement in the batch.
+         *
+         * @return
+         *     The values to bind to the parameters of the statement,
+         *     starting with the first one, are returned.
+         */
+        const std::vector< Value >& GetParameters(size_t index) const;
+
+        /**
+         * This removes all statements from the batch.
+         */
+        void Clear();
+
+        // Private Properties
+    private:
+        /**
+         * This is the type of structure that contains the private
+         * properties of the instance.  It is defined in the implementation
+         * and declared here to ensure that it is scoped inside the class.
+         */
+        struct Impl;
+
+        /**
+         * This contains the private properties of the instance.
+         */
+        std::unique_ptr< Impl > impl_;
+    };
+
+}
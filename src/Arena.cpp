@@ -0,0 +1,152 @@
+/**
+ * @file Arena.cpp
+ *
+ * This file contains the implementation
+ * of the DatabaseAbstractions::Arena class.
+ */
+
+#include <algorithm>
+#include <DatabaseAbstractions/Arena.hpp>
+#include <stdint.h>
+#include <vector>
+
+namespace {
+
+    /**
+     * This is a piece of memory from which an arena hands out memory.
+     */
+    struct Block {
+        /**
+         * This is the memory of the block.
+         */
+        std::unique_ptr< uint8_t[] > memory;
+
+        /**
+         * This is the number of bytes in the block.
+         */
+        size_t size = 0;
+    };
+
+}
+
+namespace DatabaseAbstractions {
+
+    struct Arena::Impl {
+        // Properties
+
+        /**
+         * This is the number of bytes to allocate at a time.
+         */
+        size_t blockSize = 0;
+
+        /**
+         * These are the blocks held by the arena, in the order in which
+         * memory is handed out from them.
+         */
+        std::vector< Block > blocks;
+
+        /**
+         * This is the index of the block from which memory is currently
+         * being handed out.
+         */
+        size_t current = 0;
+
+        /**
+         * This is the offset of the first byte not yet handed out
+         * from the current block.
+         */
+        size_t offset = 0;
+
+        /**
+         * This is the number of bytes handed out since the arena
+         * was constructed or last reset.
+         */
+        size_t bytesUsed = 0;
+
+        /**
+         * This is the total size of the blocks held by the arena.
+         */
+        size_t bytesReserved = 0;
+
+        // Methods
+
+        /**
+         * This tries to carve the given amount of memory from the
+         * current block.
+         *
+         * @param[in] size
+         *     This is the number of bytes needed.
+         *
+         * @param[in] alignment
+         *     This is the alignment required for the memory.
+         *
+         * @return
+         *     A pointer to the memory is returned, or nullptr if the
+         *     current block doesn't have room for it.
+         */
+        void* Carve(size_t size, size_t alignment) {
+            if (current >= blocks.size()) {
+                return nullptr;
+            }
+            auto& block = blocks[current];
+            const auto base = (uintptr_t)block.memory.get();
+            const auto start = ((base + offset + alignment - 1) & ~(uintptr_t)(alignment - 1)) - base;
+            if (start + size > block.size) {
+                return nullptr;
+            }
+            offset = start + size;
+            bytesUsed += size;
+            return block.memory.get() + start;
+        }
+    };
+
+    Arena::~Arena() noexcept = default;
+    Arena::Arena(Arena&&) noexcept = default;
+    Arena& Arena::operator=(Arena&&) noexcept = default;
+
+    Arena::Arena(size_t blockSize)
+        : impl_(new Impl())
+    {
+        impl_->blockSize = std::max(blockSize, (size_t)1);
+    }
+
+    void* Arena::Allocate(
+        size_t size,
+        size_t alignment
+    ) {
+        for (;;) {
+            const auto memory = impl_->Carve(size, alignment);
+            if (memory != nullptr) {
+                return memory;
+            }
+            if (impl_->current + 1 >= impl_->blocks.size()) {
+                break;
+            }
+            ++impl_->current;
+            impl_->offset = 0;
+        }
+        Block block;
+        block.size = std::max(impl_->blockSize, size + alignment - 1);
+        block.memory.reset(new uint8_t[block.size]);
+        impl_->bytesReserved += block.size;
+        impl_->blocks.push_back(std::move(block));
+        impl_->current = impl_->blocks.size() - 1;
+        impl_->offset = 0;
+        return impl_->Carve(size, alignment);
+    }
+
+    void Arena::Reset() {
+        impl_->current = 0;
+        impl_->offset = 0;
+        impl_->bytesUsed = 0;
+    }
+
+    size_t Arena::GetBytesUsed() const {
+        return impl_->bytesUsed;
+    }
+
+    size_t Arena::GetBytesReserved() const {
+        return impl_->bytesReserved;
+    }
+
+}
@@ -0,0 +1,583 @@
+/**
+ * @file AsyncDatabase.cpp
+ *
+ * This file contains the implementation
+ * of the DatabaseAbstractions::AsyncDatabase class.
+ */
+
+#include <condition_variable>
+#include <DatabaseAbstractions/AsyncDatabase.hpp>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <utility>
+
+namespace {
+
+    using namespace DatabaseAbstractions;
+
+    /**
+     * This is the maximum number of functions a strand calls each time
+     * it's given a worker thread, before giving the thread back to the
+     * pool so that other work sharing the pool gets a turn.
+     */
+    constexpr size_t MAX_WORK_PER_TURN = 16;
+
+    class Strand;
+
+    /**
+     * This is the strand, if any, whose work is being done
+     * by the current thread.
+     */
+    thread_local const Strand* currentStrand = nullptr;
+
+    /**
+     * This calls functions given to it on the threads of a worker pool,
+     * one at a time, in the order they're given.
+     */
+    class Strand
+        : public std::enable_shared_from_this< Strand >
+    {
+        // Lifecycle
+    public:
+        explicit Strand(std::shared_ptr< WorkerPool > pool)
+            : pool_(pool)
+        {
+        }
+
+        // Methods
+    public:
+        /**
+         * This queues the given function to be called after all the
+         * functions queued before it.
+         *
+         * @param[in] work
+         *     This is the function to call.
+         */
+        void Post(std::function< void() > work) {
+            bool start = false;
+            {
+                std::lock_guard< decltype(mutex_) > lock(mutex_);
+                queue_.push_back(std::move(work));
+                if (!running_) {
+                    running_ = true;
+                    start = true;
+                }
+            }
+            if (start) {
+                Schedule();
+            }
+        }
+
+        /**
+         * This calls the given function after all the functions queued
+         * before it, and waits for it to return.  If called by work
+         * already being done by the strand, the function is called
+         * immediately instead.
+         *
+         * @param[in] work
+         *     This is the function to call.
+         */
+        void Run(const std::function< void() >& work) {
+            if (currentStrand == this) {
+                work();
+                return;
+            }
+            std::mutex doneMutex;
+            std::condition_variable doneCondition;
+            bool done = false;
+            Post(
+                [&]{
+                    work();
+                    std::lock_guard< decltype(doneMutex) > lock(doneMutex);
+                    done = true;
+                    doneCondition.notify_all();
+                }
+            );
+            std::unique_lock< decltype(doneMutex) > lock(doneMutex);
+            doneCondition.wait(lock, [&done]{ return done; });
+        }
+
+        // Private Methods
+    private:
+        /**
+         * This asks the pool for a worker thread to do queued work.
+         */
+        void Schedule() {
+            const auto self = shared_from_this();
+            pool_->Post([self]{ self->Drain(); });
+        }
+
+        /**
+         * This calls queued functions until the queue is empty or the
+         * strand has had its turn, in which case it asks the pool for
+         * another thread to carry on later.
+         */
+        void Drain() {
+            const auto previousStrand = currentStrand;
+            currentStrand = this;
+            for (size_t i = 0; i < MAX_WORK_PER_TURN; ++i) {
+                std::function< void() > work;
+                {
+                    std::lock_guard< decltype(mutex_) > lock(mutex_);
+                    if (queue_.empty()) {
+                        running_ = false;
+                        currentStrand = previousStrand;
+                        return;
+                    }
+                    work = std::move(queue_.front());
+                    queue_.pop_front();
+                }
+                work();
+            }
+            currentStrand = previousStrand;
+            Schedule();
+        }
+
+        // Private Properties
+    private:
+        /**
+         * This is the pool whose threads do the work of the strand.
+         */
+        std::shared_ptr< WorkerPool > pool_;
+
+        /**
+         * This is used to synchronize access to the queue and
+         * the running flag.
+         */
+        std::mutex mutex_;
+
+        /**
+         * These are the functions waiting to be called.
+         */
+        std::deque< std::function< void() > > queue_;
+
+        /**
+         * This flag is set while a worker thread has been asked to call
+         * queued functions.
+         */
+        bool running_ = false;
+    };
+
+    /**
+     * This releases the given object on the given strand, so that the
+     * object is destroyed in line with the other work done with it.
+     *
+     * @param[in] strand
+     *     This is the strand on which to release the object.
+     *
+     * @param[in,out] object
+     *     This is the object to release.
+     */
+    template< typename T > void ReleaseOnStrand(
+        const std::shared_ptr< Strand >& strand,
+        std::shared_ptr< T >& object
+    ) {
+        if (object == nullptr) {
+            return;
+        }
+        std::shared_ptr< T > released;
+        released.swap(object);
+        strand->Post([released]{});
+    }
+
+    /**
+     * This is a statement which does the work of a statement prepared by
+     * the wrapped database on the strand of an AsyncDatabase.
+     */
+    class AsyncStatement
+        : public PreparedStatement
+    {
+        // Lifecycle
+    public:
+        ~AsyncStatement() noexcept {
+            ReleaseOnStrand(strand_, statement_);
+        }
+        AsyncStatement(const AsyncStatement&) = delete;
+        AsyncStatement(AsyncStatement&&) = delete;
+        AsyncStatement& operator=(const AsyncStatement&) = delete;
+        AsyncStatement& operator=(AsyncStatement&&) = delete;
+
+        // Construction
+    public:
+        AsyncStatement(
+            std::shared_ptr< PreparedStatement > statement,
+            std::shared_ptr< Strand > strand
+        )
+            : statement_(statement)
+            , strand_(strand)
+        {
+        }
+
+        // PreparedStatement
+    public:
+        virtual void BindParameter(
+            int index,
+            const Value& value
+        ) override {
+            strand_->Run([&]{ statement_->BindParameter(index, value); });
+        }
+
+        virtual void BindParameter(
+            int index,
+            Value&& value
+        ) override {
+            strand_->Run([&]{ statement_->BindParameter(index, std::move(value)); });
+        }
+
+        virtual void BindParameters(std::initializer_list< const Value > values) override {
+            strand_->Run([&]{ statement_->BindParameters(values); });
+        }
+
+        virtual void BindParameters(std::vector< Value >&& values) override {
+            strand_->Run([&]{ statement_->BindParameters(std::move(values)); });
+        }
+
+        virtual Value FetchColumn(int index, Value::Type type) override {
+            Value value;
+            strand_->Run([&]{ value = statement_->FetchColumn(index, type); });
+            return value;
+        }
+
+        virtual void FetchColumn(
+            int index,
+            Value::Type type,
+            Value& value
+        ) override {
+            strand_->Run([&]{ statement_->FetchColumn(index, type, value); });
+        }
+
+        virtual void Reset() override {
+            strand_->Run([&]{ statement_->Reset(); });
+        }
+
+        virtual StepStatementResults Step() override {
+            StepStatementResults results;
+            strand_->Run([&]{ results = statement_->Step(); });
+            return results;
+        }
+
+        virtual StepStatementResults StepBatch(
+            size_t maxRows,
+            RowBatch& batch
+        ) override {
+            StepStatementResults results;
+            strand_->Run([&]{ results = statement_->StepBatch(maxRows, batch); });
+            return results;
+        }
+
+        virtual void StepAsync(StepStatementCallback callback) override {
+            const auto statement = statement_;
+            strand_->Post(
+                [statement, callback]{
+                    callback(statement->Step());
+                }
+            );
+        }
+
+        // Private Properties
+    private:
+        /**
+         * This is the statement prepared by the wrapped database.
+         */
+        std::shared_ptr< PreparedStatement > statement_;
+
+        /**
+         * This is the strand on which to do the work of the statement.
+         */
+        std::shared_ptr< Strand > strand_;
+    };
+
+    /**
+     * This is a snapshot reader which does the work of a reader made by
+     * the wrapped database on the strand of an AsyncDatabase.
+     */
+    class AsyncSnapshotReader
+        : public SnapshotReader
+    {
+        // Lifecycle
+    public:
+        ~AsyncSnapshotReader() noexcept {
+            ReleaseOnStrand(strand_, reader_);
+        }
+
+        // Construction
+    public:
+        AsyncSnapshotReader(
+            std::shared_ptr< SnapshotReader > reader,
+            std::shared_ptr< Strand > strand
+        )
+            : reader_(reader)
+            , strand_(strand)
+        {
+        }
+
+        // SnapshotReader
+    public:
+        virtual ReadSnapshotChunkResults ReadChunk(Blob& chunk) override {
+            ReadSnapshotChunkResults results;
+            strand_->Run([&]{ results = reader_->ReadChunk(chunk); });
+            return results;
+        }
+
+        // Private Properties
+    private:
+        /**
+         * This is the reader made by the wrapped database.
+         */
+        std::shared_ptr< SnapshotReader > reader_;
+
+        /**
+         * This is the strand on which to do the work of the reader.
+         */
+        std::shared_ptr< Strand > strand_;
+    };
+
+    /**
+     * This is a snapshot writer which does the work of a writer made by
+     * the wrapped database on the strand of an AsyncDatabase.
+     */
+    class AsyncSnapshotWriter
+        : public SnapshotWriter
+    {
+        // Lifecycle
+    public:
+        ~AsyncSnapshotWriter() noexcept {
+            ReleaseOnStrand(strand_, writer_);
+        }
+
+        // Construction
+    public:
+        AsyncSnapshotWriter(
+            std::shared_ptr< SnapshotWriter > writer,
+            std::shared_ptr< Strand > strand
+        )
+            : writer_(writer)
+            , strand_(strand)
+        {
+        }
+
+        // SnapshotWriter
+    public:
+        virtual std::string WriteChunk(BlobView chunk) override {
+            std::string error;
+            strand_->Run([&]{ error = writer_->WriteChunk(chunk); });
+            return error;
+        }
+
+        virtual std::string Finish() override {
+            std::string error;
+            strand_->Run([&]{ error = writer_->Finish(); });
+            return error;
+        }
+
+        // Private Properties
+    private:
+        /**
+         * This is the writer made by the wrapped database.
+         */
+        std::shared_ptr< SnapshotWriter > writer_;
+
+        /**
+         * This is the strand on which to do the work of the writer.
+         */
+        std::shared_ptr< Strand > strand_;
+    };
+
+    /**
+     * This wraps the statement in the given results, if any, so that its
+     * work is done on the given strand.
+     *
+     * @param[in,out] results
+     *     These are the results of building the statement.
+     *
+     * @param[in] strand
+     *     This is the strand on which to do the work of the statement.
+     */
+    void WrapStatement(
+        BuildStatementResults& results,
+        const std::shared_ptr< Strand >& strand
+    ) {
+        if (results.statement != nullptr) {
+            results.statement = std::make_shared< AsyncStatement >(
+                results.statement,
+                strand
+            );
+        }
+    }
+
+}
+
+namespace DatabaseAbstractions {
+
+    struct AsyncDatabase::Impl {
+        // Properties
+
+        /**
+         * This is the database being wrapped.
+         */
+        std::shared_ptr< Database > database;
+
+        /**
+         * This is the strand on which all the work of the wrapped
+         * database is done.
+         */
+        std::shared_ptr< Strand > strand;
+    };
+
+    AsyncDatabase::~AsyncDatabase() noexcept {
+        if (impl_ != nullptr) {
+            ReleaseOnStrand(impl_->strand, impl_->database);
+        }
+    }
+
+    AsyncDatabase::AsyncDatabase(AsyncDatabase&&) noexcept = default;
+
+    AsyncDatabase& AsyncDatabase::operator=(AsyncDatabase&& other) noexcept {
+        if (this != &other) {
+            if (impl_ != nullptr) {
+                ReleaseOnStrand(impl_->strand, impl_->database);
+            }
+            impl_ = std::move(other.impl_);
+        }
+        return *this;
+    }
+
+    AsyncDatabase::AsyncDatabase(
+        std::shared_ptr< Database > database,
+        std::shared_ptr< WorkerPool > pool
+    )
+        : impl_(new Impl())
+    {
+        impl_->database = database;
+        impl_->strand = std::make_shared< Strand >(pool);
+    }
+
+    BuildStatementResults AsyncDatabase::BuildStatement(
+        const std::string& statement
+    ) {
+        BuildStatementResults results;
+        impl_->strand->Run([&]{ results = impl_->database->BuildStatement(statement); });
+        WrapStatement(results, impl_->strand);
+        return results;
+    }
+
+    std::string AsyncDatabase::ExecuteStatement(const std::string& statement) {
+        std::string error;
+        impl_->strand->Run([&]{ error = impl_->database->ExecuteStatement(statement); });
+        return error;
+    }
+
+    std::string AsyncDatabase::BeginTransaction() {
+        std::string error;
+        impl_->strand->Run([&]{ error = impl_->database->BeginTransaction(); });
+        return error;
+    }
+
+    std::string AsyncDatabase::CommitTransaction() {
+        std::string error;
+        impl_->strand->Run([&]{ error = impl_->database->CommitTransaction(); });
+        return error;
+    }
+
+    std::string AsyncDatabase::RollbackTransaction() {
+        std::string error;
+        impl_->strand->Run([&]{ error = impl_->database->RollbackTransaction(); });
+        return error;
+    }
+
+    std::string AsyncDatabase::ApplyWriteBatch(const WriteBatch& batch) {
+        std::string error;
+        impl_->strand->Run([&]{ error = impl_->database->ApplyWriteBatch(batch); });
+        return error;
+    }
+
+    void AsyncDatabase::BuildStatementAsync(
+        const std::string& statement,
+        BuildStatementCallback callback
+    ) {
+        const auto database = impl_->database;
+        const auto strand = impl_->strand;
+        strand->Post(
+            [database, strand, statement, callback]{
+                auto results = database->BuildStatement(statement);
+                WrapStatement(results, strand);
+                callback(results);
+            }
+        );
+    }
+
+    void AsyncDatabase::ExecuteAsync(
+        const std::string& statement,
+        CompletionCallback callback
+    ) {
+        const auto database = impl_->database;
+        impl_->strand->Post(
+            [database, statement, callback]{
+                callback(database->ExecuteStatement(statement));
+            }
+        );
+    }
+
+    void AsyncDatabase::ApplyWriteBatchAsync(
+        WriteBatch&& batch,
+        CompletionCallback callback
+    ) {
+        const auto database = impl_->database;
+        const auto sharedBatch = std::make_shared< WriteBatch >(std::move(batch));
+        impl_->strand->Post(
+            [database, sharedBatch, callback]{
+                callback(database->ApplyWriteBatch(*sharedBatch));
+            }
+        );
+    }
+
+    Blob AsyncDatabase::CreateSnapshot() {
+        Blob blob;
+        impl_->strand->Run([&]{ blob = impl_->database->CreateSnapshot(); });
+        return blob;
+    }
+
+    std::string AsyncDatabase::InstallSnapshot(const Blob& blob) {
+        std::string error;
+        impl_->strand->Run([&]{ error = impl_->database->InstallSnapshot(blob); });
+        return error;
+    }
+
+    std::shared_ptr< SnapshotReader > AsyncDatabase::CreateSnapshotReader(size_t chunkSize) {
+        std::shared_ptr< SnapshotReader > reader;
+        impl_->strand->Run([&]{ reader = impl_->database->CreateSnapshotReader(chunkSize); });
+        return std::make_shared< AsyncSnapshotReader >(reader, impl_->strand);
+    }
+
+    std::shared_ptr< SnapshotReader > AsyncDatabase::CaptureSnapshot(size_t chunkSize) {
+        std::shared_ptr< SnapshotReader > reader;
+        impl_->strand->Run([&]{ reader = impl_->database->CaptureSnapshot(chunkSize); });
+        return reader;
+    }
+
+    std::shared_ptr< SnapshotWriter > AsyncDatabase::CreateSnapshotWriter() {
+        std::shared_ptr< SnapshotWriter > writer;
+        impl_->strand->Run([&]{ writer = impl_->database->CreateSnapshotWriter(); });
+        return std::make_shared< AsyncSnapshotWriter >(writer, impl_->strand);
+    }
+
+    uint64_t AsyncDatabase::GetSnapshotId() {
+        uint64_t id = 0;
+        impl_->strand->Run([&]{ id = impl_->database->GetSnapshotId(); });
+        return id;
+    }
+
+    DeltaSnapshot AsyncDatabase::CreateDeltaSnapshot(uint64_t baseId) {
+        DeltaSnapshot snapshot;
+        impl_->strand->Run([&]{ snapshot = impl_->database->CreateDeltaSnapshot(baseId); });
+        return snapshot;
+    }
+
+    std::string AsyncDatabase::InstallDeltaSnapshot(const DeltaSnapshot& snapshot) {
+        std::string error;
+        impl_->strand->Run([&]{ error = impl_->database->InstallDeltaSnapshot(snapshot); });
+        return error;
+    }
+
+}
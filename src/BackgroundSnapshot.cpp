@@ -0,0 +1,188 @@
+/**
+ * @file BackgroundSnapshot.cpp
+ *
+ * This file contains the implementation
+ * of the DatabaseAbstractions::BackgroundSnapshot class.
+ */
+
+#include <atomic>
+#include <DatabaseAbstractions/BackgroundSnapshot.hpp>
+#include <thread>
+
+namespace DatabaseAbstractions {
+
+    struct BackgroundSnapshot::Impl {
+        // Properties
+
+        /**
+         * This is the thread writing the snapshot.
+         */
+        std::thread thread;
+
+        /**
+         * This is the number of bytes of the snapshot written so far.
+         */
+        std::atomic< uint64_t > bytes{0};
+
+        /**
+         * This is the number of chunks of the snapshot written so far.
+         */
+        std::atomic< uint64_t > chunks{0};
+
+        /**
+         * This flag is set once the background thread is done
+         * with the snapshot.
+         */
+        std::atomic< bool > done{false};
+
+        /**
+         * This flag is set when the snapshot should stop before
+         * its next chunk.
+         */
+        std::atomic< bool > cancelled{false};
+
+        /**
+         * This describes what went wrong with the snapshot, if anything.
+         * It's only used by the background thread until it's joined.
+         */
+        std::string error;
+
+        // Methods
+
+        /**
+         * This is the body of the background thread.  It reads the
+         * snapshot one chunk at a time and writes each chunk, until the
+         * snapshot is complete, something fails, or it's cancelled.
+         *
+         * @param[in] reader
+         *     This is the source of the snapshot.
+         *
+         * @param[in] writer
+         *     This is where to write the snapshot.
+         *
+         * @param[in] progressCallback
+         *     If not null, this is called each time another chunk
+         *     has been written.
+         */
+        void Run(
+            std::shared_ptr< SnapshotReader > reader,
+            std::shared_ptr< SnapshotWriter > writer,
+            BackgroundSnapshotProgressCallback progressCallback
+        ) {
+            Blob chunk;
+            for (;;) {
+                if (cancelled) {
+                    error = "snapshot cancelled";
+                    break;
+                }
+                const auto results = reader->ReadChunk(chunk);
+                if (!results.error.empty()) {
+                    error = results.error;
+                    break;
+                }
+                if (results.done) {
+                    error = writer->Finish();
+                    break;
+                }
+                error = writer->WriteChunk(BlobView(chunk.data(), chunk.size()));
+                if (!error.empty()) {
+                    break;
+                }
+                bytes += chunk.size();
+                ++chunks;
+                if (progressCallback != nullptr) {
+                    BackgroundSnapshotProgress progress;
+                    progress.bytes = bytes;
+                    progress.chunks = chunks;
+                    progressCallback(progress);
+                }
+            }
+            done = true;
+        }
+    };
+
+    BackgroundSnapshot::~BackgroundSnapshot() noexcept {
+        if (impl_ == nullptr) {
+            return;
+        }
+        Cancel();
+        (void)Wait();
+    }
+
+    BackgroundSnapshot::BackgroundSnapshot(BackgroundSnapshot&&) noexcept = default;
+
+    BackgroundSnapshot& BackgroundSnapshot::operator=(BackgroundSnapshot&& other) noexcept {
+        if (this != &other) {
+            if (impl_ != nullptr) {
+                Cancel();
+                (void)Wait();
+            }
+            impl_ = std::move(other.impl_);
+        }
+        return *this;
+    }
+
+    BackgroundSnapshot::BackgroundSnapshot()
+        : impl_(new Impl())
+    {
+    }
+
+    std::string BackgroundSnapshot::Start(
+        Database& database,
+        std::shared_ptr< SnapshotWriter > writer,
+        BackgroundSnapshotProgressCallback progressCallback,
+        size_t chunkSize
+    ) {
+        if (impl_->thread.joinable()) {
+            return "a snapshot is already being written";
+        }
+        return Start(
+            database.CaptureSnapshot(chunkSize),
+            writer,
+            progressCallback
+        );
+    }
+
+    std::string BackgroundSnapshot::Start(
+        std::shared_ptr< SnapshotReader > reader,
+        std::shared_ptr< SnapshotWriter > writer,
+        BackgroundSnapshotProgressCallback progressCallback
+    ) {
+        if (impl_->thread.joinable()) {
+            return "a snapshot is already being written";
+        }
+        impl_->bytes = 0;
+        impl_->chunks = 0;
+        impl_->done = false;
+        impl_->cancelled = false;
+        impl_->error.clear();
+        impl_->thread = std::thread(
+            &Impl::Run,
+            impl_.get(),
+            reader,
+            writer,
+            progressCallback
+        );
+        return "";
+    }
+
+    BackgroundSnapshotProgress BackgroundSnapshot::GetProgress() const {
+        BackgroundSnapshotProgress progress;
+        progress.done = impl_->done;
+        progress.bytes = impl_->bytes;
+        progress.chunks = impl_->chunks;
+        return progress;
+    }
+
+    void BackgroundSnapshot::Cancel() {
+        impl_->cancelled = true;
+    }
+
+    std::string BackgroundSnapshot::Wait() {
+        if (impl_->thread.joinable()) {
+            impl_->thread.join();
+        }
+        return impl_->error;
+    }
+
+}
@@ -0,0 +1,1844 @@
+/**
+ * @file CachingDatabase.cpp
+ *
+ * This file contains the implementation
+ * of the DatabaseAbstractions::CachingDatabase class.
+ */
+
+#include <algorithm>
+#include <ctype.h>
+#include <DatabaseAbstractions/Arena.hpp>
+#include <DatabaseAbstractions/CachingDatabase.hpp>
+#include <DatabaseAbstractions/CompositeKey.hpp>
+#include <DatabaseAbstractions/ValueEncoding.hpp>
+#include <list>
+#include <mutex>
+#include <string.h>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace {
+
+    using namespace DatabaseAbstractions;
+
+    /**
+     * This is roughly the number of bytes of memory used by a cached
+     * result apart from its key, its rows, and its table names.
+     */
+    constexpr size_t ENTRY_OVERHEAD = 256;
+
+    /**
+     * These are the words which, when found after the name of a table
+     * in a FROM clause, are the start of the next part of the query
+     * rather than an alias for the table.
+     */
+    const std::unordered_set< std::string > CLAUSE_KEYWORDS{
+        "cross", "except", "full", "group", "having", "indexed", "inner",
+        "intersect", "join", "left", "limit", "natural", "not", "offset",
+        "on", "order", "outer", "right", "union", "using", "where", "window",
+    };
+
+    /**
+     * These are the words which start statements that neither read
+     * nor change any tables.
+     */
+    const std::unordered_set< std::string > TRANSACTION_KEYWORDS{
+        "begin", "commit", "end", "release", "savepoint",
+    };
+
+    /**
+     * This is one piece of SQL text, as far as the cache cares.
+     */
+    struct Token {
+        /**
+         * This is the text of the token.  Names are converted to lower
+         * case, and have any quotes removed.  String and number literals
+         * are replaced by a single quote or zero, respectively.
+         */
+        std::string text;
+
+        /**
+         * This indicates whether the token is a name or keyword,
+         * rather than a literal or punctuation.
+         */
+        bool name = false;
+    };
+
+    /**
+     * This describes which tables a statement reads and changes.
+     */
+    struct Access {
+        /**
+         * This indicates whether the statement only reads tables.
+         */
+        bool query = true;
+
+        /**
+         * This indicates whether the statement might change any table.
+         */
+        bool changesAll = false;
+
+        /**
+         * These are the names of the tables read by a query.
+         */
+        std::vector< std::string > tablesRead;
+
+        /**
+         * These are the names of the tables changed by the statement.
+         */
+        std::vector< std::string > tablesChanged;
+
+        /**
+         * This adds what another statement does to what this one does.
+         *
+         * @param[in] other
+         *     This describes what the other statement does.
+         */
+        void Add(const Access& other) {
+            query = query && other.query;
+            changesAll = changesAll || other.changesAll;
+            for (const auto& table: other.tablesChanged) {
+                AddTable(tablesChanged, table);
+            }
+            for (const auto& table: other.tablesRead) {
+                AddTable(tablesRead, table);
+            }
+        }
+
+        /**
+         * This adds a table name to the given list, unless it's
+         * already there.
+         *
+         * @param[in,out] tables
+         *     This is the list of table names to which to add the name.
+         *
+         * @param[in] table
+         *     This is the name of the table to add.
+         */
+        static void AddTable(
+            std::vector< std::string >& tables,
+            const std::string& table
+        ) {
+            if (std::find(tables.begin(), tables.end(), table) == tables.end()) {
+                tables.push_back(table);
+            }
+        }
+    };
+
+    /**
+     * This returns a copy of the given text in lower case.
+     *
+     * @param[in] text
+     *     This is the text to convert.
+     *
+     * @return
+     *     The text in lower case is returned.
+     */
+    std::string ToLower(std::string text) {
+        for (auto& c: text) {
+            c = (char)tolower((unsigned char)c);
+        }
+        return text;
+    }
+
+    /**
+     * This breaks the given SQL text into tokens, skipping whitespace
+     * and comments.
+     *
+     * @param[in] text
+     *     This is the SQL text to break into tokens.
+     *
+     * @return
+     *     The tokens of the SQL text are returned.
+     */
+    std::vector< Token > Tokenize(const std::string& text) {
+        std::vector< Token > tokens;
+        const auto length = text.length();
+        size_t i = 0;
+        while (i < length) {
+            const auto c = text[i];
+            Token token;
+            if (isspace((unsigned char)c)) {
+                ++i;
+                continue;
+            } else if (
+                (c == '-')
+                && (i + 1 < length)
+                && (text[i + 1] == '-')
+            ) {
+                while (
+                    (i < length)
+                    && (text[i] != '\n')
+                ) {
+                    ++i;
+                }
+                continue;
+            } else if (
+                (c == '/')
+                && (i + 1 < length)
+                && (text[i + 1] == '*')
+            ) {
+                const auto end = text.find("*/", i + 2);
+                i = ((end == std::string::npos) ? length : end + 2);
+                continue;
+            } else if (
+                (c == '\'')
+                || (c == '"')
+                || (c == '`')
+                || (c == '[')
+            ) {
+                const auto close = ((c == '[') ? ']' : c);
+                std::string quoted;
+                ++i;
+                while (i < length) {
+                    if (text[i] == close) {
+                        if (
+                            (close != ']')
+                            && (i + 1 < length)
+                            && (text[i + 1] == close)
+                        ) {
+                            quoted += close;
+                            i += 2;
+                            continue;
+                        }
+                        ++i;
+                        break;
+                    }
+                    quoted += text[i++];
+                }
+                if (c == '\'') {
+                    token.text = "'";
+                } else {
+                    token.text = ToLower(std::move(quoted));
+                    token.name = true;
+                }
+            } else if (
+                isalpha((unsigned char)c)
+                || (c == '_')
+            ) {
+                const auto start = i;
+                while (
+                    (i < length)
+                    && (
+                        isalnum((unsigned char)text[i])
+                        || (text[i] == '_')
+                        || (text[i] == '$')
+                    )
+                ) {
+                    ++i;
+                }
+                token.text = ToLower(text.substr(start, i - start));
+                token.name = true;
+            } else if (isdigit((unsigned char)c)) {
+                while (
+                    (i < length)
+                    && (
+                        isalnum((unsigned char)text[i])
+                        || (text[i] == '.')
+                    )
+                ) {
+                    ++i;
+                }
+                token.text = "0";
+            } else {
+                token.text = std::string(1, c);
+                ++i;
+            }
+            tokens.push_back(std::move(token));
+        }
+        return tokens;
+    }
+
+    /**
+     * This reads the name of a table, which may be qualified by the
+     * name of a schema, from the given tokens.
+     *
+     * @param[in] tokens
+     *     These are the tokens of the statement.
+     *
+     * @param[in,out] position
+     *     This is the index of the token at which the name should start.
+     *     On success, it's moved past the name.
+     *
+     * @param[out] table
+     *     This is where to store the name of the table.
+     *
+     * @return
+     *     An indication of whether or not a name was read is returned.
+     */
+    bool ReadTableName(
+        const std::vector< Token >& tokens,
+        size_t& position,
+        std::string& table
+    ) {
+        if (
+            (position >= tokens.size())
+            || !tokens[position].name
+        ) {
+            return false;
+        }
+        table = tokens[position++].text;
+        if (
+            (position + 1 < tokens.size())
+            && (tokens[position].text == ".")
+            && tokens[position + 1].name
+        ) {
+            table = tokens[position + 1].text;
+            position += 2;
+        }
+        return true;
+    }
+
+    /**
+     * This finds the given word among the given tokens.
+     *
+     * @param[in] tokens
+     *     These are the tokens of the statement.
+     *
+     * @param[in] word
+     *     This is the word to find.
+     *
+     * @return
+     *     The index of the first token holding the word is returned,
+     *     or the number of tokens if the word isn't found.
+     */
+    size_t FindWord(
+        const std::vector< Token >& tokens,
+        const std::string& word
+    ) {
+        for (size_t i = 0; i < tokens.size(); ++i) {
+            if (
+                tokens[i].name
+                && (tokens[i].text == word)
+            ) {
+                return i;
+            }
+        }
+        return tokens.size();
+    }
+
+    /**
+     * This adds to the given description the tables named in the
+     * FROM and JOIN clauses of a query.
+     *
+     * @param[in] tokens
+     *     These are the tokens of the query.
+     *
+     * @param[in,out] access
+     *     This is where to add the names of the tables.
+     */
+    void FindTablesRead(
+        const std::vector< Token >& tokens,
+        Access& access
+    ) {
+        for (size_t i = 0; i < tokens.size(); ++i) {
+            if (
+                !tokens[i].name
+                || (
+                    (tokens[i].text != "from")
+                    && (tokens[i].text != "join")
+                )
+            ) {
+                continue;
+            }
+            auto position = i + 1;
+            std::string table;
+            while (
+                (position < tokens.size())
+                && (CLAUSE_KEYWORDS.count(tokens[position].text) == 0)
+                && ReadTableName(tokens, position, table)
+            ) {
+                Access::AddTable(access.tablesRead, table);
+                if (
+                    (position < tokens.size())
+                    && (tokens[position].text == "as")
+                ) {
+                    position += 2;
+                } else if (
+                    (position < tokens.size())
+                    && tokens[position].name
+                    && (CLAUSE_KEYWORDS.count(tokens[position].text) == 0)
+                ) {
+                    ++position;
+                }
+                if (
+                    (position >= tokens.size())
+                    || (tokens[position].text != ",")
+                ) {
+                    break;
+                }
+                ++position;
+            }
+        }
+    }
+
+    /**
+     * This determines which tables a single statement reads and changes.
+     *
+     * @param[in] tokens
+     *     These are the tokens of the statement.
+     *
+     * @return
+     *     A description of which tables the statement reads and changes
+     *     is returned.
+     */
+    Access AnalyzeStatement(const std::vector< Token >& tokens) {
+        Access access;
+        const auto& first = tokens[0].text;
+        if (
+            (first == "select")
+            || (first == "values")
+        ) {
+            FindTablesRead(tokens, access);
+            return access;
+        }
+        access.query = false;
+        if (first == "with") {
+            for (const auto& word: {"insert", "update", "delete", "replace"}) {
+                if (FindWord(tokens, word) < tokens.size()) {
+                    access.changesAll = true;
+                    return access;
+                }
+            }
+            access.query = true;
+            FindTablesRead(tokens, access);
+            return access;
+        }
+        if (TRANSACTION_KEYWORDS.count(first) != 0) {
+            return access;
+        }
+        size_t position = tokens.size();
+        if (
+            (first == "insert")
+            || (first == "replace")
+        ) {
+            position = FindWord(tokens, "into") + 1;
+        } else if (first == "update") {
+            position = 1;
+            if (
+                (position < tokens.size())
+                && (tokens[position].text == "or")
+            ) {
+                position += 2;
+            }
+        } else if (first == "delete") {
+            position = FindWord(tokens, "from") + 1;
+        } else if (
+            (first == "create")
+            || (first == "drop")
+            || (first == "alter")
+        ) {
+            for (size_t i = 1; (i < tokens.size()) && (i < 4); ++i) {
+                if (tokens[i].text == "table") {
+                    position = i + 1;
+                    break;
+                }
+            }
+            for (const auto& word: {"if", "not", "exists"}) {
+                if (
+                    (position < tokens.size())
+                    && (tokens[position].text == word)
+                ) {
+                    ++position;
+                }
+            }
+        }
+        std::string table;
+        if (ReadTableName(tokens, position, table)) {
+            access.tablesChanged.push_back(table);
+        } else {
+            access.changesAll = true;
+        }
+        return access;
+    }
+
+    /**
+     * This determines which tables the statements in the given SQL text
+     * read and change.
+     *
+     * @param[in] text
+     *     This is the SQL text to analyze.
+     *
+     * @return
+     *     A description of which tables the statements read and change
+     *     is returned.
+     */
+    Access Analyze(const std::string& text) {
+        Access access;
+        const auto tokens = Tokenize(text);
+        std::vector< Token > statement;
+        for (size_t i = 0; i <= tokens.size(); ++i) {
+            if (
+                (i < tokens.size())
+                && (tokens[i].text != ";")
+            ) {
+                statement.push_back(tokens[i]);
+                continue;
+            }
+            if (!statement.empty()) {
+                access.Add(AnalyzeStatement(statement));
+                statement.clear();
+            }
+        }
+        return access;
+    }
+
+    /**
+     * This returns the approximate number of bytes of memory used
+     * by the given value.
+     *
+     * @param[in] value
+     *     This is the value to measure.
+     *
+     * @return
+     *     The approximate number of bytes of memory used by the value
+     *     is returned.
+     */
+    size_t GetMemoryUsed(const Value& value) {
+        size_t size = sizeof(Value);
+        switch (value.GetType()) {
+            case Value::Type::Text:
+            case Value::Type::Error: {
+                size += strlen((const char*)value);
+            } break;
+
+            case Value::Type::Blob: {
+                size += ((BlobView)value).size;
+            } break;
+
+            default: break;
+        }
+        return size;
+    }
+
+    /**
+     * This holds the rows fetched by one query.
+     */
+    struct Entry {
+        /**
+         * This is made up of the SQL text of the query, followed by
+         * the type and value of each of its parameters.
+         */
+        CompositeKey key;
+
+        /**
+         * These are the names of the tables read by the query.
+         */
+        std::vector< std::string > tables;
+
+        /**
+         * These are the index and type of each column fetched.
+         * Each row holds the values of these columns, in this order.
+         */
+        std::vector< std::pair< int, Value::Type > > columns;
+
+        /**
+         * These are the encoded values of the rows.  A row may leave
+         * off columns at the end, and holds invalid values for any
+         * other columns which weren't fetched for it.
+         */
+        Blob rows;
+
+        /**
+         * These are the offsets in the rows buffer at which each
+         * row ends.
+         */
+        std::vector< size_t > rowEnds;
+
+        /**
+         * This indicates whether the rows are all the rows of the query,
+         * rather than only the first few.
+         */
+        bool complete = false;
+
+        /**
+         * This is the approximate number of bytes of memory used
+         * by the entry.
+         */
+        size_t cost = 0;
+
+        /**
+         * This finds the given column among those fetched.
+         *
+         * @param[in] index
+         *     This is the index of the column.
+         *
+         * @param[in] type
+         *     This is the type with which the column was fetched.
+         *
+         * @return
+         *     The position of the column among those fetched is returned,
+         *     or the number of columns fetched if it isn't among them.
+         */
+        size_t FindColumn(
+            int index,
+            Value::Type type
+        ) const {
+            for (size_t i = 0; i < columns.size(); ++i) {
+                if (
+                    (columns[i].first == index)
+                    && (columns[i].second == type)
+                ) {
+                    return i;
+                }
+            }
+            return columns.size();
+        }
+    };
+
+    /**
+     * This is used to look up entries by key without copying the key.
+     */
+    struct KeyPointerHash {
+        size_t operator()(const CompositeKey* key) const {
+            return key->Hash();
+        }
+    };
+
+    /**
+     * This is used to look up entries by key without copying the key.
+     */
+    struct KeyPointerEqual {
+        bool operator()(
+            const CompositeKey* lhs,
+            const CompositeKey* rhs
+        ) const {
+            return *lhs == *rhs;
+        }
+    };
+
+    /**
+     * This holds the results of queries, along with the statistics
+     * about how they're used.  It may be used by several threads at once.
+     */
+    class ResultCache {
+        // Lifecycle
+    public:
+        explicit ResultCache(size_t budget)
+            : budget_(budget)
+        {
+        }
+
+        // Methods
+    public:
+        /**
+         * This returns the memory budget of the cache.
+         *
+         * @return
+         *     The approximate number of bytes of memory which the
+         *     cached results may use is returned.
+         */
+        size_t GetBudget() {
+            std::lock_guard< decltype(mutex_) > lock(mutex_);
+            return budget_;
+        }
+
+        /**
+         * This changes the memory budget of the cache, discarding
+         * results as needed.
+         *
+         * @param[in] budget
+         *     This is the approximate number of bytes of memory which
+         *     the cached results may use.
+         */
+        void SetBudget(size_t budget) {
+            std::lock_guard< decltype(mutex_) > lock(mutex_);
+            budget_ = budget;
+            Evict();
+        }
+
+        /**
+         * This looks up the results of the query with the given key,
+         * counting a hit or miss.
+         *
+         * @param[in] key
+         *     This is the key of the query whose results to find.
+         *
+         * @return
+         *     The results of the query are returned, or null if they
+         *     aren't in the cache.
+         */
+        std::shared_ptr< const Entry > Find(const CompositeKey& key) {
+            std::lock_guard< decltype(mutex_) > lock(mutex_);
+            const auto entry = entries_.find(&key);
+            if (entry == entries_.end()) {
+                ++statistics_.misses;
+                return nullptr;
+            }
+            ++statistics_.hits;
+            lru_.splice(lru_.begin(), lru_, entry->second);
+            return *entry->second;
+        }
+
+        /**
+         * This returns the generations of the given tables, which are
+         * compared when results are stored, to find out whether any of
+         * the tables were changed while the query was running.
+         *
+         * @param[in] tables
+         *     These are the names of the tables read by the query.
+         *
+         * @return
+         *     The generations of the tables are returned.
+         */
+        std::vector< uint64_t > GetGenerations(const std::vector< std::string >& tables) {
+            std::lock_guard< decltype(mutex_) > lock(mutex_);
+            return GetGenerationsLocked(tables);
+        }
+
+        /**
+         * This adds the results of a query to the cache, replacing any
+         * results already there for the same query, unless any of the
+         * tables read by the query were changed while it was running.
+         *
+         * @param[in] entry
+         *     These are the results of the query.
+         *
+         * @param[in] generations
+         *     These are the generations of the tables read by the query,
+         *     from before it started running.
+         */
+        void Store(
+            std::shared_ptr< Entry > entry,
+            const std::vector< uint64_t >& generations
+        ) {
+            std::lock_guard< decltype(mutex_) > lock(mutex_);
+            if (
+                (entry->cost > budget_)
+                || (GetGenerationsLocked(entry->tables) != generations)
+            ) {
+                return;
+            }
+            const auto existing = entries_.find(&entry->key);
+            if (existing != entries_.end()) {
+                RemoveLocked(existing->second->get());
+            }
+            lru_.push_front(entry);
+            entries_[&entry->key] = lru_.begin();
+            for (const auto& table: entry->tables) {
+                (void)tableEntries_[table].insert(entry.get());
+            }
+            statistics_.bytes += entry->cost;
+            ++statistics_.entries;
+            ++statistics_.stores;
+            Evict();
+        }
+
+        /**
+         * This discards the given results, if they're still in the cache.
+         *
+         * @param[in] entry
+         *     These are the results to discard.
+         */
+        void Remove(const Entry* entry) {
+            std::lock_guard< decltype(mutex_) > lock(mutex_);
+            const auto existing = entries_.find(&entry->key);
+            if (
+                (existing != entries_.end())
+                && (existing->second->get() == entry)
+            ) {
+                RemoveLocked(entry);
+            }
+        }
+
+        /**
+         * This discards the results of queries which read tables changed
+         * by a statement.
+         *
+         * @param[in] access
+         *     This describes which tables the statement changed.
+         */
+        void Invalidate(const Access& access) {
+            if (access.changesAll) {
+                RemoveAll(true);
+                return;
+            }
+            if (access.tablesChanged.empty()) {
+                return;
+            }
+            std::lock_guard< decltype(mutex_) > lock(mutex_);
+            for (const auto& table: access.tablesChanged) {
+                ++tableGenerations_[table];
+                const auto tableEntries = tableEntries_.find(table);
+                if (tableEntries == tableEntries_.end()) {
+                    continue;
+                }
+                const auto doomed = std::move(tableEntries->second);
+                tableEntries_.erase(tableEntries);
+                for (const auto entry: doomed) {
+                    RemoveLocked(entry);
+                    ++statistics_.invalidations;
+                }
+            }
+        }
+
+        /**
+         * This discards all results.
+         *
+         * @param[in] invalidate
+         *     This indicates whether to count the results discarded
+         *     as invalidations.
+         */
+        void RemoveAll(bool invalidate) {
+            std::lock_guard< decltype(mutex_) > lock(mutex_);
+            ++allGeneration_;
+            if (invalidate) {
+                statistics_.invalidations += statistics_.entries;
+            }
+            entries_.clear();
+            lru_.clear();
+            tableEntries_.clear();
+            statistics_.entries = 0;
+            statistics_.bytes = 0;
+        }
+
+        /**
+         * This returns a copy of the statistics kept by the cache.
+         *
+         * @return
+         *     A copy of the statistics kept by the cache is returned.
+         */
+        ResultCacheStatistics GetStatistics() {
+            std::lock_guard< decltype(mutex_) > lock(mutex_);
+            return statistics_;
+        }
+
+        // Private Methods
+    private:
+        /**
+         * This returns the generations of the given tables.
+         * The mutex must be held.
+         *
+         * @param[in] tables
+         *     These are the names of the tables.
+         *
+         * @return
+         *     The generation of the whole cache, followed by the
+         *     generations of the tables, is returned.
+         */
+        std::vector< uint64_t > GetGenerationsLocked(const std::vector< std::string >& tables) {
+            std::vector< uint64_t > generations;
+            generations.reserve(tables.size() + 1);
+            generations.push_back(allGeneration_);
+            for (const auto& table: tables) {
+                const auto generation = tableGenerations_.find(table);
+                generations.push_back(
+                    (generation == tableGenerations_.end())
+                    ? 0
+                    : generation->second
+                );
+            }
+            return generations;
+        }
+
+        /**
+         * This discards the given results, which must be in the cache.
+         * The mutex must be held.
+         *
+         * @param[in] entry
+         *     These are the results to discard.
+         */
+        void RemoveLocked(const Entry* entry) {
+            for (const auto& table: entry->tables) {
+                const auto tableEntries = tableEntries_.find(table);
+                if (tableEntries != tableEntries_.end()) {
+                    (void)tableEntries->second.erase(entry);
+                    if (tableEntries->second.empty()) {
+                        tableEntries_.erase(tableEntries);
+                    }
+                }
+            }
+            statistics_.bytes -= entry->cost;
+            --statistics_.entries;
+            const auto existing = entries_.find(&entry->key);
+            const auto position = existing->second;
+            entries_.erase(existing);
+            lru_.erase(position);
+        }
+
+        /**
+         * This discards the least recently used results until the rest
+         * fit within the memory budget.  The mutex must be held.
+         */
+        void Evict() {
+            while (statistics_.bytes > budget_) {
+                RemoveLocked(lru_.back().get());
+                ++statistics_.evictions;
+            }
+        }
+
+        // Private Properties
+    private:
+        /**
+         * This is the type of list used to keep results in order
+         * from most to least recently used.
+         */
+        using Lru = std::list< std::shared_ptr< const Entry > >;
+
+        /**
+         * This is used to synchronize access to the cache.
+         */
+        std::mutex mutex_;
+
+        /**
+         * This is the approximate number of bytes of memory which
+         * the cached results may use.
+         */
+        size_t budget_;
+
+        /**
+         * These are the cached results, in order from most to least
+         * recently used.
+         */
+        Lru lru_;
+
+        /**
+         * These are the cached results, by key.
+         */
+        std::unordered_map<
+            const CompositeKey*,
+            Lru::iterator,
+            KeyPointerHash,
+            KeyPointerEqual
+        > entries_;
+
+        /**
+         * These are the cached results, by the tables they read.
+         */
+        std::unordered_map<
+            std::string,
+            std::unordered_set< const Entry* >
+        > tableEntries_;
+
+        /**
+         * This counts how many times each table has been changed.
+         */
+        std::unordered_map< std::string, uint64_t > tableGenerations_;
+
+        /**
+         * This counts how many times all tables have been changed
+         * at once.
+         */
+        uint64_t allGeneration_ = 0;
+
+        /**
+         * These are the statistics kept by the cache.
+         */
+        ResultCacheStatistics statistics_;
+    };
+
+    /**
+     * This is a query statement which answers from the cache
+     * when it can, and adds to the cache when it can't.
+     */
+    class CachingStatement
+        : public PreparedStatement
+        , public std::enable_shared_from_this< CachingStatement >
+    {
+        // Lifecycle
+    public:
+        ~CachingStatement() noexcept {
+            StoreRecording();
+        }
+
+        CachingStatement(
+            std::shared_ptr< PreparedStatement > statement,
+            std::shared_ptr< ResultCache > cache,
+            const std::string& text,
+            std::vector< std::string > tables
+        )
+            : statement_(statement)
+            , cache_(cache)
+            , text_(text)
+            , tables_(std::move(tables))
+        {
+            text_.Share();
+        }
+
+        // PreparedStatement
+    public:
+        virtual void BindParameter(
+            int index,
+            const Value& value
+        ) override {
+            RememberParameter(index, value);
+            statement_->BindParameter(index, value);
+        }
+
+        virtual void BindParameter(
+            int index,
+            Value&& value
+        ) override {
+            RememberParameter(index, value);
+            statement_->BindParameter(index, std::move(value));
+        }
+
+        virtual void BindParameters(std::initializer_list< const Value > values) override {
+            int index = 1;
+            for (const auto& value: values) {
+                BindParameter(index++, value);
+            }
+        }
+
+        virtual void BindParameters(std::vector< Value >&& values) override {
+            int index = 1;
+            for (auto& value: values) {
+                BindParameter(index++, std::move(value));
+            }
+        }
+
+        virtual Value FetchColumn(int index, Value::Type type) override {
+            Value value;
+            FetchColumn(index, type, value);
+            return value;
+        }
+
+        virtual void FetchColumn(
+            int index,
+            Value::Type type,
+            Value& value
+        ) override {
+            if (mode_ == Mode::Cached) {
+                if (!hasRow_) {
+                    value = Value();
+                    return;
+                }
+                const auto column = entry_->FindColumn(index, type);
+                if (
+                    (column < rowValues_.size())
+                    && (rowValues_[column].GetType() != Value::Type::Invalid)
+                ) {
+                    value = rowValues_[column];
+                    return;
+                }
+                cache_->Remove(entry_.get());
+                StepStatementResults results;
+                if (!CatchUp(rowsStepped_, results)) {
+                    value = Value();
+                    return;
+                }
+            }
+            statement_->FetchColumn(index, type, value);
+            if (rowOpen_) {
+                Record(index, type, value);
+            }
+        }
+
+        virtual void Reset() override {
+            FinishExecution();
+            statement_->Reset();
+        }
+
+        virtual StepStatementResults Step() override {
+            StepStatementResults results;
+            if (StepCached(results)) {
+                return results;
+            }
+            FlushRow();
+            results = statement_->Step();
+            EndLiveStep(results);
+            return results;
+        }
+
+        virtual void StepAsync(StepStatementCallback callback) override {
+            StepStatementResults results;
+            if (StepCached(results)) {
+                callback(results);
+                return;
+            }
+            FlushRow();
+            const auto self = shared_from_this();
+            statement_->StepAsync(
+                [self, callback](const StepStatementResults& results){
+                    self->EndLiveStep(results);
+                    callback(results);
+                }
+            );
+        }
+
+        // Private Methods
+    private:
+        /**
+         * This finishes any execution of the statement in progress,
+         * and remembers the value bound to the given parameter, so that
+         * it can become part of the key of the results.
+         *
+         * @param[in] index
+         *     This is the one-based index of the parameter.
+         *
+         * @param[in] value
+         *     This is the value bound to the parameter.
+         */
+        void RememberParameter(
+            int index,
+            const Value& value
+        ) {
+            FinishExecution();
+            if (index >= 1) {
+                if ((size_t)index > parameters_.size()) {
+                    parameters_.resize(index);
+                }
+                auto& parameter = parameters_[index - 1];
+                parameter = value;
+                parameter.Own();
+            }
+        }
+
+        /**
+         * This makes the key of the results of the query with
+         * the parameters currently bound.
+         *
+         * @return
+         *     The key of the results of the query is returned.
+         */
+        CompositeKey MakeKey() const {
+            std::vector< Value > values;
+            values.reserve(1 + parameters_.size() * 2);
+            values.push_back(text_);
+            for (const auto& parameter: parameters_) {
+                values.emplace_back((intmax_t)parameter.GetType());
+                values.push_back(parameter);
+            }
+            return CompositeKey(std::move(values));
+        }
+
+        /**
+         * This steps the statement using the cached results, looking them
+         * up first if this is the first step since the statement was
+         * reset.
+         *
+         * @param[out] results
+         *     This is where to store the results of the step.
+         *
+         * @return
+         *     An indication of whether or not the step was done is
+         *     returned.  If not, the statement must be stepped for real.
+         */
+        bool StepCached(StepStatementResults& results) {
+            if (mode_ == Mode::Idle) {
+                auto key = MakeKey();
+                entry_ = cache_->Find(key);
+                if (entry_ == nullptr) {
+                    mode_ = Mode::Live;
+                    recording_ = std::make_shared< Entry >();
+                    recording_->key = std::move(key);
+                    recording_->tables = tables_;
+                    generations_ = cache_->GetGenerations(tables_);
+                    return false;
+                }
+                mode_ = Mode::Cached;
+            }
+            if (mode_ != Mode::Cached) {
+                return false;
+            }
+            if (rowsStepped_ < entry_->rowEnds.size()) {
+                DecodeRow(rowsStepped_++);
+                hasRow_ = true;
+                return true;
+            }
+            if (entry_->complete) {
+                hasRow_ = false;
+                results.done = true;
+                return true;
+            }
+            return !CatchUp(rowsStepped_, results);
+        }
+
+        /**
+         * This stops using the cached results, and steps the statement
+         * for real until it's caught up to where it was.
+         *
+         * @param[in] rows
+         *     This is the number of rows to step.
+         *
+         * @param[out] results
+         *     This is where to store the results of the last step
+         *     if the statement couldn't be caught up.
+         *
+         * @return
+         *     An indication of whether or not the statement was caught
+         *     up is returned.
+         */
+        bool CatchUp(
+            size_t rows,
+            StepStatementResults& results
+        ) {
+            mode_ = Mode::Live;
+            entry_.reset();
+            statement_->Reset();
+            for (size_t i = 0; i < rows; ++i) {
+                results = statement_->Step();
+                if (
+                    results.done
+                    || !results.error.empty()
+                ) {
+                    hasRow_ = false;
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        /**
+         * This updates the state of the statement after stepping it
+         * for real, and finishes recording the results if there are
+         * no more rows.
+         *
+         * @param[in] results
+         *     These are the results of the step.
+         */
+        void EndLiveStep(const StepStatementResults& results) {
+            if (!results.error.empty()) {
+                recording_.reset();
+                hasRow_ = false;
+            } else if (results.done) {
+                hasRow_ = false;
+                if (recording_ != nullptr) {
+                    recording_->complete = true;
+                    StoreRecording();
+                }
+            } else {
+                ++rowsStepped_;
+                hasRow_ = true;
+                rowOpen_ = (recording_ != nullptr);
+            }
+        }
+
+        /**
+         * This decodes one of the cached rows.
+         *
+         * @param[in] row
+         *     This is the index of the row to decode.
+         */
+        void DecodeRow(size_t row) {
+            for (auto& value: rowValues_) {
+                value = Value();
+            }
+            arena_.Reset();
+            const auto start = ((row == 0) ? 0 : entry_->rowEnds[row - 1]);
+            const auto end = entry_->rowEnds[row];
+            rowValues_.resize(entry_->columns.size());
+            ValueDecoder decoder(BlobView(entry_->rows.data() + start, end - start));
+            for (auto& value: rowValues_) {
+                if (
+                    decoder.AtEnd()
+                    || !decoder.Decode(value, arena_).empty()
+                ) {
+                    break;
+                }
+            }
+        }
+
+        /**
+         * This remembers a value fetched from the current row.
+         *
+         * @param[in] index
+         *     This is the index of the column fetched.
+         *
+         * @param[in] type
+         *     This is the type with which the column was fetched.
+         *
+         * @param[in] value
+         *     This is the value fetched.
+         */
+        void Record(
+            int index,
+            Value::Type type,
+            const Value& value
+        ) {
+            auto& columns = recording_->columns;
+            const auto column = recording_->FindColumn(index, type);
+            if (column == columns.size()) {
+                columns.emplace_back(index, type);
+            }
+            if (column >= pendingRow_.size()) {
+                pendingRow_.resize(column + 1);
+            }
+            pendingRow_[column].Assign(value, pendingArena_);
+        }
+
+        /**
+         * This encodes the values fetched from the current row, if the
+         * results are being recorded, and gives up recording if the
+         * results have grown too large to cache.
+         */
+        void FlushRow() {
+            if (!rowOpen_) {
+                return;
+            }
+            rowOpen_ = false;
+            auto& rows = recording_->rows;
+            auto fetched = pendingRow_.size();
+            while (
+                (fetched > 0)
+                && (pendingRow_[fetched - 1].GetType() == Value::Type::Invalid)
+            ) {
+                --fetched;
+            }
+            for (size_t i = 0; i < fetched; ++i) {
+                EncodeValue(pendingRow_[i], rows);
+                pendingRow_[i] = Value();
+            }
+            pendingArena_.Reset();
+            recording_->rowEnds.push_back(rows.size());
+            if (rows.size() > cache_->GetBudget()) {
+                recording_.reset();
+            }
+        }
+
+        /**
+         * This adds the results recorded so far to the cache,
+         * if there are any.
+         */
+        void StoreRecording() {
+            FlushRow();
+            if (recording_ == nullptr) {
+                return;
+            }
+            const auto entry = std::move(recording_);
+            recording_.reset();
+            if (
+                entry->rowEnds.empty()
+                && !entry->complete
+            ) {
+                return;
+            }
+            entry->rows.shrink_to_fit();
+            entry->cost = (
+                ENTRY_OVERHEAD
+                + entry->rows.size()
+                + entry->rowEnds.size() * sizeof(size_t)
+                + entry->columns.size() * sizeof(entry->columns[0])
+            );
+            for (const auto& value: entry->key.GetValues()) {
+                entry->cost += GetMemoryUsed(value);
+            }
+            for (const auto& table: entry->tables) {
+                entry->cost += sizeof(table) + table.length();
+            }
+            cache_->Store(entry, generations_);
+        }
+
+        /**
+         * This stores any results recorded and gets the statement ready
+         * for the next time it's stepped.
+         */
+        void FinishExecution() {
+            StoreRecording();
+            mode_ = Mode::Idle;
+            entry_.reset();
+            rowsStepped_ = 0;
+            hasRow_ = false;
+        }
+
+        // Private Properties
+    private:
+        /**
+         * These are the ways the statement can be answering the query.
+         */
+        enum class Mode {
+            /**
+             * The statement hasn't been stepped since it was reset.
+             */
+            Idle,
+
+            /**
+             * The statement is handing out cached results.
+             */
+            Cached,
+
+            /**
+             * The statement is running the query for real.
+             */
+            Live,
+        };
+
+        /**
+         * This is the statement being wrapped.
+         */
+        std::shared_ptr< PreparedStatement > statement_;
+
+        /**
+         * This is the cache used by the statement.
+         */
+        std::shared_ptr< ResultCache > cache_;
+
+        /**
+         * This is the SQL text of the statement, shared with the keys
+         * of all the results cached for the statement.
+         */
+        Value text_;
+
+        /**
+         * These are the names of the tables read by the statement.
+         */
+        std::vector< std::string > tables_;
+
+        /**
+         * These are the values bound to the parameters of the statement.
+         */
+        std::vector< Value > parameters_;
+
+        /**
+         * This indicates how the statement is answering the query.
+         */
+        Mode mode_ = Mode::Idle;
+
+        /**
+         * This is the number of rows stepped since the statement
+         * was reset.
+         */
+        size_t rowsStepped_ = 0;
+
+        /**
+         * This indicates whether the statement is on a row.
+         */
+        bool hasRow_ = false;
+
+        /**
+         * These are the cached results being handed out, if any.
+         */
+        std::shared_ptr< const Entry > entry_;
+
+        /**
+         * These are the values of the current row of the cached results,
+         * in the order of the columns of the results.
+         */
+        std::vector< Value > rowValues_;
+
+        /**
+         * This holds the text of the values of the current row of the
+         * cached results.
+         */
+        Arena arena_;
+
+        /**
+         * These are the results being recorded, if any.
+         */
+        std::shared_ptr< Entry > recording_;
+
+        /**
+         * These are the generations of the tables read by the statement
+         * from when recording started.
+         */
+        std::vector< uint64_t > generations_;
+
+        /**
+         * This indicates whether values fetched from the current row
+         * are being recorded.
+         */
+        bool rowOpen_ = false;
+
+        /**
+         * These are the values fetched from the current row,
+         * in the order of the columns of the results being recorded.
+         */
+        std::vector< Value > pendingRow_;
+
+        /**
+         * This holds the text and blobs of the values fetched
+         * from the current row.
+         */
+        Arena pendingArena_;
+    };
+
+    /**
+     * This is a statement which changes tables, and so discards cached
+     * results of queries of those tables whenever it's stepped.
+     */
+    class InvalidatingStatement
+        : public PreparedStatement
+    {
+        // Lifecycle
+    public:
+        InvalidatingStatement(
+            std::shared_ptr< PreparedStatement > statement,
+            std::shared_ptr< ResultCache > cache,
+            Access access
+        )
+            : statement_(statement)
+            , cache_(cache)
+            , access_(std::move(access))
+        {
+        }
+
+        // PreparedStatement
+    public:
+        virtual void BindParameter(
+            int index,
+            const Value& value
+        ) override {
+            statement_->BindParameter(index, value);
+        }
+
+        virtual void BindParameter(
+            int index,
+            Value&& value
+        ) override {
+            statement_->BindParameter(index, std::move(value));
+        }
+
+        virtual void BindParameters(std::initializer_list< const Value > values) override {
+            statement_->BindParameters(values);
+        }
+
+        virtual void BindParameters(std::vector< Value >&& values) override {
+            statement_->BindParameters(std::move(values));
+        }
+
+        virtual Value FetchColumn(int index, Value::Type type) override {
+            return statement_->FetchColumn(index, type);
+        }
+
+        virtual void FetchColumn(
+            int index,
+            Value::Type type,
+            Value& value
+        ) override {
+            statement_->FetchColumn(index, type, value);
+        }
+
+        virtual void Reset() override {
+            statement_->Reset();
+        }
+
+        virtual StepStatementResults Step() override {
+            const auto results = statement_->Step();
+            cache_->Invalidate(access_);
+            return results;
+        }
+
+        virtual StepStatementResults StepBatch(
+            size_t maxRows,
+            RowBatch& batch
+        ) override {
+            const auto results = statement_->StepBatch(maxRows, batch);
+            cache_->Invalidate(access_);
+            return results;
+        }
+
+        virtual void StepAsync(StepStatementCallback callback) override {
+            const auto cache = cache_;
+            const auto access = access_;
+            statement_->StepAsync(
+                [cache, access, callback](const StepStatementResults& results){
+                    cache->Invalidate(access);
+                    callback(results);
+                }
+            );
+        }
+
+        // Private Properties
+    private:
+        /**
+         * This is the statement being wrapped.
+         */
+        std::shared_ptr< PreparedStatement > statement_;
+
+        /**
+         * This is the cache whose results to discard.
+         */
+        std::shared_ptr< ResultCache > cache_;
+
+        /**
+         * This describes which tables the statement changes.
+         */
+        Access access_;
+    };
+
+    /**
+     * This is a snapshot writer which discards all cached results
+     * once the snapshot it's given is installed.
+     */
+    class InvalidatingSnapshotWriter
+        : public SnapshotWriter
+    {
+        // Lifecycle
+    public:
+        InvalidatingSnapshotWriter(
+            std::shared_ptr< SnapshotWriter > writer,
+            std::shared_ptr< ResultCache > cache
+        )
+            : writer_(writer)
+            , cache_(cache)
+        {
+        }
+
+        // SnapshotWriter
+    public:
+        virtual std::string WriteChunk(BlobView chunk) override {
+            return writer_->WriteChunk(chunk);
+        }
+
+        virtual std::string Finish() override {
+            const auto error = writer_->Finish();
+            cache_->RemoveAll(true);
+            return error;
+        }
+
+        // Private Properties
+    private:
+        /**
+         * This is the writer being wrapped.
+         */
+        std::shared_ptr< SnapshotWriter > writer_;
+
+        /**
+         * This is the cache whose results to discard.
+         */
+        std::shared_ptr< ResultCache > cache_;
+    };
+
+    /**
+     * This wraps a statement built by the wrapped database so that
+     * it works with the cache.
+     *
+     * @param[in] statement
+     *     This is the statement to wrap.
+     *
+     * @param[in] cache
+     *     This is the cache to use.
+     *
+     * @param[in] text
+     *     This is the SQL text of the statement.
+     *
+     * @param[in] access
+     *     This describes which tables the statement reads and changes.
+     *
+     * @return
+     *     The wrapped statement is returned.
+     */
+    std::shared_ptr< PreparedStatement > WrapStatement(
+        std::shared_ptr< PreparedStatement > statement,
+        std::shared_ptr< ResultCache > cache,
+        const std::string& text,
+        Access access
+    ) {
+        if (access.query) {
+            return std::make_shared< CachingStatement >(
+                statement,
+                cache,
+                text,
+                std::move(access.tablesRead)
+            );
+        } else if (
+            access.changesAll
+            || !access.tablesChanged.empty()
+        ) {
+            return std::make_shared< InvalidatingStatement >(
+                statement,
+                cache,
+                std::move(access)
+            );
+        } else {
+            return statement;
+        }
+    }
+
+    /**
+     * This determines which tables the statements in the given
+     * write batch change.
+     *
+     * @param[in] batch
+     *     This is the batch to analyze.
+     *
+     * @return
+     *     A description of which tables the batch changes is returned.
+     */
+    Access Analyze(const WriteBatch& batch) {
+        Access access;
+        for (size_t i = 0; i < batch.GetSize(); ++i) {
+            access.Add(Analyze(batch.GetStatement(i)));
+        }
+        return access;
+    }
+
+}
+
+namespace DatabaseAbstractions {
+
+    double ResultCacheStatistics::GetHitRatio() const {
+        const auto lookups = hits + misses;
+        if (lookups == 0) {
+            return 0.0;
+        }
+        return (double)hits / (double)lookups;
+    }
+
+    struct CachingDatabase::Impl {
+        // Properties
+
+        /**
+         * This is the database being wrapped.
+         */
+        std::shared_ptr< Database > database;
+
+        /**
+         * This holds the results of queries.
+         */
+        std::shared_ptr< ResultCache > cache;
+    };
+
+    CachingDatabase::~CachingDatabase() noexcept = default;
+    CachingDatabase::CachingDatabase(CachingDatabase&&) noexcept = default;
+    CachingDatabase& CachingDatabase::operator=(CachingDatabase&&) noexcept = default;
+
+    CachingDatabase::CachingDatabase(
+        std::shared_ptr< Database > database,
+        size_t memoryBudget
+    )
+        : impl_(new Impl())
+    {
+        impl_->database = database;
+        impl_->cache = std::make_shared< ResultCache >(memoryBudget);
+    }
+
+    void CachingDatabase::SetMemoryBudget(size_t memoryBudget) {
+        impl_->cache->SetBudget(memoryBudget);
+    }
+
+    void CachingDatabase::Clear() {
+        impl_->cache->RemoveAll(false);
+    }
+
+    ResultCacheStatistics CachingDatabase::GetStatistics() const {
+        return impl_->cache->GetStatistics();
+    }
+
+    BuildStatementResults CachingDatabase::BuildStatement(
+        const std::string& statement
+    ) {
+        auto results = impl_->database->BuildStatement(statement);
+        if (results.statement != nullptr) {
+            results.statement = WrapStatement(
+                results.statement,
+                impl_->cache,
+                statement,
+                Analyze(statement)
+            );
+        }
+        return results;
+    }
+
+    std::string CachingDatabase::ExecuteStatement(const std::string& statement) {
+        const auto error = impl_->database->ExecuteStatement(statement);
+        impl_->cache->Invalidate(Analyze(statement));
+        return error;
+    }
+
+    std::string CachingDatabase::BeginTransaction() {
+        return impl_->database->BeginTransaction();
+    }
+
+    std::string CachingDatabase::CommitTransaction() {
+        return impl_->database->CommitTransaction();
+    }
+
+    std::string CachingDatabase::RollbackTransaction() {
+        const auto error = impl_->database->RollbackTransaction();
+        impl_->cache->RemoveAll(true);
+        return error;
+    }
+
+    std::string CachingDatabase::ApplyWriteBatch(const WriteBatch& batch) {
+        const auto error = impl_->database->ApplyWriteBatch(batch);
+        impl_->cache->Invalidate(Analyze(batch));
+        return error;
+    }
+
+    void CachingDatabase::BuildStatementAsync(
+        const std::string& statement,
+        BuildStatementCallback callback
+    ) {
+        const auto cache = impl_->cache;
+        impl_->database->BuildStatementAsync(
+            statement,
+            [cache, statement, callback](const BuildStatementResults& results){
+                if (results.statement == nullptr) {
+                    callback(results);
+                    return;
+                }
+                BuildStatementResults cachingResults;
+                cachingResults.statement = WrapStatement(
+                    results.statement,
+                    cache,
+                    statement,
+                    Analyze(statement)
+                );
+                callback(cachingResults);
+            }
+        );
+    }
+
+    void CachingDatabase::ExecuteAsync(
+        const std::string& statement,
+        CompletionCallback callback
+    ) {
+        const auto cache = impl_->cache;
+        const auto access = Analyze(statement);
+        impl_->database->ExecuteAsync(
+            statement,
+            [cache, access, callback](const std::string& error){
+                cache->Invalidate(access);
+                callback(error);
+            }
+        );
+    }
+
+    void CachingDatabase::ApplyWriteBatchAsync(
+        WriteBatch&& batch,
+        CompletionCallback callback
+    ) {
+        const auto cache = impl_->cache;
+        const auto access = Analyze(batch);
+        impl_->database->ApplyWriteBatchAsync(
+            std::move(batch),
+            [cache, access, callback](const std::string& error){
+                cache->Invalidate(access);
+                callback(error);
+            }
+        );
+    }
+
+    Blob CachingDatabase::CreateSnapshot() {
+        return impl_->database->CreateSnapshot();
+    }
+
+    std::string CachingDatabase::InstallSnapshot(const Blob& blob) {
+        const auto error = impl_->database->InstallSnapshot(blob);
+        impl_->cache->RemoveAll(true);
+        return error;
+    }
+
+    std::shared_ptr< SnapshotReader > CachingDatabase::CreateSnapshotReader(size_t chunkSize) {
+        return impl_->database->CreateSnapshotReader(chunkSize);
+    }
+
+    std::shared_ptr< SnapshotReader > CachingDatabase::CaptureSnapshot(size_t chunkSize) {
+        return impl_->database->CaptureSnapshot(chunkSize);
+    }
+
+    std::shared_ptr< SnapshotWriter > CachingDatabase::CreateSnapshotWriter() {
+        return std::make_shared< InvalidatingSnapshotWriter >(
+            impl_->database->CreateSnapshotWriter(),
+            impl_->cache
+        );
+    }
+
+    uint64_t CachingDatabase::GetSnapshotId() {
+        return impl_->database->GetSnapshotId();
+    }
+
+    DeltaSnapshot CachingDatabase::CreateDeltaSnapshot(uint64_t baseId) {
+        return impl_->database->CreateDeltaSnapshot(baseId);
+    }
+
+    std::string CachingDatabase::InstallDeltaSnapshot(const DeltaSnapshot& snapshot) {
+        const auto error = impl_->database->InstallDeltaSnapshot(snapshot);
+        impl_->cache->RemoveAll(true);
+        return error;
+    }
+
+}
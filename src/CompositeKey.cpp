@@ -0,0 +1,130 @@
+/**
+ * @file CompositeKey.cpp
+ *
+ * This file contains the implementation
+ * of the DatabaseAbstractions::CompositeKey class.
+ */
+
+#include <algorithm>
+#include <DatabaseAbstractions/CompositeKey.hpp>
+#include <stdint.h>
+#include <utility>
+
+namespace {
+
+    /**
+     * This is the hash of a key with no values.
+     */
+    constexpr uint64_t EMPTY_HASH = 0x243F6A8885A308D3ULL;
+
+}
+
+namespace DatabaseAbstractions {
+
+    CompositeKey::CompositeKey() {
+        Prepare();
+    }
+
+    CompositeKey::CompositeKey(std::initializer_list< Value > values)
+        : values_(values)
+    {
+        Prepare();
+    }
+
+    CompositeKey::CompositeKey(std::vector< Value > values)
+        : values_(std::move(values))
+    {
+        Prepare();
+    }
+
+    size_t CompositeKey::GetSize() const {
+        return values_.size();
+    }
+
+    const std::vector< Value >& CompositeKey::GetValues() const {
+        return values_;
+    }
+
+    size_t CompositeKey::Hash() const {
+        return hash_;
+    }
+
+    int CompositeKey::Compare(const CompositeKey& other) const {
+        const auto size = std::min(values_.size(), other.values_.size());
+        for (size_t i = 0; i < size; ++i) {
+            const auto comparison = values_[i].Compare(other.values_[i]);
+            if (comparison != 0) {
+                return comparison;
+            }
+        }
+        if (values_.size() == other.values_.size()) {
+            return 0;
+        }
+        return (values_.size() < other.values_.size()) ? -1 : 1;
+    }
+
+    const Value& CompositeKey::operator[](size_t index) const {
+        return values_[index];
+    }
+
+    bool CompositeKey::operator==(const CompositeKey& other) const {
+        if (
+            (hash_ != other.hash_)
+            || (values_.size() != other.values_.size())
+        ) {
+            return false;
+        }
+        for (size_t i = 0; i < values_.size(); ++i) {
+            if (values_[i] != other.values_[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool CompositeKey::operator!=(const CompositeKey& other) const {
+        return !(*this == other);
+    }
+
+    bool CompositeKey::operator<(const CompositeKey& other) const {
+        return Compare(other) < 0;
+    }
+
+    bool CompositeKey::operator<=(const CompositeKey& other) const {
+        return Compare(other) <= 0;
+    }
+
+    bool CompositeKey::operator>(const CompositeKey& other) const {
+        return Compare(other) > 0;
+    }
+
+    bool CompositeKey::operator>=(const CompositeKey& other) const {
+        return Compare(other) >= 0;
+    }
+
+    void CompositeKey::Prepare() {
+        uint64_t hash = EMPTY_HASH;
+        for (auto& value: values_) {
+            value.Own();
+            hash ^= (uint64_t)value.Hash();
+            hash = ((hash << 27) | (hash >> 37)) * 0x9E3779B97F4A7C15ULL;
+        }
+        hash ^= (hash >> 32);
+        hash_ = (size_t)hash;
+    }
+
+    void PrintTo(
+        const CompositeKey& key,
+        std::ostream* os
+    ) {
+        *os << "(";
+        for (size_t i = 0; i < key.GetSize(); ++i) {
+            if (i > 0) {
+                *os << ", ";
+            }
+            PrintTo(key[i], os);
+        }
+        *os << ")";
+    }
+
+}
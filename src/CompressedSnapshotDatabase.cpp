@@ -0,0 +1,196 @@
+/**
+ * @file CompressedSnapshotDatabase.cpp
+ *
+ * This file contains the implementation
+ * of the DatabaseAbstractions::CompressedSnapshotDatabase class.
+ */
+
+#include <DatabaseAbstractions/CompressedSnapshotDatabase.hpp>
+
+namespace DatabaseAbstractions {
+
+    struct CompressedSnapshotDatabase::Impl {
+        // Properties
+
+        /**
+         * This is the database being wrapped.
+         */
+        std::shared_ptr< Database > database;
+
+        /**
+         * This is the codec used to compress snapshots.
+         */
+        std::shared_ptr< const SnapshotCodec > codec;
+
+        /**
+         * If not null, this is used to compress and decompress
+         * blocks of snapshots in parallel.
+         */
+        std::shared_ptr< WorkerPool > pool;
+
+        /**
+         * This is the number of bytes of each snapshot to compress
+         * in each block.
+         */
+        size_t blockSize = 0;
+
+        // Methods
+
+        /**
+         * This compresses the given snapshot into a frame.
+         *
+         * @param[in] snapshot
+         *     This is the snapshot to compress.
+         *
+         * @return
+         *     The frame is returned.
+         */
+        Blob Compress(const Blob& snapshot) {
+            return CompressSnapshot(snapshot, *codec, blockSize, pool.get());
+        }
+    };
+
+    CompressedSnapshotDatabase::~CompressedSnapshotDatabase() noexcept = default;
+    CompressedSnapshotDatabase::CompressedSnapshotDatabase(CompressedSnapshotDatabase&&) noexcept = default;
+    CompressedSnapshotDatabase& CompressedSnapshotDatabase::operator=(CompressedSnapshotDatabase&&) noexcept = default;
+
+    CompressedSnapshotDatabase::CompressedSnapshotDatabase(
+        std::shared_ptr< Database > database,
+        std::shared_ptr< const SnapshotCodec > codec,
+        std::shared_ptr< WorkerPool > pool,
+        size_t blockSize
+    )
+        : impl_(new Impl())
+    {
+        impl_->database = database;
+        impl_->codec = (
+            (codec == nullptr)
+            ? GetSnapshotCodec(SNAPSHOT_CODEC_LZ)
+            : codec
+        );
+        impl_->pool = pool;
+        impl_->blockSize = blockSize;
+    }
+
+    BuildStatementResults CompressedSnapshotDatabase::BuildStatement(
+        const std::string& statement
+    ) {
+        return impl_->database->BuildStatement(statement);
+    }
+
+    std::string CompressedSnapshotDatabase::ExecuteStatement(const std::string& statement) {
+        return impl_->database->ExecuteStatement(statement);
+    }
+
+    std::string CompressedSnapshotDatabase::BeginTransaction() {
+        return impl_->database->BeginTransaction();
+    }
+
+    std::string CompressedSnapshotDatabase::CommitTransaction() {
+        return impl_->database->CommitTransaction();
+    }
+
+    std::string CompressedSnapshotDatabase::RollbackTransaction() {
+        return impl_->database->RollbackTransaction();
+    }
+
+    std::string CompressedSnapshotDatabase::ApplyWriteBatch(const WriteBatch& batch) {
+        return impl_->database->ApplyWriteBatch(batch);
+    }
+
+    void CompressedSnapshotDatabase::BuildStatementAsync(
+        const std::string& statement,
+        BuildStatementCallback callback
+    ) {
+        impl_->database->BuildStatementAsync(statement, callback);
+    }
+
+    void CompressedSnapshotDatabase::ExecuteAsync(
+        const std::string& statement,
+        CompletionCallback callback
+    ) {
+        impl_->database->ExecuteAsync(statement, callback);
+    }
+
+    void CompressedSnapshotDatabase::ApplyWriteBatchAsync(
+        WriteBatch&& batch,
+        CompletionCallback callback
+    ) {
+        impl_->database->ApplyWriteBatchAsync(std::move(batch), callback);
+    }
+
+    Blob CompressedSnapshotDatabase::CreateSnapshot() {
+        return impl_->Compress(impl_->database->CreateSnapshot());
+    }
+
+    std::string CompressedSnapshotDatabase::InstallSnapshot(const Blob& blob) {
+        if (!IsSnapshotFrame(blob)) {
+            return impl_->database->InstallSnapshot(blob);
+        }
+        Blob snapshot;
+        const auto error = DecompressSnapshot(blob, snapshot, impl_->pool.get());
+        if (!error.empty()) {
+            return error;
+        }
+        return impl_->database->InstallSnapshot(snapshot);
+    }
+
+    std::shared_ptr< SnapshotReader > CompressedSnapshotDatabase::CreateSnapshotReader(size_t chunkSize) {
+        return std::make_shared< CompressingSnapshotReader >(
+            impl_->database->CreateSnapshotReader(chunkSize),
+            chunkSize,
+            impl_->codec,
+            impl_->blockSize,
+            impl_->pool
+        );
+    }
+
+    std::shared_ptr< SnapshotReader > CompressedSnapshotDatabase::CaptureSnapshot(size_t chunkSize) {
+        return std::make_shared< CompressingSnapshotReader >(
+            impl_->database->CaptureSnapshot(chunkSize),
+            chunkSize,
+            impl_->codec,
+            impl_->blockSize,
+            impl_->pool
+        );
+    }
+
+    std::shared_ptr< SnapshotWriter > CompressedSnapshotDatabase::CreateSnapshotWriter() {
+        return std::make_shared< DecompressingSnapshotWriter >(
+            impl_->database->CreateSnapshotWriter(),
+            impl_->pool
+        );
+    }
+
+    uint64_t CompressedSnapshotDatabase::GetSnapshotId() {
+        return impl_->database->GetSnapshotId();
+    }
+
+    DeltaSnapshot CompressedSnapshotDatabase::CreateDeltaSnapshot(uint64_t baseId) {
+        auto snapshot = impl_->database->CreateDeltaSnapshot(baseId);
+        if (snapshot.error.empty()) {
+            snapshot.blob = impl_->Compress(snapshot.blob);
+        }
+        return snapshot;
+    }
+
+    std::string CompressedSnapshotDatabase::InstallDeltaSnapshot(const DeltaSnapshot& snapshot) {
+        if (!IsSnapshotFrame(snapshot.blob)) {
+            return impl_->database->InstallDeltaSnapshot(snapshot);
+        }
+        DeltaSnapshot decompressed;
+        decompressed.full = snapshot.full;
+        decompressed.baseId = snapshot.baseId;
+        decompressed.id = snapshot.id;
+        const auto error = DecompressSnapshot(
+            snapshot.blob,
+            decompressed.blob,
+            impl_->pool.get()
+        );
+        if (!error.empty()) {
+            return error;
+        }
+        return impl_->database->InstallDeltaSnapshot(decompressed);
+    }
+
+}
@@ -0,0 +1,712 @@
+/**
+ * @file ConnectionPool.cpp
+ *
+ * This file contains the implementation
+ * of the DatabaseAbstractions::ConnectionPool class.
+ */
+
+#include "TransactionStatements.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <ctype.h>
+#include <DatabaseAbstractions/ConnectionPool.hpp>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace {
+
+    using namespace DatabaseAbstractions;
+
+    /**
+     * This holds the connections of a pool, along with what's needed to
+     * share them.  Statements handed out by the pool keep it alive, so
+     * that they may be released after the pool is gone.
+     */
+    struct Connections {
+        // Properties
+
+        /**
+         * This is used to let only one thread at a time use the writer.
+         */
+        std::mutex writerMutex;
+
+        /**
+         * This is the connection used for everything other than
+         * read-only queries.
+         */
+        std::shared_ptr< Database > writer;
+
+        /**
+         * This is used to synchronize access to the list of free readers,
+         * the transaction flag, and the statistics.
+         */
+        std::mutex mutex;
+
+        /**
+         * This is used to wake threads waiting for a reader when
+         * one is released.
+         */
+        std::condition_variable readerReleased;
+
+        /**
+         * These are the connections used for read-only queries.
+         */
+        std::vector< std::shared_ptr< Database > > readers;
+
+        /**
+         * These are the indexes of the readers not held by any statement.
+         */
+        std::vector< size_t > freeReaders;
+
+        /**
+         * This flag is set while a transaction is open on the writer.
+         */
+        bool inTransaction = false;
+
+        /**
+         * These are the counters describing how busy the pool is.
+         */
+        ConnectionPoolStatistics statistics;
+
+        // Methods
+
+        /**
+         * This takes a reader from the free list, waiting for one to be
+         * released if none are free.
+         *
+         * @return
+         *     The index of the reader taken is returned.
+         */
+        size_t AcquireReader() {
+            std::unique_lock< decltype(mutex) > lock(mutex);
+            if (freeReaders.empty()) {
+                ++statistics.readerWaits;
+                readerReleased.wait(lock, [this]{ return !freeReaders.empty(); });
+            }
+            const auto reader = freeReaders.back();
+            freeReaders.pop_back();
+            ++statistics.readersInUse;
+            statistics.peakReadersInUse = std::max(
+                statistics.peakReadersInUse,
+                statistics.readersInUse
+            );
+            return reader;
+        }
+
+        /**
+         * This returns the given reader to the free list.
+         *
+         * @param[in] reader
+         *     This is the index of the reader to return.
+         */
+        void ReleaseReader(size_t reader) {
+            std::lock_guard< decltype(mutex) > lock(mutex);
+            freeReaders.push_back(reader);
+            --statistics.readersInUse;
+            readerReleased.notify_one();
+        }
+
+        /**
+         * This counts one use of the writer.
+         */
+        void CountWrite() {
+            std::lock_guard< decltype(mutex) > lock(mutex);
+            ++statistics.writes;
+        }
+
+        /**
+         * This sets or clears the flag indicating a transaction is
+         * open on the writer.
+         *
+         * @param[in] open
+         *     This indicates whether or not a transaction is open.
+         */
+        void SetInTransaction(bool open) {
+            std::lock_guard< decltype(mutex) > lock(mutex);
+            inTransaction = open;
+        }
+
+        /**
+         * This updates the flag indicating a transaction is open on the
+         * writer, to account for executing statements on the writer
+         * which begin or end transactions.
+         *
+         * @param[in] statements
+         *     This describes the statements executed.
+         *
+         * @param[in] succeeded
+         *     This indicates whether or not the statements all succeeded.
+         */
+        void TrackTransaction(
+            const TransactionStatements& statements,
+            bool succeeded
+        ) {
+            if (
+                !statements.begins
+                && !statements.ends
+            ) {
+                return;
+            }
+            std::lock_guard< decltype(mutex) > lock(mutex);
+            DatabaseAbstractions::TrackTransaction(statements, succeeded, inTransaction);
+        }
+    };
+
+    /**
+     * This determines whether or not the given SQL text is a read-only
+     * query, which is the case if it starts with SELECT.
+     *
+     * @param[in] statement
+     *     This is the SQL text to check.
+     *
+     * @return
+     *     An indication of whether or not the SQL text is a read-only
+     *     query is returned.
+     */
+    bool IsReadOnly(const std::string& statement) {
+        static const std::string keyword = "select";
+        size_t i = 0;
+        while (
+            (i < statement.length())
+            && (
+                isspace((unsigned char)statement[i])
+                || (statement[i] == '(')
+            )
+        ) {
+            ++i;
+        }
+        if (statement.length() - i < keyword.length()) {
+            return false;
+        }
+        for (size_t j = 0; j < keyword.length(); ++j) {
+            if (tolower((unsigned char)statement[i + j]) != keyword[j]) {
+                return false;
+            }
+        }
+        i += keyword.length();
+        return (
+            (i == statement.length())
+            || (
+                !isalnum((unsigned char)statement[i])
+                && (statement[i] != '_')
+            )
+        );
+    }
+
+    /**
+     * This is a statement built on a reader connection, which holds the
+     * connection until the statement is released.
+     */
+    class ReaderStatement
+        : public PreparedStatement
+    {
+        // Lifecycle
+    public:
+        ~ReaderStatement() noexcept {
+            statement_ = nullptr;
+            connections_->ReleaseReader(reader_);
+        }
+        ReaderStatement(const ReaderStatement&) = delete;
+        ReaderStatement(ReaderStatement&&) = delete;
+        ReaderStatement& operator=(const ReaderStatement&) = delete;
+        ReaderStatement& operator=(ReaderStatement&&) = delete;
+
+        // Construction
+    public:
+        ReaderStatement(
+            std::shared_ptr< PreparedStatement > statement,
+            std::shared_ptr< Connections > connections,
+            size_t reader
+        )
+            : statement_(statement)
+            , connections_(connections)
+            , reader_(reader)
+        {
+        }
+
+        // PreparedStatement
+    public:
+        virtual void BindParameter(
+            int index,
+            const Value& value
+        ) override {
+            statement_->BindParameter(index, value);
+        }
+
+        virtual void BindParameter(
+            int index,
+            Value&& value
+        ) override {
+            statement_->BindParameter(index, std::move(value));
+        }
+
+        virtual void BindParameters(std::initializer_list< const Value > values) override {
+            statement_->BindParameters(values);
+        }
+
+        virtual void BindParameters(std::vector< Value >&& values) override {
+            statement_->BindParameters(std::move(values));
+        }
+
+        virtual Value FetchColumn(int index, Value::Type type) override {
+            return statement_->FetchColumn(index, type);
+        }
+
+        virtual void FetchColumn(
+            int index,
+            Value::Type type,
+            Value& value
+        ) override {
+            statement_->FetchColumn(index, type, value);
+        }
+
+        virtual void Reset() override {
+            statement_->Reset();
+        }
+
+        virtual StepStatementResults Step() override {
+            return statement_->Step();
+        }
+
+        virtual StepStatementResults StepBatch(
+            size_t maxRows,
+            RowBatch& batch
+        ) override {
+            return statement_->StepBatch(maxRows, batch);
+        }
+
+        virtual void StepAsync(StepStatementCallback callback) override {
+            statement_->StepAsync(callback);
+        }
+
+        // Private Properties
+    private:
+        /**
+         * This is the statement built on the reader.
+         */
+        std::shared_ptr< PreparedStatement > statement_;
+
+        /**
+         * These are the connections of the pool.
+         */
+        std::shared_ptr< Connections > connections_;
+
+        /**
+         * This is the index of the reader held by the statement.
+         */
+        size_t reader_;
+    };
+
+    /**
+     * This is a statement built on the writer connection, which takes
+     * its turn with the writer whenever it's used.
+     */
+    class WriterStatement
+        : public PreparedStatement
+    {
+        // Lifecycle
+    public:
+        ~WriterStatement() noexcept {
+            std::lock_guard< decltype(connections_->writerMutex) > lock(connections_->writerMutex);
+            statement_ = nullptr;
+        }
+        WriterStatement(const WriterStatement&) = delete;
+        WriterStatement(WriterStatement&&) = delete;
+        WriterStatement& operator=(const WriterStatement&) = delete;
+        WriterStatement& operator=(WriterStatement&&) = delete;
+
+        // Construction
+    public:
+        WriterStatement(
+            std::shared_ptr< PreparedStatement > statement,
+            std::shared_ptr< Connections > connections,
+            const TransactionStatements& transaction
+        )
+            : statement_(statement)
+            , connections_(connections)
+            , transaction_(transaction)
+        {
+        }
+
+        // PreparedStatement
+    public:
+        virtual void BindParameter(
+            int index,
+            const Value& value
+        ) override {
+            std::lock_guard< decltype(connections_->writerMutex) > lock(connections_->writerMutex);
+            statement_->BindParameter(index, value);
+        }
+
+        virtual void BindParameter(
+            int index,
+            Value&& value
+        ) override {
+            std::lock_guard< decltype(connections_->writerMutex) > lock(connections_->writerMutex);
+            statement_->BindParameter(index, std::move(value));
+        }
+
+        virtual void BindParameters(std::initializer_list< const Value > values) override {
+            std::lock_guard< decltype(connections_->writerMutex) > lock(connections_->writerMutex);
+            statement_->BindParameters(values);
+        }
+
+        virtual void BindParameters(std::vector< Value >&& values) override {
+            std::lock_guard< decltype(connections_->writerMutex) > lock(connections_->writerMutex);
+            statement_->BindParameters(std::move(values));
+        }
+
+        virtual Value FetchColumn(int index, Value::Type type) override {
+            std::lock_guard< decltype(connections_->writerMutex) > lock(connections_->writerMutex);
+            return statement_->FetchColumn(index, type);
+        }
+
+        virtual void FetchColumn(
+            int index,
+            Value::Type type,
+            Value& value
+        ) override {
+            std::lock_guard< decltype(connections_->writerMutex) > lock(connections_->writerMutex);
+            statement_->FetchColumn(index, type, value);
+        }
+
+        virtual void Reset() override {
+            std::lock_guard< decltype(connections_->writerMutex) > lock(connections_->writerMutex);
+            statement_->Reset();
+        }
+
+        virtual StepStatementResults Step() override {
+            std::lock_guard< decltype(connections_->writerMutex) > lock(connections_->writerMutex);
+            const auto results = statement_->Step();
+            connections_->TrackTransaction(transaction_, results.error.empty());
+            return results;
+        }
+
+        virtual StepStatementResults StepBatch(
+            size_t maxRows,
+            RowBatch& batch
+        ) override {
+            std::lock_guard< decltype(connections_->writerMutex) > lock(connections_->writerMutex);
+            const auto results = statement_->StepBatch(maxRows, batch);
+            connections_->TrackTransaction(transaction_, results.error.empty());
+            return results;
+        }
+
+        // Private Properties
+    private:
+        /**
+         * This is the statement built on the writer.
+         */
+        std::shared_ptr< PreparedStatement > statement_;
+
+        /**
+         * These are the connections of the pool.
+         */
+        std::shared_ptr< Connections > connections_;
+
+        /**
+         * This describes whether the statement begins or ends
+         * a transaction.
+         */
+        TransactionStatements transaction_;
+    };
+
+    /**
+     * This is a snapshot reader made by the writer connection, which
+     * takes its turn with the writer whenever it's used.
+     */
+    class WriterSnapshotReader
+        : public SnapshotReader
+    {
+        // Lifecycle
+    public:
+        ~WriterSnapshotReader() noexcept {
+            std::lock_guard< decltype(connections_->writerMutex) > lock(connections_->writerMutex);
+            reader_ = nullptr;
+        }
+
+        // Construction
+    public:
+        WriterSnapshotReader(
+            std::shared_ptr< SnapshotReader > reader,
+            std::shared_ptr< Connections > connections
+        )
+            : reader_(reader)
+            , connections_(connections)
+        {
+        }
+
+        // SnapshotReader
+    public:
+        virtual ReadSnapshotChunkResults ReadChunk(Blob& chunk) override {
+            std::lock_guard< decltype(connections_->writerMutex) > lock(connections_->writerMutex);
+            return reader_->ReadChunk(chunk);
+        }
+
+        // Private Properties
+    private:
+        /**
+         * This is the reader made by the writer connection.
+         */
+        std::shared_ptr< SnapshotReader > reader_;
+
+        /**
+         * These are the connections of the pool.
+         */
+        std::shared_ptr< Connections > connections_;
+    };
+
+    /**
+     * This is a snapshot writer made by the writer connection, which
+     * takes its turn with the writer whenever it's used.
+     */
+    class WriterSnapshotWriter
+        : public SnapshotWriter
+    {
+        // Lifecycle
+    public:
+        ~WriterSnapshotWriter() noexcept {
+            std::lock_guard< decltype(connections_->writerMutex) > lock(connections_->writerMutex);
+            writer_ = nullptr;
+        }
+
+        // Construction
+    public:
+        WriterSnapshotWriter(
+            std::shared_ptr< SnapshotWriter > writer,
+            std::shared_ptr< Connections > connections
+        )
+            : writer_(writer)
+            , connections_(connections)
+        {
+        }
+
+        // SnapshotWriter
+    public:
+        virtual std::string WriteChunk(BlobView chunk) override {
+            std::lock_guard< decltype(connections_->writerMutex) > lock(connections_->writerMutex);
+            return writer_->WriteChunk(chunk);
+        }
+
+        virtual std::string Finish() override {
+            std::lock_guard< decltype(connections_->writerMutex) > lock(connections_->writerMutex);
+            return writer_->Finish();
+        }
+
+        // Private Properties
+    private:
+        /**
+         * This is the writer made by the writer connection.
+         */
+        std::shared_ptr< SnapshotWriter > writer_;
+
+        /**
+         * These are the connections of the pool.
+         */
+        std::shared_ptr< Connections > connections_;
+    };
+
+}
+
+namespace DatabaseAbstractions {
+
+    struct ConnectionPool::Impl {
+        // Properties
+
+        /**
+         * These are the connections of the pool.
+         */
+        std::shared_ptr< Connections > connections = std::make_shared< Connections >();
+
+        // Methods
+
+        /**
+         * This determines whether or not the given SQL text should be
+         * built on a reader connection.
+         *
+         * @param[in] statement
+         *     This is the SQL text to check.
+         *
+         * @return
+         *     An indication of whether or not the SQL text should be
+         *     built on a reader connection is returned.
+         */
+        bool UseReader(const std::string& statement) {
+            if (
+                connections->readers.empty()
+                || !IsReadOnly(statement)
+            ) {
+                return false;
+            }
+            std::lock_guard< decltype(connections->mutex) > lock(connections->mutex);
+            return !connections->inTransaction;
+        }
+    };
+
+    ConnectionPool::~ConnectionPool() noexcept = default;
+    ConnectionPool::ConnectionPool(ConnectionPool&&) noexcept = default;
+    ConnectionPool& ConnectionPool::operator=(ConnectionPool&&) noexcept = default;
+
+    ConnectionPool::ConnectionPool(
+        ConnectionFactory connect,
+        size_t readerCount
+    )
+        : impl_(new Impl())
+    {
+        const auto& connections = impl_->connections;
+        connections->writer = connect();
+        for (size_t i = 0; i < readerCount; ++i) {
+            connections->readers.push_back(connect());
+            connections->freeReaders.push_back(i);
+        }
+        connections->statistics.readers = readerCount;
+    }
+
+    ConnectionPoolStatistics ConnectionPool::GetStatistics() const {
+        const auto& connections = impl_->connections;
+        std::lock_guard< decltype(connections->mutex) > lock(connections->mutex);
+        return connections->statistics;
+    }
+
+    BuildStatementResults ConnectionPool::BuildStatement(
+        const std::string& statement
+    ) {
+        const auto& connections = impl_->connections;
+        BuildStatementResults results;
+        if (impl_->UseReader(statement)) {
+            const auto reader = connections->AcquireReader();
+            results = connections->readers[reader]->BuildStatement(statement);
+            if (results.statement == nullptr) {
+                connections->ReleaseReader(reader);
+            } else {
+                results.statement = std::make_shared< ReaderStatement >(
+                    results.statement,
+                    connections,
+                    reader
+                );
+            }
+            std::lock_guard< decltype(connections->mutex) > lock(connections->mutex);
+            ++connections->statistics.reads;
+        } else {
+            {
+                std::lock_guard< decltype(connections->writerMutex) > lock(connections->writerMutex);
+                results = connections->writer->BuildStatement(statement);
+            }
+            if (results.statement != nullptr) {
+                results.statement = std::make_shared< WriterStatement >(
+                    results.statement,
+                    connections,
+                    FindTransactionStatements(statement)
+                );
+            }
+            connections->CountWrite();
+        }
+        return results;
+    }
+
+    std::string ConnectionPool::ExecuteStatement(const std::string& statement) {
+        const auto& connections = impl_->connections;
+        const auto transaction = FindTransactionStatements(statement);
+        connections->CountWrite();
+        std::lock_guard< decltype(connections->writerMutex) > lock(connections->writerMutex);
+        const auto error = connections->writer->ExecuteStatement(statement);
+        connections->TrackTransaction(transaction, error.empty());
+        return error;
+    }
+
+    std::string ConnectionPool::BeginTransaction() {
+        const auto& connections = impl_->connections;
+        std::lock_guard< decltype(connections->writerMutex) > lock(connections->writerMutex);
+        const auto error = connections->writer->BeginTransaction();
+        if (error.empty()) {
+            connections->SetInTransaction(true);
+        }
+        return error;
+    }
+
+    std::string ConnectionPool::CommitTransaction() {
+        const auto& connections = impl_->connections;
+        std::lock_guard< decltype(connections->writerMutex) > lock(connections->writerMutex);
+        const auto error = connections->writer->CommitTransaction();
+        if (error.empty()) {
+            connections->SetInTransaction(false);
+        }
+        return error;
+    }
+
+    std::string ConnectionPool::RollbackTransaction() {
+        const auto& connections = impl_->connections;
+        std::lock_guard< decltype(connections->writerMutex) > lock(connections->writerMutex);
+        const auto error = connections->writer->RollbackTransaction();
+        if (error.empty()) {
+            connections->SetInTransaction(false);
+        }
+        return error;
+    }
+
+    std::string ConnectionPool::ApplyWriteBatch(const WriteBatch& batch) {
+        const auto& connections = impl_->connections;
+        connections->CountWrite();
+        std::lock_guard< decltype(connections->writerMutex) > lock(connections->writerMutex);
+        return connections->writer->ApplyWriteBatch(batch);
+    }
+
+    Blob ConnectionPool::CreateSnapshot() {
+        const auto& connections = impl_->connections;
+        std::lock_guard< decltype(connections->writerMutex) > lock(connections->writerMutex);
+        return connections->writer->CreateSnapshot();
+    }
+
+    std::string ConnectionPool::InstallSnapshot(const Blob& blob) {
+        const auto& connections = impl_->connections;
+        std::lock_guard< decltype(connections->writerMutex) > lock(connections->writerMutex);
+        return connections->writer->InstallSnapshot(blob);
+    }
+
+    std::shared_ptr< SnapshotReader > ConnectionPool::CreateSnapshotReader(size_t chunkSize) {
+        const auto& connections = impl_->connections;
+        std::shared_ptr< SnapshotReader > reader;
+        {
+            std::lock_guard< decltype(connections->writerMutex) > lock(connections->writerMutex);
+            reader = connections->writer->CreateSnapshotReader(chunkSize);
+        }
+        return std::make_shared< WriterSnapshotReader >(reader, connections);
+    }
+
+    std::shared_ptr< SnapshotReader > ConnectionPool::CaptureSnapshot(size_t chunkSize) {
+        const auto& connections = impl_->connections;
+        std::lock_guard< decltype(connections->writerMutex) > lock(connections->writerMutex);
+        return connections->writer->CaptureSnapshot(chunkSize);
+    }
+
+    std::shared_ptr< SnapshotWriter > ConnectionPool::CreateSnapshotWriter() {
+        const auto& connections = impl_->connections;
+        std::shared_ptr< SnapshotWriter > writer;
+        {
+            std::lock_guard< decltype(connections->writerMutex) > lock(connections->writerMutex);
+            writer = connections->writer->CreateSnapshotWriter();
+        }
+        return std::make_shared< WriterSnapshotWriter >(writer, connections);
+    }
+
+    uint64_t ConnectionPool::GetSnapshotId() {
+        const auto& connections = impl_->connections;
+        std::lock_guard< decltype(connections->writerMutex) > lock(connections->writerMutex);
+        return connections->writer->GetSnapshotId();
+    }
+
+    DeltaSnapshot ConnectionPool::CreateDeltaSnapshot(uint64_t baseId) {
+        const auto& connections = impl_->connections;
+        std::lock_guard< decltype(connections->writerMutex) > lock(connections->writerMutex);
+        return connections->writer->CreateDeltaSnapshot(baseId);
+    }
+
+    std::string ConnectionPool::InstallDeltaSnapshot(const DeltaSnapshot& snapshot) {
+        const auto& connections = impl_->connections;
+        std::lock_guard< decltype(connections->writerMutex) > lock(connections->writerMutex);
+        return connections->writer->InstallDeltaSnapshot(snapshot);
+    }
+
+}
@@ -0,0 +1,279 @@
+/**
+ * @file Crc32c.cpp
+ *
+ * This file contains the implementation of the
+ * DatabaseAbstractions::Crc32c and IsCrc32cAccelerated functions.
+ */
+
+#include <DatabaseAbstractions/Crc32c.hpp>
+#include <string.h>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define CRC32C_X86
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define CRC32C_TARGET
+#else /* GCC or Clang */
+#include <cpuid.h>
+#define CRC32C_TARGET __attribute__((target("sse4.2")))
+#endif /* _MSC_VER / GCC or Clang */
+#include <nmmintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+#define CRC32C_ARM
+#include <arm_acle.h>
+#endif /* x86 / ARM with CRC instructions */
+
+namespace {
+
+    /**
+     * This is the CRC-32C polynomial, in reversed bit order.
+     */
+    constexpr uint32_t POLYNOMIAL = 0x82F63B78;
+
+    /**
+     * This holds the tables used to compute the checksum eight bytes
+     * at a time ("slicing-by-8").
+     */
+    struct Tables {
+        uint32_t entries[8][256];
+
+        Tables() {
+            for (uint32_t i = 0; i < 256; ++i) {
+                uint32_t crc = i;
+                for (int bit = 0; bit < 8; ++bit) {
+                    crc = (crc >> 1) ^ ((crc & 1) ? POLYNOMIAL : 0);
+                }
+                entries[0][i] = crc;
+            }
+            for (uint32_t i = 0; i < 256; ++i) {
+                for (size_t slice = 1; slice < 8; ++slice) {
+                    const auto previous = entries[slice - 1][i];
+                    entries[slice][i] = (previous >> 8) ^ entries[0][previous & 0xFF];
+                }
+            }
+        }
+    };
+
+    /**
+     * This returns the tables used to compute the checksum,
+     * building them the first time they're needed.
+     *
+     * @return
+     *     The tables used to compute the checksum are returned.
+     */
+    const Tables& GetTables() {
+        static const Tables tables;
+        return tables;
+    }
+
+    /**
+     * This updates the checksum state (the checksum with its bits
+     * inverted) with the given data, using lookup tables eight bytes
+     * at a time.  It works on any processor.
+     *
+     * @param[in] bytes
+     *     This points to the data to checksum.
+     *
+     * @param[in] size
+     *     This is the number of bytes of data to checksum.
+     *
+     * @param[in] crc
+     *     This is the checksum state before the data.
+     *
+     * @return
+     *     The checksum state after the data is returned.
+     */
+    uint32_t SoftwareCrc32c(
+        const uint8_t* bytes,
+        size_t size,
+        uint32_t crc
+    ) {
+        const auto& tables = GetTables().entries;
+        while (size >= 8) {
+            const uint32_t low = (
+                ((uint32_t)bytes[0])
+                | ((uint32_t)bytes[1] << 8)
+                | ((uint32_t)bytes[2] << 16)
+                | ((uint32_t)bytes[3] << 24)
+            ) ^ crc;
+            crc = (
+                tables[7][low & 0xFF]
+                ^ tables[6][(low >> 8) & 0xFF]
+                ^ tables[5][(low >> 16) & 0xFF]
+                ^ tables[4][low >> 24]
+                ^ tables[3][bytes[4]]
+                ^ tables[2][bytes[5]]
+                ^ tables[1][bytes[6]]
+                ^ tables[0][bytes[7]]
+            );
+            bytes += 8;
+            size -= 8;
+        }
+        while (size-- > 0) {
+            crc = (crc >> 8) ^ tables[0][(crc ^ *bytes++) & 0xFF];
+        }
+        return crc;
+    }
+
+#if defined(CRC32C_X86)
+
+    /**
+     * This determines whether or not the processor has the SSE 4.2
+     * CRC32 instruction.
+     *
+     * @return
+     *     An indication of whether or not the processor has the SSE 4.2
+     *     CRC32 instruction is returned.
+     */
+    bool DetectHardwareCrc32c() {
+#if defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 1);
+        return ((info[2] & (1 << 20)) != 0);
+#else /* GCC or Clang */
+        unsigned int eax, ebx, ecx, edx;
+        if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+            return false;
+        }
+        return ((ecx & bit_SSE4_2) != 0);
+#endif /* _MSC_VER / GCC or Clang */
+    }
+
+    /**
+     * This updates the checksum state with the given data, using the
+     * SSE 4.2 CRC32 instruction, which the caller must make sure
+     * the processor has.
+     *
+     * @param[in] bytes
+     *     This points to the data to checksum.
+     *
+     * @param[in] size
+     *     This is the number of bytes of data to checksum.
+     *
+     * @param[in] crc
+     *     This is the checksum state before the data.
+     *
+     * @return
+     *     The checksum state after the data is returned.
+     */
+    CRC32C_TARGET uint32_t HardwareCrc32c(
+        const uint8_t* bytes,
+        size_t size,
+        uint32_t crc
+    ) {
+#if defined(__x86_64__) || defined(_M_X64)
+        uint64_t crc64 = crc;
+        while (size >= 8) {
+            uint64_t word;
+            (void)memcpy(&word, bytes, sizeof(word));
+            crc64 = _mm_crc32_u64(crc64, word);
+            bytes += 8;
+            size -= 8;
+        }
+        crc = (uint32_t)crc64;
+#endif /* 64-bit */
+        while (size >= 4) {
+            uint32_t word;
+            (void)memcpy(&word, bytes, sizeof(word));
+            crc = _mm_crc32_u32(crc, word);
+            bytes += 4;
+            size -= 4;
+        }
+        while (size-- > 0) {
+            crc = _mm_crc32_u8(crc, *bytes++);
+        }
+        return crc;
+    }
+
+#elif defined(CRC32C_ARM)
+
+    bool DetectHardwareCrc32c() {
+        return true;
+    }
+
+    /**
+     * This updates the checksum state with the given data, using the
+     * ARMv8 CRC32C instructions.
+     *
+     * @param[in] bytes
+     *     This points to the data to checksum.
+     *
+     * @param[in] size
+     *     This is the number of bytes of data to checksum.
+     *
+     * @param[in] crc
+     *     This is the checksum state before the data.
+     *
+     * @return
+     *     The checksum state after the data is returned.
+     */
+    uint32_t HardwareCrc32c(
+        const uint8_t* bytes,
+        size_t size,
+        uint32_t crc
+    ) {
+        while (size >= 8) {
+            uint64_t word;
+            (void)memcpy(&word, bytes, sizeof(word));
+            crc = __crc32cd(crc, word);
+            bytes += 8;
+            size -= 8;
+        }
+        while (size-- > 0) {
+            crc = __crc32cb(crc, *bytes++);
+        }
+        return crc;
+    }
+
+#else /* no CRC instructions */
+
+    bool DetectHardwareCrc32c() {
+        return false;
+    }
+
+    uint32_t HardwareCrc32c(
+        const uint8_t* bytes,
+        size_t size,
+        uint32_t crc
+    ) {
+        return SoftwareCrc32c(bytes, size, crc);
+    }
+
+#endif /* x86 / ARM / no CRC instructions */
+
+    /**
+     * This returns an indication of whether or not the processor
+     * has instructions which compute the checksum, checking the
+     * first time it's needed.
+     *
+     * @return
+     *     An indication of whether or not the processor has
+     *     instructions which compute the checksum is returned.
+     */
+    bool HasHardwareCrc32c() {
+        static const bool hasHardwareCrc32c = DetectHardwareCrc32c();
+        return hasHardwareCrc32c;
+    }
+
+}
+
+namespace DatabaseAbstractions {
+
+    uint32_t Crc32c(
+        const void* data,
+        size_t size,
+        uint32_t crc
+    ) {
+        const auto bytes = (const uint8_t*)data;
+        if (HasHardwareCrc32c()) {
+            return ~HardwareCrc32c(bytes, size, ~crc);
+        } else {
+            return ~SoftwareCrc32c(bytes, size, ~crc);
+        }
+    }
+
+    bool IsCrc32cAccelerated() {
+        return HasHardwareCrc32c();
+    }
+
+}
@@ -0,0 +1,175 @@
+/**
+ * @file Database.cpp
+ *
+ * This file contains the base implementations of the optional methods
+ * of the DatabaseAbstractions::Database class.
+ */
+
+#include <DatabaseAbstractions/Database.hpp>
+
+namespace {
+
+    using namespace DatabaseAbstractions;
+
+    /**
+     * This is the snapshot writer used for databases which can only
+     * install complete snapshots.  It collects the chunks written to it
+     * and installs the whole snapshot when finished.
+     */
+    class BufferingSnapshotWriter
+        : public SnapshotWriter
+    {
+        // Lifecycle
+    public:
+        BufferingSnapshotWriter(Database& database)
+            : database_(database)
+        {
+        }
+
+        // SnapshotWriter
+    public:
+        virtual std::string WriteChunk(BlobView chunk) override {
+            snapshot_.insert(snapshot_.end(), chunk.data, chunk.data + chunk.size);
+            return "";
+        }
+
+        virtual std::string Finish() override {
+            const auto error = database_.InstallSnapshot(snapshot_);
+            Blob().swap(snapshot_);
+            return error;
+        }
+
+        // Private Properties
+    private:
+        /**
+         * This is the database in which to install the snapshot.
+         */
+        Database& database_;
+
+        /**
+         * This holds the chunks written so far.
+         */
+        Blob snapshot_;
+    };
+
+}
+
+namespace DatabaseAbstractions {
+
+    std::string Database::BeginTransaction() {
+        return ExecuteStatement("BEGIN");
+    }
+
+    std::string Database::CommitTransaction() {
+        return ExecuteStatement("COMMIT");
+    }
+
+    std::string Database::RollbackTransaction() {
+        return ExecuteStatement("ROLLBACK");
+    }
+
+    std::string Database::ApplyWriteBatch(const WriteBatch& batch) {
+        if (batch.GetSize() == 0) {
+            return "";
+        }
+        auto error = BeginTransaction();
+        if (!error.empty()) {
+            return error;
+        }
+        std::shared_ptr< PreparedStatement > statement;
+        const std::string* statementText = nullptr;
+        for (size_t i = 0; i < batch.GetSize(); ++i) {
+            const auto& text = batch.GetStatement(i);
+            if (
+                (statementText == nullptr)
+                || (*statementText != text)
+            ) {
+                auto built = BuildStatement(text);
+                if (!built.error.empty()) {
+                    error = built.error;
+                    break;
+                }
+                statement = std::move(built.statement);
+                statementText = &text;
+            } else {
+                statement->Reset();
+            }
+            const auto& parameters = batch.GetParameters(i);
+            for (size_t j = 0; j < parameters.size(); ++j) {
+                statement->BindParameter((int)j + 1, parameters[j]);
+            }
+            for (;;) {
+                const auto results = statement->Step();
+                if (!results.error.empty()) {
+                    error = results.error;
+                    break;
+                }
+                if (results.done) {
+                    break;
+                }
+            }
+            if (!error.empty()) {
+                break;
+            }
+        }
+        statement = nullptr;
+        if (!error.empty()) {
+            (void)RollbackTransaction();
+            return error;
+        }
+        return CommitTransaction();
+    }
+
+    void Database::BuildStatementAsync(
+        const std::string& statement,
+        BuildStatementCallback callback
+    ) {
+        callback(BuildStatement(statement));
+    }
+
+    void Database::ExecuteAsync(
+        const std::string& statement,
+        CompletionCallback callback
+    ) {
+        callback(ExecuteStatement(statement));
+    }
+
+    void Database::ApplyWriteBatchAsync(
+        WriteBatch&& batch,
+        CompletionCallback callback
+    ) {
+        callback(ApplyWriteBatch(batch));
+    }
+
+    std::shared_ptr< SnapshotReader > Database::CreateSnapshotReader(size_t chunkSize) {
+        return std::make_shared< BlobSnapshotReader >(CreateSnapshot(), chunkSize);
+    }
+
+    std::shared_ptr< SnapshotReader > Database::CaptureSnapshot(size_t chunkSize) {
+        return std::make_shared< BlobSnapshotReader >(CreateSnapshot(), chunkSize);
+    }
+
+    std::shared_ptr< SnapshotWriter > Database::CreateSnapshotWriter() {
+        return std::make_shared< BufferingSnapshotWriter >(*this);
+    }
+
+    uint64_t Database::GetSnapshotId() {
+        return 0;
+    }
+
+    DeltaSnapshot Database::CreateDeltaSnapshot(uint64_t baseId) {
+        (void)baseId;
+        DeltaSnapshot snapshot;
+        snapshot.id = GetSnapshotId();
+        snapshot.blob = CreateSnapshot();
+        return snapshot;
+    }
+
+    std::string Database::InstallDeltaSnapshot(const DeltaSnapshot& snapshot) {
+        if (!snapshot.full) {
+            return "delta snapshots are not supported";
+        }
+        return InstallSnapshot(snapshot.blob);
+    }
+
+}
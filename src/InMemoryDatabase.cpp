@@ -0,0 +1,3890 @@
+/**
+ * @file InMemoryDatabase.cpp
+ *
+ * This file contains the implementation
+ * of the DatabaseAbstractions::InMemoryDatabase class.
+ */
+
+#include "SqlParser.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <ctype.h>
+#include <DatabaseAbstractions/InMemoryDatabase.hpp>
+#include <DatabaseAbstractions/ValueEncoding.hpp>
+#include <deque>
+#include <functional>
+#include <map>
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace {
+
+    using namespace DatabaseAbstractions;
+
+    /**
+     * This is the number of rows stored together in each page of a table.
+     */
+    constexpr size_t ROWS_PER_PAGE = 256;
+
+    /**
+     * This is used to identify complete snapshots.
+     */
+    const uint8_t SNAPSHOT_MAGIC[4] = {'I', 'M', 'D', 'B'};
+
+    /**
+     * This is used to identify delta snapshots.
+     */
+    const uint8_t DELTA_MAGIC[4] = {'I', 'M', 'D', 'D'};
+
+    /**
+     * This is the version of the snapshot format.
+     */
+    constexpr uint64_t FORMAT_VERSION = 1;
+
+    /**
+     * This is the number of rows to encode at a time when producing
+     * a snapshot in chunks.
+     */
+    constexpr size_t ROWS_PER_ENCODING_STEP = 64;
+
+    /**
+     * This returns a copy of the given name in lower case, for use
+     * in looking up names without regard to case.
+     *
+     * @param[in] name
+     *     This is the name to convert.
+     *
+     * @return
+     *     The name in lower case is returned.
+     */
+    std::string ToLower(const std::string& name) {
+        std::string lower(name);
+        for (auto& c: lower) {
+            c = (char)tolower((unsigned char)c);
+        }
+        return lower;
+    }
+
+    /**
+     * This returns the rank of the given type of value in the order
+     * used to compare values of different types: nulls first, then
+     * numbers, then text, then blobs.
+     *
+     * @param[in] type
+     *     This is the type of value.
+     *
+     * @return
+     *     The rank of the type is returned.
+     */
+    int TypeRank(Value::Type type) {
+        switch (type) {
+            case Value::Type::Invalid: return 0;
+            case Value::Type::Null: return 1;
+            case Value::Type::Boolean:
+            case Value::Type::Integer:
+            case Value::Type::Real: return 2;
+            case Value::Type::Text: return 3;
+            case Value::Type::Blob: return 4;
+            default: return 5;
+        }
+    }
+
+    /**
+     * This returns the given numeric value as an integer,
+     * treating booleans as 0 or 1.
+     *
+     * @param[in] value
+     *     This is the value to convert.
+     *
+     * @return
+     *     The value as an integer is returned.
+     */
+    intmax_t NumericInteger(const Value& value) {
+        if (value.GetType() == Value::Type::Boolean) {
+            return ((bool)value ? 1 : 0);
+        }
+        return (intmax_t)value;
+    }
+
+    /**
+     * This returns the given numeric value as a real number,
+     * treating booleans as 0 or 1.
+     *
+     * @param[in] value
+     *     This is the value to convert.
+     *
+     * @return
+     *     The value as a real number is returned.
+     */
+    double NumericReal(const Value& value) {
+        if (value.GetType() == Value::Type::Real) {
+            return (double)value;
+        }
+        return (double)NumericInteger(value);
+    }
+
+    /**
+     * This determines whether a value satisfies a comparison with
+     * an operand.  As in SQL, comparisons involving nulls never hold.
+     *
+     * @param[in] value
+     *     This is the value to compare.
+     *
+     * @param[in] comparison
+     *     This is the kind of comparison to make.
+     *
+     * @param[in] operand
+     *     This is the value with which to compare.
+     *
+     * @return
+     *     An indication of whether or not the comparison holds
+     *     is returned.
+     */
+    bool Matches(
+        const Value& value,
+        Sql::Comparison comparison,
+        const Value& operand
+    ) {
+        if (
+            (TypeRank(value.GetType()) <= 1)
+            || (TypeRank(operand.GetType()) <= 1)
+        ) {
+            return false;
+        }
+        const auto order = value.Compare(operand);
+        switch (comparison) {
+            case Sql::Comparison::Equal: return order == 0;
+            case Sql::Comparison::NotEqual: return order != 0;
+            case Sql::Comparison::Less: return order < 0;
+            case Sql::Comparison::LessOrEqual: return order <= 0;
+            case Sql::Comparison::Greater: return order > 0;
+            case Sql::Comparison::GreaterOrEqual: return order >= 0;
+            default: return false;
+        }
+    }
+
+    /**
+     * This converts a value stored in a table to the type requested
+     * when fetching it.  Blobs are returned as views of the stored data.
+     *
+     * @param[in] value
+     *     This is the value to convert.
+     *
+     * @param[in] type
+     *     This is the type of value requested.
+     *
+     * @return
+     *     The converted value is returned.  Nulls are returned as nulls,
+     *     and values which can't be converted are returned as invalid.
+     */
+    Value ConvertValue(
+        const Value& value,
+        Value::Type type
+    ) {
+        const auto valueType = value.GetType();
+        if (valueType == Value::Type::Null) {
+            return nullptr;
+        }
+        if (valueType == type) {
+            if (type == Value::Type::Blob) {
+                return (BlobView)value;
+            }
+            return value;
+        }
+        const auto numeric = (TypeRank(valueType) == 2);
+        switch (type) {
+            case Value::Type::Integer: {
+                if (valueType == Value::Type::Real) {
+                    return (intmax_t)(double)value;
+                } else if (numeric) {
+                    return NumericInteger(value);
+                } else if (valueType == Value::Type::Text) {
+                    return (intmax_t)strtoll((const char*)value, NULL, 10);
+                }
+            } break;
+
+            case Value::Type::Real: {
+                if (numeric) {
+                    return NumericReal(value);
+                } else if (valueType == Value::Type::Text) {
+                    return strtod((const char*)value, NULL);
+                }
+            } break;
+
+            case Value::Type::Boolean: {
+                if (numeric) {
+                    return (NumericReal(value) != 0.0);
+                }
+            } break;
+
+            case Value::Type::Text: {
+                if (valueType == Value::Type::Real) {
+                    return std::to_string((double)value);
+                } else if (numeric) {
+                    return std::to_string(NumericInteger(value));
+                } else if (valueType == Value::Type::Blob) {
+                    const BlobView blob(value);
+                    return std::string((const char*)blob.data, blob.size);
+                }
+            } break;
+
+            case Value::Type::Blob: {
+                if (valueType == Value::Type::Text) {
+                    const auto& text = (const std::string&)value;
+                    return BlobView((const uint8_t*)text.data(), text.length());
+                }
+            } break;
+
+            default: break;
+        }
+        return Value();
+    }
+
+    /**
+     * This appends an integer to the given buffer, encoded in
+     * 7-bit groups, least significant first.
+     *
+     * @param[in,out] buffer
+     *     This is the buffer to which to append the integer.
+     *
+     * @param[in] value
+     *     This is the integer to append.
+     */
+    void EncodeVarint(
+        Blob& buffer,
+        uint64_t value
+    ) {
+        while (value >= 0x80) {
+            buffer.push_back((uint8_t)(value | 0x80));
+            value >>= 7;
+        }
+        buffer.push_back((uint8_t)value);
+    }
+
+    /**
+     * This appends a length-prefixed sequence of bytes to the
+     * given buffer.
+     *
+     * @param[in,out] buffer
+     *     This is the buffer to which to append the bytes.
+     *
+     * @param[in] data
+     *     This points to the bytes to append.
+     *
+     * @param[in] size
+     *     This is the number of bytes to append.
+     */
+    void EncodeBytes(
+        Blob& buffer,
+        const void* data,
+        size_t size
+    ) {
+        EncodeVarint(buffer, size);
+        const auto bytes = (const uint8_t*)data;
+        buffer.insert(buffer.end(), bytes, bytes + size);
+    }
+
+    /**
+     * This appends a length-prefixed string to the given buffer.
+     *
+     * @param[in,out] buffer
+     *     This is the buffer to which to append the string.
+     *
+     * @param[in] text
+     *     This is the string to append.
+     */
+    void EncodeString(
+        Blob& buffer,
+        const std::string& text
+    ) {
+        EncodeBytes(buffer, text.data(), text.length());
+    }
+
+    /**
+     * This reads the elements encoded by the Encode functions
+     * from a buffer, checking that they don't run past its end.
+     */
+    class Decoder {
+        // Lifecycle
+    public:
+        Decoder(
+            const uint8_t* data,
+            size_t size
+        )
+            : next_(data)
+            , end_(data + size)
+        {
+        }
+
+        // Methods
+    public:
+        /**
+         * This determines whether or not the whole buffer
+         * has been read.
+         *
+         * @return
+         *     An indication of whether or not the whole buffer
+         *     has been read is returned.
+         */
+        bool AtEnd() const {
+            return next_ == end_;
+        }
+
+        /**
+         * This returns the number of bytes of the buffer
+         * not yet read.
+         *
+         * @return
+         *     The number of bytes not yet read is returned.
+         */
+        size_t Remaining() const {
+            return (size_t)(end_ - next_);
+        }
+
+        /**
+         * This determines whether or not a read failed because
+         * the buffer ended before the element being read, so that
+         * it might succeed once more of the encoding is available.
+         *
+         * @return
+         *     An indication of whether or not a read ran past the end
+         *     of the buffer is returned.
+         */
+        bool RanShort() const {
+            return ranShort_;
+        }
+
+        /**
+         * This reads the given magic number.
+         *
+         * @param[in] magic
+         *     This points to the four bytes expected next.
+         *
+         * @return
+         *     An indication of whether or not the expected bytes
+         *     were read is returned.
+         */
+        bool Magic(const uint8_t* magic) {
+            if (end_ - next_ < 4) {
+                ranShort_ = true;
+                return false;
+            }
+            if (memcmp(next_, magic, 4) != 0) {
+                return false;
+            }
+            next_ += 4;
+            return true;
+        }
+
+        /**
+         * This reads one byte.
+         *
+         * @param[out] byte
+         *     This is where to store the byte.
+         *
+         * @return
+         *     An indication of whether or not the byte
+         *     was read is returned.
+         */
+        bool Byte(uint8_t& byte) {
+            if (next_ == end_) {
+                ranShort_ = true;
+                return false;
+            }
+            byte = *next_++;
+            return true;
+        }
+
+        /**
+         * This reads an integer encoded by EncodeVarint.
+         *
+         * @param[out] value
+         *     This is where to store the integer.
+         *
+         * @return
+         *     An indication of whether or not the integer
+         *     was read is returned.
+         */
+        bool Varint(uint64_t& value) {
+            value = 0;
+            for (size_t shift = 0; shift < 64; shift += 7) {
+                uint8_t byte;
+                if (!Byte(byte)) {
+                    return false;
+                }
+                value |= ((uint64_t)(byte & 0x7F) << shift);
+                if ((byte & 0x80) == 0) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        /**
+         * This reads an integer encoded by EncodeVarint
+         * which is used as a size or index.
+         *
+         * @param[out] value
+         *     This is where to store the integer.
+         *
+         * @return
+         *     An indication of whether or not the integer
+         *     was read is returned.
+         */
+        bool Size(size_t& value) {
+            uint64_t varint;
+            if (!Varint(varint)) {
+                return false;
+            }
+            value = (size_t)varint;
+            return ((uint64_t)value == varint);
+        }
+
+        /**
+         * This reads a sequence of bytes encoded by EncodeBytes.
+         *
+         * @param[out] data
+         *     This is where to store a pointer to the bytes.
+         *
+         * @param[out] size
+         *     This is where to store the number of bytes.
+         *
+         * @return
+         *     An indication of whether or not the bytes
+         *     were read is returned.
+         */
+        bool Bytes(
+            const uint8_t*& data,
+            size_t& size
+        ) {
+            if (!Size(size)) {
+                return false;
+            }
+            if (size > (size_t)(end_ - next_)) {
+                ranShort_ = true;
+                return false;
+            }
+            data = next_;
+            next_ += size;
+            return true;
+        }
+
+        /**
+         * This reads a string encoded by EncodeString.
+         *
+         * @param[out] text
+         *     This is where to store the string.
+         *
+         * @return
+         *     An indication of whether or not the string
+         *     was read is returned.
+         */
+        bool String(std::string& text) {
+            const uint8_t* data;
+            size_t size;
+            if (!Bytes(data, size)) {
+                return false;
+            }
+            text.assign((const char*)data, size);
+            return true;
+        }
+
+        /**
+         * This reads a value encoded by EncodeValue.
+         *
+         * @param[out] value
+         *     This is where to store the value.
+         *
+         * @return
+         *     An indication of whether or not the value
+         *     was read is returned.
+         */
+        bool Value(DatabaseAbstractions::Value& value) {
+            ValueDecoder decoder(BlobView(next_, (size_t)(end_ - next_)));
+            const auto error = decoder.Decode(value);
+            if (!error.empty()) {
+                ranShort_ = (error == "truncated value");
+                return false;
+            }
+            value.Own();
+            next_ += decoder.GetOffset();
+            return true;
+        }
+
+        // Private Properties
+    private:
+        /**
+         * This points to the next byte to read.
+         */
+        const uint8_t* next_;
+
+        /**
+         * This points just past the last byte in the buffer.
+         */
+        const uint8_t* end_;
+
+        /**
+         * This flag is set if a read failed because the buffer ended
+         * before the element being read.
+         */
+        bool ranShort_ = false;
+    };
+
+    /**
+     * This describes a column of a table.
+     */
+    struct Column {
+        /**
+         * This is the name of the column.
+         */
+        std::string name;
+
+        /**
+         * This is the type of value the column was declared to hold.
+         */
+        Value::Type type = Value::Type::Blob;
+
+        /**
+         * This flag is set if values in the column must not be null.
+         */
+        bool notNull = false;
+
+        /**
+         * This is the value used for the column when a row is
+         * inserted without giving one.
+         */
+        Value defaultValue = nullptr;
+    };
+
+    /**
+     * This is an index of the values in one column of a table.
+     */
+    struct Index {
+        /**
+         * This is the name of the index, which is empty for indexes
+         * made for PRIMARY KEY and UNIQUE constraints.
+         */
+        std::string name;
+
+        /**
+         * This is the index of the column indexed.
+         */
+        size_t column = 0;
+
+        /**
+         * This flag is set if values in the column must be unique.
+         */
+        bool unique = false;
+
+        /**
+         * This flag is set if the index is for the primary key.
+         */
+        bool primaryKey = false;
+
+        /**
+         * For unique indexes, this maps non-null values in the column
+         * to the rows holding them.
+         */
+        std::unordered_map< Value, size_t > lookup;
+
+        /**
+         * This maps values in the column, in order, to the rows
+         * holding them.
+         */
+        std::multimap< Value, size_t > ordered;
+    };
+
+    /**
+     * This holds a fixed number of consecutive rows of a table.
+     */
+    struct Page {
+        /**
+         * These are the values of the rows, row by row.
+         */
+        std::vector< Value > cells;
+
+        /**
+         * These flags indicate which rows are in use.
+         */
+        std::vector< bool > live;
+    };
+
+    /**
+     * This holds the schema, data and indexes of one table.
+     */
+    struct Table {
+        // Properties
+
+        /**
+         * This is the name of the table.
+         */
+        std::string name;
+
+        /**
+         * These are the columns of the table.
+         */
+        std::vector< Column > columns;
+
+        /**
+         * These are the indexes of the table.
+         */
+        std::vector< Index > indexes;
+
+        /**
+         * These hold the rows of the table.  A page holding no rows
+         * in use may be null, until a row is stored in it.
+         */
+        std::vector< std::shared_ptr< Page > > pages;
+
+        /**
+         * These are the identifiers of rows which aren't in use and
+         * are below the high-water mark.  The last one is reused next.
+         */
+        std::vector< size_t > freeRows;
+
+        /**
+         * This is one more than the highest row identifier ever used.
+         */
+        size_t slotCount = 0;
+
+        /**
+         * This is the number of rows in use.
+         */
+        size_t rowCount = 0;
+
+        // Methods
+
+        /**
+         * This determines whether or not the given row is in use.
+         *
+         * @param[in] row
+         *     This is the identifier of the row.
+         *
+         * @return
+         *     An indication of whether or not the row is in use
+         *     is returned.
+         */
+        bool IsLive(size_t row) const {
+            if (row >= slotCount) {
+                return false;
+            }
+            const auto& page = pages[row / ROWS_PER_PAGE];
+            return (
+                (page != nullptr)
+                && page->live[row % ROWS_PER_PAGE]
+            );
+        }
+
+        /**
+         * This returns the values of the given row.
+         *
+         * @param[in] row
+         *     This is the identifier of the row.
+         *
+         * @return
+         *     A pointer to the value of the first column of the row
+         *     is returned.  The other columns follow it.
+         */
+        const Value* GetRow(size_t row) const {
+            return &pages[row / ROWS_PER_PAGE]->cells[(row % ROWS_PER_PAGE) * columns.size()];
+        }
+
+        /**
+         * This returns the values of the given row, so that they
+         * can be changed.
+         *
+         * @param[in] row
+         *     This is the identifier of the row.
+         *
+         * @return
+         *     A pointer to the value of the first column of the row
+         *     is returned.  The other columns follow it.
+         */
+        Value* GetMutableRow(size_t row) {
+            return &MakePageWritable(row).cells[(row % ROWS_PER_PAGE) * columns.size()];
+        }
+
+        /**
+         * This returns the page holding the given row, first replacing
+         * it with a copy if it's shared with a captured snapshot, so that
+         * changing it doesn't change the snapshot.
+         *
+         * @param[in] row
+         *     This is the identifier of the row.
+         *
+         * @return
+         *     The page holding the row, owned only by the table,
+         *     is returned.
+         */
+        Page& MakePageWritable(size_t row) {
+            auto& page = pages[row / ROWS_PER_PAGE];
+            if (page == nullptr) {
+                page = MakePage();
+            } else if (page.use_count() > 1) {
+                page = std::make_shared< Page >(*page);
+            } else {
+                // A snapshot reading the page on another thread may have
+                // just let go of it; this makes sure it's done reading
+                // before the page is changed.
+                std::atomic_thread_fence(std::memory_order_acquire);
+            }
+            return *page;
+        }
+
+        /**
+         * This makes a copy of the table for a captured snapshot.
+         * Only the schema of the indexes is copied, and the pages are
+         * shared with the table, which copies each one before it next
+         * changes it.
+         *
+         * @return
+         *     The copy of the table is returned.
+         */
+        std::unique_ptr< Table > Capture() const {
+            std::unique_ptr< Table > copy(new Table());
+            copy->name = name;
+            copy->columns = columns;
+            copy->indexes.reserve(indexes.size());
+            for (const auto& index: indexes) {
+                Index indexCopy;
+                indexCopy.name = index.name;
+                indexCopy.column = index.column;
+                indexCopy.unique = index.unique;
+                indexCopy.primaryKey = index.primaryKey;
+                copy->indexes.push_back(std::move(indexCopy));
+            }
+            copy->pages = pages;
+            copy->freeRows = freeRows;
+            copy->slotCount = slotCount;
+            copy->rowCount = rowCount;
+            return copy;
+        }
+
+        /**
+         * This marks the given row as in use or not.
+         *
+         * @param[in] row
+         *     This is the identifier of the row.
+         *
+         * @param[in] live
+         *     This indicates whether or not the row is in use.
+         */
+        void SetLive(size_t row, bool live) {
+            MakePageWritable(row).live[row % ROWS_PER_PAGE] = live;
+        }
+
+        /**
+         * This adds pages to the table, if necessary, to hold
+         * the given row.
+         *
+         * @param[in] row
+         *     This is the identifier of the row to hold.
+         */
+        void EnsurePage(size_t row) {
+            while (pages.size() * ROWS_PER_PAGE <= row) {
+                pages.push_back(MakePage());
+            }
+        }
+
+        /**
+         * This makes a new page for the table, with no rows in use.
+         *
+         * @return
+         *     The new page is returned.
+         */
+        std::shared_ptr< Page > MakePage() const {
+            const auto page = std::make_shared< Page >();
+            page->cells.resize(ROWS_PER_PAGE * columns.size());
+            page->live.resize(ROWS_PER_PAGE);
+            return page;
+        }
+
+        /**
+         * This finds the column with the given name.
+         *
+         * @param[in] columnName
+         *     This is the name of the column to find.
+         *
+         * @return
+         *     The index of the column is returned, or -1 if there is
+         *     no column with the given name.
+         */
+        int FindColumn(const std::string& columnName) const {
+            const auto lowerName = ToLower(columnName);
+            for (size_t i = 0; i < columns.size(); ++i) {
+                if (ToLower(columns[i].name) == lowerName) {
+                    return (int)i;
+                }
+            }
+            return -1;
+        }
+
+        /**
+         * This finds an index of the given column.
+         *
+         * @param[in] column
+         *     This is the index of the column.
+         *
+         * @param[in] unique
+         *     This indicates whether only unique indexes are wanted.
+         *
+         * @return
+         *     A pointer to the index is returned, or null if there
+         *     is no such index.
+         */
+        Index* FindIndex(size_t column, bool unique) {
+            for (auto& index: indexes) {
+                if (
+                    (index.column == column)
+                    && (index.unique || !unique)
+                ) {
+                    return &index;
+                }
+            }
+            return nullptr;
+        }
+
+        /**
+         * This adds the given row to an index.
+         *
+         * @param[in,out] index
+         *     This is the index to which to add the row.
+         *
+         * @param[in] row
+         *     This is the identifier of the row to add.
+         */
+        void AddToIndex(Index& index, size_t row) {
+            const auto& key = GetRow(row)[index.column];
+            (void)index.ordered.insert(std::make_pair(key, row));
+            if (
+                index.unique
+                && (key.GetType() != Value::Type::Null)
+            ) {
+                index.lookup[key] = row;
+            }
+        }
+
+        /**
+         * This adds the given row to all of the table's indexes.
+         *
+         * @param[in] row
+         *     This is the identifier of the row to add.
+         */
+        void AddToIndexes(size_t row) {
+            for (auto& index: indexes) {
+                AddToIndex(index, row);
+            }
+        }
+
+        /**
+         * This removes the given row from all of the table's indexes.
+         *
+         * @param[in] row
+         *     This is the identifier of the row to remove.
+         */
+        void RemoveFromIndexes(size_t row) {
+            const auto values = GetRow(row);
+            for (auto& index: indexes) {
+                const auto& key = values[index.column];
+                auto entries = index.ordered.equal_range(key);
+                for (auto entry = entries.first; entry != entries.second; ++entry) {
+                    if (entry->second == row) {
+                        (void)index.ordered.erase(entry);
+                        break;
+                    }
+                }
+                if (
+                    index.unique
+                    && (key.GetType() != Value::Type::Null)
+                ) {
+                    (void)index.lookup.erase(key);
+                }
+            }
+        }
+
+        /**
+         * This finds the rows which conflict with the given values
+         * because they have the same values in unique columns.
+         *
+         * @param[in] values
+         *     These are the values to check.
+         *
+         * @param[in] self
+         *     This is the identifier of a row to ignore, because
+         *     it's the row being given the values.
+         *
+         * @param[out] conflicts
+         *     This is where to store the identifiers of conflicting rows.
+         *
+         * @return
+         *     If there's a conflict, the name of the first column which
+         *     has a conflict is returned.  Otherwise, an empty string
+         *     is returned.
+         */
+        std::string FindConflicts(
+            const Value* values,
+            size_t self,
+            std::vector< size_t >& conflicts
+        ) const {
+            std::string column;
+            for (const auto& index: indexes) {
+                if (!index.unique) {
+                    continue;
+                }
+                const auto& key = values[index.column];
+                if (key.GetType() == Value::Type::Null) {
+                    continue;
+                }
+                const auto entry = index.lookup.find(key);
+                if (
+                    (entry != index.lookup.end())
+                    && (entry->second != self)
+                ) {
+                    if (column.empty()) {
+                        column = columns[index.column].name;
+                    }
+                    if (
+                        std::find(conflicts.begin(), conflicts.end(), entry->second)
+                        == conflicts.end()
+                    ) {
+                        conflicts.push_back(entry->second);
+                    }
+                }
+            }
+            return column;
+        }
+    };
+
+    /**
+     * These are the kinds of changes recorded in the change log.
+     */
+    enum class ChangeKind : uint8_t {
+        Schema = 0,
+        Put = 1,
+        Delete = 2,
+    };
+
+    /**
+     * This records one change made to the database, for use in
+     * producing delta snapshots.
+     */
+    struct Change {
+        /**
+         * This is the kind of change.
+         */
+        ChangeKind kind = ChangeKind::Schema;
+
+        /**
+         * This identifies the state of the database after the statement
+         * which made the change.
+         */
+        uint64_t version = 0;
+
+        /**
+         * This is the name of the table changed, or the SQL text
+         * of a statement which changed the schema.
+         */
+        std::string target;
+
+        /**
+         * This is the identifier of the row changed.
+         */
+        size_t row = 0;
+
+        /**
+         * These are the new values of a row which was added or changed.
+         */
+        std::vector< Value > values;
+    };
+
+    /**
+     * These are the kinds of changes which can be undone.
+     */
+    enum class UndoKind {
+        Insert,
+        Delete,
+        Update,
+        CreateTable,
+        DropTable,
+        CreateIndex,
+        DropIndex,
+    };
+
+    /**
+     * This records how to undo one change made to a table
+     * or to the schema.
+     */
+    struct Undo {
+        /**
+         * This is the kind of change to undo.
+         */
+        UndoKind kind = UndoKind::Insert;
+
+        /**
+         * This is the table which was changed.
+         */
+        Table* table = nullptr;
+
+        /**
+         * This is the identifier of the row changed.
+         */
+        size_t row = 0;
+
+        /**
+         * These are the values the row had before the change.
+         */
+        std::vector< Value > values;
+
+        /**
+         * This flag is set if an inserted row reused an identifier
+         * from the table's list of free rows.
+         */
+        bool reusedFreeRow = false;
+
+        /**
+         * This holds a table which was dropped.
+         */
+        std::unique_ptr< Table > droppedTable;
+
+        /**
+         * This holds an index which was dropped.
+         */
+        Index droppedIndex;
+
+        /**
+         * This is the position the dropped index had in the table's
+         * list of indexes.
+         */
+        size_t indexNumber = 0;
+    };
+
+    /**
+     * This marks a point to which changes can be undone.
+     */
+    struct Savepoint {
+        /**
+         * This is the number of entries in the undo log at the time.
+         */
+        size_t undoCount = 0;
+
+        /**
+         * This is the number of entries in the change log at the time.
+         */
+        size_t changeCount = 0;
+    };
+
+    /**
+     * This builds the tables described by a snapshot, one element
+     * at a time, so that the snapshot can be decoded as it arrives
+     * rather than only once it's complete.
+     */
+    class SnapshotDecoder {
+        // Types
+    private:
+        /**
+         * These are the elements of the snapshot, in the order
+         * they're expected.
+         */
+        enum class Step {
+            Header,
+            TableSchema,
+            FreeRow,
+            RowCount,
+            Row,
+            Done,
+        };
+
+        // Methods
+    public:
+        /**
+         * This decodes as many whole elements of the snapshot
+         * as the given bytes hold.
+         *
+         * @param[in] data
+         *     This points to the next bytes of the snapshot.
+         *
+         * @param[in] size
+         *     This is the number of bytes available.
+         *
+         * @param[out] consumed
+         *     This is where to store the number of bytes decoded.
+         *     The rest must be given again, followed by more of the
+         *     snapshot, in the next call.
+         *
+         * @return
+         *     If the snapshot is invalid, a description of the problem
+         *     is returned.  Otherwise, an empty string is returned.
+         */
+        std::string Decode(
+            const uint8_t* data,
+            size_t size,
+            size_t& consumed
+        ) {
+            static const std::string invalid = "invalid snapshot";
+            consumed = 0;
+            while (consumed < size) {
+                if (step_ == Step::Done) {
+                    return invalid;
+                }
+                Decoder decoder(data + consumed, size - consumed);
+                if (!DecodeStep(decoder)) {
+                    return (decoder.RanShort() ? "" : invalid);
+                }
+                consumed = size - decoder.Remaining();
+            }
+            return "";
+        }
+
+        /**
+         * This hands over the tables decoded from the snapshot,
+         * once all of it has been decoded, leaving the decoder ready
+         * to decode another snapshot.
+         *
+         * @param[out] tables
+         *     This is where to store the tables.
+         *
+         * @param[out] id
+         *     This is where to store the identifier of the state
+         *     of the database captured by the snapshot.
+         *
+         * @return
+         *     If the snapshot is incomplete, a description of the
+         *     problem is returned.  Otherwise, an empty string
+         *     is returned.
+         */
+        std::string Finish(
+            std::map< std::string, std::unique_ptr< Table > >& tables,
+            uint64_t& id
+        ) {
+            if (step_ != Step::Done) {
+                return "invalid snapshot";
+            }
+            tables = std::move(tables_);
+            tables_.clear();
+            id = id_;
+            step_ = Step::Header;
+            return "";
+        }
+
+        // Private Methods
+    private:
+        /**
+         * This decodes the next element of the snapshot.  Nothing is
+         * changed unless the whole element is decoded.
+         *
+         * @param[in,out] decoder
+         *     This reads the element.
+         *
+         * @return
+         *     An indication of whether or not the element was decoded
+         *     is returned.  If the decoder didn't run short, the
+         *     snapshot is invalid.
+         */
+        bool DecodeStep(Decoder& decoder) {
+            switch (step_) {
+                case Step::Header: return DecodeHeader(decoder);
+                case Step::TableSchema: return DecodeTableSchema(decoder);
+                case Step::FreeRow: return DecodeFreeRow(decoder);
+                case Step::RowCount: return DecodeRowCount(decoder);
+                case Step::Row: return DecodeRow(decoder);
+                default: return false;
+            }
+        }
+
+        /**
+         * This decodes the start of the snapshot, which comes before
+         * the first table.
+         *
+         * @param[in,out] decoder
+         *     This reads the element.
+         *
+         * @return
+         *     An indication of whether or not the element was decoded
+         *     is returned.
+         */
+        bool DecodeHeader(Decoder& decoder) {
+            uint64_t formatVersion;
+            if (
+                !decoder.Magic(SNAPSHOT_MAGIC)
+                || !decoder.Varint(formatVersion)
+                || (formatVersion != FORMAT_VERSION)
+                || !decoder.Varint(id_)
+                || !decoder.Size(tableCount_)
+            ) {
+                return false;
+            }
+            step_ = ((tableCount_ == 0) ? Step::Done : Step::TableSchema);
+            return true;
+        }
+
+        /**
+         * This decodes the schema of the next table, along with
+         * the number of its rows and free rows.
+         *
+         * @param[in,out] decoder
+         *     This reads the element.
+         *
+         * @return
+         *     An indication of whether or not the element was decoded
+         *     is returned.
+         */
+        bool DecodeTableSchema(Decoder& decoder) {
+            std::unique_ptr< Table > table(new Table());
+            size_t columnCount;
+            if (
+                !decoder.String(table->name)
+                || !decoder.Size(columnCount)
+                || (columnCount == 0)
+            ) {
+                return false;
+            }
+            for (size_t i = 0; i < columnCount; ++i) {
+                Column column;
+                Value type;
+                uint8_t notNull;
+                if (
+                    !decoder.String(column.name)
+                    || !decoder.Value(type)
+                    || !decoder.Byte(notNull)
+                    || !decoder.Value(column.defaultValue)
+                    || (type.GetType() != Value::Type::Integer)
+                ) {
+                    return false;
+                }
+                column.type = (Value::Type)(intmax_t)type;
+                switch (column.type) {
+                    case Value::Type::Blob:
+                    case Value::Type::Boolean:
+                    case Value::Type::Integer:
+                    case Value::Type::Real:
+                    case Value::Type::Text: break;
+                    default: return false;
+                }
+                column.notNull = (notNull != 0);
+                table->columns.push_back(std::move(column));
+            }
+            size_t indexCount;
+            if (!decoder.Size(indexCount)) {
+                return false;
+            }
+            for (size_t i = 0; i < indexCount; ++i) {
+                Index index;
+                uint8_t flags;
+                if (
+                    !decoder.String(index.name)
+                    || !decoder.Size(index.column)
+                    || (index.column >= columnCount)
+                    || !decoder.Byte(flags)
+                ) {
+                    return false;
+                }
+                index.unique = ((flags & 1) != 0);
+                index.primaryKey = ((flags & 2) != 0);
+                table->indexes.push_back(std::move(index));
+            }
+            size_t freeRowCount;
+            if (
+                !decoder.Size(table->slotCount)
+                || !decoder.Size(freeRowCount)
+                || (freeRowCount > table->slotCount)
+            ) {
+                return false;
+            }
+            table_ = std::move(table);
+            freeRowCount_ = freeRowCount;
+            sortedFreeRows_.clear();
+            step_ = ((freeRowCount == 0) ? Step::RowCount : Step::FreeRow);
+            return true;
+        }
+
+        /**
+         * This decodes the identifier of the next free row
+         * of the table.
+         *
+         * @param[in,out] decoder
+         *     This reads the element.
+         *
+         * @return
+         *     An indication of whether or not the element was decoded
+         *     is returned.
+         */
+        bool DecodeFreeRow(Decoder& decoder) {
+            size_t row;
+            if (
+                !decoder.Size(row)
+                || (row >= table_->slotCount)
+            ) {
+                return false;
+            }
+            table_->freeRows.push_back(row);
+            if (table_->freeRows.size() < freeRowCount_) {
+                return true;
+            }
+            sortedFreeRows_ = table_->freeRows;
+            std::sort(sortedFreeRows_.begin(), sortedFreeRows_.end());
+            if (
+                std::adjacent_find(
+                    sortedFreeRows_.begin(),
+                    sortedFreeRows_.end()
+                ) != sortedFreeRows_.end()
+            ) {
+                return false;
+            }
+            step_ = Step::RowCount;
+            return true;
+        }
+
+        /**
+         * This decodes the number of rows in use in the table.
+         *
+         * @param[in,out] decoder
+         *     This reads the element.
+         *
+         * @return
+         *     An indication of whether or not the element was decoded
+         *     is returned.
+         */
+        bool DecodeRowCount(Decoder& decoder) {
+            if (
+                !decoder.Size(rowCount_)
+                || (rowCount_ + freeRowCount_ != table_->slotCount)
+            ) {
+                return false;
+            }
+            if (rowCount_ == 0) {
+                return FinishTable();
+            }
+            step_ = Step::Row;
+            return true;
+        }
+
+        /**
+         * This decodes the next row in use in the table.
+         *
+         * Rows come in order of their identifiers, and every row below
+         * the high-water mark is either free or in use, so no row can
+         * have an identifier above the number of rows already decoded.
+         * This keeps the pages allocated in proportion to the snapshot.
+         *
+         * @param[in,out] decoder
+         *     This reads the element.
+         *
+         * @return
+         *     An indication of whether or not the element was decoded
+         *     is returned.
+         */
+        bool DecodeRow(Decoder& decoder) {
+            const auto columnCount = table_->columns.size();
+            size_t row;
+            if (
+                !decoder.Size(row)
+                || (row >= table_->slotCount)
+                || (row > freeRowCount_ + table_->rowCount)
+                || (
+                    (table_->rowCount > 0)
+                    && (row <= lastRow_)
+                )
+                || std::binary_search(
+                    sortedFreeRows_.begin(),
+                    sortedFreeRows_.end(),
+                    row
+                )
+            ) {
+                return false;
+            }
+            std::vector< Value > values(columnCount);
+            for (auto& value: values) {
+                if (!decoder.Value(value)) {
+                    return false;
+                }
+            }
+            for (const auto& index: table_->indexes) {
+                const auto& key = values[index.column];
+                if (
+                    index.unique
+                    && (key.GetType() != Value::Type::Null)
+                    && (index.lookup.find(key) != index.lookup.end())
+                ) {
+                    return false;
+                }
+            }
+            if (table_->pages.size() * ROWS_PER_PAGE <= row) {
+                table_->pages.resize(row / ROWS_PER_PAGE + 1);
+            }
+            const auto cells = table_->GetMutableRow(row);
+            for (size_t i = 0; i < columnCount; ++i) {
+                cells[i] = std::move(values[i]);
+            }
+            table_->SetLive(row, true);
+            ++table_->rowCount;
+            lastRow_ = row;
+            for (auto& index: table_->indexes) {
+                table_->AddToIndex(index, row);
+            }
+            if (table_->rowCount < rowCount_) {
+                return true;
+            }
+            return FinishTable();
+        }
+
+        /**
+         * This adds the table just decoded to the tables
+         * decoded so far.
+         *
+         * @return
+         *     An indication of whether or not the table could be added
+         *     is returned.
+         */
+        bool FinishTable() {
+            const auto key = ToLower(table_->name);
+            if (tables_.find(key) != tables_.end()) {
+                return false;
+            }
+            // Pages for free rows at the end of the table are left null.
+            table_->pages.resize((table_->slotCount + ROWS_PER_PAGE - 1) / ROWS_PER_PAGE);
+            tables_[key] = std::move(table_);
+            step_ = ((tables_.size() == tableCount_) ? Step::Done : Step::TableSchema);
+            return true;
+        }
+
+        // Private Properties
+    private:
+        /**
+         * This is the next element of the snapshot expected.
+         */
+        Step step_ = Step::Header;
+
+        /**
+         * This identifies the state of the database captured
+         * by the snapshot.
+         */
+        uint64_t id_ = 0;
+
+        /**
+         * This is the number of tables in the snapshot.
+         */
+        size_t tableCount_ = 0;
+
+        /**
+         * These are the tables decoded so far, keyed by the
+         * lower-case versions of their names.
+         */
+        std::map< std::string, std::unique_ptr< Table > > tables_;
+
+        /**
+         * This is the table being decoded.
+         */
+        std::unique_ptr< Table > table_;
+
+        /**
+         * This is the number of free rows in the table being decoded.
+         */
+        size_t freeRowCount_ = 0;
+
+        /**
+         * This is the number of rows in use in the table
+         * being decoded.
+         */
+        size_t rowCount_ = 0;
+
+        /**
+         * These are the free rows of the table being decoded,
+         * in order.
+         */
+        std::vector< size_t > sortedFreeRows_;
+
+        /**
+         * This is the identifier of the last row decoded.
+         */
+        size_t lastRow_ = 0;
+    };
+
+    /**
+     * This holds the complete state of a database.
+     */
+    struct Engine {
+        // Properties
+
+        /**
+         * These are the tables of the database, keyed by lower-case name.
+         */
+        std::map< std::string, std::unique_ptr< Table > > tables;
+
+        /**
+         * This identifies the current state of the database.
+         */
+        uint64_t version = 0;
+
+        /**
+         * This is incremented whenever the schema of the database
+         * changes, so that prepared statements know to look up tables
+         * and columns again.
+         */
+        uint64_t schemaGeneration = 0;
+
+        /**
+         * These are the most recent changes made to the database,
+         * oldest first.
+         */
+        std::deque< Change > changes;
+
+        /**
+         * This identifies the oldest state from which the changes
+         * in the change log lead to the current state.
+         */
+        uint64_t oldestDeltaBase = 0;
+
+        /**
+         * This is the maximum number of changes to keep in the log.
+         */
+        size_t maxChangeLogSize = 0;
+
+        /**
+         * This records how to undo the changes made by the current
+         * statement or transaction.
+         */
+        std::vector< Undo > undoLog;
+
+        /**
+         * This flag is set while a transaction is open.
+         */
+        bool inTransaction = false;
+
+        /**
+         * This marks where the changes of the open transaction began.
+         */
+        Savepoint transaction;
+
+        /**
+         * This is incremented whenever the contents of the database
+         * change, including changes not yet committed, so that snapshot
+         * readers can tell if the database changed under them.
+         */
+        uint64_t modificationCount = 0;
+
+        // Methods
+
+        /**
+         * This finds the table with the given name.
+         *
+         * @param[in] name
+         *     This is the name of the table to find.
+         *
+         * @return
+         *     A pointer to the table is returned, or null if there is
+         *     no table with the given name.
+         */
+        Table* FindTable(const std::string& name) {
+            const auto table = tables.find(ToLower(name));
+            if (table == tables.end()) {
+                return nullptr;
+            }
+            return table->second.get();
+        }
+
+        /**
+         * This finds the table having the index with the given name.
+         *
+         * @param[in] name
+         *     This is the name of the index to find.
+         *
+         * @param[out] indexNumber
+         *     This is where to store the position of the index
+         *     in the table's list of indexes.
+         *
+         * @return
+         *     A pointer to the table with the index is returned, or null
+         *     if there is no index with the given name.
+         */
+        Table* FindIndex(
+            const std::string& name,
+            size_t& indexNumber
+        ) {
+            const auto lowerName = ToLower(name);
+            for (auto& table: tables) {
+                auto& indexes = table.second->indexes;
+                for (size_t i = 0; i < indexes.size(); ++i) {
+                    if (
+                        !indexes[i].name.empty()
+                        && (ToLower(indexes[i].name) == lowerName)
+                    ) {
+                        indexNumber = i;
+                        return table.second.get();
+                    }
+                }
+            }
+            return nullptr;
+        }
+
+        /**
+         * This marks the current point in the undo and change logs,
+         * so that changes made afterwards can be undone.
+         *
+         * @return
+         *     The savepoint is returned.
+         */
+        Savepoint Begin() const {
+            Savepoint savepoint;
+            savepoint.undoCount = undoLog.size();
+            savepoint.changeCount = changes.size();
+            return savepoint;
+        }
+
+        /**
+         * This makes the changes recorded since the given savepoint
+         * permanent, advancing the identifier of the database state
+         * if anything changed.  While a transaction is open, this does
+         * nothing, since the changes are kept until the transaction
+         * is committed or rolled back.
+         *
+         * @param[in] savepoint
+         *     This marks where the changes to keep began.
+         */
+        void Commit(const Savepoint& savepoint) {
+            if (inTransaction) {
+                return;
+            }
+            if (changes.size() > savepoint.changeCount) {
+                version = changes.back().version;
+            }
+            undoLog.resize(savepoint.undoCount);
+            TrimChangeLog();
+        }
+
+        /**
+         * This undoes the changes made since the given savepoint.
+         *
+         * @param[in] savepoint
+         *     This marks where the changes to undo began.
+         */
+        void Rollback(const Savepoint& savepoint) {
+            if (undoLog.size() > savepoint.undoCount) {
+                ++modificationCount;
+            }
+            while (undoLog.size() > savepoint.undoCount) {
+                UndoChange(undoLog.back());
+                undoLog.pop_back();
+            }
+            changes.resize(savepoint.changeCount);
+        }
+
+        /**
+         * This opens a transaction, so that the changes made by the
+         * statements which follow are made permanent together or
+         * not at all.
+         *
+         * @return
+         *     If a transaction is already open, a description of the
+         *     problem is returned.  Otherwise, an empty string
+         *     is returned.
+         */
+        std::string BeginTransaction() {
+            if (inTransaction) {
+                return "cannot start a transaction within a transaction";
+            }
+            transaction = Begin();
+            inTransaction = true;
+            return "";
+        }
+
+        /**
+         * This makes the changes made by the open transaction permanent,
+         * advancing the identifier of the database state once for the
+         * whole transaction.
+         *
+         * @return
+         *     If no transaction is open, a description of the problem
+         *     is returned.  Otherwise, an empty string is returned.
+         */
+        std::string CommitTransaction() {
+            if (!inTransaction) {
+                return "cannot commit - no transaction is active";
+            }
+            inTransaction = false;
+            Commit(transaction);
+            return "";
+        }
+
+        /**
+         * This undoes the changes made by the open transaction.
+         *
+         * @return
+         *     If no transaction is open, a description of the problem
+         *     is returned.  Otherwise, an empty string is returned.
+         */
+        std::string RollbackTransaction() {
+            if (!inTransaction) {
+                return "cannot rollback - no transaction is active";
+            }
+            inTransaction = false;
+            Rollback(transaction);
+            return "";
+        }
+
+        /**
+         * This drops the oldest changes from the change log, if it's
+         * grown too large.  All the changes of a state are dropped
+         * together.
+         */
+        void TrimChangeLog() {
+            if (changes.size() <= maxChangeLogSize) {
+                return;
+            }
+            while (changes.size() > maxChangeLogSize) {
+                oldestDeltaBase = changes.front().version;
+                changes.pop_front();
+            }
+            while (
+                !changes.empty()
+                && (changes.front().version == oldestDeltaBase)
+            ) {
+                changes.pop_front();
+            }
+        }
+
+        /**
+         * This adds a change to the change log.
+         *
+         * @param[in] kind
+         *     This is the kind of change.
+         *
+         * @param[in] target
+         *     This is the name of the table changed, or the SQL text
+         *     of a statement which changed the schema.
+         *
+         * @param[in] row
+         *     This is the identifier of the row changed.
+         *
+         * @param[in] values
+         *     These are the new values of the row changed.
+         */
+        void RecordChange(
+            ChangeKind kind,
+            const std::string& target,
+            size_t row = 0,
+            std::vector< Value >&& values = std::vector< Value >()
+        ) {
+            Change change;
+            change.kind = kind;
+            change.version = version + 1;
+            change.target = target;
+            change.row = row;
+            change.values = std::move(values);
+            changes.push_back(std::move(change));
+            ++modificationCount;
+        }
+
+        /**
+         * This makes copies of the tables of the database as they were
+         * when the last change was committed, sharing their pages, for
+         * a captured snapshot.  If a transaction is open, the changes
+         * it has made so far are undone in the copies, leaving the
+         * tables themselves as they are.
+         *
+         * @return
+         *     The copies of the tables are returned, in the order
+         *     of their lower-case names.
+         */
+        std::vector< std::unique_ptr< Table > > CaptureCommittedTables() const {
+            std::map< std::string, std::unique_ptr< Table > > captured;
+            std::map< const Table*, Table* > copies;
+            for (const auto& table: tables) {
+                auto copy = table.second->Capture();
+                copies[table.second.get()] = copy.get();
+                captured[table.first] = std::move(copy);
+            }
+            const auto undoCount = (inTransaction ? transaction.undoCount : undoLog.size());
+            for (size_t i = undoLog.size(); i > undoCount; --i) {
+                const auto& undo = undoLog[i - 1];
+                if (undo.kind == UndoKind::DropTable) {
+                    auto copy = undo.droppedTable->Capture();
+                    copies[undo.droppedTable.get()] = copy.get();
+                    captured[ToLower(copy->name)] = std::move(copy);
+                    continue;
+                }
+                auto& table = *copies[undo.table];
+                switch (undo.kind) {
+                    case UndoKind::Insert: {
+                        const auto values = table.GetMutableRow(undo.row);
+                        for (size_t j = 0; j < table.columns.size(); ++j) {
+                            values[j] = Value();
+                        }
+                        table.SetLive(undo.row, false);
+                        --table.rowCount;
+                        if (undo.reusedFreeRow) {
+                            table.freeRows.push_back(undo.row);
+                        } else {
+                            --table.slotCount;
+                        }
+                    } break;
+
+                    case UndoKind::Delete: {
+                        table.freeRows.pop_back();
+                        const auto values = table.GetMutableRow(undo.row);
+                        for (size_t j = 0; j < table.columns.size(); ++j) {
+                            values[j] = undo.values[j];
+                        }
+                        table.SetLive(undo.row, true);
+                        ++table.rowCount;
+                    } break;
+
+                    case UndoKind::Update: {
+                        const auto values = table.GetMutableRow(undo.row);
+                        for (size_t j = 0; j < table.columns.size(); ++j) {
+                            values[j] = undo.values[j];
+                        }
+                    } break;
+
+                    case UndoKind::CreateTable: {
+                        (void)captured.erase(ToLower(table.name));
+                    } break;
+
+                    case UndoKind::CreateIndex: {
+                        table.indexes.pop_back();
+                    } break;
+
+                    case UndoKind::DropIndex: {
+                        Index index;
+                        index.name = undo.droppedIndex.name;
+                        index.column = undo.droppedIndex.column;
+                        index.unique = undo.droppedIndex.unique;
+                        index.primaryKey = undo.droppedIndex.primaryKey;
+                        (void)table.indexes.insert(
+                            table.indexes.begin() + undo.indexNumber,
+                            std::move(index)
+                        );
+                    } break;
+
+                    default: break;
+                }
+            }
+            std::vector< std::unique_ptr< Table > > result;
+            result.reserve(captured.size());
+            for (auto& table: captured) {
+                result.push_back(std::move(table.second));
+            }
+            return result;
+        }
+
+        /**
+         * This undoes one change made to a table or to the schema.
+         *
+         * @param[in,out] undo
+         *     This describes the change to undo.
+         */
+        void UndoChange(Undo& undo) {
+            auto& table = *undo.table;
+            switch (undo.kind) {
+                case UndoKind::Insert: {
+                    table.RemoveFromIndexes(undo.row);
+                    const auto values = table.GetMutableRow(undo.row);
+                    for (size_t i = 0; i < table.columns.size(); ++i) {
+                        values[i] = Value();
+                    }
+                    table.SetLive(undo.row, false);
+                    --table.rowCount;
+                    if (undo.reusedFreeRow) {
+                        table.freeRows.push_back(undo.row);
+                    } else {
+                        --table.slotCount;
+                    }
+                } break;
+
+                case UndoKind::Delete: {
+                    table.freeRows.pop_back();
+                    const auto values = table.GetMutableRow(undo.row);
+                    for (size_t i = 0; i < table.columns.size(); ++i) {
+                        values[i] = std::move(undo.values[i]);
+                    }
+                    table.SetLive(undo.row, true);
+                    ++table.rowCount;
+                    table.AddToIndexes(undo.row);
+                } break;
+
+                case UndoKind::Update: {
+                    table.RemoveFromIndexes(undo.row);
+                    const auto values = table.GetMutableRow(undo.row);
+                    for (size_t i = 0; i < table.columns.size(); ++i) {
+                        values[i] = std::move(undo.values[i]);
+                    }
+                    table.AddToIndexes(undo.row);
+                } break;
+
+                case UndoKind::CreateTable: {
+                    (void)tables.erase(ToLower(table.name));
+                    ++schemaGeneration;
+                } break;
+
+                case UndoKind::DropTable: {
+                    tables[ToLower(table.name)] = std::move(undo.droppedTable);
+                    ++schemaGeneration;
+                } break;
+
+                case UndoKind::CreateIndex: {
+                    table.indexes.pop_back();
+                    ++schemaGeneration;
+                } break;
+
+                case UndoKind::DropIndex: {
+                    (void)table.indexes.insert(
+                        table.indexes.begin() + undo.indexNumber,
+                        std::move(undo.droppedIndex)
+                    );
+                    ++schemaGeneration;
+                } break;
+            }
+        }
+
+        /**
+         * This checks the given values for a row of the given table
+         * against the table's NOT NULL constraints.
+         *
+         * @param[in] table
+         *     This is the table to which the row belongs.
+         *
+         * @param[in] values
+         *     These are the values to check.
+         *
+         * @return
+         *     If a constraint is violated, a description of the problem
+         *     is returned.  Otherwise, an empty string is returned.
+         */
+        static std::string CheckNotNull(
+            const Table& table,
+            const std::vector< Value >& values
+        ) {
+            for (size_t i = 0; i < table.columns.size(); ++i) {
+                if (
+                    table.columns[i].notNull
+                    && (values[i].GetType() == Value::Type::Null)
+                ) {
+                    return "NOT NULL constraint failed: " + table.name + "." + table.columns[i].name;
+                }
+            }
+            return "";
+        }
+
+        /**
+         * This stores the given values in a row of the given table,
+         * which must not be in use, and records the change.
+         *
+         * @param[in,out] table
+         *     This is the table to which to add the row.
+         *
+         * @param[in] row
+         *     This is the identifier of the row to use.
+         *
+         * @param[in] reusedFreeRow
+         *     This indicates whether the row was taken from the
+         *     table's list of free rows.
+         *
+         * @param[in,out] values
+         *     These are the values to store.  They're moved into the row.
+         */
+        void StoreNewRow(
+            Table& table,
+            size_t row,
+            bool reusedFreeRow,
+            std::vector< Value >& values
+        ) {
+            table.EnsurePage(row);
+            const auto cells = table.GetMutableRow(row);
+            for (size_t i = 0; i < values.size(); ++i) {
+                cells[i] = values[i];
+            }
+            table.SetLive(row, true);
+            ++table.rowCount;
+            table.AddToIndexes(row);
+            Undo undo;
+            undo.kind = UndoKind::Insert;
+            undo.table = &table;
+            undo.row = row;
+            undo.reusedFreeRow = reusedFreeRow;
+            undoLog.push_back(std::move(undo));
+            RecordChange(ChangeKind::Put, table.name, row, std::move(values));
+        }
+
+        /**
+         * This adds a row to the given table.
+         *
+         * @param[in,out] table
+         *     This is the table to which to add the row.
+         *
+         * @param[in,out] values
+         *     These are the values of the new row.
+         *
+         * @param[in] replace
+         *     This indicates whether rows which conflict with the new
+         *     row should be deleted, rather than failing.
+         *
+         * @return
+         *     If the row can't be added, a description of the problem
+         *     is returned.  Otherwise, an empty string is returned.
+         */
+        std::string InsertRow(
+            Table& table,
+            std::vector< Value >& values,
+            bool replace
+        ) {
+            for (auto& value: values) {
+                value.Own();
+            }
+            for (const auto& index: table.indexes) {
+                if (
+                    index.primaryKey
+                    && (table.columns[index.column].type == Value::Type::Integer)
+                    && (values[index.column].GetType() == Value::Type::Null)
+                ) {
+                    intmax_t key = 1;
+                    if (!index.ordered.empty()) {
+                        const auto& last = index.ordered.rbegin()->first;
+                        if (TypeRank(last.GetType()) == 2) {
+                            intmax_t lastKey;
+                            if (last.GetType() == Value::Type::Real) {
+                                const auto real = floor((double)last);
+                                if (real >= 9223372036854775808.0) {
+                                    return "database or disk is full";
+                                }
+                                lastKey = (
+                                    (real < -9223372036854775808.0)
+                                    ? INTMAX_MIN
+                                    : (intmax_t)real
+                                );
+                            } else {
+                                lastKey = NumericInteger(last);
+                            }
+                            if (lastKey == INTMAX_MAX) {
+                                return "database or disk is full";
+                            }
+                            key = lastKey + 1;
+                        }
+                    }
+                    values[index.column] = key;
+                }
+            }
+            const auto error = CheckNotNull(table, values);
+            if (!error.empty()) {
+                return error;
+            }
+            std::vector< size_t > conflicts;
+            const auto conflict = table.FindConflicts(values.data(), (size_t)-1, conflicts);
+            if (!conflict.empty()) {
+                if (!replace) {
+                    return "UNIQUE constraint failed: " + table.name + "." + conflict;
+                }
+                for (const auto row: conflicts) {
+                    DeleteRow(table, row);
+                }
+            }
+            size_t row;
+            bool reusedFreeRow;
+            if (table.freeRows.empty()) {
+                row = table.slotCount++;
+                reusedFreeRow = false;
+            } else {
+                row = table.freeRows.back();
+                table.freeRows.pop_back();
+                reusedFreeRow = true;
+            }
+            StoreNewRow(table, row, reusedFreeRow, values);
+            return "";
+        }
+
+        /**
+         * This removes a row from the given table.
+         *
+         * @param[in,out] table
+         *     This is the table from which to remove the row.
+         *
+         * @param[in] row
+         *     This is the identifier of the row to remove.
+         */
+        void DeleteRow(
+            Table& table,
+            size_t row
+        ) {
+            table.RemoveFromIndexes(row);
+            const auto cells = table.GetMutableRow(row);
+            Undo undo;
+            undo.kind = UndoKind::Delete;
+            undo.table = &table;
+            undo.row = row;
+            undo.values.reserve(table.columns.size());
+            for (size_t i = 0; i < table.columns.size(); ++i) {
+                undo.values.push_back(std::move(cells[i]));
+            }
+            undoLog.push_back(std::move(undo));
+            table.SetLive(row, false);
+            --table.rowCount;
+            table.freeRows.push_back(row);
+            RecordChange(ChangeKind::Delete, table.name, row);
+        }
+
+        /**
+         * This replaces the values of a row in the given table.
+         *
+         * @param[in,out] table
+         *     This is the table holding the row.
+         *
+         * @param[in] row
+         *     This is the identifier of the row to change.
+         *
+         * @param[in,out] values
+         *     These are the new values of the row.
+         *
+         * @return
+         *     If the row can't be changed, a description of the problem
+         *     is returned.  Otherwise, an empty string is returned.
+         */
+        std::string UpdateRow(
+            Table& table,
+            size_t row,
+            std::vector< Value >& values
+        ) {
+            for (auto& value: values) {
+                value.Own();
+            }
+            const auto error = CheckNotNull(table, values);
+            if (!error.empty()) {
+                return error;
+            }
+            std::vector< size_t > conflicts;
+            const auto conflict = table.FindConflicts(values.data(), row, conflicts);
+            if (!conflict.empty()) {
+                return "UNIQUE constraint failed: " + table.name + "." + conflict;
+            }
+            table.RemoveFromIndexes(row);
+            const auto cells = table.GetMutableRow(row);
+            Undo undo;
+            undo.kind = UndoKind::Update;
+            undo.table = &table;
+            undo.row = row;
+            undo.values.reserve(table.columns.size());
+            for (size_t i = 0; i < table.columns.size(); ++i) {
+                undo.values.push_back(std::move(cells[i]));
+                cells[i] = values[i];
+            }
+            undoLog.push_back(std::move(undo));
+            table.AddToIndexes(row);
+            RecordChange(ChangeKind::Put, table.name, row, std::move(values));
+            return "";
+        }
+
+        /**
+         * This stores the given values in the given row of a table,
+         * as part of installing a delta snapshot.  The row is added if
+         * it isn't already in use, in which case it must be the row the
+         * table would use next, since the table is expected to be in the
+         * same state as it was in the database which made the change.
+         *
+         * @param[in,out] table
+         *     This is the table holding the row.
+         *
+         * @param[in] row
+         *     This is the identifier of the row to change.
+         *
+         * @param[in,out] values
+         *     These are the new values of the row.
+         *
+         * @return
+         *     If the row can't be stored, a description of the problem
+         *     is returned.  Otherwise, an empty string is returned.
+         */
+        std::string PutRow(
+            Table& table,
+            size_t row,
+            std::vector< Value >& values
+        ) {
+            if (values.size() != table.columns.size()) {
+                return "delta snapshot does not match table " + table.name;
+            }
+            if (table.IsLive(row)) {
+                return UpdateRow(table, row, values);
+            }
+            bool reusedFreeRow;
+            if (row == table.slotCount) {
+                ++table.slotCount;
+                reusedFreeRow = false;
+            } else if (
+                !table.freeRows.empty()
+                && (table.freeRows.back() == row)
+            ) {
+                table.freeRows.pop_back();
+                reusedFreeRow = true;
+            } else {
+                return "delta snapshot does not match table " + table.name;
+            }
+            std::vector< size_t > conflicts;
+            if (!table.FindConflicts(values.data(), row, conflicts).empty()) {
+                if (reusedFreeRow) {
+                    table.freeRows.push_back(row);
+                } else {
+                    --table.slotCount;
+                }
+                return "delta snapshot does not match table " + table.name;
+            }
+            StoreNewRow(table, row, reusedFreeRow, values);
+            return "";
+        }
+
+        /**
+         * This carries out a statement which changes the schema
+         * of the database.
+         *
+         * @param[in] statement
+         *     This is the statement to carry out.
+         *
+         * @return
+         *     If the statement fails, a description of the problem
+         *     is returned.  Otherwise, an empty string is returned.
+         */
+        std::string ChangeSchema(const Sql::Statement& statement) {
+            std::string error;
+            auto changed = false;
+            Undo undo;
+            switch (statement.kind) {
+                case Sql::StatementKind::CreateTable: {
+                    error = CreateTable(statement, changed);
+                    undo.kind = UndoKind::CreateTable;
+                    undo.table = FindTable(statement.table);
+                } break;
+
+                case Sql::StatementKind::CreateIndex: {
+                    error = CreateIndex(statement, changed);
+                    undo.kind = UndoKind::CreateIndex;
+                    undo.table = FindTable(statement.table);
+                } break;
+
+                case Sql::StatementKind::DropTable: {
+                    const auto table = tables.find(ToLower(statement.table));
+                    if (table == tables.end()) {
+                        if (!statement.ifClause) {
+                            error = "no such table: " + statement.table;
+                        }
+                    } else {
+                        undo.kind = UndoKind::DropTable;
+                        undo.table = table->second.get();
+                        undo.droppedTable = std::move(table->second);
+                        (void)tables.erase(table);
+                        changed = true;
+                    }
+                } break;
+
+                case Sql::StatementKind::DropIndex: {
+                    size_t indexNumber;
+                    const auto table = FindIndex(statement.index, indexNumber);
+                    if (table == nullptr) {
+                        if (!statement.ifClause) {
+                            error = "no such index: " + statement.index;
+                        }
+                    } else {
+                        undo.kind = UndoKind::DropIndex;
+                        undo.table = table;
+                        undo.indexNumber = indexNumber;
+                        undo.droppedIndex = std::move(table->indexes[indexNumber]);
+                        (void)table->indexes.erase(table->indexes.begin() + indexNumber);
+                        changed = true;
+                    }
+                } break;
+
+                default: break;
+            }
+            if (changed) {
+                undoLog.push_back(std::move(undo));
+                ++schemaGeneration;
+                RecordChange(ChangeKind::Schema, statement.text);
+            }
+            return error;
+        }
+
+        /**
+         * This carries out a CREATE TABLE statement.
+         *
+         * @param[in] statement
+         *     This is the statement to carry out.
+         *
+         * @param[out] changed
+         *     This is set if the table was created.
+         *
+         * @return
+         *     If the statement fails, a description of the problem
+         *     is returned.  Otherwise, an empty string is returned.
+         */
+        std::string CreateTable(
+            const Sql::Statement& statement,
+            bool& changed
+        ) {
+            if (FindTable(statement.table) != nullptr) {
+                if (statement.ifClause) {
+                    return "";
+                }
+                return "table " + statement.table + " already exists";
+            }
+            std::unique_ptr< Table > table(new Table());
+            table->name = statement.table;
+            auto primaryKeys = 0;
+            for (const auto& definition: statement.columnDefinitions) {
+                if (table->FindColumn(definition.name) >= 0) {
+                    return "duplicate column name: " + definition.name;
+                }
+                const auto columnNumber = table->columns.size();
+                Column column;
+                column.name = definition.name;
+                column.type = definition.type;
+                column.notNull = definition.notNull;
+                column.defaultValue = definition.defaultValue;
+                table->columns.push_back(std::move(column));
+                if (
+                    definition.primaryKey
+                    || definition.unique
+                ) {
+                    Index index;
+                    index.column = columnNumber;
+                    index.unique = true;
+                    index.primaryKey = definition.primaryKey;
+                    table->indexes.push_back(std::move(index));
+                }
+                if (definition.primaryKey) {
+                    ++primaryKeys;
+                }
+            }
+            if (primaryKeys > 1) {
+                return "table " + statement.table + " has more than one primary key";
+            }
+            tables[ToLower(statement.table)] = std::move(table);
+            changed = true;
+            return "";
+        }
+
+        /**
+         * This carries out a CREATE INDEX statement.
+         *
+         * @param[in] statement
+         *     This is the statement to carry out.
+         *
+         * @param[out] changed
+         *     This is set if the index was created.
+         *
+         * @return
+         *     If the statement fails, a description of the problem
+         *     is returned.  Otherwise, an empty string is returned.
+         */
+        std::string CreateIndex(
+            const Sql::Statement& statement,
+            bool& changed
+        ) {
+            size_t indexNumber;
+            if (FindIndex(statement.index, indexNumber) != nullptr) {
+                if (statement.ifClause) {
+                    return "";
+                }
+                return "index " + statement.index + " already exists";
+            }
+            const auto table = FindTable(statement.table);
+            if (table == nullptr) {
+                return "no such table: " + statement.table;
+            }
+            const auto column = table->FindColumn(statement.columns[0]);
+            if (column < 0) {
+                return "no such column: " + statement.columns[0];
+            }
+            Index index;
+            index.name = statement.index;
+            index.column = (size_t)column;
+            index.unique = statement.unique;
+            for (size_t row = 0; row < table->slotCount; ++row) {
+                if (!table->IsLive(row)) {
+                    continue;
+                }
+                const auto& key = table->GetRow(row)[column];
+                if (
+                    index.unique
+                    && (key.GetType() != Value::Type::Null)
+                    && (index.lookup.find(key) != index.lookup.end())
+                ) {
+                    return "UNIQUE constraint failed: " + table->name + "." + table->columns[column].name;
+                }
+                table->AddToIndex(index, row);
+            }
+            table->indexes.push_back(std::move(index));
+            changed = true;
+            return "";
+        }
+
+        /**
+         * This appends the schema of the given table to a snapshot.
+         *
+         * @param[in,out] buffer
+         *     This is the snapshot to which to append the schema.
+         *
+         * @param[in] table
+         *     This is the table whose schema to append.
+         */
+        static void EncodeTableSchema(
+            Blob& buffer,
+            const Table& table
+        ) {
+            EncodeString(buffer, table.name);
+            EncodeVarint(buffer, table.columns.size());
+            for (const auto& column: table.columns) {
+                EncodeString(buffer, column.name);
+                EncodeValue(Value((intmax_t)column.type), buffer);
+                buffer.push_back(column.notNull ? 1 : 0);
+                EncodeValue(column.defaultValue, buffer);
+            }
+            EncodeVarint(buffer, table.indexes.size());
+            for (const auto& index: table.indexes) {
+                EncodeString(buffer, index.name);
+                EncodeVarint(buffer, index.column);
+                buffer.push_back(
+                    (index.unique ? 1 : 0)
+                    | (index.primaryKey ? 2 : 0)
+                );
+            }
+            EncodeVarint(buffer, table.slotCount);
+            EncodeVarint(buffer, table.freeRows.size());
+            for (const auto row: table.freeRows) {
+                EncodeVarint(buffer, row);
+            }
+            EncodeVarint(buffer, table.rowCount);
+        }
+
+        /**
+         * This appends one row of the given table to a snapshot.
+         *
+         * @param[in,out] buffer
+         *     This is the snapshot to which to append the row.
+         *
+         * @param[in] table
+         *     This is the table holding the row.
+         *
+         * @param[in] row
+         *     This is the identifier of the row to append.
+         */
+        static void EncodeRow(
+            Blob& buffer,
+            const Table& table,
+            size_t row
+        ) {
+            EncodeVarint(buffer, row);
+            const auto values = table.GetRow(row);
+            for (size_t i = 0; i < table.columns.size(); ++i) {
+                EncodeValue(values[i], buffer);
+            }
+        }
+
+        /**
+         * This replaces the state of the database with the state
+         * captured in the given complete snapshot.
+         *
+         * @param[in] blob
+         *     This is the snapshot to install.
+         *
+         * @return
+         *     If the snapshot is invalid, a description of the problem
+         *     is returned.  Otherwise, an empty string is returned.
+         */
+        std::string InstallSnapshot(const Blob& blob) {
+            if (inTransaction) {
+                return "cannot install a snapshot during a transaction";
+            }
+            SnapshotDecoder decoder;
+            size_t consumed;
+            const auto error = decoder.Decode(blob.data(), blob.size(), consumed);
+            if (!error.empty()) {
+                return error;
+            }
+            return InstallSnapshot(decoder);
+        }
+
+        /**
+         * This replaces the state of the database with the state
+         * captured in the snapshot decoded by the given decoder.
+         *
+         * @param[in,out] decoder
+         *     This holds the tables decoded from the snapshot.
+         *
+         * @return
+         *     If the snapshot is incomplete or can't be installed,
+         *     a description of the problem is returned.  Otherwise,
+         *     an empty string is returned.
+         */
+        std::string InstallSnapshot(SnapshotDecoder& decoder) {
+            if (inTransaction) {
+                return "cannot install a snapshot during a transaction";
+            }
+            std::map< std::string, std::unique_ptr< Table > > newTables;
+            uint64_t id;
+            const auto error = decoder.Finish(newTables, id);
+            if (!error.empty()) {
+                return error;
+            }
+            tables.swap(newTables);
+            version = id;
+            ++schemaGeneration;
+            changes.clear();
+            oldestDeltaBase = id;
+            undoLog.clear();
+            ++modificationCount;
+            return "";
+        }
+
+        /**
+         * This encodes the changes made since the given state.
+         *
+         * @param[in] baseId
+         *     This identifies the state from which to encode changes.
+         *
+         * @return
+         *     The encoded changes are returned.
+         */
+        Blob EncodeDelta(uint64_t baseId) const {
+            auto last = changes.end();
+            while (
+                (last != changes.begin())
+                && ((last - 1)->version > version)
+            ) {
+                --last;
+            }
+            auto first = last;
+            while (
+                (first != changes.begin())
+                && ((first - 1)->version > baseId)
+            ) {
+                --first;
+            }
+            Blob buffer(DELTA_MAGIC, DELTA_MAGIC + 4);
+            EncodeVarint(buffer, (uint64_t)(last - first));
+            for (auto change = first; change != last; ++change) {
+                EncodeVarint(buffer, change->version);
+                buffer.push_back((uint8_t)change->kind);
+                EncodeString(buffer, change->target);
+                switch (change->kind) {
+                    case ChangeKind::Put: {
+                        EncodeVarint(buffer, change->row);
+                        EncodeVarint(buffer, change->values.size());
+                        for (const auto& value: change->values) {
+                            EncodeValue(value, buffer);
+                        }
+                    } break;
+
+                    case ChangeKind::Delete: {
+                        EncodeVarint(buffer, change->row);
+                    } break;
+
+                    default: break;
+                }
+            }
+            return buffer;
+        }
+
+        /**
+         * This decodes changes encoded by EncodeDelta.
+         *
+         * @param[in] blob
+         *     This holds the encoded changes.
+         *
+         * @param[out] deltaChanges
+         *     This is where to store the changes.
+         *
+         * @return
+         *     An indication of whether or not the changes
+         *     were decoded successfully is returned.
+         */
+        static bool DecodeDelta(
+            const Blob& blob,
+            std::vector< Change >& deltaChanges
+        ) {
+            Decoder decoder(blob.data(), blob.size());
+            size_t count;
+            if (
+                !decoder.Magic(DELTA_MAGIC)
+                || !decoder.Size(count)
+            ) {
+                return false;
+            }
+            for (size_t i = 0; i < count; ++i) {
+                Change change;
+                uint8_t kind;
+                if (
+                    !decoder.Varint(change.version)
+                    || !decoder.Byte(kind)
+                    || !decoder.String(change.target)
+                ) {
+                    return false;
+                }
+                change.kind = (ChangeKind)kind;
+                switch (change.kind) {
+                    case ChangeKind::Schema: break;
+
+                    case ChangeKind::Put: {
+                        size_t valueCount;
+                        if (
+                            !decoder.Size(change.row)
+                            || !decoder.Size(valueCount)
+                            || (valueCount > blob.size())
+                        ) {
+                            return false;
+                        }
+                        change.values.resize(valueCount);
+                        for (auto& value: change.values) {
+                            if (!decoder.Value(value)) {
+                                return false;
+                            }
+                        }
+                    } break;
+
+                    case ChangeKind::Delete: {
+                        if (!decoder.Size(change.row)) {
+                            return false;
+                        }
+                    } break;
+
+                    default: return false;
+                }
+                deltaChanges.push_back(std::move(change));
+            }
+            return decoder.AtEnd();
+        }
+
+        /**
+         * This applies one change from a delta snapshot.
+         *
+         * @param[in,out] change
+         *     This is the change to apply.
+         *
+         * @return
+         *     If the change can't be applied, a description of the
+         *     problem is returned.  Otherwise, an empty string
+         *     is returned.
+         */
+        std::string ApplyChange(Change& change) {
+            if (change.kind == ChangeKind::Schema) {
+                Sql::Statement statement;
+                size_t offset = 0;
+                const auto error = Sql::Parse(change.target, offset, statement);
+                if (!error.empty()) {
+                    return error;
+                }
+                return ChangeSchema(statement);
+            }
+            const auto table = FindTable(change.target);
+            if (table == nullptr) {
+                return "no such table: " + change.target;
+            }
+            if (change.kind == ChangeKind::Put) {
+                return PutRow(*table, change.row, change.values);
+            }
+            if (!table->IsLive(change.row)) {
+                return "delta snapshot does not match table " + table->name;
+            }
+            DeleteRow(*table, change.row);
+            return "";
+        }
+    };
+
+    /**
+     * This holds the tables and columns a prepared statement refers to,
+     * as looked up for a particular generation of the database schema.
+     */
+    struct Plan {
+        /**
+         * This is the generation of the schema for which the plan
+         * was made.
+         */
+        uint64_t schemaGeneration = (uint64_t)-1;
+
+        /**
+         * This is the table on which the statement acts.
+         */
+        Table* table = nullptr;
+
+        /**
+         * These are the columns selected, given values by an INSERT,
+         * or assigned by an UPDATE.
+         */
+        std::vector< size_t > columns;
+
+        /**
+         * These are the columns compared by the WHERE clause.
+         */
+        std::vector< size_t > whereColumns;
+
+        /**
+         * This is the column by which results are ordered,
+         * or -1 if they aren't ordered.
+         */
+        int orderBy = -1;
+    };
+
+    /**
+     * This is the implementation of prepared statements for
+     * InMemoryDatabase.
+     */
+    class Statement
+        : public PreparedStatement
+    {
+        // Lifecycle
+    public:
+        Statement(
+            const std::shared_ptr< Engine >& engine,
+            Sql::Statement&& statement
+        )
+            : engine_(engine)
+            , statement_(std::move(statement))
+            , parameters_(statement_.parameterCount, nullptr)
+        {
+        }
+
+        // Methods
+    public:
+        /**
+         * This carries out the statement.  If it's a query, this finds
+         * the matching rows.
+         *
+         * @return
+         *     If the statement fails, a description of the problem
+         *     is returned.  Otherwise, an empty string is returned.
+         */
+        std::string Execute() {
+            auto& engine = *engine_;
+            switch (statement_.kind) {
+                case Sql::StatementKind::Insert:
+                case Sql::StatementKind::Update:
+                case Sql::StatementKind::Delete: {
+                    auto error = MakePlan();
+                    if (!error.empty()) {
+                        return error;
+                    }
+                    const auto savepoint = engine.Begin();
+                    if (statement_.kind == Sql::StatementKind::Insert) {
+                        error = Insert();
+                    } else if (statement_.kind == Sql::StatementKind::Update) {
+                        error = Update();
+                    } else {
+                        error = Delete();
+                    }
+                    if (error.empty()) {
+                        engine.Commit(savepoint);
+                    } else {
+                        engine.Rollback(savepoint);
+                    }
+                    return error;
+                }
+
+                case Sql::StatementKind::Select: {
+                    const auto error = MakePlan();
+                    if (!error.empty()) {
+                        return error;
+                    }
+                    return Select();
+                }
+
+                case Sql::StatementKind::Begin: {
+                    return engine.BeginTransaction();
+                }
+
+                case Sql::StatementKind::Commit: {
+                    return engine.CommitTransaction();
+                }
+
+                case Sql::StatementKind::Rollback: {
+                    return engine.RollbackTransaction();
+                }
+
+                default: {
+                    const auto savepoint = engine.Begin();
+                    const auto error = engine.ChangeSchema(statement_);
+                    if (error.empty()) {
+                        engine.Commit(savepoint);
+                    } else {
+                        engine.Rollback(savepoint);
+                    }
+                    return error;
+                }
+            }
+        }
+
+        // PreparedStatement
+    public:
+        virtual void BindParameter(
+            int index,
+            const Value& value
+        ) override {
+            if (
+                (index >= 1)
+                && (index <= (int)parameters_.size())
+            ) {
+                parameters_[index - 1] = value;
+            }
+        }
+
+        virtual void BindParameter(
+            int index,
+            Value&& value
+        ) override {
+            if (
+                (index >= 1)
+                && (index <= (int)parameters_.size())
+            ) {
+                parameters_[index - 1] = std::move(value);
+            }
+        }
+
+        virtual void BindParameters(std::initializer_list< const Value > values) override {
+            int index = 1;
+            for (const auto& value: values) {
+                BindParameter(index++, value);
+            }
+        }
+
+        virtual void BindParameters(std::vector< Value >&& values) override {
+            int index = 1;
+            for (auto& value: values) {
+                BindParameter(index++, std::move(value));
+            }
+        }
+
+        virtual Value FetchColumn(int index, Value::Type type) override {
+            if (
+                !hasRow_
+                || (index < 0)
+            ) {
+                return Value();
+            }
+            if (statement_.countRows) {
+                return (index == 0) ? ConvertValue(count_, type) : Value();
+            }
+            const auto cell = FindCell(index);
+            if (cell == nullptr) {
+                return Value();
+            }
+            return ConvertValue(*cell, type);
+        }
+
+        virtual void FetchColumn(
+            int index,
+            Value::Type type,
+            Value& value
+        ) override {
+            const auto cell = FindCell(index);
+            if (
+                (cell != nullptr)
+                && (cell->GetType() == type)
+            ) {
+                if (type == Value::Type::Blob) {
+                    value = (BlobView)*cell;
+                } else {
+                    value = *cell;
+                }
+            } else {
+                value = FetchColumn(index, type);
+            }
+        }
+
+        virtual StepStatementResults StepBatch(
+            size_t maxRows,
+            RowBatch& batch
+        ) override {
+            batch.Clear();
+            const auto columnCount = batch.GetColumnCount();
+            auto& arena = batch.GetArena();
+            StepStatementResults results;
+            while (batch.GetRowCount() < maxRows) {
+                results = Step();
+                if (
+                    results.done
+                    || !results.error.empty()
+                ) {
+                    break;
+                }
+                const auto row = batch.AddRow();
+                const Value* cells = (
+                    (
+                        statement_.countRows
+                        || (plan_.schemaGeneration != engine_->schemaGeneration)
+                    )
+                    ? nullptr
+                    : plan_.table->GetRow(currentRow_)
+                );
+                for (size_t column = 0; column < columnCount; ++column) {
+                    const auto type = batch.GetColumnType(column);
+                    auto& value = batch.GetValue(row, column);
+                    if (
+                        (cells != nullptr)
+                        && (column < plan_.columns.size())
+                    ) {
+                        const auto& cell = cells[plan_.columns[column]];
+                        if (cell.GetType() == type) {
+                            value.Assign(cell, arena);
+                            continue;
+                        }
+                    }
+                    value.Assign(FetchColumn((int)column, type), arena);
+                }
+            }
+            return results;
+        }
+
+        virtual void Reset() override {
+            executed_ = false;
+            hasRow_ = false;
+            rows_.clear();
+            position_ = 0;
+        }
+
+        virtual StepStatementResults Step() override {
+            StepStatementResults results;
+            if (!executed_) {
+                executed_ = true;
+                results.error = Execute();
+                if (!results.error.empty()) {
+                    return results;
+                }
+            }
+            if (statement_.kind != Sql::StatementKind::Select) {
+                results.done = true;
+                return results;
+            }
+            if (statement_.countRows) {
+                hasRow_ = (position_++ == 0);
+                results.done = !hasRow_;
+                return results;
+            }
+            hasRow_ = false;
+            if (plan_.schemaGeneration == engine_->schemaGeneration) {
+                while (position_ < rows_.size()) {
+                    currentRow_ = rows_[position_++];
+                    if (plan_.table->IsLive(currentRow_)) {
+                        hasRow_ = true;
+                        break;
+                    }
+                }
+            }
+            results.done = !hasRow_;
+            return results;
+        }
+
+        // Private Methods
+    private:
+        /**
+         * This returns the table cell holding the given column of the
+         * current row, if there is one.
+         *
+         * @param[in] index
+         *     This is the zero-based index of the column whose cell
+         *     to return.
+         *
+         * @return
+         *     The cell holding the column is returned, or nullptr if
+         *     there is no current row, the column doesn't exist, or
+         *     the column isn't read from a table (as when counting rows).
+         */
+        const Value* FindCell(int index) const {
+            if (
+                !hasRow_
+                || (index < 0)
+                || statement_.countRows
+                || (plan_.schemaGeneration != engine_->schemaGeneration)
+                || ((size_t)index >= plan_.columns.size())
+            ) {
+                return nullptr;
+            }
+            return &plan_.table->GetRow(currentRow_)[plan_.columns[index]];
+        }
+
+        /**
+         * This returns the value of the given operand.
+         *
+         * @param[in] expression
+         *     This is the operand whose value to return.
+         *
+         * @return
+         *     The value of the operand is returned.
+         */
+        const Value& Evaluate(const Sql::Expression& expression) const {
+            if (expression.parameter == 0) {
+                return expression.literal;
+            }
+            if (expression.parameter > (int)parameters_.size()) {
+                static const Value null(nullptr);
+                return null;
+            }
+            return parameters_[expression.parameter - 1];
+        }
+
+        /**
+         * This looks up the table and columns the statement refers to,
+         * if the schema has changed since they were last looked up.
+         *
+         * @return
+         *     If the table or columns don't exist, a description of the
+         *     problem is returned.  Otherwise, an empty string
+         *     is returned.
+         */
+        std::string MakePlan() {
+            auto& engine = *engine_;
+            if (plan_.schemaGeneration == engine.schemaGeneration) {
+                return "";
+            }
+            Plan plan;
+            plan.table = engine.FindTable(statement_.table);
+            if (plan.table == nullptr) {
+                return "no such table: " + statement_.table;
+            }
+            const auto& table = *plan.table;
+            std::vector< std::string > columnNames;
+            if (statement_.kind == Sql::StatementKind::Update) {
+                for (const auto& assignment: statement_.assignments) {
+                    columnNames.push_back(assignment.first);
+                }
+            } else {
+                columnNames = statement_.columns;
+            }
+            if (columnNames.empty()) {
+                for (size_t i = 0; i < table.columns.size(); ++i) {
+                    plan.columns.push_back(i);
+                }
+            } else {
+                for (const auto& name: columnNames) {
+                    const auto column = table.FindColumn(name);
+                    if (column < 0) {
+                        return "no such column: " + name;
+                    }
+                    plan.columns.push_back((size_t)column);
+                }
+            }
+            for (const auto& row: statement_.rows) {
+                if (row.size() != plan.columns.size()) {
+                    return (
+                        "table " + table.name + " has "
+                        + std::to_string(plan.columns.size())
+                        + " columns but "
+                        + std::to_string(row.size())
+                        + " values were supplied"
+                    );
+                }
+            }
+            for (const auto& condition: statement_.where) {
+                const auto column = table.FindColumn(condition.column);
+                if (column < 0) {
+                    return "no such column: " + condition.column;
+                }
+                plan.whereColumns.push_back((size_t)column);
+            }
+            if (!statement_.orderBy.empty()) {
+                plan.orderBy = table.FindColumn(statement_.orderBy);
+                if (plan.orderBy < 0) {
+                    return "no such column: " + statement_.orderBy;
+                }
+            }
+            plan.schemaGeneration = engine.schemaGeneration;
+            plan_ = std::move(plan);
+            return "";
+        }
+
+        /**
+         * This determines whether or not the given row satisfies all
+         * the conditions of the WHERE clause.
+         *
+         * @param[in] row
+         *     This is the identifier of the row to check.
+         *
+         * @return
+         *     An indication of whether or not the row satisfies the
+         *     WHERE clause is returned.
+         */
+        bool RowMatches(size_t row) const {
+            const auto values = plan_.table->GetRow(row);
+            for (size_t i = 0; i < statement_.where.size(); ++i) {
+                const auto& condition = statement_.where[i];
+                if (
+                    !Matches(
+                        values[plan_.whereColumns[i]],
+                        condition.comparison,
+                        Evaluate(condition.operand)
+                    )
+                ) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        /**
+         * This finds the rows which satisfy the WHERE clause,
+         * using an index where possible.
+         *
+         * @param[out] rows
+         *     This is where to store the identifiers of the rows.
+         *
+         * @return
+         *     An indication of whether or not the rows were found
+         *     in the order of the ORDER BY column is returned.
+         */
+        bool FindRows(std::vector< size_t >& rows) const {
+            auto& table = *plan_.table;
+            const auto& where = statement_.where;
+            for (size_t i = 0; i < where.size(); ++i) {
+                if (where[i].comparison != Sql::Comparison::Equal) {
+                    continue;
+                }
+                const auto index = table.FindIndex(plan_.whereColumns[i], true);
+                if (index == nullptr) {
+                    continue;
+                }
+                const auto entry = index->lookup.find(Evaluate(where[i].operand));
+                if (
+                    (entry != index->lookup.end())
+                    && RowMatches(entry->second)
+                ) {
+                    rows.push_back(entry->second);
+                }
+                return true;
+            }
+            const Index* rangeIndex = nullptr;
+            for (size_t i = 0; i < where.size(); ++i) {
+                if (where[i].comparison == Sql::Comparison::NotEqual) {
+                    continue;
+                }
+                const auto index = table.FindIndex(plan_.whereColumns[i], false);
+                if (
+                    (index != nullptr)
+                    && (
+                        (rangeIndex == nullptr)
+                        || ((int)index->column == plan_.orderBy)
+                    )
+                ) {
+                    rangeIndex = index;
+                }
+            }
+            if (
+                (rangeIndex == nullptr)
+                && (plan_.orderBy >= 0)
+            ) {
+                rangeIndex = table.FindIndex((size_t)plan_.orderBy, false);
+            }
+            if (rangeIndex == nullptr) {
+                for (size_t row = 0; row < table.slotCount; ++row) {
+                    if (
+                        table.IsLive(row)
+                        && RowMatches(row)
+                    ) {
+                        rows.push_back(row);
+                    }
+                }
+                return false;
+            }
+            const auto& ordered = rangeIndex->ordered;
+            auto begin = ordered.begin();
+            auto end = ordered.end();
+            for (size_t i = 0; i < where.size(); ++i) {
+                if (plan_.whereColumns[i] != rangeIndex->column) {
+                    continue;
+                }
+                const auto& operand = Evaluate(where[i].operand);
+                if (TypeRank(operand.GetType()) <= 1) {
+                    return ((int)rangeIndex->column == plan_.orderBy);
+                }
+                auto lower = ordered.begin();
+                auto upper = ordered.end();
+                switch (where[i].comparison) {
+                    case Sql::Comparison::Equal: {
+                        lower = ordered.lower_bound(operand);
+                        upper = ordered.upper_bound(operand);
+                    } break;
+
+                    case Sql::Comparison::Less: {
+                        upper = ordered.lower_bound(operand);
+                    } break;
+
+                    case Sql::Comparison::LessOrEqual: {
+                        upper = ordered.upper_bound(operand);
+                    } break;
+
+                    case Sql::Comparison::Greater: {
+                        lower = ordered.upper_bound(operand);
+                    } break;
+
+                    case Sql::Comparison::GreaterOrEqual: {
+                        lower = ordered.lower_bound(operand);
+                    } break;
+
+                    default: break;
+                }
+                if (
+                    (begin != ordered.end())
+                    && (
+                        (lower == ordered.end())
+                        || (begin->first < lower->first)
+                    )
+                ) {
+                    begin = lower;
+                }
+                if (
+                    (upper != ordered.end())
+                    && (
+                        (end == ordered.end())
+                        || (upper->first < end->first)
+                    )
+                ) {
+                    end = upper;
+                }
+            }
+            if (
+                (end != ordered.end())
+                && (
+                    (begin == ordered.end())
+                    || !(begin->first < end->first)
+                )
+            ) {
+                return ((int)rangeIndex->column == plan_.orderBy);
+            }
+            for (auto entry = begin; entry != end; ++entry) {
+                if (RowMatches(entry->second)) {
+                    rows.push_back(entry->second);
+                }
+            }
+            return ((int)rangeIndex->column == plan_.orderBy);
+        }
+
+        /**
+         * This carries out an INSERT statement.
+         *
+         * @return
+         *     If the statement fails, a description of the problem
+         *     is returned.  Otherwise, an empty string is returned.
+         */
+        std::string Insert() {
+            auto& table = *plan_.table;
+            for (const auto& row: statement_.rows) {
+                std::vector< Value > values;
+                values.reserve(table.columns.size());
+                for (const auto& column: table.columns) {
+                    values.push_back(column.defaultValue);
+                }
+                for (size_t i = 0; i < row.size(); ++i) {
+                    values[plan_.columns[i]] = Evaluate(row[i]);
+                }
+                const auto error = engine_->InsertRow(table, values, statement_.unique);
+                if (!error.empty()) {
+                    return error;
+                }
+            }
+            return "";
+        }
+
+        /**
+         * This carries out an UPDATE statement.
+         *
+         * @return
+         *     If the statement fails, a description of the problem
+         *     is returned.  Otherwise, an empty string is returned.
+         */
+        std::string Update() {
+            auto& table = *plan_.table;
+            std::vector< size_t > rows;
+            (void)FindRows(rows);
+            for (const auto row: rows) {
+                const auto current = table.GetRow(row);
+                std::vector< Value > values(current, current + table.columns.size());
+                for (size_t i = 0; i < statement_.assignments.size(); ++i) {
+                    values[plan_.columns[i]] = Evaluate(statement_.assignments[i].second);
+                }
+                const auto error = engine_->UpdateRow(table, row, values);
+                if (!error.empty()) {
+                    return error;
+                }
+            }
+            return "";
+        }
+
+        /**
+         * This carries out a DELETE statement.
+         *
+         * @return
+         *     If the statement fails, a description of the problem
+         *     is returned.  Otherwise, an empty string is returned.
+         */
+        std::string Delete() {
+            std::vector< size_t > rows;
+            (void)FindRows(rows);
+            for (const auto row: rows) {
+                engine_->DeleteRow(*plan_.table, row);
+            }
+            return "";
+        }
+
+        /**
+         * This carries out a SELECT statement, finding the rows which
+         * match and putting them in order.
+         *
+         * @return
+         *     If the statement fails, a description of the problem
+         *     is returned.  Otherwise, an empty string is returned.
+         */
+        std::string Select() {
+            rows_.clear();
+            position_ = 0;
+            const auto ordered = FindRows(rows_);
+            if (statement_.countRows) {
+                count_ = rows_.size();
+                return "";
+            }
+            if (plan_.orderBy >= 0) {
+                const auto& table = *plan_.table;
+                const auto column = (size_t)plan_.orderBy;
+                if (!ordered) {
+                    std::stable_sort(
+                        rows_.begin(),
+                        rows_.end(),
+                        [&table, column](size_t lhs, size_t rhs){
+                            return (
+                                table.GetRow(lhs)[column]
+                                < table.GetRow(rhs)[column]
+                            );
+                        }
+                    );
+                }
+                if (statement_.descending) {
+                    std::reverse(rows_.begin(), rows_.end());
+                }
+            }
+            if (statement_.hasLimit) {
+                const auto& limit = Evaluate(statement_.limit);
+                if (limit.GetType() == Value::Type::Integer) {
+                    const auto maxRows = (intmax_t)limit;
+                    if (
+                        (maxRows >= 0)
+                        && ((size_t)maxRows < rows_.size())
+                    ) {
+                        rows_.resize((size_t)maxRows);
+                    }
+                }
+            }
+            return "";
+        }
+
+        // Private Properties
+    private:
+        /**
+         * This is the state of the database, if the reader reads
+         * its tables as they are.
+         */
+        std::shared_ptr< Engine > engine_;
+
+        /**
+         * This is the parsed SQL statement.
+         */
+        Sql::Statement statement_;
+
+        /**
+         * These are the values bound to the statement's parameters.
+         */
+        std::vector< Value > parameters_;
+
+        /**
+         * These are the table and columns the statement refers to.
+         */
+        Plan plan_;
+
+        /**
+         * This flag is set once the statement has been carried out
+         * since it was prepared or last reset.
+         */
+        bool executed_ = false;
+
+        /**
+         * These are the identifiers of the rows found by a query.
+         */
+        std::vector< size_t > rows_;
+
+        /**
+         * This is the position in the query results of the next row.
+         */
+        size_t position_ = 0;
+
+        /**
+         * This is the identifier of the current row of query results.
+         */
+        size_t currentRow_ = 0;
+
+        /**
+         * This flag is set if there is a current row of query results.
+         */
+        bool hasRow_ = false;
+
+        /**
+         * This is the number of rows counted by a COUNT(*) query.
+         */
+        Value count_;
+    };
+
+    /**
+     * This produces a complete snapshot of the database in chunks,
+     * encoding only a few rows at a time.  It either reads the tables
+     * of the database as they are, failing if the database changes
+     * before it's done, or reads copies of the tables captured when
+     * it was made, which don't change and may be read on any thread.
+     */
+    class EngineSnapshotReader
+        : public SnapshotReader
+    {
+        // Lifecycle
+    public:
+        /**
+         * This constructs a reader of the tables of the given database
+         * as they are, which fails if the database changes before
+         * the snapshot is complete.
+         *
+         * @param[in] engine
+         *     This is the state of the database.
+         *
+         * @param[in] chunkSize
+         *     This is the maximum number of bytes in each chunk.
+         */
+        EngineSnapshotReader(
+            const std::shared_ptr< Engine >& engine,
+            size_t chunkSize
+        )
+            : engine_(engine)
+            , chunkSize_(std::max(chunkSize, (size_t)1))
+            , version_(engine->version)
+            , modificationCount_(engine->modificationCount)
+            , schemaGeneration_(engine->schemaGeneration)
+        {
+            tables_.reserve(engine->tables.size());
+            for (const auto& table: engine->tables) {
+                tables_.push_back(table.second.get());
+            }
+            EncodeHeader();
+        }
+
+        /**
+         * This constructs a reader of the given tables captured
+         * from a database.
+         *
+         * @param[in] captured
+         *     These are the copies of the tables of the database,
+         *     in the order of their lower-case names.
+         *
+         * @param[in] version
+         *     This identifies the state of the database captured.
+         *
+         * @param[in] chunkSize
+         *     This is the maximum number of bytes in each chunk.
+         */
+        EngineSnapshotReader(
+            std::vector< std::unique_ptr< Table > >&& captured,
+            uint64_t version,
+            size_t chunkSize
+        )
+            : chunkSize_(std::max(chunkSize, (size_t)1))
+            , version_(version)
+            , captured_(std::move(captured))
+        {
+            tables_.reserve(captured_.size());
+            for (const auto& table: captured_) {
+                tables_.push_back(table.get());
+            }
+            EncodeHeader();
+        }
+
+        // SnapshotReader
+    public:
+        virtual ReadSnapshotChunkResults ReadChunk(Blob& chunk) override {
+            ReadSnapshotChunkResults results;
+            if (
+                (engine_ != nullptr)
+                && (
+                    (engine_->modificationCount != modificationCount_)
+                    || (engine_->schemaGeneration != schemaGeneration_)
+                )
+            ) {
+                chunk.clear();
+                results.error = "database changed while snapshot was being read";
+                return results;
+            }
+            while (
+                (pending_.size() - offset_ < chunkSize_)
+                && EncodeMore()
+            ) {
+            }
+            const auto size = std::min(chunkSize_, pending_.size() - offset_);
+            const auto begin = pending_.begin() + offset_;
+            chunk.assign(begin, begin + size);
+            offset_ += size;
+            if (offset_ == pending_.size()) {
+                pending_.clear();
+                offset_ = 0;
+            }
+            results.done = (size == 0);
+            return results;
+        }
+
+        // Private Methods
+    private:
+        /**
+         * This encodes the start of the snapshot, which comes before
+         * the first table.
+         */
+        void EncodeHeader() {
+            pending_.assign(SNAPSHOT_MAGIC, SNAPSHOT_MAGIC + 4);
+            EncodeVarint(pending_, FORMAT_VERSION);
+            EncodeVarint(pending_, version_);
+            EncodeVarint(pending_, tables_.size());
+        }
+
+        /**
+         * This encodes the next part of the snapshot.
+         *
+         * @return
+         *     An indication of whether or not there was any more
+         *     of the snapshot to encode is returned.
+         */
+        bool EncodeMore() {
+            if (offset_ > 0) {
+                (void)pending_.erase(pending_.begin(), pending_.begin() + offset_);
+                offset_ = 0;
+            }
+            if (nextTable_ == tables_.size()) {
+                return false;
+            }
+            const auto& table = *tables_[nextTable_];
+            if (!tableStarted_) {
+                Engine::EncodeTableSchema(pending_, table);
+                tableStarted_ = true;
+                nextRow_ = 0;
+            }
+            for (
+                size_t rowsEncoded = 0;
+                (rowsEncoded < ROWS_PER_ENCODING_STEP) && (nextRow_ < table.slotCount);
+                ++nextRow_
+            ) {
+                if (table.IsLive(nextRow_)) {
+                    Engine::EncodeRow(pending_, table, nextRow_);
+                    ++rowsEncoded;
+                }
+            }
+            if (nextRow_ == table.slotCount) {
+                ++nextTable_;
+                tableStarted_ = false;
+            }
+            return true;
+        }
+
+        // Private Properties
+    private:
+        /**
+         * This is the state of the database, if the reader reads
+         * its tables as they are.
+         */
+        std::shared_ptr< Engine > engine_;
+
+        /**
+         * This is the maximum number of bytes in each chunk.
+         */
+        size_t chunkSize_;
+
+        /**
+         * This identifies the state of the database being captured.
+         */
+        uint64_t version_;
+
+        /**
+         * This is the number of modifications made to the database
+         * before the snapshot was started.
+         */
+        uint64_t modificationCount_ = 0;
+
+        /**
+         * This is the generation of the schema being captured.
+         */
+        uint64_t schemaGeneration_ = 0;
+
+        /**
+         * These are the copies of the tables of the database, if the
+         * reader reads tables captured from it.
+         */
+        std::vector< std::unique_ptr< Table > > captured_;
+
+        /**
+         * These are the tables to encode, in order.
+         */
+        std::vector< const Table* > tables_;
+
+        /**
+         * This is the position of the next table to encode.
+         */
+        size_t nextTable_ = 0;
+
+        /**
+         * This flag is set if the schema of the next table
+         * has been encoded.
+         */
+        bool tableStarted_ = false;
+
+        /**
+         * This is the identifier of the next row to consider encoding.
+         */
+        size_t nextRow_ = 0;
+
+        /**
+         * This holds encoded parts of the snapshot not yet read.
+         */
+        Blob pending_;
+
+        /**
+         * This is the offset of the first unread byte in the
+         * pending buffer.
+         */
+        size_t offset_ = 0;
+    };
+
+    /**
+     * This accepts a snapshot of an in-memory database one chunk at a
+     * time, decoding each chunk as it arrives, so that only the part of
+     * an element split across chunks is held back for the next one.
+     */
+    class EngineSnapshotWriter
+        : public SnapshotWriter
+    {
+        // Lifecycle
+    public:
+        /**
+         * This constructs a writer of a snapshot into the given database.
+         *
+         * @param[in] engine
+         *     This is the state of the database.
+         */
+        EngineSnapshotWriter(const std::shared_ptr< Engine >& engine)
+            : engine_(engine)
+        {
+        }
+
+        // SnapshotWriter
+    public:
+        virtual std::string WriteChunk(BlobView chunk) override {
+            if (!error_.empty()) {
+                return error_;
+            }
+            auto data = chunk.data;
+            auto size = chunk.size;
+            if (!pending_.empty()) {
+                pending_.insert(pending_.end(), chunk.data, chunk.data + chunk.size);
+                data = pending_.data();
+                size = pending_.size();
+            }
+            size_t consumed;
+            error_ = decoder_.Decode(data, size, consumed);
+            if (!error_.empty()) {
+                Blob().swap(pending_);
+                return error_;
+            }
+            if (pending_.empty()) {
+                pending_.assign(data + consumed, data + size);
+            } else {
+                (void)pending_.erase(pending_.begin(), pending_.begin() + consumed);
+            }
+            return "";
+        }
+
+        virtual std::string Finish() override {
+            if (!error_.empty()) {
+                return error_;
+            }
+            if (!pending_.empty()) {
+                return "invalid snapshot";
+            }
+            return engine_->InstallSnapshot(decoder_);
+        }
+
+        // Private Properties
+    private:
+        /**
+         * This is the state of the database.
+         */
+        std::shared_ptr< Engine > engine_;
+
+        /**
+         * This builds the tables described by the snapshot.
+         */
+        SnapshotDecoder decoder_;
+
+        /**
+         * This holds the start of an element of the snapshot
+         * whose end hasn't arrived yet.
+         */
+        Blob pending_;
+
+        /**
+         * This describes the problem found with the snapshot, if any.
+         */
+        std::string error_;
+    };
+
+}
+
+namespace DatabaseAbstractions {
+
+    struct InMemoryDatabase::Impl {
+        // Properties
+
+        /**
+         * This is the state of the database, which is shared with
+         * the statements prepared for it.
+         */
+        std::shared_ptr< Engine > engine = std::make_shared< Engine >();
+    };
+
+    InMemoryDatabase::~InMemoryDatabase() noexcept = default;
+    InMemoryDatabase::InMemoryDatabase(InMemoryDatabase&&) noexcept = default;
+    InMemoryDatabase& InMemoryDatabase::operator=(InMemoryDatabase&&) noexcept = default;
+
+    InMemoryDatabase::InMemoryDatabase(size_t maxChangeLogSize)
+        : impl_(new Impl())
+    {
+        impl_->engine->maxChangeLogSize = maxChangeLogSize;
+    }
+
+    BuildStatementResults InMemoryDatabase::BuildStatement(
+        const std::string& statement
+    ) {
+        BuildStatementResults results;
+        Sql::Statement parsed;
+        size_t offset = 0;
+        results.error = Sql::Parse(statement, offset, parsed);
+        if (!results.error.empty()) {
+            return results;
+        }
+        if (Sql::HasMoreStatements(statement, offset)) {
+            results.error = "only one statement may be prepared at a time";
+            return results;
+        }
+        results.statement = std::make_shared< Statement >(impl_->engine, std::move(parsed));
+        return results;
+    }
+
+    std::string InMemoryDatabase::ExecuteStatement(const std::string& statement) {
+        size_t offset = 0;
+        while (Sql::HasMoreStatements(statement, offset)) {
+            Sql::Statement parsed;
+            auto error = Sql::Parse(statement, offset, parsed);
+            if (!error.empty()) {
+                return error;
+            }
+            Statement prepared(impl_->engine, std::move(parsed));
+            error = prepared.Execute();
+            if (!error.empty()) {
+                return error;
+            }
+        }
+        return "";
+    }
+
+    std::string InMemoryDatabase::BeginTransaction() {
+        return impl_->engine->BeginTransaction();
+    }
+
+    std::string InMemoryDatabase::CommitTransaction() {
+        return impl_->engine->CommitTransaction();
+    }
+
+    std::string InMemoryDatabase::RollbackTransaction() {
+        return impl_->engine->RollbackTransaction();
+    }
+
+    Blob InMemoryDatabase::CreateSnapshot() {
+        Blob snapshot;
+        Blob chunk;
+        const auto reader = InMemoryDatabase::CreateSnapshotReader(65536);
+        while (!reader->ReadChunk(chunk).done) {
+            snapshot.insert(snapshot.end(), chunk.begin(), chunk.end());
+        }
+        return snapshot;
+    }
+
+    std::string InMemoryDatabase::InstallSnapshot(const Blob& blob) {
+        return impl_->engine->InstallSnapshot(blob);
+    }
+
+    std::shared_ptr< SnapshotReader > InMemoryDatabase::CreateSnapshotReader(size_t chunkSize) {
+        if (impl_->engine->inTransaction) {
+            return CaptureSnapshot(chunkSize);
+        }
+        return std::make_shared< EngineSnapshotReader >(impl_->engine, chunkSize);
+    }
+
+    std::shared_ptr< SnapshotWriter > InMemoryDatabase::CreateSnapshotWriter() {
+        return std::make_shared< EngineSnapshotWriter >(impl_->engine);
+    }
+
+    std::shared_ptr< SnapshotReader > InMemoryDatabase::CaptureSnapshot(size_t chunkSize) {
+        const auto& engine = *impl_->engine;
+        return std::make_shared< EngineSnapshotReader >(
+            engine.CaptureCommittedTables(),
+            engine.version,
+            chunkSize
+        );
+    }
+
+    uint64_t InMemoryDatabase::GetSnapshotId() {
+        return impl_->engine->version;
+    }
+
+    DeltaSnapshot InMemoryDatabase::CreateDeltaSnapshot(uint64_t baseId) {
+        const auto& engine = *impl_->engine;
+        DeltaSnapshot snapshot;
+        snapshot.id = engine.version;
+        if (
+            (baseId == 0)
+            || (baseId < engine.oldestDeltaBase)
+            || (baseId > engine.version)
+        ) {
+            snapshot.blob = CreateSnapshot();
+        } else {
+            snapshot.full = false;
+            snapshot.baseId = baseId;
+            snapshot.blob = engine.EncodeDelta(baseId);
+        }
+        return snapshot;
+    }
+
+    std::string InMemoryDatabase::InstallDeltaSnapshot(const DeltaSnapshot& snapshot) {
+        auto& engine = *impl_->engine;
+        if (snapshot.full) {
+            return engine.InstallSnapshot(snapshot.blob);
+        }
+        if (engine.inTransaction) {
+            return "cannot install a snapshot during a transaction";
+        }
+        if (snapshot.baseId != engine.version) {
+            return "delta snapshot base does not match database state";
+        }
+        std::vector< Change > deltaChanges;
+        if (!Engine::DecodeDelta(snapshot.blob, deltaChanges)) {
+            return "invalid delta snapshot";
+        }
+        const auto savepoint = engine.Begin();
+        for (auto& change: deltaChanges) {
+            engine.version = change.version - 1;
+            const auto error = engine.ApplyChange(change);
+            if (!error.empty()) {
+                engine.Rollback(savepoint);
+                engine.version = snapshot.baseId;
+                return error;
+            }
+        }
+        engine.version = snapshot.baseId;
+        engine.Commit(savepoint);
+        engine.version = snapshot.id;
+        return "";
+    }
+
+}
@@ -0,0 +1,906 @@
+/**
+ * @file InstrumentedDatabase.cpp
+ *
+ * This file contains the implementation
+ * of the DatabaseAbstractions::InstrumentedDatabase class.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <DatabaseAbstractions/InstrumentedDatabase.hpp>
+#include <math.h>
+#include <mutex>
+#include <string.h>
+#include <unordered_map>
+
+namespace {
+
+    using namespace DatabaseAbstractions;
+
+    /**
+     * This is the number of bits of each duration, after its most
+     * significant bit, used to pick its bucket in a histogram.
+     */
+    constexpr unsigned int SUB_BUCKET_BITS = 3;
+
+    /**
+     * This is the number of buckets for each power of two.
+     */
+    constexpr uint64_t SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+
+    /**
+     * This is the base-two logarithm of the longest duration, in
+     * nanoseconds, which a histogram tells apart from longer ones
+     * (about 36 minutes).
+     */
+    constexpr unsigned int MAX_EXPONENT = 41;
+
+    /**
+     * This is the number of buckets in a histogram.
+     */
+    constexpr size_t BUCKET_COUNT = (MAX_EXPONENT - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+    /**
+     * This returns the position of the most significant bit
+     * of the given value, which must not be zero.
+     *
+     * @param[in] value
+     *     This is the value whose most significant bit to find.
+     *
+     * @return
+     *     The position of the most significant bit of the value
+     *     is returned.
+     */
+    unsigned int FloorLog2(uint64_t value) {
+        unsigned int log = 0;
+        for (unsigned int shift = 32; shift > 0; shift /= 2) {
+            if ((value >> shift) != 0) {
+                value >>= shift;
+                log += shift;
+            }
+        }
+        return log;
+    }
+
+    /**
+     * This returns the index of the histogram bucket into which
+     * the given duration falls.
+     *
+     * @param[in] nanoseconds
+     *     This is the duration to place in a bucket.
+     *
+     * @return
+     *     The index of the bucket is returned.
+     */
+    size_t BucketIndex(uint64_t nanoseconds) {
+        if (nanoseconds < SUB_BUCKETS) {
+            return (size_t)nanoseconds;
+        }
+        const auto exponent = FloorLog2(nanoseconds);
+        const auto subBucket = (nanoseconds >> (exponent - SUB_BUCKET_BITS)) - SUB_BUCKETS;
+        const auto index = (size_t)((exponent - SUB_BUCKET_BITS + 1) * SUB_BUCKETS + subBucket);
+        return std::min(index, BUCKET_COUNT - 1);
+    }
+
+    /**
+     * This measures how much time passes after it's constructed.
+     */
+    class Stopwatch {
+        // Methods
+    public:
+        /**
+         * This returns the time passed since the stopwatch was
+         * constructed.
+         *
+         * @return
+         *     The time passed, in nanoseconds, is returned.
+         */
+        uint64_t GetElapsed() const {
+            return (uint64_t)std::chrono::duration_cast< std::chrono::nanoseconds >(
+                std::chrono::steady_clock::now() - start_
+            ).count();
+        }
+
+        // Private Properties
+    private:
+        /**
+         * This is the time at which the stopwatch was constructed.
+         */
+        std::chrono::steady_clock::time_point start_ = std::chrono::steady_clock::now();
+    };
+
+    /**
+     * This counts durations of operations, both in total and by
+     * histogram bucket.  It may be updated by several threads at once.
+     */
+    class Histogram {
+        // Lifecycle
+    public:
+        Histogram() {
+            for (auto& bucket: buckets_) {
+                bucket.store(0, std::memory_order_relaxed);
+            }
+        }
+
+        // Methods
+    public:
+        /**
+         * This counts one operation which took the given time.
+         *
+         * @param[in] nanoseconds
+         *     This is how long the operation took.
+         */
+        void Record(uint64_t nanoseconds) {
+            (void)buckets_[BucketIndex(nanoseconds)].fetch_add(1, std::memory_order_relaxed);
+            (void)count_.fetch_add(1, std::memory_order_relaxed);
+            (void)total_.fetch_add(nanoseconds, std::memory_order_relaxed);
+            auto max = max_.load(std::memory_order_relaxed);
+            while (
+                (nanoseconds > max)
+                && !max_.compare_exchange_weak(max, nanoseconds, std::memory_order_relaxed)
+            ) {
+            }
+        }
+
+        /**
+         * This returns a copy of the counts.
+         *
+         * @return
+         *     A copy of the counts is returned.
+         */
+        LatencyStatistics Get() const {
+            LatencyStatistics statistics;
+            statistics.count = count_.load(std::memory_order_relaxed);
+            statistics.totalNanoseconds = total_.load(std::memory_order_relaxed);
+            statistics.maxNanoseconds = max_.load(std::memory_order_relaxed);
+            statistics.buckets.reserve(BUCKET_COUNT);
+            for (const auto& bucket: buckets_) {
+                statistics.buckets.push_back(bucket.load(std::memory_order_relaxed));
+            }
+            return statistics;
+        }
+
+        // Private Properties
+    private:
+        /**
+         * This is the number of operations counted.
+         */
+        std::atomic< uint64_t > count_{0};
+
+        /**
+         * This is the total duration of the operations counted.
+         */
+        std::atomic< uint64_t > total_{0};
+
+        /**
+         * This is the longest duration of any operation counted.
+         */
+        std::atomic< uint64_t > max_{0};
+
+        /**
+         * These are the numbers of operations counted in each bucket.
+         */
+        std::atomic< uint64_t > buckets_[BUCKET_COUNT];
+    };
+
+    /**
+     * This holds the measurements made for one SQL text.
+     */
+    struct StatementCounters {
+        std::string text;
+        bool other = false;
+        Histogram build;
+        Histogram execute;
+        Histogram step;
+        Histogram fetch;
+        std::atomic< uint64_t > errors{0};
+        std::atomic< uint64_t > rows{0};
+        std::atomic< uint64_t > bytesFetched{0};
+
+        /**
+         * This counts an error, if the given error message isn't empty.
+         *
+         * @param[in] error
+         *     This is the error message, if any, to count.
+         */
+        void CountError(const std::string& error) {
+            if (!error.empty()) {
+                (void)errors.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+
+        /**
+         * This returns a copy of the measurements.
+         *
+         * @return
+         *     A copy of the measurements is returned.
+         */
+        StatementMetrics Get() const {
+            StatementMetrics metrics;
+            metrics.text = text;
+            metrics.other = other;
+            metrics.build = build.Get();
+            metrics.execute = execute.Get();
+            metrics.step = step.Get();
+            metrics.fetch = fetch.Get();
+            metrics.errors = errors.load(std::memory_order_relaxed);
+            metrics.rows = rows.load(std::memory_order_relaxed);
+            metrics.bytesFetched = bytesFetched.load(std::memory_order_relaxed);
+            return metrics;
+        }
+    };
+
+    /**
+     * This holds the measurements made of snapshots made or installed.
+     */
+    struct SnapshotCounters {
+        Histogram duration;
+        std::atomic< uint64_t > snapshots{0};
+        std::atomic< uint64_t > bytes{0};
+
+        /**
+         * This counts a piece of a snapshot.
+         *
+         * @param[in] nanoseconds
+         *     This is how long it took to make or install the piece.
+         *
+         * @param[in] size
+         *     This is the number of bytes in the piece.
+         *
+         * @param[in] complete
+         *     This indicates whether or not the piece completes
+         *     a snapshot.
+         */
+        void Count(
+            uint64_t nanoseconds,
+            size_t size,
+            bool complete
+        ) {
+            duration.Record(nanoseconds);
+            (void)bytes.fetch_add(size, std::memory_order_relaxed);
+            if (complete) {
+                (void)snapshots.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+
+        /**
+         * This returns a copy of the measurements.
+         *
+         * @return
+         *     A copy of the measurements is returned.
+         */
+        SnapshotMetrics Get() const {
+            SnapshotMetrics metrics;
+            metrics.duration = duration.Get();
+            metrics.snapshots = snapshots.load(std::memory_order_relaxed);
+            metrics.bytes = bytes.load(std::memory_order_relaxed);
+            return metrics;
+        }
+    };
+
+    /**
+     * This holds all the measurements made by an instrumented database.
+     */
+    struct Counters {
+        // Properties
+
+        /**
+         * This is used to synchronize access to the statement counters.
+         */
+        std::mutex mutex;
+
+        /**
+         * These are the measurements made for each SQL text.
+         */
+        std::unordered_map< std::string, std::shared_ptr< StatementCounters > > statements;
+
+        /**
+         * This is the number of SQL texts to measure separately.
+         */
+        size_t maxStatements = DEFAULT_MAX_MEASURED_STATEMENTS;
+
+        /**
+         * These are the measurements made for all SQL texts first used
+         * once the limit on SQL texts measured separately was reached.
+         * They're made only when first needed.
+         */
+        std::shared_ptr< StatementCounters > otherStatements;
+
+        Histogram writeBatches;
+        SnapshotCounters snapshotsCreated;
+        SnapshotCounters snapshotsInstalled;
+
+        // Methods
+
+        /**
+         * This returns the measurements for the given SQL text,
+         * adding them if they don't exist yet, or the measurements
+         * for all other SQL texts if there are already as many SQL
+         * texts measured separately as allowed.
+         *
+         * @param[in] text
+         *     This is the SQL text whose measurements to return.
+         *
+         * @return
+         *     The measurements for the SQL text are returned.
+         */
+        std::shared_ptr< StatementCounters > GetStatement(const std::string& text) {
+            std::lock_guard< decltype(mutex) > lock(mutex);
+            const auto existing = statements.find(text);
+            if (existing != statements.end()) {
+                return existing->second;
+            }
+            if (statements.size() < maxStatements) {
+                auto& statement = statements[text];
+                statement = std::make_shared< StatementCounters >();
+                statement->text = text;
+                return statement;
+            }
+            if (otherStatements == nullptr) {
+                otherStatements = std::make_shared< StatementCounters >();
+                otherStatements->other = true;
+            }
+            return otherStatements;
+        }
+    };
+
+    /**
+     * This returns the number of bytes of text or binary data
+     * in the given value.
+     *
+     * @param[in] value
+     *     This is the value to measure.
+     *
+     * @return
+     *     The number of bytes of text or binary data in the value
+     *     is returned.
+     */
+    size_t GetDataSize(const Value& value) {
+        switch (value.GetType()) {
+            case Value::Type::Text: return strlen((const char*)value);
+            case Value::Type::Blob: return ((BlobView)value).size;
+            default: return 0;
+        }
+    }
+
+    /**
+     * This is a statement which measures how another statement is used.
+     */
+    class InstrumentedStatement
+        : public PreparedStatement
+    {
+        // Lifecycle
+    public:
+        InstrumentedStatement(
+            std::shared_ptr< PreparedStatement > statement,
+            std::shared_ptr< StatementCounters > counters
+        )
+            : statement_(statement)
+            , counters_(counters)
+        {
+        }
+
+        // PreparedStatement
+    public:
+        virtual void BindParameter(
+            int index,
+            const Value& value
+        ) override {
+            statement_->BindParameter(index, value);
+        }
+
+        virtual void BindParameter(
+            int index,
+            Value&& value
+        ) override {
+            statement_->BindParameter(index, std::move(value));
+        }
+
+        virtual void BindParameters(std::initializer_list< const Value > values) override {
+            statement_->BindParameters(values);
+        }
+
+        virtual void BindParameters(std::vector< Value >&& values) override {
+            statement_->BindParameters(std::move(values));
+        }
+
+        virtual Value FetchColumn(int index, Value::Type type) override {
+            const Stopwatch stopwatch;
+            auto value = statement_->FetchColumn(index, type);
+            CountFetch(stopwatch.GetElapsed(), value);
+            return value;
+        }
+
+        virtual void FetchColumn(
+            int index,
+            Value::Type type,
+            Value& value
+        ) override {
+            const Stopwatch stopwatch;
+            statement_->FetchColumn(index, type, value);
+            CountFetch(stopwatch.GetElapsed(), value);
+        }
+
+        virtual void Reset() override {
+            statement_->Reset();
+        }
+
+        virtual StepStatementResults Step() override {
+            const Stopwatch stopwatch;
+            const auto results = statement_->Step();
+            CountStep(stopwatch.GetElapsed(), results);
+            return results;
+        }
+
+        virtual StepStatementResults StepBatch(
+            size_t maxRows,
+            RowBatch& batch
+        ) override {
+            const Stopwatch stopwatch;
+            const auto results = statement_->StepBatch(maxRows, batch);
+            counters_->step.Record(stopwatch.GetElapsed());
+            counters_->CountError(results.error);
+            const auto rowCount = batch.GetRowCount();
+            size_t bytes = 0;
+            for (size_t column = 0; column < batch.GetColumnCount(); ++column) {
+                const auto type = batch.GetColumnType(column);
+                if (
+                    (type != Value::Type::Text)
+                    && (type != Value::Type::Blob)
+                ) {
+                    continue;
+                }
+                const auto values = batch.GetColumn(column);
+                for (size_t row = 0; row < rowCount; ++row) {
+                    bytes += GetDataSize(values[row]);
+                }
+            }
+            (void)counters_->rows.fetch_add(rowCount, std::memory_order_relaxed);
+            (void)counters_->bytesFetched.fetch_add(bytes, std::memory_order_relaxed);
+            return results;
+        }
+
+        virtual void StepAsync(StepStatementCallback callback) override {
+            const auto counters = counters_;
+            const auto stopwatch = Stopwatch();
+            statement_->StepAsync(
+                [counters, stopwatch, callback](const StepStatementResults& results){
+                    CountStep(counters, stopwatch.GetElapsed(), results);
+                    callback(results);
+                }
+            );
+        }
+
+        // Private Methods
+    private:
+        /**
+         * This counts one step of a statement.
+         *
+         * @param[in] counters
+         *     These are the measurements to update.
+         *
+         * @param[in] nanoseconds
+         *     This is how long the step took.
+         *
+         * @param[in] results
+         *     These are the results of the step.
+         */
+        static void CountStep(
+            const std::shared_ptr< StatementCounters >& counters,
+            uint64_t nanoseconds,
+            const StepStatementResults& results
+        ) {
+            counters->step.Record(nanoseconds);
+            counters->CountError(results.error);
+            if (
+                !results.done
+                && results.error.empty()
+            ) {
+                (void)counters->rows.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+
+        void CountStep(
+            uint64_t nanoseconds,
+            const StepStatementResults& results
+        ) {
+            CountStep(counters_, nanoseconds, results);
+        }
+
+        /**
+         * This counts one fetch of a column.
+         *
+         * @param[in] nanoseconds
+         *     This is how long the fetch took.
+         *
+         * @param[in] value
+         *     This is the value fetched.
+         */
+        void CountFetch(
+            uint64_t nanoseconds,
+            const Value& value
+        ) {
+            counters_->fetch.Record(nanoseconds);
+            (void)counters_->bytesFetched.fetch_add(
+                GetDataSize(value),
+                std::memory_order_relaxed
+            );
+        }
+
+        // Private Properties
+    private:
+        /**
+         * This is the statement being measured.
+         */
+        std::shared_ptr< PreparedStatement > statement_;
+
+        /**
+         * These are the measurements for the SQL text of the statement.
+         */
+        std::shared_ptr< StatementCounters > counters_;
+    };
+
+    /**
+     * This is a snapshot reader which measures another reader.
+     */
+    class InstrumentedSnapshotReader
+        : public SnapshotReader
+    {
+        // Lifecycle
+    public:
+        InstrumentedSnapshotReader(
+            std::shared_ptr< SnapshotReader > reader,
+            std::shared_ptr< Counters > counters
+        )
+            : reader_(reader)
+            , counters_(counters)
+        {
+        }
+
+        // SnapshotReader
+    public:
+        virtual ReadSnapshotChunkResults ReadChunk(Blob& chunk) override {
+            const Stopwatch stopwatch;
+            const auto results = reader_->ReadChunk(chunk);
+            const auto complete = (results.done && !done_);
+            done_ = done_ || results.done;
+            counters_->snapshotsCreated.Count(
+                stopwatch.GetElapsed(),
+                chunk.size(),
+                complete
+            );
+            return results;
+        }
+
+        // Private Properties
+    private:
+        /**
+         * This is the reader being measured.
+         */
+        std::shared_ptr< SnapshotReader > reader_;
+
+        /**
+         * These are the measurements to update.
+         */
+        std::shared_ptr< Counters > counters_;
+
+        /**
+         * This flag is set once the reader has produced every chunk.
+         */
+        bool done_ = false;
+    };
+
+    /**
+     * This is a snapshot writer which measures another writer.
+     */
+    class InstrumentedSnapshotWriter
+        : public SnapshotWriter
+    {
+        // Lifecycle
+    public:
+        InstrumentedSnapshotWriter(
+            std::shared_ptr< SnapshotWriter > writer,
+            std::shared_ptr< Counters > counters
+        )
+            : writer_(writer)
+            , counters_(counters)
+        {
+        }
+
+        // SnapshotWriter
+    public:
+        virtual std::string WriteChunk(BlobView chunk) override {
+            const Stopwatch stopwatch;
+            const auto error = writer_->WriteChunk(chunk);
+            counters_->snapshotsInstalled.Count(
+                stopwatch.GetElapsed(),
+                chunk.size,
+                false
+            );
+            return error;
+        }
+
+        virtual std::string Finish() override {
+            const Stopwatch stopwatch;
+            const auto error = writer_->Finish();
+            counters_->snapshotsInstalled.Count(
+                stopwatch.GetElapsed(),
+                0,
+                error.empty()
+            );
+            return error;
+        }
+
+        // Private Properties
+    private:
+        /**
+         * This is the writer being measured.
+         */
+        std::shared_ptr< SnapshotWriter > writer_;
+
+        /**
+         * These are the measurements to update.
+         */
+        std::shared_ptr< Counters > counters_;
+    };
+
+}
+
+namespace DatabaseAbstractions {
+
+    uint64_t LatencyStatistics::GetBucketLowerBound(size_t bucket) {
+        if (bucket < SUB_BUCKETS) {
+            return (uint64_t)bucket;
+        }
+        const auto exponent = (unsigned int)(bucket / SUB_BUCKETS) + SUB_BUCKET_BITS - 1;
+        const auto subBucket = (uint64_t)(bucket % SUB_BUCKETS);
+        return (SUB_BUCKETS + subBucket) << (exponent - SUB_BUCKET_BITS);
+    }
+
+    uint64_t LatencyStatistics::GetPercentile(double fraction) const {
+        if (count == 0) {
+            return 0;
+        }
+        const auto target = std::min(
+            count,
+            std::max(
+                (uint64_t)1,
+                (uint64_t)ceil(fraction * (double)count)
+            )
+        );
+        uint64_t seen = 0;
+        for (size_t bucket = 0; bucket < buckets.size(); ++bucket) {
+            seen += buckets[bucket];
+            if (seen >= target) {
+                if (bucket + 1 >= buckets.size()) {
+                    return maxNanoseconds;
+                }
+                return std::min(
+                    maxNanoseconds,
+                    GetBucketLowerBound(bucket + 1) - 1
+                );
+            }
+        }
+        return maxNanoseconds;
+    }
+
+    struct InstrumentedDatabase::Impl {
+        // Properties
+
+        /**
+         * This is the database being wrapped.
+         */
+        std::shared_ptr< Database > database;
+
+        /**
+         * These are the measurements made so far.
+         */
+        std::shared_ptr< Counters > counters = std::make_shared< Counters >();
+    };
+
+    InstrumentedDatabase::~InstrumentedDatabase() noexcept = default;
+    InstrumentedDatabase::InstrumentedDatabase(InstrumentedDatabase&&) noexcept = default;
+    InstrumentedDatabase& InstrumentedDatabase::operator=(InstrumentedDatabase&&) noexcept = default;
+
+    InstrumentedDatabase::InstrumentedDatabase(
+        std::shared_ptr< Database > database,
+        size_t maxStatements
+    )
+        : impl_(new Impl())
+    {
+        impl_->database = database;
+        impl_->counters->maxStatements = maxStatements;
+    }
+
+    DatabaseMetrics InstrumentedDatabase::GetMetrics() const {
+        DatabaseMetrics metrics;
+        const auto& counters = impl_->counters;
+        std::vector< std::shared_ptr< StatementCounters > > statements;
+        {
+            std::lock_guard< decltype(counters->mutex) > lock(counters->mutex);
+            statements.reserve(counters->statements.size() + 1);
+            for (const auto& statement: counters->statements) {
+                statements.push_back(statement.second);
+            }
+            if (counters->otherStatements != nullptr) {
+                statements.push_back(counters->otherStatements);
+            }
+        }
+        metrics.statements.reserve(statements.size());
+        for (const auto& statement: statements) {
+            metrics.statements.push_back(statement->Get());
+        }
+        metrics.writeBatches = counters->writeBatches.Get();
+        metrics.snapshotsCreated = counters->snapshotsCreated.Get();
+        metrics.snapshotsInstalled = counters->snapshotsInstalled.Get();
+        return metrics;
+    }
+
+    BuildStatementResults InstrumentedDatabase::BuildStatement(
+        const std::string& statement
+    ) {
+        const auto counters = impl_->counters->GetStatement(statement);
+        const Stopwatch stopwatch;
+        auto results = impl_->database->BuildStatement(statement);
+        counters->build.Record(stopwatch.GetElapsed());
+        counters->CountError(results.error);
+        if (results.statement != nullptr) {
+            results.statement = std::make_shared< InstrumentedStatement >(
+                results.statement,
+                counters
+            );
+        }
+        return results;
+    }
+
+    std::string InstrumentedDatabase::ExecuteStatement(const std::string& statement) {
+        const auto counters = impl_->counters->GetStatement(statement);
+        const Stopwatch stopwatch;
+        const auto error = impl_->database->ExecuteStatement(statement);
+        counters->execute.Record(stopwatch.GetElapsed());
+        counters->CountError(error);
+        return error;
+    }
+
+    std::string InstrumentedDatabase::BeginTransaction() {
+        return impl_->database->BeginTransaction();
+    }
+
+    std::string InstrumentedDatabase::CommitTransaction() {
+        return impl_->database->CommitTransaction();
+    }
+
+    std::string InstrumentedDatabase::RollbackTransaction() {
+        return impl_->database->RollbackTransaction();
+    }
+
+    std::string InstrumentedDatabase::ApplyWriteBatch(const WriteBatch& batch) {
+        const Stopwatch stopwatch;
+        const auto error = impl_->database->ApplyWriteBatch(batch);
+        impl_->counters->writeBatches.Record(stopwatch.GetElapsed());
+        return error;
+    }
+
+    void InstrumentedDatabase::BuildStatementAsync(
+        const std::string& statement,
+        BuildStatementCallback callback
+    ) {
+        const auto counters = impl_->counters->GetStatement(statement);
+        const auto stopwatch = Stopwatch();
+        impl_->database->BuildStatementAsync(
+            statement,
+            [counters, stopwatch, callback](const BuildStatementResults& results){
+                counters->build.Record(stopwatch.GetElapsed());
+                counters->CountError(results.error);
+                if (results.statement == nullptr) {
+                    callback(results);
+                    return;
+                }
+                BuildStatementResults instrumentedResults;
+                instrumentedResults.statement = std::make_shared< InstrumentedStatement >(
+                    results.statement,
+                    counters
+                );
+                callback(instrumentedResults);
+            }
+        );
+    }
+
+    void InstrumentedDatabase::ExecuteAsync(
+        const std::string& statement,
+        CompletionCallback callback
+    ) {
+        const auto counters = impl_->counters->GetStatement(statement);
+        const auto stopwatch = Stopwatch();
+        impl_->database->ExecuteAsync(
+            statement,
+            [counters, stopwatch, callback](const std::string& error){
+                counters->execute.Record(stopwatch.GetElapsed());
+                counters->CountError(error);
+                callback(error);
+            }
+        );
+    }
+
+    void InstrumentedDatabase::ApplyWriteBatchAsync(
+        WriteBatch&& batch,
+        CompletionCallback callback
+    ) {
+        const auto counters = impl_->counters;
+        const auto stopwatch = Stopwatch();
+        impl_->database->ApplyWriteBatchAsync(
+            std::move(batch),
+            [counters, stopwatch, callback](const std::string& error){
+                counters->writeBatches.Record(stopwatch.GetElapsed());
+                callback(error);
+            }
+        );
+    }
+
+    Blob InstrumentedDatabase::CreateSnapshot() {
+        const Stopwatch stopwatch;
+        auto blob = impl_->database->CreateSnapshot();
+        impl_->counters->snapshotsCreated.Count(stopwatch.GetElapsed(), blob.size(), true);
+        return blob;
+    }
+
+    std::string InstrumentedDatabase::InstallSnapshot(const Blob& blob) {
+        const Stopwatch stopwatch;
+        const auto error = impl_->database->InstallSnapshot(blob);
+        impl_->counters->snapshotsInstalled.Count(
+            stopwatch.GetElapsed(),
+            blob.size(),
+            error.empty()
+        );
+        return error;
+    }
+
+    std::shared_ptr< SnapshotReader > InstrumentedDatabase::CreateSnapshotReader(size_t chunkSize) {
+        return std::make_shared< InstrumentedSnapshotReader >(
+            impl_->database->CreateSnapshotReader(chunkSize),
+            impl_->counters
+        );
+    }
+
+    std::shared_ptr< SnapshotReader > InstrumentedDatabase::CaptureSnapshot(size_t chunkSize) {
+        return std::make_shared< InstrumentedSnapshotReader >(
+            impl_->database->CaptureSnapshot(chunkSize),
+            impl_->counters
+        );
+    }
+
+    std::shared_ptr< SnapshotWriter > InstrumentedDatabase::CreateSnapshotWriter() {
+        return std::make_shared< InstrumentedSnapshotWriter >(
+            impl_->database->CreateSnapshotWriter(),
+            impl_->counters
+        );
+    }
+
+    uint64_t InstrumentedDatabase::GetSnapshotId() {
+        return impl_->database->GetSnapshotId();
+    }
+
+    DeltaSnapshot InstrumentedDatabase::CreateDeltaSnapshot(uint64_t baseId) {
+        const Stopwatch stopwatch;
+        auto snapshot = impl_->database->CreateDeltaSnapshot(baseId);
+        impl_->counters->snapshotsCreated.Count(
+            stopwatch.GetElapsed(),
+            snapshot.blob.size(),
+            snapshot.error.empty()
+        );
+        return snapshot;
+    }
+
+    std::string InstrumentedDatabase::InstallDeltaSnapshot(const DeltaSnapshot& snapshot) {
+        const Stopwatch stopwatch;
+        const auto error = impl_->database->InstallDeltaSnapshot(snapshot);
+        impl_->counters->snapshotsInstalled.Count(
+            stopwatch.GetElapsed(),
+            snapshot.blob.size(),
+            error.empty()
+        );
+        return error;
+    }
+
+}
@@ -0,0 +1,168 @@
+/**
+ * @file MappedFile.cpp
+ *
+ * This module contains the implementation
+ * of the DatabaseAbstractions::MappedFile class.
+ */
+
+#include "MappedFile.hpp"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#else /* POSIX */
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif /* _WIN32 / POSIX */
+
+namespace DatabaseAbstractions {
+
+    struct MappedFile::Impl {
+        // Properties
+
+        /**
+         * This points to the mapped contents of the file.
+         */
+        const uint8_t* data = nullptr;
+
+        /**
+         * This is the number of bytes mapped.
+         */
+        size_t size = 0;
+
+#ifdef _WIN32
+        /**
+         * This is the handle of the file mapping object.
+         */
+        HANDLE mapping = NULL;
+#endif /* _WIN32 */
+    };
+
+    MappedFile::~MappedFile() noexcept {
+        if (impl_ != nullptr) {
+            Close();
+        }
+    }
+
+    MappedFile::MappedFile(MappedFile&&) noexcept = default;
+
+    MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+        if (this != &other) {
+            if (impl_ != nullptr) {
+                Close();
+            }
+            impl_ = std::move(other.impl_);
+        }
+        return *this;
+    }
+
+    MappedFile::MappedFile()
+        : impl_(new Impl())
+    {
+    }
+
+#ifdef _WIN32
+
+    std::string MappedFile::Open(const std::string& path) {
+        Close();
+        const auto file = CreateFileA(
+            path.c_str(),
+            GENERIC_READ,
+            FILE_SHARE_READ,
+            NULL,
+            OPEN_EXISTING,
+            FILE_FLAG_SEQUENTIAL_SCAN,
+            NULL
+        );
+        if (file == INVALID_HANDLE_VALUE) {
+            return "unable to open file '" + path + "'";
+        }
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file, &size)) {
+            (void)CloseHandle(file);
+            return "unable to determine size of file '" + path + "'";
+        }
+        if (size.QuadPart == 0) {
+            (void)CloseHandle(file);
+            return "";
+        }
+        impl_->mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+        (void)CloseHandle(file);
+        if (impl_->mapping == NULL) {
+            return "unable to map file '" + path + "'";
+        }
+        impl_->data = (const uint8_t*)MapViewOfFile(impl_->mapping, FILE_MAP_READ, 0, 0, 0);
+        if (impl_->data == nullptr) {
+            (void)CloseHandle(impl_->mapping);
+            impl_->mapping = NULL;
+            return "unable to map file '" + path + "'";
+        }
+        impl_->size = (size_t)size.QuadPart;
+        return "";
+    }
+
+    void MappedFile::Close() {
+        if (impl_->data != nullptr) {
+            (void)UnmapViewOfFile(impl_->data);
+            impl_->data = nullptr;
+        }
+        if (impl_->mapping != NULL) {
+            (void)CloseHandle(impl_->mapping);
+            impl_->mapping = NULL;
+        }
+        impl_->size = 0;
+    }
+
+#else /* POSIX */
+
+    std::string MappedFile::Open(const std::string& path) {
+        Close();
+        const auto file = open(path.c_str(), O_RDONLY);
+        if (file < 0) {
+            return "unable to open file '" + path + "': " + strerror(errno);
+        }
+        struct stat status;
+        if (fstat(file, &status) != 0) {
+            const auto error = errno;
+            (void)close(file);
+            return "unable to determine size of file '" + path + "': " + strerror(error);
+        }
+        if (status.st_size == 0) {
+            (void)close(file);
+            return "";
+        }
+        const auto data = mmap(nullptr, (size_t)status.st_size, PROT_READ, MAP_SHARED, file, 0);
+        const auto error = errno;
+        (void)close(file);
+        if (data == MAP_FAILED) {
+            return "unable to map file '" + path + "': " + strerror(error);
+        }
+        (void)madvise(data, (size_t)status.st_size, MADV_SEQUENTIAL);
+        impl_->data = (const uint8_t*)data;
+        impl_->size = (size_t)status.st_size;
+        return "";
+    }
+
+    void MappedFile::Close() {
+        if (impl_->data != nullptr) {
+            (void)munmap((void*)impl_->data, impl_->size);
+            impl_->data = nullptr;
+        }
+        impl_->size = 0;
+    }
+
+#endif /* _WIN32 / POSIX */
+
+    const uint8_t* MappedFile::GetData() const {
+        return impl_->data;
+    }
+
+    size_t MappedFile::GetSize() const {
+        return impl_->size;
+    }
+
+}
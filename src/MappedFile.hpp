@@ -0,0 +1,87 @@
+#pragma once
+
+/**
+ * @file MappedFile.hpp
+ *
+ * This module declares the DatabaseAbstractions::MappedFile class,
+ * which maps the contents of a file into memory for reading.
+ */
+
+#include <memory>
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+
+namespace DatabaseAbstractions {
+
+    /**
+     * This maps the complete contents of a file into memory, read-only,
+     * so that it can be accessed without copying it into a buffer.
+     * The mapping is removed when the object is destroyed.
+     */
+    class MappedFile {
+        // Lifecycle
+    public:
+        ~MappedFile() noexcept;
+        MappedFile(const MappedFile&) = delete;
+        MappedFile(MappedFile&&) noexcept;
+        MappedFile& operator=(const MappedFile&) = delete;
+        MappedFile& operator=(MappedFile&&) noexcept;
+
+        // Construction
+    public:
+        MappedFile();
+
+        // Methods
+    public:
+        /**
+         * This maps the given file into memory, replacing any mapping
+         * previously made by the object.
+         *
+         * @param[in] path
+         *     This is the path to the file to map.
+         *
+         * @return
+         *     If an error occurs, a description of the error is returned.
+         *     Otherwise, an empty string is returned.
+         */
+        std::string Open(const std::string& path);
+
+        /**
+         * This removes any mapping made by the object.
+         */
+        void Close();
+
+        /**
+         * This returns a pointer to the mapped contents of the file.
+         *
+         * @return
+         *     A pointer to the mapped contents of the file is returned.
+         *     This is null if the file is empty or not mapped.
+         */
+        const uint8_t* GetData() const;
+
+        /**
+         * This returns the size of the mapped file.
+         *
+         * @return
+         *     The number of bytes mapped is returned.
+         */
+        size_t GetSize() const;
+
+        // Private Properties
+    private:
+        /**
+         * This is the type of structure that contains the private
+         * properties of the instance.  It is defined in the implementation
+         * and declared here to ensure that it is scoped inside the class.
+         */
+        struct Impl;
+
+        /**
+         * This contains the private properties of the instance.
+         */
+        std::unique_ptr< Impl > impl_;
+    };
+
+}
@@ -0,0 +1,112 @@
+/**
+ * @file ParallelFor.cpp
+ *
+ * This module contains the implementation
+ * of the DatabaseAbstractions::ParallelFor function.
+ */
+
+#include "ParallelFor.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+
+namespace {
+
+    /**
+     * This holds the state shared between the caller of ParallelFor and
+     * the helpers it posts to the worker pool.  Helpers which the pool
+     * doesn't get to until after all the work is done keep it alive,
+     * find nothing left to do, and return.
+     */
+    struct Shared {
+        /**
+         * This is used to synchronize access to the other properties.
+         */
+        std::mutex mutex;
+
+        /**
+         * This is used to wake the caller once all the work is done.
+         */
+        std::condition_variable doneCondition;
+
+        /**
+         * This is the function to call for each index.  It's cleared
+         * once all the work is done, since it refers to the caller's
+         * state.
+         */
+        const std::function< void(size_t index) >* work = nullptr;
+
+        /**
+         * This is the number of times to call the function.
+         */
+        size_t count = 0;
+
+        /**
+         * This is the next index to hand out.
+         */
+        size_t next = 0;
+
+        /**
+         * This is the number of calls which have returned.
+         */
+        size_t finished = 0;
+    };
+
+    /**
+     * This makes calls to the function for indexes not yet handed out,
+     * until there are none left.
+     *
+     * @param[in] shared
+     *     This is the state shared between the caller and the helpers.
+     */
+    void Help(Shared& shared) {
+        std::unique_lock< decltype(shared.mutex) > lock(shared.mutex);
+        while (shared.next < shared.count) {
+            const auto index = shared.next++;
+            const auto work = shared.work;
+            lock.unlock();
+            (*work)(index);
+            lock.lock();
+            if (++shared.finished == shared.count) {
+                shared.work = nullptr;
+                shared.doneCondition.notify_all();
+            }
+        }
+    }
+
+}
+
+namespace DatabaseAbstractions {
+
+    void ParallelFor(
+        WorkerPool* pool,
+        size_t count,
+        const std::function< void(size_t index) >& work
+    ) {
+        if (
+            (pool == nullptr)
+            || (count < 2)
+        ) {
+            for (size_t i = 0; i < count; ++i) {
+                work(i);
+            }
+            return;
+        }
+        const auto shared = std::make_shared< Shared >();
+        shared->work = &work;
+        shared->count = count;
+        const auto helpers = std::min(pool->GetThreadCount(), count - 1);
+        for (size_t i = 0; i < helpers; ++i) {
+            pool->Post([shared]{ Help(*shared); });
+        }
+        Help(*shared);
+        std::unique_lock< decltype(shared->mutex) > lock(shared->mutex);
+        shared->doneCondition.wait(
+            lock,
+            [&shared]{ return shared->finished == shared->count; }
+        );
+    }
+
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+/**
+ * @file ParallelFor.hpp
+ *
+ * This module declares the DatabaseAbstractions::ParallelFor function,
+ * which spreads independent pieces of work across a worker pool.
+ */
+
+#include <DatabaseAbstractions/WorkerPool.hpp>
+#include <functional>
+#include <stddef.h>
+
+namespace DatabaseAbstractions {
+
+    /**
+     * This calls the given function once for each index from zero up to
+     * (but not including) the given count, spreading the calls across the
+     * threads of the given worker pool, and returns once all the calls
+     * have returned.
+     *
+     * The calling thread takes part in the work, so this doesn't wait on
+     * work which the pool hasn't started yet, and is safe to call from
+     * one of the pool's own threads.
+     *
+     * @param[in] pool
+     *     This is the worker pool to use.  If null, the calls are all
+     *     made on the calling thread, in order.
+     *
+     * @param[in] count
+     *     This is the number of times to call the function.
+     *
+     * @param[in] work
+     *     This is the function to call.  It's given the index of the call.
+     */
+    void ParallelFor(
+        WorkerPool* pool,
+        size_t count,
+        const std::function< void(size_t index) >& work
+    );
+
+}
@@ -0,0 +1,64 @@
+/**
+ * @file PreparedStatement.cpp
+ *
+ * This file contains the base implementations of the optional methods
+ * of the DatabaseAbstractions::PreparedStatement class.
+ */
+
+#include <DatabaseAbstractions/Database.hpp>
+#include <utility>
+
+namespace DatabaseAbstractions {
+
+    void PreparedStatement::BindParameter(
+        int index,
+        Value&& value
+    ) {
+        BindParameter(index, (const Value&)value);
+    }
+
+    void PreparedStatement::BindParameters(std::vector< Value >&& values) {
+        int index = 1;
+        for (auto& value: values) {
+            BindParameter(index++, std::move(value));
+        }
+    }
+
+    void PreparedStatement::FetchColumn(
+        int index,
+        Value::Type type,
+        Value& value
+    ) {
+        value = FetchColumn(index, type);
+    }
+
+    StepStatementResults PreparedStatement::StepBatch(
+        size_t maxRows,
+        RowBatch& batch
+    ) {
+        batch.Clear();
+        const auto columnCount = batch.GetColumnCount();
+        StepStatementResults results;
+        Value value;
+        while (batch.GetRowCount() < maxRows) {
+            results = Step();
+            if (
+                results.done
+                || !results.error.empty()
+            ) {
+                break;
+            }
+            const auto row = batch.AddRow();
+            for (size_t column = 0; column < columnCount; ++column) {
+                FetchColumn((int)column, batch.GetColumnType(column), value);
+                batch.GetValue(row, column).Assign(value, batch.GetArena());
+            }
+        }
+        return results;
+    }
+
+    void PreparedStatement::StepAsync(StepStatementCallback callback) {
+        callback(Step());
+    }
+
+}
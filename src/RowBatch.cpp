@@ -0,0 +1,125 @@
+/**
+ * @file RowBatch.cpp
+ *
+ * This file contains the implementation
+ * of the DatabaseAbstractions::RowBatch class.
+ */
+
+#include <DatabaseAbstractions/RowBatch.hpp>
+
+namespace DatabaseAbstractions {
+
+    struct RowBatch::Impl {
+        // Properties
+
+        /**
+         * These are the types of values to fetch for the columns
+         * of each row.
+         */
+        std::vector< Value::Type > columnTypes;
+
+        /**
+         * These hold the values of the batch, one vector per column.
+         */
+        std::vector< std::vector< Value > > columns;
+
+        /**
+         * This is the number of rows for which values are allocated.
+         */
+        size_t capacity = 0;
+
+        /**
+         * This is the number of rows currently in the batch.
+         */
+        size_t rowCount = 0;
+
+        /**
+         * This holds the text and blobs of the values of the batch.
+         */
+        Arena arena;
+
+        // Methods
+
+        /**
+         * This allocates values for the given number of rows, if
+         * they aren't already allocated.
+         *
+         * @param[in] newCapacity
+         *     This is the number of rows for which values should
+         *     be allocated.
+         */
+        void Reserve(size_t newCapacity) {
+            if (newCapacity <= capacity) {
+                return;
+            }
+            for (auto& column: columns) {
+                column.resize(newCapacity);
+            }
+            capacity = newCapacity;
+        }
+    };
+
+    RowBatch::~RowBatch() noexcept = default;
+    RowBatch::RowBatch(RowBatch&&) noexcept = default;
+    RowBatch& RowBatch::operator=(RowBatch&&) noexcept = default;
+
+    RowBatch::RowBatch(
+        const std::vector< Value::Type >& columnTypes,
+        size_t capacity
+    )
+        : impl_(new Impl())
+    {
+        impl_->columnTypes = columnTypes;
+        impl_->columns.resize(columnTypes.size());
+        impl_->Reserve(capacity);
+    }
+
+    size_t RowBatch::GetColumnCount() const {
+        return impl_->columnTypes.size();
+    }
+
+    Value::Type RowBatch::GetColumnType(size_t column) const {
+        return impl_->columnTypes[column];
+    }
+
+    size_t RowBatch::GetRowCount() const {
+        return impl_->rowCount;
+    }
+
+    size_t RowBatch::GetCapacity() const {
+        return impl_->capacity;
+    }
+
+    const Value* RowBatch::GetColumn(size_t column) const {
+        return impl_->columns[column].data();
+    }
+
+    const Value& RowBatch::GetValue(size_t row, size_t column) const {
+        return impl_->columns[column][row];
+    }
+
+    Value& RowBatch::GetValue(size_t row, size_t column) {
+        return impl_->columns[column][row];
+    }
+
+    size_t RowBatch::AddRow() {
+        if (impl_->rowCount == impl_->capacity) {
+            impl_->Reserve(
+                (impl_->capacity == 0)
+                ? 1
+                : impl_->capacity * 2
+            );
+        }
+        return impl_->rowCount++;
+    }
+
+    Arena& RowBatch::GetArena() {
+        return impl_->arena;
+    }
+
+    void RowBatch::Clear() {
+        impl_->rowCount = 0;
+        impl_->arena.Reset();
+    }
+
+}
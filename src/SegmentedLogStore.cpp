@@ -0,0 +1,1102 @@
+/**
+ * @file SegmentedLogStore.cpp
+ *
+ * This module contains the implementation
+ * of the DatabaseAbstractions::SegmentedLogStore class.
+ */
+
+#include "MappedFile.hpp"
+
+#include <algorithm>
+#include <DatabaseAbstractions/Crc32c.hpp>
+#include <DatabaseAbstractions/SegmentedLogStore.hpp>
+#include <deque>
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <utility>
+
+#ifdef _WIN32
+#include <io.h>
+#else /* POSIX */
+#include <fcntl.h>
+#include <sys/types.h>
+#include <unistd.h>
+#endif /* _WIN32 / POSIX */
+
+namespace {
+
+    using namespace DatabaseAbstractions;
+
+    /**
+     * This is used to identify log segment files.
+     */
+    const uint8_t SEGMENT_MAGIC[8] = {'D', 'B', 'L', 'O', 'G', 'S', 'E', 'G'};
+
+    /**
+     * This is used to identify the files holding the index of
+     * the first entry of a log and the range of its segments.
+     */
+    const uint8_t META_MAGIC[8] = {'D', 'B', 'L', 'O', 'G', 'M', 'E', 'T'};
+
+    /**
+     * This is the version of the log file formats.
+     */
+    constexpr uint32_t LOG_FILE_VERSION = 1;
+
+    /**
+     * This is the number of bytes at the start of each segment,
+     * identifying it and giving the index of its first entry.
+     */
+    constexpr size_t SEGMENT_HEADER_SIZE = 32;
+
+    /**
+     * This is the number of bytes of the segment header which are
+     * covered by the header's checksum.
+     */
+    constexpr size_t SEGMENT_HEADER_CHECKED_SIZE = 24;
+
+    /**
+     * This is the number of bytes stored in front of the data of each
+     * entry: the length of the data, a checksum of the term and data,
+     * and the term.
+     */
+    constexpr size_t RECORD_HEADER_SIZE = 16;
+
+    /**
+     * This is the number of bytes in the file holding the index of
+     * the first entry of a log and the range of its segments.
+     */
+    constexpr size_t META_SIZE = 44;
+
+    /**
+     * This is the number of bytes of the meta file which are covered
+     * by its checksum.
+     */
+    constexpr size_t META_CHECKED_SIZE = 40;
+
+    /**
+     * This stores the given integer in little-endian byte order.
+     *
+     * @param[in] value
+     *     This is the integer to store.
+     *
+     * @param[in] size
+     *     This is the number of bytes to store.
+     *
+     * @param[out] buffer
+     *     This is where to store the integer.
+     */
+    void EncodeInteger(
+        uint64_t value,
+        size_t size,
+        uint8_t* buffer
+    ) {
+        for (size_t i = 0; i < size; ++i) {
+            buffer[i] = (uint8_t)(value >> (i * 8));
+        }
+    }
+
+    /**
+     * This loads an integer stored in little-endian byte order.
+     *
+     * @param[in] buffer
+     *     This is where the integer is stored.
+     *
+     * @param[in] size
+     *     This is the number of bytes in which the integer is stored.
+     *
+     * @return
+     *     The integer is returned.
+     */
+    uint64_t DecodeInteger(
+        const uint8_t* buffer,
+        size_t size
+    ) {
+        uint64_t value = 0;
+        for (size_t i = 0; i < size; ++i) {
+            value |= ((uint64_t)buffer[i] << (i * 8));
+        }
+        return value;
+    }
+
+    /**
+     * This flushes everything written to the given file to disk.
+     *
+     * @param[in] file
+     *     This is the file to flush.
+     *
+     * @return
+     *     An indication of whether or not the file was flushed
+     *     successfully is returned.
+     */
+    bool FlushToDisk(FILE* file) {
+        if (fflush(file) != 0) {
+            return false;
+        }
+#ifdef _WIN32
+        return (_commit(_fileno(file)) == 0);
+#else /* POSIX */
+        return (fsync(fileno(file)) == 0);
+#endif /* _WIN32 / POSIX */
+    }
+
+    /**
+     * This changes the size of the given file, discarding anything
+     * past the new size.
+     *
+     * @param[in] file
+     *     This is the file to shorten.
+     *
+     * @param[in] size
+     *     This is the new size of the file.
+     *
+     * @return
+     *     An indication of whether or not the file was shortened
+     *     successfully is returned.
+     */
+    bool TruncateFile(
+        FILE* file,
+        size_t size
+    ) {
+        if (fflush(file) != 0) {
+            return false;
+        }
+#ifdef _WIN32
+        return (_chsize_s(_fileno(file), (__int64)size) == 0);
+#else /* POSIX */
+        return (ftruncate(fileno(file), (off_t)size) == 0);
+#endif /* _WIN32 / POSIX */
+    }
+
+    /**
+     * This flushes to disk the entries of the directory holding the
+     * file with the given path, so that files created in it or renamed
+     * into it survive a crash.
+     *
+     * @param[in] path
+     *     This is the path of a file in the directory to flush.
+     *
+     * @return
+     *     An indication of whether or not the directory was flushed
+     *     successfully is returned.
+     */
+    bool FlushDirectoryToDisk(const std::string& path) {
+#ifdef _WIN32
+        (void)path;
+        return true;
+#else /* POSIX */
+        const auto delimiter = path.find_last_of('/');
+        const auto directory = (
+            (delimiter == std::string::npos)
+            ? std::string(".")
+            : path.substr(0, std::max(delimiter, (size_t)1))
+        );
+        const auto handle = open(directory.c_str(), O_RDONLY);
+        if (handle < 0) {
+            return false;
+        }
+        const auto flushed = (fsync(handle) == 0);
+        return ((close(handle) == 0) && flushed);
+#endif /* _WIN32 / POSIX */
+    }
+
+    /**
+     * This holds what's known about one segment of the log.
+     */
+    struct Segment {
+        /**
+         * This is the sequence number of the segment, which
+         * determines the name of its file.
+         */
+        uint64_t number = 0;
+
+        /**
+         * This is the index of the first entry in the segment.
+         */
+        uint64_t firstIndex = 0;
+
+        /**
+         * These are the offsets in the segment at which the entries
+         * are stored, followed by the offset of the end of the last one.
+         */
+        std::vector< size_t > offsets;
+
+        /**
+         * These are the terms of the entries in the segment.
+         */
+        std::vector< uint64_t > terms;
+
+        /**
+         * This maps the file of the segment into memory, once it's
+         * no longer being appended to.
+         */
+        MappedFile mapping;
+    };
+
+}
+
+namespace DatabaseAbstractions {
+
+    struct SegmentedLogStore::Impl {
+        // Properties
+
+        /**
+         * This indicates whether or not a log is open.
+         */
+        bool open = false;
+
+        /**
+         * This is the path, without extension, of the files
+         * in which the log is kept.
+         */
+        std::string basePath;
+
+        /**
+         * This is the approximate number of bytes of entries
+         * to keep in each segment.
+         */
+        size_t segmentSize = DEFAULT_LOG_SEGMENT_SIZE;
+
+        /**
+         * This is the index of the first entry in the log.
+         * The first segment may hold earlier entries which
+         * have been removed from the log.
+         */
+        uint64_t firstIndex = 1;
+
+        /**
+         * These are the segments in which the log is kept.  The last
+         * one is the segment being appended to.
+         */
+        std::deque< Segment > segments;
+
+        /**
+         * This is the file of the segment being appended to.
+         */
+        FILE* file = NULL;
+
+        /**
+         * This is a copy of the contents of the segment being appended
+         * to.  Enough memory is reserved up front that appending never
+         * moves it, other than for entries too large for a segment.
+         */
+        Blob activeData;
+
+        /**
+         * This indicates whether or not anything has been written
+         * to the file of the segment being appended to since it was
+         * last flushed to disk.
+         */
+        bool dirty = false;
+
+        // Methods
+
+        /**
+         * This returns the path of the file holding the index of
+         * the first entry of the log.
+         *
+         * @return
+         *     The path of the meta file is returned.
+         */
+        std::string GetMetaPath() const {
+            return basePath + ".meta";
+        }
+
+        /**
+         * This returns the path of the file of the given segment.
+         *
+         * @param[in] number
+         *     This is the sequence number of the segment.
+         *
+         * @return
+         *     The path of the segment's file is returned.
+         */
+        std::string GetSegmentPath(uint64_t number) const {
+            auto digits = std::to_string(number);
+            if (digits.length() < 10) {
+                digits.insert(0, 10 - digits.length(), '0');
+            }
+            return basePath + "." + digits + ".log";
+        }
+
+        /**
+         * This returns the index of the last entry in the log.
+         *
+         * @return
+         *     The index of the last entry in the log is returned.
+         */
+        uint64_t GetLastIndex() const {
+            if (segments.empty()) {
+                return firstIndex - 1;
+            }
+            const auto& segment = segments.back();
+            return segment.firstIndex + segment.terms.size() - 1;
+        }
+
+        /**
+         * This finds the segment holding the given entry,
+         * which must be in the log.
+         *
+         * @param[in] index
+         *     This is the index of the entry to find.
+         *
+         * @return
+         *     An iterator to the segment holding the entry is returned.
+         */
+        std::deque< Segment >::const_iterator FindSegment(uint64_t index) const {
+            const auto next = std::upper_bound(
+                segments.begin(),
+                segments.end(),
+                index,
+                [](uint64_t entryIndex, const Segment& segment){
+                    return entryIndex < segment.firstIndex;
+                }
+            );
+            return next - 1;
+        }
+
+        /**
+         * This returns the contents of the given segment.
+         *
+         * @param[in] segment
+         *     This is the segment whose contents to return.
+         *
+         * @return
+         *     A pointer to the contents of the segment is returned.
+         */
+        const uint8_t* GetSegmentData(const Segment& segment) const {
+            if (&segment == &segments.back()) {
+                return activeData.data();
+            }
+            return segment.mapping.GetData();
+        }
+
+        /**
+         * This reads the meta file of the log.
+         *
+         * @param[out] metaFirstIndex
+         *     This is where to store the index of the first entry.
+         *
+         * @param[out] firstSegment
+         *     This is where to store the sequence number of
+         *     the first segment.
+         *
+         * @param[out] lastSegment
+         *     This is where to store the sequence number of
+         *     the last segment.
+         *
+         * @param[out] found
+         *     This is where to store whether or not the file exists.
+         *
+         * @return
+         *     If an error occurs, a description of the error is returned.
+         *     Otherwise, an empty string is returned.
+         */
+        std::string ReadMeta(
+            uint64_t& metaFirstIndex,
+            uint64_t& firstSegment,
+            uint64_t& lastSegment,
+            bool& found
+        ) const {
+            const auto file = fopen(GetMetaPath().c_str(), "rb");
+            found = (file != NULL);
+            if (!found) {
+                return "";
+            }
+            uint8_t buffer[META_SIZE];
+            const auto size = fread(buffer, 1, sizeof(buffer), file);
+            (void)fclose(file);
+            if (
+                (size < META_SIZE)
+                || (memcmp(buffer, META_MAGIC, sizeof(META_MAGIC)) != 0)
+                || (
+                    (uint32_t)DecodeInteger(buffer + META_CHECKED_SIZE, 4)
+                    != Crc32c(buffer, META_CHECKED_SIZE)
+                )
+            ) {
+                return "log meta file is corrupt";
+            }
+            const auto version = (uint32_t)DecodeInteger(buffer + 8, 4);
+            if (version != LOG_FILE_VERSION) {
+                return "unsupported log file version " + std::to_string(version);
+            }
+            metaFirstIndex = DecodeInteger(buffer + 16, 8);
+            firstSegment = DecodeInteger(buffer + 24, 8);
+            lastSegment = DecodeInteger(buffer + 32, 8);
+            if (lastSegment < firstSegment) {
+                return "log meta file is corrupt";
+            }
+            return "";
+        }
+
+        /**
+         * This replaces the meta file of the log.  The file is written
+         * under a temporary name and renamed into place once it's
+         * flushed to disk, so it's never left incomplete.
+         *
+         * @param[in] metaFirstIndex
+         *     This is the index of the first entry.
+         *
+         * @param[in] firstSegment
+         *     This is the sequence number of the first segment.
+         *
+         * @param[in] lastSegment
+         *     This is the sequence number of the last segment.  Any
+         *     segment files after it are left over from before the end
+         *     of the log was removed, and are ignored.
+         *
+         * @return
+         *     If an error occurs, a description of the error is returned.
+         *     Otherwise, an empty string is returned.
+         */
+        std::string WriteMeta(
+            uint64_t metaFirstIndex,
+            uint64_t firstSegment,
+            uint64_t lastSegment
+        ) const {
+            uint8_t buffer[META_SIZE];
+            (void)memcpy(buffer, META_MAGIC, sizeof(META_MAGIC));
+            EncodeInteger(LOG_FILE_VERSION, 4, buffer + 8);
+            EncodeInteger(0, 4, buffer + 12);
+            EncodeInteger(metaFirstIndex, 8, buffer + 16);
+            EncodeInteger(firstSegment, 8, buffer + 24);
+            EncodeInteger(lastSegment, 8, buffer + 32);
+            EncodeInteger(Crc32c(buffer, META_CHECKED_SIZE), 4, buffer + META_CHECKED_SIZE);
+            const auto path = GetMetaPath();
+            const auto temporaryPath = path + ".tmp";
+            const auto file = fopen(temporaryPath.c_str(), "wb");
+            if (file == NULL) {
+                return "unable to create log meta file '" + temporaryPath + "'";
+            }
+            auto written = (
+                (fwrite(buffer, sizeof(buffer), 1, file) == 1)
+                && FlushToDisk(file)
+            );
+            written = ((fclose(file) == 0) && written);
+            if (written) {
+#ifdef _WIN32
+                (void)remove(path.c_str());
+#endif /* _WIN32 */
+                written = (
+                    (rename(temporaryPath.c_str(), path.c_str()) == 0)
+                    && FlushDirectoryToDisk(path)
+                );
+            }
+            if (!written) {
+                (void)remove(temporaryPath.c_str());
+                return "unable to write log meta file '" + path + "'";
+            }
+            return "";
+        }
+
+        /**
+         * This determines whether or not the given segment is the last
+         * one on disk, so that damage to it may be taken to be the torn
+         * tail left by a crash, rather than damage to entries already
+         * made durable.
+         *
+         * @param[in] number
+         *     This is the sequence number of the segment.
+         *
+         * @return
+         *     An indication of whether or not there is no segment after
+         *     the given one is returned.
+         */
+        bool IsLastSegment(uint64_t number) const {
+            const auto file = fopen(GetSegmentPath(number + 1).c_str(), "rb");
+            if (file == NULL) {
+                return true;
+            }
+            (void)fclose(file);
+            return false;
+        }
+
+        /**
+         * This deletes the files of the given segment and every segment
+         * after it, stopping at the first one which doesn't exist, and
+         * then flushes the directory holding them to disk.
+         *
+         * @param[in] number
+         *     This is the sequence number of the first segment to delete.
+         *
+         * @return
+         *     If an error occurs, a description of the error is returned.
+         *     Otherwise, an empty string is returned.
+         */
+        std::string RemoveSegmentsFrom(uint64_t number) const {
+            for (;; ++number) {
+                const auto path = GetSegmentPath(number);
+                if (remove(path.c_str()) != 0) {
+                    if (errno == ENOENT) {
+                        break;
+                    }
+                    return "unable to remove log segment file '" + path + "'";
+                }
+            }
+            if (!FlushDirectoryToDisk(GetMetaPath())) {
+                return "unable to flush log directory to disk";
+            }
+            return "";
+        }
+
+        /**
+         * This finds the entries in the given segment contents,
+         * stopping at the first one which is incomplete or fails
+         * its checksum.
+         *
+         * @param[in] data
+         *     This points to the contents of the segment.
+         *
+         * @param[in] size
+         *     This is the number of bytes of segment contents.
+         *
+         * @param[in,out] segment
+         *     This is where to store the offsets and terms of the entries.
+         */
+        static void LoadEntries(
+            const uint8_t* data,
+            size_t size,
+            Segment& segment
+        ) {
+            auto offset = SEGMENT_HEADER_SIZE;
+            segment.offsets.assign(1, offset);
+            segment.terms.clear();
+            while (size - offset >= RECORD_HEADER_SIZE) {
+                const auto record = data + offset;
+                const auto length = (size_t)DecodeInteger(record, 4);
+                if (length > size - offset - RECORD_HEADER_SIZE) {
+                    break;
+                }
+                const auto checksum = (uint32_t)DecodeInteger(record + 4, 4);
+                if (checksum != Crc32c(record + 8, 8 + length)) {
+                    break;
+                }
+                offset += RECORD_HEADER_SIZE + length;
+                segment.offsets.push_back(offset);
+                segment.terms.push_back(DecodeInteger(record + 8, 8));
+            }
+        }
+
+        /**
+         * This starts a new segment for entries to be appended to.
+         * Any segment previously being appended to must already
+         * be finished.
+         *
+         * @param[in] number
+         *     This is the sequence number of the new segment.
+         *
+         * @param[in] segmentFirstIndex
+         *     This is the index of the first entry to be appended
+         *     to the new segment.
+         *
+         * @return
+         *     If an error occurs, a description of the error is returned.
+         *     Otherwise, an empty string is returned.
+         */
+        std::string StartSegment(
+            uint64_t number,
+            uint64_t segmentFirstIndex
+        ) {
+            const auto path = GetSegmentPath(number);
+            file = fopen(path.c_str(), "wb");
+            if (file == NULL) {
+                return "unable to create log segment file '" + path + "'";
+            }
+            uint8_t header[SEGMENT_HEADER_SIZE] = {0};
+            (void)memcpy(header, SEGMENT_MAGIC, sizeof(SEGMENT_MAGIC));
+            EncodeInteger(LOG_FILE_VERSION, 4, header + 8);
+            EncodeInteger(segmentFirstIndex, 8, header + 16);
+            EncodeInteger(
+                Crc32c(header, SEGMENT_HEADER_CHECKED_SIZE),
+                4,
+                header + SEGMENT_HEADER_CHECKED_SIZE
+            );
+            if (
+                (fwrite(header, sizeof(header), 1, file) != 1)
+                || !FlushDirectoryToDisk(path)
+            ) {
+                (void)fclose(file);
+                file = NULL;
+                (void)remove(path.c_str());
+                return "unable to write log segment file '" + path + "'";
+            }
+            activeData.clear();
+            activeData.reserve(std::max(segmentSize, SEGMENT_HEADER_SIZE));
+            activeData.assign(header, header + sizeof(header));
+            Segment segment;
+            segment.number = number;
+            segment.firstIndex = segmentFirstIndex;
+            segment.offsets.assign(1, SEGMENT_HEADER_SIZE);
+            segments.push_back(std::move(segment));
+            dirty = true;
+            return "";
+        }
+
+        /**
+         * This finishes the segment being appended to, flushing it to
+         * disk and mapping it into memory, and starts a new one.
+         *
+         * @return
+         *     If an error occurs, a description of the error is returned.
+         *     Otherwise, an empty string is returned.
+         */
+        std::string FinishSegment() {
+            auto& segment = segments.back();
+            const auto path = GetSegmentPath(segment.number);
+            const auto flushed = FlushToDisk(file);
+            const auto closed = (fclose(file) == 0);
+            file = NULL;
+            dirty = false;
+            if (
+                !flushed
+                || !closed
+            ) {
+                return "unable to flush log segment file '" + path + "' to disk";
+            }
+            auto error = segment.mapping.Open(path);
+            if (!error.empty()) {
+                return error;
+            }
+            if (segment.mapping.GetSize() != activeData.size()) {
+                return "log segment file '" + path + "' has the wrong size";
+            }
+            const auto number = segment.number + 1;
+            error = WriteMeta(firstIndex, segments.front().number, number);
+            if (!error.empty()) {
+                return error;
+            }
+            return StartSegment(number, GetLastIndex() + 1);
+        }
+
+        /**
+         * This goes back to appending to the last segment, which is
+         * currently mapped into memory, discarding anything in it
+         * past the given size.
+         *
+         * @param[in] size
+         *     This is the number of bytes of the segment to keep.
+         *
+         * @return
+         *     If an error occurs, a description of the error is returned.
+         *     Otherwise, an empty string is returned.
+         */
+        std::string ReopenSegment(size_t size) {
+            auto& segment = segments.back();
+            const auto data = segment.mapping.GetData();
+            activeData.clear();
+            activeData.reserve(std::max(segmentSize, size));
+            activeData.assign(data, data + size);
+            segment.mapping.Close();
+            const auto path = GetSegmentPath(segment.number);
+            file = fopen(path.c_str(), "r+b");
+            if (file == NULL) {
+                return "unable to open log segment file '" + path + "'";
+            }
+            return ShortenSegment(size);
+        }
+
+        /**
+         * This discards everything in the segment being appended to
+         * past the given size.
+         *
+         * @param[in] size
+         *     This is the number of bytes of the segment to keep.
+         *
+         * @return
+         *     If an error occurs, a description of the error is returned.
+         *     Otherwise, an empty string is returned.
+         */
+        std::string ShortenSegment(size_t size) {
+            dirty = true;
+            if (
+                !TruncateFile(file, size)
+                || (fseek(file, (long)size, SEEK_SET) != 0)
+            ) {
+                return "unable to truncate log segment file";
+            }
+            activeData.resize(size);
+            return "";
+        }
+
+        /**
+         * This closes the file of the segment being appended to, and
+         * forgets all the segments.
+         */
+        void CloseSegments() {
+            if (file != NULL) {
+                (void)fclose(file);
+                file = NULL;
+            }
+            dirty = false;
+            segments.clear();
+            activeData.clear();
+        }
+    };
+
+    SegmentedLogStore::~SegmentedLogStore() noexcept {
+        if (impl_ != nullptr) {
+            Close();
+        }
+    }
+
+    SegmentedLogStore::SegmentedLogStore(SegmentedLogStore&&) noexcept = default;
+
+    SegmentedLogStore& SegmentedLogStore::operator=(SegmentedLogStore&& other) noexcept {
+        if (this != &other) {
+            if (impl_ != nullptr) {
+                Close();
+            }
+            impl_ = std::move(other.impl_);
+        }
+        return *this;
+    }
+
+    SegmentedLogStore::SegmentedLogStore()
+        : impl_(new Impl())
+    {
+    }
+
+    std::string SegmentedLogStore::Open(
+        const std::string& basePath,
+        size_t segmentSize
+    ) {
+        Close();
+        impl_->basePath = basePath;
+        impl_->segmentSize = segmentSize;
+        uint64_t firstIndex = 1;
+        uint64_t firstSegment = 1;
+        uint64_t lastSegment = 1;
+        bool found;
+        auto error = impl_->ReadMeta(firstIndex, firstSegment, lastSegment, found);
+        if (!error.empty()) {
+            return error;
+        }
+        if (!found) {
+            error = impl_->WriteMeta(firstIndex, firstSegment, lastSegment);
+            if (!error.empty()) {
+                return error;
+            }
+        }
+        error = impl_->RemoveSegmentsFrom(lastSegment + 1);
+        if (!error.empty()) {
+            return error;
+        }
+        for (
+            auto number = firstSegment - 1;
+            (number > 0) && (remove(impl_->GetSegmentPath(number).c_str()) == 0);
+            --number
+        ) {
+        }
+        impl_->firstIndex = firstIndex;
+        size_t lastSize = 0;
+        for (auto number = firstSegment; number <= lastSegment; ++number) {
+            Segment segment;
+            if (!segment.mapping.Open(impl_->GetSegmentPath(number)).empty()) {
+                break;
+            }
+            const auto data = segment.mapping.GetData();
+            const auto size = segment.mapping.GetSize();
+            if (
+                (size < SEGMENT_HEADER_SIZE)
+                || (memcmp(data, SEGMENT_MAGIC, sizeof(SEGMENT_MAGIC)) != 0)
+                || (
+                    (uint32_t)DecodeInteger(data + SEGMENT_HEADER_CHECKED_SIZE, 4)
+                    != Crc32c(data, SEGMENT_HEADER_CHECKED_SIZE)
+                )
+                || ((uint32_t)DecodeInteger(data + 8, 4) != LOG_FILE_VERSION)
+            ) {
+                segment.mapping.Close();
+                if (!impl_->IsLastSegment(number)) {
+                    impl_->CloseSegments();
+                    return "log segment file '" + impl_->GetSegmentPath(number) + "' is corrupt";
+                }
+                error = impl_->RemoveSegmentsFrom(number);
+                if (!error.empty()) {
+                    impl_->CloseSegments();
+                    return error;
+                }
+                break;
+            }
+            segment.number = number;
+            segment.firstIndex = DecodeInteger(data + 16, 8);
+            if (
+                impl_->segments.empty()
+                ? (segment.firstIndex > firstIndex)
+                : (segment.firstIndex != impl_->GetLastIndex() + 1)
+            ) {
+                segment.mapping.Close();
+                if (
+                    impl_->segments.empty()
+                    || !impl_->IsLastSegment(number)
+                ) {
+                    impl_->CloseSegments();
+                    return "log segments do not match log meta file";
+                }
+                error = impl_->RemoveSegmentsFrom(number);
+                if (!error.empty()) {
+                    impl_->CloseSegments();
+                    return error;
+                }
+                break;
+            }
+            Impl::LoadEntries(data, size, segment);
+            lastSize = segment.offsets.back();
+            impl_->segments.push_back(std::move(segment));
+            if (lastSize < size) {
+                if (!impl_->IsLastSegment(number)) {
+                    impl_->CloseSegments();
+                    return "log segment file '" + impl_->GetSegmentPath(number) + "' is corrupt";
+                }
+                break;
+            }
+        }
+        if (impl_->segments.empty()) {
+            error = impl_->StartSegment(firstSegment, firstIndex);
+        } else if (firstIndex > impl_->GetLastIndex() + 1) {
+            error = "log is missing entries";
+        } else {
+            error = impl_->ReopenSegment(lastSize);
+        }
+        if (!error.empty()) {
+            impl_->CloseSegments();
+            return error;
+        }
+        impl_->open = true;
+        return "";
+    }
+
+    void SegmentedLogStore::Close() {
+        impl_->CloseSegments();
+        impl_->firstIndex = 1;
+        impl_->open = false;
+    }
+
+    size_t SegmentedLogStore::GetSegmentCount() const {
+        return impl_->segments.size();
+    }
+
+    uint64_t SegmentedLogStore::GetFirstIndex() {
+        return impl_->firstIndex;
+    }
+
+    uint64_t SegmentedLogStore::GetLastIndex() {
+        return impl_->GetLastIndex();
+    }
+
+    uint64_t SegmentedLogStore::GetTerm(uint64_t index) {
+        if (
+            (index < impl_->firstIndex)
+            || (index > impl_->GetLastIndex())
+        ) {
+            return 0;
+        }
+        const auto segment = impl_->FindSegment(index);
+        return segment->terms[index - segment->firstIndex];
+    }
+
+    std::string SegmentedLogStore::Append(
+        uint64_t term,
+        BlobView data
+    ) {
+        if (!impl_->open) {
+            return "log store is not open";
+        }
+        if (data.size > 0xFFFFFFFF) {
+            return "log entry is too large";
+        }
+        const auto recordSize = RECORD_HEADER_SIZE + data.size;
+        if (
+            !impl_->segments.back().terms.empty()
+            && (impl_->activeData.size() + recordSize > impl_->segmentSize)
+        ) {
+            const auto error = impl_->FinishSegment();
+            if (!error.empty()) {
+                impl_->open = false;
+                return error;
+            }
+        }
+        auto& segment = impl_->segments.back();
+        auto& activeData = impl_->activeData;
+        uint8_t header[RECORD_HEADER_SIZE];
+        EncodeInteger(data.size, 4, header);
+        EncodeInteger(term, 8, header + 8);
+        EncodeInteger(
+            Crc32c(data.data, data.size, Crc32c(header + 8, 8)),
+            4,
+            header + 4
+        );
+        const auto size = activeData.size();
+        impl_->dirty = true;
+        if (
+            (fwrite(header, sizeof(header), 1, impl_->file) != 1)
+            || (
+                (data.size > 0)
+                && (fwrite(data.data, data.size, 1, impl_->file) != 1)
+            )
+        ) {
+            (void)impl_->ShortenSegment(size);
+            return "unable to write log segment file";
+        }
+        if (activeData.capacity() < size + recordSize) {
+            activeData.reserve(size + recordSize);
+        }
+        activeData.insert(activeData.end(), header, header + sizeof(header));
+        activeData.insert(activeData.end(), data.data, data.data + data.size);
+        segment.offsets.push_back(activeData.size());
+        segment.terms.push_back(term);
+        return "";
+    }
+
+    std::string SegmentedLogStore::Sync() {
+        if (!impl_->open) {
+            return "log store is not open";
+        }
+        if (!impl_->dirty) {
+            return "";
+        }
+        if (!FlushToDisk(impl_->file)) {
+            return "unable to flush log segment file to disk";
+        }
+        impl_->dirty = false;
+        return "";
+    }
+
+    std::string SegmentedLogStore::Read(
+        uint64_t first,
+        uint64_t last,
+        std::vector< LogEntryView >& entries
+    ) {
+        entries.clear();
+        if (first > last) {
+            return "";
+        }
+        if (
+            (first < impl_->firstIndex)
+            || (last > impl_->GetLastIndex())
+        ) {
+            return "log entries are not available";
+        }
+        entries.reserve((size_t)(last - first + 1));
+        auto segment = impl_->FindSegment(first);
+        auto data = impl_->GetSegmentData(*segment);
+        for (auto index = first; index <= last; ++index) {
+            auto position = (size_t)(index - segment->firstIndex);
+            if (position >= segment->terms.size()) {
+                ++segment;
+                data = impl_->GetSegmentData(*segment);
+                position = 0;
+            }
+            const auto offset = segment->offsets[position] + RECORD_HEADER_SIZE;
+            LogEntryView entry;
+            entry.index = index;
+            entry.term = segment->terms[position];
+            entry.data = BlobView(
+                data + offset,
+                segment->offsets[position + 1] - offset
+            );
+            entries.push_back(entry);
+        }
+        return "";
+    }
+
+    std::string SegmentedLogStore::TruncateSuffix(uint64_t last) {
+        if (!impl_->open) {
+            return "log store is not open";
+        }
+        if (last >= impl_->GetLastIndex()) {
+            return "";
+        }
+        if (last + 1 < impl_->firstIndex) {
+            return "log entries to keep have already been removed";
+        }
+        auto& segments = impl_->segments;
+        if (
+            (segments.size() > 1)
+            && (segments.back().firstIndex > last)
+        ) {
+            (void)fclose(impl_->file);
+            impl_->file = NULL;
+            do {
+                const auto path = impl_->GetSegmentPath(segments.back().number);
+                segments.pop_back();
+                if (remove(path.c_str()) != 0) {
+                    impl_->open = false;
+                    return "unable to remove log segment file '" + path + "'";
+                }
+            } while (
+                (segments.size() > 1)
+                && (segments.back().firstIndex > last)
+            );
+            if (!FlushDirectoryToDisk(impl_->GetMetaPath())) {
+                impl_->open = false;
+                return "unable to flush log directory to disk";
+            }
+            auto error = impl_->WriteMeta(
+                impl_->firstIndex,
+                segments.front().number,
+                segments.back().number
+            );
+            if (error.empty()) {
+                error = impl_->ReopenSegment(segments.back().offsets.back());
+            }
+            if (!error.empty()) {
+                impl_->open = false;
+                return error;
+            }
+        }
+        auto& segment = segments.back();
+        const auto keep = (size_t)(last + 1 - segment.firstIndex);
+        const auto error = impl_->ShortenSegment(segment.offsets[keep]);
+        if (!error.empty()) {
+            return error;
+        }
+        segment.offsets.resize(keep + 1);
+        segment.terms.resize(keep);
+        return "";
+    }
+
+    std::string SegmentedLogStore::CompactPrefix(uint64_t last) {
+        if (!impl_->open) {
+            return "log store is not open";
+        }
+        if (last < impl_->firstIndex) {
+            return "";
+        }
+        const auto firstIndex = last + 1;
+        auto& segments = impl_->segments;
+        if (firstIndex > impl_->GetLastIndex()) {
+            const auto number = segments.back().number + 1;
+            auto error = impl_->WriteMeta(firstIndex, number, number);
+            if (!error.empty()) {
+                return error;
+            }
+            impl_->CloseSegments();
+            impl_->firstIndex = firstIndex;
+            for (
+                auto oldNumber = number - 1;
+                (oldNumber > 0) && (remove(impl_->GetSegmentPath(oldNumber).c_str()) == 0);
+                --oldNumber
+            ) {
+            }
+            error = impl_->StartSegment(number, firstIndex);
+            if (!error.empty()) {
+                impl_->open = false;
+            }
+            return error;
+        }
+        const auto number = impl_->FindSegment(firstIndex)->number;
+        const auto error = impl_->WriteMeta(firstIndex, number, segments.back().number);
+        if (!error.empty()) {
+            return error;
+        }
+        impl_->firstIndex = firstIndex;
+        while (segments.front().number != number) {
+            const auto oldNumber = segments.front().number;
+            segments.pop_front();
+            (void)remove(impl_->GetSegmentPath(oldNumber).c_str());
+        }
+        return "";
+    }
+
+}
@@ -0,0 +1,57 @@
+/**
+ * @file Snapshot.cpp
+ *
+ * This file contains the implementation
+ * of the DatabaseAbstractions::BlobSnapshotReader class.
+ */
+
+#include <DatabaseAbstractions/Snapshot.hpp>
+#include <algorithm>
+
+namespace DatabaseAbstractions {
+
+    struct BlobSnapshotReader::Impl {
+        // Properties
+
+        /**
+         * This is the complete snapshot being read.
+         */
+        Blob snapshot;
+
+        /**
+         * This is the maximum number of bytes in each chunk.
+         */
+        size_t chunkSize = 0;
+
+        /**
+         * This is the offset of the next chunk to read.
+         */
+        size_t offset = 0;
+    };
+
+    BlobSnapshotReader::~BlobSnapshotReader() noexcept = default;
+    BlobSnapshotReader::BlobSnapshotReader(BlobSnapshotReader&&) noexcept = default;
+    BlobSnapshotReader& BlobSnapshotReader::operator=(BlobSnapshotReader&&) noexcept = default;
+
+    BlobSnapshotReader::BlobSnapshotReader(
+        Blob&& snapshot,
+        size_t chunkSize
+    )
+        : impl_(new Impl())
+    {
+        impl_->snapshot = std::move(snapshot);
+        impl_->chunkSize = std::max(chunkSize, (size_t)1);
+    }
+
+    ReadSnapshotChunkResults BlobSnapshotReader::ReadChunk(Blob& chunk) {
+        ReadSnapshotChunkResults results;
+        const auto remaining = impl_->snapshot.size() - impl_->offset;
+        const auto size = std::min(remaining, impl_->chunkSize);
+        const auto begin = impl_->snapshot.begin() + impl_->offset;
+        chunk.assign(begin, begin + size);
+        impl_->offset += size;
+        results.done = (size == 0);
+        return results;
+    }
+
+}
@@ -0,0 +1,1390 @@
+/**
+ * @file SnapshotCodec.cpp
+ *
+ * This file contains the implementation of the built-in snapshot codecs,
+ * the codec registry, and the functions and classes which compress
+ * snapshots into frames and decompress them again.
+ */
+
+#include "ParallelFor.hpp"
+
+#include <algorithm>
+#include <DatabaseAbstractions/Crc32c.hpp>
+#include <DatabaseAbstractions/SnapshotCodec.hpp>
+#include <mutex>
+#include <string.h>
+#include <vector>
+
+namespace {
+
+    using namespace DatabaseAbstractions;
+
+    /**
+     * This is used to identify frames.
+     */
+    const uint8_t MAGIC[4] = {'D', 'B', 'Z', 'F'};
+
+    /**
+     * This is set in the flags of a frame whose blocks carry checksums.
+     */
+    constexpr uint8_t FLAG_CHECKSUMS = 0x01;
+
+    /**
+     * This is the number of bytes in the part of each block's header
+     * which holds its sizes.
+     */
+    constexpr size_t BLOCK_SIZES_SIZE = 8;
+
+    /**
+     * This is set in the stored size of a block which is stored as is,
+     * rather than compressed.
+     */
+    constexpr uint32_t STORED_FLAG = 0x80000000;
+
+    /**
+     * This is the largest block size allowed, which leaves the top bit
+     * of each block's stored size free for STORED_FLAG.
+     */
+    constexpr size_t MAX_BLOCK_SIZE = 0x40000000;
+
+    /**
+     * This stores the given integer in little-endian byte order.
+     *
+     * @param[in] value
+     *     This is the integer to store.
+     *
+     * @param[in] size
+     *     This is the number of bytes to store.
+     *
+     * @param[out] buffer
+     *     This is where to store the integer.
+     */
+    void EncodeInteger(
+        uint64_t value,
+        size_t size,
+        uint8_t* buffer
+    ) {
+        for (size_t i = 0; i < size; ++i) {
+            buffer[i] = (uint8_t)(value >> (i * 8));
+        }
+    }
+
+    /**
+     * This loads an integer stored in little-endian byte order.
+     *
+     * @param[in] buffer
+     *     This is where the integer is stored.
+     *
+     * @param[in] size
+     *     This is the number of bytes in which the integer is stored.
+     *
+     * @return
+     *     The integer is returned.
+     */
+    uint64_t DecodeInteger(
+        const uint8_t* buffer,
+        size_t size
+    ) {
+        uint64_t value = 0;
+        for (size_t i = 0; i < size; ++i) {
+            value |= ((uint64_t)buffer[i] << (i * 8));
+        }
+        return value;
+    }
+
+    /**
+     * This is the codec which stores blocks as is.
+     */
+    class NoneCodec
+        : public SnapshotCodec
+    {
+        // SnapshotCodec
+    public:
+        virtual uint8_t GetId() const override {
+            return SNAPSHOT_CODEC_NONE;
+        }
+
+        virtual size_t GetMaxExpansion() const override {
+            return 1;
+        }
+
+        virtual void Compress(
+            BlobView input,
+            Blob& output
+        ) const override {
+            output.assign(input.data, input.data + input.size);
+        }
+
+        virtual bool Decompress(
+            BlobView input,
+            uint8_t* output,
+            size_t size
+        ) const override {
+            if (input.size != size) {
+                return false;
+            }
+            if (size > 0) {
+                (void)memcpy(output, input.data, size);
+            }
+            return true;
+        }
+    };
+
+    /**
+     * This is a fast codec in the LZ77 family.  The compressed data is a
+     * series of sequences, each made up of a token byte, some literal
+     * bytes, a two-byte offset back to an earlier copy of the bytes which
+     * follow, and the length of that copy.  The token holds the number of
+     * literal bytes in its upper four bits, and the copy length (less the
+     * minimum) in its lower four bits.  Either number, if it doesn't fit,
+     * is continued in extra bytes which are added up until one is less
+     * than 255.  The last sequence has only literal bytes.
+     */
+    class LzCodec
+        : public SnapshotCodec
+    {
+        // Private Constants
+    private:
+        /**
+         * This is the shortest copy which is encoded as a copy,
+         * rather than as literal bytes.
+         */
+        static constexpr size_t MIN_MATCH = 4;
+
+        /**
+         * This is the furthest back a copy may be taken from.
+         */
+        static constexpr size_t MAX_OFFSET = 65535;
+
+        /**
+         * This is the number of bits in the hash of each four bytes,
+         * used to look up where those bytes were last seen.
+         */
+        static constexpr int HASH_BITS = 14;
+
+        /**
+         * This controls how quickly the compressor starts skipping ahead
+         * when it doesn't find copies, so that data which doesn't
+         * compress doesn't take long to find out.
+         */
+        static constexpr int SKIP_SHIFT = 6;
+
+        // Private Methods
+    private:
+        static uint32_t Load32(const uint8_t* data) {
+            uint32_t value;
+            (void)memcpy(&value, data, sizeof(value));
+            return value;
+        }
+
+        static size_t Hash(uint32_t sequence) {
+            return (size_t)((sequence * 2654435761U) >> (32 - HASH_BITS));
+        }
+
+        static void WriteLength(
+            Blob& output,
+            size_t length
+        ) {
+            while (length >= 255) {
+                output.push_back(255);
+                length -= 255;
+            }
+            output.push_back((uint8_t)length);
+        }
+
+        static bool ReadLength(
+            const uint8_t*& input,
+            const uint8_t* end,
+            size_t& length
+        ) {
+            for (;;) {
+                if (input == end) {
+                    return false;
+                }
+                const auto next = *input++;
+                length += next;
+                if (next != 255) {
+                    return true;
+                }
+            }
+        }
+
+        static void WriteSequence(
+            Blob& output,
+            const uint8_t* literals,
+            size_t literalCount,
+            size_t offset,
+            size_t matchLength
+        ) {
+            const auto matchCode = (matchLength == 0) ? 0 : matchLength - MIN_MATCH;
+            output.push_back((uint8_t)(
+                (std::min(literalCount, (size_t)15) << 4)
+                | std::min(matchCode, (size_t)15)
+            ));
+            if (literalCount >= 15) {
+                WriteLength(output, literalCount - 15);
+            }
+            output.insert(output.end(), literals, literals + literalCount);
+            if (matchLength == 0) {
+                return;
+            }
+            output.push_back((uint8_t)offset);
+            output.push_back((uint8_t)(offset >> 8));
+            if (matchCode >= 15) {
+                WriteLength(output, matchCode - 15);
+            }
+        }
+
+        // SnapshotCodec
+    public:
+        virtual uint8_t GetId() const override {
+            return SNAPSHOT_CODEC_LZ;
+        }
+
+        virtual size_t GetMaxExpansion() const override {
+            // A copy takes at least three bytes and copies at most 19,
+            // and each extra byte of its length adds at most 255 more.
+            return 255;
+        }
+
+        virtual void Compress(
+            BlobView input,
+            Blob& output
+        ) const override {
+            output.clear();
+            output.reserve(input.size + input.size / 255 + 16);
+            std::vector< uint32_t > lastSeen((size_t)1 << HASH_BITS);
+            const auto begin = input.data;
+            const auto end = begin + input.size;
+            auto anchor = begin;
+            auto next = begin;
+            size_t misses = 0;
+            while ((size_t)(end - next) >= MIN_MATCH) {
+                const auto sequence = Load32(next);
+                auto& slot = lastSeen[Hash(sequence)];
+                const auto candidate = slot;
+                slot = (uint32_t)(next - begin) + 1;
+                if (candidate != 0) {
+                    const auto match = begin + candidate - 1;
+                    if (
+                        ((size_t)(next - match) <= MAX_OFFSET)
+                        && (Load32(match) == sequence)
+                    ) {
+                        auto length = MIN_MATCH;
+                        while (
+                            (next + length < end)
+                            && (match[length] == next[length])
+                        ) {
+                            ++length;
+                        }
+                        WriteSequence(
+                            output,
+                            anchor,
+                            (size_t)(next - anchor),
+                            (size_t)(next - match),
+                            length
+                        );
+                        next += length;
+                        anchor = next;
+                        misses = 0;
+                        continue;
+                    }
+                }
+                next += std::min(
+                    1 + (misses++ >> SKIP_SHIFT),
+                    (size_t)(end - next)
+                );
+            }
+            WriteSequence(output, anchor, (size_t)(end - anchor), 0, 0);
+        }
+
+        virtual bool Decompress(
+            BlobView input,
+            uint8_t* output,
+            size_t size
+        ) const override {
+            auto next = input.data;
+            const auto end = next + input.size;
+            auto out = output;
+            const auto outEnd = output + size;
+            for (;;) {
+                if (next == end) {
+                    return false;
+                }
+                const auto token = *next++;
+                size_t literalCount = (token >> 4);
+                if (
+                    (literalCount == 15)
+                    && !ReadLength(next, end, literalCount)
+                ) {
+                    return false;
+                }
+                if (
+                    (literalCount > (size_t)(end - next))
+                    || (literalCount > (size_t)(outEnd - out))
+                ) {
+                    return false;
+                }
+                if (literalCount > 0) {
+                    (void)memcpy(out, next, literalCount);
+                }
+                next += literalCount;
+                out += literalCount;
+                if (next == end) {
+                    return (out == outEnd);
+                }
+                if (end - next < 2) {
+                    return false;
+                }
+                const auto offset = (size_t)next[0] | ((size_t)next[1] << 8);
+                next += 2;
+                if (
+                    (offset == 0)
+                    || (offset > (size_t)(out - output))
+                ) {
+                    return false;
+                }
+                size_t length = (token & 15);
+                if (
+                    (length == 15)
+                    && !ReadLength(next, end, length)
+                ) {
+                    return false;
+                }
+                length += MIN_MATCH;
+                if (length > (size_t)(outEnd - out)) {
+                    return false;
+                }
+                const auto match = out - offset;
+                if (offset >= length) {
+                    (void)memcpy(out, match, length);
+                } else {
+                    for (size_t i = 0; i < length; ++i) {
+                        out[i] = match[i];
+                    }
+                }
+                out += length;
+            }
+        }
+    };
+
+    /**
+     * This holds the codecs available to decompress frames.
+     */
+    struct Registry {
+        /**
+         * This is used to synchronize access to the codecs.
+         */
+        std::mutex mutex;
+
+        /**
+         * These are the codecs, indexed by identifier.
+         */
+        std::shared_ptr< const SnapshotCodec > codecs[256];
+
+        Registry() {
+            codecs[SNAPSHOT_CODEC_NONE] = std::make_shared< NoneCodec >();
+            codecs[SNAPSHOT_CODEC_LZ] = std::make_shared< LzCodec >();
+        }
+    };
+
+    /**
+     * This returns the codec registry, setting it up the first time
+     * it's needed.
+     *
+     * @return
+     *     The codec registry is returned.
+     */
+    Registry& GetRegistry() {
+        static Registry registry;
+        return registry;
+    }
+
+    /**
+     * This holds the information in the header of a frame.
+     */
+    struct FrameHeader {
+        /**
+         * This is the codec used to compress the blocks of the frame.
+         */
+        std::shared_ptr< const SnapshotCodec > codec;
+
+        /**
+         * This is the largest number of bytes any block of the frame
+         * decompresses to.
+         */
+        size_t blockSize = 0;
+
+        /**
+         * This flag is set if each block of the frame carries
+         * a checksum.
+         */
+        bool checksums = false;
+
+        /**
+         * This is the number of bytes in the header of each block.
+         */
+        size_t blockHeaderSize = 0;
+    };
+
+    /**
+     * This describes one block of a frame.
+     */
+    struct FrameBlock {
+        /**
+         * This points to the header of the block.
+         */
+        const uint8_t* begin = nullptr;
+
+        /**
+         * This points to the data of the block, as stored in the frame.
+         */
+        const uint8_t* data = nullptr;
+
+        /**
+         * This is the number of bytes of the block stored in the frame.
+         */
+        size_t storedSize = 0;
+
+        /**
+         * This is the number of bytes the block decompresses to.
+         */
+        size_t size = 0;
+
+        /**
+         * This flag is set if the block is stored as is, rather than
+         * compressed.
+         */
+        bool stored = false;
+
+        /**
+         * This is the checksum of the block's sizes and stored data,
+         * if the frame has checksums.
+         */
+        uint32_t checksum = 0;
+    };
+
+    /**
+     * This forms the header of a frame.
+     *
+     * @param[in] codec
+     *     This is the codec used to compress the blocks of the frame.
+     *
+     * @param[in] blockSize
+     *     This is the largest number of bytes any block of the frame
+     *     decompresses to.
+     *
+     * @param[out] frame
+     *     This is where to append the header.
+     */
+    void EncodeFrameHeader(
+        const SnapshotCodec& codec,
+        size_t blockSize,
+        Blob& frame
+    ) {
+        uint8_t buffer[SNAPSHOT_FRAME_HEADER_SIZE];
+        (void)memcpy(buffer, MAGIC, sizeof(MAGIC));
+        buffer[4] = SNAPSHOT_FRAME_VERSION;
+        buffer[5] = codec.GetId();
+        buffer[6] = FLAG_CHECKSUMS;
+        buffer[7] = 0;
+        EncodeInteger(blockSize, 4, buffer + 8);
+        frame.insert(frame.end(), buffer, buffer + sizeof(buffer));
+    }
+
+    /**
+     * This extracts and validates the information in the header
+     * of a frame.
+     *
+     * @param[in] buffer
+     *     This is where the header is stored.  It must hold at least
+     *     SNAPSHOT_FRAME_HEADER_SIZE bytes.
+     *
+     * @param[out] header
+     *     This is where to store the information in the header.
+     *
+     * @return
+     *     If the header isn't valid, a description of the problem
+     *     is returned.  Otherwise, an empty string is returned.
+     */
+    std::string DecodeFrameHeader(
+        const uint8_t* buffer,
+        FrameHeader& header
+    ) {
+        if (memcmp(buffer, MAGIC, sizeof(MAGIC)) != 0) {
+            return "not a snapshot frame";
+        }
+        if (buffer[4] != SNAPSHOT_FRAME_VERSION) {
+            return "unsupported snapshot frame version";
+        }
+        if (
+            ((buffer[6] & ~FLAG_CHECKSUMS) != 0)
+            || (buffer[7] != 0)
+        ) {
+            return "unsupported snapshot frame flags";
+        }
+        header.codec = GetSnapshotCodec(buffer[5]);
+        if (header.codec == nullptr) {
+            return "unknown snapshot codec";
+        }
+        header.checksums = ((buffer[6] & FLAG_CHECKSUMS) != 0);
+        header.blockHeaderSize = (
+            header.checksums
+            ? SNAPSHOT_FRAME_BLOCK_HEADER_SIZE
+            : BLOCK_SIZES_SIZE
+        );
+        header.blockSize = (size_t)DecodeInteger(buffer + 8, 4);
+        if (
+            (header.blockSize == 0)
+            || (header.blockSize > MAX_BLOCK_SIZE)
+        ) {
+            return "invalid snapshot frame block size";
+        }
+        return "";
+    }
+
+    /**
+     * This compresses one block of a snapshot, and forms the block
+     * as it's stored in a frame.
+     *
+     * @param[in] codec
+     *     This is the codec to use.
+     *
+     * @param[in] input
+     *     This is the block of the snapshot to compress.
+     *
+     * @param[out] output
+     *     This is where to store the block as it's stored in a frame.
+     */
+    void EncodeBlock(
+        const SnapshotCodec& codec,
+        BlobView input,
+        Blob& output
+    ) {
+        Blob compressed;
+        codec.Compress(input, compressed);
+        const auto stored = (compressed.size() >= input.size);
+        output.resize(SNAPSHOT_FRAME_BLOCK_HEADER_SIZE);
+        EncodeInteger(input.size, 4, output.data());
+        EncodeInteger(
+            stored ? (input.size | STORED_FLAG) : compressed.size(),
+            4,
+            output.data() + 4
+        );
+        const auto data = stored ? input : BlobView(compressed);
+        EncodeInteger(
+            Crc32c(data.data, data.size, Crc32c(output.data(), BLOCK_SIZES_SIZE)),
+            4,
+            output.data() + BLOCK_SIZES_SIZE
+        );
+        output.insert(output.end(), data.data, data.data + data.size);
+    }
+
+    /**
+     * This forms the block which marks the end of a frame.
+     *
+     * @param[out] frame
+     *     This is where to append the block.
+     */
+    void EncodeEndBlock(Blob& frame) {
+        uint8_t buffer[SNAPSHOT_FRAME_BLOCK_HEADER_SIZE] = {0};
+        EncodeInteger(Crc32c(buffer, BLOCK_SIZES_SIZE), 4, buffer + BLOCK_SIZES_SIZE);
+        frame.insert(frame.end(), buffer, buffer + sizeof(buffer));
+    }
+
+    /**
+     * This extracts the next block of a frame.
+     *
+     * @param[in] begin
+     *     This points to the start of the block.
+     *
+     * @param[in] end
+     *     This points just past the last byte available.
+     *
+     * @param[in] header
+     *     This holds the information in the header of the frame.
+     *
+     * @param[out] block
+     *     This is where to store the description of the block.
+     *
+     * @param[out] consumed
+     *     This is where to store the number of bytes taken up by the
+     *     block in the frame, or zero if the block isn't complete yet.
+     *
+     * @param[out] last
+     *     This is set if the block marks the end of the frame.
+     *
+     * @return
+     *     If the block isn't valid, a description of the problem
+     *     is returned.  Otherwise, an empty string is returned.
+     */
+    std::string DecodeBlock(
+        const uint8_t* begin,
+        const uint8_t* end,
+        const FrameHeader& header,
+        FrameBlock& block,
+        size_t& consumed,
+        bool& last
+    ) {
+        consumed = 0;
+        last = false;
+        const auto available = (size_t)(end - begin);
+        if (available < header.blockHeaderSize) {
+            return "";
+        }
+        block.begin = begin;
+        block.size = (size_t)DecodeInteger(begin, 4);
+        const auto storedField = (uint32_t)DecodeInteger(begin + 4, 4);
+        if (header.checksums) {
+            block.checksum = (uint32_t)DecodeInteger(begin + BLOCK_SIZES_SIZE, 4);
+        }
+        if (
+            (block.size == 0)
+            && (storedField == 0)
+        ) {
+            if (
+                header.checksums
+                && (block.checksum != Crc32c(begin, BLOCK_SIZES_SIZE))
+            ) {
+                return "invalid snapshot frame block";
+            }
+            consumed = header.blockHeaderSize;
+            last = true;
+            return "";
+        }
+        block.stored = ((storedField & STORED_FLAG) != 0);
+        block.storedSize = (storedField & ~STORED_FLAG);
+        if (
+            (block.size == 0)
+            || (block.size > header.blockSize)
+            || (block.storedSize > block.size)
+            || (
+                block.stored
+                && (block.storedSize != block.size)
+            )
+            || (
+                !block.stored
+                && (
+                    (uint64_t)block.size
+                    > (uint64_t)block.storedSize * header.codec->GetMaxExpansion()
+                )
+            )
+        ) {
+            return "invalid snapshot frame block";
+        }
+        if (available - header.blockHeaderSize < block.storedSize) {
+            return "";
+        }
+        block.data = begin + header.blockHeaderSize;
+        consumed = header.blockHeaderSize + block.storedSize;
+        return "";
+    }
+
+    /**
+     * This determines whether or not a block of a frame is intact,
+     * by checking its checksum, if the frame has checksums.
+     *
+     * @param[in] header
+     *     This holds the information in the header of the frame.
+     *
+     * @param[in] block
+     *     This describes the block to check.
+     *
+     * @return
+     *     An indication of whether or not the block is intact
+     *     is returned.
+     */
+    bool IsBlockIntact(
+        const FrameHeader& header,
+        const FrameBlock& block
+    ) {
+        if (!header.checksums) {
+            return true;
+        }
+        return (
+            Crc32c(
+                block.data,
+                block.storedSize,
+                Crc32c(block.begin, BLOCK_SIZES_SIZE)
+            )
+            == block.checksum
+        );
+    }
+
+    /**
+     * This checks and decompresses blocks of a frame.  No block is
+     * decompressed unless its checksum matches.
+     *
+     * @param[in] header
+     *     This holds the information in the header of the frame.
+     *
+     * @param[in] blocks
+     *     These describe the blocks to decompress.
+     *
+     * @param[in] outputs
+     *     These point to where to store the decompressed blocks.
+     *
+     * @param[in] pool
+     *     If not null, this is used to check and decompress blocks
+     *     in parallel.
+     *
+     * @return
+     *     The index of the first block which is corrupt is returned,
+     *     or the number of blocks if none are.
+     */
+    size_t DecodeBlocks(
+        const FrameHeader& header,
+        const std::vector< FrameBlock >& blocks,
+        const std::vector< uint8_t* >& outputs,
+        WorkerPool* pool
+    ) {
+        std::vector< char > succeeded(blocks.size());
+        ParallelFor(
+            pool,
+            blocks.size(),
+            [&](size_t i){
+                const auto& block = blocks[i];
+                if (!IsBlockIntact(header, block)) {
+                    succeeded[i] = false;
+                } else if (block.stored) {
+                    (void)memcpy(outputs[i], block.data, block.size);
+                    succeeded[i] = true;
+                } else {
+                    succeeded[i] = header.codec->Decompress(
+                        BlobView(block.data, block.storedSize),
+                        outputs[i],
+                        block.size
+                    );
+                }
+            }
+        );
+        return (size_t)(
+            std::find(succeeded.begin(), succeeded.end(), false)
+            - succeeded.begin()
+        );
+    }
+
+    /**
+     * This forms the description of the error of finding a corrupt
+     * block in a frame.
+     *
+     * @param[in] index
+     *     This is the index of the block within the frame.
+     *
+     * @return
+     *     The description of the error is returned.
+     */
+    std::string CorruptBlockError(size_t index) {
+        return "corrupt block " + std::to_string(index) + " in snapshot frame";
+    }
+
+    /**
+     * This holds the results of walking through the blocks of
+     * a complete frame.
+     */
+    struct FrameLayout {
+        /**
+         * This holds the information in the header of the frame.
+         */
+        FrameHeader header;
+
+        /**
+         * These describe the blocks of the frame, in order, up to the
+         * end of the frame, or the first block which isn't valid.
+         */
+        std::vector< FrameBlock > blocks;
+
+        /**
+         * This is the number of bytes of the frame taken up by the
+         * header and the blocks described.
+         */
+        size_t blocksEnd = 0;
+
+        /**
+         * This flag is set if the block marking the end of the frame
+         * was found.
+         */
+        bool ended = false;
+
+        /**
+         * This gets a value if the frame isn't laid out properly.
+         */
+        std::string error;
+    };
+
+    /**
+     * This walks through the blocks of a complete frame, without
+     * checking or decompressing them.
+     *
+     * @param[in] frame
+     *     This is the frame to walk through.
+     *
+     * @return
+     *     The results of walking through the frame are returned.
+     */
+    FrameLayout LayOutFrame(BlobView frame) {
+        FrameLayout layout;
+        if (
+            (frame.size < SNAPSHOT_FRAME_HEADER_SIZE)
+            || (memcmp(frame.data, MAGIC, sizeof(MAGIC)) != 0)
+        ) {
+            layout.error = "not a snapshot frame";
+            return layout;
+        }
+        layout.error = DecodeFrameHeader(frame.data, layout.header);
+        if (!layout.error.empty()) {
+            return layout;
+        }
+        auto next = frame.data + SNAPSHOT_FRAME_HEADER_SIZE;
+        const auto end = frame.data + frame.size;
+        for (;;) {
+            layout.blocksEnd = (size_t)(next - frame.data);
+            FrameBlock block;
+            size_t consumed;
+            bool last;
+            layout.error = DecodeBlock(next, end, layout.header, block, consumed, last);
+            if (!layout.error.empty()) {
+                return layout;
+            }
+            if (consumed == 0) {
+                layout.error = "truncated snapshot frame";
+                return layout;
+            }
+            next += consumed;
+            if (last) {
+                break;
+            }
+            layout.blocks.push_back(block);
+        }
+        layout.ended = true;
+        if (next != end) {
+            layout.error = "extra data after end of snapshot frame";
+        }
+        return layout;
+    }
+
+}
+
+namespace DatabaseAbstractions {
+
+    void RegisterSnapshotCodec(std::shared_ptr< const SnapshotCodec > codec) {
+        auto& registry = GetRegistry();
+        std::lock_guard< decltype(registry.mutex) > lock(registry.mutex);
+        registry.codecs[codec->GetId()] = codec;
+    }
+
+    std::shared_ptr< const SnapshotCodec > GetSnapshotCodec(uint8_t id) {
+        auto& registry = GetRegistry();
+        std::lock_guard< decltype(registry.mutex) > lock(registry.mutex);
+        return registry.codecs[id];
+    }
+
+    bool IsSnapshotFrame(BlobView data) {
+        return (
+            (data.size >= SNAPSHOT_FRAME_HEADER_SIZE)
+            && (memcmp(data.data, MAGIC, sizeof(MAGIC)) == 0)
+        );
+    }
+
+    Blob CompressSnapshot(
+        BlobView snapshot,
+        const SnapshotCodec& codec,
+        size_t blockSize,
+        WorkerPool* pool
+    ) {
+        blockSize = std::min(std::max(blockSize, (size_t)1), MAX_BLOCK_SIZE);
+        const auto blockCount = (snapshot.size + blockSize - 1) / blockSize;
+        std::vector< Blob > blocks(blockCount);
+        ParallelFor(
+            pool,
+            blockCount,
+            [&](size_t i){
+                const auto offset = i * blockSize;
+                EncodeBlock(
+                    codec,
+                    BlobView(
+                        snapshot.data + offset,
+                        std::min(blockSize, snapshot.size - offset)
+                    ),
+                    blocks[i]
+                );
+            }
+        );
+        size_t frameSize = SNAPSHOT_FRAME_HEADER_SIZE + SNAPSHOT_FRAME_BLOCK_HEADER_SIZE;
+        for (const auto& block: blocks) {
+            frameSize += block.size();
+        }
+        Blob frame;
+        frame.reserve(frameSize);
+        EncodeFrameHeader(codec, blockSize, frame);
+        for (const auto& block: blocks) {
+            frame.insert(frame.end(), block.begin(), block.end());
+        }
+        EncodeEndBlock(frame);
+        return frame;
+    }
+
+    SnapshotFrameVerification VerifySnapshotFrame(
+        BlobView frame,
+        WorkerPool* pool
+    ) {
+        SnapshotFrameVerification verification;
+        const auto layout = LayOutFrame(frame);
+        if (layout.blocksEnd == 0) {
+            verification.error = layout.error;
+            return verification;
+        }
+        std::vector< char > intact(layout.blocks.size());
+        ParallelFor(
+            pool,
+            layout.blocks.size(),
+            [&](size_t i){
+                intact[i] = IsBlockIntact(layout.header, layout.blocks[i]);
+            }
+        );
+        verification.intactBlocks = (size_t)(
+            std::find(intact.begin(), intact.end(), false)
+            - intact.begin()
+        );
+        if (verification.intactBlocks < layout.blocks.size()) {
+            verification.error = CorruptBlockError(verification.intactBlocks);
+            verification.intactBytes = (size_t)(
+                layout.blocks[verification.intactBlocks].begin - frame.data
+            );
+            return verification;
+        }
+        verification.error = layout.error;
+        verification.intactBytes = (
+            layout.ended
+            ? layout.blocksEnd + layout.header.blockHeaderSize
+            : layout.blocksEnd
+        );
+        return verification;
+    }
+
+    std::string DecompressSnapshot(
+        BlobView frame,
+        Blob& snapshot,
+        WorkerPool* pool
+    ) {
+        const auto layout = LayOutFrame(frame);
+        if (!layout.error.empty()) {
+            return layout.error;
+        }
+        size_t size = 0;
+        for (const auto& block: layout.blocks) {
+            size += block.size;
+        }
+        snapshot.resize(size);
+        std::vector< uint8_t* > outputs;
+        outputs.reserve(layout.blocks.size());
+        size = 0;
+        for (const auto& block: layout.blocks) {
+            outputs.push_back(snapshot.data() + size);
+            size += block.size;
+        }
+        const auto firstCorrupt = DecodeBlocks(layout.header, layout.blocks, outputs, pool);
+        if (firstCorrupt < layout.blocks.size()) {
+            return CorruptBlockError(firstCorrupt);
+        }
+        return "";
+    }
+
+    struct CompressingSnapshotReader::Impl {
+        // Properties
+
+        /**
+         * This is the reader of the snapshot to compress.
+         */
+        std::shared_ptr< SnapshotReader > reader;
+
+        /**
+         * This is the maximum number of bytes in each chunk.
+         */
+        size_t chunkSize = 0;
+
+        /**
+         * This is the codec to use.
+         */
+        std::shared_ptr< const SnapshotCodec > codec;
+
+        /**
+         * This is the number of bytes of the snapshot to compress
+         * in each block.
+         */
+        size_t blockSize = 0;
+
+        /**
+         * If not null, this is used to compress blocks in parallel.
+         */
+        std::shared_ptr< WorkerPool > pool;
+
+        /**
+         * This holds snapshot data read but not yet compressed.
+         */
+        Blob input;
+
+        /**
+         * This holds the part of the frame formed but not yet read.
+         */
+        Blob output;
+
+        /**
+         * This is the offset of the first byte of the output
+         * not yet read.
+         */
+        size_t outputOffset = 0;
+
+        /**
+         * This flag is set once the last chunk of the snapshot
+         * has been read.
+         */
+        bool inputDone = false;
+
+        /**
+         * This flag is set once the whole frame has been formed.
+         */
+        bool outputDone = false;
+
+        // Methods
+
+        /**
+         * This reads snapshot data until there's enough for one block
+         * per thread in the pool, compresses it, and adds it to the
+         * output.
+         *
+         * @return
+         *     If an error occurs, a description of the error is returned.
+         *     Otherwise, an empty string is returned.
+         */
+        std::string Refill() {
+            const auto batchBlocks = (
+                (pool == nullptr)
+                ? (size_t)1
+                : std::max(pool->GetThreadCount(), (size_t)1)
+            );
+            Blob chunk;
+            while (
+                !inputDone
+                && (input.size() < batchBlocks * blockSize)
+            ) {
+                const auto results = reader->ReadChunk(chunk);
+                if (!results.error.empty()) {
+                    return results.error;
+                }
+                if (results.done) {
+                    inputDone = true;
+                } else {
+                    input.insert(input.end(), chunk.begin(), chunk.end());
+                }
+            }
+            const auto blockCount = std::min(
+                batchBlocks,
+                (input.size() + blockSize - 1) / blockSize
+            );
+            std::vector< Blob > blocks(blockCount);
+            ParallelFor(
+                pool.get(),
+                blockCount,
+                [&](size_t i){
+                    const auto offset = i * blockSize;
+                    EncodeBlock(
+                        *codec,
+                        BlobView(
+                            input.data() + offset,
+                            std::min(blockSize, input.size() - offset)
+                        ),
+                        blocks[i]
+                    );
+                }
+            );
+            for (const auto& block: blocks) {
+                output.insert(output.end(), block.begin(), block.end());
+            }
+            input.erase(
+                input.begin(),
+                input.begin() + std::min(input.size(), blockCount * blockSize)
+            );
+            if (
+                inputDone
+                && input.empty()
+            ) {
+                EncodeEndBlock(output);
+                outputDone = true;
+            }
+            return "";
+        }
+    };
+
+    CompressingSnapshotReader::~CompressingSnapshotReader() noexcept = default;
+    CompressingSnapshotReader::CompressingSnapshotReader(CompressingSnapshotReader&&) noexcept = default;
+    CompressingSnapshotReader& CompressingSnapshotReader::operator=(CompressingSnapshotReader&&) noexcept = default;
+
+    CompressingSnapshotReader::CompressingSnapshotReader(
+        std::shared_ptr< SnapshotReader > reader,
+        size_t chunkSize,
+        std::shared_ptr< const SnapshotCodec > codec,
+        size_t blockSize,
+        std::shared_ptr< WorkerPool > pool
+    )
+        : impl_(new Impl())
+    {
+        impl_->reader = reader;
+        impl_->chunkSize = std::max(chunkSize, (size_t)1);
+        impl_->codec = codec;
+        impl_->blockSize = std::min(std::max(blockSize, (size_t)1), MAX_BLOCK_SIZE);
+        impl_->pool = pool;
+        EncodeFrameHeader(*codec, impl_->blockSize, impl_->output);
+    }
+
+    ReadSnapshotChunkResults CompressingSnapshotReader::ReadChunk(Blob& chunk) {
+        ReadSnapshotChunkResults results;
+        while (
+            !impl_->outputDone
+            && (impl_->output.size() - impl_->outputOffset < impl_->chunkSize)
+        ) {
+            results.error = impl_->Refill();
+            if (!results.error.empty()) {
+                chunk.clear();
+                return results;
+            }
+        }
+        const auto size = std::min(
+            impl_->output.size() - impl_->outputOffset,
+            impl_->chunkSize
+        );
+        const auto begin = impl_->output.begin() + impl_->outputOffset;
+        chunk.assign(begin, begin + size);
+        impl_->outputOffset += size;
+        if (impl_->outputOffset == impl_->output.size()) {
+            impl_->output.clear();
+            impl_->outputOffset = 0;
+        }
+        results.done = (size == 0);
+        return results;
+    }
+
+    struct DecompressingSnapshotWriter::Impl {
+        // Types
+
+        /**
+         * These are the forms the data written may turn out to take.
+         */
+        enum class Mode {
+            /**
+             * Not enough has been written yet to tell.
+             */
+            Detecting,
+
+            /**
+             * The data is a frame.
+             */
+            Frame,
+
+            /**
+             * The data isn't a frame, and is passed on as is.
+             */
+            Raw,
+        };
+
+        // Properties
+
+        /**
+         * This is the writer to which to pass the decompressed snapshot.
+         */
+        std::shared_ptr< SnapshotWriter > writer;
+
+        /**
+         * If not null, this is used to decompress blocks in parallel.
+         */
+        std::shared_ptr< WorkerPool > pool;
+
+        /**
+         * This is the form the data written has turned out to take.
+         */
+        Mode mode = Mode::Detecting;
+
+        /**
+         * This holds the information in the header of the frame.
+         */
+        FrameHeader header;
+
+        /**
+         * This holds data written but not yet decompressed.
+         */
+        Blob input;
+
+        /**
+         * This is the number of bytes of the frame accepted so far.
+         */
+        uint64_t accepted = 0;
+
+        /**
+         * This is the number of blocks of the frame decompressed so far.
+         */
+        size_t blocksDone = 0;
+
+        /**
+         * This flag is set once the block marking the end of the
+         * frame has been written.
+         */
+        bool frameDone = false;
+
+        // Methods
+
+        /**
+         * This checks and decompresses all the complete blocks written
+         * so far, and passes them on.  If a block is corrupt, the blocks
+         * before it are still passed on, while it and everything written
+         * after it is discarded, so that the frame may be written again
+         * starting from the corrupt block.
+         *
+         * @return
+         *     If an error occurs, a description of the error is returned.
+         *     Otherwise, an empty string is returned.
+         */
+        std::string DecodeAvailable() {
+            std::vector< FrameBlock > blocks;
+            std::vector< size_t > ends;
+            std::string error;
+            size_t size = 0;
+            auto next = input.data();
+            const auto end = next + input.size();
+            bool ended = false;
+            while (!ended) {
+                FrameBlock block;
+                size_t consumed;
+                bool last;
+                error = DecodeBlock(next, end, header, block, consumed, last);
+                if (
+                    !error.empty()
+                    || (consumed == 0)
+                ) {
+                    break;
+                }
+                next += consumed;
+                if (last) {
+                    ended = true;
+                } else {
+                    blocks.push_back(block);
+                    ends.push_back((size_t)(next - input.data()));
+                    size += block.size;
+                }
+            }
+            if (
+                ended
+                && (next != end)
+            ) {
+                error = "extra data after end of snapshot frame";
+                ended = false;
+                next = input.data() + (ends.empty() ? 0 : ends.back());
+            }
+            Blob output(size);
+            std::vector< uint8_t* > outputs;
+            outputs.reserve(blocks.size());
+            size = 0;
+            for (const auto& block: blocks) {
+                outputs.push_back(output.data() + size);
+                size += block.size;
+            }
+            const auto goodBlocks = DecodeBlocks(header, blocks, outputs, pool.get());
+            if (goodBlocks < blocks.size()) {
+                error = CorruptBlockError(blocksDone + goodBlocks);
+                ended = false;
+                next = input.data() + ((goodBlocks == 0) ? 0 : ends[goodBlocks - 1]);
+                size = (size_t)(outputs[goodBlocks] - output.data());
+            }
+            blocksDone += goodBlocks;
+            frameDone = ended;
+            const auto consumed = (size_t)(next - input.data());
+            accepted += consumed;
+            if (error.empty()) {
+                input.erase(input.begin(), input.begin() + consumed);
+            } else {
+                input.clear();
+            }
+            if (size > 0) {
+                const auto writeError = writer->WriteChunk(BlobView(output.data(), size));
+                if (!writeError.empty()) {
+                    return writeError;
+                }
+            }
+            return error;
+        }
+    };
+
+    DecompressingSnapshotWriter::~DecompressingSnapshotWriter() noexcept = default;
+    DecompressingSnapshotWriter::DecompressingSnapshotWriter(DecompressingSnapshotWriter&&) noexcept = default;
+    DecompressingSnapshotWriter& DecompressingSnapshotWriter::operator=(DecompressingSnapshotWriter&&) noexcept = default;
+
+    DecompressingSnapshotWriter::DecompressingSnapshotWriter(
+        std::shared_ptr< SnapshotWriter > writer,
+        std::shared_ptr< WorkerPool > pool
+    )
+        : impl_(new Impl())
+    {
+        impl_->writer = writer;
+        impl_->pool = pool;
+    }
+
+    uint64_t DecompressingSnapshotWriter::GetResumeOffset() const {
+        return impl_->accepted;
+    }
+
+    std::string DecompressingSnapshotWriter::WriteChunk(BlobView chunk) {
+        if (impl_->mode == Impl::Mode::Raw) {
+            impl_->accepted += chunk.size;
+            return impl_->writer->WriteChunk(chunk);
+        }
+        if (impl_->frameDone) {
+            return ((chunk.size == 0) ? "" : "extra data after end of snapshot frame");
+        }
+        impl_->input.insert(impl_->input.end(), chunk.data, chunk.data + chunk.size);
+        if (impl_->mode == Impl::Mode::Detecting) {
+            const auto prefix = std::min(impl_->input.size(), sizeof(MAGIC));
+            if (memcmp(impl_->input.data(), MAGIC, prefix) != 0) {
+                impl_->mode = Impl::Mode::Raw;
+                Blob input;
+                input.swap(impl_->input);
+                impl_->accepted += input.size();
+                return impl_->writer->WriteChunk(input);
+            }
+            if (impl_->input.size() < SNAPSHOT_FRAME_HEADER_SIZE) {
+                return "";
+            }
+            const auto error = DecodeFrameHeader(impl_->input.data(), impl_->header);
+            if (!error.empty()) {
+                impl_->input.clear();
+                return error;
+            }
+            impl_->input.erase(
+                impl_->input.begin(),
+                impl_->input.begin() + SNAPSHOT_FRAME_HEADER_SIZE
+            );
+            impl_->accepted += SNAPSHOT_FRAME_HEADER_SIZE;
+            impl_->mode = Impl::Mode::Frame;
+        }
+        return impl_->DecodeAvailable();
+    }
+
+    std::string DecompressingSnapshotWriter::Finish() {
+        if (impl_->mode == Impl::Mode::Detecting) {
+            if (!impl_->input.empty()) {
+                Blob input;
+                input.swap(impl_->input);
+                impl_->accepted += input.size();
+                const auto error = impl_->writer->WriteChunk(input);
+                if (!error.empty()) {
+                    return error;
+                }
+            }
+        } else if (
+            (impl_->mode == Impl::Mode::Frame)
+            && !impl_->frameDone
+        ) {
+            return "truncated snapshot frame";
+        }
+        return impl_->writer->Finish();
+    }
+
+}
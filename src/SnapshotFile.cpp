@@ -0,0 +1,421 @@
+/**
+ * @file SnapshotFile.cpp
+ *
+ * This file contains the implementation of the functions which store
+ * database snapshots in files and install them from files.
+ */
+
+#include "MappedFile.hpp"
+
+#include <algorithm>
+#include <DatabaseAbstractions/Crc32c.hpp>
+#include <DatabaseAbstractions/SnapshotFile.hpp>
+#include <stdio.h>
+#include <string.h>
+
+#include <vector>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#include <share.h>
+#include <sys/stat.h>
+#else /* POSIX */
+#include <fcntl.h>
+#include <stdlib.h>
+#include <unistd.h>
+#endif /* _WIN32 / POSIX */
+
+namespace {
+
+    using namespace DatabaseAbstractions;
+
+    /**
+     * This is used to identify snapshot files.
+     */
+    const uint8_t MAGIC[8] = {'D', 'B', 'S', 'N', 'A', 'P', 'S', 'H'};
+
+    /**
+     * This is the number of bytes of the header which are covered
+     * by the header's own checksum.
+     */
+    constexpr size_t HEADER_CHECKED_SIZE = SNAPSHOT_FILE_HEADER_SIZE - 4;
+
+    /**
+     * This is the number of bytes to move at a time between
+     * the database and the file.
+     */
+    constexpr size_t CHUNK_SIZE = 1024 * 1024;
+
+    /**
+     * This stores the given integer in little-endian byte order.
+     *
+     * @param[in] value
+     *     This is the integer to store.
+     *
+     * @param[in] size
+     *     This is the number of bytes to store.
+     *
+     * @param[out] buffer
+     *     This is where to store the integer.
+     */
+    void EncodeInteger(
+        uint64_t value,
+        size_t size,
+        uint8_t* buffer
+    ) {
+        for (size_t i = 0; i < size; ++i) {
+            buffer[i] = (uint8_t)(value >> (i * 8));
+        }
+    }
+
+    /**
+     * This loads an integer stored in little-endian byte order.
+     *
+     * @param[in] buffer
+     *     This is where the integer is stored.
+     *
+     * @param[in] size
+     *     This is the number of bytes in which the integer is stored.
+     *
+     * @return
+     *     The integer is returned.
+     */
+    uint64_t DecodeInteger(
+        const uint8_t* buffer,
+        size_t size
+    ) {
+        uint64_t value = 0;
+        for (size_t i = 0; i < size; ++i) {
+            value |= ((uint64_t)buffer[i] << (i * 8));
+        }
+        return value;
+    }
+
+    /**
+     * This forms the header of a snapshot file.
+     *
+     * @param[in] header
+     *     This is the information to store in the header.
+     *
+     * @param[out] buffer
+     *     This is where to store the header.
+     */
+    void EncodeHeader(
+        const SnapshotFileHeader& header,
+        uint8_t* buffer
+    ) {
+        (void)memcpy(buffer, MAGIC, sizeof(MAGIC));
+        EncodeInteger(header.version, 4, buffer + 8);
+        EncodeInteger(0, 4, buffer + 12);
+        EncodeInteger(header.schemaHash, 8, buffer + 16);
+        EncodeInteger(header.length, 8, buffer + 24);
+        EncodeInteger(header.checksum, 4, buffer + 32);
+        EncodeInteger(Crc32c(buffer, HEADER_CHECKED_SIZE), 4, buffer + HEADER_CHECKED_SIZE);
+    }
+
+    /**
+     * This extracts and validates the information in the header
+     * of a snapshot file.
+     *
+     * @param[in] buffer
+     *     This is where the header is stored.
+     *
+     * @param[in] size
+     *     This is the number of bytes available in the buffer.
+     *
+     * @param[out] header
+     *     This is where to store the information from the header.
+     *
+     * @return
+     *     If the header is invalid, a description of the problem
+     *     is returned.  Otherwise, an empty string is returned.
+     */
+    std::string DecodeHeader(
+        const uint8_t* buffer,
+        size_t size,
+        SnapshotFileHeader& header
+    ) {
+        if (
+            (size < SNAPSHOT_FILE_HEADER_SIZE)
+            || (memcmp(buffer, MAGIC, sizeof(MAGIC)) != 0)
+        ) {
+            return "not a snapshot file";
+        }
+        const auto headerChecksum = (uint32_t)DecodeInteger(buffer + HEADER_CHECKED_SIZE, 4);
+        if (headerChecksum != Crc32c(buffer, HEADER_CHECKED_SIZE)) {
+            return "snapshot file header is corrupt";
+        }
+        header.version = (uint32_t)DecodeInteger(buffer + 8, 4);
+        if (header.version != SNAPSHOT_FILE_VERSION) {
+            return "unsupported snapshot file version " + std::to_string(header.version);
+        }
+        header.schemaHash = DecodeInteger(buffer + 16, 8);
+        header.length = DecodeInteger(buffer + 24, 8);
+        header.checksum = (uint32_t)DecodeInteger(buffer + 32, 4);
+        return "";
+    }
+
+    /**
+     * This flushes everything written to the given file to disk.
+     *
+     * @param[in] file
+     *     This is the file to flush.
+     *
+     * @return
+     *     An indication of whether or not the file was flushed
+     *     successfully is returned.
+     */
+    bool FlushToDisk(FILE* file) {
+        if (fflush(file) != 0) {
+            return false;
+        }
+#ifdef _WIN32
+        return (_commit(_fileno(file)) == 0);
+#else /* POSIX */
+        return (fsync(fileno(file)) == 0);
+#endif /* _WIN32 / POSIX */
+    }
+
+    /**
+     * This flushes to disk the entries of the directory holding the
+     * file with the given path, so that a file renamed into it
+     * survives a crash.
+     *
+     * @param[in] path
+     *     This is the path of a file in the directory to flush.
+     *
+     * @return
+     *     An indication of whether or not the directory was flushed
+     *     successfully is returned.
+     */
+    bool FlushDirectoryToDisk(const std::string& path) {
+#ifdef _WIN32
+        (void)path;
+        return true;
+#else /* POSIX */
+        const auto delimiter = path.find_last_of('/');
+        const auto directory = (
+            (delimiter == std::string::npos)
+            ? std::string(".")
+            : path.substr(0, std::max(delimiter, (size_t)1))
+        );
+        const auto handle = open(directory.c_str(), O_RDONLY);
+        if (handle < 0) {
+            return false;
+        }
+        const auto flushed = (fsync(handle) == 0);
+        return ((close(handle) == 0) && flushed);
+#endif /* _WIN32 / POSIX */
+    }
+
+    /**
+     * This creates and opens for writing a new file, with a unique name
+     * formed from the given path, in the same directory.  The name is
+     * chosen and the file created in one step, so that two writers of
+     * the same path never write to the same temporary file.
+     *
+     * @param[in] path
+     *     This is the path from which to form the name of the file.
+     *
+     * @param[out] temporaryPath
+     *     This is where to store the path of the file created.
+     *
+     * @return
+     *     The open file is returned, or NULL if it couldn't be created.
+     */
+    FILE* CreateTemporaryFile(
+        const std::string& path,
+        std::string& temporaryPath
+    ) {
+        const std::string pattern = path + ".XXXXXX";
+        std::vector< char > name(pattern.begin(), pattern.end());
+        name.push_back('\0');
+#ifdef _WIN32
+        if (_mktemp_s(name.data(), name.size()) != 0) {
+            return NULL;
+        }
+        int handle;
+        if (
+            _sopen_s(
+                &handle,
+                name.data(),
+                _O_CREAT | _O_EXCL | _O_WRONLY | _O_BINARY,
+                _SH_DENYNO,
+                _S_IREAD | _S_IWRITE
+            ) != 0
+        ) {
+            return NULL;
+        }
+        const auto file = _fdopen(handle, "wb");
+        if (file == NULL) {
+            (void)_close(handle);
+        }
+#else /* POSIX */
+        const auto handle = mkstemp(name.data());
+        if (handle < 0) {
+            return NULL;
+        }
+        const auto file = fdopen(handle, "wb");
+        if (file == NULL) {
+            (void)close(handle);
+        }
+#endif /* _WIN32 / POSIX */
+        temporaryPath = name.data();
+        if (file == NULL) {
+            (void)remove(temporaryPath.c_str());
+        }
+        return file;
+    }
+
+    /**
+     * This writes a snapshot of the given database into the given file,
+     * leaving room for the header at the start, and returns the header
+     * describing it.
+     *
+     * @param[in] database
+     *     This is the database to snapshot.
+     *
+     * @param[in] file
+     *     This is the file in which to write the snapshot.
+     *
+     * @param[in,out] header
+     *     This is where to store the length and checksum
+     *     of the snapshot.
+     *
+     * @return
+     *     If an error occurs, a description of the error is returned.
+     *     Otherwise, an empty string is returned.
+     */
+    std::string WriteSnapshot(
+        Database& database,
+        FILE* file,
+        SnapshotFileHeader& header
+    ) {
+        uint8_t placeholder[SNAPSHOT_FILE_HEADER_SIZE] = {0};
+        if (fwrite(placeholder, sizeof(placeholder), 1, file) != 1) {
+            return "unable to write snapshot file header";
+        }
+        const auto reader = database.CreateSnapshotReader(CHUNK_SIZE);
+        Blob chunk;
+        for (;;) {
+            const auto results = reader->ReadChunk(chunk);
+            if (!results.error.empty()) {
+                return results.error;
+            }
+            if (results.done) {
+                break;
+            }
+            if (fwrite(chunk.data(), chunk.size(), 1, file) != 1) {
+                return "unable to write snapshot to file";
+            }
+            header.checksum = Crc32c(chunk.data(), chunk.size(), header.checksum);
+            header.length += chunk.size();
+        }
+        uint8_t buffer[SNAPSHOT_FILE_HEADER_SIZE];
+        EncodeHeader(header, buffer);
+        if (
+            (fseek(file, 0, SEEK_SET) != 0)
+            || (fwrite(buffer, sizeof(buffer), 1, file) != 1)
+        ) {
+            return "unable to write snapshot file header";
+        }
+        if (!FlushToDisk(file)) {
+            return "unable to flush snapshot file to disk";
+        }
+        return "";
+    }
+
+}
+
+namespace DatabaseAbstractions {
+
+    std::string CreateSnapshotFile(
+        Database& database,
+        const std::string& path,
+        uint64_t schemaHash
+    ) {
+        std::string temporaryPath;
+        const auto file = CreateTemporaryFile(path, temporaryPath);
+        if (file == NULL) {
+            return "unable to create temporary snapshot file for '" + path + "'";
+        }
+        SnapshotFileHeader header;
+        header.version = SNAPSHOT_FILE_VERSION;
+        header.schemaHash = schemaHash;
+        auto error = WriteSnapshot(database, file, header);
+        if (fclose(file) != 0) {
+            if (error.empty()) {
+                error = "unable to close snapshot file '" + temporaryPath + "'";
+            }
+        }
+        if (error.empty()) {
+#ifdef _WIN32
+            (void)remove(path.c_str());
+#endif /* _WIN32 */
+            if (rename(temporaryPath.c_str(), path.c_str()) != 0) {
+                error = "unable to rename snapshot file to '" + path + "'";
+            } else if (!FlushDirectoryToDisk(path)) {
+                error = "unable to flush directory of snapshot file '" + path + "' to disk";
+            }
+        }
+        if (!error.empty()) {
+            (void)remove(temporaryPath.c_str());
+        }
+        return error;
+    }
+
+    std::string ReadSnapshotFileHeader(
+        const std::string& path,
+        SnapshotFileHeader& header
+    ) {
+        const auto file = fopen(path.c_str(), "rb");
+        if (file == NULL) {
+            return "unable to open snapshot file '" + path + "'";
+        }
+        uint8_t buffer[SNAPSHOT_FILE_HEADER_SIZE];
+        const auto size = fread(buffer, 1, sizeof(buffer), file);
+        (void)fclose(file);
+        return DecodeHeader(buffer, size, header);
+    }
+
+    std::string InstallSnapshotFile(
+        Database& database,
+        const std::string& path,
+        uint64_t schemaHash
+    ) {
+        MappedFile mappedFile;
+        auto error = mappedFile.Open(path);
+        if (!error.empty()) {
+            return error;
+        }
+        const auto data = mappedFile.GetData();
+        const auto size = mappedFile.GetSize();
+        SnapshotFileHeader header;
+        error = DecodeHeader(data, size, header);
+        if (!error.empty()) {
+            return error;
+        }
+        if (header.schemaHash != schemaHash) {
+            return "snapshot file was made for a different schema";
+        }
+        if (header.length != size - SNAPSHOT_FILE_HEADER_SIZE) {
+            return "snapshot file length does not match its header";
+        }
+        const auto snapshot = data + SNAPSHOT_FILE_HEADER_SIZE;
+        const auto length = (size_t)header.length;
+        if (Crc32c(snapshot, length) != header.checksum) {
+            return "snapshot file is corrupt";
+        }
+        const auto writer = database.CreateSnapshotWriter();
+        for (size_t offset = 0; offset < length; offset += CHUNK_SIZE) {
+            const auto chunkSize = std::min(CHUNK_SIZE, length - offset);
+            error = writer->WriteChunk(BlobView(snapshot + offset, chunkSize));
+            if (!error.empty()) {
+                return error;
+            }
+        }
+        return writer->Finish();
+    }
+
+}
@@ -0,0 +1,1243 @@
+/**
+ * @file SqlParser.cpp
+ *
+ * This module contains the implementation of the parser for the subset
+ * of SQL understood by the DatabaseAbstractions::InMemoryDatabase class.
+ */
+
+#include "SqlParser.hpp"
+
+#include <ctype.h>
+#include <errno.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+namespace {
+
+    using namespace DatabaseAbstractions;
+    using namespace DatabaseAbstractions::Sql;
+
+    /**
+     * This is the largest index a parameter may have, the same as the
+     * default limit in SQLite.
+     */
+    constexpr int MAX_PARAMETER_INDEX = 32766;
+
+    /**
+     * These are the kinds of tokens found in SQL text.
+     */
+    enum class TokenKind {
+        End,
+        Identifier,
+        Integer,
+        Real,
+        String,
+        Blob,
+        Parameter,
+        Symbol,
+    };
+
+    /**
+     * This represents one token found in SQL text.
+     */
+    struct Token {
+        /**
+         * This is the kind of token.
+         */
+        TokenKind kind = TokenKind::End;
+
+        /**
+         * This is the text of an identifier, string or symbol.
+         */
+        std::string text;
+
+        /**
+         * This flag is set if the token is an identifier which
+         * was quoted, and so can't be a keyword.
+         */
+        bool quoted = false;
+
+        /**
+         * This is the value of an integer, real or blob token.
+         */
+        Value value;
+
+        /**
+         * This is the index given with a parameter token,
+         * or zero if none was given.
+         */
+        int parameter = 0;
+    };
+
+    /**
+     * This returns the value of the given hexadecimal digit.
+     *
+     * @param[in] c
+     *     This is the hexadecimal digit.
+     *
+     * @return
+     *     The value of the digit is returned, or -1 if it isn't
+     *     a hexadecimal digit.
+     */
+    int HexDigitValue(char c) {
+        if ((c >= '0') && (c <= '9')) {
+            return c - '0';
+        } else if ((c >= 'a') && (c <= 'f')) {
+            return c - 'a' + 10;
+        } else if ((c >= 'A') && (c <= 'F')) {
+            return c - 'A' + 10;
+        } else {
+            return -1;
+        }
+    }
+
+    /**
+     * This breaks SQL text into tokens, one statement at a time.
+     */
+    class Tokenizer {
+        // Lifecycle
+    public:
+        Tokenizer(
+            const std::string& text,
+            size_t offset
+        )
+            : text_(text)
+            , offset_(offset)
+        {
+        }
+
+        // Methods
+    public:
+        /**
+         * This breaks the next statement into tokens.
+         *
+         * @param[out] tokens
+         *     This is where to store the tokens.  The last one is always
+         *     an End token, marking the end of the statement.
+         *
+         * @return
+         *     If the text can't be broken into tokens, a description of
+         *     the problem is returned.  Otherwise, an empty string
+         *     is returned.
+         */
+        std::string Tokenize(std::vector< Token >& tokens) {
+            for (;;) {
+                SkipWhitespace();
+                Token token;
+                if (
+                    (offset_ >= text_.length())
+                    || (text_[offset_] == ';')
+                ) {
+                    if (offset_ < text_.length()) {
+                        ++offset_;
+                    }
+                    tokens.push_back(std::move(token));
+                    return "";
+                }
+                const auto error = NextToken(token);
+                if (!error.empty()) {
+                    return error;
+                }
+                tokens.push_back(std::move(token));
+            }
+        }
+
+        /**
+         * This returns the offset of the first character in the SQL text
+         * which hasn't been broken into tokens yet.
+         *
+         * @return
+         *     The offset of the first character not yet broken into
+         *     tokens is returned.
+         */
+        size_t GetOffset() const {
+            return offset_;
+        }
+
+        // Private Methods
+    private:
+        /**
+         * This advances past any whitespace and comments.
+         */
+        void SkipWhitespace() {
+            while (offset_ < text_.length()) {
+                const auto c = text_[offset_];
+                if (isspace((unsigned char)c)) {
+                    ++offset_;
+                } else if (text_.compare(offset_, 2, "--") == 0) {
+                    const auto end = text_.find('\n', offset_);
+                    offset_ = ((end == std::string::npos) ? text_.length() : end + 1);
+                } else {
+                    break;
+                }
+            }
+        }
+
+        /**
+         * This extracts the next token, which is known to exist.
+         *
+         * @param[out] token
+         *     This is where to store the token.
+         *
+         * @return
+         *     If the token is invalid, a description of the problem
+         *     is returned.  Otherwise, an empty string is returned.
+         */
+        std::string NextToken(Token& token) {
+            const auto c = text_[offset_];
+            if (
+                ((c == 'x') || (c == 'X'))
+                && (offset_ + 1 < text_.length())
+                && (text_[offset_ + 1] == '\'')
+            ) {
+                ++offset_;
+                return BlobToken(token);
+            } else if (isalpha((unsigned char)c) || (c == '_')) {
+                const auto start = offset_;
+                while (
+                    (offset_ < text_.length())
+                    && (
+                        isalnum((unsigned char)text_[offset_])
+                        || (text_[offset_] == '_')
+                    )
+                ) {
+                    ++offset_;
+                }
+                token.kind = TokenKind::Identifier;
+                token.text = text_.substr(start, offset_ - start);
+            } else if ((c == '"') || (c == '`') || (c == '[')) {
+                const auto close = ((c == '[') ? ']' : c);
+                const auto end = text_.find(close, offset_ + 1);
+                if (end == std::string::npos) {
+                    return "unterminated quoted identifier";
+                }
+                token.kind = TokenKind::Identifier;
+                token.text = text_.substr(offset_ + 1, end - offset_ - 1);
+                token.quoted = true;
+                offset_ = end + 1;
+            } else if (c == '\'') {
+                return StringToken(token);
+            } else if (
+                isdigit((unsigned char)c)
+                || (
+                    (c == '.')
+                    && (offset_ + 1 < text_.length())
+                    && isdigit((unsigned char)text_[offset_ + 1])
+                )
+            ) {
+                return NumberToken(token);
+            } else if (c == '?') {
+                ++offset_;
+                token.kind = TokenKind::Parameter;
+                const auto start = offset_;
+                while (
+                    (offset_ < text_.length())
+                    && isdigit((unsigned char)text_[offset_])
+                ) {
+                    ++offset_;
+                }
+                if (offset_ > start) {
+                    int index = 0;
+                    for (auto i = start; i < offset_; ++i) {
+                        index = index * 10 + (text_[i] - '0');
+                        if (index > MAX_PARAMETER_INDEX) {
+                            break;
+                        }
+                    }
+                    if (
+                        (index <= 0)
+                        || (index > MAX_PARAMETER_INDEX)
+                    ) {
+                        return (
+                            "variable number must be between ?1 and ?"
+                            + std::to_string(MAX_PARAMETER_INDEX)
+                        );
+                    }
+                    token.parameter = index;
+                }
+            } else {
+                static const char* const symbols[] = {
+                    "<=", ">=", "<>", "!=", "==",
+                    "(", ")", ",", "*", "=", "<", ">", "-", "+",
+                };
+                for (const auto symbol: symbols) {
+                    if (text_.compare(offset_, strlen(symbol), symbol) == 0) {
+                        token.kind = TokenKind::Symbol;
+                        token.text = symbol;
+                        offset_ += token.text.length();
+                        return "";
+                    }
+                }
+                return std::string("unexpected character '") + c + "'";
+            }
+            return "";
+        }
+
+        /**
+         * This extracts a string literal token.
+         *
+         * @param[out] token
+         *     This is where to store the token.
+         *
+         * @return
+         *     If the token is invalid, a description of the problem
+         *     is returned.  Otherwise, an empty string is returned.
+         */
+        std::string StringToken(Token& token) {
+            token.kind = TokenKind::String;
+            ++offset_;
+            for (;;) {
+                if (offset_ >= text_.length()) {
+                    return "unterminated string";
+                }
+                const auto c = text_[offset_++];
+                if (c == '\'') {
+                    if (
+                        (offset_ < text_.length())
+                        && (text_[offset_] == '\'')
+                    ) {
+                        token.text += '\'';
+                        ++offset_;
+                    } else {
+                        return "";
+                    }
+                } else {
+                    token.text += c;
+                }
+            }
+        }
+
+        /**
+         * This extracts a blob literal token, whose opening quote
+         * is at the current offset.
+         *
+         * @param[out] token
+         *     This is where to store the token.
+         *
+         * @return
+         *     If the token is invalid, a description of the problem
+         *     is returned.  Otherwise, an empty string is returned.
+         */
+        std::string BlobToken(Token& token) {
+            const auto end = text_.find('\'', offset_ + 1);
+            if (end == std::string::npos) {
+                return "unterminated blob";
+            }
+            const auto digits = text_.substr(offset_ + 1, end - offset_ - 1);
+            if (digits.length() % 2 != 0) {
+                return "blob literal has an odd number of digits";
+            }
+            Blob blob;
+            for (size_t i = 0; i < digits.length(); i += 2) {
+                const auto high = HexDigitValue(digits[i]);
+                const auto low = HexDigitValue(digits[i + 1]);
+                if ((high < 0) || (low < 0)) {
+                    return "invalid digit in blob literal";
+                }
+                blob.push_back((uint8_t)((high << 4) | low));
+            }
+            token.kind = TokenKind::Blob;
+            token.value = std::move(blob);
+            offset_ = end + 1;
+            return "";
+        }
+
+        /**
+         * This extracts a numeric literal token.
+         *
+         * @param[out] token
+         *     This is where to store the token.
+         *
+         * @return
+         *     If the token is invalid, a description of the problem
+         *     is returned.  Otherwise, an empty string is returned.
+         */
+        std::string NumberToken(Token& token) {
+            const auto start = text_.c_str() + offset_;
+            char* end;
+            errno = 0;
+            const auto integer = strtoll(start, &end, 10);
+            if (
+                (errno == 0)
+                && (*end != '.')
+                && (*end != 'e')
+                && (*end != 'E')
+            ) {
+                token.kind = TokenKind::Integer;
+                token.value = (intmax_t)integer;
+            } else {
+                const auto real = strtod(start, &end);
+                token.kind = TokenKind::Real;
+                token.value = real;
+            }
+            if (isalpha((unsigned char)*end) || (*end == '_')) {
+                return "invalid number";
+            }
+            offset_ += (size_t)(end - start);
+            return "";
+        }
+
+        // Private Properties
+    private:
+        /**
+         * This is the SQL text being broken into tokens.
+         */
+        const std::string& text_;
+
+        /**
+         * This is the offset of the next character to examine.
+         */
+        size_t offset_;
+    };
+
+    /**
+     * This builds statements from the tokens of SQL text.
+     */
+    class Parser {
+        // Lifecycle
+    public:
+        Parser(
+            const std::vector< Token >& tokens,
+            Statement& statement
+        )
+            : tokens_(tokens)
+            , statement_(statement)
+        {
+        }
+
+        // Methods
+    public:
+        /**
+         * This builds the statement from the tokens.
+         *
+         * @return
+         *     If the tokens don't form a valid statement, a description
+         *     of the problem is returned.  Otherwise, an empty string
+         *     is returned.
+         */
+        std::string Parse() {
+            std::string error;
+            if (Accept("CREATE")) {
+                error = ParseCreate();
+            } else if (Accept("DROP")) {
+                error = ParseDrop();
+            } else if (Accept("INSERT")) {
+                if (Accept("OR")) {
+                    if (!Accept("REPLACE")) {
+                        return Expected("REPLACE");
+                    }
+                    statement_.unique = true;
+                }
+                error = ParseInsert();
+            } else if (Accept("REPLACE")) {
+                statement_.unique = true;
+                error = ParseInsert();
+            } else if (Accept("SELECT")) {
+                error = ParseSelect();
+            } else if (Accept("UPDATE")) {
+                error = ParseUpdate();
+            } else if (Accept("DELETE")) {
+                error = ParseDelete();
+            } else if (Accept("BEGIN")) {
+                statement_.kind = StatementKind::Begin;
+                (void)Accept("TRANSACTION");
+            } else if (
+                Accept("COMMIT")
+                || Accept("END")
+            ) {
+                statement_.kind = StatementKind::Commit;
+                (void)Accept("TRANSACTION");
+            } else if (Accept("ROLLBACK")) {
+                statement_.kind = StatementKind::Rollback;
+                (void)Accept("TRANSACTION");
+            } else if (Peek().kind == TokenKind::End) {
+                return "empty statement";
+            } else {
+                return "unsupported statement";
+            }
+            if (!error.empty()) {
+                return error;
+            }
+            if (Peek().kind != TokenKind::End) {
+                return "unexpected '" + Peek().text + "' at end of statement";
+            }
+            statement_.parameterCount = nextParameter_ - 1;
+            return "";
+        }
+
+        // Private Methods
+    private:
+        /**
+         * This returns the next token, without consuming it.
+         *
+         * @return
+         *     The next token is returned.
+         */
+        const Token& Peek() const {
+            return tokens_[position_];
+        }
+
+        /**
+         * This consumes the next token if it's the given keyword.
+         *
+         * @param[in] keyword
+         *     This is the keyword to accept, in upper case.
+         *
+         * @return
+         *     An indication of whether or not the keyword was
+         *     consumed is returned.
+         */
+        bool Accept(const char* keyword) {
+            const auto& token = Peek();
+            if (
+                (token.kind != TokenKind::Identifier)
+                || token.quoted
+                || (token.text.length() != strlen(keyword))
+            ) {
+                return false;
+            }
+            for (size_t i = 0; i < token.text.length(); ++i) {
+                if (toupper((unsigned char)token.text[i]) != keyword[i]) {
+                    return false;
+                }
+            }
+            ++position_;
+            return true;
+        }
+
+        /**
+         * This consumes the next token if it's the given symbol.
+         *
+         * @param[in] symbol
+         *     This is the symbol to accept.
+         *
+         * @return
+         *     An indication of whether or not the symbol was
+         *     consumed is returned.
+         */
+        bool AcceptSymbol(const char* symbol) {
+            const auto& token = Peek();
+            if (
+                (token.kind != TokenKind::Symbol)
+                || (token.text != symbol)
+            ) {
+                return false;
+            }
+            ++position_;
+            return true;
+        }
+
+        /**
+         * This forms an error message about something expected
+         * but not found.
+         *
+         * @param[in] what
+         *     This describes what was expected.
+         *
+         * @return
+         *     The error message is returned.
+         */
+        std::string Expected(const std::string& what) const {
+            const auto& token = Peek();
+            if (token.kind == TokenKind::End) {
+                return "expected " + what + " but found end of statement";
+            }
+            return "expected " + what + " near '" + token.text + "'";
+        }
+
+        /**
+         * This consumes a name (of a table, column or index).
+         *
+         * @param[out] name
+         *     This is where to store the name.
+         *
+         * @return
+         *     An indication of whether or not a name was consumed
+         *     is returned.
+         */
+        bool AcceptName(std::string& name) {
+            const auto& token = Peek();
+            if (token.kind != TokenKind::Identifier) {
+                return false;
+            }
+            name = token.text;
+            ++position_;
+            return true;
+        }
+
+        /**
+         * This consumes an IF EXISTS or IF NOT EXISTS clause,
+         * if present.
+         *
+         * @param[in] negated
+         *     This indicates whether the clause is IF NOT EXISTS.
+         *
+         * @return
+         *     If the clause is malformed, a description of the problem
+         *     is returned.  Otherwise, an empty string is returned.
+         */
+        std::string ParseIfClause(bool negated) {
+            if (!Accept("IF")) {
+                return "";
+            }
+            if (negated && !Accept("NOT")) {
+                return Expected("NOT");
+            }
+            if (!Accept("EXISTS")) {
+                return Expected("EXISTS");
+            }
+            statement_.ifClause = true;
+            return "";
+        }
+
+        /**
+         * This consumes an operand, which is a literal or a parameter.
+         *
+         * @param[out] expression
+         *     This is where to store the operand.
+         *
+         * @return
+         *     If there is no valid operand, a description of the problem
+         *     is returned.  Otherwise, an empty string is returned.
+         */
+        std::string ParseExpression(Expression& expression) {
+            auto negate = false;
+            if (AcceptSymbol("-")) {
+                negate = true;
+            } else {
+                (void)AcceptSymbol("+");
+            }
+            const auto& token = Peek();
+            switch (token.kind) {
+                case TokenKind::Integer: {
+                    const auto integer = (intmax_t)token.value;
+                    expression.literal = (negate ? -integer : integer);
+                } break;
+
+                case TokenKind::Real: {
+                    const auto real = (double)token.value;
+                    expression.literal = (negate ? -real : real);
+                } break;
+
+                case TokenKind::String: {
+                    expression.literal = token.text;
+                } break;
+
+                case TokenKind::Blob: {
+                    expression.literal = token.value;
+                } break;
+
+                case TokenKind::Parameter: {
+                    if (token.parameter == 0) {
+                        if (nextParameter_ > MAX_PARAMETER_INDEX) {
+                            return "too many SQL variables";
+                        }
+                        expression.parameter = nextParameter_++;
+                    } else {
+                        expression.parameter = token.parameter;
+                        if (token.parameter >= nextParameter_) {
+                            nextParameter_ = token.parameter + 1;
+                        }
+                    }
+                } break;
+
+                case TokenKind::Identifier: {
+                    if (Accept("NULL")) {
+                        expression.literal = nullptr;
+                    } else if (Accept("TRUE")) {
+                        expression.literal = true;
+                    } else if (Accept("FALSE")) {
+                        expression.literal = false;
+                    } else {
+                        return Expected("value");
+                    }
+                    if (negate) {
+                        return "only numbers can be negated";
+                    }
+                    return "";
+                }
+
+                default: {
+                    return Expected("value");
+                }
+            }
+            if (
+                negate
+                && (token.kind != TokenKind::Integer)
+                && (token.kind != TokenKind::Real)
+            ) {
+                return "only numbers can be negated";
+            }
+            ++position_;
+            return "";
+        }
+
+        /**
+         * This consumes a parenthesized list of names.
+         *
+         * @param[out] names
+         *     This is where to store the names.
+         *
+         * @return
+         *     If the list is malformed, a description of the problem
+         *     is returned.  Otherwise, an empty string is returned.
+         */
+        std::string ParseNameList(std::vector< std::string >& names) {
+            if (!AcceptSymbol("(")) {
+                return Expected("'('");
+            }
+            do {
+                std::string name;
+                if (!AcceptName(name)) {
+                    return Expected("column name");
+                }
+                names.push_back(name);
+            } while (AcceptSymbol(","));
+            if (!AcceptSymbol(")")) {
+                return Expected("')'");
+            }
+            return "";
+        }
+
+        /**
+         * This consumes a WHERE clause, if present.
+         *
+         * @return
+         *     If the clause is malformed, a description of the problem
+         *     is returned.  Otherwise, an empty string is returned.
+         */
+        std::string ParseWhere() {
+            if (!Accept("WHERE")) {
+                return "";
+            }
+            do {
+                Condition condition;
+                if (!AcceptName(condition.column)) {
+                    return Expected("column name");
+                }
+                if (AcceptSymbol("=") || AcceptSymbol("==")) {
+                    condition.comparison = Comparison::Equal;
+                } else if (AcceptSymbol("<>") || AcceptSymbol("!=")) {
+                    condition.comparison = Comparison::NotEqual;
+                } else if (AcceptSymbol("<=")) {
+                    condition.comparison = Comparison::LessOrEqual;
+                } else if (AcceptSymbol(">=")) {
+                    condition.comparison = Comparison::GreaterOrEqual;
+                } else if (AcceptSymbol("<")) {
+                    condition.comparison = Comparison::Less;
+                } else if (AcceptSymbol(">")) {
+                    condition.comparison = Comparison::Greater;
+                } else {
+                    return Expected("comparison");
+                }
+                const auto error = ParseExpression(condition.operand);
+                if (!error.empty()) {
+                    return error;
+                }
+                statement_.where.push_back(std::move(condition));
+            } while (Accept("AND"));
+            return "";
+        }
+
+        /**
+         * This consumes the remainder of a CREATE statement.
+         *
+         * @return
+         *     If the statement is malformed, a description of the problem
+         *     is returned.  Otherwise, an empty string is returned.
+         */
+        std::string ParseCreate() {
+            if (Accept("TABLE")) {
+                return ParseCreateTable();
+            }
+            if (Accept("UNIQUE")) {
+                statement_.unique = true;
+            }
+            if (Accept("INDEX")) {
+                return ParseCreateIndex();
+            }
+            return Expected("TABLE or INDEX");
+        }
+
+        /**
+         * This consumes the type name of a column, and determines
+         * the type of value the column is meant to hold, using rules
+         * similar to SQLite's type affinity.
+         *
+         * @param[out] type
+         *     This is where to store the type of value.
+         *
+         * @return
+         *     If the type name is malformed, a description of the
+         *     problem is returned.  Otherwise, an empty string
+         *     is returned.
+         */
+        std::string ParseColumnType(Value::Type& type) {
+            std::string typeName;
+            while (
+                (Peek().kind == TokenKind::Identifier)
+                && !Peek().quoted
+            ) {
+                static const char* const constraints[] = {
+                    "PRIMARY", "NOT", "NULL", "UNIQUE", "DEFAULT",
+                };
+                auto isConstraint = false;
+                for (const auto constraint: constraints) {
+                    if (Accept(constraint)) {
+                        --position_;
+                        isConstraint = true;
+                        break;
+                    }
+                }
+                if (isConstraint) {
+                    break;
+                }
+                for (const auto c: Peek().text) {
+                    typeName += (char)toupper((unsigned char)c);
+                }
+                ++position_;
+            }
+            if (AcceptSymbol("(")) {
+                while (!AcceptSymbol(")")) {
+                    if (Peek().kind == TokenKind::End) {
+                        return Expected("')'");
+                    }
+                    ++position_;
+                }
+            }
+            if (typeName.find("INT") != std::string::npos) {
+                type = Value::Type::Integer;
+            } else if (
+                (typeName.find("CHAR") != std::string::npos)
+                || (typeName.find("CLOB") != std::string::npos)
+                || (typeName.find("TEXT") != std::string::npos)
+            ) {
+                type = Value::Type::Text;
+            } else if (
+                typeName.empty()
+                || (typeName.find("BLOB") != std::string::npos)
+            ) {
+                type = Value::Type::Blob;
+            } else if (typeName.find("BOOL") != std::string::npos) {
+                type = Value::Type::Boolean;
+            } else {
+                type = Value::Type::Real;
+            }
+            return "";
+        }
+
+        /**
+         * This consumes the remainder of a CREATE TABLE statement.
+         *
+         * @return
+         *     If the statement is malformed, a description of the problem
+         *     is returned.  Otherwise, an empty string is returned.
+         */
+        std::string ParseCreateTable() {
+            statement_.kind = StatementKind::CreateTable;
+            auto error = ParseIfClause(true);
+            if (!error.empty()) {
+                return error;
+            }
+            if (!AcceptName(statement_.table)) {
+                return Expected("table name");
+            }
+            if (!AcceptSymbol("(")) {
+                return Expected("'('");
+            }
+            do {
+                if (Accept("PRIMARY")) {
+                    if (!Accept("KEY")) {
+                        return Expected("KEY");
+                    }
+                    error = ParseTableConstraint(true);
+                } else if (Accept("UNIQUE")) {
+                    error = ParseTableConstraint(false);
+                } else {
+                    error = ParseColumnDefinition();
+                }
+                if (!error.empty()) {
+                    return error;
+                }
+            } while (AcceptSymbol(","));
+            if (!AcceptSymbol(")")) {
+                return Expected("')'");
+            }
+            return "";
+        }
+
+        /**
+         * This consumes the definition of one column in a
+         * CREATE TABLE statement.
+         *
+         * @return
+         *     If the definition is malformed, a description of the
+         *     problem is returned.  Otherwise, an empty string
+         *     is returned.
+         */
+        std::string ParseColumnDefinition() {
+            ColumnDefinition column;
+            if (!AcceptName(column.name)) {
+                return Expected("column name");
+            }
+            auto error = ParseColumnType(column.type);
+            if (!error.empty()) {
+                return error;
+            }
+            for (;;) {
+                if (Accept("PRIMARY")) {
+                    if (!Accept("KEY")) {
+                        return Expected("KEY");
+                    }
+                    column.primaryKey = true;
+                    (void)(Accept("ASC") || Accept("DESC"));
+                    (void)Accept("AUTOINCREMENT");
+                } else if (Accept("NOT")) {
+                    if (!Accept("NULL")) {
+                        return Expected("NULL");
+                    }
+                    column.notNull = true;
+                } else if (Accept("NULL")) {
+                } else if (Accept("UNIQUE")) {
+                    column.unique = true;
+                } else if (Accept("DEFAULT")) {
+                    Expression expression;
+                    error = ParseExpression(expression);
+                    if (!error.empty()) {
+                        return error;
+                    }
+                    if (expression.parameter != 0) {
+                        return "default values can't be parameters";
+                    }
+                    column.defaultValue = std::move(expression.literal);
+                } else {
+                    break;
+                }
+            }
+            statement_.columnDefinitions.push_back(std::move(column));
+            return "";
+        }
+
+        /**
+         * This consumes a PRIMARY KEY or UNIQUE table constraint.
+         *
+         * @param[in] primaryKey
+         *     This indicates whether the constraint is PRIMARY KEY.
+         *
+         * @return
+         *     If the constraint is malformed, a description of the
+         *     problem is returned.  Otherwise, an empty string
+         *     is returned.
+         */
+        std::string ParseTableConstraint(bool primaryKey) {
+            std::vector< std::string > names;
+            const auto error = ParseNameList(names);
+            if (!error.empty()) {
+                return error;
+            }
+            if (names.size() != 1) {
+                return "only single-column keys are supported";
+            }
+            for (auto& column: statement_.columnDefinitions) {
+                if (column.name == names[0]) {
+                    if (primaryKey) {
+                        column.primaryKey = true;
+                    } else {
+                        column.unique = true;
+                    }
+                    return "";
+                }
+            }
+            return "no such column: " + names[0];
+        }
+
+        /**
+         * This consumes the remainder of a CREATE INDEX statement.
+         *
+         * @return
+         *     If the statement is malformed, a description of the problem
+         *     is returned.  Otherwise, an empty string is returned.
+         */
+        std::string ParseCreateIndex() {
+            statement_.kind = StatementKind::CreateIndex;
+            auto error = ParseIfClause(true);
+            if (!error.empty()) {
+                return error;
+            }
+            if (!AcceptName(statement_.index)) {
+                return Expected("index name");
+            }
+            if (!Accept("ON")) {
+                return Expected("ON");
+            }
+            if (!AcceptName(statement_.table)) {
+                return Expected("table name");
+            }
+            error = ParseNameList(statement_.columns);
+            if (!error.empty()) {
+                return error;
+            }
+            if (statement_.columns.size() != 1) {
+                return "only single-column indexes are supported";
+            }
+            return "";
+        }
+
+        /**
+         * This consumes the remainder of a DROP statement.
+         *
+         * @return
+         *     If the statement is malformed, a description of the problem
+         *     is returned.  Otherwise, an empty string is returned.
+         */
+        std::string ParseDrop() {
+            std::string* name;
+            std::string what;
+            if (Accept("TABLE")) {
+                statement_.kind = StatementKind::DropTable;
+                name = &statement_.table;
+                what = "table name";
+            } else if (Accept("INDEX")) {
+                statement_.kind = StatementKind::DropIndex;
+                name = &statement_.index;
+                what = "index name";
+            } else {
+                return Expected("TABLE or INDEX");
+            }
+            const auto error = ParseIfClause(false);
+            if (!error.empty()) {
+                return error;
+            }
+            if (!AcceptName(*name)) {
+                return Expected(what);
+            }
+            return "";
+        }
+
+        /**
+         * This consumes the remainder of an INSERT statement.
+         *
+         * @return
+         *     If the statement is malformed, a description of the problem
+         *     is returned.  Otherwise, an empty string is returned.
+         */
+        std::string ParseInsert() {
+            statement_.kind = StatementKind::Insert;
+            if (!Accept("INTO")) {
+                return Expected("INTO");
+            }
+            if (!AcceptName(statement_.table)) {
+                return Expected("table name");
+            }
+            std::string error;
+            if (Peek().kind == TokenKind::Symbol) {
+                error = ParseNameList(statement_.columns);
+                if (!error.empty()) {
+                    return error;
+                }
+            }
+            if (!Accept("VALUES")) {
+                return Expected("VALUES");
+            }
+            do {
+                if (!AcceptSymbol("(")) {
+                    return Expected("'('");
+                }
+                std::vector< Expression > row;
+                do {
+                    Expression expression;
+                    error = ParseExpression(expression);
+                    if (!error.empty()) {
+                        return error;
+                    }
+                    row.push_back(std::move(expression));
+                } while (AcceptSymbol(","));
+                if (!AcceptSymbol(")")) {
+                    return Expected("')'");
+                }
+                statement_.rows.push_back(std::move(row));
+            } while (AcceptSymbol(","));
+            return "";
+        }
+
+        /**
+         * This consumes the remainder of a SELECT statement.
+         *
+         * @return
+         *     If the statement is malformed, a description of the problem
+         *     is returned.  Otherwise, an empty string is returned.
+         */
+        std::string ParseSelect() {
+            statement_.kind = StatementKind::Select;
+            if (AcceptSymbol("*")) {
+            } else if (Accept("COUNT")) {
+                if (
+                    !AcceptSymbol("(")
+                    || !AcceptSymbol("*")
+                    || !AcceptSymbol(")")
+                ) {
+                    return Expected("(*)");
+                }
+                statement_.countRows = true;
+            } else {
+                do {
+                    std::string name;
+                    if (!AcceptName(name)) {
+                        return Expected("column name");
+                    }
+                    statement_.columns.push_back(name);
+                } while (AcceptSymbol(","));
+            }
+            if (!Accept("FROM")) {
+                return Expected("FROM");
+            }
+            if (!AcceptName(statement_.table)) {
+                return Expected("table name");
+            }
+            auto error = ParseWhere();
+            if (!error.empty()) {
+                return error;
+            }
+            if (Accept("ORDER")) {
+                if (!Accept("BY")) {
+                    return Expected("BY");
+                }
+                if (!AcceptName(statement_.orderBy)) {
+                    return Expected("column name");
+                }
+                if (Accept("DESC")) {
+                    statement_.descending = true;
+                } else {
+                    (void)Accept("ASC");
+                }
+            }
+            if (Accept("LIMIT")) {
+                statement_.hasLimit = true;
+                error = ParseExpression(statement_.limit);
+                if (!error.empty()) {
+                    return error;
+                }
+            }
+            return "";
+        }
+
+        /**
+         * This consumes the remainder of an UPDATE statement.
+         *
+         * @return
+         *     If the statement is malformed, a description of the problem
+         *     is returned.  Otherwise, an empty string is returned.
+         */
+        std::string ParseUpdate() {
+            statement_.kind = StatementKind::Update;
+            if (!AcceptName(statement_.table)) {
+                return Expected("table name");
+            }
+            if (!Accept("SET")) {
+                return Expected("SET");
+            }
+            do {
+                std::pair< std::string, Expression > assignment;
+                if (!AcceptName(assignment.first)) {
+                    return Expected("column name");
+                }
+                if (!AcceptSymbol("=")) {
+                    return Expected("'='");
+                }
+                const auto error = ParseExpression(assignment.second);
+                if (!error.empty()) {
+                    return error;
+                }
+                statement_.assignments.push_back(std::move(assignment));
+            } while (AcceptSymbol(","));
+            return ParseWhere();
+        }
+
+        /**
+         * This consumes the remainder of a DELETE statement.
+         *
+         * @return
+         *     If the statement is malformed, a description of the problem
+         *     is returned.  Otherwise, an empty string is returned.
+         */
+        std::string ParseDelete() {
+            statement_.kind = StatementKind::Delete;
+            if (!Accept("FROM")) {
+                return Expected("FROM");
+            }
+            if (!AcceptName(statement_.table)) {
+                return Expected("table name");
+            }
+            return ParseWhere();
+        }
+
+        // Private Properties
+    private:
+        /**
+         * These are the tokens of the statement.
+         */
+        const std::vector< Token >& tokens_;
+
+        /**
+         * This is the index of the next token to consume.
+         */
+        size_t position_ = 0;
+
+        /**
+         * This is the index to give the next parameter
+         * which doesn't have one.
+         */
+        int nextParameter_ = 1;
+
+        /**
+         * This is where to store the parsed statement.
+         */
+        Statement& statement_;
+    };
+
+}
+
+namespace DatabaseAbstractions {
+
+    namespace Sql {
+
+        std::string Parse(
+            const std::string& text,
+            size_t& offset,
+            Statement& statement
+        ) {
+            Tokenizer tokenizer(text, offset);
+            std::vector< Token > tokens;
+            const auto start = offset;
+            auto error = tokenizer.Tokenize(tokens);
+            if (!error.empty()) {
+                return error;
+            }
+            offset = tokenizer.GetOffset();
+            statement.text = text.substr(start, offset - start);
+            Parser parser(tokens, statement);
+            return parser.Parse();
+        }
+
+        bool HasMoreStatements(
+            const std::string& text,
+            size_t offset
+        ) {
+            Tokenizer tokenizer(text, offset);
+            std::vector< Token > tokens;
+            while (tokenizer.GetOffset() < text.length()) {
+                tokens.clear();
+                if (!tokenizer.Tokenize(tokens).empty()) {
+                    return true;
+                }
+                if (tokens.size() > 1) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+    }
+
+}
@@ -0,0 +1,272 @@
+#pragma once
+
+/**
+ * @file SqlParser.hpp
+ *
+ * This module declares the parser for the subset of SQL understood by
+ * the DatabaseAbstractions::InMemoryDatabase class.
+ */
+
+#include <DatabaseAbstractions/Value.hpp>
+#include <stddef.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace DatabaseAbstractions {
+
+    namespace Sql {
+
+        /**
+         * This represents an operand in a statement, which is either
+         * a literal value or a reference to a bound parameter.
+         */
+        struct Expression {
+            /**
+             * This is the value of a literal operand.
+             */
+            Value literal;
+
+            /**
+             * This is the index (starting at 1) of the parameter referenced
+             * by the operand, or zero if the operand is a literal.
+             */
+            int parameter = 0;
+        };
+
+        /**
+         * These are the comparisons which can be made in conditions.
+         */
+        enum class Comparison {
+            Equal,
+            NotEqual,
+            Less,
+            LessOrEqual,
+            Greater,
+            GreaterOrEqual,
+        };
+
+        /**
+         * This represents a comparison between a column and an operand,
+         * as found in a WHERE clause.
+         */
+        struct Condition {
+            /**
+             * This is the name of the column to compare.
+             */
+            std::string column;
+
+            /**
+             * This is the kind of comparison to make.
+             */
+            Comparison comparison = Comparison::Equal;
+
+            /**
+             * This is the operand with which to compare the column.
+             */
+            Expression operand;
+        };
+
+        /**
+         * This describes a column in a CREATE TABLE statement.
+         */
+        struct ColumnDefinition {
+            /**
+             * This is the name of the column.
+             */
+            std::string name;
+
+            /**
+             * This is the type of value the column is declared to hold.
+             */
+            Value::Type type = Value::Type::Blob;
+
+            /**
+             * This flag is set if the column is the primary key.
+             */
+            bool primaryKey = false;
+
+            /**
+             * This flag is set if values in the column must be unique.
+             */
+            bool unique = false;
+
+            /**
+             * This flag is set if values in the column must not be null.
+             */
+            bool notNull = false;
+
+            /**
+             * This is the value used for the column when a row is
+             * inserted without giving one.
+             */
+            Value defaultValue = nullptr;
+        };
+
+        /**
+         * These are the kinds of statements which can be parsed.
+         */
+        enum class StatementKind {
+            CreateTable,
+            CreateIndex,
+            DropTable,
+            DropIndex,
+            Insert,
+            Select,
+            Update,
+            Delete,
+            Begin,
+            Commit,
+            Rollback,
+        };
+
+        /**
+         * This represents a parsed SQL statement.  Only the members
+         * relevant to the kind of statement are used.
+         */
+        struct Statement {
+            /**
+             * This is the kind of statement.
+             */
+            StatementKind kind = StatementKind::Select;
+
+            /**
+             * This is the SQL text of the statement.
+             */
+            std::string text;
+
+            /**
+             * This is the number of parameters which may be bound
+             * to the statement.
+             */
+            int parameterCount = 0;
+
+            /**
+             * This is the name of the table on which the statement acts.
+             */
+            std::string table;
+
+            /**
+             * This is the name of the index created or dropped
+             * by the statement.
+             */
+            std::string index;
+
+            /**
+             * This flag is set if the statement includes an
+             * IF EXISTS or IF NOT EXISTS clause.
+             */
+            bool ifClause = false;
+
+            /**
+             * This flag is set if the statement creates a unique index,
+             * or inserts rows replacing any which conflict with them.
+             */
+            bool unique = false;
+
+            /**
+             * These are the columns defined by a CREATE TABLE statement.
+             */
+            std::vector< ColumnDefinition > columnDefinitions;
+
+            /**
+             * These are the columns named by the statement: the indexed
+             * column of a CREATE INDEX statement, the columns given values
+             * by an INSERT statement, or the columns selected by a SELECT
+             * statement (empty for "*").
+             */
+            std::vector< std::string > columns;
+
+            /**
+             * These are the rows of values inserted by an INSERT statement.
+             */
+            std::vector< std::vector< Expression > > rows;
+
+            /**
+             * This flag is set if a SELECT statement selects
+             * the number of matching rows.
+             */
+            bool countRows = false;
+
+            /**
+             * These are the conditions in the WHERE clause of the statement,
+             * all of which must hold for a row to match.
+             */
+            std::vector< Condition > where;
+
+            /**
+             * These are the columns and values assigned by an
+             * UPDATE statement.
+             */
+            std::vector< std::pair< std::string, Expression > > assignments;
+
+            /**
+             * This is the name of the column by which a SELECT statement
+             * orders its results, if any.
+             */
+            std::string orderBy;
+
+            /**
+             * This flag is set if a SELECT statement orders its results
+             * in descending order.
+             */
+            bool descending = false;
+
+            /**
+             * This flag is set if a SELECT statement limits
+             * the number of results.
+             */
+            bool hasLimit = false;
+
+            /**
+             * This is the maximum number of results of a SELECT statement.
+             */
+            Expression limit;
+        };
+
+        /**
+         * This parses the next statement in the given SQL text.
+         *
+         * @param[in] text
+         *     This is the SQL text to parse.
+         *
+         * @param[in,out] offset
+         *     This is the offset in the text at which to start parsing.
+         *     It's advanced past the statement and any semicolon which
+         *     ends it.
+         *
+         * @param[out] statement
+         *     This is where to store the parsed statement.
+         *
+         * @return
+         *     If the text can't be parsed, a description of the problem
+         *     is returned.  Otherwise, an empty string is returned.
+         */
+        std::string Parse(
+            const std::string& text,
+            size_t& offset,
+            Statement& statement
+        );
+
+        /**
+         * This determines whether or not there's anything but whitespace
+         * and semicolons left in the given SQL text.
+         *
+         * @param[in] text
+         *     This is the SQL text to examine.
+         *
+         * @param[in] offset
+         *     This is the offset in the text at which to start looking.
+         *
+         * @return
+         *     An indication of whether or not there are more statements
+         *     in the text is returned.
+         */
+        bool HasMoreStatements(
+            const std::string& text,
+            size_t offset
+        );
+
+    }
+
+}
@@ -0,0 +1,285 @@
+/**
+ * @file StatementCache.cpp
+ *
+ * This file contains the implementation
+ * of the DatabaseAbstractions::StatementCache class.
+ */
+
+#include <DatabaseAbstractions/StatementCache.hpp>
+#include <functional>
+#include <list>
+#include <unordered_map>
+#include <utility>
+
+namespace {
+
+    using namespace DatabaseAbstractions;
+
+    /**
+     * This holds a statement kept in the cache.
+     */
+    struct CacheEntry {
+        /**
+         * This is the SQL text from which the statement was built.
+         */
+        std::string text;
+
+        /**
+         * This is the statement built from the SQL text.
+         */
+        std::shared_ptr< PreparedStatement > statement;
+    };
+
+    /**
+     * This is the type of list used to keep cached statements in order
+     * from most to least recently used.
+     */
+    using CacheList = std::list< CacheEntry >;
+
+}
+
+namespace DatabaseAbstractions {
+
+    struct StatementCache::Impl {
+        // Properties
+
+        /**
+         * This is the database being wrapped.
+         */
+        std::shared_ptr< Database > database;
+
+        /**
+         * This is the maximum number of statements to keep.
+         */
+        size_t capacity = 0;
+
+        /**
+         * These are the statements in the cache, in order from most
+         * to least recently used.
+         */
+        CacheList entries;
+
+        /**
+         * This is used to find statements in the cache by SQL text.
+         */
+        std::unordered_map< std::string, CacheList::iterator > index;
+
+        /**
+         * These are the counters describing how well the cache is working.
+         */
+        StatementCacheStatistics statistics;
+
+        // Methods
+
+        /**
+         * This drops all statements from the cache.
+         */
+        void Clear() {
+            index.clear();
+            entries.clear();
+        }
+
+        /**
+         * This adds the given statement to the cache, dropping the least
+         * recently used statements if the cache is full.
+         *
+         * @param[in] text
+         *     This is the SQL text from which the statement was built.
+         *
+         * @param[in] statement
+         *     This is the statement to add.
+         */
+        void Add(
+            const std::string& text,
+            const std::shared_ptr< PreparedStatement >& statement
+        ) {
+            if (capacity == 0) {
+                return;
+            }
+            while (entries.size() >= capacity) {
+                (void)index.erase(entries.back().text);
+                entries.pop_back();
+                ++statistics.evictions;
+            }
+            CacheEntry entry;
+            entry.text = text;
+            entry.statement = statement;
+            entries.push_front(std::move(entry));
+            index[text] = entries.begin();
+        }
+    };
+
+}
+
+namespace {
+
+    /**
+     * This is a snapshot writer which empties a statement cache when
+     * the snapshot it writes is installed.
+     */
+    class ClearingSnapshotWriter
+        : public SnapshotWriter
+    {
+        // Lifecycle
+    public:
+        ClearingSnapshotWriter(
+            std::shared_ptr< SnapshotWriter > writer,
+            std::function< void() > clearCache
+        )
+            : writer_(writer)
+            , clearCache_(clearCache)
+        {
+        }
+
+        // SnapshotWriter
+    public:
+        virtual std::string WriteChunk(BlobView chunk) override {
+            return writer_->WriteChunk(chunk);
+        }
+
+        virtual std::string Finish() override {
+            clearCache_();
+            return writer_->Finish();
+        }
+
+        // Private Properties
+    private:
+        /**
+         * This is the writer of the wrapped database.
+         */
+        std::shared_ptr< SnapshotWriter > writer_;
+
+        /**
+         * This is called to empty the cache when the snapshot
+         * is installed.
+         */
+        std::function< void() > clearCache_;
+    };
+
+}
+
+namespace DatabaseAbstractions {
+
+    StatementCache::~StatementCache() noexcept = default;
+    StatementCache::StatementCache(StatementCache&&) noexcept = default;
+    StatementCache& StatementCache::operator=(StatementCache&&) noexcept = default;
+
+    StatementCache::StatementCache(
+        std::shared_ptr< Database > database,
+        size_t capacity
+    )
+        : impl_(new Impl())
+    {
+        impl_->database = database;
+        impl_->capacity = capacity;
+    }
+
+    StatementCacheStatistics StatementCache::GetStatistics() const {
+        auto statistics = impl_->statistics;
+        statistics.size = impl_->entries.size();
+        return statistics;
+    }
+
+    void StatementCache::Clear() {
+        impl_->Clear();
+    }
+
+    BuildStatementResults StatementCache::BuildStatement(
+        const std::string& statement
+    ) {
+        const auto indexEntry = impl_->index.find(statement);
+        if (indexEntry != impl_->index.end()) {
+            const auto entry = indexEntry->second;
+            if (entry->statement.use_count() == 1) {
+                impl_->entries.splice(impl_->entries.begin(), impl_->entries, entry);
+                entry->statement->Reset();
+                ++impl_->statistics.hits;
+                BuildStatementResults results;
+                results.statement = entry->statement;
+                return results;
+            }
+        }
+        ++impl_->statistics.misses;
+        const auto results = impl_->database->BuildStatement(statement);
+        if (
+            (results.statement != nullptr)
+            && (indexEntry == impl_->index.end())
+        ) {
+            impl_->Add(statement, results.statement);
+        }
+        return results;
+    }
+
+    std::string StatementCache::ExecuteStatement(const std::string& statement) {
+        return impl_->database->ExecuteStatement(statement);
+    }
+
+    std::string StatementCache::BeginTransaction() {
+        return impl_->database->BeginTransaction();
+    }
+
+    std::string StatementCache::CommitTransaction() {
+        return impl_->database->CommitTransaction();
+    }
+
+    std::string StatementCache::RollbackTransaction() {
+        return impl_->database->RollbackTransaction();
+    }
+
+    std::string StatementCache::ApplyWriteBatch(const WriteBatch& batch) {
+        return impl_->database->ApplyWriteBatch(batch);
+    }
+
+    void StatementCache::ExecuteAsync(
+        const std::string& statement,
+        CompletionCallback callback
+    ) {
+        impl_->database->ExecuteAsync(statement, callback);
+    }
+
+    void StatementCache::ApplyWriteBatchAsync(
+        WriteBatch&& batch,
+        CompletionCallback callback
+    ) {
+        impl_->database->ApplyWriteBatchAsync(std::move(batch), callback);
+    }
+
+    Blob StatementCache::CreateSnapshot() {
+        return impl_->database->CreateSnapshot();
+    }
+
+    std::string StatementCache::InstallSnapshot(const Blob& blob) {
+        impl_->Clear();
+        return impl_->database->InstallSnapshot(blob);
+    }
+
+    std::shared_ptr< SnapshotReader > StatementCache::CreateSnapshotReader(size_t chunkSize) {
+        return impl_->database->CreateSnapshotReader(chunkSize);
+    }
+
+    std::shared_ptr< SnapshotReader > StatementCache::CaptureSnapshot(size_t chunkSize) {
+        return impl_->database->CaptureSnapshot(chunkSize);
+    }
+
+    std::shared_ptr< SnapshotWriter > StatementCache::CreateSnapshotWriter() {
+        const auto impl = impl_.get();
+        return std::make_shared< ClearingSnapshotWriter >(
+            impl_->database->CreateSnapshotWriter(),
+            [impl]{ impl->Clear(); }
+        );
+    }
+
+    uint64_t StatementCache::GetSnapshotId() {
+        return impl_->database->GetSnapshotId();
+    }
+
+    DeltaSnapshot StatementCache::CreateDeltaSnapshot(uint64_t baseId) {
+        return impl_->database->CreateDeltaSnapshot(baseId);
+    }
+
+    std::string StatementCache::InstallDeltaSnapshot(const DeltaSnapshot& snapshot) {
+        impl_->Clear();
+        return impl_->database->InstallDeltaSnapshot(snapshot);
+    }
+
+}
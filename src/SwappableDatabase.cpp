@@ -0,0 +1,576 @@
+/**
+ * @file SwappableDatabase.cpp
+ *
+ * This file contains the implementation
+ * of the DatabaseAbstractions::SwappableDatabase class.
+ */
+
+#include "TransactionStatements.hpp"
+
+#include <DatabaseAbstractions/SwappableDatabase.hpp>
+#include <DatabaseAbstractions/WorkerPool.hpp>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace {
+
+    using namespace DatabaseAbstractions;
+
+    /**
+     * This is the type of function called to swap a shadow in
+     * to replace the current database.
+     */
+    using SwapFunction = std::function<
+        std::string(std::shared_ptr< Database > shadow)
+    >;
+
+    /**
+     * This holds the database currently used by a swappable database,
+     * along with what's needed to swap another in.  Statements handed
+     * out by the swappable database keep it alive, so that they may be
+     * used after the swappable database is gone.
+     */
+    struct CurrentDatabase {
+        // Properties
+
+        /**
+         * This is used to synchronize access to the other properties.
+         */
+        mutable std::mutex mutex;
+
+        /**
+         * This is the database on which statements are built.
+         */
+        std::shared_ptr< Database > database;
+
+        /**
+         * This flag is set while a transaction is open
+         * on the current database.
+         */
+        bool inTransaction = false;
+
+        /**
+         * This is the number of times a shadow has been swapped in.
+         */
+        size_t swapCount = 0;
+
+        // Methods
+
+        /**
+         * This returns the database on which statements are built.
+         *
+         * @return
+         *     The current database is returned.
+         */
+        std::shared_ptr< Database > Get() const {
+            std::lock_guard< decltype(mutex) > lock(mutex);
+            return database;
+        }
+
+        /**
+         * This replaces the current database with the given shadow,
+         * unless a transaction is open.
+         *
+         * @param[in] shadow
+         *     This is the database to swap in.  It's left holding the
+         *     database it replaced.
+         *
+         * @return
+         *     If the shadow can't be swapped in, a description of the
+         *     problem is returned.  Otherwise, an empty string is returned.
+         */
+        std::string Swap(std::shared_ptr< Database >& shadow) {
+            std::lock_guard< decltype(mutex) > lock(mutex);
+            if (inTransaction) {
+                return "cannot install a snapshot during a transaction";
+            }
+            database.swap(shadow);
+            ++swapCount;
+            return "";
+        }
+
+        /**
+         * This runs the given function, which executes statements on the
+         * given database that begin or end transactions, so that no
+         * shadow is swapped in meanwhile, and updates the transaction
+         * flag to match, if the database is still the current one.
+         *
+         * @param[in] target
+         *     This is the database on which the statements are executed.
+         *
+         * @param[in] statements
+         *     This describes the statements executed.
+         *
+         * @param[in] execute
+         *     This is the function which executes the statements.
+         *     It returns a description of any error which occurs.
+         *
+         * @return
+         *     The description of any error returned by the given function
+         *     is returned.
+         */
+        std::string ExecuteTransactionStatements(
+            const std::shared_ptr< Database >& target,
+            const TransactionStatements& statements,
+            const std::function< std::string() >& execute
+        ) {
+            std::lock_guard< decltype(mutex) > lock(mutex);
+            const auto error = execute();
+            if (target == database) {
+                TrackTransaction(statements, error.empty(), inTransaction);
+            }
+            return error;
+        }
+    };
+
+    /**
+     * This is a statement which holds on to the database on which it
+     * was built, so that it may be used after another database has been
+     * swapped in to replace it.
+     */
+    class SwappableStatement
+        : public PreparedStatement
+    {
+        // Lifecycle
+    public:
+        SwappableStatement(
+            std::shared_ptr< PreparedStatement > statement,
+            std::shared_ptr< Database > database,
+            std::shared_ptr< CurrentDatabase > current,
+            const TransactionStatements& transaction
+        )
+            : database_(database)
+            , statement_(statement)
+            , current_(current)
+            , transaction_(transaction)
+        {
+        }
+
+        // PreparedStatement
+    public:
+        virtual void BindParameter(
+            int index,
+            const Value& value
+        ) override {
+            statement_->BindParameter(index, value);
+        }
+
+        virtual void BindParameter(
+            int index,
+            Value&& value
+        ) override {
+            statement_->BindParameter(index, std::move(value));
+        }
+
+        virtual void BindParameters(std::initializer_list< const Value > values) override {
+            statement_->BindParameters(values);
+        }
+
+        virtual void BindParameters(std::vector< Value >&& values) override {
+            statement_->BindParameters(std::move(values));
+        }
+
+        virtual Value FetchColumn(int index, Value::Type type) override {
+            return statement_->FetchColumn(index, type);
+        }
+
+        virtual void FetchColumn(
+            int index,
+            Value::Type type,
+            Value& value
+        ) override {
+            statement_->FetchColumn(index, type, value);
+        }
+
+        virtual void Reset() override {
+            statement_->Reset();
+        }
+
+        virtual StepStatementResults Step() override {
+            if (!ChangesTransaction()) {
+                return statement_->Step();
+            }
+            StepStatementResults results;
+            (void)current_->ExecuteTransactionStatements(
+                database_,
+                transaction_,
+                [this, &results]{
+                    results = statement_->Step();
+                    return results.error;
+                }
+            );
+            return results;
+        }
+
+        virtual StepStatementResults StepBatch(
+            size_t maxRows,
+            RowBatch& batch
+        ) override {
+            if (!ChangesTransaction()) {
+                return statement_->StepBatch(maxRows, batch);
+            }
+            StepStatementResults results;
+            (void)current_->ExecuteTransactionStatements(
+                database_,
+                transaction_,
+                [this, maxRows, &batch, &results]{
+                    results = statement_->StepBatch(maxRows, batch);
+                    return results.error;
+                }
+            );
+            return results;
+        }
+
+        virtual void StepAsync(StepStatementCallback callback) override {
+            if (ChangesTransaction()) {
+                callback(Step());
+                return;
+            }
+            statement_->StepAsync(callback);
+        }
+
+        // Private Methods
+    private:
+        /**
+         * This determines whether or not the statement begins or ends
+         * a transaction.
+         *
+         * @return
+         *     An indication of whether or not the statement begins or
+         *     ends a transaction is returned.
+         */
+        bool ChangesTransaction() const {
+            return (
+                transaction_.begins
+                || transaction_.ends
+            );
+        }
+
+        // Private Properties
+    private:
+        /**
+         * This is the database on which the statement was built.
+         * It's declared first so that it's released after the statement.
+         */
+        std::shared_ptr< Database > database_;
+
+        /**
+         * This is the statement built on the database.
+         */
+        std::shared_ptr< PreparedStatement > statement_;
+
+        /**
+         * This holds the current database of the swappable database
+         * which built the statement.
+         */
+        std::shared_ptr< CurrentDatabase > current_;
+
+        /**
+         * This describes whether the statement begins or ends
+         * a transaction.
+         */
+        TransactionStatements transaction_;
+    };
+
+    /**
+     * This is a snapshot writer which installs the snapshot written to
+     * it into a shadow, and swaps the shadow in once it's installed.
+     */
+    class SwappingSnapshotWriter
+        : public SnapshotWriter
+    {
+        // Lifecycle
+    public:
+        SwappingSnapshotWriter(
+            std::shared_ptr< Database > shadow,
+            SwapFunction swapIn
+        )
+            : shadow_(shadow)
+            , writer_(shadow->CreateSnapshotWriter())
+            , swapIn_(swapIn)
+        {
+        }
+
+        // SnapshotWriter
+    public:
+        virtual std::string WriteChunk(BlobView chunk) override {
+            return writer_->WriteChunk(chunk);
+        }
+
+        virtual std::string Finish() override {
+            const auto error = writer_->Finish();
+            if (!error.empty()) {
+                return error;
+            }
+            return swapIn_(shadow_);
+        }
+
+        // Private Properties
+    private:
+        /**
+         * This is the database into which the snapshot is installed.
+         */
+        std::shared_ptr< Database > shadow_;
+
+        /**
+         * This is the writer of the shadow.
+         */
+        std::shared_ptr< SnapshotWriter > writer_;
+
+        /**
+         * This is called to swap the shadow in once the snapshot
+         * is installed.
+         */
+        SwapFunction swapIn_;
+    };
+
+}
+
+namespace DatabaseAbstractions {
+
+    struct SwappableDatabase::Impl {
+        // Properties
+
+        /**
+         * This is the function to call to make each shadow.
+         */
+        DatabaseFactory makeDatabase;
+
+        /**
+         * This holds the database on which statements are built.
+         */
+        std::shared_ptr< CurrentDatabase > current = std::make_shared< CurrentDatabase >();
+
+        /**
+         * This is the thread used to install snapshots in the
+         * background.  It's only made when first needed, and is
+         * declared last so that it finishes its work before the
+         * rest of the properties are destroyed.
+         */
+        std::unique_ptr< WorkerPool > installer;
+
+        // Methods
+
+        /**
+         * This installs the given full snapshot into a new shadow,
+         * and swaps the shadow in once it's installed.
+         *
+         * @param[in] blob
+         *     This is the snapshot to install.
+         *
+         * @return
+         *     If an error occurs, a description of the error is returned.
+         *     Otherwise, an empty string is returned.
+         */
+        std::string InstallInShadow(const Blob& blob) {
+            auto shadow = makeDatabase();
+            const auto error = shadow->InstallSnapshot(blob);
+            if (!error.empty()) {
+                return error;
+            }
+            return current->Swap(shadow);
+        }
+    };
+
+    SwappableDatabase::~SwappableDatabase() noexcept = default;
+    SwappableDatabase::SwappableDatabase(SwappableDatabase&&) noexcept = default;
+    SwappableDatabase& SwappableDatabase::operator=(SwappableDatabase&&) noexcept = default;
+
+    SwappableDatabase::SwappableDatabase(DatabaseFactory makeDatabase)
+        : impl_(new Impl())
+    {
+        impl_->makeDatabase = makeDatabase;
+        impl_->current->database = makeDatabase();
+    }
+
+    std::shared_ptr< Database > SwappableDatabase::GetCurrent() const {
+        return impl_->current->Get();
+    }
+
+    size_t SwappableDatabase::GetSwapCount() const {
+        const auto& current = impl_->current;
+        std::lock_guard< decltype(current->mutex) > lock(current->mutex);
+        return current->swapCount;
+    }
+
+    void SwappableDatabase::InstallSnapshotAsync(
+        Blob&& blob,
+        CompletionCallback callback
+    ) {
+        const auto impl = impl_.get();
+        const auto snapshot = std::make_shared< Blob >(std::move(blob));
+        WorkerPool* installer;
+        {
+            std::lock_guard< decltype(impl->current->mutex) > lock(impl->current->mutex);
+            if (impl->installer == nullptr) {
+                impl->installer.reset(new WorkerPool(1));
+            }
+            installer = impl->installer.get();
+        }
+        installer->Post(
+            [impl, snapshot, callback]{
+                callback(impl->InstallInShadow(*snapshot));
+            }
+        );
+    }
+
+    BuildStatementResults SwappableDatabase::BuildStatement(
+        const std::string& statement
+    ) {
+        const auto database = impl_->current->Get();
+        auto results = database->BuildStatement(statement);
+        if (results.statement != nullptr) {
+            results.statement = std::make_shared< SwappableStatement >(
+                results.statement,
+                database,
+                impl_->current,
+                FindTransactionStatements(statement)
+            );
+        }
+        return results;
+    }
+
+    std::string SwappableDatabase::ExecuteStatement(const std::string& statement) {
+        const auto transaction = FindTransactionStatements(statement);
+        if (
+            !transaction.begins
+            && !transaction.ends
+        ) {
+            return impl_->current->Get()->ExecuteStatement(statement);
+        }
+        const auto& current = impl_->current;
+        const auto database = current->Get();
+        return current->ExecuteTransactionStatements(
+            database,
+            transaction,
+            [&database, &statement]{
+                return database->ExecuteStatement(statement);
+            }
+        );
+    }
+
+    std::string SwappableDatabase::BeginTransaction() {
+        const auto& current = impl_->current;
+        std::lock_guard< decltype(current->mutex) > lock(current->mutex);
+        const auto error = current->database->BeginTransaction();
+        if (error.empty()) {
+            current->inTransaction = true;
+        }
+        return error;
+    }
+
+    std::string SwappableDatabase::CommitTransaction() {
+        const auto& current = impl_->current;
+        std::lock_guard< decltype(current->mutex) > lock(current->mutex);
+        const auto error = current->database->CommitTransaction();
+        if (error.empty()) {
+            current->inTransaction = false;
+        }
+        return error;
+    }
+
+    std::string SwappableDatabase::RollbackTransaction() {
+        const auto& current = impl_->current;
+        std::lock_guard< decltype(current->mutex) > lock(current->mutex);
+        const auto error = current->database->RollbackTransaction();
+        if (error.empty()) {
+            current->inTransaction = false;
+        }
+        return error;
+    }
+
+    std::string SwappableDatabase::ApplyWriteBatch(const WriteBatch& batch) {
+        return impl_->current->Get()->ApplyWriteBatch(batch);
+    }
+
+    void SwappableDatabase::BuildStatementAsync(
+        const std::string& statement,
+        BuildStatementCallback callback
+    ) {
+        const auto current = impl_->current;
+        const auto database = current->Get();
+        const auto transaction = FindTransactionStatements(statement);
+        database->BuildStatementAsync(
+            statement,
+            [current, database, transaction, callback](const BuildStatementResults& results){
+                if (results.statement == nullptr) {
+                    callback(results);
+                    return;
+                }
+                BuildStatementResults wrapped;
+                wrapped.statement = std::make_shared< SwappableStatement >(
+                    results.statement,
+                    database,
+                    current,
+                    transaction
+                );
+                callback(wrapped);
+            }
+        );
+    }
+
+    void SwappableDatabase::ExecuteAsync(
+        const std::string& statement,
+        CompletionCallback callback
+    ) {
+        const auto transaction = FindTransactionStatements(statement);
+        if (
+            transaction.begins
+            || transaction.ends
+        ) {
+            callback(ExecuteStatement(statement));
+            return;
+        }
+        impl_->current->Get()->ExecuteAsync(statement, callback);
+    }
+
+    void SwappableDatabase::ApplyWriteBatchAsync(
+        WriteBatch&& batch,
+        CompletionCallback callback
+    ) {
+        impl_->current->Get()->ApplyWriteBatchAsync(std::move(batch), callback);
+    }
+
+    Blob SwappableDatabase::CreateSnapshot() {
+        return impl_->current->Get()->CreateSnapshot();
+    }
+
+    std::string SwappableDatabase::InstallSnapshot(const Blob& blob) {
+        return impl_->InstallInShadow(blob);
+    }
+
+    std::shared_ptr< SnapshotReader > SwappableDatabase::CreateSnapshotReader(size_t chunkSize) {
+        return impl_->current->Get()->CreateSnapshotReader(chunkSize);
+    }
+
+    std::shared_ptr< SnapshotReader > SwappableDatabase::CaptureSnapshot(size_t chunkSize) {
+        return impl_->current->Get()->CaptureSnapshot(chunkSize);
+    }
+
+    std::shared_ptr< SnapshotWriter > SwappableDatabase::CreateSnapshotWriter() {
+        const auto impl = impl_.get();
+        return std::make_shared< SwappingSnapshotWriter >(
+            impl_->makeDatabase(),
+            [impl](std::shared_ptr< Database > shadow){
+                return impl->current->Swap(shadow);
+            }
+        );
+    }
+
+    uint64_t SwappableDatabase::GetSnapshotId() {
+        return impl_->current->Get()->GetSnapshotId();
+    }
+
+    DeltaSnapshot SwappableDatabase::CreateDeltaSnapshot(uint64_t baseId) {
+        return impl_->current->Get()->CreateDeltaSnapshot(baseId);
+    }
+
+    std::string SwappableDatabase::InstallDeltaSnapshot(const DeltaSnapshot& snapshot) {
+        if (snapshot.full) {
+            return impl_->InstallInShadow(snapshot.blob);
+        }
+        return impl_->current->Get()->InstallDeltaSnapshot(snapshot);
+    }
+
+}
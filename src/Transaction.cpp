@@ -0,0 +1,91 @@
+/**
+ * @file Transaction.cpp
+ *
+ * This file contains the implementation
+ * of the DatabaseAbstractions::Transaction class.
+ */
+
+#include <DatabaseAbstractions/Transaction.hpp>
+
+namespace DatabaseAbstractions {
+
+    struct Transaction::Impl {
+        // Properties
+
+        /**
+         * This is the database on which the transaction is open.
+         */
+        Database* database = nullptr;
+
+        /**
+         * This is the error reported when the transaction was opened.
+         */
+        std::string error;
+
+        /**
+         * This flag is set while the transaction is open.
+         */
+        bool open = false;
+    };
+
+    Transaction::~Transaction() noexcept {
+        if (
+            (impl_ != nullptr)
+            && impl_->open
+        ) {
+            (void)impl_->database->RollbackTransaction();
+        }
+    }
+
+    Transaction::Transaction(Transaction&&) noexcept = default;
+
+    Transaction& Transaction::operator=(Transaction&& other) noexcept {
+        if (this != &other) {
+            if (
+                (impl_ != nullptr)
+                && impl_->open
+            ) {
+                (void)impl_->database->RollbackTransaction();
+            }
+            impl_ = std::move(other.impl_);
+        }
+        return *this;
+    }
+
+    Transaction::Transaction(Database& database)
+        : impl_(new Impl())
+    {
+        impl_->database = &database;
+        impl_->error = database.BeginTransaction();
+        impl_->open = impl_->error.empty();
+    }
+
+    const std::string& Transaction::GetError() const {
+        return impl_->error;
+    }
+
+    bool Transaction::IsOpen() const {
+        return (
+            (impl_ != nullptr)
+            && impl_->open
+        );
+    }
+
+    std::string Transaction::Commit() {
+        if (!IsOpen()) {
+            return "transaction is not open";
+        }
+        const auto error = impl_->database->CommitTransaction();
+        impl_->open = !error.empty();
+        return error;
+    }
+
+    std::string Transaction::Rollback() {
+        if (!IsOpen()) {
+            return "transaction is not open";
+        }
+        impl_->open = false;
+        return impl_->database->RollbackTransaction();
+    }
+
+}
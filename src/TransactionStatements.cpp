@@ -0,0 +1,177 @@
+/**
+ * @file TransactionStatements.cpp
+ *
+ * This module contains the implementation
+ * of the DatabaseAbstractions::FindTransactionStatements function.
+ */
+
+#include "TransactionStatements.hpp"
+
+#include <ctype.h>
+
+namespace {
+
+    /**
+     * This skips over any whitespace and comments at the given position
+     * in the given SQL text.
+     *
+     * @param[in] sql
+     *     This is the SQL text.
+     *
+     * @param[in,out] i
+     *     This is the position in the SQL text, which is moved past
+     *     any whitespace and comments.
+     */
+    void SkipSpace(
+        const std::string& sql,
+        size_t& i
+    ) {
+        while (i < sql.length()) {
+            if (isspace((unsigned char)sql[i])) {
+                ++i;
+            } else if (sql.compare(i, 2, "--") == 0) {
+                const auto end = sql.find('\n', i);
+                i = ((end == std::string::npos) ? sql.length() : end + 1);
+            } else if (sql.compare(i, 2, "/*") == 0) {
+                const auto end = sql.find("*/", i + 2);
+                i = ((end == std::string::npos) ? sql.length() : end + 2);
+            } else {
+                break;
+            }
+        }
+    }
+
+    /**
+     * This reads the word, if any, at the given position in the
+     * given SQL text.
+     *
+     * @param[in] sql
+     *     This is the SQL text.
+     *
+     * @param[in,out] i
+     *     This is the position in the SQL text, which is moved past
+     *     the word.
+     *
+     * @return
+     *     The word, in upper case, is returned, or an empty string
+     *     if there is no word at the given position.
+     */
+    std::string ReadWord(
+        const std::string& sql,
+        size_t& i
+    ) {
+        std::string word;
+        while (
+            (i < sql.length())
+            && (
+                isalnum((unsigned char)sql[i])
+                || (sql[i] == '_')
+            )
+        ) {
+            word += (char)toupper((unsigned char)sql[i]);
+            ++i;
+        }
+        return word;
+    }
+
+    /**
+     * This moves past the rest of the statement at the given position
+     * in the given SQL text, including the semicolon which ends it,
+     * skipping over quoted text and comments.
+     *
+     * @param[in] sql
+     *     This is the SQL text.
+     *
+     * @param[in,out] i
+     *     This is the position in the SQL text, which is moved to the
+     *     start of the next statement.
+     *
+     * @return
+     *     An indication of whether or not the word TO appears in the
+     *     rest of the statement, outside of quotes, is returned.
+     */
+    bool SkipStatement(
+        const std::string& sql,
+        size_t& i
+    ) {
+        bool sawTo = false;
+        while (i < sql.length()) {
+            SkipSpace(sql, i);
+            if (i >= sql.length()) {
+                break;
+            }
+            const auto c = sql[i];
+            if (c == ';') {
+                ++i;
+                break;
+            }
+            if (
+                (c == '\'')
+                || (c == '"')
+                || (c == '`')
+                || (c == '[')
+            ) {
+                const auto close = ((c == '[') ? ']' : c);
+                const auto end = sql.find(close, i + 1);
+                i = ((end == std::string::npos) ? sql.length() : end + 1);
+            } else if (
+                isalnum((unsigned char)c)
+                || (c == '_')
+            ) {
+                if (ReadWord(sql, i) == "TO") {
+                    sawTo = true;
+                }
+            } else {
+                ++i;
+            }
+        }
+        return sawTo;
+    }
+
+}
+
+namespace DatabaseAbstractions {
+
+    TransactionStatements FindTransactionStatements(const std::string& sql) {
+        TransactionStatements statements;
+        size_t i = 0;
+        while (i < sql.length()) {
+            SkipSpace(sql, i);
+            const auto keyword = ReadWord(sql, i);
+            const auto sawTo = SkipStatement(sql, i);
+            if (keyword == "BEGIN") {
+                statements.begins = true;
+                statements.leavesOpen = true;
+            } else if (
+                (keyword == "COMMIT")
+                || (keyword == "END")
+                || (
+                    (keyword == "ROLLBACK")
+                    && !sawTo
+                )
+            ) {
+                statements.ends = true;
+                statements.leavesOpen = false;
+            }
+        }
+        return statements;
+    }
+
+    void TrackTransaction(
+        const TransactionStatements& statements,
+        bool succeeded,
+        bool& inTransaction
+    ) {
+        if (succeeded) {
+            if (
+                statements.begins
+                || statements.ends
+            ) {
+                inTransaction = statements.leavesOpen;
+            }
+        } else if (statements.begins) {
+            inTransaction = true;
+        }
+    }
+
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+/**
+ * @file TransactionStatements.hpp
+ *
+ * This module declares the DatabaseAbstractions::FindTransactionStatements
+ * function, which finds the statements in SQL text which begin or end
+ * transactions.
+ */
+
+#include <string>
+
+namespace DatabaseAbstractions {
+
+    /**
+     * This describes the statements found in SQL text which begin
+     * or end transactions.
+     */
+    struct TransactionStatements {
+        /**
+         * This flag is set if any statement begins a transaction.
+         */
+        bool begins = false;
+
+        /**
+         * This flag is set if any statement ends a transaction.
+         */
+        bool ends = false;
+
+        /**
+         * This flag is set if the last statement which begins or ends
+         * a transaction begins one, so that a transaction is left open
+         * once all the statements have been executed.
+         */
+        bool leavesOpen = false;
+    };
+
+    /**
+     * This finds the statements in the given SQL text which begin a
+     * transaction (BEGIN) or end one (COMMIT, END, or ROLLBACK, other
+     * than ROLLBACK TO a savepoint).
+     *
+     * @param[in] sql
+     *     This is the SQL text to check.
+     *
+     * @return
+     *     A description of the statements found is returned.
+     */
+    TransactionStatements FindTransactionStatements(const std::string& sql);
+
+    /**
+     * This updates the given flag, which indicates whether or not a
+     * transaction is open, to account for executing the given statements.
+     * If they fail, a transaction is assumed to be open if any of them
+     * begins one, since they may have failed after it was begun.
+     *
+     * @param[in] statements
+     *     This describes the statements executed.
+     *
+     * @param[in] succeeded
+     *     This indicates whether or not the statements all succeeded.
+     *
+     * @param[in,out] inTransaction
+     *     This is the flag to update.
+     */
+    void TrackTransaction(
+        const TransactionStatements& statements,
+        bool succeeded,
+        bool& inTransaction
+    );
+
+}
@@ -5,192 +5,438 @@
  * of the DatabaseAbstractions::Value class.
  */
 
+#include <algorithm>
+#include <DatabaseAbstractions/Arena.hpp>
 #include <DatabaseAbstractions/Value.hpp>
+#include <iomanip>
+#include <memory>
+#include <new>
 #include <stdint.h>
+#include <string.h>
 #include <string>
+#include <utility>
 
 namespace {
 
     using namespace DatabaseAbstractions;
 
-    union Data {
-        std::string* error;
-        std::string* text;
-        double real;
-        intmax_t integer;
-        bool boolean;
-    };
-
-}
-
-namespace DatabaseAbstractions {
+    /**
+     * This copies the given data into the given arena.
+     *
+     * @param[in] data
+     *     This points to the data to copy.
+     *
+     * @param[in] size
+     *     This is the number of bytes to copy.
+     *
+     * @param[in,out] arena
+     *     This is the arena into which to copy the data.
+     *
+     * @return
+     *     A pointer to the copy of the data is returned.
+     */
+    const char* CopyToArena(
+        const void* data,
+        size_t size,
+        Arena& arena
+    ) {
+        const auto copy = (char*)arena.Allocate(size, 1);
+        if (size > 0) {
+            (void)memcpy(copy, data, size);
+        }
+        return copy;
+    }
 
-    struct Value::Impl {
-        // Properties
+    /**
+     * These are the ranks of the kinds of values, in the order in which
+     * values of different kinds are sorted.
+     */
+    enum class Rank {
+        Invalid,
+        Null,
+        Number,
+        Text,
+        Blob,
+        Error,
+    };
 
-        Data data;
-        Type type = Type::Invalid;
+    /**
+     * These are mixed into the hashes of values of each kind, so that
+     * values of different kinds which happen to hold the same bytes
+     * don't hash the same.
+     */
+    constexpr uint64_t INVALID_SEED = 0x0123456789ABCDEFULL;
+    constexpr uint64_t NULL_SEED = 0x7F4A7C159E3779B9ULL;
+    constexpr uint64_t NUMBER_SEED = 0x94D049BB133111EBULL;
+    constexpr uint64_t NAN_SEED = 0x2545F4914F6CDD1DULL;
+    constexpr uint64_t TEXT_SEED = 0xBF58476D1CE4E5B9ULL;
+    constexpr uint64_t BLOB_SEED = 0xD6E8FEB86659FD93ULL;
+    constexpr uint64_t ERROR_SEED = 0xA0761D6478BD642FULL;
 
-        // Lifecycle
-        ~Impl() noexcept {
-            switch (type) {
-                case Type::Text: {
-                    delete data.text;
-                } break;
+    /**
+     * This returns the rank of the given type of value in the order
+     * in which values of different kinds are sorted.
+     *
+     * @param[in] type
+     *     This is the type of value.
+     *
+     * @return
+     *     The rank of the type is returned.
+     */
+    Rank GetRank(Value::Type type) {
+        switch (type) {
+            case Value::Type::Null: return Rank::Null;
+            case Value::Type::Boolean:
+            case Value::Type::Integer:
+            case Value::Type::Real: return Rank::Number;
+            case Value::Type::Text: return Rank::Text;
+            case Value::Type::Blob: return Rank::Blob;
+            case Value::Type::Error: return Rank::Error;
+            default: return Rank::Invalid;
+        }
+    }
 
-                case Type::Error: {
-                    delete data.error;
-                } break;
+    /**
+     * This scrambles the bits of the given number, so that every bit
+     * of the result depends on every bit of the input.
+     *
+     * @param[in] x
+     *     This is the number to scramble.
+     *
+     * @return
+     *     The scrambled number is returned.
+     */
+    uint64_t Mix(uint64_t x) {
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+        return x ^ (x >> 31);
+    }
 
-                default: break;
-            }
+    /**
+     * This computes a hash of the given bytes, eight at a time.
+     *
+     * @param[in] data
+     *     This points to the bytes to hash.
+     *
+     * @param[in] size
+     *     This is the number of bytes to hash.
+     *
+     * @param[in] seed
+     *     This is mixed into the hash.
+     *
+     * @return
+     *     The hash of the bytes is returned.
+     */
+    uint64_t HashBytes(
+        const void* data,
+        size_t size,
+        uint64_t seed
+    ) {
+        auto bytes = (const uint8_t*)data;
+        uint64_t hash = seed ^ ((uint64_t)size * 0x9E3779B97F4A7C15ULL);
+        while (size >= 8) {
+            uint64_t word;
+            (void)memcpy(&word, bytes, sizeof(word));
+            hash ^= word * 0x87C37B91114253D5ULL;
+            hash = ((hash << 31) | (hash >> 33)) * 0x4CF5AD432745937FULL;
+            bytes += 8;
+            size -= 8;
+        }
+        if (size > 0) {
+            uint64_t word = 0;
+            (void)memcpy(&word, bytes, size);
+            hash ^= word * 0x87C37B91114253D5ULL;
         }
-        Impl(const Impl& other) = delete;
-        Impl(Impl&& other) noexcept = default;
-        Impl& operator=(const Impl& other) = delete;
-        Impl& operator=(Impl&& other) noexcept = default;
+        return Mix(hash);
+    }
 
-        // Constructor
-        Impl() = default;
-    };
+    /**
+     * This compares two sequences of bytes in lexicographic order.
+     *
+     * @param[in] lhs
+     *     This points to the first sequence.
+     *
+     * @param[in] lhsSize
+     *     This is the number of bytes in the first sequence.
+     *
+     * @param[in] rhs
+     *     This points to the second sequence.
+     *
+     * @param[in] rhsSize
+     *     This is the number of bytes in the second sequence.
+     *
+     * @return
+     *     -1, 0, or 1 is returned, according to whether the first
+     *     sequence comes before, is the same as, or comes after
+     *     the second sequence.
+     */
+    int CompareBytes(
+        const void* lhs,
+        size_t lhsSize,
+        const void* rhs,
+        size_t rhsSize
+    ) {
+        const auto size = std::min(lhsSize, rhsSize);
+        const auto comparison = (
+            (size == 0)
+            ? 0
+            : memcmp(lhs, rhs, size)
+        );
+        if (comparison != 0) {
+            return (comparison < 0) ? -1 : 1;
+        }
+        return (lhsSize < rhsSize) ? -1 : ((lhsSize > rhsSize) ? 1 : 0);
+    }
 
-    Value::~Value() noexcept = default;
+    /**
+     * This compares two real numbers, treating NaN as equal to itself
+     * and less than every other number, so that the order is total.
+     *
+     * @param[in] lhs
+     *     This is the first number to compare.
+     *
+     * @param[in] rhs
+     *     This is the second number to compare.
+     *
+     * @return
+     *     -1, 0, or 1 is returned, according to whether the first
+     *     number comes before, is the same as, or comes after
+     *     the second number.
+     */
+    int CompareReals(
+        double lhs,
+        double rhs
+    ) {
+        if (lhs < rhs) {
+            return -1;
+        }
+        if (lhs > rhs) {
+            return 1;
+        }
+        if (lhs == rhs) {
+            return 0;
+        }
+        const auto lhsNan = (lhs != lhs);
+        const auto rhsNan = (rhs != rhs);
+        return (lhsNan == rhsNan) ? 0 : (lhsNan ? -1 : 1);
+    }
 
-    Value::Value(const Value& other)
-        : Value()
-    {
-        impl_->type = other.impl_->type;
-        switch (impl_->type) {
-            case Type::Boolean: {
-                impl_->data.boolean = other;
-            } break;
+    /**
+     * This compares an integer with a real number exactly, without
+     * losing precision for integers too large to convert to real
+     * numbers exactly.
+     *
+     * @param[in] lhs
+     *     This is the integer to compare.
+     *
+     * @param[in] rhs
+     *     This is the real number to compare.
+     *
+     * @return
+     *     -1, 0, or 1 is returned, according to whether the integer
+     *     comes before, is the same as, or comes after the real number.
+     */
+    int CompareIntegerToReal(
+        intmax_t lhs,
+        double rhs
+    ) {
+        if (rhs != rhs) {
+            return 1;
+        }
+        if (rhs >= 9223372036854775808.0) {
+            return -1;
+        }
+        if (rhs < -9223372036854775808.0) {
+            return 1;
+        }
+        const auto whole = (intmax_t)rhs;
+        if (lhs != whole) {
+            return (lhs < whole) ? -1 : 1;
+        }
+        const auto fraction = rhs - (double)whole;
+        return (fraction > 0.0) ? -1 : ((fraction < 0.0) ? 1 : 0);
+    }
 
-            case Type::Error: {
-                impl_->data.error = new std::string((const std::string&)other);
-            } break;
+    /**
+     * This returns the given numeric value as an integer,
+     * treating booleans as 0 or 1.
+     *
+     * @param[in] value
+     *     This is the value to convert.
+     *
+     * @return
+     *     The value as an integer is returned.
+     */
+    intmax_t NumericInteger(const Value& value) {
+        if (value.GetType() == Value::Type::Boolean) {
+            return ((bool)value ? 1 : 0);
+        }
+        return (intmax_t)value;
+    }
 
-            case Type::Integer: {
-                impl_->data.integer = other;
-            } break;
+}
 
-            case Type::Real: {
-                impl_->data.real = other;
-            } break;
+namespace DatabaseAbstractions {
 
-            case Type::Text: {
-                impl_->data.text = new std::string((const std::string&)other);
-            } break;
+    Value::~Value() noexcept {
+        Clear();
+    }
 
-            default: break;
-        }
+    Value::Value(const Value& other) {
+        CopyFrom(other);
     }
 
-    Value::Value(Value&& other) noexcept
-        : impl_(std::move(other.impl_))
-    {
-        other.impl_ = nullptr;
+    Value::Value(Value&& other) noexcept {
+        MoveFrom(other);
     }
 
     Value& Value::operator=(const Value& other) {
         if (this != &other) {
-            *this = Value(other);
+            if (other.HoldsString()) {
+                AssignString(other.data_.text, other.type_);
+            } else if (other.HoldsBlob()) {
+                AssignBlob(other.data_.blob);
+            } else {
+                Clear();
+                CopyFrom(other);
+            }
         }
         return *this;
     }
 
     Value& Value::operator=(Value&& other) noexcept {
         if (this != &other) {
-            std::swap(impl_, other.impl_);
+            Clear();
+            MoveFrom(other);
         }
         return *this;
     }
 
-    Value::Value()
-        : impl_(new Impl())
-    {
+    Value::Value() = default;
+
+    Value::Value(const char* text) {
+        new (&data_.text) std::string(text);
+        type_ = Type::Text;
+    }
+
+    Value::Value(const std::string& text) {
+        new (&data_.text) std::string(text);
+        type_ = Type::Text;
+    }
+
+    Value::Value(std::string&& text) {
+        new (&data_.text) std::string(std::move(text));
+        type_ = Type::Text;
+    }
+
+    Value::Value(const char* text, size_t size) {
+        new (&data_.text) std::string(text, size);
+        type_ = Type::Text;
     }
 
-    Value::Value(const char* text)
-        : Value(std::string(text))
-    {
+    Value::Value(double real) {
+        data_.real = real;
+        type_ = Type::Real;
     }
 
-    Value::Value(const std::string& text)
-        : Value()
-    {
-        impl_->data.text = new std::string(text);
-        impl_->type = Type::Text;
+    Value::Value(int integer) {
+        data_.integer = (intmax_t)integer;
+        type_ = Type::Integer;
     }
 
-    Value::Value(std::string&& text)
-        : Value()
-    {
-        impl_->data.text = new std::string(std::move(text));
-        impl_->type = Type::Text;
+    Value::Value(intmax_t integer) {
+        data_.integer = integer;
+        type_ = Type::Integer;
     }
 
-    Value::Value(double real)
-        : Value()
-    {
-        impl_->data.real = real;
-        impl_->type = Type::Real;
+    Value::Value(size_t integer) {
+        data_.integer = (intmax_t)integer;
+        type_ = Type::Integer;
     }
 
-    Value::Value(int integer)
-        : Value()
-    {
-        impl_->data.integer = (intmax_t)integer;
-        impl_->type = Type::Integer;
+    Value::Value(bool boolean) {
+        data_.boolean = boolean;
+        type_ = Type::Boolean;
     }
 
-    Value::Value(intmax_t integer)
-        : Value()
-    {
-        impl_->data.integer = integer;
-        impl_->type = Type::Integer;
+    Value::Value(nullptr_t null) {
+        type_ = Type::Null;
     }
 
-    Value::Value(size_t integer)
-        : Value()
-    {
-        impl_->data.integer = (intmax_t)integer;
-        impl_->type = Type::Integer;
+    Value::Value(const Blob& blob) {
+        new (&data_.blob) Blob(blob);
+        type_ = Type::Blob;
     }
 
-    Value::Value(bool boolean)
-        : Value()
-    {
-        impl_->data.boolean = boolean;
-        impl_->type = Type::Boolean;
+    Value::Value(Blob&& blob) {
+        new (&data_.blob) Blob(std::move(blob));
+        type_ = Type::Blob;
     }
 
-    Value::Value(nullptr_t null)
-        : Value()
-    {
-        impl_->type = Type::Null;
+    Value::Value(BlobView blob) {
+        new (&data_.blobView) BlobView(blob);
+        type_ = Type::Blob;
+        borrowed_ = true;
+    }
+
+    Value::Value(const std::string& text, Arena& arena) {
+        data_.textView.data = CopyToArena(text.c_str(), text.length() + 1, arena);
+        data_.textView.size = text.length();
+        type_ = Type::Text;
+        inArena_ = true;
+    }
+
+    Value::Value(const char* text, size_t size, Arena& arena) {
+        const auto copy = (char*)arena.Allocate(size + 1, 1);
+        if (size > 0) {
+            (void)memcpy(copy, text, size);
+        }
+        copy[size] = '\0';
+        data_.textView.data = copy;
+        data_.textView.size = size;
+        type_ = Type::Text;
+        inArena_ = true;
+    }
+
+    Value::Value(BlobView blob, Arena& arena) {
+        new (&data_.blobView) BlobView(
+            (const uint8_t*)CopyToArena(blob.data, blob.size, arena),
+            blob.size
+        );
+        type_ = Type::Blob;
+        inArena_ = true;
     }
 
     Value::operator const char*() const {
         static const char* defaultString = "";
-        switch (impl_->type) {
-            case Type::Text: return impl_->data.text->c_str();
-            case Type::Error: return impl_->data.error->c_str();
-            default: return defaultString;
+        if (
+            (type_ == Type::Text)
+            || (type_ == Type::Error)
+        ) {
+            size_t size;
+            return GetText(size);
         }
+        return defaultString;
     }
 
     Value::operator const std::string&() const {
         static const std::string defaultString;
-        switch (impl_->type) {
-            case Type::Text: return *impl_->data.text;
-            case Type::Error: return *impl_->data.error;
-            default: return defaultString;
+        OwnText();
+        if (HoldsString()) {
+            return data_.text;
+        }
+        if (
+            shared_
+            && (type_ != Type::Blob)
+        ) {
+            return *data_.sharedText;
         }
+        return defaultString;
     }
 
     Value::operator double() const {
-        switch (impl_->type) {
-            case Type::Real: return impl_->data.real;
+        switch (type_) {
+            case Type::Real: return data_.real;
             default: return 0.0;
         }
     }
@@ -200,8 +446,8 @@ namespace DatabaseAbstractions {
     }
 
     Value::operator intmax_t() const {
-        switch (impl_->type) {
-            case Type::Integer: return impl_->data.integer;
+        switch (type_) {
+            case Type::Integer: return data_.integer;
             default: return 0;
         }
     }
@@ -211,96 +457,556 @@ namespace DatabaseAbstractions {
     }
 
     Value::operator bool() const {
-        switch (impl_->type) {
-            case Type::Boolean: return impl_->data.boolean;
+        switch (type_) {
+            case Type::Boolean: return data_.boolean;
             default: return false;
         }
     }
 
+    Value::operator BlobView() const {
+        if (type_ != Type::Blob) {
+            return BlobView();
+        }
+        if (
+            borrowed_
+            || inArena_
+        ) {
+            return data_.blobView;
+        }
+        if (shared_) {
+            return BlobView(*data_.sharedBlob);
+        }
+        return BlobView(data_.blob);
+    }
+
     auto Value::GetType() const -> Type {
-        if (impl_ == nullptr) {
-            return Type::Invalid;
+        return type_;
+    }
+
+    bool Value::IsBorrowed() const {
+        return borrowed_;
+    }
+
+    bool Value::IsInArena() const {
+        return inArena_;
+    }
+
+    bool Value::IsShared() const {
+        return shared_;
+    }
+
+    void Value::Own() {
+        if (type_ == Type::Blob) {
+            if (
+                !borrowed_
+                && !inArena_
+            ) {
+                return;
+            }
+            const auto view = data_.blobView;
+            Clear();
+            new (&data_.blob) Blob(view.data, view.data + view.size);
+            type_ = Type::Blob;
+        } else {
+            OwnText();
+        }
+    }
+
+    void Value::Share() {
+        switch (type_) {
+            case Type::Blob: {
+                if (shared_) {
+                    return;
+                }
+                std::shared_ptr< const Blob > blob;
+                if (HoldsBlob()) {
+                    blob = std::make_shared< Blob >(std::move(data_.blob));
+                } else {
+                    const auto view = data_.blobView;
+                    blob = std::make_shared< Blob >(view.data, view.data + view.size);
+                }
+                Clear();
+                new (&data_.sharedBlob) std::shared_ptr< const Blob >(std::move(blob));
+                type_ = Type::Blob;
+            } break;
+
+            case Type::Error:
+            case Type::Text: {
+                if (shared_) {
+                    return;
+                }
+                std::shared_ptr< const std::string > text;
+                if (HoldsString()) {
+                    text = std::make_shared< std::string >(std::move(data_.text));
+                } else {
+                    const auto view = data_.textView;
+                    text = std::make_shared< std::string >(view.data, view.size);
+                }
+                const auto type = type_;
+                Clear();
+                new (&data_.sharedText) std::shared_ptr< const std::string >(std::move(text));
+                type_ = type;
+            } break;
+
+            default: return;
+        }
+        shared_ = true;
+    }
+
+    void Value::SetText(const char* text, size_t size) {
+        if (HoldsString()) {
+            (void)data_.text.assign(text, size);
+        } else {
+            std::string copy(text, size);
+            Clear();
+            new (&data_.text) std::string(std::move(copy));
+        }
+        type_ = Type::Text;
+    }
+
+    void Value::SetBlob(const uint8_t* data, size_t size) {
+        if (
+            HoldsBlob()
+            && (
+                (data + size <= data_.blob.data())
+                || (data >= data_.blob.data() + data_.blob.size())
+            )
+        ) {
+            (void)data_.blob.assign(data, data + size);
+        } else {
+            Blob copy(data, data + size);
+            Clear();
+            new (&data_.blob) Blob(std::move(copy));
+            type_ = Type::Blob;
+        }
+    }
+
+    void Value::Assign(const Value& other, Arena& arena) {
+        switch (other.type_) {
+            case Type::Blob: {
+                const BlobView blob(other);
+                const auto data = CopyToArena(blob.data, blob.size, arena);
+                Clear();
+                new (&data_.blobView) BlobView((const uint8_t*)data, blob.size);
+                type_ = Type::Blob;
+                inArena_ = true;
+            } break;
+
+            case Type::Error:
+            case Type::Text: {
+                size_t size;
+                const auto text = other.GetText(size);
+                const auto data = CopyToArena(text, size + 1, arena);
+                const auto type = other.type_;
+                Clear();
+                data_.textView.data = data;
+                data_.textView.size = size;
+                type_ = type;
+                inArena_ = true;
+            } break;
+
+            default: {
+                if (this != &other) {
+                    Clear();
+                    CopyFrom(other);
+                }
+            } break;
+        }
+    }
+
+    int Value::Compare(const Value& other) const {
+        const auto rank = GetRank(type_);
+        const auto otherRank = GetRank(other.type_);
+        if (rank != otherRank) {
+            return (rank < otherRank) ? -1 : 1;
+        }
+        switch (rank) {
+            case Rank::Number: {
+                if (type_ == Type::Real) {
+                    if (other.type_ == Type::Real) {
+                        return CompareReals(data_.real, other.data_.real);
+                    }
+                    return -CompareIntegerToReal(NumericInteger(other), data_.real);
+                }
+                const auto integer = NumericInteger(*this);
+                if (other.type_ == Type::Real) {
+                    return CompareIntegerToReal(integer, other.data_.real);
+                }
+                const auto otherInteger = NumericInteger(other);
+                return (integer < otherInteger) ? -1 : ((integer > otherInteger) ? 1 : 0);
+            }
+
+            case Rank::Text:
+            case Rank::Error: {
+                size_t size, otherSize;
+                const auto text = GetText(size);
+                const auto otherText = other.GetText(otherSize);
+                return CompareBytes(text, size, otherText, otherSize);
+            }
+
+            case Rank::Blob: {
+                const BlobView blob(*this);
+                const BlobView otherBlob(other);
+                return CompareBytes(blob.data, blob.size, otherBlob.data, otherBlob.size);
+            }
+
+            default: return 0;
+        }
+    }
+
+    size_t Value::Hash() const {
+        switch (type_) {
+            case Type::Boolean:
+            case Type::Integer: {
+                return (size_t)Mix((uint64_t)NumericInteger(*this) ^ NUMBER_SEED);
+            }
+
+            case Type::Real: {
+                const auto real = data_.real;
+                if (real != real) {
+                    return (size_t)Mix(NAN_SEED);
+                }
+                if (
+                    (real >= -9223372036854775808.0)
+                    && (real < 9223372036854775808.0)
+                ) {
+                    const auto whole = (intmax_t)real;
+                    if ((double)whole == real) {
+                        return (size_t)Mix((uint64_t)whole ^ NUMBER_SEED);
+                    }
+                }
+                uint64_t bits;
+                (void)memcpy(&bits, &real, sizeof(bits));
+                return (size_t)Mix(Mix(bits) ^ NUMBER_SEED);
+            }
+
+            case Type::Text:
+            case Type::Error: {
+                size_t size;
+                const auto text = GetText(size);
+                return (size_t)HashBytes(
+                    text,
+                    size,
+                    (type_ == Type::Text) ? TEXT_SEED : ERROR_SEED
+                );
+            }
+
+            case Type::Blob: {
+                const BlobView blob(*this);
+                return (size_t)HashBytes(blob.data, blob.size, BLOB_SEED);
+            }
+
+            case Type::Null: return (size_t)Mix(NULL_SEED);
+            default: return (size_t)Mix(INVALID_SEED);
         }
-        return impl_->type;
     }
 
     bool Value::operator==(const Value& other) const {
         if (this == &other) {
             return true;
         }
-        switch (impl_->type) {
-            case Type::Boolean: return impl_->data.boolean == (bool)other;
-            case Type::Error: return *impl_->data.error == (const std::string&)other;
-            case Type::Integer: return impl_->data.integer == (intmax_t)other;
-            case Type::Real: return impl_->data.real == (double)other;
-            case Type::Text: return *impl_->data.text == (const std::string&)other;
-            case Type::Invalid: return other.impl_->type == Type::Invalid;
-            case Type::Null: return other.impl_->type == Type::Null;
-            default: return false;
+        if (type_ == other.type_) {
+            switch (type_) {
+                case Type::Boolean: return data_.boolean == other.data_.boolean;
+                case Type::Integer: return data_.integer == other.data_.integer;
+                case Type::Invalid:
+                case Type::Null: return true;
+                default: break;
+            }
+            if (
+                shared_
+                && other.shared_
+                && (
+                    (type_ == Type::Blob)
+                    ? (data_.sharedBlob == other.data_.sharedBlob)
+                    : (data_.sharedText == other.data_.sharedText)
+                )
+            ) {
+                return true;
+            }
         }
+        return Compare(other) == 0;
     }
 
     bool Value::operator!=(const Value& other) const {
         return !(*this == other);
     }
 
+    bool Value::operator<(const Value& other) const {
+        return Compare(other) < 0;
+    }
+
+    bool Value::operator<=(const Value& other) const {
+        return Compare(other) <= 0;
+    }
+
+    bool Value::operator>(const Value& other) const {
+        return Compare(other) > 0;
+    }
+
+    bool Value::operator>=(const Value& other) const {
+        return Compare(other) >= 0;
+    }
+
     Value& Value::operator=(const char* text) {
-        *this = Value(text);
+        AssignString(text, Type::Text);
         return *this;
     }
 
     Value& Value::operator=(const std::string& text) {
-        *this = Value(text);
+        AssignString(text, Type::Text);
         return *this;
     }
 
     Value& Value::operator=(std::string&& text) {
-        *this = Value(std::move(text));
+        AssignString(std::move(text), Type::Text);
         return *this;
     }
 
     Value& Value::operator=(double real) {
-        *this = Value(real);
+        Clear();
+        data_.real = real;
+        type_ = Type::Real;
         return *this;
     }
 
     Value& Value::operator=(int integer) {
-        *this = Value(integer);
-        return *this;
+        return *this = (intmax_t)integer;
     }
 
     Value& Value::operator=(intmax_t integer) {
-        *this = Value(integer);
+        Clear();
+        data_.integer = integer;
+        type_ = Type::Integer;
         return *this;
     }
 
     Value& Value::operator=(size_t integer) {
-        *this = Value(integer);
-        return *this;
+        return *this = (intmax_t)integer;
     }
 
     Value& Value::operator=(bool boolean) {
-        *this = Value(boolean);
+        Clear();
+        data_.boolean = boolean;
+        type_ = Type::Boolean;
         return *this;
     }
 
     Value& Value::operator=(nullptr_t null) {
-        *this = Value(nullptr);
+        Clear();
+        type_ = Type::Null;
+        return *this;
+    }
+
+    Value& Value::operator=(const Blob& blob) {
+        AssignBlob(blob);
+        return *this;
+    }
+
+    Value& Value::operator=(Blob&& blob) {
+        AssignBlob(std::move(blob));
+        return *this;
+    }
+
+    Value& Value::operator=(BlobView blob) {
+        Clear();
+        new (&data_.blobView) BlobView(blob);
+        type_ = Type::Blob;
+        borrowed_ = true;
         return *this;
     }
 
     Value Value::Error(const std::string& error) {
         Value value;
-        value.impl_->type = Type::Error;
-        value.impl_->data.error = new std::string(error);
+        value.AssignString(error, Type::Error);
         return value;
     }
 
+    bool Value::HoldsString() const noexcept {
+        return (
+            (
+                (type_ == Type::Text)
+                || (type_ == Type::Error)
+            )
+            && !inArena_
+            && !shared_
+        );
+    }
+
+    bool Value::HoldsBlob() const noexcept {
+        return (
+            (type_ == Type::Blob)
+            && !borrowed_
+            && !inArena_
+            && !shared_
+        );
+    }
+
+    const char* Value::GetText(size_t& size) const noexcept {
+        if (inArena_) {
+            size = data_.textView.size;
+            return data_.textView.data;
+        }
+        if (shared_) {
+            size = data_.sharedText->length();
+            return data_.sharedText->c_str();
+        }
+        size = data_.text.length();
+        return data_.text.c_str();
+    }
+
+    void Value::OwnText() const {
+        if (
+            !inArena_
+            || (
+                (type_ != Type::Text)
+                && (type_ != Type::Error)
+            )
+        ) {
+            return;
+        }
+        const auto view = data_.textView;
+        new (&data_.text) std::string(view.data, view.size);
+        inArena_ = false;
+    }
+
+    void Value::Clear() noexcept {
+        if (HoldsString()) {
+            data_.text.~basic_string();
+        } else if (HoldsBlob()) {
+            data_.blob.~Blob();
+        } else if (shared_) {
+            if (type_ == Type::Blob) {
+                data_.sharedBlob.~shared_ptr();
+            } else {
+                data_.sharedText.~shared_ptr();
+            }
+        }
+        type_ = Type::Invalid;
+        borrowed_ = false;
+        inArena_ = false;
+        shared_ = false;
+    }
+
+    void Value::CopyFrom(const Value& other) {
+        if (other.shared_) {
+            if (other.type_ == Type::Blob) {
+                new (&data_.sharedBlob) std::shared_ptr< const Blob >(other.data_.sharedBlob);
+            } else {
+                new (&data_.sharedText) std::shared_ptr< const std::string >(other.data_.sharedText);
+            }
+            type_ = other.type_;
+            shared_ = true;
+            return;
+        }
+        switch (other.type_) {
+            case Type::Blob: {
+                if (other.inArena_) {
+                    const auto view = other.data_.blobView;
+                    new (&data_.blob) Blob(view.data, view.data + view.size);
+                } else if (other.borrowed_) {
+                    new (&data_.blobView) BlobView(other.data_.blobView);
+                } else {
+                    new (&data_.blob) Blob(other.data_.blob);
+                }
+            } break;
+
+            case Type::Boolean: {
+                data_.boolean = other.data_.boolean;
+            } break;
+
+            case Type::Error:
+            case Type::Text: {
+                size_t size;
+                const auto text = other.GetText(size);
+                new (&data_.text) std::string(text, size);
+            } break;
+
+            case Type::Integer: {
+                data_.integer = other.data_.integer;
+            } break;
+
+            case Type::Real: {
+                data_.real = other.data_.real;
+            } break;
+
+            default: break;
+        }
+        type_ = other.type_;
+        borrowed_ = other.borrowed_;
+    }
+
+    void Value::MoveFrom(Value& other) noexcept {
+        if (other.HoldsString()) {
+            new (&data_.text) std::string(std::move(other.data_.text));
+            type_ = other.type_;
+            other.Clear();
+        } else if (other.HoldsBlob()) {
+            new (&data_.blob) Blob(std::move(other.data_.blob));
+            type_ = other.type_;
+            other.Clear();
+        } else if (other.shared_) {
+            if (other.type_ == Type::Blob) {
+                new (&data_.sharedBlob) std::shared_ptr< const Blob >(std::move(other.data_.sharedBlob));
+            } else {
+                new (&data_.sharedText) std::shared_ptr< const std::string >(std::move(other.data_.sharedText));
+            }
+            type_ = other.type_;
+            shared_ = true;
+            other.Clear();
+        } else if (other.inArena_) {
+            if (other.type_ == Type::Blob) {
+                new (&data_.blobView) BlobView(other.data_.blobView);
+            } else {
+                data_.textView = other.data_.textView;
+            }
+            type_ = other.type_;
+            inArena_ = true;
+            other.Clear();
+        } else {
+            CopyFrom(other);
+            other.Clear();
+        }
+    }
+
+    template< typename T > void Value::AssignString(T&& text, Type type) {
+        if (HoldsString()) {
+            data_.text = std::forward< T >(text);
+        } else {
+            Clear();
+            new (&data_.text) std::string(std::forward< T >(text));
+        }
+        type_ = type;
+    }
+
+    template< typename T > void Value::AssignBlob(T&& blob) {
+        if (HoldsBlob()) {
+            data_.blob = std::forward< T >(blob);
+        } else {
+            Clear();
+            new (&data_.blob) Blob(std::forward< T >(blob));
+            type_ = Type::Blob;
+        }
+    }
+
     void PrintTo(
         const Value& value,
         std::ostream* os
     ) {
         switch (value.GetType()) {
+            case Value::Type::Blob: {
+                const BlobView blob(value);
+                const auto flags = os->flags();
+                const auto fill = os->fill();
+                *os << "blob(" << std::hex << std::setfill('0');
+                for (size_t i = 0; i < blob.size; ++i) {
+                    *os << std::setw(2) << (unsigned int)blob.data[i];
+                }
+                *os << ")";
+                os->flags(flags);
+                os->fill(fill);
+            } break;
+
             case Value::Type::Boolean: {
                 *os << ((bool)value ? "true" : "false");
             } break;
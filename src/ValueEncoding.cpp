@@ -0,0 +1,366 @@
+/**
+ * @file ValueEncoding.cpp
+ *
+ * This file contains the implementation of the functions which encode
+ * database values and batches of rows, and of the
+ * DatabaseAbstractions::ValueDecoder class.
+ */
+
+#include <DatabaseAbstractions/ValueEncoding.hpp>
+#include <string.h>
+#include <vector>
+
+namespace {
+
+    using namespace DatabaseAbstractions;
+
+    /**
+     * This appends an unsigned integer to the given buffer, encoded in
+     * 7-bit groups, least significant first.
+     *
+     * @param[in] value
+     *     This is the integer to append.
+     *
+     * @param[in,out] buffer
+     *     This is the buffer to which to append the integer.
+     */
+    void EncodeVarint(
+        uint64_t value,
+        Blob& buffer
+    ) {
+        while (value >= 0x80) {
+            buffer.push_back((uint8_t)(value | 0x80));
+            value >>= 7;
+        }
+        buffer.push_back((uint8_t)value);
+    }
+
+    /**
+     * This appends a length-prefixed sequence of bytes to the
+     * given buffer.
+     *
+     * @param[in] data
+     *     This points to the bytes to append.
+     *
+     * @param[in] size
+     *     This is the number of bytes to append.
+     *
+     * @param[in,out] buffer
+     *     This is the buffer to which to append the bytes.
+     */
+    void EncodeBytes(
+        const void* data,
+        size_t size,
+        Blob& buffer
+    ) {
+        EncodeVarint(size, buffer);
+        const auto bytes = (const uint8_t*)data;
+        buffer.insert(buffer.end(), bytes, bytes + size);
+    }
+
+    /**
+     * This returns the type of value identified by the given tag.
+     *
+     * @param[in] tag
+     *     This is the tag to look up.
+     *
+     * @param[out] type
+     *     This is where to store the type of value.
+     *
+     * @return
+     *     An indication of whether or not the tag is known is returned.
+     */
+    bool TypeFromTag(
+        uint8_t tag,
+        Value::Type& type
+    ) {
+        switch ((ValueTag)tag) {
+            case ValueTag::Invalid: type = Value::Type::Invalid; return true;
+            case ValueTag::Null: type = Value::Type::Null; return true;
+            case ValueTag::Boolean: type = Value::Type::Boolean; return true;
+            case ValueTag::Integer: type = Value::Type::Integer; return true;
+            case ValueTag::Real: type = Value::Type::Real; return true;
+            case ValueTag::Text: type = Value::Type::Text; return true;
+            case ValueTag::Blob: type = Value::Type::Blob; return true;
+            case ValueTag::Error: type = Value::Type::Error; return true;
+            default: return false;
+        }
+    }
+
+    /**
+     * This returns the tag which identifies the given type of value.
+     *
+     * @param[in] type
+     *     This is the type of value to identify.
+     *
+     * @return
+     *     The tag which identifies the type of value is returned.
+     */
+    ValueTag TagFromType(Value::Type type) {
+        switch (type) {
+            case Value::Type::Null: return ValueTag::Null;
+            case Value::Type::Boolean: return ValueTag::Boolean;
+            case Value::Type::Integer: return ValueTag::Integer;
+            case Value::Type::Real: return ValueTag::Real;
+            case Value::Type::Text: return ValueTag::Text;
+            case Value::Type::Blob: return ValueTag::Blob;
+            case Value::Type::Error: return ValueTag::Error;
+            default: return ValueTag::Invalid;
+        }
+    }
+
+}
+
+namespace DatabaseAbstractions {
+
+    void EncodeValue(
+        const Value& value,
+        Blob& buffer
+    ) {
+        buffer.push_back((uint8_t)TagFromType(value.type_));
+        switch (value.type_) {
+            case Value::Type::Boolean: {
+                buffer.push_back(value.data_.boolean ? 1 : 0);
+            } break;
+
+            case Value::Type::Integer: {
+                const auto integer = (int64_t)value.data_.integer;
+                EncodeVarint(
+                    ((uint64_t)integer << 1) ^ (uint64_t)(integer >> 63),
+                    buffer
+                );
+            } break;
+
+            case Value::Type::Real: {
+                uint64_t bits;
+                (void)memcpy(&bits, &value.data_.real, sizeof(bits));
+                for (size_t i = 0; i < 8; ++i) {
+                    buffer.push_back((uint8_t)(bits >> (i * 8)));
+                }
+            } break;
+
+            case Value::Type::Text:
+            case Value::Type::Error: {
+                size_t size;
+                const auto text = value.GetText(size);
+                EncodeBytes(text, size, buffer);
+            } break;
+
+            case Value::Type::Blob: {
+                const BlobView blob(value);
+                EncodeBytes(blob.data, blob.size, buffer);
+            } break;
+
+            default: break;
+        }
+    }
+
+    void EncodeValues(
+        const Value* values,
+        size_t count,
+        Blob& buffer
+    ) {
+        for (size_t i = 0; i < count; ++i) {
+            EncodeValue(values[i], buffer);
+        }
+    }
+
+    void EncodeRowBatch(
+        const RowBatch& batch,
+        Blob& buffer
+    ) {
+        const auto columns = batch.GetColumnCount();
+        const auto rows = batch.GetRowCount();
+        EncodeVarint(columns, buffer);
+        for (size_t column = 0; column < columns; ++column) {
+            buffer.push_back((uint8_t)TagFromType(batch.GetColumnType(column)));
+        }
+        EncodeVarint(rows, buffer);
+        for (size_t row = 0; row < rows; ++row) {
+            for (size_t column = 0; column < columns; ++column) {
+                EncodeValue(batch.GetValue(row, column), buffer);
+            }
+        }
+    }
+
+    ValueDecoder::ValueDecoder(BlobView buffer)
+        : begin_(buffer.data)
+        , next_(buffer.data)
+        , end_(buffer.data + buffer.size)
+    {
+    }
+
+    bool ValueDecoder::AtEnd() const {
+        return next_ == end_;
+    }
+
+    size_t ValueDecoder::GetOffset() const {
+        return (size_t)(next_ - begin_);
+    }
+
+    std::string ValueDecoder::Decode(Value& value) {
+        return DecodeValue(value, nullptr);
+    }
+
+    std::string ValueDecoder::Decode(
+        Value& value,
+        Arena& arena
+    ) {
+        return DecodeValue(value, &arena);
+    }
+
+    std::string ValueDecoder::Decode(RowBatch& batch) {
+        uint64_t columns;
+        if (
+            !ReadVarint(columns)
+            || (columns > (uint64_t)(end_ - next_))
+        ) {
+            return "truncated row batch";
+        }
+        std::vector< Value::Type > columnTypes((size_t)columns);
+        for (auto& columnType: columnTypes) {
+            if (!TypeFromTag(*next_++, columnType)) {
+                return "unknown value tag";
+            }
+        }
+        uint64_t rows;
+        if (!ReadVarint(rows)) {
+            return "truncated row batch";
+        }
+        if (columns == 0) {
+            if (rows > 0) {
+                return "invalid row batch";
+            }
+        } else if (rows > (uint64_t)(end_ - next_) / columns) {
+            return "truncated row batch";
+        }
+        auto sameColumns = (batch.GetColumnCount() == columnTypes.size());
+        for (size_t column = 0; sameColumns && (column < columnTypes.size()); ++column) {
+            sameColumns = (batch.GetColumnType(column) == columnTypes[column]);
+        }
+        if (sameColumns) {
+            batch.Clear();
+        } else {
+            batch = RowBatch(columnTypes, (size_t)rows);
+        }
+        auto& arena = batch.GetArena();
+        for (uint64_t i = 0; i < rows; ++i) {
+            const auto row = batch.AddRow();
+            for (size_t column = 0; column < columnTypes.size(); ++column) {
+                const auto error = DecodeValue(batch.GetValue(row, column), &arena);
+                if (!error.empty()) {
+                    return error;
+                }
+            }
+        }
+        return "";
+    }
+
+    std::string ValueDecoder::DecodeValue(
+        Value& value,
+        Arena* arena
+    ) {
+        if (next_ == end_) {
+            return "truncated value";
+        }
+        const auto tag = (ValueTag)*next_++;
+        switch (tag) {
+            case ValueTag::Invalid: {
+                value = Value();
+            } break;
+
+            case ValueTag::Null: {
+                value = nullptr;
+            } break;
+
+            case ValueTag::Boolean: {
+                if (next_ == end_) {
+                    return "truncated value";
+                }
+                value = (*next_++ != 0);
+            } break;
+
+            case ValueTag::Integer: {
+                uint64_t zigzag;
+                if (!ReadVarint(zigzag)) {
+                    return "truncated value";
+                }
+                value = (intmax_t)(int64_t)((zigzag >> 1) ^ (~(zigzag & 1) + 1));
+            } break;
+
+            case ValueTag::Real: {
+                if (end_ - next_ < 8) {
+                    return "truncated value";
+                }
+                uint64_t bits = 0;
+                for (size_t i = 0; i < 8; ++i) {
+                    bits |= ((uint64_t)*next_++ << (i * 8));
+                }
+                double real;
+                (void)memcpy(&real, &bits, sizeof(real));
+                value = real;
+            } break;
+
+            case ValueTag::Text:
+            case ValueTag::Error: {
+                const uint8_t* data;
+                size_t size;
+                if (!ReadBytes(data, size)) {
+                    return "truncated value";
+                }
+                if (tag == ValueTag::Error) {
+                    value = Value::Error(std::string((const char*)data, size));
+                } else if (arena == nullptr) {
+                    value.SetText((const char*)data, size);
+                } else {
+                    value = Value((const char*)data, size, *arena);
+                }
+            } break;
+
+            case ValueTag::Blob: {
+                const uint8_t* data;
+                size_t size;
+                if (!ReadBytes(data, size)) {
+                    return "truncated value";
+                }
+                value = BlobView(data, size);
+            } break;
+
+            default: return "unknown value tag";
+        }
+        return "";
+    }
+
+    bool ValueDecoder::ReadVarint(uint64_t& value) {
+        value = 0;
+        for (size_t shift = 0; shift < 64; shift += 7) {
+            if (next_ == end_) {
+                return false;
+            }
+            const auto byte = *next_++;
+            value |= ((uint64_t)(byte & 0x7F) << shift);
+            if ((byte & 0x80) == 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool ValueDecoder::ReadBytes(
+        const uint8_t*& data,
+        size_t& size
+    ) {
+        uint64_t length;
+        if (
+            !ReadVarint(length)
+            || (length > (uint64_t)(end_ - next_))
+        ) {
+            return false;
+        }
+        data = next_;
+        size = (size_t)length;
+        next_ += size;
+        return true;
+    }
+
+}
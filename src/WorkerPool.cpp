@@ -0,0 +1,158 @@
+/**
+ * @file WorkerPool.cpp
+ *
+ * This file contains the implementation
+ * of the DatabaseAbstractions::WorkerPool class.
+ */
+
+#include <algorithm>
+#include <condition_variable>
+#include <DatabaseAbstractions/WorkerPool.hpp>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    /**
+     * This holds the state shared between a worker pool and its threads.
+     * The threads keep it alive, so that a pool may be destroyed by one
+     * of its own threads, in which case that thread finishes the queued
+     * work on its own after the pool is gone.
+     */
+    struct Shared {
+        // Properties
+
+        /**
+         * This is used to synchronize access to the queue and
+         * the stop flag.
+         */
+        std::mutex mutex;
+
+        /**
+         * This is used to wake worker threads when work is queued
+         * or the pool is stopping.
+         */
+        std::condition_variable wakeCondition;
+
+        /**
+         * These are the functions waiting to be called.
+         */
+        std::deque< std::function< void() > > queue;
+
+        /**
+         * This flag is set when the worker threads should stop once
+         * the queue is empty.
+         */
+        bool stop = false;
+    };
+
+    /**
+     * This is the body of each worker thread.  It calls queued
+     * functions until the pool is stopped and the queue is empty.
+     *
+     * @param[in] shared
+     *     This is the state shared with the pool.
+     */
+    void Worker(std::shared_ptr< Shared > shared) {
+        std::unique_lock< decltype(shared->mutex) > lock(shared->mutex);
+        for (;;) {
+            shared->wakeCondition.wait(
+                lock,
+                [&shared]{
+                    return shared->stop || !shared->queue.empty();
+                }
+            );
+            if (shared->queue.empty()) {
+                return;
+            }
+            auto work = std::move(shared->queue.front());
+            shared->queue.pop_front();
+            lock.unlock();
+            work();
+            work = nullptr;
+            lock.lock();
+        }
+    }
+
+}
+
+namespace DatabaseAbstractions {
+
+    struct WorkerPool::Impl {
+        // Properties
+
+        /**
+         * This is the state shared with the worker threads.
+         */
+        std::shared_ptr< Shared > shared = std::make_shared< Shared >();
+
+        /**
+         * These are the worker threads.
+         */
+        std::vector< std::thread > threads;
+
+        // Methods
+
+        /**
+         * This waits for the queue to be emptied and then stops
+         * the worker threads.
+         */
+        void StopThreads() {
+            {
+                std::lock_guard< decltype(shared->mutex) > lock(shared->mutex);
+                shared->stop = true;
+                shared->wakeCondition.notify_all();
+            }
+            for (auto& thread: threads) {
+                if (thread.get_id() == std::this_thread::get_id()) {
+                    thread.detach();
+                } else {
+                    thread.join();
+                }
+            }
+            threads.clear();
+        }
+    };
+
+    WorkerPool::~WorkerPool() noexcept {
+        if (impl_ != nullptr) {
+            impl_->StopThreads();
+        }
+    }
+
+    WorkerPool::WorkerPool(WorkerPool&&) noexcept = default;
+
+    WorkerPool& WorkerPool::operator=(WorkerPool&& other) noexcept {
+        if (this != &other) {
+            if (impl_ != nullptr) {
+                impl_->StopThreads();
+            }
+            impl_ = std::move(other.impl_);
+        }
+        return *this;
+    }
+
+    WorkerPool::WorkerPool(size_t threadCount)
+        : impl_(new Impl())
+    {
+        if (threadCount == 0) {
+            threadCount = std::max(std::thread::hardware_concurrency(), 1U);
+        }
+        for (size_t i = 0; i < threadCount; ++i) {
+            impl_->threads.emplace_back(Worker, impl_->shared);
+        }
+    }
+
+    size_t WorkerPool::GetThreadCount() const {
+        return impl_->threads.size();
+    }
+
+    void WorkerPool::Post(std::function< void() > work) {
+        std::lock_guard< decltype(impl_->shared->mutex) > lock(impl_->shared->mutex);
+        impl_->shared->queue.push_back(std::move(work));
+        impl_->shared->wakeCondition.notify_one();
+    }
+
+}
@@ -0,0 +1,71 @@
+/**
+ * @file WriteBatch.cpp
+ *
+ * This file contains the implementation
+ * of the DatabaseAbstractions::WriteBatch class.
+ */
+
+#include <DatabaseAbstractions/WriteBatch.hpp>
+
+namespace DatabaseAbstractions {
+
+    struct WriteBatch::Impl {
+        // Properties
+
+        /**
+         * These are the SQL texts of the statements in the batch.
+         */
+        std::vector< std::string > statements;
+
+        /**
+         * These are the values to bind to the parameters
+         * of each statement in the batch.
+         */
+        std::vector< std::vector< Value > > parameters;
+    };
+
+    WriteBatch::~WriteBatch() noexcept = default;
+    WriteBatch::WriteBatch(WriteBatch&&) noexcept = default;
+    WriteBatch& WriteBatch::operator=(WriteBatch&&) noexcept = default;
+
+    WriteBatch::WriteBatch()
+        : impl_(new Impl())
+    {
+    }
+
+    void WriteBatch::Add(
+        const std::string& statement,
+        std::initializer_list< const Value > parameters
+    ) {
+        Add(statement, std::vector< Value >(parameters.begin(), parameters.end()));
+    }
+
+    void WriteBatch::Add(
+        const std::string& statement,
+        std::vector< Value >&& parameters
+    ) {
+        for (auto& parameter: parameters) {
+            parameter.Own();
+        }
+        impl_->statements.push_back(statement);
+        impl_->parameters.push_back(std::move(parameters));
+    }
+
+    size_t WriteBatch::GetSize() const {
+        return impl_->statements.size();
+    }
+
+    const std::string& WriteBatch::GetStatement(size_t index) const {
+        return impl_->statements[index];
+    }
+
+    const std::vector< Value >& WriteBatch::GetParameters(size_t index) const {
+        return impl_->parameters[index];
+    }
+
+    void WriteBatch::Clear() {
+        impl_->statements.clear();
+        impl_->parameters.clear();
+    }
+
+}
@@ -0,0 +1,87 @@
+/**
+ * @file ArenaTests.cpp
+ *
+ * This module contains unit tests of the
+ * DatabaseAbstractions::Arena class.
+ */
+
+#include <DatabaseAbstractions/Arena.hpp>
+#include <gtest/gtest.h>
+#include <stdint.h>
+
+using namespace DatabaseAbstractions;
+
+/**
+ * This is the test fixture for these tests, providing common
+ * setup and teardown for each test.
+ */
+struct ArenaTests
+    : public ::testing::Test
+{
+};
+
+TEST_F(ArenaTests, Allocations_From_Same_Block) {
+    // Arrange
+    Arena arena(64);
+
+    // Act
+    const auto first = (uint8_t*)arena.Allocate(10, 1);
+    const auto second = (uint8_t*)arena.Allocate(10, 1);
+
+    // Assert
+    EXPECT_EQ(first + 10, second);
+    EXPECT_EQ(20, arena.GetBytesUsed());
+    EXPECT_EQ(64, arena.GetBytesReserved());
+}
+
+TEST_F(ArenaTests, Allocations_Aligned) {
+    // Arrange
+    Arena arena(64);
+    (void)arena.Allocate(1, 1);
+
+    // Act
+    const auto memory = arena.Allocate(8, 8);
+
+    // Assert
+    EXPECT_EQ(0, (uintptr_t)memory % 8);
+}
+
+TEST_F(ArenaTests, New_Block_When_Full) {
+    // Arrange
+    Arena arena(64);
+    (void)arena.Allocate(60, 1);
+
+    // Act
+    (void)arena.Allocate(10, 1);
+
+    // Assert
+    EXPECT_EQ(128, arena.GetBytesReserved());
+}
+
+TEST_F(ArenaTests, Large_Allocation_Gets_Own_Block) {
+    // Arrange
+    Arena arena(64);
+
+    // Act
+    (void)arena.Allocate(1000, 1);
+
+    // Assert
+    EXPECT_EQ(1000, arena.GetBytesReserved());
+}
+
+TEST_F(ArenaTests, Reset_Reuses_Blocks) {
+    // Arrange
+    Arena arena(64);
+    const auto first = arena.Allocate(60, 1);
+    (void)arena.Allocate(60, 1);
+
+    // Act
+    arena.Reset();
+    const auto again = arena.Allocate(60, 1);
+    (void)arena.Allocate(60, 1);
+
+    // Assert
+    EXPECT_EQ(first, again);
+    EXPECT_EQ(120, arena.GetBytesUsed());
+    EXPECT_EQ(128, arena.GetBytesReserved());
+}
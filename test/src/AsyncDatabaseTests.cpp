@@ -0,0 +1,252 @@
+/**
+ * @file AsyncDatabaseTests.cpp
+ *
+ * This module contains unit tests of the
+ * DatabaseAbstractions::AsyncDatabase class.
+ */
+
+#include <DatabaseAbstractions/AsyncDatabase.hpp>
+#include <DatabaseAbstractions/InMemoryDatabase.hpp>
+#include <future>
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace DatabaseAbstractions;
+
+/**
+ * This is the test fixture for these tests, providing common
+ * setup and teardown for each test.
+ */
+struct AsyncDatabaseTests
+    : public ::testing::Test
+{
+    // Properties
+
+    std::shared_ptr< WorkerPool > pool = std::make_shared< WorkerPool >(2);
+    std::shared_ptr< InMemoryDatabase > wrapped = std::make_shared< InMemoryDatabase >();
+    AsyncDatabase database{wrapped, pool};
+
+    // Methods
+
+    /**
+     * This executes the given statement asynchronously and waits
+     * for it to finish.
+     *
+     * @param[in] statement
+     *     This is the statement to execute.
+     *
+     * @return
+     *     The error reported by the statement is returned.
+     */
+    std::string ExecuteAndWait(const std::string& statement) {
+        std::promise< std::string > error;
+        database.ExecuteAsync(
+            statement,
+            [&](const std::string& result){ error.set_value(result); }
+        );
+        return error.get_future().get();
+    }
+
+    /**
+     * This returns the number of rows in the numbers table of the
+     * given database.
+     *
+     * @param[in] target
+     *     This is the database to query.
+     *
+     * @return
+     *     The number of rows in the table is returned.
+     */
+    int Count(Database& target) {
+        const auto built = target.BuildStatement("SELECT COUNT(*) FROM numbers");
+        EXPECT_EQ("", built.error);
+        if (built.statement == nullptr) {
+            return -1;
+        }
+        EXPECT_EQ("", built.statement->Step().error);
+        return built.statement->FetchColumn(0, Value::Type::Integer);
+    }
+
+    // ::testing::Test
+
+    virtual void SetUp() override {
+        ASSERT_EQ(
+            "",
+            wrapped->ExecuteStatement(
+                "CREATE TABLE numbers (value INTEGER)"
+            )
+        );
+    }
+};
+
+TEST_F(AsyncDatabaseTests, Execute_Async_Done_On_Worker_Thread) {
+    // Arrange
+    std::promise< std::thread::id > threadId;
+
+    // Act
+    database.ExecuteAsync(
+        "INSERT INTO numbers VALUES (1)",
+        [&](const std::string& error){
+            EXPECT_EQ("", error);
+            threadId.set_value(std::this_thread::get_id());
+        }
+    );
+
+    // Assert
+    EXPECT_NE(std::this_thread::get_id(), threadId.get_future().get());
+    EXPECT_EQ(1, Count(database));
+}
+
+TEST_F(AsyncDatabaseTests, Execute_Async_Reports_Errors) {
+    // Arrange
+
+    // Act
+    const auto error = ExecuteAndWait("INSERT INTO nowhere VALUES (1)");
+
+    // Assert
+    EXPECT_FALSE(error.empty());
+}
+
+TEST_F(AsyncDatabaseTests, Work_Done_In_Order_Requested) {
+    // Arrange
+    std::promise< void > done;
+
+    // Act
+    for (int i = 0; i < 100; ++i) {
+        database.ExecuteAsync(
+            "INSERT INTO numbers VALUES (" + std::to_string(i) + ")",
+            [](const std::string& error){ EXPECT_EQ("", error); }
+        );
+    }
+    database.ExecuteAsync(
+        "DELETE FROM numbers WHERE value = 99",
+        [&](const std::string& error){
+            EXPECT_EQ("", error);
+            done.set_value();
+        }
+    );
+    done.get_future().wait();
+
+    // Assert
+    EXPECT_EQ(99, Count(database));
+}
+
+TEST_F(AsyncDatabaseTests, Synchronous_Calls_Wait_For_Earlier_Async_Work) {
+    // Arrange
+    for (int i = 0; i < 10; ++i) {
+        database.ExecuteAsync(
+            "INSERT INTO numbers VALUES (" + std::to_string(i) + ")",
+            [](const std::string& error){ EXPECT_EQ("", error); }
+        );
+    }
+
+    // Act
+    const auto count = Count(database);
+
+    // Assert
+    EXPECT_EQ(10, count);
+}
+
+TEST_F(AsyncDatabaseTests, Build_And_Step_Async) {
+    // Arrange
+    ASSERT_EQ("", ExecuteAndWait("INSERT INTO numbers VALUES (1), (2), (3)"));
+    std::promise< std::vector< std::string > > valuesPromise;
+    std::vector< std::string > values;
+    std::function< void(const StepStatementResults&) > onStep;
+    std::shared_ptr< PreparedStatement > statement;
+
+    // Act
+    onStep = [&](const StepStatementResults& results){
+        if (results.done || !results.error.empty()) {
+            statement = nullptr;
+            valuesPromise.set_value(values);
+            return;
+        }
+        values.push_back(
+            (const std::string&)statement->FetchColumn(0, Value::Type::Text)
+        );
+        statement->StepAsync(onStep);
+    };
+    database.BuildStatementAsync(
+        "SELECT value FROM numbers ORDER BY value",
+        [&](const BuildStatementResults& results){
+            EXPECT_EQ("", results.error);
+            statement = results.statement;
+            statement->StepAsync(onStep);
+        }
+    );
+
+    // Assert
+    EXPECT_EQ(
+        std::vector< std::string >({"1", "2", "3"}),
+        valuesPromise.get_future().get()
+    );
+}
+
+TEST_F(AsyncDatabaseTests, Apply_Write_Batch_Async) {
+    // Arrange
+    WriteBatch batch;
+    batch.Add("INSERT INTO numbers VALUES (?)", {1});
+    batch.Add("INSERT INTO numbers VALUES (?)", {2});
+    std::promise< std::string > error;
+
+    // Act
+    database.ApplyWriteBatchAsync(
+        std::move(batch),
+        [&](const std::string& result){ error.set_value(result); }
+    );
+
+    // Assert
+    EXPECT_EQ("", error.get_future().get());
+    EXPECT_EQ(2, Count(database));
+}
+
+TEST_F(AsyncDatabaseTests, Databases_Share_Pool) {
+    // Arrange
+    auto otherWrapped = std::make_shared< InMemoryDatabase >();
+    AsyncDatabase other(otherWrapped, pool);
+    ASSERT_EQ("", other.ExecuteStatement("CREATE TABLE numbers (value INTEGER)"));
+    std::promise< void > firstDone;
+    std::promise< void > secondDone;
+
+    // Act
+    database.ExecuteAsync(
+        "INSERT INTO numbers VALUES (1)",
+        [&](const std::string& error){
+            EXPECT_EQ("", error);
+            firstDone.set_value();
+        }
+    );
+    other.ExecuteAsync(
+        "INSERT INTO numbers VALUES (2)",
+        [&](const std::string& error){
+            EXPECT_EQ("", error);
+            secondDone.set_value();
+        }
+    );
+    firstDone.get_future().wait();
+    secondDone.get_future().wait();
+
+    // Assert
+    EXPECT_EQ(1, Count(database));
+    EXPECT_EQ(1, Count(other));
+}
+
+TEST_F(AsyncDatabaseTests, Snapshot_Round_Trip) {
+    // Arrange
+    ASSERT_EQ("", ExecuteAndWait("INSERT INTO numbers VALUES (42)"));
+    AsyncDatabase follower(std::make_shared< InMemoryDatabase >(), pool);
+
+    // Act
+    const auto installError = follower.InstallSnapshot(database.CreateSnapshot());
+
+    // Assert
+    EXPECT_EQ("", installError);
+    const auto built = follower.BuildStatement("SELECT value FROM numbers");
+    ASSERT_EQ("", built.error);
+    ASSERT_EQ("", built.statement->Step().error);
+    EXPECT_EQ(42, (int)built.statement->FetchColumn(0, Value::Type::Integer));
+}
@@ -0,0 +1,259 @@
+/**
+ * @file BackgroundSnapshotTests.cpp
+ *
+ * This module contains unit tests of the
+ * DatabaseAbstractions::BackgroundSnapshot class.
+ */
+
+#include <algorithm>
+#include <DatabaseAbstractions/BackgroundSnapshot.hpp>
+#include <DatabaseAbstractions/InMemoryDatabase.hpp>
+#include <future>
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace DatabaseAbstractions;
+
+namespace {
+
+    /**
+     * This is a fake snapshot writer which collects the chunks written
+     * to it.  It can be made to wait before taking each chunk, so that
+     * tests can do things while a snapshot is being written, and to
+     * report an error instead of taking the chunks.
+     */
+    struct RecordingSnapshotWriter
+        : public SnapshotWriter
+    {
+        // Properties
+
+        Blob snapshot;
+        bool finished = false;
+        std::string error;
+        std::shared_future< void > gate;
+
+        // SnapshotWriter
+
+        virtual std::string WriteChunk(BlobView chunk) override {
+            if (gate.valid()) {
+                gate.wait();
+            }
+            if (!error.empty()) {
+                return error;
+            }
+            snapshot.insert(snapshot.end(), chunk.data, chunk.data + chunk.size);
+            return "";
+        }
+
+        virtual std::string Finish() override {
+            finished = true;
+            return "";
+        }
+    };
+
+    /**
+     * This is a fake snapshot reader which always reports an error.
+     */
+    struct FailingSnapshotReader
+        : public SnapshotReader
+    {
+        // SnapshotReader
+
+        virtual ReadSnapshotChunkResults ReadChunk(Blob& chunk) override {
+            ReadSnapshotChunkResults results;
+            chunk.clear();
+            results.error = "snapshot unavailable";
+            return results;
+        }
+    };
+
+}
+
+/**
+ * This is the test fixture for these tests, providing common
+ * setup and teardown for each test.
+ */
+struct BackgroundSnapshotTests
+    : public ::testing::Test
+{
+    // Properties
+
+    InMemoryDatabase database;
+    std::shared_ptr< RecordingSnapshotWriter > writer = std::make_shared< RecordingSnapshotWriter >();
+    std::promise< void > release;
+    bool released = false;
+    BackgroundSnapshot background;
+
+    // Methods
+
+    /**
+     * This makes the writer wait before taking each chunk until
+     * the release promise is fulfilled.
+     */
+    void HoldWriter() {
+        writer->gate = release.get_future().share();
+    }
+
+    /**
+     * This lets the writer go on taking chunks, if it was held.
+     */
+    void ReleaseWriter() {
+        if (!released) {
+            release.set_value();
+            released = true;
+        }
+    }
+
+    // ::testing::Test
+
+    virtual void SetUp() override {
+        ASSERT_EQ("", database.ExecuteStatement("CREATE TABLE numbers (n INTEGER, name TEXT)"));
+        ASSERT_EQ("", database.BeginTransaction());
+        const auto built = database.BuildStatement("INSERT INTO numbers VALUES (?, ?)");
+        ASSERT_EQ("", built.error);
+        for (int i = 0; i < 1000; ++i) {
+            built.statement->BindParameters({i, "number " + std::to_string(i)});
+            ASSERT_EQ("", built.statement->Step().error);
+            built.statement->Reset();
+        }
+        ASSERT_EQ("", database.CommitTransaction());
+    }
+
+    virtual void TearDown() override {
+        ReleaseWriter();
+        (void)background.Wait();
+    }
+};
+
+TEST_F(BackgroundSnapshotTests, Writes_Captured_State_While_Database_Changes) {
+    // Arrange
+    const auto expected = database.CreateSnapshot();
+    HoldWriter();
+    ASSERT_EQ("", background.Start(database, writer, nullptr, 256));
+
+    // Act
+    ASSERT_EQ(
+        "",
+        database.ExecuteStatement(
+            "DELETE FROM numbers WHERE n < 500;"
+            "UPDATE numbers SET name = 'changed';"
+            "INSERT INTO numbers VALUES (1000, 'new');"
+        )
+    );
+    ReleaseWriter();
+    const auto error = background.Wait();
+
+    // Assert
+    EXPECT_EQ("", error);
+    EXPECT_TRUE(writer->finished);
+    EXPECT_EQ(expected, writer->snapshot);
+    InMemoryDatabase copy;
+    EXPECT_EQ("", copy.InstallSnapshot(writer->snapshot));
+    EXPECT_EQ(expected, copy.CreateSnapshot());
+}
+
+TEST_F(BackgroundSnapshotTests, Progress_Reported_After_Each_Chunk) {
+    // Arrange
+    const auto expected = database.CreateSnapshot();
+    std::vector< BackgroundSnapshotProgress > reports;
+
+    // Act
+    ASSERT_EQ(
+        "",
+        background.Start(
+            database,
+            writer,
+            [&](const BackgroundSnapshotProgress& progress){
+                reports.push_back(progress);
+            },
+            256
+        )
+    );
+    const auto error = background.Wait();
+    const auto progress = background.GetProgress();
+
+    // Assert
+    EXPECT_EQ("", error);
+    ASSERT_FALSE(reports.empty());
+    EXPECT_EQ((expected.size() + 255) / 256, reports.size());
+    for (size_t i = 0; i < reports.size(); ++i) {
+        EXPECT_EQ(i + 1, reports[i].chunks);
+        EXPECT_EQ(std::min((i + 1) * 256, expected.size()), reports[i].bytes);
+        EXPECT_FALSE(reports[i].done);
+    }
+    EXPECT_TRUE(progress.done);
+    EXPECT_EQ(expected.size(), progress.bytes);
+    EXPECT_EQ(reports.size(), progress.chunks);
+}
+
+TEST_F(BackgroundSnapshotTests, Cancel_Stops_Before_Next_Chunk) {
+    // Arrange
+    HoldWriter();
+    ASSERT_EQ("", background.Start(database, writer, nullptr, 256));
+
+    // Act
+    background.Cancel();
+    ReleaseWriter();
+    const auto error = background.Wait();
+    const auto progress = background.GetProgress();
+
+    // Assert
+    EXPECT_EQ("snapshot cancelled", error);
+    EXPECT_FALSE(writer->finished);
+    EXPECT_TRUE(progress.done);
+    EXPECT_LE(progress.chunks, (uint64_t)1);
+}
+
+TEST_F(BackgroundSnapshotTests, Only_One_Snapshot_At_A_Time) {
+    // Arrange
+    HoldWriter();
+    ASSERT_EQ("", background.Start(database, writer));
+    const auto secondWriter = std::make_shared< RecordingSnapshotWriter >();
+
+    // Act
+    const auto secondError = background.Start(database, secondWriter);
+    ReleaseWriter();
+    const auto firstError = background.Wait();
+    const auto thirdError = background.Start(database, secondWriter);
+    const auto thirdWaitError = background.Wait();
+
+    // Assert
+    EXPECT_EQ("a snapshot is already being written", secondError);
+    EXPECT_EQ("", firstError);
+    EXPECT_EQ("", thirdError);
+    EXPECT_EQ("", thirdWaitError);
+    EXPECT_TRUE(writer->finished);
+    EXPECT_TRUE(secondWriter->finished);
+    EXPECT_EQ(writer->snapshot, secondWriter->snapshot);
+}
+
+TEST_F(BackgroundSnapshotTests, Writer_Error_Stops_Snapshot) {
+    // Arrange
+    writer->error = "disk full";
+
+    // Act
+    ASSERT_EQ("", background.Start(database, writer));
+    const auto error = background.Wait();
+
+    // Assert
+    EXPECT_EQ("disk full", error);
+    EXPECT_FALSE(writer->finished);
+    EXPECT_TRUE(background.GetProgress().done);
+    EXPECT_EQ((uint64_t)0, background.GetProgress().bytes);
+}
+
+TEST_F(BackgroundSnapshotTests, Reader_Error_Stops_Snapshot) {
+    // Arrange
+    const auto reader = std::make_shared< FailingSnapshotReader >();
+
+    // Act
+    ASSERT_EQ("", background.Start(reader, writer));
+    const auto error = background.Wait();
+
+    // Assert
+    EXPECT_EQ("snapshot unavailable", error);
+    EXPECT_FALSE(writer->finished);
+    EXPECT_EQ((uint64_t)0, background.GetProgress().chunks);
+}
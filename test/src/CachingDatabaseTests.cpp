@@ -0,0 +1,438 @@
+/**
+ * @file CachingDatabaseTests.cpp
+ *
+ * This module contains unit tests of the
+ * DatabaseAbstractions::CachingDatabase class.
+ */
+
+#include <DatabaseAbstractions/CachingDatabase.hpp>
+#include <DatabaseAbstractions/InMemoryDatabase.hpp>
+#include <DatabaseAbstractions/InstrumentedDatabase.hpp>
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace DatabaseAbstractions;
+
+namespace {
+
+    /**
+     * This is the type used to hold the rows returned by a query.
+     */
+    using Rows = std::vector< std::vector< Value > >;
+
+    /**
+     * This runs a query, fetching the given columns of every row.
+     *
+     * @param[in] statement
+     *     This is the statement to step.
+     *
+     * @param[in] types
+     *     These are the types of the columns to fetch.
+     *
+     * @return
+     *     The rows returned by the query are returned.
+     */
+    Rows Fetch(
+        PreparedStatement& statement,
+        const std::vector< Value::Type >& types
+    ) {
+        Rows rows;
+        for (;;) {
+            const auto results = statement.Step();
+            EXPECT_EQ("", results.error);
+            if (
+                results.done
+                || !results.error.empty()
+            ) {
+                break;
+            }
+            std::vector< Value > row;
+            for (size_t column = 0; column < types.size(); ++column) {
+                row.push_back(statement.FetchColumn((int)column, types[column]));
+                row.back().Own();
+            }
+            rows.push_back(std::move(row));
+        }
+        statement.Reset();
+        return rows;
+    }
+
+    /**
+     * This finds the metrics for the given SQL text.
+     *
+     * @param[in] metrics
+     *     These are the metrics to search.
+     *
+     * @param[in] text
+     *     This is the SQL text whose metrics to find.
+     *
+     * @return
+     *     The metrics for the SQL text are returned, or empty metrics
+     *     if there are none.
+     */
+    StatementMetrics FindStatement(
+        const DatabaseMetrics& metrics,
+        const std::string& text
+    ) {
+        for (const auto& statement: metrics.statements) {
+            if (statement.text == text) {
+                return statement;
+            }
+        }
+        return StatementMetrics();
+    }
+
+}
+
+/**
+ * This is the test fixture for these tests, providing common
+ * setup and teardown for each test.
+ */
+struct CachingDatabaseTests
+    : public ::testing::Test
+{
+    // Properties
+
+    std::shared_ptr< InMemoryDatabase > storage = std::make_shared< InMemoryDatabase >();
+    std::shared_ptr< InstrumentedDatabase > instrumented = std::make_shared< InstrumentedDatabase >(storage);
+    CachingDatabase database{instrumented};
+    const std::string peopleQuery = "SELECT name, age FROM people WHERE age > ? ORDER BY name";
+    const std::string petsQuery = "SELECT name FROM pets ORDER BY name";
+
+    // Methods
+
+    /**
+     * This runs the query of the people table.
+     *
+     * @param[in] age
+     *     This is the age which the people returned must be older than.
+     *
+     * @return
+     *     The rows returned by the query are returned.
+     */
+    Rows QueryPeople(const Value& age) {
+        const auto built = database.BuildStatement(peopleQuery);
+        EXPECT_EQ("", built.error);
+        built.statement->BindParameter(1, age);
+        return Fetch(*built.statement, {Value::Type::Text, Value::Type::Integer});
+    }
+
+    /**
+     * This runs the query of the pets table.
+     *
+     * @return
+     *     The rows returned by the query are returned.
+     */
+    Rows QueryPets() {
+        const auto built = database.BuildStatement(petsQuery);
+        EXPECT_EQ("", built.error);
+        return Fetch(*built.statement, {Value::Type::Text});
+    }
+
+    /**
+     * This returns the number of times the given query was
+     * stepped in the wrapped database.
+     *
+     * @param[in] query
+     *     This is the SQL text of the query.
+     *
+     * @return
+     *     The number of times the query was stepped is returned.
+     */
+    uint64_t CountSteps(const std::string& query) {
+        return FindStatement(instrumented->GetMetrics(), query).step.count;
+    }
+
+    // ::testing::Test
+
+    virtual void SetUp() override {
+        ASSERT_EQ(
+            "",
+            storage->ExecuteStatement(
+                "CREATE TABLE people (name TEXT, age INTEGER);"
+                "INSERT INTO people VALUES ('alice', 30), ('bob', 25), ('carol', 35);"
+                "CREATE TABLE pets (name TEXT);"
+                "INSERT INTO pets VALUES ('rex'), ('tom')"
+            )
+        );
+    }
+};
+
+TEST_F(CachingDatabaseTests, Repeated_Query_Answered_From_Cache) {
+    // Arrange
+    const Rows expected{
+        {Value("alice"), Value(30)},
+        {Value("carol"), Value(35)},
+    };
+
+    // Act
+    const auto first = QueryPeople(26);
+    const auto stepsAfterFirst = CountSteps(peopleQuery);
+    const auto second = QueryPeople(26);
+
+    // Assert
+    EXPECT_EQ(expected, first);
+    EXPECT_EQ(expected, second);
+    EXPECT_EQ(Value::Type::Integer, second[0][1].GetType());
+    EXPECT_EQ(3, stepsAfterFirst);
+    EXPECT_EQ(stepsAfterFirst, CountSteps(peopleQuery));
+    const auto statistics = database.GetStatistics();
+    EXPECT_EQ(1, statistics.hits);
+    EXPECT_EQ(1, statistics.misses);
+    EXPECT_EQ(1, statistics.stores);
+    EXPECT_EQ(1, statistics.entries);
+    EXPECT_GT(statistics.bytes, 0);
+    EXPECT_DOUBLE_EQ(0.5, statistics.GetHitRatio());
+}
+
+TEST_F(CachingDatabaseTests, Parameters_Are_Part_Of_Key) {
+    // Arrange
+
+    // Act
+    const auto older = QueryPeople(26);
+    const auto all = QueryPeople(0);
+    const auto real = QueryPeople(26.0);
+    const auto olderAgain = QueryPeople(26);
+
+    // Assert
+    EXPECT_EQ(2, older.size());
+    EXPECT_EQ(3, all.size());
+    EXPECT_EQ(older, real);
+    EXPECT_EQ(older, olderAgain);
+    const auto statistics = database.GetStatistics();
+    EXPECT_EQ(1, statistics.hits);
+    EXPECT_EQ(3, statistics.misses);
+    EXPECT_EQ(3, statistics.entries);
+}
+
+TEST_F(CachingDatabaseTests, Executed_Write_Invalidates_Its_Table) {
+    // Arrange
+    (void)QueryPeople(0);
+    (void)QueryPets();
+
+    // Act
+    ASSERT_EQ("", database.ExecuteStatement("INSERT INTO people VALUES ('dave', 40)"));
+    const auto people = QueryPeople(0);
+    const auto pets = QueryPets();
+
+    // Assert
+    EXPECT_EQ(4, people.size());
+    EXPECT_EQ(2, pets.size());
+    const auto statistics = database.GetStatistics();
+    EXPECT_EQ(1, statistics.hits);
+    EXPECT_EQ(3, statistics.misses);
+    EXPECT_EQ(1, statistics.invalidations);
+}
+
+TEST_F(CachingDatabaseTests, Built_Write_Invalidates_Its_Table_When_Stepped) {
+    // Arrange
+    (void)QueryPeople(0);
+    (void)QueryPets();
+    const auto update = database.BuildStatement(
+        "UPDATE People SET age = ? WHERE name = ?"
+    );
+    ASSERT_EQ("", update.error);
+    update.statement->BindParameters({20, "carol"});
+
+    // Act
+    EXPECT_EQ(3, QueryPeople(0).size());
+    EXPECT_EQ(1, database.GetStatistics().hits);
+    (void)update.statement->Step();
+    const auto people = QueryPeople(0);
+    (void)QueryPets();
+
+    // Assert
+    const Rows expected{
+        {Value("alice"), Value(30)},
+        {Value("bob"), Value(25)},
+        {Value("carol"), Value(20)},
+    };
+    EXPECT_EQ(expected, people);
+    const auto statistics = database.GetStatistics();
+    EXPECT_EQ(2, statistics.hits);
+    EXPECT_EQ(1, statistics.invalidations);
+}
+
+TEST_F(CachingDatabaseTests, Write_Batch_Invalidates_Its_Tables) {
+    // Arrange
+    (void)QueryPeople(0);
+    (void)QueryPets();
+    WriteBatch batch;
+    batch.Add("DELETE FROM pets WHERE name = ?", {"rex"});
+
+    // Act
+    ASSERT_EQ("", database.ApplyWriteBatch(batch));
+    const auto pets = QueryPets();
+    (void)QueryPeople(0);
+
+    // Assert
+    EXPECT_EQ(Rows({{Value("tom")}}), pets);
+    const auto statistics = database.GetStatistics();
+    EXPECT_EQ(1, statistics.hits);
+    EXPECT_EQ(1, statistics.invalidations);
+}
+
+TEST_F(CachingDatabaseTests, Rollback_And_Unknown_Statements_Invalidate_All) {
+    // Arrange
+    (void)QueryPeople(0);
+    (void)QueryPets();
+
+    // Act
+    ASSERT_EQ("", database.BeginTransaction());
+    ASSERT_EQ("", database.ExecuteStatement("INSERT INTO pets VALUES ('fido')"));
+    EXPECT_EQ(3, QueryPets().size());
+    ASSERT_EQ("", database.RollbackTransaction());
+    const auto pets = QueryPets();
+    (void)QueryPeople(0);
+    ASSERT_EQ("", database.ExecuteStatement("CREATE INDEX by_age ON people (age)"));
+    (void)QueryPeople(0);
+
+    // Assert
+    EXPECT_EQ(2, pets.size());
+    const auto statistics = database.GetStatistics();
+    EXPECT_EQ(0, statistics.hits);
+    EXPECT_EQ(6, statistics.misses);
+    EXPECT_EQ(5, statistics.invalidations);
+}
+
+TEST_F(CachingDatabaseTests, Partial_Results_Continued_For_Real) {
+    // Arrange
+    const auto built = database.BuildStatement(peopleQuery);
+    ASSERT_EQ("", built.error);
+    built.statement->BindParameter(1, 0);
+    ASSERT_FALSE(built.statement->Step().done);
+    EXPECT_EQ(Value("alice"), built.statement->FetchColumn(0, Value::Type::Text));
+    built.statement->Reset();
+    const auto stepsAfterFirst = CountSteps(peopleQuery);
+
+    // Act
+    const auto people = Fetch(*built.statement, {Value::Type::Text});
+
+    // Assert
+    const Rows expected{
+        {Value("alice")},
+        {Value("bob")},
+        {Value("carol")},
+    };
+    EXPECT_EQ(expected, people);
+    EXPECT_EQ(1, stepsAfterFirst);
+    EXPECT_EQ(stepsAfterFirst + 4, CountSteps(peopleQuery));
+    EXPECT_EQ(1, database.GetStatistics().hits);
+}
+
+TEST_F(CachingDatabaseTests, Column_Not_Cached_Fetched_For_Real) {
+    // Arrange
+    const auto built = database.BuildStatement(peopleQuery);
+    ASSERT_EQ("", built.error);
+    built.statement->BindParameter(1, 0);
+    (void)Fetch(*built.statement, {Value::Type::Text});
+
+    // Act
+    const auto people = Fetch(*built.statement, {Value::Type::Text, Value::Type::Integer});
+    const auto peopleAgain = Fetch(*built.statement, {Value::Type::Text, Value::Type::Integer});
+
+    // Assert
+    const Rows expected{
+        {Value("alice"), Value(30)},
+        {Value("bob"), Value(25)},
+        {Value("carol"), Value(35)},
+    };
+    EXPECT_EQ(expected, people);
+    EXPECT_EQ(expected, peopleAgain);
+    const auto statistics = database.GetStatistics();
+    EXPECT_EQ(1, statistics.hits);
+    EXPECT_EQ(2, statistics.misses);
+    EXPECT_EQ(1, statistics.entries);
+}
+
+TEST_F(CachingDatabaseTests, Blobs_And_Batches_Served_From_Cache) {
+    // Arrange
+    ASSERT_EQ(
+        "",
+        storage->ExecuteStatement("CREATE TABLE files (name TEXT, data BLOB)")
+    );
+    const auto insert = storage->BuildStatement("INSERT INTO files VALUES (?, ?)");
+    insert.statement->BindParameters({"a", Blob{1, 2, 3}});
+    (void)insert.statement->Step();
+    const std::string query = "SELECT name, data FROM files";
+    const auto built = database.BuildStatement(query);
+    ASSERT_EQ("", built.error);
+    RowBatch first({Value::Type::Text, Value::Type::Blob});
+    RowBatch second({Value::Type::Text, Value::Type::Blob});
+
+    // Act
+    const auto firstResults = built.statement->StepBatch(10, first);
+    built.statement->Reset();
+    const auto secondResults = built.statement->StepBatch(10, second);
+
+    // Assert
+    EXPECT_TRUE(firstResults.done);
+    EXPECT_TRUE(secondResults.done);
+    ASSERT_EQ(1, second.GetRowCount());
+    EXPECT_EQ(Value("a"), second.GetValue(0, 0));
+    EXPECT_EQ(Value(Blob{1, 2, 3}), second.GetValue(0, 1));
+    EXPECT_EQ(1, database.GetStatistics().hits);
+}
+
+TEST_F(CachingDatabaseTests, Memory_Budget_Evicts_Least_Recently_Used) {
+    // Arrange
+    (void)QueryPeople(0);
+    const auto entryBytes = database.GetStatistics().bytes;
+    database.SetMemoryBudget(entryBytes * 2 + entryBytes / 2);
+    (void)QueryPeople(10);
+    (void)QueryPeople(0);
+
+    // Act
+    (void)QueryPeople(20);
+    (void)QueryPeople(0);
+    (void)QueryPeople(10);
+
+    // Assert
+    const auto statistics = database.GetStatistics();
+    EXPECT_EQ(2, statistics.hits);
+    EXPECT_EQ(4, statistics.misses);
+    EXPECT_EQ(2, statistics.evictions);
+    EXPECT_EQ(2, statistics.entries);
+    EXPECT_LE(statistics.bytes, entryBytes * 2 + entryBytes / 2);
+}
+
+TEST_F(CachingDatabaseTests, Snapshot_Install_Invalidates_All) {
+    // Arrange
+    (void)QueryPeople(0);
+    InMemoryDatabase other;
+    ASSERT_EQ(
+        "",
+        other.ExecuteStatement(
+            "CREATE TABLE people (name TEXT, age INTEGER);"
+            "INSERT INTO people VALUES ('zoe', 50)"
+        )
+    );
+
+    // Act
+    ASSERT_EQ("", database.InstallSnapshot(other.CreateSnapshot()));
+    const auto people = QueryPeople(0);
+
+    // Assert
+    EXPECT_EQ(Rows({{Value("zoe"), Value(50)}}), people);
+    EXPECT_EQ(0, database.GetStatistics().hits);
+    EXPECT_EQ(1, database.GetStatistics().invalidations);
+}
+
+TEST_F(CachingDatabaseTests, Clear_Discards_Everything) {
+    // Arrange
+    (void)QueryPeople(0);
+    (void)QueryPets();
+
+    // Act
+    database.Clear();
+    (void)QueryPets();
+
+    // Assert
+    const auto statistics = database.GetStatistics();
+    EXPECT_EQ(0, statistics.hits);
+    EXPECT_EQ(3, statistics.misses);
+    EXPECT_EQ(0, statistics.invalidations);
+    EXPECT_EQ(1, statistics.entries);
+}
@@ -0,0 +1,93 @@
+/**
+ * @file CompositeKeyTests.cpp
+ *
+ * This module contains unit tests of the
+ * DatabaseAbstractions::CompositeKey class.
+ */
+
+#include <DatabaseAbstractions/CompositeKey.hpp>
+#include <gtest/gtest.h>
+#include <map>
+#include <string>
+#include <unordered_map>
+
+using namespace DatabaseAbstractions;
+
+/**
+ * This is the test fixture for these tests, providing common
+ * setup and teardown for each test.
+ */
+struct CompositeKeyTests
+    : public ::testing::Test
+{
+};
+
+TEST_F(CompositeKeyTests, Equivalent_Keys_Equal_With_Same_Hash) {
+    // Arrange
+    const CompositeKey key1{Value(1), Value("alice")};
+    const CompositeKey key2{Value(1.0), Value(std::string("alice"))};
+    const CompositeKey key3{Value(1), Value("bob")};
+    const CompositeKey key4{Value(1)};
+
+    // Act
+
+    // Assert
+    EXPECT_EQ(key1, key2);
+    EXPECT_EQ(key1.Hash(), key2.Hash());
+    EXPECT_NE(key1, key3);
+    EXPECT_NE(key1.Hash(), key3.Hash());
+    EXPECT_NE(key1, key4);
+    EXPECT_EQ(2, key1.GetSize());
+    EXPECT_EQ(Value("alice"), key1[1]);
+}
+
+TEST_F(CompositeKeyTests, Order_Is_Lexicographic) {
+    // Arrange
+    const CompositeKey empty;
+    const CompositeKey shorter{Value(1)};
+    const CompositeKey longer{Value(1), Value(nullptr)};
+    const CompositeKey later{Value(1), Value(5)};
+    const CompositeKey latest{Value(2), Value(0)};
+
+    // Act
+
+    // Assert
+    EXPECT_LT(empty, shorter);
+    EXPECT_LT(shorter, longer);
+    EXPECT_LT(longer, later);
+    EXPECT_LT(later, latest);
+    EXPECT_EQ(0, later.Compare(CompositeKey{Value(1.0), Value(5.0)}));
+    EXPECT_EQ(1, latest.Compare(empty));
+}
+
+TEST_F(CompositeKeyTests, Borrowed_Data_Owned) {
+    // Arrange
+    Blob blob{0x01, 0x02};
+    const CompositeKey key{Value(BlobView(blob))};
+
+    // Act
+    blob[0] = 0xFF;
+
+    // Assert
+    EXPECT_FALSE(key[0].IsBorrowed());
+    EXPECT_EQ(Value(Blob({0x01, 0x02})), key[0]);
+}
+
+TEST_F(CompositeKeyTests, Keys_In_Containers) {
+    // Arrange
+    std::unordered_map< CompositeKey, int > unordered;
+    std::map< CompositeKey, int > ordered;
+
+    // Act
+    for (int i = 0; i < 100; ++i) {
+        const CompositeKey key{Value(i % 10), Value(std::to_string(i / 10))};
+        unordered[key] += i;
+        ordered[key] += i;
+    }
+
+    // Assert
+    EXPECT_EQ(100, unordered.size());
+    EXPECT_EQ(23, (unordered[CompositeKey{Value(3), Value("2")}]));
+    EXPECT_EQ((CompositeKey{Value(0), Value("0")}), ordered.begin()->first);
+    EXPECT_EQ((CompositeKey{Value(9), Value("9")}), ordered.rbegin()->first);
+}
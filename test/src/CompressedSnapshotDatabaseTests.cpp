@@ -0,0 +1,161 @@
+/**
+ * @file CompressedSnapshotDatabaseTests.cpp
+ *
+ * This module contains unit tests of the
+ * DatabaseAbstractions::CompressedSnapshotDatabase class.
+ */
+
+#include <DatabaseAbstractions/CompressedSnapshotDatabase.hpp>
+#include <DatabaseAbstractions/InMemoryDatabase.hpp>
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+
+using namespace DatabaseAbstractions;
+
+/**
+ * This is the test fixture for these tests, providing common
+ * setup and teardown for each test.
+ */
+struct CompressedSnapshotDatabaseTests
+    : public ::testing::Test
+{
+    // Properties
+
+    std::shared_ptr< InMemoryDatabase > wrapped = std::make_shared< InMemoryDatabase >();
+    std::shared_ptr< WorkerPool > pool = std::make_shared< WorkerPool >(2);
+    CompressedSnapshotDatabase database{wrapped, nullptr, pool, 1024};
+
+    // Methods
+
+    /**
+     * This returns the number of rows in the "kv" table
+     * of the given database.
+     */
+    static intmax_t Count(Database& target) {
+        const auto built = target.BuildStatement("SELECT COUNT(*) FROM kv");
+        if (built.statement == nullptr) {
+            return -1;
+        }
+        (void)built.statement->Step();
+        return built.statement->FetchColumn(0, Value::Type::Integer);
+    }
+
+    // ::testing::Test
+
+    virtual void SetUp() override {
+        ASSERT_EQ("", database.ExecuteStatement("CREATE TABLE kv (key TEXT, value TEXT)"));
+        for (int i = 0; i < 200; ++i) {
+            const auto key = std::to_string(i);
+            ASSERT_EQ(
+                "",
+                database.ExecuteStatement(
+                    "INSERT INTO kv VALUES ('key " + key + "', 'the value for key " + key + "')"
+                )
+            );
+        }
+    }
+};
+
+TEST_F(CompressedSnapshotDatabaseTests, Snapshot_Compressed_And_Installed) {
+    // Arrange
+    CompressedSnapshotDatabase follower(std::make_shared< InMemoryDatabase >());
+
+    // Act
+    const auto snapshot = database.CreateSnapshot();
+    const auto error = follower.InstallSnapshot(snapshot);
+
+    // Assert
+    EXPECT_TRUE(IsSnapshotFrame(snapshot));
+    EXPECT_LT(snapshot.size(), wrapped->CreateSnapshot().size() / 2);
+    EXPECT_EQ("", error);
+    EXPECT_EQ(200, Count(follower));
+}
+
+TEST_F(CompressedSnapshotDatabaseTests, Uncompressed_Snapshot_Installed) {
+    // Arrange
+    CompressedSnapshotDatabase follower(std::make_shared< InMemoryDatabase >());
+
+    // Act
+    const auto error = follower.InstallSnapshot(wrapped->CreateSnapshot());
+
+    // Assert
+    EXPECT_EQ("", error);
+    EXPECT_EQ(200, Count(follower));
+}
+
+TEST_F(CompressedSnapshotDatabaseTests, Chunked_Snapshot_Transferred) {
+    // Arrange
+    CompressedSnapshotDatabase follower(std::make_shared< InMemoryDatabase >(), nullptr, pool);
+    const auto reader = database.CreateSnapshotReader(256);
+    const auto writer = follower.CreateSnapshotWriter();
+    size_t transferred = 0;
+
+    // Act
+    Blob chunk;
+    for (;;) {
+        const auto results = reader->ReadChunk(chunk);
+        ASSERT_EQ("", results.error);
+        if (results.done) {
+            break;
+        }
+        transferred += chunk.size();
+        ASSERT_EQ("", writer->WriteChunk(chunk));
+    }
+    const auto error = writer->Finish();
+
+    // Assert
+    EXPECT_EQ("", error);
+    EXPECT_EQ(200, Count(follower));
+    EXPECT_LT(transferred, wrapped->CreateSnapshot().size() / 2);
+}
+
+TEST_F(CompressedSnapshotDatabaseTests, Delta_Snapshot_Compressed_And_Installed) {
+    // Arrange
+    CompressedSnapshotDatabase follower(std::make_shared< InMemoryDatabase >());
+    ASSERT_EQ("", follower.InstallSnapshot(database.CreateSnapshot()));
+    const auto baseId = database.GetSnapshotId();
+    ASSERT_EQ("", database.ExecuteStatement("DELETE FROM kv WHERE key = 'key 7'"));
+
+    // Act
+    const auto delta = database.CreateDeltaSnapshot(baseId);
+    const auto error = follower.InstallDeltaSnapshot(delta);
+
+    // Assert
+    EXPECT_EQ("", delta.error);
+    EXPECT_FALSE(delta.full);
+    EXPECT_TRUE(IsSnapshotFrame(delta.blob));
+    EXPECT_EQ("", error);
+    EXPECT_EQ(199, Count(follower));
+    EXPECT_EQ(database.GetSnapshotId(), follower.GetSnapshotId());
+}
+
+TEST_F(CompressedSnapshotDatabaseTests, Corrupt_Snapshot_Rejected) {
+    // Arrange
+    auto snapshot = database.CreateSnapshot();
+    snapshot[5] = 123;
+
+    // Act
+    const auto error = database.InstallSnapshot(snapshot);
+
+    // Assert
+    EXPECT_EQ("unknown snapshot codec", error);
+    EXPECT_EQ(200, Count(database));
+}
+
+TEST_F(CompressedSnapshotDatabaseTests, Damaged_Snapshot_Rejected_Before_Install) {
+    // Arrange
+    auto snapshot = database.CreateSnapshot();
+    snapshot[snapshot.size() / 2] ^= 0x10;
+    CompressedSnapshotDatabase follower(std::make_shared< InMemoryDatabase >());
+    ASSERT_EQ("", follower.ExecuteStatement("CREATE TABLE kv (key TEXT, value TEXT)"));
+
+    // Act
+    const auto verification = VerifySnapshotFrame(snapshot);
+    const auto error = follower.InstallSnapshot(snapshot);
+
+    // Assert
+    EXPECT_EQ(verification.error, error);
+    EXPECT_EQ(0, error.find("corrupt block "));
+    EXPECT_EQ(0, Count(follower));
+}
@@ -0,0 +1,333 @@
+/**
+ * @file ConnectionPoolTests.cpp
+ *
+ * This module contains unit tests of the
+ * DatabaseAbstractions::ConnectionPool class.
+ */
+
+#include <DatabaseAbstractions/ConnectionPool.hpp>
+#include <gtest/gtest.h>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace DatabaseAbstractions;
+
+namespace {
+
+    /**
+     * This is a fake prepared statement which does nothing.
+     */
+    struct MockStatement
+        : public PreparedStatement
+    {
+        // PreparedStatement
+
+        virtual void BindParameter(
+            int index,
+            const Value& value
+        ) override {
+        }
+
+        virtual void BindParameters(std::initializer_list< const Value > values) override {
+        }
+
+        virtual Value FetchColumn(int index, Value::Type type) override {
+            return Value();
+        }
+
+        virtual void Reset() override {
+        }
+
+        virtual StepStatementResults Step() override {
+            StepStatementResults results;
+            results.done = true;
+            return results;
+        }
+    };
+
+    /**
+     * This is a fake database connection which records the statements
+     * built or executed on it.
+     */
+    struct MockConnection
+        : public Database
+    {
+        // Properties
+
+        std::mutex mutex;
+        std::vector< std::string > statements;
+
+        // Database
+
+        virtual BuildStatementResults BuildStatement(
+            const std::string& statement
+        ) override {
+            std::lock_guard< decltype(mutex) > lock(mutex);
+            statements.push_back(statement);
+            BuildStatementResults results;
+            results.statement = std::make_shared< MockStatement >();
+            return results;
+        }
+
+        virtual std::string ExecuteStatement(const std::string& statement) override {
+            std::lock_guard< decltype(mutex) > lock(mutex);
+            statements.push_back(statement);
+            return "";
+        }
+
+        virtual Blob CreateSnapshot() override {
+            return Blob();
+        }
+
+        virtual std::string InstallSnapshot(const Blob& blob) override {
+            return "";
+        }
+    };
+
+}
+
+/**
+ * This is the test fixture for these tests, providing common
+ * setup and teardown for each test.
+ */
+struct ConnectionPoolTests
+    : public ::testing::Test
+{
+    // Properties
+
+    /**
+     * These are the connections made for the pool, in the order they
+     * were made.  The first is the writer.
+     */
+    std::vector< std::shared_ptr< MockConnection > > connections;
+
+    // Methods
+
+    /**
+     * This makes a pool with the given number of readers, whose
+     * connections are kept by the fixture.
+     *
+     * @param[in] readerCount
+     *     This is the number of readers to give the pool.
+     *
+     * @return
+     *     The pool is returned.
+     */
+    std::unique_ptr< ConnectionPool > MakePool(size_t readerCount) {
+        return std::unique_ptr< ConnectionPool >(
+            new ConnectionPool(
+                [this]{
+                    const auto connection = std::make_shared< MockConnection >();
+                    connections.push_back(connection);
+                    return connection;
+                },
+                readerCount
+            )
+        );
+    }
+};
+
+TEST_F(ConnectionPoolTests, Connections_Made) {
+    // Arrange
+
+    // Act
+    const auto pool = MakePool(3);
+
+    // Assert
+    EXPECT_EQ(4, connections.size());
+    EXPECT_EQ(3, pool->GetStatistics().readers);
+}
+
+TEST_F(ConnectionPoolTests, Writes_Use_Writer) {
+    // Arrange
+    const auto pool = MakePool(2);
+
+    // Act
+    const auto built = pool->BuildStatement("INSERT INTO t VALUES (1)");
+    const auto error = pool->ExecuteStatement("DELETE FROM t");
+
+    // Assert
+    EXPECT_EQ("", built.error);
+    EXPECT_NE(nullptr, built.statement);
+    EXPECT_EQ("", error);
+    EXPECT_EQ(
+        std::vector< std::string >({
+            "INSERT INTO t VALUES (1)",
+            "DELETE FROM t",
+        }),
+        connections[0]->statements
+    );
+    EXPECT_TRUE(connections[1]->statements.empty());
+    EXPECT_TRUE(connections[2]->statements.empty());
+    EXPECT_EQ(2, pool->GetStatistics().writes);
+}
+
+TEST_F(ConnectionPoolTests, Concurrent_Reads_Use_Different_Readers) {
+    // Arrange
+    const auto pool = MakePool(2);
+
+    // Act
+    const auto first = pool->BuildStatement("SELECT a FROM t");
+    const auto second = pool->BuildStatement("  select b FROM t");
+
+    // Assert
+    EXPECT_TRUE(connections[0]->statements.empty());
+    EXPECT_EQ(1, connections[1]->statements.size());
+    EXPECT_EQ(1, connections[2]->statements.size());
+    const auto statistics = pool->GetStatistics();
+    EXPECT_EQ(2, statistics.reads);
+    EXPECT_EQ(2, statistics.readersInUse);
+    EXPECT_EQ(2, statistics.peakReadersInUse);
+    EXPECT_EQ(0, statistics.readerWaits);
+}
+
+TEST_F(ConnectionPoolTests, Reader_Released_With_Statement) {
+    // Arrange
+    const auto pool = MakePool(1);
+    auto first = pool->BuildStatement("SELECT a FROM t");
+
+    // Act
+    first.statement = nullptr;
+    const auto second = pool->BuildStatement("SELECT b FROM t");
+
+    // Assert
+    EXPECT_EQ(
+        std::vector< std::string >({
+            "SELECT a FROM t",
+            "SELECT b FROM t",
+        }),
+        connections[1]->statements
+    );
+    const auto statistics = pool->GetStatistics();
+    EXPECT_EQ(1, statistics.readersInUse);
+    EXPECT_EQ(1, statistics.peakReadersInUse);
+}
+
+TEST_F(ConnectionPoolTests, Read_Waits_For_Free_Reader) {
+    // Arrange
+    const auto pool = MakePool(1);
+    auto first = pool->BuildStatement("SELECT a FROM t");
+
+    // Act
+    BuildStatementResults second;
+    std::thread reader(
+        [&]{ second = pool->BuildStatement("SELECT b FROM t"); }
+    );
+    while (pool->GetStatistics().readerWaits == 0) {
+        std::this_thread::yield();
+    }
+    first.statement = nullptr;
+    reader.join();
+
+    // Assert
+    EXPECT_NE(nullptr, second.statement);
+    EXPECT_EQ(2, connections[1]->statements.size());
+    EXPECT_EQ(1, pool->GetStatistics().readerWaits);
+}
+
+TEST_F(ConnectionPoolTests, Reads_In_Transaction_Use_Writer) {
+    // Arrange
+    const auto pool = MakePool(1);
+
+    // Act
+    EXPECT_EQ("", pool->BeginTransaction());
+    (void)pool->BuildStatement("SELECT a FROM t");
+    EXPECT_EQ("", pool->CommitTransaction());
+    (void)pool->BuildStatement("SELECT b FROM t");
+
+    // Assert
+    EXPECT_EQ(
+        std::vector< std::string >({
+            "BEGIN",
+            "SELECT a FROM t",
+            "COMMIT",
+        }),
+        connections[0]->statements
+    );
+    EXPECT_EQ(
+        std::vector< std::string >({
+            "SELECT b FROM t",
+        }),
+        connections[1]->statements
+    );
+}
+
+TEST_F(ConnectionPoolTests, Reads_In_Transaction_Begun_By_Statement_Use_Writer) {
+    // Arrange
+    const auto pool = MakePool(1);
+
+    // Act
+    EXPECT_EQ("", pool->ExecuteStatement("begin transaction"));
+    (void)pool->BuildStatement("SELECT a FROM t");
+    EXPECT_EQ("", pool->ExecuteStatement("INSERT INTO t VALUES ('end;'); END"));
+    (void)pool->BuildStatement("SELECT b FROM t");
+    const auto begin = pool->BuildStatement("BEGIN");
+    EXPECT_TRUE(begin.statement->Step().done);
+    (void)pool->BuildStatement("SELECT c FROM t");
+    EXPECT_EQ("", pool->ExecuteStatement("SAVEPOINT s; ROLLBACK TO s"));
+    (void)pool->BuildStatement("SELECT d FROM t");
+    EXPECT_EQ("", pool->ExecuteStatement("/* done */ ROLLBACK"));
+    (void)pool->BuildStatement("SELECT e FROM t");
+
+    // Assert
+    EXPECT_EQ(
+        std::vector< std::string >({
+            "begin transaction",
+            "SELECT a FROM t",
+            "INSERT INTO t VALUES ('end;'); END",
+            "BEGIN",
+            "SELECT c FROM t",
+            "SAVEPOINT s; ROLLBACK TO s",
+            "SELECT d FROM t",
+            "/* done */ ROLLBACK",
+        }),
+        connections[0]->statements
+    );
+    EXPECT_EQ(
+        std::vector< std::string >({
+            "SELECT b FROM t",
+            "SELECT e FROM t",
+        }),
+        connections[1]->statements
+    );
+}
+
+TEST_F(ConnectionPoolTests, Reads_Use_Writer_Without_Readers) {
+    // Arrange
+    const auto pool = MakePool(0);
+
+    // Act
+    (void)pool->BuildStatement("SELECT a FROM t");
+
+    // Assert
+    EXPECT_EQ(1, connections.size());
+    EXPECT_EQ(1, connections[0]->statements.size());
+}
+
+TEST_F(ConnectionPoolTests, Only_Select_Is_Read_Only) {
+    // Arrange
+    const auto pool = MakePool(1);
+
+    // Act
+    (void)pool->BuildStatement("SELECTED");
+    (void)pool->BuildStatement("UPDATE t SET a = (SELECT b FROM u)");
+    (void)pool->BuildStatement("(SELECT a FROM t)");
+
+    // Assert
+    EXPECT_EQ(
+        std::vector< std::string >({
+            "SELECTED",
+            "UPDATE t SET a = (SELECT b FROM u)",
+        }),
+        connections[0]->statements
+    );
+    EXPECT_EQ(
+        std::vector< std::string >({
+            "(SELECT a FROM t)",
+        }),
+        connections[1]->statements
+    );
+}
@@ -0,0 +1,113 @@
+/**
+ * @file Crc32cTests.cpp
+ *
+ * This module contains unit tests of the
+ * DatabaseAbstractions::Crc32c function.
+ */
+
+#include <DatabaseAbstractions/Crc32c.hpp>
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+using namespace DatabaseAbstractions;
+
+namespace {
+
+    /**
+     * This computes the CRC-32C checksum of the given data one bit at
+     * a time, as a reference for checking the faster methods.
+     *
+     * @param[in] data
+     *     This points to the data to checksum.
+     *
+     * @param[in] size
+     *     This is the number of bytes of data to checksum.
+     *
+     * @return
+     *     The checksum of the data is returned.
+     */
+    uint32_t ReferenceCrc32c(
+        const uint8_t* data,
+        size_t size
+    ) {
+        uint32_t crc = ~0U;
+        for (size_t i = 0; i < size; ++i) {
+            crc ^= data[i];
+            for (int bit = 0; bit < 8; ++bit) {
+                crc = (crc >> 1) ^ ((crc & 1) ? 0x82F63B78 : 0);
+            }
+        }
+        return ~crc;
+    }
+
+}
+
+/**
+ * This is the test fixture for these tests, providing common
+ * setup and teardown for each test.
+ */
+struct Crc32cTests
+    : public ::testing::Test
+{
+};
+
+TEST_F(Crc32cTests, Known_Checksums) {
+    // Arrange
+    const std::string check("123456789");
+    const std::vector< uint8_t > zeros(32, 0x00);
+    const std::vector< uint8_t > ones(32, 0xFF);
+
+    // Act
+    const auto checkCrc = Crc32c(check.data(), check.size());
+    const auto zerosCrc = Crc32c(zeros.data(), zeros.size());
+    const auto onesCrc = Crc32c(ones.data(), ones.size());
+    const auto emptyCrc = Crc32c(nullptr, 0);
+
+    // Assert
+    EXPECT_EQ(0xE3069283, checkCrc);
+    EXPECT_EQ(0x8A9136AA, zerosCrc);
+    EXPECT_EQ(0x62A8AB43, onesCrc);
+    EXPECT_EQ(0x00000000, emptyCrc);
+}
+
+TEST_F(Crc32cTests, Piecewise_Checksum_Matches_Whole) {
+    // Arrange
+    std::vector< uint8_t > data(1000);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = (uint8_t)(i * 7 + 3);
+    }
+    const auto whole = Crc32c(data.data(), data.size());
+
+    // Act
+    uint32_t piecewise = 0;
+    size_t offset = 0;
+    for (size_t size = 1; offset < data.size(); ++size) {
+        const auto piece = std::min(size, data.size() - offset);
+        piecewise = Crc32c(data.data() + offset, piece, piecewise);
+        offset += piece;
+    }
+
+    // Assert
+    EXPECT_EQ(whole, piecewise);
+}
+
+TEST_F(Crc32cTests, Matches_Reference_At_Any_Alignment_And_Length) {
+    // Arrange
+    std::vector< uint8_t > data(300);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = (uint8_t)(i * 131 + (i >> 3));
+    }
+
+    for (size_t offset = 0; offset < 8; ++offset) {
+        for (size_t size = 0; offset + size <= data.size(); size += 13) {
+            // Act
+            const auto crc = Crc32c(data.data() + offset, size);
+
+            // Assert
+            EXPECT_EQ(ReferenceCrc32c(data.data() + offset, size), crc)
+                << "offset " << offset << ", size " << size
+                << ", accelerated " << IsCrc32cAccelerated();
+        }
+    }
+}
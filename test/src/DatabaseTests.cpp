@@ -0,0 +1,363 @@
+/**
+ * @file DatabaseTests.cpp
+ *
+ * This module contains unit tests of the base implementations of the
+ * optional methods of the DatabaseAbstractions::Database class.
+ */
+
+#include <DatabaseAbstractions/Database.hpp>
+#include <gtest/gtest.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace DatabaseAbstractions;
+
+namespace {
+
+    /**
+     * This is a fake prepared statement which records what's done
+     * with it in a log shared with its database.  Stepping a statement
+     * whose text contains "FAIL" reports an error.
+     */
+    struct MockStatement
+        : public PreparedStatement
+    {
+        // Properties
+
+        std::string text;
+        std::vector< std::string >* log = nullptr;
+
+        // PreparedStatement
+
+        virtual void BindParameter(
+            int index,
+            const Value& value
+        ) override {
+            log->push_back(
+                "bind " + std::to_string(index)
+                + " " + (const std::string&)value
+            );
+        }
+
+        virtual void BindParameters(std::initializer_list< const Value > values) override {
+        }
+
+        virtual Value FetchColumn(int index, Value::Type type) override {
+            return Value();
+        }
+
+        virtual void Reset() override {
+            log->push_back("reset");
+        }
+
+        virtual StepStatementResults Step() override {
+            log->push_back("step");
+            StepStatementResults results;
+            if (text.find("FAIL") != std::string::npos) {
+                results.error = "step failed";
+            } else {
+                results.done = true;
+            }
+            return results;
+        }
+    };
+
+    /**
+     * This is a fake database which only supports whole snapshots.
+     */
+    struct MockDatabase
+        : public Database
+    {
+        // Properties
+
+        Blob snapshot;
+        std::vector< Blob > installedSnapshots;
+        size_t snapshotsCreated = 0;
+        std::vector< std::string > log;
+
+        // Database
+
+        virtual BuildStatementResults BuildStatement(
+            const std::string& statement
+        ) override {
+            log.push_back("build " + statement);
+            const auto mockStatement = std::make_shared< MockStatement >();
+            mockStatement->text = statement;
+            mockStatement->log = &log;
+            BuildStatementResults results;
+            results.statement = mockStatement;
+            return results;
+        }
+
+        virtual std::string ExecuteStatement(const std::string& statement) override {
+            log.push_back("execute " + statement);
+            return "";
+        }
+
+        virtual Blob CreateSnapshot() override {
+            ++snapshotsCreated;
+            return snapshot;
+        }
+
+        virtual std::string InstallSnapshot(const Blob& blob) override {
+            installedSnapshots.push_back(blob);
+            return "";
+        }
+    };
+
+}
+
+/**
+ * This is the test fixture for these tests, providing common
+ * setup and teardown for each test.
+ */
+struct DatabaseTests
+    : public ::testing::Test
+{
+    // Properties
+
+    MockDatabase database;
+};
+
+TEST_F(DatabaseTests, Default_Snapshot_Reader_Chunks_Complete_Snapshot) {
+    // Arrange
+    database.snapshot = {1, 2, 3, 4, 5};
+    const auto reader = database.CreateSnapshotReader(2);
+    Blob snapshot;
+    Blob chunk;
+
+    // Act
+    for (;;) {
+        const auto results = reader->ReadChunk(chunk);
+        ASSERT_TRUE(results.error.empty());
+        if (results.done) {
+            break;
+        }
+        EXPECT_LE(chunk.size(), (size_t)2);
+        snapshot.insert(snapshot.end(), chunk.begin(), chunk.end());
+    }
+
+    // Assert
+    EXPECT_EQ(database.snapshot, snapshot);
+    EXPECT_EQ((size_t)1, database.snapshotsCreated);
+}
+
+TEST_F(DatabaseTests, Default_Captured_Snapshot_Created_Up_Front) {
+    // Arrange
+    database.snapshot = {1, 2, 3, 4, 5};
+
+    // Act
+    const auto reader = database.CaptureSnapshot(2);
+    database.snapshot = {6, 7};
+    Blob snapshot;
+    Blob chunk;
+    for (;;) {
+        const auto results = reader->ReadChunk(chunk);
+        ASSERT_TRUE(results.error.empty());
+        if (results.done) {
+            break;
+        }
+        snapshot.insert(snapshot.end(), chunk.begin(), chunk.end());
+    }
+
+    // Assert
+    EXPECT_EQ((Blob{1, 2, 3, 4, 5}), snapshot);
+    EXPECT_EQ((size_t)1, database.snapshotsCreated);
+}
+
+TEST_F(DatabaseTests, Default_Snapshot_Writer_Installs_On_Finish) {
+    // Arrange
+    const auto writer = database.CreateSnapshotWriter();
+
+    // Act
+    EXPECT_EQ("", writer->WriteChunk(Blob({1, 2})));
+    EXPECT_EQ("", writer->WriteChunk(Blob({3})));
+    const auto installedBeforeFinish = database.installedSnapshots.size();
+    EXPECT_EQ("", writer->Finish());
+
+    // Assert
+    EXPECT_EQ((size_t)0, installedBeforeFinish);
+    EXPECT_EQ(
+        std::vector< Blob >({
+            {1, 2, 3},
+        }),
+        database.installedSnapshots
+    );
+}
+
+TEST_F(DatabaseTests, Default_Delta_Snapshot_Is_Full) {
+    // Arrange
+    database.snapshot = {1, 2, 3};
+
+    // Act
+    const auto snapshot = database.CreateDeltaSnapshot(42);
+
+    // Assert
+    EXPECT_TRUE(snapshot.full);
+    EXPECT_TRUE(snapshot.error.empty());
+    EXPECT_EQ((uint64_t)0, snapshot.id);
+    EXPECT_EQ(database.snapshot, snapshot.blob);
+}
+
+TEST_F(DatabaseTests, Default_Install_Delta_Snapshot_Installs_Full_Snapshot) {
+    // Arrange
+    DeltaSnapshot snapshot;
+    snapshot.blob = {1, 2, 3};
+
+    // Act
+    const auto error = database.InstallDeltaSnapshot(snapshot);
+
+    // Assert
+    EXPECT_EQ("", error);
+    EXPECT_EQ(
+        std::vector< Blob >({
+            {1, 2, 3},
+        }),
+        database.installedSnapshots
+    );
+}
+
+TEST_F(DatabaseTests, Default_Install_Delta_Snapshot_Rejects_Delta) {
+    // Arrange
+    DeltaSnapshot snapshot;
+    snapshot.full = false;
+    snapshot.baseId = 1;
+    snapshot.id = 2;
+    snapshot.blob = {1, 2, 3};
+
+    // Act
+    const auto error = database.InstallDeltaSnapshot(snapshot);
+
+    // Assert
+    EXPECT_NE("", error);
+    EXPECT_TRUE(database.installedSnapshots.empty());
+}
+
+TEST_F(DatabaseTests, Default_Transaction_Methods_Execute_Statements) {
+    // Arrange
+
+    // Act
+    EXPECT_EQ("", database.BeginTransaction());
+    EXPECT_EQ("", database.CommitTransaction());
+    EXPECT_EQ("", database.RollbackTransaction());
+
+    // Assert
+    EXPECT_EQ(
+        std::vector< std::string >({
+            "execute BEGIN",
+            "execute COMMIT",
+            "execute ROLLBACK",
+        }),
+        database.log
+    );
+}
+
+TEST_F(DatabaseTests, Default_Apply_Write_Batch_Reuses_Repeated_Statements) {
+    // Arrange
+    WriteBatch batch;
+    batch.Add("INSERT A", {"1"});
+    batch.Add("INSERT A", {"2"});
+    batch.Add("INSERT B");
+
+    // Act
+    const auto error = database.ApplyWriteBatch(batch);
+
+    // Assert
+    EXPECT_EQ("", error);
+    EXPECT_EQ(
+        std::vector< std::string >({
+            "execute BEGIN",
+            "build INSERT A",
+            "bind 1 1",
+            "step",
+            "reset",
+            "bind 1 2",
+            "step",
+            "build INSERT B",
+            "step",
+            "execute COMMIT",
+        }),
+        database.log
+    );
+}
+
+TEST_F(DatabaseTests, Default_Apply_Write_Batch_Rolls_Back_On_Error) {
+    // Arrange
+    WriteBatch batch;
+    batch.Add("INSERT A");
+    batch.Add("FAIL");
+    batch.Add("INSERT B");
+
+    // Act
+    const auto error = database.ApplyWriteBatch(batch);
+
+    // Assert
+    EXPECT_EQ("step failed", error);
+    EXPECT_EQ(
+        std::vector< std::string >({
+            "execute BEGIN",
+            "build INSERT A",
+            "step",
+            "build FAIL",
+            "step",
+            "execute ROLLBACK",
+        }),
+        database.log
+    );
+}
+
+TEST_F(DatabaseTests, Default_Async_Methods_Complete_Before_Returning) {
+    // Arrange
+    WriteBatch batch;
+    batch.Add("INSERT A");
+    std::vector< std::string > completions;
+
+    // Act
+    database.ExecuteAsync(
+        "DELETE A",
+        [&](const std::string& error){
+            completions.push_back("execute " + error);
+        }
+    );
+    database.ApplyWriteBatchAsync(
+        std::move(batch),
+        [&](const std::string& error){
+            completions.push_back("batch " + error);
+        }
+    );
+    database.BuildStatementAsync(
+        "SELECT A",
+        [&](const BuildStatementResults& results){
+            completions.push_back("build " + results.error);
+            results.statement->StepAsync(
+                [&](const StepStatementResults& results){
+                    completions.push_back(results.done ? "step done" : "step");
+                }
+            );
+        }
+    );
+
+    // Assert
+    EXPECT_EQ(
+        std::vector< std::string >({
+            "execute ",
+            "batch ",
+            "build ",
+            "step done",
+        }),
+        completions
+    );
+    EXPECT_EQ(
+        std::vector< std::string >({
+            "execute DELETE A",
+            "execute BEGIN",
+            "build INSERT A",
+            "step",
+            "execute COMMIT",
+            "build SELECT A",
+            "step",
+        }),
+        database.log
+    );
+}
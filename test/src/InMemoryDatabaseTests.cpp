@@ -0,0 +1,1012 @@
+/**
+ * @file InMemoryDatabaseTests.cpp
+ *
+ * This module contains unit tests of the
+ * DatabaseAbstractions::InMemoryDatabase class.
+ */
+
+#include <algorithm>
+#include <DatabaseAbstractions/InMemoryDatabase.hpp>
+#include <DatabaseAbstractions/Transaction.hpp>
+#include <DatabaseAbstractions/ValueEncoding.hpp>
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+using namespace DatabaseAbstractions;
+
+/**
+ * This is the test fixture for these tests, providing common
+ * setup and teardown for each test.
+ */
+struct InMemoryDatabaseTests
+    : public ::testing::Test
+{
+    // Properties
+
+    InMemoryDatabase database;
+
+    // Methods
+
+    /**
+     * This runs the given query and returns the values of the first
+     * column of every row of the results, as text.
+     *
+     * @param[in] query
+     *     This is the query to run.
+     *
+     * @return
+     *     The values of the first column of the results are returned.
+     */
+    std::vector< std::string > Column(const std::string& query) {
+        std::vector< std::string > values;
+        const auto built = database.BuildStatement(query);
+        EXPECT_EQ("", built.error);
+        if (built.statement == nullptr) {
+            return values;
+        }
+        for (;;) {
+            const auto results = built.statement->Step();
+            EXPECT_EQ("", results.error);
+            if (
+                results.done
+                || !results.error.empty()
+            ) {
+                break;
+            }
+            const auto value = built.statement->FetchColumn(0, Value::Type::Text);
+            values.push_back(
+                (value.GetType() == Value::Type::Null)
+                ? "NULL"
+                : (const std::string&)value
+            );
+        }
+        return values;
+    }
+
+    /**
+     * This builds a snapshot by hand, holding one table with one column.
+     * The table claims to have the given number of row slots, of which
+     * all but the given free rows are claimed to be live, but only the
+     * given live rows are actually included, holding 42, 43, and so on.
+     *
+     * @param[in] columnType
+     *     This is the number to store as the type of the column.
+     *
+     * @param[in] slotCount
+     *     This is the number of row slots to claim the table has.
+     *
+     * @param[in] freeRows
+     *     These are the rows to list as free.
+     *
+     * @param[in] liveRows
+     *     These are the rows to include.
+     *
+     * @return
+     *     The snapshot is returned.
+     */
+    Blob ForgeSnapshot(
+        intmax_t columnType,
+        uint64_t slotCount,
+        const std::vector< uint64_t >& freeRows = {},
+        const std::vector< uint64_t >& liveRows = {0}
+    ) {
+        Blob snapshot{'I', 'M', 'D', 'B', 1, 1, 1};
+        const auto varint = [&snapshot](uint64_t value){
+            while (value >= 0x80) {
+                snapshot.push_back((uint8_t)(value | 0x80));
+                value >>= 7;
+            }
+            snapshot.push_back((uint8_t)value);
+        };
+        snapshot.insert(snapshot.end(), {1, 't', 1, 1, 'c'});
+        EncodeValue(Value(columnType), snapshot);
+        snapshot.push_back(0);
+        EncodeValue(Value(), snapshot);
+        varint(0);
+        varint(slotCount);
+        varint(freeRows.size());
+        for (const auto row: freeRows) {
+            varint(row);
+        }
+        varint(slotCount - freeRows.size());
+        for (size_t i = 0; i < liveRows.size(); ++i) {
+            varint(liveRows[i]);
+            EncodeValue(Value(42 + (int)i), snapshot);
+        }
+        return snapshot;
+    }
+
+    // ::testing::Test
+
+    virtual void SetUp() override {
+        ASSERT_EQ(
+            "",
+            database.ExecuteStatement(
+                "CREATE TABLE people ("
+                "  id INTEGER PRIMARY KEY,"
+                "  name TEXT NOT NULL UNIQUE,"
+                "  age INTEGER,"
+                "  photo BLOB"
+                ");"
+                "CREATE INDEX people_age ON people (age);"
+                "INSERT INTO people (name, age) VALUES ('alice', 30), ('bob', 25), ('carol', 35);"
+            )
+        );
+    }
+};
+
+TEST_F(InMemoryDatabaseTests, Select_Rows_Inserted) {
+    // Arrange
+    const auto built = database.BuildStatement("SELECT id, name, age FROM people WHERE name = ?");
+    ASSERT_EQ("", built.error);
+    const auto statement = built.statement;
+    statement->BindParameter(1, "bob");
+
+    // Act
+    const auto first = statement->Step();
+    const auto id = statement->FetchColumn(0, Value::Type::Integer);
+    const auto name = statement->FetchColumn(1, Value::Type::Text);
+    const auto age = statement->FetchColumn(2, Value::Type::Integer);
+    const auto second = statement->Step();
+
+    // Assert
+    EXPECT_EQ("", first.error);
+    EXPECT_FALSE(first.done);
+    EXPECT_EQ(Value(2), id);
+    EXPECT_EQ(Value("bob"), name);
+    EXPECT_EQ(Value(25), age);
+    EXPECT_TRUE(second.done);
+}
+
+TEST_F(InMemoryDatabaseTests, Where_Range_Uses_Ordered_Index) {
+    // Arrange
+
+    // Act
+    const auto names = Column("SELECT name FROM people WHERE age >= 26 AND age < 35");
+
+    // Assert
+    EXPECT_EQ(std::vector< std::string >({"alice"}), names);
+}
+
+TEST_F(InMemoryDatabaseTests, Where_Without_Index_Scans_Rows) {
+    // Arrange
+
+    // Act
+    const auto names = Column("SELECT name FROM people WHERE name <> 'bob' ORDER BY name DESC");
+
+    // Assert
+    EXPECT_EQ(std::vector< std::string >({"carol", "alice"}), names);
+}
+
+TEST_F(InMemoryDatabaseTests, Order_By_And_Limit) {
+    // Arrange
+
+    // Act
+    const auto names = Column("SELECT name FROM people ORDER BY age LIMIT 2");
+
+    // Assert
+    EXPECT_EQ(std::vector< std::string >({"bob", "alice"}), names);
+}
+
+TEST_F(InMemoryDatabaseTests, Count_Rows) {
+    // Arrange
+
+    // Act
+    const auto count = Column("SELECT COUNT(*) FROM people WHERE age > 26");
+
+    // Assert
+    EXPECT_EQ(std::vector< std::string >({"2"}), count);
+}
+
+TEST_F(InMemoryDatabaseTests, Update_And_Delete) {
+    // Arrange
+
+    // Act
+    const auto updateError = database.ExecuteStatement("UPDATE people SET age = 40 WHERE name = 'alice'");
+    const auto deleteError = database.ExecuteStatement("DELETE FROM people WHERE age < 30");
+
+    // Assert
+    EXPECT_EQ("", updateError);
+    EXPECT_EQ("", deleteError);
+    EXPECT_EQ(
+        std::vector< std::string >({"carol", "alice"}),
+        Column("SELECT name FROM people ORDER BY age")
+    );
+    EXPECT_EQ(
+        std::vector< std::string >({"alice"}),
+        Column("SELECT name FROM people WHERE age = 40")
+    );
+}
+
+TEST_F(InMemoryDatabaseTests, Failed_Statement_Changes_Nothing) {
+    // Arrange
+    const auto id = database.GetSnapshotId();
+
+    // Act
+    const auto error = database.ExecuteStatement(
+        "INSERT INTO people (name, age) VALUES ('dave', 40), ('alice', 50)"
+    );
+
+    // Assert
+    EXPECT_EQ("UNIQUE constraint failed: people.name", error);
+    EXPECT_EQ(
+        std::vector< std::string >({"3"}),
+        Column("SELECT COUNT(*) FROM people")
+    );
+    EXPECT_EQ(id, database.GetSnapshotId());
+}
+
+TEST_F(InMemoryDatabaseTests, Insert_Or_Replace_Replaces_Conflicting_Row) {
+    // Arrange
+
+    // Act
+    const auto error = database.ExecuteStatement(
+        "INSERT OR REPLACE INTO people (id, name, age) VALUES (2, 'bobby', 26)"
+    );
+
+    // Assert
+    EXPECT_EQ("", error);
+    EXPECT_EQ(
+        std::vector< std::string >({"alice", "bobby", "carol"}),
+        Column("SELECT name FROM people ORDER BY id")
+    );
+}
+
+TEST_F(InMemoryDatabaseTests, Automatic_Key_Follows_Largest_Key_Exactly) {
+    // Arrange
+    ASSERT_EQ(
+        "",
+        database.ExecuteStatement(
+            "INSERT INTO people (id, name) VALUES (9007199254740993, 'dave')"
+        )
+    );
+
+    // Act
+    const auto error = database.ExecuteStatement(
+        "INSERT INTO people (name) VALUES ('erin')"
+    );
+
+    // Assert
+    EXPECT_EQ("", error);
+    EXPECT_EQ(
+        std::vector< std::string >({"9007199254740994"}),
+        Column("SELECT id FROM people WHERE name = 'erin'")
+    );
+}
+
+TEST_F(InMemoryDatabaseTests, Automatic_Key_Past_Largest_Integer_Is_Refused) {
+    // Arrange
+    ASSERT_EQ(
+        "",
+        database.ExecuteStatement(
+            "INSERT INTO people (id, name) VALUES (9223372036854775807, 'dave')"
+        )
+    );
+
+    // Act
+    const auto error = database.ExecuteStatement(
+        "INSERT INTO people (name) VALUES ('erin')"
+    );
+
+    // Assert
+    EXPECT_EQ("database or disk is full", error);
+    EXPECT_EQ(
+        std::vector< std::string >({"alice", "bob", "carol", "dave"}),
+        Column("SELECT name FROM people ORDER BY id")
+    );
+}
+
+TEST_F(InMemoryDatabaseTests, Not_Null_Constraint) {
+    // Arrange
+
+    // Act
+    const auto error = database.ExecuteStatement("INSERT INTO people (age) VALUES (1)");
+
+    // Assert
+    EXPECT_EQ("NOT NULL constraint failed: people.name", error);
+}
+
+TEST_F(InMemoryDatabaseTests, Errors_Are_Reported) {
+    // Arrange
+
+    // Act
+    const auto noTable = database.BuildStatement("SELECT * FROM nobody");
+    const auto step = noTable.statement->Step();
+    const auto noColumn = database.ExecuteStatement("UPDATE people SET height = 1");
+    const auto syntax = database.BuildStatement("SELEKT * FROM people");
+
+    // Assert
+    EXPECT_EQ("no such table: nobody", step.error);
+    EXPECT_EQ("no such column: height", noColumn);
+    EXPECT_FALSE(syntax.error.empty());
+}
+
+TEST_F(InMemoryDatabaseTests, Parameter_Index_Limits) {
+    // Arrange
+
+    // Act
+    const auto largest = database.BuildStatement("SELECT name FROM people WHERE id = ?32766");
+    const auto tooLarge = database.BuildStatement("SELECT name FROM people WHERE id = ?32767");
+    const auto overflow = database.BuildStatement("SELECT name FROM people WHERE id = ?4294967297");
+    const auto zero = database.BuildStatement("SELECT name FROM people WHERE id = ?0");
+
+    // Assert
+    EXPECT_EQ("", largest.error);
+    EXPECT_EQ("variable number must be between ?1 and ?32766", tooLarge.error);
+    EXPECT_EQ("variable number must be between ?1 and ?32766", overflow.error);
+    EXPECT_EQ("variable number must be between ?1 and ?32766", zero.error);
+}
+
+TEST_F(InMemoryDatabaseTests, Fetched_Blob_Is_Borrowed) {
+    // Arrange
+    const Blob photo({1, 2, 3});
+    const auto insert = database.BuildStatement("UPDATE people SET photo = ? WHERE id = 1").statement;
+    insert->BindParameter(1, photo);
+    ASSERT_EQ("", insert->Step().error);
+    const auto select = database.BuildStatement("SELECT photo FROM people WHERE id = 1").statement;
+    ASSERT_FALSE(select->Step().done);
+
+    // Act
+    const auto value = select->FetchColumn(0, Value::Type::Blob);
+
+    // Assert
+    EXPECT_TRUE(value.IsBorrowed());
+    const BlobView view(value);
+    EXPECT_EQ(photo, Blob(view.data, view.data + view.size));
+}
+
+TEST_F(InMemoryDatabaseTests, Fetch_Column_Into_Value_Reuses_Capacity) {
+    // Arrange
+    const std::string longName(100, 'x');
+    const auto insert = database.BuildStatement("INSERT INTO people (name, age) VALUES (?, ?)").statement;
+    insert->BindParameters({longName, 40});
+    ASSERT_EQ("", insert->Step().error);
+    const auto select = database.BuildStatement("SELECT name, age FROM people ORDER BY id").statement;
+    Value name(std::string(200, 'y'));
+    const auto data = ((const std::string&)name).data();
+    std::vector< std::string > names;
+    std::vector< Value > ages;
+
+    // Act
+    while (!select->Step().done) {
+        select->FetchColumn(0, Value::Type::Text, name);
+        EXPECT_EQ(data, ((const std::string&)name).data());
+        names.push_back(name);
+        Value age;
+        select->FetchColumn(1, Value::Type::Text, age);
+        ages.push_back(age);
+    }
+
+    // Assert
+    EXPECT_EQ(
+        std::vector< std::string >({"alice", "bob", "carol", longName}),
+        names
+    );
+    EXPECT_EQ(
+        std::vector< Value >({Value("30"), Value("25"), Value("35"), Value("40")}),
+        ages
+    );
+}
+
+TEST_F(InMemoryDatabaseTests, Bind_Moved_Parameters) {
+    // Arrange
+    const std::string longName(100, 'x');
+    Value name(longName);
+    std::vector< Value > values{Value(std::string(100, 'z')), Value(50)};
+    const auto insert = database.BuildStatement("INSERT INTO people (name, age) VALUES (?, ?)").statement;
+
+    // Act
+    insert->BindParameter(1, std::move(name));
+    insert->BindParameter(2, Value(45));
+    const auto firstError = insert->Step().error;
+    insert->Reset();
+    insert->BindParameters(std::move(values));
+    const auto secondError = insert->Step().error;
+
+    // Assert
+    EXPECT_EQ("", firstError);
+    EXPECT_EQ("", secondError);
+    EXPECT_EQ(
+        std::vector< std::string >({longName, std::string(100, 'z')}),
+        Column("SELECT name FROM people WHERE age >= 45 ORDER BY age")
+    );
+}
+
+TEST_F(InMemoryDatabaseTests, Step_Batch_Copies_Into_Arena) {
+    // Arrange
+    const auto select = database.BuildStatement("SELECT name, age, id FROM people ORDER BY id").statement;
+    RowBatch batch({Value::Type::Text, Value::Type::Integer, Value::Type::Text});
+
+    // Act
+    const auto results = select->StepBatch(10, batch);
+
+    // Assert
+    EXPECT_TRUE(results.done);
+    ASSERT_EQ((size_t)3, batch.GetRowCount());
+    EXPECT_EQ(Value("alice"), batch.GetValue(0, 0));
+    EXPECT_TRUE(batch.GetValue(0, 0).IsInArena());
+    EXPECT_EQ(Value(25), batch.GetValue(1, 1));
+    EXPECT_EQ(Value("3"), batch.GetValue(2, 2));
+    EXPECT_NE((size_t)0, batch.GetArena().GetBytesUsed());
+}
+
+TEST_F(InMemoryDatabaseTests, Snapshot_Round_Trip) {
+    // Arrange
+    const auto snapshot = database.CreateSnapshot();
+    InMemoryDatabase copy;
+
+    // Act
+    const auto error = copy.InstallSnapshot(snapshot);
+
+    // Assert
+    EXPECT_EQ("", error);
+    EXPECT_EQ(database.GetSnapshotId(), copy.GetSnapshotId());
+    EXPECT_EQ(snapshot, copy.CreateSnapshot());
+    EXPECT_EQ("UNIQUE constraint failed: people.name", copy.ExecuteStatement("INSERT INTO people (name) VALUES ('bob')"));
+}
+
+TEST_F(InMemoryDatabaseTests, Forged_Snapshot_Accepted_When_Valid) {
+    // Arrange
+    const auto snapshot = ForgeSnapshot((intmax_t)Value::Type::Integer, 1);
+
+    // Act
+    const auto error = database.InstallSnapshot(snapshot);
+
+    // Assert
+    EXPECT_EQ("", error);
+    EXPECT_EQ(std::vector< std::string >({"42"}), Column("SELECT c FROM t"));
+}
+
+TEST_F(InMemoryDatabaseTests, Snapshot_With_Unknown_Column_Type_Is_Rejected) {
+    // Arrange
+    const auto snapshot = ForgeSnapshot(99, 1);
+
+    // Act
+    const auto error = database.InstallSnapshot(snapshot);
+
+    // Assert
+    EXPECT_EQ("invalid snapshot", error);
+    EXPECT_EQ(
+        std::vector< std::string >({"alice", "bob", "carol"}),
+        Column("SELECT name FROM people ORDER BY id")
+    );
+}
+
+TEST_F(InMemoryDatabaseTests, Snapshot_With_Impossible_Row_Count_Is_Rejected) {
+    // Arrange
+    const auto snapshot = ForgeSnapshot((intmax_t)Value::Type::Integer, (uint64_t)1 << 40);
+
+    // Act
+    const auto error = database.InstallSnapshot(snapshot);
+
+    // Assert
+    EXPECT_EQ("invalid snapshot", error);
+    EXPECT_EQ(
+        std::vector< std::string >({"alice", "bob", "carol"}),
+        Column("SELECT name FROM people ORDER BY id")
+    );
+}
+
+TEST_F(InMemoryDatabaseTests, Forged_Snapshot_With_Free_Row_Accepted_When_Valid) {
+    // Arrange
+    const auto snapshot = ForgeSnapshot((intmax_t)Value::Type::Integer, 3, {1}, {0, 2});
+    ASSERT_EQ("", database.InstallSnapshot(snapshot));
+
+    // Act
+    const auto error = database.ExecuteStatement("INSERT INTO t VALUES (10)");
+
+    // Assert
+    EXPECT_EQ("", error);
+    EXPECT_EQ(
+        std::vector< std::string >({"10", "42", "43"}),
+        Column("SELECT c FROM t ORDER BY c")
+    );
+}
+
+TEST_F(InMemoryDatabaseTests, Snapshot_With_Free_Row_In_Use_Is_Rejected) {
+    // Arrange
+    const auto snapshot = ForgeSnapshot((intmax_t)Value::Type::Integer, 3, {0}, {0, 2});
+
+    // Act
+    const auto error = database.InstallSnapshot(snapshot);
+
+    // Assert
+    EXPECT_EQ("invalid snapshot", error);
+    EXPECT_EQ(
+        std::vector< std::string >({"alice", "bob", "carol"}),
+        Column("SELECT name FROM people ORDER BY id")
+    );
+}
+
+TEST_F(InMemoryDatabaseTests, Snapshot_With_Duplicate_Free_Row_Is_Rejected) {
+    // Arrange
+    const auto snapshot = ForgeSnapshot((intmax_t)Value::Type::Integer, 3, {1, 1}, {0});
+
+    // Act
+    const auto error = database.InstallSnapshot(snapshot);
+
+    // Assert
+    EXPECT_EQ("invalid snapshot", error);
+}
+
+TEST_F(InMemoryDatabaseTests, Snapshot_With_Mostly_Free_Rows_Is_Accepted) {
+    // Arrange
+    std::vector< uint64_t > freeRows;
+    for (uint64_t row = 1; row < 100000; ++row) {
+        freeRows.push_back(row);
+    }
+    const auto snapshot = ForgeSnapshot((intmax_t)Value::Type::Integer, 100000, freeRows, {0});
+
+    // Act
+    const auto error = database.InstallSnapshot(snapshot);
+    const auto insertError = database.ExecuteStatement("INSERT INTO t VALUES (10)");
+
+    // Assert
+    EXPECT_EQ("", error);
+    EXPECT_EQ("", insertError);
+    EXPECT_EQ(
+        std::vector< std::string >({"10", "42"}),
+        Column("SELECT c FROM t ORDER BY c")
+    );
+}
+
+TEST_F(InMemoryDatabaseTests, Snapshot_Reader_Produces_Same_Snapshot_In_Chunks) {
+    // Arrange
+    for (int i = 0; i < 500; ++i) {
+        const auto insert = database.BuildStatement("INSERT INTO people (name, age) VALUES (?, ?)").statement;
+        insert->BindParameters({"person" + std::to_string(i), i});
+        ASSERT_EQ("", insert->Step().error);
+    }
+    const auto reader = database.CreateSnapshotReader(100);
+    Blob snapshot;
+    Blob chunk;
+
+    // Act
+    for (;;) {
+        const auto results = reader->ReadChunk(chunk);
+        ASSERT_EQ("", results.error);
+        if (results.done) {
+            break;
+        }
+        EXPECT_LE(chunk.size(), (size_t)100);
+        snapshot.insert(snapshot.end(), chunk.begin(), chunk.end());
+    }
+
+    // Assert
+    EXPECT_EQ(database.CreateSnapshot(), snapshot);
+}
+
+TEST_F(InMemoryDatabaseTests, Snapshot_Writer_Installs_Small_Chunks) {
+    // Arrange
+    for (int i = 0; i < 500; ++i) {
+        const auto insert = database.BuildStatement("INSERT INTO people (name, age) VALUES (?, ?)").statement;
+        insert->BindParameters({"person" + std::to_string(i), i});
+        ASSERT_EQ("", insert->Step().error);
+    }
+    const auto snapshot = database.CreateSnapshot();
+    InMemoryDatabase copy;
+    const auto writer = copy.CreateSnapshotWriter();
+
+    // Act
+    for (size_t offset = 0; offset < snapshot.size(); offset += 7) {
+        const auto size = std::min((size_t)7, snapshot.size() - offset);
+        ASSERT_EQ("", writer->WriteChunk(BlobView(snapshot.data() + offset, size)));
+    }
+    const auto error = writer->Finish();
+
+    // Assert
+    EXPECT_EQ("", error);
+    EXPECT_EQ(database.GetSnapshotId(), copy.GetSnapshotId());
+    EXPECT_EQ(snapshot, copy.CreateSnapshot());
+}
+
+TEST_F(InMemoryDatabaseTests, Snapshot_Writer_Decodes_Chunks_As_They_Arrive) {
+    // Arrange
+    for (int i = 0; i < 500; ++i) {
+        const auto insert = database.BuildStatement("INSERT INTO people (name, age) VALUES (?, ?)").statement;
+        insert->BindParameters({"person" + std::to_string(i), i});
+        ASSERT_EQ("", insert->Step().error);
+    }
+    auto snapshot = database.CreateSnapshot();
+    const std::string name = "person250";
+    const auto namePosition = std::search(
+        snapshot.begin(),
+        snapshot.end(),
+        name.begin(),
+        name.end()
+    ) - snapshot.begin();
+    ASSERT_LT((size_t)namePosition, snapshot.size());
+    const auto tagPosition = (size_t)namePosition - 2;
+    snapshot[tagPosition] = 0xFF;
+    InMemoryDatabase copy;
+    const auto writer = copy.CreateSnapshotWriter();
+
+    // Act
+    size_t offset = 0;
+    std::string error;
+    while (
+        (offset < snapshot.size())
+        && error.empty()
+    ) {
+        const auto size = std::min((size_t)16, snapshot.size() - offset);
+        error = writer->WriteChunk(BlobView(snapshot.data() + offset, size));
+        offset += size;
+    }
+
+    // Assert
+    EXPECT_EQ("invalid snapshot", error);
+    EXPECT_LE(offset, tagPosition + 16);
+    EXPECT_EQ("invalid snapshot", writer->Finish());
+    EXPECT_EQ((uint64_t)0, copy.GetSnapshotId());
+}
+
+TEST_F(InMemoryDatabaseTests, Snapshot_Reader_Fails_If_Database_Changes) {
+    // Arrange
+    const auto reader = database.CreateSnapshotReader(4);
+    Blob chunk;
+    ASSERT_EQ("", reader->ReadChunk(chunk).error);
+
+    // Act
+    ASSERT_EQ("", database.ExecuteStatement("DELETE FROM people"));
+    const auto results = reader->ReadChunk(chunk);
+
+    // Assert
+    EXPECT_EQ("database changed while snapshot was being read", results.error);
+}
+
+TEST_F(InMemoryDatabaseTests, Captured_Snapshot_Unaffected_By_Later_Changes) {
+    // Arrange
+    const auto expected = database.CreateSnapshot();
+    const auto reader = database.CaptureSnapshot(16);
+    Blob snapshot;
+    Blob chunk;
+    ASSERT_EQ("", reader->ReadChunk(chunk).error);
+    snapshot.insert(snapshot.end(), chunk.begin(), chunk.end());
+
+    // Act
+    ASSERT_EQ(
+        "",
+        database.ExecuteStatement(
+            "UPDATE people SET age = 99 WHERE name = 'alice';"
+            "DELETE FROM people WHERE name = 'bob';"
+            "INSERT INTO people (name, age) VALUES ('dave', 40);"
+            "CREATE TABLE pets (name TEXT);"
+        )
+    );
+    for (;;) {
+        const auto results = reader->ReadChunk(chunk);
+        ASSERT_EQ("", results.error);
+        if (results.done) {
+            break;
+        }
+        snapshot.insert(snapshot.end(), chunk.begin(), chunk.end());
+    }
+
+    // Assert
+    EXPECT_EQ(expected, snapshot);
+    EXPECT_EQ(
+        (std::vector< std::string >{"99", "35", "40"}),
+        Column("SELECT age FROM people ORDER BY id")
+    );
+}
+
+TEST_F(InMemoryDatabaseTests, Captured_Snapshot_Outlives_Database) {
+    // Arrange
+    std::shared_ptr< SnapshotReader > reader;
+    Blob expected;
+    {
+        InMemoryDatabase other;
+        ASSERT_EQ("", other.InstallSnapshot(database.CreateSnapshot()));
+        expected = other.CreateSnapshot();
+        reader = other.CaptureSnapshot(65536);
+    }
+    Blob snapshot;
+    Blob chunk;
+
+    // Act
+    for (;;) {
+        const auto results = reader->ReadChunk(chunk);
+        ASSERT_EQ("", results.error);
+        if (results.done) {
+            break;
+        }
+        snapshot.insert(snapshot.end(), chunk.begin(), chunk.end());
+    }
+
+    // Assert
+    EXPECT_EQ(expected, snapshot);
+}
+
+TEST_F(InMemoryDatabaseTests, Rollback_After_Capture_Keeps_Committed_State) {
+    // Arrange
+    const auto expected = database.CreateSnapshot();
+    ASSERT_EQ("", database.BeginTransaction());
+    ASSERT_EQ("", database.ExecuteStatement("DELETE FROM people"));
+    const auto reader = database.CaptureSnapshot(65536);
+
+    // Act
+    ASSERT_EQ("", database.RollbackTransaction());
+    Blob snapshot;
+    Blob chunk;
+    for (;;) {
+        const auto results = reader->ReadChunk(chunk);
+        ASSERT_EQ("", results.error);
+        if (results.done) {
+            break;
+        }
+        snapshot.insert(snapshot.end(), chunk.begin(), chunk.end());
+    }
+
+    // Assert
+    EXPECT_EQ(expected, snapshot);
+    EXPECT_EQ(expected, database.CreateSnapshot());
+    EXPECT_EQ(
+        (std::vector< std::string >{"alice", "bob", "carol"}),
+        Column("SELECT name FROM people ORDER BY id")
+    );
+}
+
+TEST_F(InMemoryDatabaseTests, Snapshot_Excludes_Open_Transaction) {
+    // Arrange
+    const auto expected = database.CreateSnapshot();
+    const auto id = database.GetSnapshotId();
+    Transaction transaction(database);
+    ASSERT_EQ(
+        "",
+        database.ExecuteStatement(
+            "INSERT INTO people (name, age) VALUES ('dave', 40);"
+            "UPDATE people SET age = 99 WHERE name = 'alice';"
+            "DELETE FROM people WHERE name = 'bob';"
+            "DROP INDEX people_age;"
+            "CREATE TABLE pets (name TEXT);"
+            "INSERT INTO pets VALUES ('rex');"
+        )
+    );
+
+    // Act
+    const auto snapshot = database.CreateSnapshot();
+    const auto reader = database.CaptureSnapshot(65536);
+    Blob captured;
+    Blob chunk;
+    for (;;) {
+        const auto results = reader->ReadChunk(chunk);
+        ASSERT_EQ("", results.error);
+        if (results.done) {
+            break;
+        }
+        captured.insert(captured.end(), chunk.begin(), chunk.end());
+    }
+    InMemoryDatabase follower;
+    ASSERT_EQ("", follower.InstallSnapshot(snapshot));
+
+    // Assert
+    EXPECT_EQ(expected, snapshot);
+    EXPECT_EQ(expected, captured);
+    EXPECT_EQ(id, follower.GetSnapshotId());
+    EXPECT_EQ(expected, follower.CreateSnapshot());
+    EXPECT_EQ(
+        (std::vector< std::string >{"dave"}),
+        Column("SELECT name FROM people WHERE name = 'dave'")
+    );
+}
+
+TEST_F(InMemoryDatabaseTests, Snapshot_Excludes_Dropped_And_Refilled_Table_In_Transaction) {
+    // Arrange
+    const auto expected = database.CreateSnapshot();
+    Transaction transaction(database);
+    ASSERT_EQ(
+        "",
+        database.ExecuteStatement(
+            "DELETE FROM people WHERE name = 'carol';"
+            "DROP TABLE people;"
+            "CREATE TABLE people (name TEXT);"
+            "INSERT INTO people VALUES ('zed');"
+        )
+    );
+
+    // Act
+    const auto snapshot = database.CreateSnapshot();
+
+    // Assert
+    EXPECT_EQ(expected, snapshot);
+    EXPECT_EQ(
+        (std::vector< std::string >{"zed"}),
+        Column("SELECT name FROM people")
+    );
+}
+
+TEST_F(InMemoryDatabaseTests, Delta_Snapshot_Brings_Follower_Up_To_Date) {
+    // Arrange
+    InMemoryDatabase follower;
+    ASSERT_EQ("", follower.InstallSnapshot(database.CreateSnapshot()));
+    const auto baseId = follower.GetSnapshotId();
+    ASSERT_EQ(
+        "",
+        database.ExecuteStatement(
+            "INSERT OR REPLACE INTO people (id, name, age) VALUES (2, 'bobby', 26);"
+            "DELETE FROM people WHERE name = 'carol';"
+            "INSERT INTO people (name) VALUES ('dave');"
+            "CREATE TABLE pets (name TEXT PRIMARY KEY, owner INTEGER);"
+            "INSERT INTO pets VALUES ('rex', 4)"
+        )
+    );
+
+    // Act
+    const auto delta = database.CreateDeltaSnapshot(baseId);
+    const auto error = follower.InstallDeltaSnapshot(delta);
+
+    // Assert
+    EXPECT_FALSE(delta.full);
+    EXPECT_EQ(baseId, delta.baseId);
+    EXPECT_EQ(database.GetSnapshotId(), delta.id);
+    EXPECT_EQ("", error);
+    EXPECT_EQ(database.GetSnapshotId(), follower.GetSnapshotId());
+    EXPECT_EQ(database.CreateSnapshot(), follower.CreateSnapshot());
+}
+
+TEST_F(InMemoryDatabaseTests, Delta_Snapshot_Falls_Back_To_Full_When_Log_Trimmed) {
+    // Arrange
+    InMemoryDatabase leader(2);
+    ASSERT_EQ("", leader.ExecuteStatement("CREATE TABLE t (x INTEGER)"));
+    const auto baseId = leader.GetSnapshotId();
+    ASSERT_EQ("", leader.ExecuteStatement("INSERT INTO t VALUES (1), (2), (3)"));
+    InMemoryDatabase follower;
+
+    // Act
+    const auto delta = leader.CreateDeltaSnapshot(baseId);
+    const auto error = follower.InstallDeltaSnapshot(delta);
+
+    // Assert
+    EXPECT_TRUE(delta.full);
+    EXPECT_EQ("", error);
+    EXPECT_EQ(leader.CreateSnapshot(), follower.CreateSnapshot());
+}
+
+TEST_F(InMemoryDatabaseTests, Delta_Snapshot_From_Zero_Is_Full) {
+    // Arrange
+    InMemoryDatabase leader;
+    ASSERT_EQ("", leader.ExecuteStatement("CREATE TABLE t (x INTEGER)"));
+    ASSERT_EQ("", leader.ExecuteStatement("INSERT INTO t VALUES (1), (2), (3)"));
+    InMemoryDatabase follower;
+
+    // Act
+    const auto delta = leader.CreateDeltaSnapshot(0);
+    const auto error = follower.InstallDeltaSnapshot(delta);
+
+    // Assert
+    EXPECT_TRUE(delta.full);
+    EXPECT_EQ(leader.GetSnapshotId(), delta.id);
+    EXPECT_EQ("", error);
+    EXPECT_EQ(leader.CreateSnapshot(), follower.CreateSnapshot());
+}
+
+TEST_F(InMemoryDatabaseTests, Delta_Snapshot_With_Wrong_Base_Is_Rejected) {
+    // Arrange
+    const auto baseId = database.GetSnapshotId();
+    ASSERT_EQ("", database.ExecuteStatement("DELETE FROM people WHERE id = 1"));
+    const auto delta = database.CreateDeltaSnapshot(baseId);
+    InMemoryDatabase follower;
+
+    // Act
+    const auto error = follower.InstallDeltaSnapshot(delta);
+
+    // Assert
+    EXPECT_EQ("delta snapshot base does not match database state", error);
+}
+
+TEST_F(InMemoryDatabaseTests, Transaction_Commit_Advances_Snapshot_Id_Once) {
+    // Arrange
+    const auto id = database.GetSnapshotId();
+    Transaction transaction(database);
+    ASSERT_EQ("", transaction.GetError());
+
+    // Act
+    ASSERT_EQ("", database.ExecuteStatement("INSERT INTO people (name) VALUES ('dave')"));
+    ASSERT_EQ("", database.ExecuteStatement("DELETE FROM people WHERE name = 'bob'"));
+    const auto idBeforeCommit = database.GetSnapshotId();
+    const auto error = transaction.Commit();
+
+    // Assert
+    EXPECT_EQ("", error);
+    EXPECT_EQ(id, idBeforeCommit);
+    EXPECT_EQ(id + 1, database.GetSnapshotId());
+    EXPECT_EQ(
+        std::vector< std::string >({"alice", "carol", "dave"}),
+        Column("SELECT name FROM people ORDER BY name")
+    );
+}
+
+TEST_F(InMemoryDatabaseTests, Transaction_Rollback_Undoes_Data_And_Schema_Changes) {
+    // Arrange
+    const auto snapshot = database.CreateSnapshot();
+
+    // Act
+    {
+        Transaction transaction(database);
+        ASSERT_EQ("", database.ExecuteStatement("UPDATE people SET age = 1"));
+        ASSERT_EQ("", database.ExecuteStatement("DROP INDEX people_age"));
+        ASSERT_EQ("", database.ExecuteStatement("CREATE TABLE pets (name TEXT)"));
+        ASSERT_EQ("", database.ExecuteStatement("INSERT INTO pets VALUES ('rex')"));
+        ASSERT_EQ("", database.ExecuteStatement("DELETE FROM people WHERE name = 'alice'"));
+        ASSERT_EQ("", database.ExecuteStatement("DROP TABLE people"));
+    }
+
+    // Assert
+    EXPECT_EQ(snapshot, database.CreateSnapshot());
+    EXPECT_EQ(
+        std::vector< std::string >({"alice"}),
+        Column("SELECT name FROM people WHERE age = 30")
+    );
+}
+
+TEST_F(InMemoryDatabaseTests, Failed_Statement_In_Transaction_Keeps_Earlier_Changes) {
+    // Arrange
+    Transaction transaction(database);
+    ASSERT_EQ("", database.ExecuteStatement("INSERT INTO people (name) VALUES ('dave')"));
+
+    // Act
+    const auto error = database.ExecuteStatement("INSERT INTO people (name) VALUES ('erin'), ('bob')");
+    ASSERT_EQ("", transaction.Commit());
+
+    // Assert
+    EXPECT_NE("", error);
+    EXPECT_EQ(
+        std::vector< std::string >({"4"}),
+        Column("SELECT COUNT(*) FROM people")
+    );
+}
+
+TEST_F(InMemoryDatabaseTests, Transaction_Statements) {
+    // Arrange
+
+    // Act
+    const auto nested = database.ExecuteStatement("BEGIN; BEGIN TRANSACTION");
+    const auto rollback = database.ExecuteStatement("ROLLBACK");
+    const auto commit = database.ExecuteStatement("COMMIT");
+
+    // Assert
+    EXPECT_EQ("cannot start a transaction within a transaction", nested);
+    EXPECT_EQ("", rollback);
+    EXPECT_EQ("cannot commit - no transaction is active", commit);
+}
+
+TEST_F(InMemoryDatabaseTests, Apply_Write_Batch_Is_Atomic) {
+    // Arrange
+    WriteBatch good;
+    good.Add("INSERT INTO people (name, age) VALUES (?, ?)", {"dave", 40});
+    good.Add("INSERT INTO people (name, age) VALUES (?, ?)", {"erin", 45});
+    good.Add("UPDATE people SET age = ? WHERE name = ?", {26, "bob"});
+    WriteBatch bad;
+    bad.Add("INSERT INTO people (name, age) VALUES (?, ?)", {"frank", 50});
+    bad.Add("INSERT INTO people (name, age) VALUES (?, ?)", {"alice", 55});
+    const auto id = database.GetSnapshotId();
+
+    // Act
+    const auto goodError = database.ApplyWriteBatch(good);
+    const auto badError = database.ApplyWriteBatch(bad);
+
+    // Assert
+    EXPECT_EQ("", goodError);
+    EXPECT_EQ("UNIQUE constraint failed: people.name", badError);
+    EXPECT_EQ(id + 1, database.GetSnapshotId());
+    EXPECT_EQ(
+        std::vector< std::string >({"bob", "alice", "carol", "dave", "erin"}),
+        Column("SELECT name FROM people ORDER BY age")
+    );
+}
+
+TEST_F(InMemoryDatabaseTests, Delta_Snapshot_Excludes_Open_Transaction) {
+    // Arrange
+    const auto baseId = database.GetSnapshotId();
+    ASSERT_EQ("", database.ExecuteStatement("DELETE FROM people WHERE name = 'alice'"));
+    Transaction transaction(database);
+    ASSERT_EQ("", database.ExecuteStatement("DELETE FROM people"));
+
+    // Act
+    const auto delta = database.CreateDeltaSnapshot(baseId);
+
+    // Assert
+    EXPECT_FALSE(delta.full);
+    EXPECT_EQ(baseId + 1, delta.id);
+}
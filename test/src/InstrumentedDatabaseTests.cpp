@@ -0,0 +1,268 @@
+/**
+ * @file InstrumentedDatabaseTests.cpp
+ *
+ * This module contains unit tests of the
+ * DatabaseAbstractions::InstrumentedDatabase class.
+ */
+
+#include <DatabaseAbstractions/InMemoryDatabase.hpp>
+#include <DatabaseAbstractions/InstrumentedDatabase.hpp>
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+
+using namespace DatabaseAbstractions;
+
+namespace {
+
+    /**
+     * This finds the metrics for the given SQL text.
+     *
+     * @param[in] metrics
+     *     These are the metrics to search.
+     *
+     * @param[in] text
+     *     This is the SQL text whose metrics to find.
+     *
+     * @return
+     *     The metrics for the SQL text are returned, or empty metrics
+     *     if there are none.
+     */
+    StatementMetrics FindStatement(
+        const DatabaseMetrics& metrics,
+        const std::string& text
+    ) {
+        for (const auto& statement: metrics.statements) {
+            if (statement.text == text) {
+                return statement;
+            }
+        }
+        return StatementMetrics();
+    }
+
+    /**
+     * This returns the index of the histogram bucket into which
+     * the given duration falls.
+     *
+     * @param[in] nanoseconds
+     *     This is the duration to place in a bucket.
+     *
+     * @param[in] bucketCount
+     *     This is the number of buckets in the histogram.
+     *
+     * @return
+     *     The index of the bucket is returned.
+     */
+    size_t FindBucket(
+        uint64_t nanoseconds,
+        size_t bucketCount
+    ) {
+        size_t bucket = 0;
+        while (
+            (bucket + 1 < bucketCount)
+            && (LatencyStatistics::GetBucketLowerBound(bucket + 1) <= nanoseconds)
+        ) {
+            ++bucket;
+        }
+        return bucket;
+    }
+
+}
+
+/**
+ * This is the test fixture for these tests, providing common
+ * setup and teardown for each test.
+ */
+struct InstrumentedDatabaseTests
+    : public ::testing::Test
+{
+    // Properties
+
+    std::shared_ptr< InMemoryDatabase > wrapped = std::make_shared< InMemoryDatabase >();
+    InstrumentedDatabase database{wrapped};
+
+    // ::testing::Test
+
+    virtual void SetUp() override {
+        ASSERT_EQ(
+            "",
+            wrapped->ExecuteStatement(
+                "CREATE TABLE people (name TEXT, age INTEGER);"
+                "INSERT INTO people VALUES ('alice', 30), ('bob', 25), ('carol', 35)"
+            )
+        );
+    }
+};
+
+TEST_F(InstrumentedDatabaseTests, Statement_Use_Measured) {
+    // Arrange
+    const std::string query = "SELECT name FROM people ORDER BY name";
+
+    // Act
+    const auto built = database.BuildStatement(query);
+    ASSERT_EQ("", built.error);
+    while (!built.statement->Step().done) {
+        (void)built.statement->FetchColumn(0, Value::Type::Text);
+    }
+
+    // Assert
+    const auto metrics = FindStatement(database.GetMetrics(), query);
+    EXPECT_EQ(query, metrics.text);
+    EXPECT_EQ(1, metrics.build.count);
+    EXPECT_EQ(4, metrics.step.count);
+    EXPECT_EQ(3, metrics.fetch.count);
+    EXPECT_EQ(3, metrics.rows);
+    EXPECT_EQ(13, metrics.bytesFetched);
+    EXPECT_EQ(0, metrics.errors);
+    EXPECT_LE(metrics.step.maxNanoseconds, metrics.step.totalNanoseconds);
+}
+
+TEST_F(InstrumentedDatabaseTests, Step_Batch_Measured) {
+    // Arrange
+    const std::string query = "SELECT name, age FROM people";
+    const auto built = database.BuildStatement(query);
+    RowBatch batch({Value::Type::Text, Value::Type::Integer});
+
+    // Act
+    const auto results = built.statement->StepBatch(10, batch);
+
+    // Assert
+    EXPECT_TRUE(results.done);
+    const auto metrics = FindStatement(database.GetMetrics(), query);
+    EXPECT_EQ(1, metrics.step.count);
+    EXPECT_EQ(3, metrics.rows);
+    EXPECT_EQ(13, metrics.bytesFetched);
+}
+
+TEST_F(InstrumentedDatabaseTests, Errors_Counted) {
+    // Arrange
+    const std::string statement = "INSERT INTO nowhere VALUES (1)";
+
+    // Act
+    (void)database.ExecuteStatement(statement);
+    (void)database.ExecuteStatement(statement);
+
+    // Assert
+    const auto metrics = FindStatement(database.GetMetrics(), statement);
+    EXPECT_EQ(2, metrics.execute.count);
+    EXPECT_EQ(2, metrics.errors);
+}
+
+TEST_F(InstrumentedDatabaseTests, Statements_Past_Limit_Measured_Together) {
+    // Arrange
+    InstrumentedDatabase limited(wrapped, 2);
+    const std::string first = "SELECT name FROM people";
+    const std::string second = "SELECT age FROM people";
+
+    // Act
+    (void)limited.ExecuteStatement(first);
+    (void)limited.ExecuteStatement(second);
+    for (int i = 0; i < 5; ++i) {
+        (void)limited.ExecuteStatement("SELECT " + std::to_string(i));
+    }
+    (void)limited.ExecuteStatement(first);
+
+    // Assert
+    const auto metrics = limited.GetMetrics();
+    ASSERT_EQ((size_t)3, metrics.statements.size());
+    EXPECT_EQ(2, FindStatement(metrics, first).execute.count);
+    EXPECT_EQ(1, FindStatement(metrics, second).execute.count);
+    const auto& other = metrics.statements.back();
+    EXPECT_TRUE(other.other);
+    EXPECT_EQ("", other.text);
+    EXPECT_EQ(5, other.execute.count);
+}
+
+TEST_F(InstrumentedDatabaseTests, Snapshots_Measured) {
+    // Arrange
+    InstrumentedDatabase follower(std::make_shared< InMemoryDatabase >());
+
+    // Act
+    const auto snapshot = database.CreateSnapshot();
+    EXPECT_EQ("", follower.InstallSnapshot(snapshot));
+
+    // Assert
+    const auto leaderMetrics = database.GetMetrics();
+    EXPECT_EQ(1, leaderMetrics.snapshotsCreated.snapshots);
+    EXPECT_EQ(snapshot.size(), leaderMetrics.snapshotsCreated.bytes);
+    EXPECT_EQ(1, leaderMetrics.snapshotsCreated.duration.count);
+    const auto followerMetrics = follower.GetMetrics();
+    EXPECT_EQ(1, followerMetrics.snapshotsInstalled.snapshots);
+    EXPECT_EQ(snapshot.size(), followerMetrics.snapshotsInstalled.bytes);
+}
+
+TEST_F(InstrumentedDatabaseTests, Chunked_Snapshots_Measured) {
+    // Arrange
+    InstrumentedDatabase follower(std::make_shared< InMemoryDatabase >());
+    const auto reader = database.CreateSnapshotReader(16);
+    const auto writer = follower.CreateSnapshotWriter();
+    size_t bytes = 0;
+
+    // Act
+    Blob chunk;
+    for (;;) {
+        const auto results = reader->ReadChunk(chunk);
+        ASSERT_EQ("", results.error);
+        if (results.done) {
+            break;
+        }
+        bytes += chunk.size();
+        ASSERT_EQ("", writer->WriteChunk(chunk));
+    }
+    ASSERT_EQ("", writer->Finish());
+
+    // Assert
+    const auto leaderMetrics = database.GetMetrics();
+    EXPECT_EQ(1, leaderMetrics.snapshotsCreated.snapshots);
+    EXPECT_EQ(bytes, leaderMetrics.snapshotsCreated.bytes);
+    const auto followerMetrics = follower.GetMetrics();
+    EXPECT_EQ(1, followerMetrics.snapshotsInstalled.snapshots);
+    EXPECT_EQ(bytes, followerMetrics.snapshotsInstalled.bytes);
+}
+
+TEST_F(InstrumentedDatabaseTests, Write_Batches_Measured) {
+    // Arrange
+    WriteBatch batch;
+    batch.Add("INSERT INTO people VALUES (?, ?)", {"dave", 40});
+
+    // Act
+    EXPECT_EQ("", database.ApplyWriteBatch(batch));
+
+    // Assert
+    EXPECT_EQ(1, database.GetMetrics().writeBatches.count);
+}
+
+TEST_F(InstrumentedDatabaseTests, Bucket_Lower_Bounds_Increase) {
+    // Arrange
+    uint64_t previous = 0;
+
+    // Act
+    for (size_t bucket = 1; bucket < 300; ++bucket) {
+        const auto lowerBound = LatencyStatistics::GetBucketLowerBound(bucket);
+
+        // Assert
+        EXPECT_GT(lowerBound, previous);
+        EXPECT_LE(lowerBound - previous, (previous / 8) + 1);
+        previous = lowerBound;
+    }
+}
+
+TEST_F(InstrumentedDatabaseTests, Percentiles) {
+    // Arrange
+    LatencyStatistics statistics;
+    statistics.buckets.resize(312);
+    statistics.buckets[FindBucket(1000, 312)] = 90;
+    statistics.buckets[FindBucket(50000, 312)] = 10;
+    statistics.count = 100;
+    statistics.maxNanoseconds = 50000;
+
+    // Act
+    const auto median = statistics.GetPercentile(0.5);
+    const auto p99 = statistics.GetPercentile(0.99);
+
+    // Assert
+    EXPECT_GE(median, 1000);
+    EXPECT_LE(median, 1125);
+    EXPECT_EQ(50000, p99);
+    EXPECT_EQ(0, LatencyStatistics().GetPercentile(0.5));
+}
@@ -0,0 +1,211 @@
+/**
+ * @file PreparedStatementTests.cpp
+ *
+ * This module contains unit tests of the base implementations of the
+ * optional methods of the DatabaseAbstractions::PreparedStatement class.
+ */
+
+#include <DatabaseAbstractions/Database.hpp>
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+using namespace DatabaseAbstractions;
+
+namespace {
+
+    /**
+     * This is a fake prepared statement which steps through a fixed
+     * set of rows, fetching blobs as views of its row buffer.
+     */
+    struct MockStatement
+        : public PreparedStatement
+    {
+        // Properties
+
+        std::vector< std::vector< Value > > rows;
+        size_t nextRow = 0;
+        std::vector< Value > currentRow;
+        std::string error;
+        size_t errorRow = (size_t)-1;
+        size_t steps = 0;
+        std::vector< Value > parameters;
+
+        // PreparedStatement
+
+        virtual void BindParameter(
+            int index,
+            const Value& value
+        ) override {
+            if ((size_t)index > parameters.size()) {
+                parameters.resize(index);
+            }
+            parameters[index - 1] = value;
+        }
+
+        virtual void BindParameters(std::initializer_list< const Value > values) override {
+        }
+
+        virtual Value FetchColumn(int index, Value::Type type) override {
+            const auto& value = currentRow[index];
+            if (value.GetType() != type) {
+                return Value();
+            }
+            if (type == Value::Type::Blob) {
+                return BlobView(value);
+            }
+            return value;
+        }
+
+        virtual void Reset() override {
+            nextRow = 0;
+        }
+
+        virtual StepStatementResults Step() override {
+            ++steps;
+            StepStatementResults results;
+            if (nextRow == errorRow) {
+                results.error = error;
+            } else if (nextRow < rows.size()) {
+                currentRow = rows[nextRow++];
+            } else {
+                currentRow.clear();
+                results.done = true;
+            }
+            return results;
+        }
+    };
+
+}
+
+/**
+ * This is the test fixture for these tests, providing common
+ * setup and teardown for each test.
+ */
+struct PreparedStatementTests
+    : public ::testing::Test
+{
+    // Properties
+
+    MockStatement statement;
+
+    // ::testing::Test
+
+    virtual void SetUp() override {
+        for (int i = 0; i < 5; ++i) {
+            statement.rows.push_back({
+                i,
+                std::to_string(i),
+                Blob(3, (uint8_t)i),
+            });
+        }
+    }
+};
+
+TEST_F(PreparedStatementTests, Step_Batch_Fetches_Up_To_Max_Rows) {
+    // Arrange
+    RowBatch batch({Value::Type::Integer, Value::Type::Text});
+
+    // Act
+    const auto results = statement.StepBatch(3, batch);
+
+    // Assert
+    EXPECT_FALSE(results.done);
+    EXPECT_TRUE(results.error.empty());
+    ASSERT_EQ((size_t)3, batch.GetRowCount());
+    for (size_t row = 0; row < 3; ++row) {
+        EXPECT_EQ(Value((int)row), batch.GetValue(row, 0));
+        EXPECT_EQ(Value(std::to_string(row)), batch.GetValue(row, 1));
+    }
+}
+
+TEST_F(PreparedStatementTests, Step_Batch_Reports_Done_When_Rows_Run_Out) {
+    // Arrange
+    RowBatch batch({Value::Type::Integer});
+    (void)statement.StepBatch(3, batch);
+
+    // Act
+    const auto results = statement.StepBatch(3, batch);
+
+    // Assert
+    EXPECT_TRUE(results.done);
+    EXPECT_TRUE(results.error.empty());
+    ASSERT_EQ((size_t)2, batch.GetRowCount());
+    EXPECT_EQ(Value(3), batch.GetValue(0, 0));
+    EXPECT_EQ(Value(4), batch.GetValue(1, 0));
+}
+
+TEST_F(PreparedStatementTests, Step_Batch_Owns_Borrowed_Blobs) {
+    // Arrange
+    RowBatch batch({Value::Type::Integer, Value::Type::Text, Value::Type::Blob});
+
+    // Act
+    (void)statement.StepBatch(5, batch);
+
+    // Assert
+    ASSERT_EQ((size_t)5, batch.GetRowCount());
+    for (size_t row = 0; row < 5; ++row) {
+        const auto& value = batch.GetValue(row, 2);
+        EXPECT_FALSE(value.IsBorrowed());
+        EXPECT_EQ(Value(Blob(3, (uint8_t)row)), value);
+    }
+}
+
+TEST_F(PreparedStatementTests, Step_Batch_Stops_On_Error) {
+    // Arrange
+    RowBatch batch({Value::Type::Integer});
+    statement.errorRow = 2;
+    statement.error = "REEEEEEE";
+
+    // Act
+    const auto results = statement.StepBatch(5, batch);
+
+    // Assert
+    EXPECT_FALSE(results.done);
+    EXPECT_EQ("REEEEEEE", results.error);
+    EXPECT_EQ((size_t)2, batch.GetRowCount());
+}
+
+TEST_F(PreparedStatementTests, Step_Batch_Does_Not_Step_Past_Max_Rows) {
+    // Arrange
+    RowBatch batch({Value::Type::Integer});
+
+    // Act
+    (void)statement.StepBatch(2, batch);
+
+    // Assert
+    EXPECT_EQ((size_t)2, statement.steps);
+}
+
+TEST_F(PreparedStatementTests, Bind_Moved_Parameters_Binds_Each_In_Order) {
+    // Arrange
+    std::vector< Value > values{Value(1), Value("two"), Value(Blob{3})};
+    PreparedStatement& base = statement;
+
+    // Act
+    base.BindParameters(std::move(values));
+    base.BindParameter(4, Value(4.5));
+
+    // Assert
+    ASSERT_EQ((size_t)4, statement.parameters.size());
+    EXPECT_EQ(Value(1), statement.parameters[0]);
+    EXPECT_EQ(Value("two"), statement.parameters[1]);
+    EXPECT_EQ(Value(Blob{3}), statement.parameters[2]);
+    EXPECT_EQ(Value(4.5), statement.parameters[3]);
+}
+
+TEST_F(PreparedStatementTests, Fetch_Column_Into_Value) {
+    // Arrange
+    ASSERT_FALSE(statement.Step().done);
+    Value value("Hello!");
+    PreparedStatement& base = statement;
+
+    // Act
+    base.FetchColumn(1, Value::Type::Text, value);
+    const auto text = value;
+    base.FetchColumn(0, Value::Type::Integer, value);
+
+    // Assert
+    EXPECT_EQ(Value("0"), text);
+    EXPECT_EQ(Value(0), value);
+}
@@ -0,0 +1,104 @@
+/**
+ * @file RowBatchTests.cpp
+ *
+ * This module contains unit tests of the
+ * DatabaseAbstractions::RowBatch class.
+ */
+
+#include <DatabaseAbstractions/RowBatch.hpp>
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+using namespace DatabaseAbstractions;
+
+/**
+ * This is the test fixture for these tests, providing common
+ * setup and teardown for each test.
+ */
+struct RowBatchTests
+    : public ::testing::Test
+{
+};
+
+TEST_F(RowBatchTests, Construct_Batch) {
+    // Arrange
+
+    // Act
+    RowBatch batch({Value::Type::Integer, Value::Type::Text}, 10);
+
+    // Assert
+    EXPECT_EQ((size_t)2, batch.GetColumnCount());
+    EXPECT_EQ(Value::Type::Integer, batch.GetColumnType(0));
+    EXPECT_EQ(Value::Type::Text, batch.GetColumnType(1));
+    EXPECT_EQ((size_t)0, batch.GetRowCount());
+    EXPECT_EQ((size_t)10, batch.GetCapacity());
+}
+
+TEST_F(RowBatchTests, Add_Rows_Stores_Values_By_Column) {
+    // Arrange
+    RowBatch batch({Value::Type::Integer, Value::Type::Text}, 2);
+
+    // Act
+    for (int i = 0; i < 2; ++i) {
+        const auto row = batch.AddRow();
+        batch.GetValue(row, 0) = i;
+        batch.GetValue(row, 1) = std::to_string(i);
+    }
+
+    // Assert
+    ASSERT_EQ((size_t)2, batch.GetRowCount());
+    const auto integers = batch.GetColumn(0);
+    const auto texts = batch.GetColumn(1);
+    EXPECT_EQ(Value(0), integers[0]);
+    EXPECT_EQ(Value(1), integers[1]);
+    EXPECT_EQ(Value("0"), texts[0]);
+    EXPECT_EQ(Value("1"), texts[1]);
+    EXPECT_EQ(Value("1"), batch.GetValue(1, 1));
+}
+
+TEST_F(RowBatchTests, Add_Rows_Beyond_Capacity) {
+    // Arrange
+    RowBatch batch({Value::Type::Integer});
+
+    // Act
+    for (int i = 0; i < 5; ++i) {
+        const auto row = batch.AddRow();
+        batch.GetValue(row, 0) = i;
+    }
+
+    // Assert
+    ASSERT_EQ((size_t)5, batch.GetRowCount());
+    EXPECT_GE(batch.GetCapacity(), (size_t)5);
+    for (int i = 0; i < 5; ++i) {
+        EXPECT_EQ(Value(i), batch.GetValue((size_t)i, 0));
+    }
+}
+
+TEST_F(RowBatchTests, Clear_Keeps_Capacity) {
+    // Arrange
+    RowBatch batch({Value::Type::Integer}, 4);
+    for (int i = 0; i < 3; ++i) {
+        (void)batch.AddRow();
+    }
+
+    // Act
+    batch.Clear();
+
+    // Assert
+    EXPECT_EQ((size_t)0, batch.GetRowCount());
+    EXPECT_EQ((size_t)4, batch.GetCapacity());
+}
+
+TEST_F(RowBatchTests, Clear_Releases_Arena) {
+    // Arrange
+    RowBatch batch({Value::Type::Text});
+    const auto row = batch.AddRow();
+    batch.GetValue(row, 0).Assign(Value("Hello!"), batch.GetArena());
+
+    // Act
+    batch.Clear();
+
+    // Assert
+    EXPECT_EQ((size_t)0, batch.GetArena().GetBytesUsed());
+}
@@ -0,0 +1,505 @@
+/**
+ * @file SegmentedLogStoreTests.cpp
+ *
+ * This module contains unit tests of the
+ * DatabaseAbstractions::SegmentedLogStore class.
+ */
+
+#include <DatabaseAbstractions/SegmentedLogStore.hpp>
+#include <gtest/gtest.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+using namespace DatabaseAbstractions;
+
+namespace {
+
+    /**
+     * This returns the data to store in the log entry with the
+     * given index.
+     *
+     * @param[in] index
+     *     This is the index of the entry.
+     *
+     * @return
+     *     The data to store in the entry is returned.
+     */
+    Blob MakeEntryData(uint64_t index) {
+        return Blob((size_t)(index % 7) * 10, (uint8_t)index);
+    }
+
+    /**
+     * This returns the path of the file of the given segment
+     * of a log.
+     *
+     * @param[in] basePath
+     *     This is the path, without extension, of the files
+     *     of the log.
+     *
+     * @param[in] number
+     *     This is the sequence number of the segment.
+     *
+     * @return
+     *     The path of the segment's file is returned.
+     */
+    std::string SegmentPath(
+        const std::string& basePath,
+        uint64_t number
+    ) {
+        auto digits = std::to_string(number);
+        digits.insert(0, 10 - digits.length(), '0');
+        return basePath + "." + digits + ".log";
+    }
+
+    /**
+     * This determines whether or not the given file exists.
+     *
+     * @param[in] path
+     *     This is the path of the file.
+     *
+     * @return
+     *     An indication of whether or not the file exists is returned.
+     */
+    bool FileExists(const std::string& path) {
+        const auto file = fopen(path.c_str(), "rb");
+        if (file == NULL) {
+            return false;
+        }
+        (void)fclose(file);
+        return true;
+    }
+
+    /**
+     * This reads the complete contents of the given file.
+     *
+     * @param[in] path
+     *     This is the path of the file to read.
+     *
+     * @return
+     *     The contents of the file are returned.
+     */
+    Blob ReadFile(const std::string& path) {
+        Blob contents;
+        const auto file = fopen(path.c_str(), "rb");
+        if (file == NULL) {
+            return contents;
+        }
+        uint8_t buffer[4096];
+        size_t size;
+        while ((size = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+            contents.insert(contents.end(), buffer, buffer + size);
+        }
+        (void)fclose(file);
+        return contents;
+    }
+
+    /**
+     * This replaces the contents of the given file.
+     *
+     * @param[in] path
+     *     This is the path of the file to write.
+     *
+     * @param[in] contents
+     *     These are the new contents of the file.
+     */
+    void WriteFile(
+        const std::string& path,
+        const Blob& contents
+    ) {
+        const auto file = fopen(path.c_str(), "wb");
+        if (file == NULL) {
+            return;
+        }
+        (void)fwrite(contents.data(), 1, contents.size(), file);
+        (void)fclose(file);
+    }
+
+}
+
+/**
+ * This is the test fixture for these tests, providing common
+ * setup and teardown for each test.
+ */
+struct SegmentedLogStoreTests
+    : public ::testing::Test
+{
+    // Properties
+
+    SegmentedLogStore log;
+    std::string basePath;
+
+    // Methods
+
+    /**
+     * This appends entries to the log, through the given index,
+     * using MakeEntryData for their data and a term which goes up
+     * every ten entries.
+     *
+     * @param[in] last
+     *     This is the index of the last entry to append.
+     */
+    void AppendThrough(uint64_t last) {
+        for (auto index = log.GetLastIndex() + 1; index <= last; ++index) {
+            ASSERT_EQ("", log.Append(1 + index / 10, MakeEntryData(index)));
+        }
+    }
+
+    /**
+     * This checks that the log holds the entries appended by
+     * AppendThrough, over the given range of indexes.
+     *
+     * @param[in] first
+     *     This is the index of the first entry to check.
+     *
+     * @param[in] last
+     *     This is the index of the last entry to check.
+     */
+    void ExpectEntries(
+        uint64_t first,
+        uint64_t last
+    ) {
+        std::vector< LogEntryView > entries;
+        ASSERT_EQ("", log.Read(first, last, entries));
+        ASSERT_EQ((size_t)(last - first + 1), entries.size());
+        for (auto index = first; index <= last; ++index) {
+            const auto& entry = entries[(size_t)(index - first)];
+            EXPECT_EQ(index, entry.index);
+            EXPECT_EQ(1 + index / 10, entry.term) << index;
+            EXPECT_EQ(1 + index / 10, log.GetTerm(index)) << index;
+            EXPECT_EQ(
+                MakeEntryData(index),
+                Blob(entry.data.data, entry.data.data + entry.data.size)
+            ) << index;
+        }
+    }
+
+    // ::testing::Test
+
+    virtual void SetUp() override {
+        basePath = ::testing::TempDir() + "SegmentedLogStoreTests";
+        ASSERT_EQ("", log.Open(basePath, 256));
+    }
+
+    virtual void TearDown() override {
+        log.Close();
+        (void)remove((basePath + ".meta").c_str());
+        for (uint64_t number = 1; number < 1000; ++number) {
+            (void)remove(SegmentPath(basePath, number).c_str());
+        }
+    }
+};
+
+TEST_F(SegmentedLogStoreTests, New_Log_Is_Empty) {
+    // Arrange
+    std::vector< LogEntryView > entries;
+
+    // Act
+    const auto error = log.Read(1, 0, entries);
+
+    // Assert
+    EXPECT_EQ("", error);
+    EXPECT_TRUE(entries.empty());
+    EXPECT_EQ((uint64_t)1, log.GetFirstIndex());
+    EXPECT_EQ((uint64_t)0, log.GetLastIndex());
+    EXPECT_EQ((uint64_t)0, log.GetTerm(1));
+    EXPECT_EQ((size_t)1, log.GetSegmentCount());
+}
+
+TEST_F(SegmentedLogStoreTests, Append_And_Read_Across_Segments) {
+    // Arrange
+
+    // Act
+    AppendThrough(100);
+
+    // Assert
+    EXPECT_EQ((uint64_t)1, log.GetFirstIndex());
+    EXPECT_EQ((uint64_t)100, log.GetLastIndex());
+    EXPECT_GT(log.GetSegmentCount(), (size_t)10);
+    ExpectEntries(1, 100);
+    ExpectEntries(37, 52);
+}
+
+TEST_F(SegmentedLogStoreTests, Read_Entries_Not_In_Log) {
+    // Arrange
+    AppendThrough(10);
+    std::vector< LogEntryView > entries;
+
+    // Act
+    const auto errorAfter = log.Read(5, 11, entries);
+    const auto errorBefore = log.Read(0, 3, entries);
+
+    // Assert
+    EXPECT_EQ("log entries are not available", errorAfter);
+    EXPECT_EQ("log entries are not available", errorBefore);
+    EXPECT_TRUE(entries.empty());
+    EXPECT_EQ((uint64_t)0, log.GetTerm(11));
+}
+
+TEST_F(SegmentedLogStoreTests, Entries_Survive_Reopening) {
+    // Arrange
+    AppendThrough(100);
+    ASSERT_EQ("", log.Sync());
+    log.Close();
+
+    // Act
+    const auto error = log.Open(basePath, 256);
+    AppendThrough(110);
+
+    // Assert
+    EXPECT_EQ("", error);
+    EXPECT_EQ((uint64_t)110, log.GetLastIndex());
+    ExpectEntries(1, 110);
+}
+
+TEST_F(SegmentedLogStoreTests, Entry_Larger_Than_Segment) {
+    // Arrange
+    AppendThrough(3);
+    const Blob large(1000, 0x5A);
+
+    // Act
+    const auto error = log.Append(7, large);
+    AppendThrough(5);
+    std::vector< LogEntryView > entries;
+    ASSERT_EQ("", log.Read(4, 4, entries));
+
+    // Assert
+    EXPECT_EQ("", error);
+    ASSERT_EQ((size_t)1, entries.size());
+    EXPECT_EQ((uint64_t)7, entries[0].term);
+    EXPECT_EQ(large, Blob(entries[0].data.data, entries[0].data.data + entries[0].data.size));
+    ExpectEntries(5, 5);
+}
+
+TEST_F(SegmentedLogStoreTests, Truncate_Suffix_Within_Last_Segment) {
+    // Arrange
+    AppendThrough(100);
+    const auto segments = log.GetSegmentCount();
+
+    // Act
+    const auto error = log.TruncateSuffix(99);
+    ASSERT_EQ("", log.Append(42, Blob{1, 2, 3}));
+    ASSERT_EQ("", log.Sync());
+    log.Close();
+    ASSERT_EQ("", log.Open(basePath, 256));
+    std::vector< LogEntryView > entries;
+    ASSERT_EQ("", log.Read(100, 100, entries));
+
+    // Assert
+    EXPECT_EQ("", error);
+    EXPECT_EQ(segments, log.GetSegmentCount());
+    EXPECT_EQ((uint64_t)100, log.GetLastIndex());
+    ExpectEntries(1, 99);
+    ASSERT_EQ((size_t)1, entries.size());
+    EXPECT_EQ((uint64_t)42, entries[0].term);
+    EXPECT_EQ(Blob({1, 2, 3}), Blob(entries[0].data.data, entries[0].data.data + entries[0].data.size));
+}
+
+TEST_F(SegmentedLogStoreTests, Truncate_Suffix_Across_Segments) {
+    // Arrange
+    AppendThrough(100);
+    const auto segments = log.GetSegmentCount();
+
+    // Act
+    const auto error = log.TruncateSuffix(30);
+    const auto lastIndex = log.GetLastIndex();
+    const auto segmentsAfterTruncation = log.GetSegmentCount();
+    AppendThrough(40);
+    ASSERT_EQ("", log.Sync());
+    log.Close();
+    ASSERT_EQ("", log.Open(basePath, 256));
+
+    // Assert
+    EXPECT_EQ("", error);
+    EXPECT_EQ((uint64_t)30, lastIndex);
+    EXPECT_LT(segmentsAfterTruncation, segments);
+    EXPECT_FALSE(FileExists(SegmentPath(basePath, segments)));
+    EXPECT_EQ((uint64_t)40, log.GetLastIndex());
+    ExpectEntries(1, 40);
+}
+
+TEST_F(SegmentedLogStoreTests, Stale_Segment_After_Truncation_Is_Ignored_On_Reopening) {
+    // Arrange
+    AppendThrough(100);
+    ASSERT_EQ("", log.Sync());
+    ASSERT_GE(log.GetSegmentCount(), (size_t)3);
+    const auto stalePath = SegmentPath(basePath, 3);
+    const auto stale = ReadFile(stalePath);
+    ASSERT_GE(stale.size(), (size_t)24);
+    uint64_t staleFirstIndex = 0;
+    for (size_t i = 0; i < 8; ++i) {
+        staleFirstIndex |= ((uint64_t)stale[16 + i] << (i * 8));
+    }
+    ASSERT_EQ("", log.TruncateSuffix(staleFirstIndex - 1));
+    ASSERT_EQ("", log.Sync());
+    log.Close();
+    WriteFile(stalePath, stale);
+
+    // Act
+    const auto error = log.Open(basePath, 256);
+
+    // Assert
+    EXPECT_EQ("", error);
+    EXPECT_EQ((size_t)2, log.GetSegmentCount());
+    EXPECT_EQ(staleFirstIndex - 1, log.GetLastIndex());
+    EXPECT_FALSE(FileExists(stalePath));
+    ExpectEntries(1, staleFirstIndex - 1);
+}
+
+TEST_F(SegmentedLogStoreTests, Truncate_Suffix_To_Empty_Log) {
+    // Arrange
+    AppendThrough(20);
+
+    // Act
+    const auto error = log.TruncateSuffix(0);
+    AppendThrough(3);
+
+    // Assert
+    EXPECT_EQ("", error);
+    EXPECT_EQ((uint64_t)1, log.GetFirstIndex());
+    EXPECT_EQ((uint64_t)3, log.GetLastIndex());
+    EXPECT_EQ((size_t)1, log.GetSegmentCount());
+    ExpectEntries(1, 3);
+}
+
+TEST_F(SegmentedLogStoreTests, Compact_Prefix_Removes_Whole_Segments) {
+    // Arrange
+    AppendThrough(100);
+    const auto segments = log.GetSegmentCount();
+
+    // Act
+    const auto error = log.CompactPrefix(50);
+    const auto segmentsAfterCompaction = log.GetSegmentCount();
+    ASSERT_EQ("", log.Sync());
+    log.Close();
+    ASSERT_EQ("", log.Open(basePath, 256));
+    std::vector< LogEntryView > entries;
+    const auto readError = log.Read(50, 60, entries);
+
+    // Assert
+    EXPECT_EQ("", error);
+    EXPECT_LT(segmentsAfterCompaction, segments);
+    EXPECT_EQ(segmentsAfterCompaction, log.GetSegmentCount());
+    EXPECT_FALSE(FileExists(SegmentPath(basePath, 1)));
+    EXPECT_EQ((uint64_t)51, log.GetFirstIndex());
+    EXPECT_EQ((uint64_t)100, log.GetLastIndex());
+    EXPECT_EQ((uint64_t)0, log.GetTerm(50));
+    EXPECT_EQ("log entries are not available", readError);
+    ExpectEntries(51, 100);
+}
+
+TEST_F(SegmentedLogStoreTests, Compact_Prefix_Past_End_Of_Log) {
+    // Arrange
+    AppendThrough(100);
+
+    // Act
+    const auto error = log.CompactPrefix(500);
+    AppendThrough(505);
+    ASSERT_EQ("", log.Sync());
+    log.Close();
+    ASSERT_EQ("", log.Open(basePath, 256));
+
+    // Assert
+    EXPECT_EQ("", error);
+    EXPECT_EQ((uint64_t)501, log.GetFirstIndex());
+    EXPECT_EQ((uint64_t)505, log.GetLastIndex());
+    EXPECT_FALSE(FileExists(SegmentPath(basePath, 1)));
+    ExpectEntries(501, 505);
+}
+
+TEST_F(SegmentedLogStoreTests, Truncate_Suffix_Cannot_Restore_Compacted_Entries) {
+    // Arrange
+    AppendThrough(100);
+    ASSERT_EQ("", log.CompactPrefix(50));
+
+    // Act
+    const auto error = log.TruncateSuffix(20);
+
+    // Assert
+    EXPECT_EQ("log entries to keep have already been removed", error);
+    EXPECT_EQ((uint64_t)100, log.GetLastIndex());
+}
+
+TEST_F(SegmentedLogStoreTests, Torn_Entry_Discarded_On_Reopening) {
+    // Arrange
+    AppendThrough(5);
+    ASSERT_EQ("", log.Sync());
+    const auto path = SegmentPath(basePath, log.GetSegmentCount());
+    log.Close();
+    auto contents = ReadFile(path);
+    const auto goodSize = contents.size();
+    contents.resize(goodSize - 3);
+    WriteFile(path, contents);
+
+    // Act
+    const auto error = log.Open(basePath, 256);
+    const auto lastIndex = log.GetLastIndex();
+    AppendThrough(6);
+    ASSERT_EQ("", log.Sync());
+    log.Close();
+    ASSERT_EQ("", log.Open(basePath, 256));
+
+    // Assert
+    EXPECT_EQ("", error);
+    EXPECT_EQ((uint64_t)4, lastIndex);
+    EXPECT_EQ((uint64_t)6, log.GetLastIndex());
+    ExpectEntries(1, 6);
+}
+
+TEST_F(SegmentedLogStoreTests, Corrupt_Entry_Discarded_On_Reopening) {
+    // Arrange
+    AppendThrough(5);
+    ASSERT_EQ("", log.Sync());
+    const auto path = SegmentPath(basePath, log.GetSegmentCount());
+    log.Close();
+    auto contents = ReadFile(path);
+    contents[contents.size() - 1] ^= 0x01;
+    WriteFile(path, contents);
+
+    // Act
+    const auto error = log.Open(basePath, 256);
+
+    // Assert
+    EXPECT_EQ("", error);
+    EXPECT_EQ((uint64_t)4, log.GetLastIndex());
+    ExpectEntries(1, 4);
+}
+
+TEST_F(SegmentedLogStoreTests, Corrupt_Middle_Segment_Is_Reported) {
+    // Arrange
+    AppendThrough(40);
+    ASSERT_EQ("", log.Sync());
+    const auto segments = log.GetSegmentCount();
+    ASSERT_GE(segments, (size_t)3);
+    const auto path = SegmentPath(basePath, 2);
+    log.Close();
+    auto contents = ReadFile(path);
+    const auto goodSize = contents.size();
+    contents[goodSize - 1] ^= 0x01;
+    WriteFile(path, contents);
+
+    // Act
+    const auto error = log.Open(basePath, 256);
+
+    // Assert
+    EXPECT_EQ("log segment file '" + path + "' is corrupt", error);
+    EXPECT_EQ("log store is not open", log.Append(1, Blob{1}));
+    EXPECT_EQ(goodSize, ReadFile(path).size());
+    EXPECT_TRUE(FileExists(SegmentPath(basePath, segments)));
+}
+
+TEST_F(SegmentedLogStoreTests, Corrupt_Meta_File_Is_Reported) {
+    // Arrange
+    log.Close();
+    auto contents = ReadFile(basePath + ".meta");
+    ASSERT_FALSE(contents.empty());
+    contents[16] ^= 0x01;
+    WriteFile(basePath + ".meta", contents);
+
+    // Act
+    const auto error = log.Open(basePath, 256);
+
+    // Assert
+    EXPECT_EQ("log meta file is corrupt", error);
+    EXPECT_EQ("log store is not open", log.Append(1, Blob{1}));
+}
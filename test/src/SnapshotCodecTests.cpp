@@ -0,0 +1,558 @@
+/**
+ * @file SnapshotCodecTests.cpp
+ *
+ * This module contains unit tests of the snapshot codecs and of the
+ * functions and classes which compress snapshots into frames.
+ */
+
+#include <DatabaseAbstractions/Crc32c.hpp>
+#include <DatabaseAbstractions/SnapshotCodec.hpp>
+#include <gtest/gtest.h>
+#include <memory>
+#include <stdint.h>
+#include <string>
+
+using namespace DatabaseAbstractions;
+
+namespace {
+
+    /**
+     * This is a snapshot writer which collects the chunks written to it.
+     */
+    struct CollectingWriter
+        : public SnapshotWriter
+    {
+        Blob snapshot;
+        size_t chunks = 0;
+        bool finished = false;
+
+        virtual std::string WriteChunk(BlobView chunk) override {
+            snapshot.insert(snapshot.end(), chunk.data, chunk.data + chunk.size);
+            ++chunks;
+            return "";
+        }
+
+        virtual std::string Finish() override {
+            finished = true;
+            return "";
+        }
+    };
+
+    /**
+     * This is a codec used to test registering codecs.  It "compresses"
+     * data by dropping every other byte, which only works for data
+     * in which each byte is repeated.
+     */
+    struct HalvingCodec
+        : public SnapshotCodec
+    {
+        virtual uint8_t GetId() const override {
+            return 200;
+        }
+
+        virtual size_t GetMaxExpansion() const override {
+            return 2;
+        }
+
+        virtual void Compress(
+            BlobView input,
+            Blob& output
+        ) const override {
+            output.clear();
+            for (size_t i = 0; i < input.size; i += 2) {
+                output.push_back(input.data[i]);
+            }
+        }
+
+        virtual bool Decompress(
+            BlobView input,
+            uint8_t* output,
+            size_t size
+        ) const override {
+            if (input.size * 2 != size) {
+                return false;
+            }
+            for (size_t i = 0; i < size; ++i) {
+                output[i] = input.data[i / 2];
+            }
+            return true;
+        }
+    };
+
+    /**
+     * This makes data which compresses well.
+     *
+     * @param[in] size
+     *     This is the number of bytes to make.
+     *
+     * @return
+     *     The data is returned.
+     */
+    Blob MakeCompressible(size_t size) {
+        Blob data;
+        data.reserve(size);
+        const std::string words[] = {"alpha ", "bravo ", "charlie ", "delta "};
+        for (size_t i = 0; data.size() < size; ++i) {
+            const auto& word = words[(i * 7 + i / 3) % 4];
+            data.insert(data.end(), word.begin(), word.end());
+        }
+        data.resize(size);
+        return data;
+    }
+
+    /**
+     * This makes data which doesn't compress.
+     *
+     * @param[in] size
+     *     This is the number of bytes to make.
+     *
+     * @return
+     *     The data is returned.
+     */
+    Blob MakeRandom(size_t size) {
+        Blob data(size);
+        uint32_t state = 12345;
+        for (auto& byte: data) {
+            state = state * 1103515245 + 12345;
+            byte = (uint8_t)(state >> 24);
+        }
+        return data;
+    }
+
+}
+
+/**
+ * This is the test fixture for these tests, providing common
+ * setup and teardown for each test.
+ */
+struct SnapshotCodecTests
+    : public ::testing::Test
+{
+    // Properties
+
+    std::shared_ptr< const SnapshotCodec > lz = GetSnapshotCodec(SNAPSHOT_CODEC_LZ);
+};
+
+TEST_F(SnapshotCodecTests, Built_In_Codecs_Registered) {
+    // Arrange
+
+    // Act
+    const auto none = GetSnapshotCodec(SNAPSHOT_CODEC_NONE);
+    const auto unknown = GetSnapshotCodec(123);
+
+    // Assert
+    ASSERT_FALSE(none == nullptr);
+    EXPECT_EQ(SNAPSHOT_CODEC_NONE, none->GetId());
+    ASSERT_FALSE(lz == nullptr);
+    EXPECT_EQ(SNAPSHOT_CODEC_LZ, lz->GetId());
+    EXPECT_TRUE(unknown == nullptr);
+}
+
+TEST_F(SnapshotCodecTests, Lz_Round_Trip_Various_Sizes) {
+    for (size_t size: {0, 1, 3, 4, 5, 15, 16, 19, 100, 1000, 70000}) {
+        // Arrange
+        const auto data = MakeCompressible(size);
+        Blob compressed;
+
+        // Act
+        lz->Compress(data, compressed);
+        Blob decompressed(size);
+        const auto ok = lz->Decompress(compressed, decompressed.data(), size);
+
+        // Assert
+        EXPECT_TRUE(ok) << size;
+        EXPECT_EQ(data, decompressed) << size;
+    }
+}
+
+TEST_F(SnapshotCodecTests, Lz_Compresses_Repetitive_Data) {
+    // Arrange
+    const auto data = MakeCompressible(100000);
+    const Blob run(5000, 'x');
+    Blob compressed;
+    Blob compressedRun;
+
+    // Act
+    lz->Compress(data, compressed);
+    lz->Compress(run, compressedRun);
+
+    // Assert
+    EXPECT_LT(compressed.size(), data.size() / 3);
+    EXPECT_LT(compressedRun.size(), 50);
+    Blob decompressedRun(run.size());
+    EXPECT_TRUE(lz->Decompress(compressedRun, decompressedRun.data(), run.size()));
+    EXPECT_EQ(run, decompressedRun);
+}
+
+TEST_F(SnapshotCodecTests, Lz_Rejects_Corrupt_Data) {
+    // Arrange
+    const auto data = MakeCompressible(1000);
+    Blob compressed;
+    lz->Compress(data, compressed);
+    Blob decompressed(data.size());
+
+    // Act
+    const auto wrongSize = lz->Decompress(compressed, decompressed.data(), data.size() - 1);
+    const auto truncated = lz->Decompress(
+        BlobView(compressed.data(), compressed.size() / 2),
+        decompressed.data(),
+        data.size()
+    );
+
+    // Assert
+    EXPECT_FALSE(wrongSize);
+    EXPECT_FALSE(truncated);
+}
+
+TEST_F(SnapshotCodecTests, Compress_Snapshot_Round_Trip) {
+    // Arrange
+    const auto snapshot = MakeCompressible(100000);
+
+    // Act
+    const auto frame = CompressSnapshot(snapshot, *lz, 4096);
+    Blob decompressed;
+    const auto error = DecompressSnapshot(frame, decompressed);
+
+    // Assert
+    EXPECT_TRUE(IsSnapshotFrame(frame));
+    EXPECT_FALSE(IsSnapshotFrame(snapshot));
+    EXPECT_LT(frame.size(), snapshot.size() / 3);
+    EXPECT_EQ("", error);
+    EXPECT_EQ(snapshot, decompressed);
+}
+
+TEST_F(SnapshotCodecTests, Empty_Snapshot_Round_Trip) {
+    // Arrange
+    const Blob snapshot;
+
+    // Act
+    const auto frame = CompressSnapshot(snapshot, *lz);
+    Blob decompressed{1, 2, 3};
+    const auto error = DecompressSnapshot(frame, decompressed);
+
+    // Assert
+    EXPECT_EQ(SNAPSHOT_FRAME_HEADER_SIZE + SNAPSHOT_FRAME_BLOCK_HEADER_SIZE, frame.size());
+    EXPECT_EQ("", error);
+    EXPECT_TRUE(decompressed.empty());
+}
+
+TEST_F(SnapshotCodecTests, Incompressible_Blocks_Stored) {
+    // Arrange
+    const auto snapshot = MakeRandom(10000);
+
+    // Act
+    const auto frame = CompressSnapshot(snapshot, *lz, 1000);
+    Blob decompressed;
+    const auto error = DecompressSnapshot(frame, decompressed);
+
+    // Assert
+    EXPECT_EQ(
+        SNAPSHOT_FRAME_HEADER_SIZE + 11 * SNAPSHOT_FRAME_BLOCK_HEADER_SIZE + snapshot.size(),
+        frame.size()
+    );
+    EXPECT_EQ("", error);
+    EXPECT_EQ(snapshot, decompressed);
+}
+
+TEST_F(SnapshotCodecTests, Parallel_Compression_Matches_Serial) {
+    // Arrange
+    const auto snapshot = MakeCompressible(200000);
+    WorkerPool pool(4);
+
+    // Act
+    const auto serial = CompressSnapshot(snapshot, *lz, 8192);
+    const auto parallel = CompressSnapshot(snapshot, *lz, 8192, &pool);
+    Blob decompressed;
+    const auto error = DecompressSnapshot(parallel, decompressed, &pool);
+
+    // Assert
+    EXPECT_EQ(serial, parallel);
+    EXPECT_EQ("", error);
+    EXPECT_EQ(snapshot, decompressed);
+}
+
+TEST_F(SnapshotCodecTests, Corrupt_Block_Reported) {
+    // Arrange
+    const auto snapshot = MakeCompressible(4096 * 3);
+    auto frame = CompressSnapshot(snapshot, *lz, 4096);
+    Blob firstBlock;
+    lz->Compress(BlobView(snapshot.data(), 4096), firstBlock);
+    const auto secondBlockData = (
+        SNAPSHOT_FRAME_HEADER_SIZE
+        + 2 * SNAPSHOT_FRAME_BLOCK_HEADER_SIZE
+        + firstBlock.size()
+    );
+    frame[secondBlockData] = 0xFF;
+
+    // Act
+    Blob decompressed;
+    const auto error = DecompressSnapshot(frame, decompressed);
+
+    // Assert
+    EXPECT_EQ("corrupt block 1 in snapshot frame", error);
+}
+
+TEST_F(SnapshotCodecTests, Malformed_Frames_Rejected) {
+    // Arrange
+    const auto snapshot = MakeCompressible(10000);
+    const auto frame = CompressSnapshot(snapshot, *lz, 4096);
+    auto unknownCodec = frame;
+    unknownCodec[5] = 123;
+    const Blob truncated(frame.begin(), frame.end() - 1);
+    auto extra = frame;
+    extra.push_back(0);
+    Blob decompressed;
+
+    // Act
+    const auto notFrameError = DecompressSnapshot(snapshot, decompressed);
+    const auto unknownCodecError = DecompressSnapshot(unknownCodec, decompressed);
+    const auto truncatedError = DecompressSnapshot(truncated, decompressed);
+    const auto extraError = DecompressSnapshot(extra, decompressed);
+
+    // Assert
+    EXPECT_EQ("not a snapshot frame", notFrameError);
+    EXPECT_EQ("unknown snapshot codec", unknownCodecError);
+    EXPECT_EQ("truncated snapshot frame", truncatedError);
+    EXPECT_EQ("extra data after end of snapshot frame", extraError);
+}
+
+TEST_F(SnapshotCodecTests, Block_Claiming_Too_Much_Data_Rejected) {
+    // Arrange
+    const auto snapshot = MakeCompressible(4096);
+    auto frame = CompressSnapshot(snapshot, *lz, 0x40000000);
+    const auto block = frame.data() + SNAPSHOT_FRAME_HEADER_SIZE;
+    const uint32_t claimedSize = 0x40000000;
+    const uint32_t storedSize = (
+        (uint32_t)block[4]
+        | ((uint32_t)block[5] << 8)
+        | ((uint32_t)block[6] << 16)
+        | ((uint32_t)block[7] << 24)
+    );
+    ASSERT_LT(storedSize, (uint32_t)snapshot.size());
+    for (size_t i = 0; i < 4; ++i) {
+        block[i] = (uint8_t)(claimedSize >> (i * 8));
+    }
+    const auto checksum = Crc32c(
+        block + SNAPSHOT_FRAME_BLOCK_HEADER_SIZE,
+        storedSize,
+        Crc32c(block, 8)
+    );
+    for (size_t i = 0; i < 4; ++i) {
+        block[8 + i] = (uint8_t)(checksum >> (i * 8));
+    }
+    const auto collector = std::make_shared< CollectingWriter >();
+    DecompressingSnapshotWriter writer(collector);
+
+    // Act
+    Blob decompressed;
+    const auto error = DecompressSnapshot(frame, decompressed);
+    const auto writerError = writer.WriteChunk(frame);
+
+    // Assert
+    EXPECT_EQ("invalid snapshot frame block", error);
+    EXPECT_TRUE(decompressed.empty());
+    EXPECT_EQ("invalid snapshot frame block", writerError);
+    EXPECT_TRUE(collector->snapshot.empty());
+}
+
+TEST_F(SnapshotCodecTests, Registered_Codec_Found_By_Frame) {
+    // Arrange
+    RegisterSnapshotCodec(std::make_shared< HalvingCodec >());
+    Blob snapshot;
+    for (size_t i = 0; i < 1000; ++i) {
+        snapshot.push_back((uint8_t)(i / 2 * 37));
+    }
+    const auto codec = GetSnapshotCodec(200);
+    ASSERT_FALSE(codec == nullptr);
+
+    // Act
+    const auto frame = CompressSnapshot(snapshot, *codec, 100);
+    Blob decompressed;
+    const auto error = DecompressSnapshot(frame, decompressed);
+
+    // Assert
+    EXPECT_EQ(200, frame[5]);
+    EXPECT_EQ("", error);
+    EXPECT_EQ(snapshot, decompressed);
+}
+
+TEST_F(SnapshotCodecTests, Chunked_Round_Trip) {
+    // Arrange
+    const auto snapshot = MakeCompressible(50000);
+    const auto pool = std::make_shared< WorkerPool >(3);
+    CompressingSnapshotReader reader(
+        std::make_shared< BlobSnapshotReader >(Blob(snapshot), 777),
+        100,
+        lz,
+        1024,
+        pool
+    );
+    const auto collector = std::make_shared< CollectingWriter >();
+    DecompressingSnapshotWriter writer(collector, pool);
+    Blob frame;
+
+    // Act
+    Blob chunk;
+    for (;;) {
+        const auto results = reader.ReadChunk(chunk);
+        ASSERT_EQ("", results.error);
+        if (results.done) {
+            break;
+        }
+        EXPECT_LE(chunk.size(), 100);
+        frame.insert(frame.end(), chunk.begin(), chunk.end());
+        ASSERT_EQ("", writer.WriteChunk(chunk));
+    }
+    const auto error = writer.Finish();
+
+    // Assert
+    EXPECT_EQ("", error);
+    EXPECT_TRUE(collector->finished);
+    EXPECT_GT(collector->chunks, 1);
+    EXPECT_EQ(snapshot, collector->snapshot);
+    EXPECT_EQ(CompressSnapshot(snapshot, *lz, 1024), frame);
+}
+
+TEST_F(SnapshotCodecTests, Writer_Passes_Raw_Snapshot_Through) {
+    // Arrange
+    const auto snapshot = MakeCompressible(1000);
+    const auto collector = std::make_shared< CollectingWriter >();
+    DecompressingSnapshotWriter writer(collector);
+
+    // Act
+    EXPECT_EQ("", writer.WriteChunk(BlobView(snapshot.data(), 2)));
+    EXPECT_EQ("", writer.WriteChunk(BlobView(snapshot.data() + 2, snapshot.size() - 2)));
+    const auto error = writer.Finish();
+
+    // Assert
+    EXPECT_EQ("", error);
+    EXPECT_EQ(snapshot, collector->snapshot);
+}
+
+TEST_F(SnapshotCodecTests, Writer_Rejects_Truncated_Frame) {
+    // Arrange
+    const auto snapshot = MakeCompressible(10000);
+    const auto frame = CompressSnapshot(snapshot, *lz, 1024);
+    const auto collector = std::make_shared< CollectingWriter >();
+    DecompressingSnapshotWriter writer(collector);
+
+    // Act
+    EXPECT_EQ("", writer.WriteChunk(BlobView(frame.data(), frame.size() - 4)));
+    const auto error = writer.Finish();
+
+    // Assert
+    EXPECT_EQ("truncated snapshot frame", error);
+    EXPECT_FALSE(collector->finished);
+}
+
+TEST_F(SnapshotCodecTests, Writer_Rejects_Chunk_After_Frame_End) {
+    // Arrange
+    const auto snapshot = MakeCompressible(10000);
+    const auto frame = CompressSnapshot(snapshot, *lz, 1024);
+    const auto collector = std::make_shared< CollectingWriter >();
+    DecompressingSnapshotWriter writer(collector);
+    ASSERT_EQ("", writer.WriteChunk(frame));
+
+    // Act
+    const auto extraError = writer.WriteChunk(BlobView(frame.data(), 3));
+    const auto emptyError = writer.WriteChunk(BlobView());
+    const auto error = writer.Finish();
+
+    // Assert
+    EXPECT_EQ("extra data after end of snapshot frame", extraError);
+    EXPECT_EQ("", emptyError);
+    EXPECT_EQ(frame.size(), writer.GetResumeOffset());
+    EXPECT_EQ("", error);
+    EXPECT_TRUE(collector->finished);
+    EXPECT_EQ(snapshot, collector->snapshot);
+}
+
+TEST_F(SnapshotCodecTests, Verify_Intact_Frame) {
+    // Arrange
+    const auto snapshot = MakeCompressible(20000);
+    const auto frame = CompressSnapshot(snapshot, *lz, 1000);
+    WorkerPool pool(4);
+
+    // Act
+    const auto verification = VerifySnapshotFrame(frame, &pool);
+
+    // Assert
+    EXPECT_EQ("", verification.error);
+    EXPECT_EQ(20, verification.intactBlocks);
+    EXPECT_EQ(frame.size(), verification.intactBytes);
+}
+
+TEST_F(SnapshotCodecTests, Verify_Finds_First_Corrupt_Block) {
+    // Arrange
+    const auto snapshot = MakeRandom(10000);
+    auto frame = CompressSnapshot(snapshot, *lz, 1000);
+    const auto blockSpan = SNAPSHOT_FRAME_BLOCK_HEADER_SIZE + 1000;
+    const auto thirdBlock = SNAPSHOT_FRAME_HEADER_SIZE + 2 * blockSpan;
+    frame[thirdBlock + SNAPSHOT_FRAME_BLOCK_HEADER_SIZE + 500] ^= 0x01;
+    frame[thirdBlock + 3 * blockSpan + SNAPSHOT_FRAME_BLOCK_HEADER_SIZE] ^= 0x01;
+    WorkerPool pool(4);
+
+    // Act
+    const auto verification = VerifySnapshotFrame(frame, &pool);
+    Blob decompressed;
+    const auto decompressError = DecompressSnapshot(frame, decompressed, &pool);
+
+    // Assert
+    EXPECT_EQ("corrupt block 2 in snapshot frame", verification.error);
+    EXPECT_EQ(2, verification.intactBlocks);
+    EXPECT_EQ(thirdBlock, verification.intactBytes);
+    EXPECT_EQ("corrupt block 2 in snapshot frame", decompressError);
+}
+
+TEST_F(SnapshotCodecTests, Verify_Truncated_Frame) {
+    // Arrange
+    const auto snapshot = MakeRandom(10000);
+    const auto frame = CompressSnapshot(snapshot, *lz, 1000);
+    const auto blockSpan = SNAPSHOT_FRAME_BLOCK_HEADER_SIZE + 1000;
+    const Blob truncated(frame.begin(), frame.begin() + SNAPSHOT_FRAME_HEADER_SIZE + 4 * blockSpan + 10);
+
+    // Act
+    const auto verification = VerifySnapshotFrame(truncated);
+
+    // Assert
+    EXPECT_EQ("truncated snapshot frame", verification.error);
+    EXPECT_EQ(4, verification.intactBlocks);
+    EXPECT_EQ(SNAPSHOT_FRAME_HEADER_SIZE + 4 * blockSpan, verification.intactBytes);
+}
+
+TEST_F(SnapshotCodecTests, Writer_Resumes_From_Corrupt_Block) {
+    // Arrange
+    const auto snapshot = MakeCompressible(30000);
+    const auto frame = CompressSnapshot(snapshot, *lz, 2048);
+    auto corrupted = frame;
+    corrupted[frame.size() / 2] ^= 0x80;
+    const auto collector = std::make_shared< CollectingWriter >();
+    DecompressingSnapshotWriter writer(collector, std::make_shared< WorkerPool >(2));
+
+    // Act
+    std::string firstError;
+    for (size_t offset = 0; offset < corrupted.size(); offset += 1000) {
+        firstError = writer.WriteChunk(
+            BlobView(
+                corrupted.data() + offset,
+                std::min((size_t)1000, corrupted.size() - offset)
+            )
+        );
+        if (!firstError.empty()) {
+            break;
+        }
+    }
+    const auto resumeOffset = writer.GetResumeOffset();
+    const auto resumeError = writer.WriteChunk(
+        BlobView(frame.data() + resumeOffset, frame.size() - resumeOffset)
+    );
+    const auto finishError = writer.Finish();
+
+    // Assert
+    EXPECT_EQ(0, firstError.find("corrupt block "));
+    EXPECT_GT(resumeOffset, 0);
+    EXPECT_LE(resumeOffset, frame.size() / 2);
+    EXPECT_EQ("", resumeError);
+    EXPECT_EQ("", finishError);
+    EXPECT_EQ(snapshot, collector->snapshot);
+}
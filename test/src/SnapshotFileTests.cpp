@@ -0,0 +1,279 @@
+/**
+ * @file SnapshotFileTests.cpp
+ *
+ * This module contains unit tests of the functions which store
+ * database snapshots in files and install them from files.
+ */
+
+#include <DatabaseAbstractions/InMemoryDatabase.hpp>
+#include <DatabaseAbstractions/SnapshotFile.hpp>
+#include <gtest/gtest.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+using namespace DatabaseAbstractions;
+
+namespace {
+
+    /**
+     * This is a fake database which only supports whole snapshots.
+     */
+    struct MockDatabase
+        : public Database
+    {
+        // Properties
+
+        Blob snapshot;
+        std::vector< Blob > installedSnapshots;
+
+        // Database
+
+        virtual BuildStatementResults BuildStatement(
+            const std::string& statement
+        ) override {
+            return BuildStatementResults();
+        }
+
+        virtual std::string ExecuteStatement(const std::string& statement) override {
+            return "";
+        }
+
+        virtual Blob CreateSnapshot() override {
+            return snapshot;
+        }
+
+        virtual std::string InstallSnapshot(const Blob& blob) override {
+            installedSnapshots.push_back(blob);
+            return "";
+        }
+    };
+
+    /**
+     * This reads the complete contents of the given file.
+     *
+     * @param[in] path
+     *     This is the path of the file to read.
+     *
+     * @return
+     *     The contents of the file are returned.
+     */
+    Blob ReadFile(const std::string& path) {
+        Blob contents;
+        const auto file = fopen(path.c_str(), "rb");
+        if (file == NULL) {
+            return contents;
+        }
+        uint8_t buffer[4096];
+        size_t size;
+        while ((size = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+            contents.insert(contents.end(), buffer, buffer + size);
+        }
+        (void)fclose(file);
+        return contents;
+    }
+
+    /**
+     * This replaces the contents of the given file.
+     *
+     * @param[in] path
+     *     This is the path of the file to write.
+     *
+     * @param[in] contents
+     *     These are the new contents of the file.
+     */
+    void WriteFile(
+        const std::string& path,
+        const Blob& contents
+    ) {
+        const auto file = fopen(path.c_str(), "wb");
+        if (file == NULL) {
+            return;
+        }
+        (void)fwrite(contents.data(), 1, contents.size(), file);
+        (void)fclose(file);
+    }
+
+}
+
+/**
+ * This is the test fixture for these tests, providing common
+ * setup and teardown for each test.
+ */
+struct SnapshotFileTests
+    : public ::testing::Test
+{
+    // Properties
+
+    MockDatabase source;
+    MockDatabase destination;
+    std::string path;
+
+    // ::testing::Test
+
+    virtual void SetUp() override {
+        path = ::testing::TempDir() + "SnapshotFileTests.snapshot";
+        for (size_t i = 0; i < 3000000; ++i) {
+            source.snapshot.push_back((uint8_t)(i * 31));
+        }
+    }
+
+    virtual void TearDown() override {
+        (void)remove(path.c_str());
+    }
+};
+
+TEST_F(SnapshotFileTests, Create_And_Install_Snapshot_File) {
+    // Arrange
+    ASSERT_EQ("", CreateSnapshotFile(source, path, 42));
+
+    // Act
+    const auto error = InstallSnapshotFile(destination, path, 42);
+
+    // Assert
+    EXPECT_EQ("", error);
+    ASSERT_EQ((size_t)1, destination.installedSnapshots.size());
+    EXPECT_EQ(source.snapshot, destination.installedSnapshots[0]);
+}
+
+TEST_F(SnapshotFileTests, Read_Snapshot_File_Header) {
+    // Arrange
+    ASSERT_EQ("", CreateSnapshotFile(source, path, 42));
+    SnapshotFileHeader header;
+
+    // Act
+    const auto error = ReadSnapshotFileHeader(path, header);
+
+    // Assert
+    EXPECT_EQ("", error);
+    EXPECT_EQ(SNAPSHOT_FILE_VERSION, header.version);
+    EXPECT_EQ((uint64_t)42, header.schemaHash);
+    EXPECT_EQ((uint64_t)source.snapshot.size(), header.length);
+    EXPECT_EQ(
+        ReadFile(path).size(),
+        SNAPSHOT_FILE_HEADER_SIZE + source.snapshot.size()
+    );
+}
+
+TEST_F(SnapshotFileTests, Install_Rejects_Different_Schema) {
+    // Arrange
+    ASSERT_EQ("", CreateSnapshotFile(source, path, 42));
+
+    // Act
+    const auto error = InstallSnapshotFile(destination, path, 43);
+
+    // Assert
+    EXPECT_NE("", error);
+    EXPECT_TRUE(destination.installedSnapshots.empty());
+}
+
+TEST_F(SnapshotFileTests, Install_Rejects_Corrupt_Snapshot) {
+    // Arrange
+    ASSERT_EQ("", CreateSnapshotFile(source, path, 42));
+    auto contents = ReadFile(path);
+    contents[SNAPSHOT_FILE_HEADER_SIZE + 12345] ^= 0x01;
+    WriteFile(path, contents);
+
+    // Act
+    const auto error = InstallSnapshotFile(destination, path, 42);
+
+    // Assert
+    EXPECT_EQ("snapshot file is corrupt", error);
+    EXPECT_TRUE(destination.installedSnapshots.empty());
+}
+
+TEST_F(SnapshotFileTests, Install_Rejects_Corrupt_Header) {
+    // Arrange
+    ASSERT_EQ("", CreateSnapshotFile(source, path, 42));
+    auto contents = ReadFile(path);
+    contents[24] ^= 0x01;
+    WriteFile(path, contents);
+
+    // Act
+    const auto error = InstallSnapshotFile(destination, path, 42);
+
+    // Assert
+    EXPECT_EQ("snapshot file header is corrupt", error);
+    EXPECT_TRUE(destination.installedSnapshots.empty());
+}
+
+TEST_F(SnapshotFileTests, Install_Rejects_Truncated_Snapshot) {
+    // Arrange
+    ASSERT_EQ("", CreateSnapshotFile(source, path, 42));
+    auto contents = ReadFile(path);
+    contents.resize(contents.size() - 1);
+    WriteFile(path, contents);
+
+    // Act
+    const auto error = InstallSnapshotFile(destination, path, 42);
+
+    // Assert
+    EXPECT_NE("", error);
+    EXPECT_TRUE(destination.installedSnapshots.empty());
+}
+
+TEST_F(SnapshotFileTests, Install_Rejects_Missing_File) {
+    // Arrange
+
+    // Act
+    const auto error = InstallSnapshotFile(destination, path, 42);
+
+    // Assert
+    EXPECT_NE("", error);
+    EXPECT_TRUE(destination.installedSnapshots.empty());
+}
+
+TEST_F(SnapshotFileTests, Create_And_Install_Empty_Snapshot) {
+    // Arrange
+    source.snapshot.clear();
+    ASSERT_EQ("", CreateSnapshotFile(source, path, 42));
+
+    // Act
+    const auto error = InstallSnapshotFile(destination, path, 42);
+
+    // Assert
+    EXPECT_EQ("", error);
+    ASSERT_EQ((size_t)1, destination.installedSnapshots.size());
+    EXPECT_TRUE(destination.installedSnapshots[0].empty());
+}
+
+TEST_F(SnapshotFileTests, Create_Leaves_Other_Temporary_Files_Alone) {
+    // Arrange
+    const auto otherPath = path + ".tmp";
+    const Blob other{1, 2, 3};
+    WriteFile(otherPath, other);
+
+    // Act
+    const auto error = CreateSnapshotFile(source, path, 42);
+
+    // Assert
+    EXPECT_EQ("", error);
+    EXPECT_EQ(other, ReadFile(otherPath));
+    EXPECT_EQ(
+        ReadFile(path).size(),
+        SNAPSHOT_FILE_HEADER_SIZE + source.snapshot.size()
+    );
+    (void)remove(otherPath.c_str());
+}
+
+TEST_F(SnapshotFileTests, Install_Into_In_Memory_Database) {
+    // Arrange
+    InMemoryDatabase original;
+    ASSERT_EQ(
+        "",
+        original.ExecuteStatement(
+            "CREATE TABLE t (a INTEGER PRIMARY KEY, b TEXT);"
+            "INSERT INTO t (b) VALUES ('x'), ('y'), ('z');"
+        )
+    );
+    ASSERT_EQ("", CreateSnapshotFile(original, path, 42));
+    InMemoryDatabase copy;
+
+    // Act
+    const auto error = InstallSnapshotFile(copy, path, 42);
+
+    // Assert
+    EXPECT_EQ("", error);
+    EXPECT_EQ(original.GetSnapshotId(), copy.GetSnapshotId());
+    EXPECT_EQ(original.CreateSnapshot(), copy.CreateSnapshot());
+}
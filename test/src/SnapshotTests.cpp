@@ -0,0 +1,63 @@
+/**
+ * @file SnapshotTests.cpp
+ *
+ * This module contains unit tests of the
+ * DatabaseAbstractions::BlobSnapshotReader class.
+ */
+
+#include <DatabaseAbstractions/Snapshot.hpp>
+#include <gtest/gtest.h>
+#include <vector>
+
+using namespace DatabaseAbstractions;
+
+/**
+ * This is the test fixture for these tests, providing common
+ * setup and teardown for each test.
+ */
+struct SnapshotTests
+    : public ::testing::Test
+{
+};
+
+TEST_F(SnapshotTests, Blob_Snapshot_Reader_Produces_Chunks) {
+    // Arrange
+    BlobSnapshotReader reader(Blob({1, 2, 3, 4, 5, 6, 7}), 3);
+    std::vector< Blob > chunks;
+    Blob chunk;
+
+    // Act
+    ReadSnapshotChunkResults results;
+    for (;;) {
+        results = reader.ReadChunk(chunk);
+        if (results.done || !results.error.empty()) {
+            break;
+        }
+        chunks.push_back(chunk);
+    }
+
+    // Assert
+    EXPECT_TRUE(results.error.empty());
+    EXPECT_TRUE(chunk.empty());
+    EXPECT_EQ(
+        std::vector< Blob >({
+            {1, 2, 3},
+            {4, 5, 6},
+            {7},
+        }),
+        chunks
+    );
+}
+
+TEST_F(SnapshotTests, Blob_Snapshot_Reader_Empty_Snapshot) {
+    // Arrange
+    BlobSnapshotReader reader(Blob(), 3);
+    Blob chunk;
+
+    // Act
+    const auto results = reader.ReadChunk(chunk);
+
+    // Assert
+    EXPECT_TRUE(results.done);
+    EXPECT_TRUE(chunk.empty());
+}
@@ -0,0 +1,212 @@
+/**
+ * @file StatementCacheTests.cpp
+ *
+ * This module contains unit tests of the
+ * DatabaseAbstractions::StatementCache class.
+ */
+
+#include <DatabaseAbstractions/StatementCache.hpp>
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+using namespace DatabaseAbstractions;
+
+namespace {
+
+    /**
+     * This is a fake prepared statement which remembers the SQL text
+     * it was built from and counts how many times it's reset.
+     */
+    struct MockStatement
+        : public PreparedStatement
+    {
+        // Properties
+
+        std::string text;
+        size_t resets = 0;
+
+        // PreparedStatement
+
+        virtual void BindParameter(
+            int index,
+            const Value& value
+        ) override {
+        }
+
+        virtual void BindParameters(std::initializer_list< const Value > values) override {
+        }
+
+        virtual Value FetchColumn(int index, Value::Type type) override {
+            return Value();
+        }
+
+        virtual void Reset() override {
+            ++resets;
+        }
+
+        virtual StepStatementResults Step() override {
+            StepStatementResults results;
+            results.done = true;
+            return results;
+        }
+    };
+
+    /**
+     * This is a fake database which counts how many statements
+     * it builds.
+     */
+    struct MockDatabase
+        : public Database
+    {
+        // Properties
+
+        std::vector< std::string > statementsBuilt;
+        size_t snapshotsInstalled = 0;
+
+        // Database
+
+        virtual BuildStatementResults BuildStatement(
+            const std::string& statement
+        ) override {
+            statementsBuilt.push_back(statement);
+            BuildStatementResults results;
+            if (statement == "bad") {
+                results.error = "syntax error";
+            } else {
+                const auto mockStatement = std::make_shared< MockStatement >();
+                mockStatement->text = statement;
+                results.statement = mockStatement;
+            }
+            return results;
+        }
+
+        virtual std::string ExecuteStatement(const std::string& statement) override {
+            return "";
+        }
+
+        virtual Blob CreateSnapshot() override {
+            return Blob();
+        }
+
+        virtual std::string InstallSnapshot(const Blob& blob) override {
+            ++snapshotsInstalled;
+            return "";
+        }
+    };
+
+}
+
+/**
+ * This is the test fixture for these tests, providing common
+ * setup and teardown for each test.
+ */
+struct StatementCacheTests
+    : public ::testing::Test
+{
+    // Properties
+
+    std::shared_ptr< MockDatabase > database = std::make_shared< MockDatabase >();
+    StatementCache cache{database, 2};
+};
+
+TEST_F(StatementCacheTests, Repeated_Statement_Is_Reused_And_Reset) {
+    // Arrange
+    auto first = cache.BuildStatement("SELECT 1").statement;
+    const auto firstRaw = first.get();
+    first = nullptr;
+
+    // Act
+    const auto second = cache.BuildStatement("SELECT 1").statement;
+
+    // Assert
+    EXPECT_EQ(firstRaw, second.get());
+    EXPECT_EQ((size_t)1, std::static_pointer_cast< MockStatement >(second)->resets);
+    EXPECT_EQ(std::vector< std::string >({"SELECT 1"}), database->statementsBuilt);
+    const auto statistics = cache.GetStatistics();
+    EXPECT_EQ((size_t)1, statistics.hits);
+    EXPECT_EQ((size_t)1, statistics.misses);
+    EXPECT_EQ((size_t)1, statistics.size);
+}
+
+TEST_F(StatementCacheTests, Statement_In_Use_Is_Not_Shared) {
+    // Arrange
+    const auto first = cache.BuildStatement("SELECT 1").statement;
+
+    // Act
+    const auto second = cache.BuildStatement("SELECT 1").statement;
+
+    // Assert
+    EXPECT_NE(first, second);
+    EXPECT_EQ((size_t)2, database->statementsBuilt.size());
+    EXPECT_EQ((size_t)0, cache.GetStatistics().hits);
+    EXPECT_EQ((size_t)2, cache.GetStatistics().misses);
+}
+
+TEST_F(StatementCacheTests, Least_Recently_Used_Statement_Is_Evicted) {
+    // Arrange
+    (void)cache.BuildStatement("SELECT 1");
+    (void)cache.BuildStatement("SELECT 2");
+    (void)cache.BuildStatement("SELECT 1");
+
+    // Act
+    (void)cache.BuildStatement("SELECT 3");
+    (void)cache.BuildStatement("SELECT 1");
+    (void)cache.BuildStatement("SELECT 2");
+
+    // Assert
+    EXPECT_EQ(
+        std::vector< std::string >({
+            "SELECT 1",
+            "SELECT 2",
+            "SELECT 3",
+            "SELECT 2",
+        }),
+        database->statementsBuilt
+    );
+    const auto statistics = cache.GetStatistics();
+    EXPECT_EQ((size_t)2, statistics.hits);
+    EXPECT_EQ((size_t)4, statistics.misses);
+    EXPECT_EQ((size_t)2, statistics.evictions);
+    EXPECT_EQ((size_t)2, statistics.size);
+}
+
+TEST_F(StatementCacheTests, Errors_Are_Not_Cached) {
+    // Arrange
+    (void)cache.BuildStatement("bad");
+
+    // Act
+    const auto results = cache.BuildStatement("bad");
+
+    // Assert
+    EXPECT_EQ("syntax error", results.error);
+    EXPECT_EQ((size_t)2, database->statementsBuilt.size());
+    EXPECT_EQ((size_t)0, cache.GetStatistics().size);
+}
+
+TEST_F(StatementCacheTests, Installing_Snapshot_Clears_Cache) {
+    // Arrange
+    (void)cache.BuildStatement("SELECT 1");
+
+    // Act
+    (void)cache.InstallSnapshot(Blob());
+    (void)cache.BuildStatement("SELECT 1");
+
+    // Assert
+    EXPECT_EQ((size_t)1, database->snapshotsInstalled);
+    EXPECT_EQ((size_t)2, database->statementsBuilt.size());
+}
+
+TEST_F(StatementCacheTests, Finishing_Snapshot_Writer_Clears_Cache) {
+    // Arrange
+    (void)cache.BuildStatement("SELECT 1");
+    const auto writer = cache.CreateSnapshotWriter();
+
+    // Act
+    (void)writer->Finish();
+    (void)cache.BuildStatement("SELECT 1");
+
+    // Assert
+    EXPECT_EQ((size_t)1, database->snapshotsInstalled);
+    EXPECT_EQ((size_t)2, database->statementsBuilt.size());
+}
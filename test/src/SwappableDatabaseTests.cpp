@@ -0,0 +1,364 @@
+/**
+ * @file SwappableDatabaseTests.cpp
+ *
+ * This module contains unit tests of the
+ * DatabaseAbstractions::SwappableDatabase class.
+ */
+
+#include <algorithm>
+#include <DatabaseAbstractions/InMemoryDatabase.hpp>
+#include <DatabaseAbstractions/SwappableDatabase.hpp>
+#include <future>
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace DatabaseAbstractions;
+
+namespace {
+
+    /**
+     * This is an in-memory database which can be made to fail
+     * to roll back transactions.
+     */
+    struct FailingRollbackDatabase
+        : public InMemoryDatabase
+    {
+        // Properties
+
+        std::string rollbackError;
+
+        // Database
+
+        virtual std::string RollbackTransaction() override {
+            if (!rollbackError.empty()) {
+                return rollbackError;
+            }
+            return InMemoryDatabase::RollbackTransaction();
+        }
+    };
+
+}
+
+/**
+ * This is the test fixture for these tests, providing common
+ * setup and teardown for each test.
+ */
+struct SwappableDatabaseTests
+    : public ::testing::Test
+{
+    // Properties
+
+    size_t databasesMade = 0;
+    SwappableDatabase database{
+        [this]{
+            ++databasesMade;
+            return std::make_shared< InMemoryDatabase >();
+        }
+    };
+    InMemoryDatabase leader;
+
+    // Methods
+
+    /**
+     * This runs the given query on the given database and returns the
+     * values of the first column of every row of the results, as text.
+     *
+     * @param[in] target
+     *     This is the database on which to run the query.
+     *
+     * @param[in] query
+     *     This is the query to run.
+     *
+     * @return
+     *     The values of the first column of the results are returned.
+     */
+    std::vector< std::string > Column(
+        Database& target,
+        const std::string& query
+    ) {
+        std::vector< std::string > values;
+        const auto built = target.BuildStatement(query);
+        EXPECT_EQ("", built.error);
+        if (built.statement == nullptr) {
+            return values;
+        }
+        for (;;) {
+            const auto results = built.statement->Step();
+            EXPECT_EQ("", results.error);
+            if (
+                results.done
+                || !results.error.empty()
+            ) {
+                break;
+            }
+            values.push_back(
+                (const std::string&)built.statement->FetchColumn(0, Value::Type::Text)
+            );
+        }
+        return values;
+    }
+
+    // ::testing::Test
+
+    virtual void SetUp() override {
+        ASSERT_EQ(
+            "",
+            database.ExecuteStatement(
+                "CREATE TABLE people (name TEXT);"
+                "INSERT INTO people VALUES ('alice'), ('bob');"
+            )
+        );
+        ASSERT_EQ(
+            "",
+            leader.ExecuteStatement(
+                "CREATE TABLE people (name TEXT);"
+                "INSERT INTO people VALUES ('carol'), ('dave'), ('erin');"
+            )
+        );
+    }
+};
+
+TEST_F(SwappableDatabaseTests, Statements_Built_On_Current_Database) {
+    // Arrange
+    const auto current = database.GetCurrent();
+
+    // Act
+    const auto names = Column(database, "SELECT name FROM people");
+
+    // Assert
+    EXPECT_EQ((size_t)1, databasesMade);
+    EXPECT_EQ((std::vector< std::string >{"alice", "bob"}), names);
+    EXPECT_EQ(
+        (std::vector< std::string >{"alice", "bob"}),
+        Column(*current, "SELECT name FROM people")
+    );
+}
+
+TEST_F(SwappableDatabaseTests, Install_Swaps_In_Shadow) {
+    // Arrange
+    const auto original = database.GetCurrent();
+
+    // Act
+    const auto error = database.InstallSnapshot(leader.CreateSnapshot());
+
+    // Assert
+    EXPECT_EQ("", error);
+    EXPECT_EQ((size_t)2, databasesMade);
+    EXPECT_EQ((size_t)1, database.GetSwapCount());
+    EXPECT_NE(original, database.GetCurrent());
+    EXPECT_EQ(leader.GetSnapshotId(), database.GetSnapshotId());
+    EXPECT_EQ(
+        (std::vector< std::string >{"carol", "dave", "erin"}),
+        Column(database, "SELECT name FROM people")
+    );
+    EXPECT_EQ(
+        (std::vector< std::string >{"alice", "bob"}),
+        Column(*original, "SELECT name FROM people")
+    );
+}
+
+TEST_F(SwappableDatabaseTests, Outstanding_Statement_Finishes_Against_Old_State) {
+    // Arrange
+    const auto built = database.BuildStatement("SELECT name FROM people");
+    ASSERT_EQ("", built.error);
+    ASSERT_FALSE(built.statement->Step().done);
+    const auto first = built.statement->FetchColumn(0, Value::Type::Text);
+    std::weak_ptr< Database > original = database.GetCurrent();
+
+    // Act
+    ASSERT_EQ("", database.InstallSnapshot(leader.CreateSnapshot()));
+    const auto heldAfterSwap = !original.expired();
+    ASSERT_FALSE(built.statement->Step().done);
+    const auto second = built.statement->FetchColumn(0, Value::Type::Text);
+    const auto last = built.statement->Step();
+    const auto newNames = Column(database, "SELECT name FROM people");
+
+    // Assert
+    EXPECT_EQ(Value("alice"), first);
+    EXPECT_EQ(Value("bob"), second);
+    EXPECT_TRUE(last.done);
+    EXPECT_TRUE(heldAfterSwap);
+    EXPECT_EQ((std::vector< std::string >{"carol", "dave", "erin"}), newNames);
+}
+
+TEST_F(SwappableDatabaseTests, Old_Database_Released_With_Last_Statement) {
+    // Arrange
+    auto built = database.BuildStatement("SELECT name FROM people");
+    ASSERT_EQ("", built.error);
+    std::weak_ptr< Database > original = database.GetCurrent();
+    ASSERT_EQ("", database.InstallSnapshot(leader.CreateSnapshot()));
+    ASSERT_FALSE(original.expired());
+
+    // Act
+    built.statement = nullptr;
+
+    // Assert
+    EXPECT_TRUE(original.expired());
+}
+
+TEST_F(SwappableDatabaseTests, Failed_Install_Keeps_Current_Database) {
+    // Arrange
+    const auto original = database.GetCurrent();
+
+    // Act
+    const auto error = database.InstallSnapshot({1, 2, 3});
+
+    // Assert
+    EXPECT_NE("", error);
+    EXPECT_EQ((size_t)0, database.GetSwapCount());
+    EXPECT_EQ(original, database.GetCurrent());
+    EXPECT_EQ(
+        (std::vector< std::string >{"alice", "bob"}),
+        Column(database, "SELECT name FROM people")
+    );
+}
+
+TEST_F(SwappableDatabaseTests, Install_Refused_During_Transaction) {
+    // Arrange
+    ASSERT_EQ("", database.BeginTransaction());
+    ASSERT_EQ("", database.ExecuteStatement("INSERT INTO people VALUES ('frank')"));
+
+    // Act
+    const auto error = database.InstallSnapshot(leader.CreateSnapshot());
+    const auto commitError = database.CommitTransaction();
+    const auto retryError = database.InstallSnapshot(leader.CreateSnapshot());
+
+    // Assert
+    EXPECT_EQ("cannot install a snapshot during a transaction", error);
+    EXPECT_EQ("", commitError);
+    EXPECT_EQ("", retryError);
+    EXPECT_EQ((size_t)1, database.GetSwapCount());
+}
+
+TEST_F(SwappableDatabaseTests, Install_Refused_During_Transaction_Begun_By_Statement) {
+    // Arrange
+    ASSERT_EQ("", database.ExecuteStatement("BEGIN"));
+
+    // Act
+    const auto executedError = database.InstallSnapshot(leader.CreateSnapshot());
+    ASSERT_EQ("", database.ExecuteStatement("COMMIT"));
+    const auto begin = database.BuildStatement("begin transaction");
+    ASSERT_EQ("", begin.error);
+    ASSERT_EQ("", begin.statement->Step().error);
+    const auto builtError = database.InstallSnapshot(leader.CreateSnapshot());
+    std::string endError = "not called";
+    database.ExecuteAsync(
+        "END",
+        [&](const std::string& error){
+            endError = error;
+        }
+    );
+    const auto retryError = database.InstallSnapshot(leader.CreateSnapshot());
+
+    // Assert
+    EXPECT_EQ("cannot install a snapshot during a transaction", executedError);
+    EXPECT_EQ("cannot install a snapshot during a transaction", builtError);
+    EXPECT_EQ("", endError);
+    EXPECT_EQ("", retryError);
+    EXPECT_EQ((size_t)1, database.GetSwapCount());
+}
+
+TEST_F(SwappableDatabaseTests, Failed_Rollback_Keeps_Install_Refused) {
+    // Arrange
+    std::shared_ptr< FailingRollbackDatabase > first;
+    SwappableDatabase failing(
+        [&first]() -> std::shared_ptr< Database > {
+            const auto made = std::make_shared< FailingRollbackDatabase >();
+            if (first == nullptr) {
+                first = made;
+            }
+            return made;
+        }
+    );
+    ASSERT_EQ("", failing.BeginTransaction());
+    first->rollbackError = "disk I/O error";
+
+    // Act
+    const auto rollbackError = failing.RollbackTransaction();
+    const auto installError = failing.InstallSnapshot(leader.CreateSnapshot());
+    first->rollbackError.clear();
+    const auto retryRollbackError = failing.RollbackTransaction();
+    const auto retryInstallError = failing.InstallSnapshot(leader.CreateSnapshot());
+
+    // Assert
+    EXPECT_EQ("disk I/O error", rollbackError);
+    EXPECT_EQ("cannot install a snapshot during a transaction", installError);
+    EXPECT_EQ("", retryRollbackError);
+    EXPECT_EQ("", retryInstallError);
+    EXPECT_EQ((size_t)1, failing.GetSwapCount());
+}
+
+TEST_F(SwappableDatabaseTests, Async_Install_Swaps_In_Shadow_In_Background) {
+    // Arrange
+    std::promise< std::string > installed;
+    auto installedFuture = installed.get_future();
+
+    // Act
+    database.InstallSnapshotAsync(
+        leader.CreateSnapshot(),
+        [&](const std::string& error){
+            installed.set_value(error);
+        }
+    );
+    const auto namesDuringInstall = Column(database, "SELECT name FROM people");
+    const auto error = installedFuture.get();
+
+    // Assert
+    EXPECT_EQ("", error);
+    EXPECT_TRUE(
+        (namesDuringInstall == std::vector< std::string >{"alice", "bob"})
+        || (namesDuringInstall == std::vector< std::string >{"carol", "dave", "erin"})
+    );
+    EXPECT_EQ((size_t)1, database.GetSwapCount());
+    EXPECT_EQ(
+        (std::vector< std::string >{"carol", "dave", "erin"}),
+        Column(database, "SELECT name FROM people")
+    );
+}
+
+TEST_F(SwappableDatabaseTests, Snapshot_Writer_Swaps_In_Shadow_On_Finish) {
+    // Arrange
+    const auto snapshot = leader.CreateSnapshot();
+    const auto writer = database.CreateSnapshotWriter();
+    for (size_t offset = 0; offset < snapshot.size(); offset += 7) {
+        const auto size = std::min((size_t)7, snapshot.size() - offset);
+        ASSERT_EQ("", writer->WriteChunk(BlobView(snapshot.data() + offset, size)));
+    }
+    const auto namesBeforeFinish = Column(database, "SELECT name FROM people");
+
+    // Act
+    const auto error = writer->Finish();
+
+    // Assert
+    EXPECT_EQ("", error);
+    EXPECT_EQ((std::vector< std::string >{"alice", "bob"}), namesBeforeFinish);
+    EXPECT_EQ((size_t)1, database.GetSwapCount());
+    EXPECT_EQ(
+        (std::vector< std::string >{"carol", "dave", "erin"}),
+        Column(database, "SELECT name FROM people")
+    );
+}
+
+TEST_F(SwappableDatabaseTests, Delta_Snapshot_Installed_In_Place) {
+    // Arrange
+    ASSERT_EQ("", database.InstallSnapshot(leader.CreateSnapshot()));
+    const auto swapped = database.GetCurrent();
+    const auto baseId = database.GetSnapshotId();
+    ASSERT_EQ("", leader.ExecuteStatement("INSERT INTO people VALUES ('frank')"));
+    const auto delta = leader.CreateDeltaSnapshot(baseId);
+    ASSERT_FALSE(delta.full);
+
+    // Act
+    const auto error = database.InstallDeltaSnapshot(delta);
+
+    // Assert
+    EXPECT_EQ("", error);
+    EXPECT_EQ((size_t)1, database.GetSwapCount());
+    EXPECT_EQ(swapped, database.GetCurrent());
+    EXPECT_EQ(
+        (std::vector< std::string >{"carol", "dave", "erin", "frank"}),
+        Column(database, "SELECT name FROM people")
+    );
+}
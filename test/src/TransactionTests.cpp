@@ -0,0 +1,152 @@
+/**
+ * @file TransactionTests.cpp
+ *
+ * This module contains unit tests of the
+ * DatabaseAbstractions::Transaction class.
+ */
+
+#include <DatabaseAbstractions/Transaction.hpp>
+#include <gtest/gtest.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace DatabaseAbstractions;
+
+namespace {
+
+    /**
+     * This is a fake database which records the transaction methods
+     * called on it.
+     */
+    struct MockDatabase
+        : public Database
+    {
+        // Properties
+
+        std::vector< std::string > calls;
+        std::string beginError;
+        std::string commitError;
+
+        // Database
+
+        virtual BuildStatementResults BuildStatement(
+            const std::string& statement
+        ) override {
+            return BuildStatementResults();
+        }
+
+        virtual std::string ExecuteStatement(const std::string& statement) override {
+            return "";
+        }
+
+        virtual std::string BeginTransaction() override {
+            calls.push_back("begin");
+            return beginError;
+        }
+
+        virtual std::string CommitTransaction() override {
+            calls.push_back("commit");
+            return commitError;
+        }
+
+        virtual std::string RollbackTransaction() override {
+            calls.push_back("rollback");
+            return "";
+        }
+
+        virtual Blob CreateSnapshot() override {
+            return Blob();
+        }
+
+        virtual std::string InstallSnapshot(const Blob& blob) override {
+            return "";
+        }
+    };
+
+}
+
+/**
+ * This is the test fixture for these tests, providing common
+ * setup and teardown for each test.
+ */
+struct TransactionTests
+    : public ::testing::Test
+{
+    // Properties
+
+    MockDatabase database;
+};
+
+TEST_F(TransactionTests, Rolls_Back_If_Not_Committed) {
+    // Arrange
+
+    // Act
+    {
+        Transaction transaction(database);
+        EXPECT_TRUE(transaction.IsOpen());
+    }
+
+    // Assert
+    EXPECT_EQ(std::vector< std::string >({"begin", "rollback"}), database.calls);
+}
+
+TEST_F(TransactionTests, Commit_Closes_Transaction) {
+    // Arrange
+
+    // Act
+    {
+        Transaction transaction(database);
+        EXPECT_EQ("", transaction.Commit());
+        EXPECT_FALSE(transaction.IsOpen());
+    }
+
+    // Assert
+    EXPECT_EQ(std::vector< std::string >({"begin", "commit"}), database.calls);
+}
+
+TEST_F(TransactionTests, Failed_Commit_Is_Rolled_Back) {
+    // Arrange
+    database.commitError = "disk full";
+
+    // Act
+    {
+        Transaction transaction(database);
+        EXPECT_EQ("disk full", transaction.Commit());
+        EXPECT_TRUE(transaction.IsOpen());
+    }
+
+    // Assert
+    EXPECT_EQ(std::vector< std::string >({"begin", "commit", "rollback"}), database.calls);
+}
+
+TEST_F(TransactionTests, Failed_Begin_Is_Not_Rolled_Back) {
+    // Arrange
+    database.beginError = "busy";
+
+    // Act
+    {
+        Transaction transaction(database);
+        EXPECT_EQ("busy", transaction.GetError());
+        EXPECT_FALSE(transaction.IsOpen());
+        EXPECT_NE("", transaction.Commit());
+    }
+
+    // Assert
+    EXPECT_EQ(std::vector< std::string >({"begin"}), database.calls);
+}
+
+TEST_F(TransactionTests, Moved_Transaction_Rolls_Back_Once) {
+    // Arrange
+
+    // Act
+    {
+        Transaction first(database);
+        Transaction second(std::move(first));
+        EXPECT_FALSE(first.IsOpen());
+        EXPECT_TRUE(second.IsOpen());
+    }
+
+    // Assert
+    EXPECT_EQ(std::vector< std::string >({"begin", "rollback"}), database.calls);
+}
@@ -0,0 +1,180 @@
+/**
+ * @file TypedStatementTests.cpp
+ *
+ * This module contains unit tests of the
+ * DatabaseAbstractions::TypedStatement class template.
+ */
+
+#include <DatabaseAbstractions/InMemoryDatabase.hpp>
+#include <DatabaseAbstractions/TypedStatement.hpp>
+#include <gtest/gtest.h>
+#include <string>
+#include <tuple>
+#include <vector>
+
+using namespace DatabaseAbstractions;
+
+namespace {
+
+    /**
+     * This is used to test fetching rows into user structures.
+     */
+    struct Person {
+        intmax_t id;
+        std::string name;
+        Blob photo;
+    };
+
+}
+
+/**
+ * This is the test fixture for these tests, providing common
+ * setup and teardown for each test.
+ */
+struct TypedStatementTests
+    : public ::testing::Test
+{
+    // Properties
+
+    InMemoryDatabase database;
+
+    // Methods
+
+    /**
+     * This builds the given statement and wraps it in a TypedStatement
+     * of the given type.
+     *
+     * @param[in] text
+     *     This is the SQL text of the statement to build.
+     *
+     * @return
+     *     The typed statement is returned.
+     */
+    template< typename T > T Build(const std::string& text) {
+        const auto built = database.BuildStatement(text);
+        EXPECT_EQ("", built.error);
+        return T(built.statement);
+    }
+
+    // ::testing::Test
+
+    virtual void SetUp() override {
+        ASSERT_EQ(
+            "",
+            database.ExecuteStatement(
+                "CREATE TABLE people ("
+                "  id INTEGER PRIMARY KEY,"
+                "  name TEXT NOT NULL,"
+                "  photo BLOB"
+                ")"
+            )
+        );
+        auto insert = Build<
+            TypedStatement<
+                Params< intmax_t, std::string, Blob >,
+                Columns<>
+            >
+        >("INSERT INTO people (id, name, photo) VALUES (?, ?, ?)");
+        const Blob alicePhoto({1, 2, 3});
+        insert.Bind(1, "alice", alicePhoto);
+        ASSERT_TRUE(insert.Step().done);
+        insert.Reset();
+        const Blob bobPhoto({4, 5});
+        insert.Bind(2, "bob", bobPhoto);
+        ASSERT_TRUE(insert.Step().done);
+    }
+};
+
+TEST_F(TypedStatementTests, Fetch_Into_Variables) {
+    // Arrange
+    auto query = Build<
+        TypedStatement<
+            Params< intmax_t >,
+            Columns< std::string, Blob >
+        >
+    >("SELECT name, photo FROM people WHERE id = ?");
+    query.Bind(2);
+    std::string name;
+    Blob photo;
+
+    // Act
+    const auto results = query.Step();
+    query.Fetch(name, photo);
+
+    // Assert
+    EXPECT_EQ("", results.error);
+    EXPECT_FALSE(results.done);
+    EXPECT_EQ("bob", name);
+    EXPECT_EQ(Blob({4, 5}), photo);
+}
+
+TEST_F(TypedStatementTests, Fetch_Rows_As_Tuples) {
+    // Arrange
+    auto query = Build<
+        TypedStatement<
+            Params<>,
+            Columns< intmax_t, std::string >
+        >
+    >("SELECT id, name FROM people ORDER BY id");
+    std::vector< std::tuple< intmax_t, std::string > > rows;
+
+    // Act
+    while (!query.Step().done) {
+        rows.push_back(query.FetchRow());
+    }
+
+    // Assert
+    EXPECT_EQ(
+        (std::vector< std::tuple< intmax_t, std::string > >({
+            std::make_tuple((intmax_t)1, std::string("alice")),
+            std::make_tuple((intmax_t)2, std::string("bob")),
+        })),
+        rows
+    );
+}
+
+TEST_F(TypedStatementTests, Fetch_Rows_As_Structures) {
+    // Arrange
+    auto query = Build<
+        TypedStatement<
+            Params< std::string >,
+            Columns< intmax_t, std::string, Blob >
+        >
+    >("SELECT id, name, photo FROM people WHERE name = ?");
+    query.Bind("alice");
+
+    // Act
+    ASSERT_FALSE(query.Step().done);
+    const auto person = query.FetchAs< Person >();
+
+    // Assert
+    EXPECT_EQ(1, person.id);
+    EXPECT_EQ("alice", person.name);
+    EXPECT_EQ(Blob({1, 2, 3}), person.photo);
+    EXPECT_TRUE(query.Step().done);
+}
+
+TEST_F(TypedStatementTests, Rebind_After_Reset) {
+    // Arrange
+    auto query = Build<
+        TypedStatement<
+            Params< intmax_t >,
+            Columns< std::string >
+        >
+    >("SELECT name FROM people WHERE id = ?");
+    std::vector< std::string > names;
+
+    // Act
+    for (intmax_t id = 1; id <= 2; ++id) {
+        query.Reset();
+        query.Bind(id);
+        ASSERT_FALSE(query.Step().done);
+        names.push_back(std::get< 0 >(query.FetchRow()));
+    }
+
+    // Assert
+    EXPECT_EQ(
+        std::vector< std::string >({"alice", "bob"}),
+        names
+    );
+}
@@ -0,0 +1,292 @@
+/**
+ * @file ValueEncodingTests.cpp
+ *
+ * This module contains unit tests of the functions which encode database
+ * values and batches of rows, and of the
+ * DatabaseAbstractions::ValueDecoder class.
+ */
+
+#include <DatabaseAbstractions/ValueEncoding.hpp>
+#include <gtest/gtest.h>
+#include <limits>
+#include <math.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+using namespace DatabaseAbstractions;
+
+/**
+ * This is the test fixture for these tests, providing common
+ * setup and teardown for each test.
+ */
+struct ValueEncodingTests
+    : public ::testing::Test
+{
+};
+
+TEST_F(ValueEncodingTests, Round_Trip_Values) {
+    // Arrange
+    const std::vector< Value > values{
+        Value(),
+        Value(nullptr),
+        Value(true),
+        Value(false),
+        Value(0),
+        Value(-1),
+        Value(std::numeric_limits< intmax_t >::max()),
+        Value(std::numeric_limits< intmax_t >::min()),
+        Value(3.5),
+        Value(-0.0),
+        Value(std::numeric_limits< double >::infinity()),
+        Value(""),
+        Value("Hello, World!"),
+        Value(std::string(1000, 'x')),
+        Value(std::string("a\0b", 3)),
+        Value(Blob{}),
+        Value(Blob{0x00, 0xFF, 0x7F}),
+        Value::Error("oops"),
+    };
+    Blob buffer;
+
+    // Act
+    for (const auto& value: values) {
+        EncodeValue(value, buffer);
+    }
+    ValueDecoder decoder(buffer);
+    std::vector< Value > decoded(values.size());
+    std::vector< std::string > errors;
+    for (auto& value: decoded) {
+        errors.push_back(decoder.Decode(value));
+    }
+
+    // Assert
+    EXPECT_TRUE(decoder.AtEnd());
+    EXPECT_EQ(buffer.size(), decoder.GetOffset());
+    for (size_t i = 0; i < values.size(); ++i) {
+        EXPECT_EQ("", errors[i]) << i;
+        EXPECT_EQ(values[i].GetType(), decoded[i].GetType()) << i;
+        EXPECT_EQ(0, values[i].Compare(decoded[i])) << i;
+        EXPECT_EQ(values[i].Hash(), decoded[i].Hash()) << i;
+    }
+    EXPECT_TRUE(signbit((double)decoded[9]));
+}
+
+TEST_F(ValueEncodingTests, Round_Trip_NaN) {
+    // Arrange
+    Blob buffer;
+    EncodeValue(Value(std::numeric_limits< double >::quiet_NaN()), buffer);
+    ValueDecoder decoder(buffer);
+    Value value;
+
+    // Act
+    const auto error = decoder.Decode(value);
+
+    // Assert
+    EXPECT_EQ("", error);
+    ASSERT_EQ(Value::Type::Real, value.GetType());
+    EXPECT_TRUE(isnan((double)value));
+}
+
+TEST_F(ValueEncodingTests, Encoding_Is_Compact) {
+    // Arrange
+    Blob small, negative, boolean, null, text;
+
+    // Act
+    EncodeValue(Value(5), small);
+    EncodeValue(Value(-64), negative);
+    EncodeValue(Value(true), boolean);
+    EncodeValue(Value(nullptr), null);
+    EncodeValue(Value("abc"), text);
+
+    // Assert
+    EXPECT_EQ(Blob({(uint8_t)ValueTag::Integer, 10}), small);
+    EXPECT_EQ(Blob({(uint8_t)ValueTag::Integer, 127}), negative);
+    EXPECT_EQ(Blob({(uint8_t)ValueTag::Boolean, 1}), boolean);
+    EXPECT_EQ(Blob({(uint8_t)ValueTag::Null}), null);
+    EXPECT_EQ(Blob({(uint8_t)ValueTag::Text, 3, 'a', 'b', 'c'}), text);
+}
+
+TEST_F(ValueEncodingTests, Decoded_Blobs_Refer_To_Buffer) {
+    // Arrange
+    Blob buffer;
+    EncodeValue(Value(Blob{1, 2, 3}), buffer);
+    ValueDecoder decoder(buffer);
+    Value value;
+
+    // Act
+    const auto error = decoder.Decode(value);
+
+    // Assert
+    EXPECT_EQ("", error);
+    EXPECT_TRUE(value.IsBorrowed());
+    EXPECT_EQ(buffer.data() + 2, ((BlobView)value).data);
+    value.Own();
+    buffer.assign(buffer.size(), 0);
+    EXPECT_EQ(Value(Blob{1, 2, 3}), value);
+}
+
+TEST_F(ValueEncodingTests, Decode_Text_Into_Arena) {
+    // Arrange
+    Blob buffer;
+    EncodeValue(Value("Hello, World!"), buffer);
+    ValueDecoder decoder(buffer);
+    Arena arena;
+    Value value;
+
+    // Act
+    const auto error = decoder.Decode(value, arena);
+
+    // Assert
+    EXPECT_EQ("", error);
+    EXPECT_TRUE(value.IsInArena());
+    EXPECT_STREQ("Hello, World!", (const char*)value);
+    EXPECT_EQ(Value("Hello, World!"), value);
+}
+
+TEST_F(ValueEncodingTests, Encode_Values_Kept_Elsewhere) {
+    // Arrange
+    Arena arena;
+    const uint8_t data[] = {4, 5, 6};
+    const std::vector< Value > values{
+        Value(std::string("arena text"), arena),
+        Value(BlobView(data, sizeof(data)), arena),
+        Value(BlobView(data, sizeof(data))),
+    };
+    Blob buffer;
+
+    // Act
+    EncodeValues(values.data(), values.size(), buffer);
+    ValueDecoder decoder(buffer);
+    std::vector< Value > decoded(values.size());
+    for (auto& value: decoded) {
+        ASSERT_EQ("", decoder.Decode(value));
+    }
+
+    // Assert
+    EXPECT_TRUE(decoder.AtEnd());
+    EXPECT_EQ(Value("arena text"), decoded[0]);
+    EXPECT_EQ(Value(Blob{4, 5, 6}), decoded[1]);
+    EXPECT_EQ(Value(Blob{4, 5, 6}), decoded[2]);
+}
+
+TEST_F(ValueEncodingTests, Decode_Truncated_Or_Unknown) {
+    // Arrange
+    Blob buffer;
+    EncodeValue(Value("Hello"), buffer);
+    EncodeValue(Value(1.5), buffer);
+    std::vector< std::string > errors;
+
+    // Act
+    for (size_t size = 0; size < buffer.size(); ++size) {
+        ValueDecoder decoder(BlobView(buffer.data(), size));
+        Value first, second;
+        auto error = decoder.Decode(first);
+        if (error.empty()) {
+            error = decoder.Decode(second);
+        }
+        errors.push_back(error);
+    }
+    const Blob unknown{99};
+    ValueDecoder unknownDecoder(unknown);
+    Value value;
+    const auto unknownError = unknownDecoder.Decode(value);
+
+    // Assert
+    for (size_t size = 0; size < errors.size(); ++size) {
+        EXPECT_EQ("truncated value", errors[size]) << size;
+    }
+    EXPECT_EQ("unknown value tag", unknownError);
+}
+
+TEST_F(ValueEncodingTests, Round_Trip_Row_Batch) {
+    // Arrange
+    RowBatch batch({Value::Type::Integer, Value::Type::Text, Value::Type::Blob});
+    for (int i = 0; i < 3; ++i) {
+        const auto row = batch.AddRow();
+        batch.GetValue(row, 0) = i;
+        batch.GetValue(row, 1).Assign(Value("row " + std::to_string(i)), batch.GetArena());
+        batch.GetValue(row, 2) = Blob((size_t)i, (uint8_t)i);
+    }
+    batch.GetValue(1, 1) = nullptr;
+    Blob buffer;
+    EncodeRowBatch(batch, buffer);
+    RowBatch decoded({Value::Type::Real});
+
+    // Act
+    ValueDecoder decoder(buffer);
+    const auto error = decoder.Decode(decoded);
+
+    // Assert
+    EXPECT_EQ("", error);
+    EXPECT_TRUE(decoder.AtEnd());
+    ASSERT_EQ((size_t)3, decoded.GetColumnCount());
+    EXPECT_EQ(Value::Type::Integer, decoded.GetColumnType(0));
+    EXPECT_EQ(Value::Type::Text, decoded.GetColumnType(1));
+    EXPECT_EQ(Value::Type::Blob, decoded.GetColumnType(2));
+    ASSERT_EQ((size_t)3, decoded.GetRowCount());
+    for (size_t row = 0; row < 3; ++row) {
+        for (size_t column = 0; column < 3; ++column) {
+            EXPECT_EQ(
+                batch.GetValue(row, column).GetType(),
+                decoded.GetValue(row, column).GetType()
+            ) << row << ", " << column;
+            EXPECT_EQ(batch.GetValue(row, column), decoded.GetValue(row, column))
+                << row << ", " << column;
+        }
+    }
+    EXPECT_TRUE(decoded.GetValue(0, 1).IsInArena());
+    EXPECT_TRUE(decoded.GetValue(2, 2).IsBorrowed());
+}
+
+TEST_F(ValueEncodingTests, Decode_Row_Batch_Reuses_Matching_Batch) {
+    // Arrange
+    RowBatch batch({Value::Type::Integer}, 4);
+    for (int i = 0; i < 4; ++i) {
+        batch.GetValue(batch.AddRow(), 0) = i;
+    }
+    Blob buffer;
+    EncodeRowBatch(batch, buffer);
+    RowBatch decoded({Value::Type::Integer});
+    for (int i = 0; i < 10; ++i) {
+        (void)decoded.AddRow();
+    }
+    const auto capacity = decoded.GetCapacity();
+    const auto firstValue = &decoded.GetValue(0, 0);
+
+    // Act
+    ValueDecoder decoder(buffer);
+    const auto error = decoder.Decode(decoded);
+
+    // Assert
+    EXPECT_EQ("", error);
+    EXPECT_EQ((size_t)4, decoded.GetRowCount());
+    EXPECT_EQ(capacity, decoded.GetCapacity());
+    EXPECT_EQ(firstValue, &decoded.GetValue(0, 0));
+    EXPECT_EQ(Value(3), decoded.GetValue(3, 0));
+}
+
+TEST_F(ValueEncodingTests, Decode_Truncated_Row_Batch) {
+    // Arrange
+    RowBatch batch({Value::Type::Integer, Value::Type::Text});
+    for (int i = 0; i < 3; ++i) {
+        const auto row = batch.AddRow();
+        batch.GetValue(row, 0) = i;
+        batch.GetValue(row, 1) = "text";
+    }
+    Blob buffer;
+    EncodeRowBatch(batch, buffer);
+    std::vector< std::string > errors;
+
+    // Act
+    for (size_t size = 0; size < buffer.size(); ++size) {
+        ValueDecoder decoder(BlobView(buffer.data(), size));
+        RowBatch decoded({});
+        errors.push_back(decoder.Decode(decoded));
+    }
+
+    // Assert
+    for (size_t size = 0; size < errors.size(); ++size) {
+        EXPECT_FALSE(errors[size].empty()) << size;
+    }
+}
@@ -4,10 +4,14 @@
  * This module contains unit tests of the Database::Value class.
  */
 
+#include <DatabaseAbstractions/Arena.hpp>
 #include <DatabaseAbstractions/Value.hpp>
 #include <gtest/gtest.h>
+#include <limits>
+#include <map>
 #include <sstream>
 #include <string>
+#include <unordered_set>
 #include <vector>
 
 using namespace DatabaseAbstractions;
@@ -333,6 +337,7 @@ TEST_F(ValueTests, PrintTo) {
     };
 
     const std::vector< Value > values{
+        Blob({0x01, 0x02, 0xfe}),
         true,
         Value::Error("REEEEEEE"),
         42,
@@ -351,6 +356,7 @@ TEST_F(ValueTests, PrintTo) {
     // Assert
     EXPECT_EQ(
         std::vector< std::string >({
+            "blob(0102fe)",
             "true",
             "error(\"REEEEEEE\")",
             "42",
@@ -362,3 +368,579 @@ TEST_F(ValueTests, PrintTo) {
         prints
     );
 }
+
+TEST_F(ValueTests, Reassign_Value_Between_Types) {
+    // Arrange
+    Value value("Hello!");
+
+    // Act
+    value = 42;
+    const auto typeAfterInteger = value.GetType();
+    value = "World!";
+    const auto typeAfterText = value.GetType();
+    value = Value::Error("REEEEEEE");
+
+    // Assert
+    EXPECT_EQ(Value::Type::Integer, typeAfterInteger);
+    EXPECT_EQ(Value::Type::Text, typeAfterText);
+    EXPECT_EQ(Value::Type::Error, value.GetType());
+    EXPECT_EQ("REEEEEEE", (const std::string&)value);
+}
+
+TEST_F(ValueTests, Copy_Assign_Text_Over_Text) {
+    // Arrange
+    const std::string longText(100, 'x');
+    Value value1(longText);
+    Value value2("Hello!");
+
+    // Act
+    value2 = value1;
+
+    // Assert
+    EXPECT_EQ(Value::Type::Text, value2.GetType());
+    EXPECT_EQ(longText, (const std::string&)value2);
+    EXPECT_EQ(longText, (const std::string&)value1);
+}
+
+TEST_F(ValueTests, Construct_Text_Value_From_Pointer_And_Size) {
+    // Arrange
+    const char text[] = "a\0b\0c";
+
+    // Act
+    const Value value(text, 5);
+
+    // Assert
+    EXPECT_EQ(Value::Type::Text, value.GetType());
+    EXPECT_EQ(std::string(text, 5), (const std::string&)value);
+}
+
+TEST_F(ValueTests, Set_Text_Reuses_Capacity) {
+    // Arrange
+    Value value(std::string(100, 'x'));
+    const auto data = ((const std::string&)value).data();
+    const std::string longer(80, 'y');
+
+    // Act
+    value.SetText(longer.data(), longer.size());
+
+    // Assert
+    EXPECT_EQ(Value::Type::Text, value.GetType());
+    EXPECT_EQ(longer, (const std::string&)value);
+    EXPECT_EQ(data, ((const std::string&)value).data());
+}
+
+TEST_F(ValueTests, Set_Text_Over_Other_Types) {
+    // Arrange
+    const uint8_t data[] = {1, 2, 3};
+    Arena arena;
+    std::vector< Value > values{
+        Value(42),
+        Value(Blob{1, 2}),
+        Value(BlobView(data, sizeof(data))),
+        Value(std::string("arena"), arena),
+        Value::Error("oops"),
+    };
+
+    // Act
+    for (auto& value: values) {
+        value.SetText("text", 4);
+    }
+
+    // Assert
+    for (const auto& value: values) {
+        EXPECT_EQ(Value::Type::Text, value.GetType());
+        EXPECT_FALSE(value.IsBorrowed());
+        EXPECT_FALSE(value.IsInArena());
+        EXPECT_EQ("text", (const std::string&)value);
+    }
+}
+
+TEST_F(ValueTests, Set_Blob_Reuses_Capacity) {
+    // Arrange
+    Value value(Blob(100, 1));
+    const auto data = ((BlobView)value).data;
+    const Blob longer(80, 2);
+    Value text("Hello!");
+
+    // Act
+    value.SetBlob(longer.data(), longer.size());
+    text.SetBlob(longer.data(), longer.size());
+
+    // Assert
+    EXPECT_EQ(Value(longer), value);
+    EXPECT_EQ(data, ((BlobView)value).data);
+    EXPECT_EQ(Value::Type::Blob, text.GetType());
+    EXPECT_EQ(Value(longer), text);
+}
+
+TEST_F(ValueTests, Set_Blob_From_Own_Data) {
+    // Arrange
+    Value value(Blob{1, 2, 3, 4});
+    const BlobView view(value);
+
+    // Act
+    value.SetBlob(view.data + 1, 2);
+
+    // Assert
+    EXPECT_EQ(Value(Blob{2, 3}), value);
+}
+
+TEST_F(ValueTests, Copy_Assign_Value_To_Itself) {
+    // Arrange
+    Value value("Hello!");
+    auto& alias = value;
+
+    // Act
+    value = alias;
+
+    // Assert
+    EXPECT_EQ("Hello!", (const std::string&)value);
+}
+
+TEST_F(ValueTests, Construct_Blob_Copy_Value) {
+    // Arrange
+    const Blob blob{0x01, 0x02, 0x03};
+
+    // Act
+    Value value(blob);
+
+    // Assert
+    EXPECT_EQ(Value::Type::Blob, value.GetType());
+    EXPECT_FALSE(value.IsBorrowed());
+    const BlobView view(value);
+    EXPECT_NE(blob.data(), view.data);
+    EXPECT_EQ(blob, Blob(view.data, view.data + view.size));
+}
+
+TEST_F(ValueTests, Construct_Blob_Move_Value) {
+    // Arrange
+    Blob blob{0x01, 0x02, 0x03};
+    const auto data = blob.data();
+
+    // Act
+    Value value(std::move(blob));
+
+    // Assert
+    EXPECT_EQ(Value::Type::Blob, value.GetType());
+    EXPECT_FALSE(value.IsBorrowed());
+    EXPECT_EQ(data, ((BlobView)value).data);
+}
+
+TEST_F(ValueTests, Construct_Borrowed_Blob_Value) {
+    // Arrange
+    const Blob blob{0x01, 0x02, 0x03};
+
+    // Act
+    Value value(BlobView(blob.data(), blob.size()));
+
+    // Assert
+    EXPECT_EQ(Value::Type::Blob, value.GetType());
+    EXPECT_TRUE(value.IsBorrowed());
+    const BlobView view(value);
+    EXPECT_EQ(blob.data(), view.data);
+    EXPECT_EQ(blob.size(), view.size);
+}
+
+TEST_F(ValueTests, Copy_Borrowed_Blob_Value_Still_Borrows) {
+    // Arrange
+    const Blob blob{0x01, 0x02, 0x03};
+    const Value value1(BlobView(blob.data(), blob.size()));
+
+    // Act
+    Value value2(value1);
+
+    // Assert
+    EXPECT_TRUE(value2.IsBorrowed());
+    EXPECT_EQ(blob.data(), ((BlobView)value2).data);
+}
+
+TEST_F(ValueTests, Own_Borrowed_Blob_Value) {
+    // Arrange
+    Blob blob{0x01, 0x02, 0x03};
+    Value value(BlobView(blob.data(), blob.size()));
+
+    // Act
+    value.Own();
+    blob[0] = 0x42;
+
+    // Assert
+    EXPECT_EQ(Value::Type::Blob, value.GetType());
+    EXPECT_FALSE(value.IsBorrowed());
+    EXPECT_EQ(Value(Blob({0x01, 0x02, 0x03})), value);
+}
+
+TEST_F(ValueTests, Compare_Blob_Values) {
+    // Arrange
+    const Blob blob1{0x01, 0x02, 0x03};
+    const Blob blob2{0x01, 0x02, 0x04};
+
+    // Act
+    const Value owned1(blob1);
+    const Value borrowed1(BlobView(blob1.data(), blob1.size()));
+    const Value owned2(blob2);
+
+    // Assert
+    EXPECT_EQ(owned1, borrowed1);
+    EXPECT_EQ(borrowed1, owned1);
+    EXPECT_NE(owned1, owned2);
+    EXPECT_NE(borrowed1, owned2);
+    EXPECT_EQ(Value(Blob()), Value(BlobView()));
+}
+
+TEST_F(ValueTests, Assign_Blob_Values) {
+    // Arrange
+    const Blob blob{0x01, 0x02, 0x03};
+    Value value("Hello!");
+
+    // Act
+    value = blob;
+    const auto borrowedAfterCopy = value.IsBorrowed();
+    value = BlobView(blob);
+    const auto borrowedAfterView = value.IsBorrowed();
+    value = 42;
+
+    // Assert
+    EXPECT_FALSE(borrowedAfterCopy);
+    EXPECT_TRUE(borrowedAfterView);
+    EXPECT_FALSE(value.IsBorrowed());
+    EXPECT_EQ(Value::Type::Integer, value.GetType());
+}
+
+TEST_F(ValueTests, Move_Blob_Value) {
+    // Arrange
+    Value value1(Blob({0x01, 0x02, 0x03}));
+
+    // Act
+    Value value2(std::move(value1));
+
+    // Assert
+    EXPECT_EQ(Value::Type::Blob, value2.GetType());
+    EXPECT_EQ(Value::Type::Invalid, value1.GetType());
+    EXPECT_EQ((size_t)3, ((BlobView)value2).size);
+}
+
+TEST_F(ValueTests, Construct_Text_Value_In_Arena) {
+    // Arrange
+    Arena arena;
+    const std::string text = "This text is too long to fit in a small string";
+
+    // Act
+    const Value value(text, arena);
+
+    // Assert
+    EXPECT_EQ(Value::Type::Text, value.GetType());
+    EXPECT_TRUE(value.IsInArena());
+    EXPECT_FALSE(value.IsBorrowed());
+    EXPECT_EQ(text.length() + 1, arena.GetBytesUsed());
+    EXPECT_STREQ(text.c_str(), (const char*)value);
+    EXPECT_EQ(Value(text), value);
+    EXPECT_EQ(value, Value(text));
+}
+
+TEST_F(ValueTests, Assign_Values_In_Arena) {
+    // Arrange
+    Arena arena;
+    const Blob blob{0x01, 0x02, 0x03};
+    Value text, error, blobValue, integer;
+
+    // Act
+    text.Assign(Value("Hello!"), arena);
+    error.Assign(Value::Error("REEEEEEE"), arena);
+    blobValue.Assign(Value(BlobView(blob)), arena);
+    integer.Assign(Value(42), arena);
+
+    // Assert
+    EXPECT_TRUE(text.IsInArena());
+    EXPECT_EQ(Value("Hello!"), text);
+    EXPECT_TRUE(error.IsInArena());
+    EXPECT_EQ(Value::Type::Error, error.GetType());
+    EXPECT_STREQ("REEEEEEE", (const char*)error);
+    EXPECT_TRUE(blobValue.IsInArena());
+    EXPECT_NE(blob.data(), ((BlobView)blobValue).data);
+    EXPECT_EQ(Value(blob), blobValue);
+    EXPECT_FALSE(integer.IsInArena());
+    EXPECT_EQ(Value(42), integer);
+}
+
+TEST_F(ValueTests, Copy_Value_In_Arena_Owns_Data) {
+    // Arrange
+    Arena arena;
+    const Value text("Hello!", arena);
+    const Value blob(Blob({0x01, 0x02, 0x03}), arena);
+
+    // Act
+    const Value textCopy(text);
+    Value blobCopy;
+    blobCopy = blob;
+    arena.Reset();
+    (void)arena.Allocate(64);
+
+    // Assert
+    EXPECT_FALSE(textCopy.IsInArena());
+    EXPECT_EQ("Hello!", (const std::string&)textCopy);
+    EXPECT_FALSE(blobCopy.IsInArena());
+    EXPECT_EQ(Value(Blob({0x01, 0x02, 0x03})), blobCopy);
+}
+
+TEST_F(ValueTests, Move_Value_In_Arena_Keeps_Using_Arena) {
+    // Arrange
+    Arena arena;
+    Value text("Hello!", arena);
+    const auto data = (const char*)text;
+
+    // Act
+    const Value moved(std::move(text));
+
+    // Assert
+    EXPECT_TRUE(moved.IsInArena());
+    EXPECT_EQ(data, (const char*)moved);
+}
+
+TEST_F(ValueTests, Own_Value_In_Arena) {
+    // Arrange
+    Arena arena;
+    Value text("Hello!", arena);
+    Value blob(Blob({0x01, 0x02, 0x03}), arena);
+
+    // Act
+    text.Own();
+    blob.Own();
+    arena.Reset();
+    (void)arena.Allocate(64);
+
+    // Assert
+    EXPECT_FALSE(text.IsInArena());
+    EXPECT_EQ("Hello!", (const std::string&)text);
+    EXPECT_FALSE(blob.IsInArena());
+    EXPECT_EQ(Value(Blob({0x01, 0x02, 0x03})), blob);
+}
+
+TEST_F(ValueTests, Text_In_Arena_As_String_Reference) {
+    // Arrange
+    Arena arena;
+    const Value value("Hello!", arena);
+
+    // Act
+    const auto& text = (const std::string&)value;
+
+    // Assert
+    EXPECT_EQ("Hello!", text);
+    EXPECT_FALSE(value.IsInArena());
+}
+
+TEST_F(ValueTests, Compare_Orders_Kinds_As_Sql) {
+    // Arrange
+    const std::vector< Value > ascending{
+        Value(),
+        Value(nullptr),
+        Value(-5),
+        Value(false),
+        Value(0.5),
+        Value(true),
+        Value(2),
+        Value("abc"),
+        Value("abd"),
+        Value(Blob({0x00})),
+        Value(Blob({0x00, 0x01})),
+        Value::Error("oops"),
+    };
+
+    for (size_t i = 0; i < ascending.size(); ++i) {
+        for (size_t j = 0; j < ascending.size(); ++j) {
+            // Act
+            const auto comparison = ascending[i].Compare(ascending[j]);
+
+            // Assert
+            EXPECT_EQ((i < j) ? -1 : ((i > j) ? 1 : 0), comparison) << i << " vs " << j;
+            EXPECT_EQ(i < j, ascending[i] < ascending[j]);
+            EXPECT_EQ(i == j, ascending[i] == ascending[j]);
+        }
+    }
+}
+
+TEST_F(ValueTests, Compare_Numbers_Exactly_Across_Types) {
+    // Arrange
+    const intmax_t big = ((intmax_t)1 << 53) + 1;
+    const double nan = std::numeric_limits< double >::quiet_NaN();
+
+    // Act
+
+    // Assert
+    EXPECT_EQ(Value(3), Value(3.0));
+    EXPECT_EQ(Value(true), Value(1));
+    EXPECT_EQ(Value(0.0), Value(-0.0));
+    EXPECT_LT(Value((double)((intmax_t)1 << 53)), Value(big));
+    EXPECT_GT(Value(big), Value((double)big));
+    EXPECT_LT(Value(2), Value(2.5));
+    EXPECT_GT(Value(-2), Value(-2.5));
+    EXPECT_LT(Value(INTMAX_MAX), Value(1e19));
+    EXPECT_GT(Value(INTMAX_MIN), Value(-1e19));
+    EXPECT_LT(Value(nan), Value(-1e300));
+    EXPECT_EQ(Value(nan), Value(nan));
+}
+
+TEST_F(ValueTests, Equivalent_Values_Hash_Same) {
+    // Arrange
+    const Blob blob{0x01, 0x02, 0x03};
+    Arena arena;
+
+    // Act
+
+    // Assert
+    EXPECT_EQ(Value(3).Hash(), Value(3.0).Hash());
+    EXPECT_EQ(Value(true).Hash(), Value(1).Hash());
+    EXPECT_EQ(Value(0.0).Hash(), Value(-0.0).Hash());
+    EXPECT_EQ(Value("Hello!").Hash(), Value("Hello!", arena).Hash());
+    EXPECT_EQ(Value(blob).Hash(), Value(BlobView(blob)).Hash());
+    EXPECT_EQ(Value(blob).Hash(), Value(BlobView(blob), arena).Hash());
+    EXPECT_NE(Value("a").Hash(), Value(Blob({'a'})).Hash());
+    EXPECT_NE(Value("a").Hash(), Value::Error("a").Hash());
+    EXPECT_NE(Value(1).Hash(), Value(2).Hash());
+    EXPECT_NE(Value(1.5).Hash(), Value(2.5).Hash());
+}
+
+TEST_F(ValueTests, Values_As_Container_Keys) {
+    // Arrange
+    std::unordered_set< Value > unordered;
+    std::map< Value, int > ordered;
+
+    // Act
+    for (const auto& value: {Value(1), Value(1.0), Value("x"), Value(nullptr), Value(2.5)}) {
+        (void)unordered.insert(value);
+        ++ordered[value];
+    }
+
+    // Assert
+    EXPECT_EQ(4, unordered.size());
+    EXPECT_EQ(1, unordered.count(Value(true)));
+    ASSERT_EQ(4, ordered.size());
+    auto entry = ordered.begin();
+    EXPECT_EQ(Value(nullptr), entry->first);
+    ++entry;
+    EXPECT_EQ(Value(1), entry->first);
+    EXPECT_EQ(2, entry->second);
+    ++entry;
+    EXPECT_EQ(Value(2.5), entry->first);
+    ++entry;
+    EXPECT_EQ(Value("x"), entry->first);
+}
+
+TEST_F(ValueTests, Copies_Of_Shared_Text_Share_Buffer) {
+    // Arrange
+    const std::string longText(1000, 'x');
+    Value value(longText);
+
+    // Act
+    value.Share();
+    const auto copy = value;
+    Value assigned("Hello!");
+    assigned = copy;
+
+    // Assert
+    EXPECT_TRUE(value.IsShared());
+    EXPECT_TRUE(copy.IsShared());
+    EXPECT_TRUE(assigned.IsShared());
+    EXPECT_EQ(Value::Type::Text, copy.GetType());
+    EXPECT_EQ(longText, (const std::string&)copy);
+    EXPECT_EQ(
+        ((const std::string&)value).data(),
+        ((const std::string&)copy).data()
+    );
+    EXPECT_EQ((const char*)value, (const char*)assigned);
+    EXPECT_EQ(value, copy);
+    EXPECT_EQ(Value(longText), assigned);
+    EXPECT_EQ(Value(longText).Hash(), assigned.Hash());
+}
+
+TEST_F(ValueTests, Copies_Of_Shared_Blob_Share_Buffer) {
+    // Arrange
+    Value value(Blob(1000, 7));
+
+    // Act
+    value.Share();
+    const auto copy = value;
+
+    // Assert
+    EXPECT_TRUE(copy.IsShared());
+    EXPECT_FALSE(copy.IsBorrowed());
+    EXPECT_EQ(((BlobView)value).data, ((BlobView)copy).data);
+    EXPECT_EQ(Value(Blob(1000, 7)), copy);
+}
+
+TEST_F(ValueTests, Changing_Shared_Value_Leaves_Copies_Alone) {
+    // Arrange
+    Value value("Hello, World!");
+    value.Share();
+    const auto copy = value;
+
+    // Act
+    value = "Goodbye!";
+    Value other(copy);
+    other.SetText("abc", 3);
+
+    // Assert
+    EXPECT_FALSE(value.IsShared());
+    EXPECT_EQ("Goodbye!", (const std::string&)value);
+    EXPECT_EQ("abc", (const std::string&)other);
+    EXPECT_EQ("Hello, World!", (const std::string&)copy);
+}
+
+TEST_F(ValueTests, Share_Borrowed_Or_Arena_Data_Copies_It) {
+    // Arrange
+    Blob data{1, 2, 3};
+    Arena arena;
+    Value borrowed{BlobView(data)};
+    Value inArena(std::string("arena"), arena);
+    auto error = Value::Error("oops");
+
+    // Act
+    borrowed.Share();
+    inArena.Share();
+    error.Share();
+    data.assign(data.size(), 0);
+    arena.Reset();
+
+    // Assert
+    EXPECT_TRUE(borrowed.IsShared());
+    EXPECT_FALSE(borrowed.IsBorrowed());
+    EXPECT_EQ(Value(Blob{1, 2, 3}), borrowed);
+    EXPECT_TRUE(inArena.IsShared());
+    EXPECT_FALSE(inArena.IsInArena());
+    EXPECT_EQ(Value("arena"), inArena);
+    EXPECT_EQ(Value::Type::Error, error.GetType());
+    EXPECT_EQ("oops", (const std::string&)error);
+}
+
+TEST_F(ValueTests, Share_Leaves_Other_Values_Alone) {
+    // Arrange
+    std::vector< Value > values{Value(), Value(nullptr), Value(42), Value(1.5), Value(true)};
+
+    // Act
+    for (auto& value: values) {
+        value.Share();
+    }
+
+    // Assert
+    EXPECT_EQ(
+        std::vector< Value >({Value(), Value(nullptr), Value(42), Value(1.5), Value(true)}),
+        values
+    );
+    for (const auto& value: values) {
+        EXPECT_FALSE(value.IsShared());
+    }
+}
+
+TEST_F(ValueTests, Move_Shared_Value) {
+    // Arrange
+    Value value("Hello, World!");
+    value.Share();
+    const auto text = (const char*)value;
+
+    // Act
+    Value moved(std::move(value));
+
+    // Assert
+    EXPECT_TRUE(moved.IsShared());
+    EXPECT_EQ(text, (const char*)moved);
+    EXPECT_EQ("Hello, World!", (const std::string&)moved);
+}
@@ -0,0 +1,95 @@
+/**
+ * @file WorkerPoolTests.cpp
+ *
+ * This module contains unit tests of the
+ * DatabaseAbstractions::WorkerPool class.
+ */
+
+#include <atomic>
+#include <DatabaseAbstractions/WorkerPool.hpp>
+#include <future>
+#include <gtest/gtest.h>
+#include <memory>
+#include <set>
+#include <thread>
+
+using namespace DatabaseAbstractions;
+
+/**
+ * This is the test fixture for these tests, providing common
+ * setup and teardown for each test.
+ */
+struct WorkerPoolTests
+    : public ::testing::Test
+{
+};
+
+TEST_F(WorkerPoolTests, Thread_Count) {
+    // Arrange
+    WorkerPool pool(3);
+
+    // Act
+    const auto threadCount = pool.GetThreadCount();
+
+    // Assert
+    EXPECT_EQ(3, threadCount);
+}
+
+TEST_F(WorkerPoolTests, Default_Thread_Count_Is_Not_Zero) {
+    // Arrange
+    WorkerPool pool;
+
+    // Act
+    const auto threadCount = pool.GetThreadCount();
+
+    // Assert
+    EXPECT_NE(0, threadCount);
+}
+
+TEST_F(WorkerPoolTests, Work_Done_On_Worker_Thread) {
+    // Arrange
+    WorkerPool pool(1);
+    std::promise< std::thread::id > threadId;
+
+    // Act
+    pool.Post([&]{ threadId.set_value(std::this_thread::get_id()); });
+
+    // Assert
+    EXPECT_NE(std::this_thread::get_id(), threadId.get_future().get());
+}
+
+TEST_F(WorkerPoolTests, Destructor_Finishes_Queued_Work) {
+    // Arrange
+    std::atomic< size_t > workDone(0);
+    {
+        WorkerPool pool(2);
+
+        // Act
+        for (size_t i = 0; i < 100; ++i) {
+            pool.Post([&]{ ++workDone; });
+        }
+    }
+
+    // Assert
+    EXPECT_EQ(100, workDone);
+}
+
+TEST_F(WorkerPoolTests, Destroyed_By_Own_Worker) {
+    // Arrange
+    auto pool = std::make_shared< WorkerPool >(2);
+    std::promise< void > released;
+    auto weakPool = std::weak_ptr< WorkerPool >(pool);
+
+    // Act
+    pool->Post(
+        [pool, &released]() mutable {
+            pool = nullptr;
+            released.set_value();
+        }
+    );
+    pool = nullptr;
+    released.get_future().wait();
+
+    // Assert
+    EXPECT_TRUE(weakPool.expired());
+}
@@ -0,0 +1,65 @@
+/**
+ * @file WriteBatchTests.cpp
+ *
+ * This module contains unit tests of the
+ * DatabaseAbstractions::WriteBatch class.
+ */
+
+#include <DatabaseAbstractions/WriteBatch.hpp>
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+using namespace DatabaseAbstractions;
+
+/**
+ * This is the test fixture for these tests, providing common
+ * setup and teardown for each test.
+ */
+struct WriteBatchTests
+    : public ::testing::Test
+{
+    // Properties
+
+    WriteBatch batch;
+};
+
+TEST_F(WriteBatchTests, Add_Statements) {
+    // Arrange
+
+    // Act
+    batch.Add("INSERT INTO t VALUES (?, ?)", {1, "one"});
+    batch.Add("DELETE FROM t");
+
+    // Assert
+    ASSERT_EQ((size_t)2, batch.GetSize());
+    EXPECT_EQ("INSERT INTO t VALUES (?, ?)", batch.GetStatement(0));
+    EXPECT_EQ(std::vector< Value >({1, "one"}), batch.GetParameters(0));
+    EXPECT_EQ("DELETE FROM t", batch.GetStatement(1));
+    EXPECT_TRUE(batch.GetParameters(1).empty());
+}
+
+TEST_F(WriteBatchTests, Borrowed_Blobs_Are_Copied) {
+    // Arrange
+    Blob blob({1, 2, 3});
+
+    // Act
+    batch.Add("INSERT INTO t VALUES (?)", {BlobView(blob.data(), blob.size())});
+    blob[0] = 9;
+
+    // Assert
+    const auto& parameter = batch.GetParameters(0)[0];
+    EXPECT_FALSE(parameter.IsBorrowed());
+    EXPECT_EQ(Value(Blob({1, 2, 3})), parameter);
+}
+
+TEST_F(WriteBatchTests, Clear) {
+    // Arrange
+    batch.Add("DELETE FROM t");
+
+    // Act
+    batch.Clear();
+
+    // Assert
+    EXPECT_EQ((size_t)0, batch.GetSize());
+}